@@ -0,0 +1,16 @@
+# Writes OUTPUT with a hash of the translator sources in SOURCES ("|" separated). The translation cache keys on it,
+#  so that the translations written by an older translator are never read back.
+
+STRING(REPLACE "|" ";" SOURCES "${SOURCES}")
+
+SET(ALL_HASHES "")
+FOREACH(SRC ${SOURCES})
+	FILE(MD5 ${SRC} SRC_HASH)
+	SET(ALL_HASHES "${ALL_HASHES}${SRC_HASH}")
+ENDFOREACH()
+FILE(WRITE ${OUTPUT}.hashes "${ALL_HASHES}")
+FILE(MD5 ${OUTPUT}.hashes TRANSLATOR_HASH)
+STRING(SUBSTRING ${TRANSLATOR_HASH} 0 16 TRANSLATOR_HASH)
+
+FILE(WRITE ${OUTPUT}.tmp "#define DXBC2GLSL_TRANSLATOR_HASH 0x${TRANSLATOR_HASH}ULL\n")
+EXECUTE_PROCESS(COMMAND ${CMAKE_COMMAND} -E copy_if_different ${OUTPUT}.tmp ${OUTPUT})
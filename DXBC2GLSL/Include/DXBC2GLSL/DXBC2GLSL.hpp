@@ -44,11 +44,25 @@
 #include <DXBC2GLSL/Shader.hpp>
 #include <DXBC2GLSL/GLSLGen.hpp>
 
+#include <atomic>
+#include <iosfwd>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
 namespace DXBC2GLSL
 {
+	// The GLSL and the reflection data of a shader. They are copied out of the DXBC, which doesn't have to be kept
+	//  after FeedDXBC.
 	class DXBC2GLSL
 	{
 	public:
+		DXBC2GLSL();
+
 		static uint32_t DefaultRules(GLSLVersion version);
 
 		void FeedDXBC(void const * dxbc_data,
@@ -58,6 +72,9 @@ namespace DXBC2GLSL
 			bool has_gs, bool has_ps, ShaderTessellatorPartitioning ds_partitioning, ShaderTessellatorOutputPrimitive ds_output_primitive,
 			GLSLVersion version, uint32_t glsl_rules);
 
+		bool StreamIn(std::istream& is);
+		void StreamOut(std::ostream& os) const;
+
 		std::string const & GLSLString() const;
 
 		uint32_t NumInputParams() const;
@@ -88,9 +105,110 @@ namespace DXBC2GLSL
 		ShaderTessellatorOutputPrimitive DSOutputPrimitive() const;
 
 	private:
-		std::shared_ptr<DXBCContainer> dxbc_;
-		std::shared_ptr<ShaderProgram> shader_;
+		uint32_t AddName(char const * name);
+		void ResolveParamNames(std::vector<uint32_t> const & in_names, std::vector<uint32_t> const & out_names);
+
+	private:
+		struct Variable
+		{
+			uint32_t name;
+			bool used;
+		};
+
+		struct Resource
+		{
+			uint32_t name;
+			uint32_t bind_point;
+			ShaderInputType type;
+			ShaderSRVDimension dimension;
+			bool used;
+		};
+
 		std::string glsl_;
+
+		// All the names, each one ends with a 0. Copies share it, so that the names in the params stay valid.
+		std::shared_ptr<std::vector<char>> names_;
+
+		std::vector<DXBCSignatureParamDesc> params_in_;
+		std::vector<DXBCSignatureParamDesc> params_out_;
+		std::vector<std::vector<Variable>> cbuffers_;
+		std::vector<Resource> resources_;
+
+		ShaderPrimitive gs_input_primitive_;
+		std::vector<ShaderPrimitiveTopology> gs_output_topology_;
+		uint32_t max_gs_output_vertex_;
+		uint32_t gs_instance_count_;
+
+		ShaderTessellatorPartitioning ds_partitioning_;
+		ShaderTessellatorOutputPrimitive ds_output_primitive_;
+	};
+
+	// Translations found by the hash of the DXBC, of the options and of the translator sources, shared by all the
+	//  shaders of a process. With a folder, every translation is also written to a file there, and read back by later
+	//  runs. A hit is verified against the DXBC checksum, size and options, so that two keys colliding is only a miss.
+	//  At most MaxEntries translations are kept in memory, the least recently used one is dropped first.
+	class TranslationCache : boost::noncopyable
+	{
+	public:
+		static TranslationCache& Instance();
+
+		// The folder has to exist. An empty one keeps the translations in memory only.
+		void Folder(std::string const & folder);
+
+		void MaxEntries(size_t max_entries);
+		size_t MaxEntries() const;
+		size_t NumEntries() const;
+
+		// Throws like DXBC2GLSL::FeedDXBC when the shader can't be translated
+		std::shared_ptr<DXBC2GLSL const> Translate(void const * dxbc_data,
+			bool has_gs, bool has_ps, ShaderTessellatorPartitioning ds_partitioning, ShaderTessellatorOutputPrimitive ds_output_primitive,
+			GLSLVersion version, uint32_t glsl_rules);
+
+		void Clear();
+
+		uint32_t NumHits() const
+		{
+			return num_hits_;
+		}
+		uint32_t NumMisses() const
+		{
+			return num_misses_;
+		}
+
+	private:
+		struct Source
+		{
+			uint32_t dxbc_checksum[4];
+			uint32_t dxbc_size;
+			uint32_t options[6];
+
+			bool operator==(Source const & rhs) const;
+		};
+
+		struct Entry
+		{
+			Source source;
+			std::shared_ptr<DXBC2GLSL const> translation;
+			std::list<uint64_t>::iterator lru_iter;
+		};
+
+	private:
+		TranslationCache();
+
+		std::shared_ptr<DXBC2GLSL const> Load(uint64_t key, Source const & source, std::string const & folder);
+		void Save(uint64_t key, Source const & source, std::string const & folder, DXBC2GLSL const & translation);
+		void EvictEntries();
+
+	private:
+		mutable std::mutex mutex_;
+		std::string folder_;
+		std::unordered_map<uint64_t, Entry> translations_;
+		// Keys of translations_, the most recently used one first
+		std::list<uint64_t> lru_;
+		size_t max_entries_;
+
+		std::atomic<uint32_t> num_hits_;
+		std::atomic<uint32_t> num_misses_;
 	};
 }
 
@@ -38,6 +38,9 @@
 #define BOOST_ENABLE_ASSERT_HANDLER
 #include <boost/assert.hpp>
 
+#include <string>
+#include <string_view>
+
 using KlayGE::int8_t;
 using KlayGE::int32_t;
 using KlayGE::int64_t;
@@ -48,4 +51,103 @@ using KlayGE::uint64_t;
 
 bool ValidFloat(float f);
 
+// Appends text to a string, in place of a std::ostream. Numbers come out the same as from a std::ostream with the
+//  classic locale and the default precision, without going through the locale and the stream buffer.
+class StringBuilder
+{
+public:
+	explicit StringBuilder(std::string& str)
+		: str_(str), show_point_(false)
+	{
+	}
+
+	// Like std::ios::showpoint, floats keep the decimal point and trailing zeros
+	void ShowPoint(bool show)
+	{
+		show_point_ = show;
+	}
+
+	std::string const & Str() const
+	{
+		return str_;
+	}
+
+	StringBuilder& operator<<(char const * str)
+	{
+		str_.append(str);
+		return *this;
+	}
+	StringBuilder& operator<<(std::string const & str)
+	{
+		str_.append(str);
+		return *this;
+	}
+	StringBuilder& operator<<(std::string_view str)
+	{
+		str_.append(str.data(), str.size());
+		return *this;
+	}
+	StringBuilder& operator<<(char ch)
+	{
+		str_.push_back(ch);
+		return *this;
+	}
+	StringBuilder& operator<<(signed char ch)
+	{
+		str_.push_back(static_cast<char>(ch));
+		return *this;
+	}
+	StringBuilder& operator<<(unsigned char ch)
+	{
+		str_.push_back(static_cast<char>(ch));
+		return *this;
+	}
+	StringBuilder& operator<<(bool b)
+	{
+		str_.push_back(b ? '1' : '0');
+		return *this;
+	}
+	StringBuilder& operator<<(int val)
+	{
+		return this->AppendInt(val);
+	}
+	StringBuilder& operator<<(unsigned int val)
+	{
+		return this->AppendUInt(val);
+	}
+	StringBuilder& operator<<(long val)
+	{
+		return this->AppendInt(val);
+	}
+	StringBuilder& operator<<(unsigned long val)
+	{
+		return this->AppendUInt(val);
+	}
+	StringBuilder& operator<<(long long val)
+	{
+		return this->AppendInt(val);
+	}
+	StringBuilder& operator<<(unsigned long long val)
+	{
+		return this->AppendUInt(val);
+	}
+	StringBuilder& operator<<(float val)
+	{
+		return this->AppendFloat(val);
+	}
+	StringBuilder& operator<<(double val)
+	{
+		return this->AppendFloat(val);
+	}
+
+private:
+	StringBuilder& AppendInt(long long val);
+	StringBuilder& AppendUInt(unsigned long long val);
+	StringBuilder& AppendFloat(double val);
+
+private:
+	std::string& str_;
+	bool show_point_;
+};
+
 #endif		// _DXBC2GLSL_UTILS_HPP_
@@ -28,13 +28,111 @@
  * from http://www.klayge.org/licensing/.
  */
 
+
 #include <DXBC2GLSL/DXBC2GLSL.hpp>
 #include <DXBC2GLSL/DXBC.hpp>
 #include <DXBC2GLSL/GLSLGen.hpp>
+#include <DXBC2GLSL/Utils.hpp>
+#include <KFL/Hash.hpp>
+#include <KFL/Log.hpp>
+#include <KFL/Util.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <sstream>
+#include <thread>
+
+#include "TranslatorHash.hpp"
+
+namespace
+{
+	using namespace KlayGE;
+
+	// Changes whenever the file layout does. Changes of the translator are caught by DXBC2GLSL_TRANSLATOR_HASH.
+	uint32_t const TRANSLATION_CACHE_VERSION = 2;
+
+	void WriteU32(std::ostream& os, uint32_t val)
+	{
+		val = Native2LE(val);
+		os.write(reinterpret_cast<char const *>(&val), sizeof(val));
+	}
+
+	uint32_t ReadU32(std::istream& is)
+	{
+		uint32_t val = 0;
+		is.read(reinterpret_cast<char*>(&val), sizeof(val));
+		return LE2Native(val);
+	}
+
+	void WriteString(std::ostream& os, char const * str, size_t len)
+	{
+		WriteU32(os, static_cast<uint32_t>(len));
+		os.write(str, len);
+	}
+
+	// Fails when count records of at least record_size bytes can't fit in what's left before end
+	bool ReadCount(std::istream& is, std::streamoff end, uint32_t record_size, uint32_t& count)
+	{
+		count = ReadU32(is);
+		std::streamoff const pos = is.tellg();
+		return is && (pos >= 0) && (pos <= end)
+			&& (static_cast<uint64_t>(count) * record_size <= static_cast<uint64_t>(end - pos));
+	}
+
+	bool ReadString(std::istream& is, std::streamoff end, std::vector<char>& str)
+	{
+		uint32_t len;
+		if (!ReadCount(is, end, 1, len))
+		{
+			return false;
+		}
+		str.resize(len);
+		if (len > 0)
+		{
+			is.read(&str[0], len);
+		}
+		return static_cast<bool>(is);
+	}
+
+	void WriteParams(std::ostream& os, std::vector<DXBCSignatureParamDesc> const & params)
+	{
+		WriteU32(os, static_cast<uint32_t>(params.size()));
+		for (auto const & param : params)
+		{
+			WriteString(os, param.semantic_name, std::strlen(param.semantic_name));
+			WriteU32(os, param.semantic_index);
+			WriteU32(os, param.register_index);
+			WriteU32(os, param.system_value_type);
+			WriteU32(os, param.component_type);
+			WriteU32(os, param.mask | (param.read_write_mask << 8));
+			WriteU32(os, param.stream);
+			WriteU32(os, param.min_precision);
+		}
+	}
+
+	uint32_t const PARAM_RECORD_SIZE = 8 * sizeof(uint32_t);
+	uint32_t const VARIABLE_RECORD_SIZE = 2 * sizeof(uint32_t);
+	uint32_t const RESOURCE_RECORD_SIZE = 5 * sizeof(uint32_t);
+
+	std::string CachePath(std::string const & folder, uint64_t key)
+	{
+		std::ostringstream ss;
+		ss << folder << std::hex << std::setw(16) << std::setfill('0') << key << ".glsl_cache";
+		return ss.str();
+	}
+}
 
 namespace DXBC2GLSL
 {
+	DXBC2GLSL::DXBC2GLSL()
+		: names_(KlayGE::MakeSharedPtr<std::vector<char>>()),
+			gs_input_primitive_(SP_Undefined), max_gs_output_vertex_(0), gs_instance_count_(0),
+			ds_partitioning_(STP_Undefined), ds_output_primitive_(STOP_Undefined)
+	{
+	}
+
 	uint32_t DXBC2GLSL::DefaultRules(GLSLVersion version)
 	{
 		return GLSLGen::DefaultRules(version);
@@ -51,22 +149,259 @@ namespace DXBC2GLSL
 			bool has_gs, bool has_ps, ShaderTessellatorPartitioning ds_partitioning, ShaderTessellatorOutputPrimitive ds_output_primitive,
 			GLSLVersion version, uint32_t glsl_rules)
 	{
-		dxbc_ = DXBCParse(dxbc_data);
-		if (dxbc_)
+		std::shared_ptr<DXBCContainer> dxbc = DXBCParse(dxbc_data);
+		if (!dxbc || !dxbc->shader_chunk)
 		{
-			if (dxbc_->shader_chunk)
+			return;
+		}
+
+		std::shared_ptr<ShaderProgram> shader = ShaderParse(*dxbc);
+
+		{
+			// Keeps its capacity between shaders on the same thread, so the GLSL is generated without reallocations
+			//  once a large shader has been seen
+			static thread_local std::string buffer;
+			buffer.clear();
+
+			StringBuilder sb(buffer);
+			GLSLGen converter;
+			converter.FeedDXBC(shader, has_gs, has_ps, ds_partitioning, ds_output_primitive, version, glsl_rules);
+			converter.ToGLSL(sb);
+
+			glsl_ = buffer;
+		}
+
+		names_ = KlayGE::MakeSharedPtr<std::vector<char>>();
+
+		params_in_ = shader->params_in;
+		params_out_ = shader->params_out;
+		std::vector<uint32_t> in_names;
+		for (auto const & param : params_in_)
+		{
+			in_names.push_back(this->AddName(param.semantic_name));
+		}
+		std::vector<uint32_t> out_names;
+		for (auto const & param : params_out_)
+		{
+			out_names.push_back(this->AddName(param.semantic_name));
+		}
+
+		cbuffers_.resize(shader->cbuffers.size());
+		for (size_t i = 0; i < shader->cbuffers.size(); ++ i)
+		{
+			auto const & vars = shader->cbuffers[i].vars;
+			cbuffers_[i].resize(vars.size());
+			for (size_t j = 0; j < vars.size(); ++ j)
 			{
-				shader_ = ShaderParse(*dxbc_);
+				cbuffers_[i][j].name = this->AddName(vars[j].var_desc.name);
+				cbuffers_[i][j].used = vars[j].var_desc.flags ? true : false;
+			}
+		}
+
+		resources_.resize(shader->resource_bindings.size());
+		for (size_t i = 0; i < shader->resource_bindings.size(); ++ i)
+		{
+			auto const & binding = shader->resource_bindings[i];
+			resources_[i].name = this->AddName(binding.name);
+			resources_[i].bind_point = binding.bind_point;
+			resources_[i].type = binding.type;
+			resources_[i].dimension = binding.dimension;
+			resources_[i].used = !(binding.flags & DSIF_Unused);
+		}
+
+		gs_input_primitive_ = shader->gs_input_primitive;
+		gs_output_topology_ = shader->gs_output_topology;
+		max_gs_output_vertex_ = shader->max_gs_output_vertex;
+		gs_instance_count_ = shader->gs_instance_count;
+		ds_partitioning_ = shader->ds_tessellator_partitioning;
+		ds_output_primitive_ = shader->ds_tessellator_output_primitive;
+
+		this->ResolveParamNames(in_names, out_names);
+	}
 
-				std::stringstream ss;
+	bool DXBC2GLSL::StreamIn(std::istream& is)
+	{
+		// Every count and length is checked against the rest of the stream, so that a broken file can't make it allocate
+		//  more than the file holds
+		std::streamoff const begin = is.tellg();
+		is.seekg(0, std::ios_base::end);
+		std::streamoff const end = is.tellg();
+		is.seekg(begin);
+		if (!is || (begin < 0) || (end < begin))
+		{
+			return false;
+		}
 
-				GLSLGen converter;
-				converter.FeedDXBC(shader_, has_gs, has_ps, ds_partitioning, ds_output_primitive, version, glsl_rules);
-				converter.ToGLSL(ss);
+		std::vector<char> str;
+		if (!ReadString(is, end, str))
+		{
+			return false;
+		}
+		glsl_.assign(str.begin(), str.end());
+
+		names_ = KlayGE::MakeSharedPtr<std::vector<char>>();
 
-				glsl_ = ss.str();
+		std::vector<uint32_t> in_names;
+		std::vector<uint32_t> out_names;
+		for (int p = 0; p < 2; ++ p)
+		{
+			auto& params = p ? params_out_ : params_in_;
+			auto& names = p ? out_names : in_names;
+			uint32_t num_params;
+			if (!ReadCount(is, end, PARAM_RECORD_SIZE, num_params))
+			{
+				return false;
+			}
+			params.resize(num_params);
+			for (auto& param : params)
+			{
+				if (!ReadString(is, end, str))
+				{
+					return false;
+				}
+				str.push_back('\0');
+				names.push_back(this->AddName(&str[0]));
+
+				param.semantic_index = ReadU32(is);
+				param.register_index = ReadU32(is);
+				param.system_value_type = static_cast<ShaderName>(ReadU32(is));
+				param.component_type = static_cast<ShaderRegisterComponentType>(ReadU32(is));
+				uint32_t const masks = ReadU32(is);
+				param.mask = static_cast<uint8_t>(masks & 0xFF);
+				param.read_write_mask = static_cast<uint8_t>(masks >> 8);
+				param.stream = ReadU32(is);
+				param.min_precision = ReadU32(is);
+			}
+		}
+
+		uint32_t count;
+		if (!ReadCount(is, end, sizeof(uint32_t), count))
+		{
+			return false;
+		}
+		cbuffers_.resize(count);
+		for (auto& cbuffer : cbuffers_)
+		{
+			if (!ReadCount(is, end, VARIABLE_RECORD_SIZE, count))
+			{
+				return false;
+			}
+			cbuffer.resize(count);
+			for (auto& var : cbuffer)
+			{
+				if (!ReadString(is, end, str))
+				{
+					return false;
+				}
+				str.push_back('\0');
+				var.name = this->AddName(&str[0]);
+				var.used = ReadU32(is) ? true : false;
 			}
 		}
+
+		if (!ReadCount(is, end, RESOURCE_RECORD_SIZE, count))
+		{
+			return false;
+		}
+		resources_.resize(count);
+		for (auto& res : resources_)
+		{
+			if (!ReadString(is, end, str))
+			{
+				return false;
+			}
+			str.push_back('\0');
+			res.name = this->AddName(&str[0]);
+			res.bind_point = ReadU32(is);
+			res.type = static_cast<ShaderInputType>(ReadU32(is));
+			res.dimension = static_cast<ShaderSRVDimension>(ReadU32(is));
+			res.used = ReadU32(is) ? true : false;
+		}
+
+		gs_input_primitive_ = static_cast<ShaderPrimitive>(ReadU32(is));
+		if (!ReadCount(is, end, sizeof(uint32_t), count))
+		{
+			return false;
+		}
+		gs_output_topology_.resize(count);
+		for (auto& topology : gs_output_topology_)
+		{
+			topology = static_cast<ShaderPrimitiveTopology>(ReadU32(is));
+		}
+		max_gs_output_vertex_ = ReadU32(is);
+		gs_instance_count_ = ReadU32(is);
+		ds_partitioning_ = static_cast<ShaderTessellatorPartitioning>(ReadU32(is));
+		ds_output_primitive_ = static_cast<ShaderTessellatorOutputPrimitive>(ReadU32(is));
+
+		if (!is)
+		{
+			return false;
+		}
+
+		this->ResolveParamNames(in_names, out_names);
+		return true;
+	}
+
+	void DXBC2GLSL::StreamOut(std::ostream& os) const
+	{
+		WriteString(os, glsl_.c_str(), glsl_.size());
+
+		WriteParams(os, params_in_);
+		WriteParams(os, params_out_);
+
+		WriteU32(os, static_cast<uint32_t>(cbuffers_.size()));
+		for (auto const & cbuffer : cbuffers_)
+		{
+			WriteU32(os, static_cast<uint32_t>(cbuffer.size()));
+			for (auto const & var : cbuffer)
+			{
+				char const * name = &(*names_)[var.name];
+				WriteString(os, name, std::strlen(name));
+				WriteU32(os, var.used);
+			}
+		}
+
+		WriteU32(os, static_cast<uint32_t>(resources_.size()));
+		for (auto const & res : resources_)
+		{
+			char const * name = &(*names_)[res.name];
+			WriteString(os, name, std::strlen(name));
+			WriteU32(os, res.bind_point);
+			WriteU32(os, res.type);
+			WriteU32(os, res.dimension);
+			WriteU32(os, res.used);
+		}
+
+		WriteU32(os, gs_input_primitive_);
+		WriteU32(os, static_cast<uint32_t>(gs_output_topology_.size()));
+		for (auto topology : gs_output_topology_)
+		{
+			WriteU32(os, topology);
+		}
+		WriteU32(os, max_gs_output_vertex_);
+		WriteU32(os, gs_instance_count_);
+		WriteU32(os, ds_partitioning_);
+		WriteU32(os, ds_output_primitive_);
+	}
+
+	uint32_t DXBC2GLSL::AddName(char const * name)
+	{
+		uint32_t const offset = static_cast<uint32_t>(names_->size());
+		names_->insert(names_->end(), name, name + std::strlen(name) + 1);
+		return offset;
+	}
+
+	// The pool doesn't move any more when this is called
+	void DXBC2GLSL::ResolveParamNames(std::vector<uint32_t> const & in_names, std::vector<uint32_t> const & out_names)
+	{
+		for (size_t i = 0; i < params_in_.size(); ++ i)
+		{
+			params_in_[i].semantic_name = &(*names_)[in_names[i]];
+		}
+		for (size_t i = 0; i < params_out_.size(); ++ i)
+		{
+			params_out_[i].semantic_name = &(*names_)[out_names[i]];
+		}
 	}
 
 	std::string const & DXBC2GLSL::GLSLString() const
@@ -76,119 +411,355 @@ namespace DXBC2GLSL
 
 	uint32_t DXBC2GLSL::NumInputParams() const
 	{
-		return static_cast<uint32_t>(shader_->params_in.size());
+		return static_cast<uint32_t>(params_in_.size());
 	}
 
 	DXBCSignatureParamDesc const & DXBC2GLSL::InputParam(uint32_t index) const
 	{
-		BOOST_ASSERT(index < shader_->params_in.size());
-		return shader_->params_in[index];
+		BOOST_ASSERT(index < params_in_.size());
+		return params_in_[index];
 	}
 
 	uint32_t DXBC2GLSL::NumOutputParams() const
 	{
-		return static_cast<uint32_t>(shader_->params_out.size());
+		return static_cast<uint32_t>(params_out_.size());
 	}
 
 	DXBCSignatureParamDesc const & DXBC2GLSL::OutputParam(uint32_t index) const
 	{
-		BOOST_ASSERT(index < shader_->params_out.size());
-		return shader_->params_out[index];
+		BOOST_ASSERT(index < params_out_.size());
+		return params_out_[index];
 	}
 
 	uint32_t DXBC2GLSL::NumCBuffers() const
 	{
-		return static_cast<uint32_t>(shader_->cbuffers.size());
+		return static_cast<uint32_t>(cbuffers_.size());
 	}
 
 	uint32_t DXBC2GLSL::NumVariables(uint32_t cb_index) const
 	{
-		BOOST_ASSERT(cb_index < shader_->cbuffers.size());
-		return static_cast<uint32_t>(shader_->cbuffers[cb_index].vars.size());
+		BOOST_ASSERT(cb_index < cbuffers_.size());
+		return static_cast<uint32_t>(cbuffers_[cb_index].size());
 	}
 
 	char const * DXBC2GLSL::VariableName(uint32_t cb_index, uint32_t var_index) const
 	{
-		BOOST_ASSERT(cb_index < shader_->cbuffers.size());
-		BOOST_ASSERT(var_index < shader_->cbuffers[cb_index].vars.size());
-		return shader_->cbuffers[cb_index].vars[var_index].var_desc.name;
+		BOOST_ASSERT(cb_index < cbuffers_.size());
+		BOOST_ASSERT(var_index < cbuffers_[cb_index].size());
+		return &(*names_)[cbuffers_[cb_index][var_index].name];
 	}
 
 	bool DXBC2GLSL::VariableUsed(uint32_t cb_index, uint32_t var_index) const
 	{
-		BOOST_ASSERT(cb_index < shader_->cbuffers.size());
-		BOOST_ASSERT(var_index < shader_->cbuffers[cb_index].vars.size());
-		return shader_->cbuffers[cb_index].vars[var_index].var_desc.flags ? true : false;
+		BOOST_ASSERT(cb_index < cbuffers_.size());
+		BOOST_ASSERT(var_index < cbuffers_[cb_index].size());
+		return cbuffers_[cb_index][var_index].used;
 	}
 
 	uint32_t DXBC2GLSL::NumResources() const
 	{
-		return static_cast<uint32_t>(shader_->resource_bindings.size());
+		return static_cast<uint32_t>(resources_.size());
 	}
 
 	char const * DXBC2GLSL::ResourceName(uint32_t index) const
 	{
-		BOOST_ASSERT(index < shader_->resource_bindings.size());
-		return shader_->resource_bindings[index].name;
+		BOOST_ASSERT(index < resources_.size());
+		return &(*names_)[resources_[index].name];
 	}
 
 	uint32_t DXBC2GLSL::ResourceBindPoint(uint32_t index) const
 	{
-		BOOST_ASSERT(index < shader_->resource_bindings.size());
-		return shader_->resource_bindings[index].bind_point;
+		BOOST_ASSERT(index < resources_.size());
+		return resources_[index].bind_point;
 	}
 
 	ShaderInputType DXBC2GLSL::ResourceType(uint32_t index) const
 	{
-		BOOST_ASSERT(index < shader_->resource_bindings.size());
-		return shader_->resource_bindings[index].type;
+		BOOST_ASSERT(index < resources_.size());
+		return resources_[index].type;
 	}
 
 	ShaderSRVDimension DXBC2GLSL::ResourceDimension(uint32_t index) const
 	{
-		BOOST_ASSERT(index < shader_->resource_bindings.size());
-		return shader_->resource_bindings[index].dimension;
+		BOOST_ASSERT(index < resources_.size());
+		return resources_[index].dimension;
 	}
 
 	bool DXBC2GLSL::ResourceUsed(uint32_t index) const
 	{
-		BOOST_ASSERT(index < shader_->resource_bindings.size());
-		return !(shader_->resource_bindings[index].flags & DSIF_Unused);
+		BOOST_ASSERT(index < resources_.size());
+		return resources_[index].used;
 	}
 
 	ShaderPrimitive DXBC2GLSL::GSInputPrimitive() const
 	{
-		return shader_->gs_input_primitive;
+		return gs_input_primitive_;
 	}
 
 	uint32_t DXBC2GLSL::NumGSOutputTopology() const
 	{
-		return static_cast<uint32_t>(shader_->gs_output_topology.size());
+		return static_cast<uint32_t>(gs_output_topology_.size());
 	}
 
 	ShaderPrimitiveTopology DXBC2GLSL::GSOutputTopology(uint32_t index) const
 	{
-		BOOST_ASSERT(index < shader_->gs_output_topology.size());
-		return shader_->gs_output_topology[index];
+		BOOST_ASSERT(index < gs_output_topology_.size());
+		return gs_output_topology_[index];
 	}
 
 	uint32_t DXBC2GLSL::MaxGSOutputVertex() const
 	{
-		return shader_->max_gs_output_vertex;
+		return max_gs_output_vertex_;
 	}
 
 	uint32_t DXBC2GLSL::GSInstanceCount() const
 	{
-		return shader_->gs_instance_count;
+		return gs_instance_count_;
 	}
 
 	ShaderTessellatorPartitioning DXBC2GLSL::DSPartitioning() const
 	{
-		return shader_->ds_tessellator_partitioning;
+		return ds_partitioning_;
 	}
 
 	ShaderTessellatorOutputPrimitive DXBC2GLSL::DSOutputPrimitive() const
 	{
-		return shader_->ds_tessellator_output_primitive;
+		return ds_output_primitive_;
+	}
+
+
+	TranslationCache::TranslationCache()
+		: max_entries_(1024), num_hits_(0), num_misses_(0)
+	{
+	}
+
+	TranslationCache& TranslationCache::Instance()
+	{
+		static TranslationCache cache;
+		return cache;
+	}
+
+	void TranslationCache::Folder(std::string const & folder)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		folder_ = folder;
+	}
+
+	void TranslationCache::MaxEntries(size_t max_entries)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		max_entries_ = max_entries;
+		this->EvictEntries();
+	}
+
+	size_t TranslationCache::MaxEntries() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return max_entries_;
+	}
+
+	size_t TranslationCache::NumEntries() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return translations_.size();
+	}
+
+	std::shared_ptr<DXBC2GLSL const> TranslationCache::Translate(void const * dxbc_data,
+			bool has_gs, bool has_ps, ShaderTessellatorPartitioning ds_partitioning, ShaderTessellatorOutputPrimitive ds_output_primitive,
+			GLSLVersion version, uint32_t glsl_rules)
+	{
+		DXBCContainerHeader const * header = static_cast<DXBCContainerHeader const *>(dxbc_data);
+		if (KlayGE::LE2Native(header->fourcc) != FOURCC_DXBC)
+		{
+			auto translation = KlayGE::MakeSharedPtr<DXBC2GLSL>();
+			translation->FeedDXBC(dxbc_data, has_gs, has_ps, ds_partitioning, ds_output_primitive, version, glsl_rules);
+			return translation;
+		}
+
+		Source source;
+		for (uint32_t i = 0; i < 4; ++ i)
+		{
+			source.dxbc_checksum[i] = KlayGE::LE2Native(header->unk[i]);
+		}
+		source.dxbc_size = KlayGE::LE2Native(header->total_size);
+		source.options[0] = has_gs;
+		source.options[1] = has_ps;
+		source.options[2] = ds_partitioning;
+		source.options[3] = ds_output_primitive;
+		source.options[4] = version;
+		source.options[5] = glsl_rules;
+
+		uint64_t const translator_hash = DXBC2GLSL_TRANSLATOR_HASH;
+		uint64_t key = KlayGE::HashBytes64(dxbc_data, source.dxbc_size);
+		key = KlayGE::HashBytes64(key, source.options, sizeof(source.options));
+		key = KlayGE::HashBytes64(key, &translator_hash, sizeof(translator_hash));
+
+		std::string folder;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto iter = translations_.find(key);
+			if (iter != translations_.end())
+			{
+				if (iter->second.source == source)
+				{
+					++ num_hits_;
+					lru_.splice(lru_.begin(), lru_, iter->second.lru_iter);
+					return iter->second.translation;
+				}
+
+				// Another shader has the same key. This one is translated every time, and kept nowhere.
+				++ num_misses_;
+				auto translation = KlayGE::MakeSharedPtr<DXBC2GLSL>();
+				translation->FeedDXBC(dxbc_data, has_gs, has_ps, ds_partitioning, ds_output_primitive, version, glsl_rules);
+				return translation;
+			}
+			folder = folder_;
+		}
+
+		std::shared_ptr<DXBC2GLSL const> translation;
+		if (!folder.empty())
+		{
+			translation = this->Load(key, source, folder);
+		}
+		if (translation)
+		{
+			++ num_hits_;
+		}
+		else
+		{
+			++ num_misses_;
+
+			auto new_translation = KlayGE::MakeSharedPtr<DXBC2GLSL>();
+			new_translation->FeedDXBC(dxbc_data, has_gs, has_ps, ds_partitioning, ds_output_primitive, version, glsl_rules);
+			if (!folder.empty())
+			{
+				this->Save(key, source, folder, *new_translation);
+			}
+			translation = new_translation;
+		}
+
+		// Two threads could translate the same shader. The first one wins, so that all users share one copy.
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto const result = translations_.emplace(key, Entry{ source, translation, lru_.end() });
+		auto& entry = result.first->second;
+		if (result.second)
+		{
+			lru_.push_front(key);
+			entry.lru_iter = lru_.begin();
+		}
+		else if (entry.source == source)
+		{
+			translation = entry.translation;
+		}
+		this->EvictEntries();
+		return translation;
+	}
+
+	void TranslationCache::Clear()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		translations_.clear();
+		lru_.clear();
+		num_hits_ = 0;
+		num_misses_ = 0;
+	}
+
+	bool TranslationCache::Source::operator==(Source const & rhs) const
+	{
+		return (std::memcmp(dxbc_checksum, rhs.dxbc_checksum, sizeof(dxbc_checksum)) == 0)
+			&& (dxbc_size == rhs.dxbc_size)
+			&& (std::memcmp(options, rhs.options, sizeof(options)) == 0);
+	}
+
+	std::shared_ptr<DXBC2GLSL const> TranslationCache::Load(uint64_t key, Source const & source, std::string const & folder)
+	{
+		std::ifstream ifs(CachePath(folder, key).c_str(), std::ios_base::binary);
+		if (!ifs)
+		{
+			return std::shared_ptr<DXBC2GLSL const>();
+		}
+
+		uint32_t const fourcc = ReadU32(ifs);
+		uint32_t const version = ReadU32(ifs);
+		uint32_t const key_lo = ReadU32(ifs);
+		uint32_t const key_hi = ReadU32(ifs);
+		uint32_t const translator_hash_lo = ReadU32(ifs);
+		uint32_t const translator_hash_hi = ReadU32(ifs);
+		Source file_source;
+		for (auto& val : file_source.dxbc_checksum)
+		{
+			val = ReadU32(ifs);
+		}
+		file_source.dxbc_size = ReadU32(ifs);
+		for (auto& val : file_source.options)
+		{
+			val = ReadU32(ifs);
+		}
+		if (!ifs || (fourcc != KlayGE::MakeFourCC<'D', 'X', 'G', 'L'>::value) || (version != TRANSLATION_CACHE_VERSION)
+			|| (((static_cast<uint64_t>(key_hi) << 32) | key_lo) != key)
+			|| (((static_cast<uint64_t>(translator_hash_hi) << 32) | translator_hash_lo) != DXBC2GLSL_TRANSLATOR_HASH)
+			|| !(file_source == source))
+		{
+			return std::shared_ptr<DXBC2GLSL const>();
+		}
+
+		auto translation = KlayGE::MakeSharedPtr<DXBC2GLSL>();
+		if (!translation->StreamIn(ifs))
+		{
+			return std::shared_ptr<DXBC2GLSL const>();
+		}
+		return translation;
+	}
+
+	void TranslationCache::Save(uint64_t key, Source const & source, std::string const & folder, DXBC2GLSL const & translation)
+	{
+		// Written to a temporary file first, so that another process never reads a half written one
+		std::string const path = CachePath(folder, key);
+		std::ostringstream tmp_name;
+		tmp_name << path << '.' << std::this_thread::get_id();
+		{
+			std::ofstream ofs(tmp_name.str().c_str(), std::ios_base::binary);
+			if (!ofs)
+			{
+				KlayGE::LogWarn("Can't write the GLSL translation to %s", tmp_name.str().c_str());
+				return;
+			}
+
+			WriteU32(ofs, KlayGE::MakeFourCC<'D', 'X', 'G', 'L'>::value);
+			WriteU32(ofs, TRANSLATION_CACHE_VERSION);
+			WriteU32(ofs, static_cast<uint32_t>(key & 0xFFFFFFFFU));
+			WriteU32(ofs, static_cast<uint32_t>(key >> 32));
+			WriteU32(ofs, static_cast<uint32_t>(DXBC2GLSL_TRANSLATOR_HASH & 0xFFFFFFFFU));
+			WriteU32(ofs, static_cast<uint32_t>(DXBC2GLSL_TRANSLATOR_HASH >> 32));
+			for (auto val : source.dxbc_checksum)
+			{
+				WriteU32(ofs, val);
+			}
+			WriteU32(ofs, source.dxbc_size);
+			for (auto val : source.options)
+			{
+				WriteU32(ofs, val);
+			}
+			translation.StreamOut(ofs);
+			ofs.close();
+			if (!ofs)
+			{
+				KlayGE::LogWarn("Can't write the GLSL translation to %s", tmp_name.str().c_str());
+				std::remove(tmp_name.str().c_str());
+				return;
+			}
+		}
+		std::remove(path.c_str());
+		std::rename(tmp_name.str().c_str(), path.c_str());
+	}
+
+	// The translations dropped here stay alive as long as a shader uses them
+	void TranslationCache::EvictEntries()
+	{
+		while (translations_.size() > max_entries_)
+		{
+			translations_.erase(lru_.back());
+			lru_.pop_back();
+		}
 	}
 }
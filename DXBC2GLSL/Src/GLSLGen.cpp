@@ -265,7 +265,7 @@ void GLSLGen::FeedDXBC(std::shared_ptr<ShaderProgram> const & program,
 	this->FindHSJoinPhases();
 }
 
-void GLSLGen::ToGLSL(std::ostream& out)
+void GLSLGen::ToGLSL(StringBuilder& out)
 {
 	if (glsl_rules_ & GSR_VersionDecl)
 	{
@@ -299,8 +299,8 @@ void GLSLGen::ToGLSL(std::ostream& out)
 
 	if (glsl_rules_ & GSR_Precision)
 	{
-		out << "precision highp float;" << std::endl;
-		out << "precision highp int;" << std::endl << std::endl;
+		out << "precision highp float;\n";
+		out << "precision highp int;\n\n";
 	}
 
 	if ((ST_PS == shader_type_) && (glsl_rules_ & GSR_EXTShaderTextureLod))
@@ -496,7 +496,7 @@ void GLSLGen::ToGLSL(std::ostream& out)
 	out << "}" << "\n";
 }
 
-void GLSLGen::ToDeclarations(std::ostream& out)
+void GLSLGen::ToDeclarations(StringBuilder& out)
 {
 	for (auto& po : program_->params_out)
 	{
@@ -519,7 +519,7 @@ void GLSLGen::ToDeclarations(std::ostream& out)
 	}
 }
 
-void GLSLGen::ToDclInterShaderInputRecords(std::ostream& out)
+void GLSLGen::ToDclInterShaderInputRecords(StringBuilder& out)
 {
 	for (size_t i = 0; i < program_->params_in.size(); ++ i)
 	{
@@ -664,7 +664,7 @@ void GLSLGen::ToDclInterShaderInputRecords(std::ostream& out)
 	}
 }
 
-void GLSLGen::ToDclInterShaderOutputRecords(std::ostream& out)
+void GLSLGen::ToDclInterShaderOutputRecords(StringBuilder& out)
 {
 	for (size_t i = 0; i < program_->params_out.size(); ++ i)
 	{
@@ -790,7 +790,7 @@ void GLSLGen::ToDclInterShaderOutputRecords(std::ostream& out)
 	}
 }
 
-void GLSLGen::ToDeclInterShaderInputRegisters(std::ostream& out) const
+void GLSLGen::ToDeclInterShaderInputRegisters(StringBuilder& out) const
 {
 	std::vector<RegisterDesc> input_registers;
 	for (auto const & sig_desc : program_->params_in)
@@ -883,7 +883,7 @@ void GLSLGen::ToDeclInterShaderInputRegisters(std::ostream& out) const
 	}
 }
 
-void GLSLGen::ToCopyToInterShaderInputRegisters(std::ostream& out) const
+void GLSLGen::ToCopyToInterShaderInputRegisters(StringBuilder& out) const
 {
 	uint32_t num_vertices = 1;
 	if (ST_GS == shader_type_)
@@ -1093,7 +1093,7 @@ void GLSLGen::ToCopyToInterShaderInputRegisters(std::ostream& out) const
 	}
 }
 
-void GLSLGen::ToDeclInterShaderOutputRegisters(std::ostream& out) const
+void GLSLGen::ToDeclInterShaderOutputRegisters(StringBuilder& out) const
 {
 	std::vector<RegisterDesc> output_dcl_record;
 
@@ -1170,7 +1170,7 @@ void GLSLGen::ToDeclInterShaderOutputRegisters(std::ostream& out) const
 	}
 }
 
-void GLSLGen::ToCopyToInterShaderOutputRecords(std::ostream& out) const
+void GLSLGen::ToCopyToInterShaderOutputRecords(StringBuilder& out) const
 {
 	for (auto const & sig_desc : program_->params_out)
 	{
@@ -1306,7 +1306,7 @@ void GLSLGen::ToCopyToInterShaderOutputRecords(std::ostream& out) const
 	}
 }
 
-void GLSLGen::ToDeclaration(std::ostream& out, ShaderDecl const & dcl)
+void GLSLGen::ToDeclaration(StringBuilder& out, ShaderDecl const & dcl)
 {
 	ShaderImmType sit = GetOpInType(dcl.opcode);
 	switch (dcl.opcode)
@@ -1839,7 +1839,7 @@ void GLSLGen::ToDeclaration(std::ostream& out, ShaderDecl const & dcl)
 	}
 }
 
-void GLSLGen::ToInstruction(std::ostream& out, ShaderInstruction const & insn) const
+void GLSLGen::ToInstruction(StringBuilder& out, ShaderInstruction const & insn) const
 {
 	int selector[4] = { 0 };
 	ShaderImmType oit = GetOpInType(insn.opcode);
@@ -5687,7 +5687,7 @@ void GLSLGen::ToInstruction(std::ostream& out, ShaderInstruction const & insn) c
 	}
 }
 
-void GLSLGen::ToOperands(std::ostream& out, ShaderOperand const & op, uint32_t imm_as_type,
+void GLSLGen::ToOperands(StringBuilder& out, ShaderOperand const & op, uint32_t imm_as_type,
 		bool mask, bool dcl_array, bool no_swizzle, bool no_idx, bool no_cast, ShaderInputType const & sit) const
 {
 	ShaderImmType imm_type = static_cast<ShaderImmType>(imm_as_type & 0xFF);
@@ -5712,7 +5712,7 @@ void GLSLGen::ToOperands(std::ostream& out, ShaderOperand const & op, uint32_t i
 				// Normalized float test
 				if (ValidFloat(op.imm_values[0].f32))
 				{
-					out.setf(std::ios::showpoint);
+					out.ShowPoint(true);
 					out << op.imm_values[0].f32;
 				}
 				else
@@ -5729,7 +5729,7 @@ void GLSLGen::ToOperands(std::ostream& out, ShaderOperand const & op, uint32_t i
 				if ((0xC0490FDB == op.imm_values[0].u32) || (0x3F800000 == op.imm_values[0].u32))
 				{
 					// Hack for predefined magic value
-					out.setf(std::ios::showpoint);
+					out.ShowPoint(true);
 					out << op.imm_values[0].f32;
 				}
 				else
@@ -5773,7 +5773,7 @@ void GLSLGen::ToOperands(std::ostream& out, ShaderOperand const & op, uint32_t i
 					// Normalized float test
 					if (ValidFloat(op.imm_values[i].f32))
 					{
-						out.setf(std::ios::showpoint);
+						out.ShowPoint(true);
 						out << op.imm_values[i].f32;
 					}
 					else
@@ -6180,7 +6180,7 @@ ShaderImmType GLSLGen::OperandAsType(ShaderOperand const & op, uint32_t imm_as_t
 	return as_type;
 }
 
-void GLSLGen::ToOperandName(std::ostream& out, ShaderOperand const & op, ShaderImmType as_type,
+void GLSLGen::ToOperandName(StringBuilder& out, ShaderOperand const & op, ShaderImmType as_type,
 		bool* need_idx, bool* need_comps, bool no_swizzle, bool no_idx, ShaderInputType const & sit) const
 {
 	*need_comps = true;
@@ -6833,7 +6833,7 @@ void GLSLGen::ToOperandName(std::ostream& out, ShaderOperand const & op, ShaderI
 	}
 }
 
-int GLSLGen::ToSingleComponentSelector(std::ostream& out, ShaderOperand const & op, int i, bool dot) const
+int GLSLGen::ToSingleComponentSelector(StringBuilder& out, ShaderOperand const & op, int i, bool dot) const
 {
 	if ((SOT_IMMEDIATE32 == op.type) || (SOT_IMMEDIATE64 == op.type))
 	{
@@ -6892,7 +6892,7 @@ int GLSLGen::GetComponentSelector(ShaderOperand const & op, int i) const
 	return comp;
 }
 
-void GLSLGen::ToComponentSelectors(std::ostream& out, ShaderOperand const & op, bool dot, uint32_t offset) const
+void GLSLGen::ToComponentSelectors(StringBuilder& out, ShaderOperand const & op, bool dot, uint32_t offset) const
 {
 	if ((op.type != SOT_IMMEDIATE32) && (op.type != SOT_IMMEDIATE64))
 	{
@@ -7393,7 +7393,7 @@ void GLSLGen::FindTempDcls()
 	temp_dcls_.insert(temp_dcls_.end(), indexable_temp_dcls.begin(), indexable_temp_dcls.end());
 }
 
-void GLSLGen::ToTemps(std::ostream& out, ShaderDecl const & dcl)
+void GLSLGen::ToTemps(StringBuilder& out, ShaderDecl const & dcl)
 {
 	switch (dcl.opcode)
 	{
@@ -7421,7 +7421,7 @@ void GLSLGen::ToTemps(std::ostream& out, ShaderDecl const & dcl)
 	}
 }
 
-void GLSLGen::ToImmConstBuffer(std::ostream& out, ShaderDecl const & dcl)
+void GLSLGen::ToImmConstBuffer(StringBuilder& out, ShaderDecl const & dcl)
 {
 	uint32_t vector_num = dcl.num / 4;
 	float const * data = reinterpret_cast<float const *>(&dcl.data[0]);
@@ -7435,7 +7435,7 @@ void GLSLGen::ToImmConstBuffer(std::ostream& out, ShaderDecl const & dcl)
 			// Normalized float test
 			if (ValidFloat(data[i * 4 + j]))
 			{
-				out.setf(std::ios::showpoint);
+				out.ShowPoint(true);
 				out << data[i * 4 + j];
 			}
 			else
@@ -7476,7 +7476,7 @@ uint32_t GLSLGen::GetMinComponentSelector(ShaderOperand const & op) const
 	return min_idx;
 }
 
-void GLSLGen::ToDefaultValue(std::ostream& out, DXBCShaderVariable const & var, uint32_t offset)
+void GLSLGen::ToDefaultValue(StringBuilder& out, DXBCShaderVariable const & var, uint32_t offset)
 {
 	char const * p_base = static_cast<char const *>(var.var_desc.default_val) + offset;
 	switch (var.type_desc.var_class)
@@ -7579,7 +7579,7 @@ void GLSLGen::ToDefaultValue(std::ostream& out, DXBCShaderVariable const & var,
 	}
 }
 
-void GLSLGen::ToDefaultValue(std::ostream& out, char const * value, ShaderVariableType type)
+void GLSLGen::ToDefaultValue(StringBuilder& out, char const * value, ShaderVariableType type)
 {
 	switch (type)
 	{
@@ -7610,7 +7610,7 @@ void GLSLGen::ToDefaultValue(std::ostream& out, char const * value, ShaderVariab
 	}
 }
 
-void GLSLGen::ToDefaultValue(std::ostream& out, DXBCShaderVariable const & var)
+void GLSLGen::ToDefaultValue(StringBuilder& out, DXBCShaderVariable const & var)
 {
 	if (0 == var.type_desc.elements)
 	{
@@ -7738,7 +7738,7 @@ uint32_t GLSLGen::ComponentSelectorFromCount(uint32_t count) const
 	return comps_index;
 }
 
-void GLSLGen::ToComponentSelector(std::ostream& out, uint32_t comps, uint32_t offset) const
+void GLSLGen::ToComponentSelector(StringBuilder& out, uint32_t comps, uint32_t offset) const
 {
 	for (int i = 0; i < 4; ++ i)
 	{
@@ -7894,7 +7894,7 @@ void GLSLGen::FindHSControlPointPhase()
 	}
 }
 
-void GLSLGen::ToDclInterShaderPatchConstantRegisters(std::ostream& out)
+void GLSLGen::ToDclInterShaderPatchConstantRegisters(StringBuilder& out)
 {
 	uint32_t num_registers = GetNumPatchConstantSignatureRegisters(program_->params_patch);
 	if (num_registers > 0)
@@ -7903,7 +7903,7 @@ void GLSLGen::ToDclInterShaderPatchConstantRegisters(std::ostream& out)
 	}
 }
 
-void GLSLGen::ToHSForkPhases(std::ostream& out)
+void GLSLGen::ToHSForkPhases(StringBuilder& out)
 {
 	// set enter_hs_fork_phase to true;
 	if (!hs_fork_phases_.empty())
@@ -7948,7 +7948,7 @@ void GLSLGen::ToHSForkPhases(std::ostream& out)
 	enter_hs_fork_phase_ = false;
 }
 
-void GLSLGen::ToHSJoinPhases(std::ostream& out)
+void GLSLGen::ToHSJoinPhases(StringBuilder& out)
 {
 	// set enter_hs_fork_phase to true;
 	if (!hs_join_phases_.empty())
@@ -7993,7 +7993,7 @@ void GLSLGen::ToHSJoinPhases(std::ostream& out)
 	enter_hs_join_phase_ = false;
 }
 
-void GLSLGen::ToCopyToInterShaderPatchConstantRecords(std::ostream& out)const 
+void GLSLGen::ToCopyToInterShaderPatchConstantRecords(StringBuilder& out)const 
 {
 	for (auto const & sig_desc : program_->params_patch)
 	{
@@ -8045,7 +8045,7 @@ void GLSLGen::ToCopyToInterShaderPatchConstantRecords(std::ostream& out)const
 	}
 }
 
-void GLSLGen::ToHSControlPointPhase(std::ostream& out)
+void GLSLGen::ToHSControlPointPhase(StringBuilder& out)
 {
 	if (hs_control_point_phase_.empty())
 	{
@@ -8066,7 +8066,7 @@ void GLSLGen::ToHSControlPointPhase(std::ostream& out)
 	}
 }
 
-void GLSLGen::ToDefaultHSControlPointPhase(std::ostream& out)const
+void GLSLGen::ToDefaultHSControlPointPhase(StringBuilder& out)const
 {
 	//OutputRecords = InputRecords
 	for (size_t i = 0; i < program_->params_out.size(); ++ i)
@@ -8094,7 +8094,7 @@ void GLSLGen::ToDefaultHSControlPointPhase(std::ostream& out)const
 	out << "\n";
 }
 
-void GLSLGen::ToDclInterShaderPatchConstantRecords(std::ostream& out)
+void GLSLGen::ToDclInterShaderPatchConstantRecords(StringBuilder& out)
 {
 	for (size_t i = 0; i < program_->params_patch.size(); ++ i)
 	{
@@ -8183,7 +8183,7 @@ void GLSLGen::ToDclInterShaderPatchConstantRecords(std::ostream& out)
 	}
 }
 
-void GLSLGen::ToCopyToInterShaderPatchConstantRegisters(std::ostream& out)const
+void GLSLGen::ToCopyToInterShaderPatchConstantRegisters(StringBuilder& out)const
 {
 	for (auto const & sig_desc : program_->params_patch)
 	{
@@ -33,6 +33,7 @@
 #include <sstream>
 #include <limits>
 #include <cmath>
+#include <cstdio>
 
 namespace
 {
@@ -88,3 +89,48 @@ bool ValidFloat(float f)
 		&& ((f <= std::numeric_limits<float>::max())
 			|| (-f <= std::numeric_limits<float>::max())));
 }
+
+StringBuilder& StringBuilder::AppendInt(long long val)
+{
+	if (val < 0)
+	{
+		str_.push_back('-');
+		return this->AppendUInt(0ULL - static_cast<unsigned long long>(val));
+	}
+	else
+	{
+		return this->AppendUInt(static_cast<unsigned long long>(val));
+	}
+}
+
+StringBuilder& StringBuilder::AppendUInt(unsigned long long val)
+{
+	char buf[24];
+	char* p = buf + sizeof(buf);
+	do
+	{
+		-- p;
+		*p = static_cast<char>('0' + val % 10);
+		val /= 10;
+	} while (val != 0);
+	str_.append(p, buf + sizeof(buf));
+	return *this;
+}
+
+StringBuilder& StringBuilder::AppendFloat(double val)
+{
+	// The same conversion std::num_put does with the default precision of 6
+	char buf[64];
+	int const len = std::snprintf(buf, sizeof(buf), show_point_ ? "%#g" : "%g", val);
+	for (int i = 0; i < len; ++ i)
+	{
+		// snprintf follows the C locale, the decimal point of the classic locale is always '.'
+		char const ch = buf[i];
+		if (((ch < '0') || (ch > '9')) && ((ch < 'a') || (ch > 'z')) && (ch != '-') && (ch != '+'))
+		{
+			buf[i] = '.';
+		}
+	}
+	str_.append(buf, len);
+	return *this;
+}
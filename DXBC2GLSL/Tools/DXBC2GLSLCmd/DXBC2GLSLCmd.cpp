@@ -29,9 +29,16 @@
  */
 
 #include <DXBC2GLSL/DXBC2GLSL.hpp>
+#include <KFL/CXX17/filesystem.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 void usage()
 {
@@ -41,9 +48,132 @@ void usage()
 	std::cerr << "Latest version available from http://www.klayge.org/\n";
 	std::cerr << "\n";
 	std::cerr << "Usage: DXBC2GLSLCmd FILE [OUTPUT]\n";
+	std::cerr << "       DXBC2GLSLCmd -batch INPUT_DIR OUTPUT_DIR\n";
+	std::cerr << "  -batch converts all the files under INPUT_DIR on all cores, to FILE.glsl under OUTPUT_DIR\n";
 	std::cerr << std::endl;
 }
 
+bool ReadFile(std::string const & name, std::vector<char>& data)
+{
+	std::ifstream in(name.c_str(), std::ios_base::in | std::ios_base::binary);
+	if (!in)
+	{
+		return false;
+	}
+
+	in.seekg(0, std::ios_base::end);
+	data.resize(static_cast<size_t>(in.tellg()));
+	in.seekg(0, std::ios_base::beg);
+	if (!data.empty())
+	{
+		in.read(&data[0], data.size());
+	}
+	return static_cast<bool>(in);
+}
+
+int Batch(std::string const & input_dir, std::string const & output_dir)
+{
+	std::vector<std::filesystem::path> inputs;
+	for (std::filesystem::recursive_directory_iterator iter(input_dir), end; iter != end; ++ iter)
+	{
+		if (std::filesystem::is_regular_file(iter->path()))
+		{
+			inputs.push_back(iter->path());
+		}
+	}
+	std::sort(inputs.begin(), inputs.end());
+
+	// The errors are reported in the order of the files, after all the threads finish
+	std::vector<std::string> errors(inputs.size());
+	std::atomic<uint32_t> next_input(0);
+	std::atomic<uint32_t> num_bytes(0);
+
+	auto worker = [&]()
+	{
+		std::vector<char> data;
+		for (;;)
+		{
+			uint32_t const index = next_input ++;
+			if (index >= inputs.size())
+			{
+				break;
+			}
+
+			std::filesystem::path const & input = inputs[index];
+			if (!ReadFile(input.string(), data))
+			{
+				errors[index] = "Can't read the file";
+				continue;
+			}
+			if ((data.size() < sizeof(DXBCContainerHeader))
+				|| (KlayGE::LE2Native(reinterpret_cast<DXBCContainerHeader const *>(&data[0])->total_size) > data.size()))
+			{
+				errors[index] = "Not a DXBC file";
+				continue;
+			}
+
+			try
+			{
+				auto translation = DXBC2GLSL::TranslationCache::Instance().Translate(&data[0],
+					true, true, STP_Fractional_Odd, STOP_Triangle_CW, GSV_430,
+					DXBC2GLSL::DXBC2GLSL::DefaultRules(GSV_430));
+				if (translation->GLSLString().empty())
+				{
+					errors[index] = "Not a shader";
+					continue;
+				}
+
+				std::string rel_name = input.string().substr(input_dir.size());
+				while (!rel_name.empty() && ((rel_name[0] == '/') || (rel_name[0] == '\\')))
+				{
+					rel_name.erase(0, 1);
+				}
+				std::filesystem::path const output = std::filesystem::path(output_dir) / (rel_name + ".glsl");
+				std::filesystem::create_directories(output.parent_path());
+				std::ofstream out(output.string().c_str(), std::ios_base::binary);
+				out << translation->GLSLString();
+				num_bytes += static_cast<uint32_t>(translation->GLSLString().size());
+			}
+			catch (std::exception& ex)
+			{
+				errors[index] = ex.what();
+			}
+		}
+	};
+
+	auto const start = std::chrono::high_resolution_clock::now();
+
+	std::vector<std::thread> threads(std::max(1U, std::thread::hardware_concurrency()));
+	for (auto& thread : threads)
+	{
+		thread = std::thread(worker);
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	double const time = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+	uint32_t num_errors = 0;
+	for (size_t i = 0; i < inputs.size(); ++ i)
+	{
+		if (!errors[i].empty())
+		{
+			std::cout << "Error(s) in conversion of " << inputs[i].string() << ":" << std::endl;
+			std::cout << errors[i] << std::endl;
+			++ num_errors;
+		}
+	}
+
+	uint32_t const num_shaders = static_cast<uint32_t>(inputs.size()) - num_errors;
+	std::cout << num_shaders << " shaders (" << DXBC2GLSL::TranslationCache::Instance().NumHits() << " duplicated), "
+		<< num_bytes << " bytes of GLSL, " << num_errors << " errors, " << threads.size() << " threads" << std::endl;
+	std::cout << time << " s, " << (time > 0 ? num_shaders / time : 0) << " shaders/s" << std::endl;
+
+	return num_errors > 0 ? 1 : 0;
+}
+
 int main(int argc, char** argv)
 {
 	if (argc < 2)
@@ -52,6 +182,16 @@ int main(int argc, char** argv)
 		return 1;
 	}
 
+	if (std::string(argv[1]) == "-batch")
+	{
+		if (argc < 4)
+		{
+			usage();
+			return 1;
+		}
+		return Batch(argv[2], argv[3]);
+	}
+
 	std::vector<char> data;
 	std::ifstream in(argv[1], std::ios_base::in | std::ios_base::binary);
 	std::ofstream out;
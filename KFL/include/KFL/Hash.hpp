@@ -114,6 +114,33 @@ namespace KlayGE
 		HashRange(seed, first, last);
 		return seed;
 	}
+
+	// 64-bit FNV-1a. Unlike the hashes above, it's the same on all targets, so it can name things that are stored.
+	uint64_t const HASH64_SEED = 0xCBF29CE484222325ULL;
+
+	inline uint64_t HashBytes64(uint64_t seed, void const * data, size_t size)
+	{
+		uint8_t const * p = static_cast<uint8_t const *>(data);
+		for (size_t i = 0; i < size; ++ i)
+		{
+			seed ^= p[i];
+			seed *= 0x100000001B3ULL;
+		}
+		return seed;
+	}
+
+	inline uint64_t HashBytes64(void const * data, size_t size)
+	{
+		return HashBytes64(HASH64_SEED, data, size);
+	}
+
+	// With the size, so that consecutive strings can't run into each other
+	inline uint64_t HashString64(uint64_t seed, std::string_view str)
+	{
+		uint32_t const size = static_cast<uint32_t>(str.size());
+		seed = HashBytes64(seed, &size, sizeof(size));
+		return HashBytes64(seed, str.data(), str.size());
+	}
 }
 
 #endif		// _KFL_HASH_HPP
@@ -33,8 +33,145 @@
 
 #pragma once
 
+#include <KFL/PreDeclare.hpp>
+#include <KFL/CXX17/string_view.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
 namespace KlayGE
 {
+	enum LogSeverity
+	{
+		LS_Info,
+		LS_Warn,
+		LS_Error
+	};
+
+	// Where the lines go. Called on the logging thread only, with the lines of one batch in time order.
+	class LogSink : boost::noncopyable
+	{
+	public:
+		virtual ~LogSink();
+
+		// line is the whole line without the line break. The message alone is the tail starting at msg_offset.
+		virtual void Write(LogSeverity severity, std::string_view line, size_t msg_offset) = 0;
+		// After each batch
+		virtual void Flush();
+	};
+	typedef std::shared_ptr<LogSink> LogSinkPtr;
+
+	// std::clog, or logcat on Android
+	class ConsoleLogSink : public LogSink
+	{
+	public:
+		void Write(LogSeverity severity, std::string_view line, size_t msg_offset) override;
+		void Flush() override;
+	};
+
+	// Starts a new file when the current one reaches max_size. The old ones are renamed to path.1, path.2, and so
+	//  on, up to path.<max_backups>.
+	class RotatingFileLogSink : public LogSink
+	{
+	public:
+		RotatingFileLogSink(std::string const & path, uint64_t max_size, uint32_t max_backups);
+
+		void Write(LogSeverity severity, std::string_view line, size_t msg_offset) override;
+		void Flush() override;
+
+	private:
+		void Rotate();
+
+	private:
+		std::string path_;
+		uint64_t max_size_;
+		uint32_t max_backups_;
+
+		std::ofstream file_;
+		uint64_t size_;
+	};
+
+	// Messages are formatted and time stamped on the calling thread, and pushed to a lock-free queue owned by that
+	//  thread. A background thread drains the queues, sorts the messages by time and writes them to the sinks.
+	//  Errors are flushed before the call returns.
+	class Logger : boost::noncopyable
+	{
+		struct ThreadQueue;
+
+	public:
+		static Logger& Instance();
+
+		~Logger();
+
+		void MinSeverity(LogSeverity severity);
+		LogSeverity MinSeverity() const;
+
+		void AddSink(LogSinkPtr const & sink);
+		void DelSink(LogSinkPtr const & sink);
+		void ClearSinks();
+
+		void Log(LogSeverity severity, char const * fmt, ...);
+		void LogV(LogSeverity severity, char const * fmt, va_list args);
+
+		// Returns after everything logged before it is written
+		void Flush();
+
+	private:
+		Logger();
+
+		ThreadQueue* CurrentThreadQueue();
+		void Push(ThreadQueue& queue, LogSeverity severity, uint64_t time, char const * msg, uint32_t len);
+		void WakeUp();
+
+		void ThreadFunc();
+		void DrainQueues();
+		void WriteBatch();
+
+	private:
+		std::atomic<int32_t> min_severity_;
+
+		std::mutex queues_mutex_;
+		std::vector<std::unique_ptr<ThreadQueue>> queues_;
+		uint32_t next_thread_id_;
+
+		std::mutex sinks_mutex_;
+		std::vector<LogSinkPtr> sinks_;
+
+		// Time stamps are from the steady clock, in ns. They're converted to the wall clock, in us, when written.
+		uint64_t start_steady_;
+		uint64_t start_wall_;
+
+		struct Entry
+		{
+			uint64_t time;
+			uint32_t thread_id;
+			LogSeverity severity;
+			uint32_t offset;
+			uint32_t len;
+		};
+		std::vector<Entry> batch_;
+		std::vector<char> batch_text_;
+		std::string line_;
+
+		std::mutex wake_mutex_;
+		std::condition_variable wake_cond_;
+		std::condition_variable flushed_cond_;
+		uint64_t flush_requested_;
+		uint64_t flush_done_;
+		bool wake_;
+		bool quit_;
+		std::thread thread_;
+	};
+
 	void LogInfo(char const * fmt, ...);
 	void LogWarn(char const * fmt, ...);
 	void LogError(char const * fmt, ...);
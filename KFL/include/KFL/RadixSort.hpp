@@ -0,0 +1,93 @@
+/**
+ * @file RadixSort.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KFL, a subproject of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#ifndef _KFL_RADIXSORT_HPP
+#define _KFL_RADIXSORT_HPP
+
+#include <KFL/Types.hpp>
+
+#include <array>
+#include <vector>
+
+namespace KlayGE
+{
+	// Maps the float to an uint32_t with the same order
+	inline uint32_t SortableFloat(float f)
+	{
+		union FNI
+		{
+			float f;
+			uint32_t i;
+		} fni;
+		fni.f = f;
+		return (fni.i & 0x80000000U) ? ~fni.i : (fni.i | 0x80000000U);
+	}
+
+	// Stable LSD radix sort by the 64-bit key(item), 8 bits a pass, from bit first_bit up. Passes where all items share
+	//  the digit are skipped. The result ends up in items, scratch keeps its capacity for the next call.
+	template <typename T, typename KeyFunc>
+	void RadixSort(std::vector<T>& items, std::vector<T>& scratch, KeyFunc key, uint32_t first_bit = 0)
+	{
+		if (items.size() < 2)
+		{
+			return;
+		}
+
+		scratch.resize(items.size());
+		std::array<uint32_t, 256> counts;
+		for (uint32_t shift = first_bit; shift < 64; shift += 8)
+		{
+			counts.fill(0);
+			for (auto const & item : items)
+			{
+				++ counts[(key(item) >> shift) & 0xFF];
+			}
+			if (counts[(key(items[0]) >> shift) & 0xFF] == items.size())
+			{
+				continue;
+			}
+
+			uint32_t offset = 0;
+			for (auto& count : counts)
+			{
+				uint32_t const c = count;
+				count = offset;
+				offset += c;
+			}
+			for (auto const & item : items)
+			{
+				scratch[counts[(key(item) >> shift) & 0xFF] ++] = item;
+			}
+			items.swap(scratch);
+		}
+	}
+}
+
+#endif		// _KFL_RADIXSORT_HPP
@@ -34,6 +34,7 @@
 #pragma once
 
 #include <KFL/PreDeclare.hpp>
+#include <KFL/Math.hpp>
 
 #if defined(KLAYGE_SSE_SUPPORT) && !defined(KLAYGE_COMPILER_CLANGC2)
 	#define SIMD_MATH_SSE
@@ -252,6 +253,45 @@ namespace KlayGE
 		void ObliqueClipping(SIMDMatrixF4& proj, SIMDVectorF4 const & clip_plane);
 
 
+		// Bound
+		///////////////////////////////////////////////////////////////////////////////
+
+		// Tests num AABBs, stored as SoA, against a frustum, 8 or 4 boxes at a time. The 6 arrays must be 16-byte aligned and
+		//  padded to a multiple of 4. Gives the same results as MathLib::intersect_aabb_frustum.
+		void IntersectAABBFrustum(BoundOverlap* results,
+			float const * min_x, float const * min_y, float const * min_z,
+			float const * max_x, float const * max_y, float const * max_z,
+			uint32_t num, Frustum const & frustum);
+
+
+		// Batch
+		///////////////////////////////////////////////////////////////////////////////
+
+		// The functions working on arrays run 8 elements at a time with AVX2 and FMA, 4 with SSE, or one by one. The
+		//  best target the CPU supports is picked at run time, so a build for any x86 CPU still gets the AVX2 path.
+		enum BatchTarget
+		{
+			BT_Scalar,
+			BT_SSE,
+			BT_AVX2
+		};
+
+		bool IsBatchTargetSupported(BatchTarget target);
+		BatchTarget ActiveBatchTarget();
+		// For testing and benchmarking. The target has to be supported.
+		void ActiveBatchTarget(BatchTarget target);
+
+		// MathLib::transform_coord on each point. out can be the same as in.
+		void TransformCoords(float3* out, float3 const * in, uint32_t num, float4x4 const & mat);
+		// The tightest AABBs around the transformed boxes. mat has to be affine. Unlike MathLib::transform_aabb, it
+		//  doesn't decompose the matrix, so shear is kept. out can be the same as in.
+		void TransformAABBs(AABBox* out, AABBox const * in, uint32_t num, float4x4 const & mat);
+		// MathLib::mul on each pair
+		void MultiplyQuats(Quaternion* out, Quaternion const * lhs, Quaternion const * rhs, uint32_t num);
+		// MathLib::slerp on each pair, with its own s. SIMD targets use polynomial acos and sin, within 1e-5 of it.
+		void SlerpQuats(Quaternion* out, Quaternion const * lhs, Quaternion const * rhs, float const * s, uint32_t num);
+
+
 		// Color
 		///////////////////////////////////////////////////////////////////////////////
 		SIMDVectorF4 NegativeColor(SIMDVectorF4 const & rhs);
@@ -34,12 +34,16 @@
 #pragma once
 
 #include <boost/assert.hpp>
+#include <boost/noncopyable.hpp>
 #include <thread>
 #include <condition_variable>
 #include <mutex>
+#include <atomic>
 #include <exception>
 #include <vector>
+#include <deque>
 #include <functional>
+#include <algorithm>
 
 #include <KFL/CXX17/optional.hpp>
 
@@ -612,6 +616,149 @@ namespace KlayGE
 	private:
 		std::shared_ptr<thread_pool_common_data_t> data_;
 	};
+
+	class task_scheduler;
+
+	// A set of tasks spawned into a task_scheduler that can be waited on as a whole. Continuations attached with then()
+	//  are spawned once every task in the group has finished. The first exception thrown by a task is rethrown by wait().
+	class task_group : boost::noncopyable
+	{
+		friend class task_scheduler;
+
+	public:
+		explicit task_group(task_scheduler& scheduler);
+		~task_group();
+
+		template <typename Task>
+		void run(Task&& task);
+
+		// Adds a continuation. If the group has no pending task, it's spawned immediately.
+		void then(std::function<void()> const & continuation);
+
+		// Blocks until all tasks in this group are finished. The calling thread executes pending tasks while waiting,
+		//  so it's safe to call from inside a task.
+		void wait();
+
+		bool done() const
+		{
+			return (num_pending_ == 0) && (num_finishing_ == 0);
+		}
+
+	private:
+		void on_task_done(std::exception_ptr const & exception);
+
+	private:
+		task_scheduler& scheduler_;
+		std::atomic<uint32_t> num_pending_;
+		// Non-zero while the thread that finished the last task is still spawning the continuations
+		std::atomic<uint32_t> num_finishing_;
+
+		std::mutex done_mutex_;
+		std::vector<std::function<void()>> continuations_;
+		std::exception_ptr exception_;
+	};
+
+	// A fine-grained job system. Each worker owns a deque of tasks, pops its own tasks in LIFO order, and steals from
+	//  the front of other workers' deques when it runs out of work. Tasks spawned from non-worker threads go to a shared
+	//  injection queue. Tasks must not block for a long time, use thread_pool for long-lived loops.
+	class task_scheduler : boost::noncopyable
+	{
+		friend class task_group;
+
+		struct task
+		{
+			std::function<void()> func;
+			task_group* group;
+		};
+
+		struct task_queue
+		{
+			std::mutex mutex;
+			std::deque<task> tasks;
+		};
+
+	public:
+		// num_workers == 0 means one worker per hardware thread, except the calling one.
+		explicit task_scheduler(uint32_t num_workers = 0);
+		~task_scheduler();
+
+		uint32_t num_workers() const
+		{
+			return static_cast<uint32_t>(workers_.size());
+		}
+
+		// Fire and forget.
+		template <typename Task>
+		void spawn(Task&& task)
+		{
+			this->push(std::function<void()>(std::forward<Task>(task)), nullptr);
+		}
+
+		// Calls func(first, last) on sub-ranges of [begin, end) in parallel, and returns when all of them are done.
+		//  grain_size == 0 picks a grain that gives each worker a few ranges to balance the load.
+		template <typename Func>
+		void parallel_for(uint32_t begin, uint32_t end, uint32_t grain_size, Func const & func)
+		{
+			if (begin >= end)
+			{
+				return;
+			}
+
+			uint32_t const count = end - begin;
+			if (0 == grain_size)
+			{
+				grain_size = std::max(count / ((this->num_workers() + 1) * 4), 1U);
+			}
+			if (count <= grain_size)
+			{
+				func(begin, end);
+				return;
+			}
+
+			task_group group(*this);
+			uint32_t first = begin;
+			while (end - first > grain_size)
+			{
+				uint32_t const last = first + grain_size;
+				group.run([&func, first, last]
+					{
+						func(first, last);
+					});
+				first = last;
+			}
+			func(first, end);
+			group.wait();
+		}
+
+		// Executes one pending task on the calling thread. Returns false if there is nothing to do.
+		bool try_run_one();
+
+		// True if the calling thread is one of this scheduler's workers.
+		bool in_worker_thread() const;
+
+	private:
+		void push(std::function<void()>&& func, task_group* group);
+		bool pop(task& t);
+		void execute(task& t);
+		void worker_func(uint32_t index);
+
+	private:
+		// The last one is the injection queue for non-worker threads
+		std::vector<std::unique_ptr<task_queue>> queues_;
+		std::vector<std::thread> workers_;
+
+		std::atomic<uint32_t> num_queued_;
+		std::atomic<bool> quit_;
+		std::mutex sleep_mutex_;
+		std::condition_variable sleep_cond_;
+	};
+
+	template <typename Task>
+	void task_group::run(Task&& task)
+	{
+		++ num_pending_;
+		scheduler_.push(std::function<void()>(std::forward<Task>(task)), this);
+	}
 }
 
 #endif		// _KFL_THREAD_HPP
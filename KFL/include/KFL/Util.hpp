@@ -183,6 +183,13 @@ namespace KlayGE
 	std::string ReadShortString(ResIdentifierPtr const & res);
 	void WriteShortString(std::ostream& os, std::string_view str);
 
+	// Parses the number at the beginning of [first, last) like std::from_chars, plus an optional leading '+'. Doesn't
+	//  allocate and doesn't depend on the locale. Returns the end of the number, or first if there is no number or it's
+	//  out of range. val is only written on success.
+	char const * FromChars(char const * first, char const * last, int32_t& val);
+	char const * FromChars(char const * first, char const * last, uint32_t& val);
+	char const * FromChars(char const * first, char const * last, float& val);
+
 	template <typename T, typename... Args>
 	inline std::shared_ptr<T> MakeSharedPtr(Args&&... args)
 	{
@@ -34,6 +34,7 @@
 #pragma once
 
 #include <iosfwd>
+#include <string_view>
 #include <vector>
 
 namespace KlayGE
@@ -50,6 +51,131 @@ namespace KlayGE
 		XNT_PI
 	};
 
+	// Handles to attributes and nodes inside the memory of their document. They are as cheap to copy as a pointer,
+	//  and navigating or reading them doesn't allocate. They stay valid as long as the document.
+	class XMLAttributeView
+	{
+		friend class XMLNodeView;
+		friend class XMLNode;
+		friend class XMLAttribute;
+
+	public:
+		XMLAttributeView() noexcept
+			: attr_(nullptr)
+		{
+		}
+
+		explicit operator bool() const noexcept
+		{
+			return attr_ != nullptr;
+		}
+		bool operator==(XMLAttributeView const & rhs) const noexcept
+		{
+			return attr_ == rhs.attr_;
+		}
+		bool operator!=(XMLAttributeView const & rhs) const noexcept
+		{
+			return attr_ != rhs.attr_;
+		}
+
+		std::string_view Name() const;
+
+		XMLAttributeView NextAttrib(std::string_view name) const;
+		XMLAttributeView NextAttrib() const;
+
+		bool TryConvert(int32_t& val) const;
+		bool TryConvert(uint32_t& val) const;
+		bool TryConvert(float& val) const;
+
+		int32_t ValueInt() const;
+		uint32_t ValueUInt() const;
+		float ValueFloat() const;
+		std::string_view ValueString() const;
+
+	private:
+		explicit XMLAttributeView(void* attr) noexcept
+			: attr_(attr)
+		{
+		}
+
+	private:
+		void* attr_;
+	};
+
+	class XMLNodeView
+	{
+		friend class XMLDocument;
+		friend class XMLNode;
+
+	public:
+		XMLNodeView() noexcept
+			: node_(nullptr)
+		{
+		}
+
+		explicit operator bool() const noexcept
+		{
+			return node_ != nullptr;
+		}
+		bool operator==(XMLNodeView const & rhs) const noexcept
+		{
+			return node_ == rhs.node_;
+		}
+		bool operator!=(XMLNodeView const & rhs) const noexcept
+		{
+			return node_ != rhs.node_;
+		}
+
+		std::string_view Name() const;
+		XMLNodeType Type() const;
+
+		XMLNodeView Parent() const;
+
+		XMLAttributeView FirstAttrib(std::string_view name) const;
+		XMLAttributeView LastAttrib(std::string_view name) const;
+		XMLAttributeView FirstAttrib() const;
+		XMLAttributeView LastAttrib() const;
+
+		XMLAttributeView Attrib(std::string_view name) const;
+
+		bool TryConvertAttrib(std::string_view name, int32_t& val, int32_t default_val) const;
+		bool TryConvertAttrib(std::string_view name, uint32_t& val, uint32_t default_val) const;
+		bool TryConvertAttrib(std::string_view name, float& val, float default_val) const;
+
+		int32_t AttribInt(std::string_view name, int32_t default_val) const;
+		uint32_t AttribUInt(std::string_view name, uint32_t default_val) const;
+		float AttribFloat(std::string_view name, float default_val) const;
+		std::string_view AttribString(std::string_view name, std::string_view default_val) const;
+
+		XMLNodeView FirstNode(std::string_view name) const;
+		XMLNodeView LastNode(std::string_view name) const;
+		XMLNodeView FirstNode() const;
+		XMLNodeView LastNode() const;
+
+		XMLNodeView PrevSibling(std::string_view name) const;
+		XMLNodeView NextSibling(std::string_view name) const;
+		XMLNodeView PrevSibling() const;
+		XMLNodeView NextSibling() const;
+
+		bool TryConvert(int32_t& val) const;
+		bool TryConvert(uint32_t& val) const;
+		bool TryConvert(float& val) const;
+
+		int32_t ValueInt() const;
+		uint32_t ValueUInt() const;
+		float ValueFloat() const;
+		std::string_view ValueString() const;
+
+	private:
+		explicit XMLNodeView(void* node) noexcept
+			: node_(node)
+		{
+		}
+
+	private:
+		void* node_;
+	};
+
 	class XMLDocument
 	{
 	public:
@@ -67,6 +193,7 @@ namespace KlayGE
 		XMLAttributePtr AllocAttribString(std::string_view name, std::string_view value);
 
 		void RootNode(XMLNodePtr const & new_node);
+		XMLNodeView RootView() const;
 
 	private:
 		std::shared_ptr<void> doc_;
@@ -83,6 +210,8 @@ namespace KlayGE
 		explicit XMLNode(void* node);
 		XMLNode(void* doc, XMLNodeType type, std::string_view name);
 
+		XMLNodeView View() const;
+
 		std::string const & Name() const;
 		XMLNodeType Type() const;
 
@@ -148,6 +277,8 @@ namespace KlayGE
 		explicit XMLAttribute(void* attr);
 		XMLAttribute(void* doc, std::string_view name, std::string_view value);
 
+		XMLAttributeView View() const;
+
 		std::string const & Name() const;
 
 		XMLAttributePtr NextAttrib(std::string_view name) const;
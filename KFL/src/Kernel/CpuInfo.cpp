@@ -42,6 +42,7 @@
 #include <intrin.h>
 #endif
 #endif
+#include <cstring>
 #include <vector>
 #include <boost/assert.hpp>
 
@@ -89,6 +90,25 @@ namespace
 	#endif
 #else
 		// TODO: Supports other compiler
+#endif
+	}
+
+	// The register states the OS saves on context switches
+	uint64_t get_xcr0()
+	{
+#if defined(KLAYGE_COMPILER_MSVC)
+		return _xgetbv(0);
+#elif (defined(KLAYGE_COMPILER_GCC) || defined(KLAYGE_COMPILER_CLANG)) && !defined(KLAYGE_PLATFORM_IOS)
+		uint32_t eax, edx;
+		__asm__
+		(
+			".byte 0x0f, 0x01, 0xd0"	// xgetbv
+			: "=a" (eax), "=d" (edx)
+			: "c" (0)
+		);
+		return (static_cast<uint64_t>(edx) << 32) | eax;
+#else
+		return 0;
 #endif
 	}
 #endif
@@ -123,6 +143,10 @@ namespace
 		// In EBX of type 7
 		CFM_AVX2		= 1UL << 5,
 
+		// In XCR0
+		XCR0_SSE		= 1UL << 1,
+		XCR0_AVX		= 1UL << 2,
+
 		// In EAX of type 4. Intel only.
 		CFM_NC_Intel				= 0xFC000000,
 
@@ -244,6 +268,7 @@ namespace
 		void Call(uint32_t fn)
 		{
 			eax_ = fn;
+			ecx_ = 0;
 			get_cpuid(&eax_, &ebx_, &ecx_, &edx_);
 		}
 
@@ -302,14 +327,20 @@ namespace KlayGE
 			feature_mask_ |= (cpuid.Ecx() & CFM_MOVBE) ? CF_MOVBE : 0;
 			feature_mask_ |= (cpuid.Ecx() & CFM_POPCNT) ? CF_POPCNT : 0;
 			feature_mask_ |= (cpuid.Ecx() & CFM_AES) ? CF_AES : 0;
+			// AVX instructions fault unless the OS saves the YMM registers too
+			bool os_avx = false;
 			if (cpuid.Ecx() & CFM_OSXSAVE)
+			{
+				os_avx = ((get_xcr0() & (XCR0_SSE | XCR0_AVX)) == (XCR0_SSE | XCR0_AVX));
+			}
+			if (os_avx)
 			{
 				feature_mask_ |= (cpuid.Ecx() & CFM_FMA3) ? CF_FMA3 : 0;
 				feature_mask_ |= (cpuid.Ecx() & CFM_AVX) ? CF_AVX : 0;
 				feature_mask_ |= (cpuid.Ecx() & CFM_F16C) ? CF_F16C : 0;
 			}
 
-			if (max_std_fn >= 7)
+			if (os_avx && (max_std_fn >= 7))
 			{
 				cpuid.Call(7);
 
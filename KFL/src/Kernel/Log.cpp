@@ -30,86 +30,578 @@
 
 #include <KFL/KFL.hpp>
 
-#include <cstdarg>
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
 
 #ifdef KLAYGE_PLATFORM_ANDROID
 #include <android/log.h>
 #else
 #include <iostream>
-#include <fstream>
 #endif
 
 #include <KFL/Log.hpp>
 
-#ifdef KLAYGE_DEBUG
-#ifndef KLAYGE_PLATFORM_ANDROID
 namespace
 {
-	std::ofstream log_file("KlayGE.log");
-}
-#endif
+	using namespace KlayGE;
+
+	// Bytes in the queue of each thread
+	uint32_t const QUEUE_SIZE = 64 * 1024;
+	// Longer messages are kept aside, and only a mark goes through the queue
+	uint32_t const MAX_QUEUED_MSG_LEN = 4 * 1024;
+	uint32_t const WRAP_MARK = 0xFFFFFFFFU;
+	uint32_t const LONG_MSG_MARK = 0xFFFFFFFEU;
+	// The logging thread wakes up at least this often
+	uint32_t const DRAIN_INTERVAL_MS = 20;
+
+	// Starts a record, and is 8-byte aligned. A wrap mark only has the len.
+	struct RecordHeader
+	{
+		uint32_t len;
+		uint32_t severity;
+		uint64_t time;
+	};
+
+	// Set when the logger is gone, at the end of the program. Logging falls back to writing directly.
+	std::atomic<bool> logger_destroyed(false);
+
+	char const * SeverityName(LogSeverity severity)
+	{
+		switch (severity)
+		{
+		case LS_Info:
+			return "INFO";
+
+		case LS_Warn:
+			return "WARN";
+
+		default:
+			return "ERROR";
+		}
+	}
+
+	uint64_t SteadyNow()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void LogDirect(LogSeverity severity, char const * fmt, va_list args)
+	{
+#ifdef KLAYGE_PLATFORM_ANDROID
+		int const prio = (LS_Info == severity) ? ANDROID_LOG_INFO : ((LS_Warn == severity) ? ANDROID_LOG_WARN : ANDROID_LOG_ERROR);
+		__android_log_vprint(prio, "KlayGE", fmt, args);
+#else
+		std::fprintf(stderr, "(%s) KlayGE: ", SeverityName(severity));
+		std::vfprintf(stderr, fmt, args);
+		std::fputc('\n', stderr);
 #endif
+	}
+
+	void LogTo(LogSeverity severity, char const * fmt, va_list args)
+	{
+		if (logger_destroyed)
+		{
+			LogDirect(severity, fmt, args);
+		}
+		else
+		{
+			Logger::Instance().LogV(severity, fmt, args);
+		}
+	}
+}
 
 namespace KlayGE
 {
-	void LogInfo(char const * fmt, ...)
+	// Single producer, the owning thread, and single consumer, the logging thread. Positions only increase.
+	struct Logger::ThreadQueue
 	{
-		va_list args;
-		va_start(args, fmt);
+		explicit ThreadQueue(uint32_t id)
+			: thread_id(id), buffer(QUEUE_SIZE / sizeof(uint64_t)), write_pos(0), read_pos(0), retired(false)
+		{
+		}
+
+		uint32_t thread_id;
+		// uint64_t keeps the records aligned
+		std::vector<uint64_t> buffer;
+		std::atomic<uint64_t> write_pos;
+		std::atomic<uint64_t> read_pos;
+		// The thread has exited. The queue is freed once it's drained.
+		std::atomic<bool> retired;
+
+		std::mutex long_msgs_mutex;
+		std::deque<std::string> long_msgs;
+
+		uint8_t* Data()
+		{
+			return reinterpret_cast<uint8_t*>(buffer.data());
+		}
+	};
 
+
+	LogSink::~LogSink()
+	{
+	}
+
+	void LogSink::Flush()
+	{
+	}
+
+
+	void ConsoleLogSink::Write(LogSeverity severity, std::string_view line, size_t msg_offset)
+	{
 #ifdef KLAYGE_PLATFORM_ANDROID
-		__android_log_vprint(ANDROID_LOG_INFO, "KlayGE", fmt, args);
+		int const prio = (LS_Info == severity) ? ANDROID_LOG_INFO : ((LS_Warn == severity) ? ANDROID_LOG_WARN : ANDROID_LOG_ERROR);
+		__android_log_write(prio, "KlayGE", std::string(line.substr(msg_offset)).c_str());
 #else
-		std::array<char, 1024> buffer;
-		vsprintf(&buffer[0], fmt, args);
+		KFL_UNUSED(severity);
+		KFL_UNUSED(msg_offset);
 
-		std::clog << "(INFO) KlayGE: " << &buffer[0] << std::endl;
-#ifdef KLAYGE_DEBUG
-		log_file << "(INFO) KlayGE: " << &buffer[0] << std::endl;
+		std::clog.write(line.data(), line.size());
+		std::clog.put('\n');
 #endif
+	}
+
+	void ConsoleLogSink::Flush()
+	{
+#ifndef KLAYGE_PLATFORM_ANDROID
+		std::clog.flush();
 #endif
+	}
 
-		va_end(args);
+
+	RotatingFileLogSink::RotatingFileLogSink(std::string const & path, uint64_t max_size, uint32_t max_backups)
+		: path_(path), max_size_(max_size), max_backups_(max_backups), size_(0)
+	{
+		// The log of the last run becomes the first backup
+		this->Rotate();
 	}
 
-	void LogWarn(char const * fmt, ...)
+	void RotatingFileLogSink::Write(LogSeverity severity, std::string_view line, size_t msg_offset)
 	{
-		va_list args;
-		va_start(args, fmt);
+		KFL_UNUSED(severity);
+		KFL_UNUSED(msg_offset);
 
-#ifdef KLAYGE_PLATFORM_ANDROID
-		__android_log_vprint(ANDROID_LOG_WARN, "KlayGE", fmt, args);
-#else
-		std::array<char, 1024> buffer;
-		vsprintf(&buffer[0], fmt, args);
+		if ((size_ > 0) && (size_ + line.size() + 1 > max_size_))
+		{
+			this->Rotate();
+		}
+
+		file_.write(line.data(), line.size());
+		file_.put('\n');
+		size_ += line.size() + 1;
+	}
+
+	void RotatingFileLogSink::Flush()
+	{
+		file_.flush();
+	}
+
+	void RotatingFileLogSink::Rotate()
+	{
+		if (file_.is_open())
+		{
+			file_.close();
+		}
+
+		if (max_backups_ > 0)
+		{
+			std::remove((path_ + "." + std::to_string(max_backups_)).c_str());
+			for (uint32_t i = max_backups_ - 1; i > 0; -- i)
+			{
+				std::rename((path_ + "." + std::to_string(i)).c_str(), (path_ + "." + std::to_string(i + 1)).c_str());
+			}
+			std::rename(path_.c_str(), (path_ + ".1").c_str());
+		}
+		else
+		{
+			std::remove(path_.c_str());
+		}
 
-		std::clog << "(WARN) KlayGE: " << &buffer[0] << std::endl;
+		file_.open(path_.c_str(), std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+		size_ = 0;
+	}
+
+
+	Logger::Logger()
+		: min_severity_(LS_Info), next_thread_id_(0),
+			flush_requested_(0), flush_done_(0), wake_(false), quit_(false)
+	{
+		start_steady_ = SteadyNow();
+		start_wall_ = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+
+		sinks_.push_back(MakeSharedPtr<ConsoleLogSink>());
 #ifdef KLAYGE_DEBUG
-		log_file << "(WARN) KlayGE: " << &buffer[0] << std::endl;
+#ifndef KLAYGE_PLATFORM_ANDROID
+		sinks_.push_back(MakeSharedPtr<RotatingFileLogSink>("KlayGE.log", 16 * 1024 * 1024, 3));
 #endif
 #endif
 
-		va_end(args);
+		thread_ = std::thread(&Logger::ThreadFunc, this);
 	}
 
-	void LogError(char const * fmt, ...)
+	Logger::~Logger()
+	{
+		logger_destroyed = true;
+
+		{
+			std::lock_guard<std::mutex> lock(wake_mutex_);
+			quit_ = true;
+		}
+		wake_cond_.notify_one();
+		thread_.join();
+	}
+
+	Logger& Logger::Instance()
+	{
+		static Logger logger;
+		return logger;
+	}
+
+	void Logger::MinSeverity(LogSeverity severity)
+	{
+		min_severity_ = severity;
+	}
+
+	LogSeverity Logger::MinSeverity() const
+	{
+		return static_cast<LogSeverity>(min_severity_.load());
+	}
+
+	void Logger::AddSink(LogSinkPtr const & sink)
+	{
+		std::lock_guard<std::mutex> lock(sinks_mutex_);
+		sinks_.push_back(sink);
+	}
+
+	void Logger::DelSink(LogSinkPtr const & sink)
+	{
+		std::lock_guard<std::mutex> lock(sinks_mutex_);
+		sinks_.erase(std::remove(sinks_.begin(), sinks_.end(), sink), sinks_.end());
+	}
+
+	void Logger::ClearSinks()
+	{
+		std::lock_guard<std::mutex> lock(sinks_mutex_);
+		sinks_.clear();
+	}
+
+	void Logger::Log(LogSeverity severity, char const * fmt, ...)
 	{
 		va_list args;
 		va_start(args, fmt);
+		this->LogV(severity, fmt, args);
+		va_end(args);
+	}
 
-#ifdef KLAYGE_PLATFORM_ANDROID
-		__android_log_vprint(ANDROID_LOG_ERROR, "KlayGE", fmt, args);
-#else
-		std::array<char, 1024> buffer;
-		vsprintf(&buffer[0], fmt, args);
+	void Logger::LogV(LogSeverity severity, char const * fmt, va_list args)
+	{
+		if (severity < min_severity_.load(std::memory_order_relaxed))
+		{
+			return;
+		}
 
-		std::clog << "(ERROR) KlayGE: " << &buffer[0] << std::endl;
-#ifdef KLAYGE_DEBUG
-		log_file << "(ERROR) KlayGE: " << &buffer[0] << std::endl;
-#endif
+		uint64_t const time = SteadyNow();
+
+		va_list args_copy;
+		va_copy(args_copy, args);
+		std::array<char, 512> buffer;
+		int const len = std::vsnprintf(buffer.data(), buffer.size(), fmt, args);
+		if (len >= 0)
+		{
+			std::vector<char> long_buffer;
+			char const * msg = buffer.data();
+			if (static_cast<size_t>(len) >= buffer.size())
+			{
+				long_buffer.resize(len + 1);
+				std::vsnprintf(long_buffer.data(), long_buffer.size(), fmt, args_copy);
+				msg = long_buffer.data();
+			}
+
+			this->Push(*this->CurrentThreadQueue(), severity, time, msg, static_cast<uint32_t>(len));
+		}
+		va_end(args_copy);
+
+		if (LS_Error == severity)
+		{
+			this->Flush();
+		}
+	}
+
+	void Logger::Flush()
+	{
+		std::unique_lock<std::mutex> lock(wake_mutex_);
+		if (quit_ || (std::this_thread::get_id() == thread_.get_id()))
+		{
+			return;
+		}
+
+		uint64_t const target = ++ flush_requested_;
+		wake_ = true;
+		wake_cond_.notify_one();
+		flushed_cond_.wait(lock, [this, target] { return flush_done_ >= target; });
+	}
+
+	Logger::ThreadQueue* Logger::CurrentThreadQueue()
+	{
+		// Retires the queue when the thread exits
+		struct Holder
+		{
+			ThreadQueue* queue = nullptr;
+
+			~Holder()
+			{
+				if (queue && !logger_destroyed)
+				{
+					queue->retired.store(true, std::memory_order_release);
+				}
+			}
+		};
+		thread_local Holder holder;
+
+		if (!holder.queue)
+		{
+			std::lock_guard<std::mutex> lock(queues_mutex_);
+			++ next_thread_id_;
+			queues_.push_back(MakeUniquePtr<ThreadQueue>(next_thread_id_));
+			holder.queue = queues_.back().get();
+		}
+		return holder.queue;
+	}
+
+	void Logger::Push(ThreadQueue& queue, LogSeverity severity, uint64_t time, char const * msg, uint32_t len)
+	{
+		bool const is_long = len > MAX_QUEUED_MSG_LEN;
+		if (is_long)
+		{
+			std::lock_guard<std::mutex> lock(queue.long_msgs_mutex);
+			queue.long_msgs.emplace_back(msg, len);
+		}
+
+		uint32_t const record_size = sizeof(RecordHeader) + (is_long ? 0 : ((len + 7) & ~7U));
+		uint64_t write_pos = queue.write_pos.load(std::memory_order_relaxed);
+		uint32_t offset = static_cast<uint32_t>(write_pos % QUEUE_SIZE);
+		uint32_t const wrap_size = (offset + record_size > QUEUE_SIZE) ? QUEUE_SIZE - offset : 0;
+		while (write_pos + wrap_size + record_size - queue.read_pos.load(std::memory_order_acquire) > QUEUE_SIZE)
+		{
+			// Full, waits for the logging thread
+			this->WakeUp();
+			std::this_thread::yield();
+		}
+
+		uint8_t* data = queue.Data();
+		if (wrap_size > 0)
+		{
+			std::memcpy(data + offset, &WRAP_MARK, sizeof(WRAP_MARK));
+			write_pos += wrap_size;
+			offset = 0;
+		}
+
+		RecordHeader header;
+		header.len = is_long ? LONG_MSG_MARK : len;
+		header.severity = severity;
+		header.time = time;
+		std::memcpy(data + offset, &header, sizeof(header));
+		if (!is_long)
+		{
+			std::memcpy(data + offset + sizeof(header), msg, len);
+		}
+		queue.write_pos.store(write_pos + record_size, std::memory_order_release);
+
+		if ((LS_Error == severity) || (write_pos + record_size - queue.read_pos.load(std::memory_order_relaxed) > QUEUE_SIZE / 2))
+		{
+			this->WakeUp();
+		}
+	}
+
+	void Logger::WakeUp()
+	{
+		{
+			std::lock_guard<std::mutex> lock(wake_mutex_);
+			wake_ = true;
+		}
+		wake_cond_.notify_one();
+	}
+
+	void Logger::ThreadFunc()
+	{
+		for (;;)
+		{
+			uint64_t flush_target;
+			bool quit;
+			{
+				std::unique_lock<std::mutex> lock(wake_mutex_);
+				wake_cond_.wait_for(lock, std::chrono::milliseconds(DRAIN_INTERVAL_MS), [this] { return wake_ || quit_; });
+				wake_ = false;
+				flush_target = flush_requested_;
+				quit = quit_;
+			}
+
+			this->DrainQueues();
+			if (!batch_.empty())
+			{
+				this->WriteBatch();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(wake_mutex_);
+				flush_done_ = flush_target;
+			}
+			flushed_cond_.notify_all();
+
+			if (quit)
+			{
+				break;
+			}
+		}
+	}
+
+	void Logger::DrainQueues()
+	{
+		std::vector<ThreadQueue*> queues;
+		{
+			std::lock_guard<std::mutex> lock(queues_mutex_);
+			for (auto const & queue : queues_)
+			{
+				queues.push_back(queue.get());
+			}
+		}
+
+		for (auto queue : queues)
+		{
+			uint8_t const * data = queue->Data();
+			uint64_t read_pos = queue->read_pos.load(std::memory_order_relaxed);
+			uint64_t const write_pos = queue->write_pos.load(std::memory_order_acquire);
+			while (read_pos < write_pos)
+			{
+				uint32_t const offset = static_cast<uint32_t>(read_pos % QUEUE_SIZE);
+				uint32_t len;
+				std::memcpy(&len, data + offset, sizeof(len));
+				if (WRAP_MARK == len)
+				{
+					read_pos += QUEUE_SIZE - offset;
+					continue;
+				}
+
+				RecordHeader header;
+				std::memcpy(&header, data + offset, sizeof(header));
+
+				Entry entry;
+				entry.time = header.time;
+				entry.thread_id = queue->thread_id;
+				entry.severity = static_cast<LogSeverity>(header.severity);
+				entry.offset = static_cast<uint32_t>(batch_text_.size());
+				if (LONG_MSG_MARK == len)
+				{
+					std::string msg;
+					{
+						std::lock_guard<std::mutex> lock(queue->long_msgs_mutex);
+						msg.swap(queue->long_msgs.front());
+						queue->long_msgs.pop_front();
+					}
+					entry.len = static_cast<uint32_t>(msg.size());
+					batch_text_.insert(batch_text_.end(), msg.begin(), msg.end());
+					read_pos += sizeof(header);
+				}
+				else
+				{
+					char const * msg = reinterpret_cast<char const *>(data + offset + sizeof(header));
+					entry.len = len;
+					batch_text_.insert(batch_text_.end(), msg, msg + len);
+					read_pos += sizeof(header) + ((len + 7) & ~7U);
+				}
+				batch_.push_back(entry);
+			}
+			queue->read_pos.store(read_pos, std::memory_order_release);
+		}
+
+		std::lock_guard<std::mutex> lock(queues_mutex_);
+		queues_.erase(std::remove_if(queues_.begin(), queues_.end(),
+			[](std::unique_ptr<ThreadQueue> const & queue)
+			{
+				return queue->retired.load(std::memory_order_acquire)
+					&& (queue->read_pos.load(std::memory_order_relaxed) == queue->write_pos.load(std::memory_order_acquire));
+			}), queues_.end());
+	}
+
+	void Logger::WriteBatch()
+	{
+		// Each queue is in order already
+		std::stable_sort(batch_.begin(), batch_.end(),
+			[](Entry const & lhs, Entry const & rhs)
+			{
+				return lhs.time < rhs.time;
+			});
+
+		std::lock_guard<std::mutex> lock(sinks_mutex_);
+
+		int64_t last_second = -1;
+		char date[32] = "";
+		for (auto const & entry : batch_)
+		{
+			uint64_t const wall = start_wall_ + (entry.time - start_steady_) / 1000;
+			int64_t const second = static_cast<int64_t>(wall / 1000000);
+			if (second != last_second)
+			{
+				std::time_t const t = static_cast<std::time_t>(second);
+				std::tm local;
+#ifdef KLAYGE_PLATFORM_WINDOWS
+				localtime_s(&local, &t);
+#else
+				localtime_r(&t, &local);
 #endif
+				std::strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &local);
+				last_second = second;
+			}
+
+			char prefix[96];
+			int const prefix_len = std::snprintf(prefix, sizeof(prefix), "[%s.%03u] [T%u] (%s) KlayGE: ", date,
+				static_cast<uint32_t>(wall / 1000 % 1000), entry.thread_id, SeverityName(entry.severity));
+			line_.assign(prefix, prefix_len);
+			line_.append(&batch_text_[entry.offset], entry.len);
+
+			for (auto const & sink : sinks_)
+			{
+				sink->Write(entry.severity, line_, prefix_len);
+			}
+		}
+		for (auto const & sink : sinks_)
+		{
+			sink->Flush();
+		}
+
+		batch_.clear();
+		batch_text_.clear();
+	}
+
+
+	void LogInfo(char const * fmt, ...)
+	{
+		va_list args;
+		va_start(args, fmt);
+		LogTo(LS_Info, fmt, args);
+		va_end(args);
+	}
+
+	void LogWarn(char const * fmt, ...)
+	{
+		va_list args;
+		va_start(args, fmt);
+		LogTo(LS_Warn, fmt, args);
+		va_end(args);
+	}
 
+	void LogError(char const * fmt, ...)
+	{
+		va_list args;
+		va_start(args, fmt);
+		LogTo(LS_Error, fmt, args);
 		va_end(args);
 	}
 }
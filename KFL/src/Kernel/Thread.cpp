@@ -248,4 +248,246 @@ namespace KlayGE
 	{
 		data_->kill_all();
 	}
+
+
+	namespace
+	{
+		// Set on each worker thread, so spawning from inside a task goes to the worker's own deque.
+		thread_local task_scheduler const * tls_scheduler = nullptr;
+		thread_local uint32_t tls_worker_index = 0;
+	}
+
+	task_group::task_group(task_scheduler& scheduler)
+		: scheduler_(scheduler), num_pending_(0), num_finishing_(0)
+	{
+	}
+
+	task_group::~task_group()
+	{
+		try
+		{
+			this->wait();
+		}
+		catch (...)
+		{
+		}
+	}
+
+	void task_group::then(std::function<void()> const & continuation)
+	{
+		{
+			std::lock_guard<std::mutex> lock(done_mutex_);
+			if (num_pending_ != 0)
+			{
+				continuations_.push_back(continuation);
+				return;
+			}
+		}
+
+		scheduler_.spawn(continuation);
+	}
+
+	void task_group::wait()
+	{
+		while (!this->done())
+		{
+			if (!scheduler_.try_run_one())
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		std::exception_ptr exception;
+		{
+			// Makes sure the thread finishing the last task has left on_task_done
+			std::lock_guard<std::mutex> lock(done_mutex_);
+			exception = exception_;
+			exception_ = nullptr;
+		}
+		if (exception)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+
+	void task_group::on_task_done(std::exception_ptr const & exception)
+	{
+		std::vector<std::function<void()>> continuations;
+		{
+			std::lock_guard<std::mutex> lock(done_mutex_);
+			if (exception && !exception_)
+			{
+				exception_ = exception;
+			}
+			++ num_finishing_;
+			if (0 == -- num_pending_)
+			{
+				continuations.swap(continuations_);
+			}
+		}
+
+		// The group can be destroyed as soon as num_finishing_ drops to 0, so nothing in it is touched after that
+		task_scheduler& scheduler = scheduler_;
+		for (auto& cont : continuations)
+		{
+			scheduler.spawn(std::move(cont));
+		}
+		-- num_finishing_;
+	}
+
+
+	task_scheduler::task_scheduler(uint32_t num_workers)
+		: num_queued_(0), quit_(false)
+	{
+		if (0 == num_workers)
+		{
+			num_workers = std::max(std::thread::hardware_concurrency(), 2U) - 1;
+		}
+
+		queues_.resize(num_workers + 1);
+		for (auto& queue : queues_)
+		{
+			queue = MakeUniquePtr<task_queue>();
+		}
+
+		workers_.reserve(num_workers);
+		for (uint32_t i = 0; i < num_workers; ++ i)
+		{
+			workers_.emplace_back(&task_scheduler::worker_func, this, i);
+		}
+	}
+
+	task_scheduler::~task_scheduler()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex_);
+			quit_ = true;
+		}
+		sleep_cond_.notify_all();
+
+		for (auto& worker : workers_)
+		{
+			worker.join();
+		}
+	}
+
+	bool task_scheduler::in_worker_thread() const
+	{
+		return tls_scheduler == this;
+	}
+
+	bool task_scheduler::try_run_one()
+	{
+		task t;
+		if (this->pop(t))
+		{
+			this->execute(t);
+			return true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	void task_scheduler::push(std::function<void()>&& func, task_group* group)
+	{
+		uint32_t const index = this->in_worker_thread() ? tls_worker_index : this->num_workers();
+		++ num_queued_;
+		{
+			task_queue& queue = *queues_[index];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.tasks.push_back({ std::move(func), group });
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex_);
+		}
+		sleep_cond_.notify_one();
+	}
+
+	bool task_scheduler::pop(task& t)
+	{
+		if (0 == num_queued_)
+		{
+			return false;
+		}
+
+		uint32_t const num_queues = static_cast<uint32_t>(queues_.size());
+		uint32_t const injection_index = num_queues - 1;
+		uint32_t const self_index = this->in_worker_thread() ? tls_worker_index : injection_index;
+
+		// Own deque first, newest task, for cache locality
+		if (self_index != injection_index)
+		{
+			task_queue& queue = *queues_[self_index];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.tasks.empty())
+			{
+				t = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+				-- num_queued_;
+				return true;
+			}
+		}
+
+		// Then the injection queue and other workers' deques, oldest task
+		for (uint32_t i = 0; i < num_queues; ++ i)
+		{
+			uint32_t const index = (self_index + num_queues - i) % num_queues;
+			if (index == self_index && self_index != injection_index)
+			{
+				continue;
+			}
+
+			task_queue& queue = *queues_[index];
+			std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+			if (lock.owns_lock() && !queue.tasks.empty())
+			{
+				t = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+				-- num_queued_;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void task_scheduler::execute(task& t)
+	{
+		std::exception_ptr exception;
+		try
+		{
+			t.func();
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+		t.func = std::function<void()>();
+
+		if (t.group)
+		{
+			t.group->on_task_done(exception);
+		}
+	}
+
+	void task_scheduler::worker_func(uint32_t index)
+	{
+		tls_scheduler = this;
+		tls_worker_index = index;
+
+		while (!quit_)
+		{
+			if (!this->try_run_one())
+			{
+				std::unique_lock<std::mutex> lock(sleep_mutex_);
+				sleep_cond_.wait_for(lock, std::chrono::milliseconds(1), [this]
+					{
+						return quit_ || (num_queued_ != 0);
+					});
+			}
+		}
+	}
 }
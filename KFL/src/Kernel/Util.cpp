@@ -46,10 +46,53 @@
 
 #include <vector>
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <boost/assert.hpp>
 
 #include <KFL/Util.hpp>
 
+namespace
+{
+	using namespace KlayGE;
+
+	bool IsDigit(char ch)
+	{
+		return (ch >= '0') && (ch <= '9');
+	}
+
+	// Powers of 10 that are exact in a double
+	double const POW10[] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	// Significant digits kept for the slow path. The rest only count as a non-zero tail, which is enough to round a
+	//  float correctly, since its exact decimal expansion never needs more than 112 significant digits.
+	int const MAX_KEPT_DIGITS = 120;
+
+	char const * ParseUnsigned(char const * first, char const * last, uint64_t max_val, uint64_t& val)
+	{
+		char const * p = first;
+		uint64_t acc = 0;
+		for (; (p != last) && IsDigit(*p); ++ p)
+		{
+			acc = acc * 10 + (*p - '0');
+			if (acc > max_val)
+			{
+				return first;
+			}
+		}
+		if (p != first)
+		{
+			val = acc;
+		}
+		return p;
+	}
+}
+
 namespace KlayGE
 {
 	// һwstringתΪstring
@@ -220,4 +263,217 @@ namespace KlayGE
 			os.write(str.data(), len * sizeof(str[0]));
 		}
 	}
+
+	char const * FromChars(char const * first, char const * last, int32_t& val)
+	{
+		char const * p = first;
+		bool negative = false;
+		if ((p != last) && ((*p == '-') || (*p == '+')))
+		{
+			negative = (*p == '-');
+			++ p;
+		}
+
+		uint64_t const max_val = negative ? 0x80000000ULL : 0x7FFFFFFFULL;
+		uint64_t acc;
+		char const * end = ParseUnsigned(p, last, max_val, acc);
+		if (end == p)
+		{
+			return first;
+		}
+
+		val = static_cast<int32_t>(negative ? -static_cast<int64_t>(acc) : static_cast<int64_t>(acc));
+		return end;
+	}
+
+	char const * FromChars(char const * first, char const * last, uint32_t& val)
+	{
+		char const * p = first;
+		if ((p != last) && (*p == '+'))
+		{
+			++ p;
+		}
+
+		uint64_t acc;
+		char const * end = ParseUnsigned(p, last, 0xFFFFFFFFULL, acc);
+		if (end == p)
+		{
+			return first;
+		}
+
+		val = static_cast<uint32_t>(acc);
+		return end;
+	}
+
+	char const * FromChars(char const * first, char const * last, float& val)
+	{
+		char const * p = first;
+		bool negative = false;
+		if ((p != last) && ((*p == '-') || (*p == '+')))
+		{
+			negative = (*p == '-');
+			++ p;
+		}
+
+		// The number is digits * 10^exp10. The first 19 significant digits go to mantissa, the first
+		//  MAX_KEPT_DIGITS to the buffer of the slow path.
+		char digits[MAX_KEPT_DIGITS + 1];
+		int num_digits = 0;
+		int num_kept = 0;
+		bool non_zero_tail = false;
+		uint64_t mantissa = 0;
+		int32_t exp10 = 0;
+		bool any_digit = false;
+		bool fraction = false;
+		for (; p != last; ++ p)
+		{
+			char const ch = *p;
+			if (IsDigit(ch))
+			{
+				any_digit = true;
+				if (fraction)
+				{
+					-- exp10;
+				}
+				if ((num_digits == 0) && (ch == '0'))
+				{
+					continue;
+				}
+
+				if (num_digits < 19)
+				{
+					mantissa = mantissa * 10 + (ch - '0');
+				}
+				if (num_kept < MAX_KEPT_DIGITS)
+				{
+					digits[num_kept] = ch;
+					++ num_kept;
+				}
+				else if (ch != '0')
+				{
+					non_zero_tail = true;
+				}
+				++ num_digits;
+			}
+			else if ((ch == '.') && !fraction)
+			{
+				fraction = true;
+			}
+			else
+			{
+				break;
+			}
+		}
+		if (!any_digit)
+		{
+			return first;
+		}
+
+		if ((p != last) && ((*p == 'e') || (*p == 'E')))
+		{
+			char const * q = p + 1;
+			bool negative_exp = false;
+			if ((q != last) && ((*q == '-') || (*q == '+')))
+			{
+				negative_exp = (*q == '-');
+				++ q;
+			}
+			if ((q != last) && IsDigit(*q))
+			{
+				int32_t exp = 0;
+				for (; (q != last) && IsDigit(*q); ++ q)
+				{
+					if (exp < 100000)
+					{
+						exp = exp * 10 + (*q - '0');
+					}
+				}
+				exp10 += negative_exp ? -exp : exp;
+				p = q;
+			}
+		}
+
+		if (num_digits == 0)
+		{
+			val = negative ? -0.0f : 0.0f;
+			return p;
+		}
+
+		if ((num_digits <= 19) && (mantissa <= (1ULL << 53)) && (exp10 >= -22) && (exp10 <= 22))
+		{
+			if ((mantissa < (1ULL << 24)) && (exp10 >= -10) && (exp10 <= 10))
+			{
+				// Both are exact in a float, so one rounding
+				float f = static_cast<float>(mantissa);
+				float const scale = static_cast<float>(POW10[exp10 < 0 ? -exp10 : exp10]);
+				f = (exp10 < 0) ? f / scale : f * scale;
+				val = negative ? -f : f;
+				return p;
+			}
+			else
+			{
+				double d = static_cast<double>(mantissa);
+				d = (exp10 < 0) ? d / POW10[-exp10] : d * POW10[exp10];
+
+				// Rounding to double then to float is only wrong if the double lands right between 2 floats
+				uint64_t bits;
+				std::memcpy(&bits, &d, sizeof(bits));
+				if ((bits & 0x1FFFFFFFULL) != 0x10000000ULL)
+				{
+					float const f = static_cast<float>(d);
+					val = negative ? -f : f;
+					return p;
+				}
+			}
+		}
+
+		// Slow path. Without a decimal point, strtof doesn't depend on the locale.
+		char buf[MAX_KEPT_DIGITS + 24];
+		char* out = buf;
+		if (negative)
+		{
+			*out = '-';
+			++ out;
+		}
+		std::memcpy(out, digits, num_kept);
+		out += num_kept;
+		int32_t buf_exp = exp10 + (num_digits - num_kept);
+		if (non_zero_tail)
+		{
+			*out = '1';
+			++ out;
+			-- buf_exp;
+		}
+		*out = 'e';
+		++ out;
+		if (buf_exp < 0)
+		{
+			*out = '-';
+			++ out;
+			buf_exp = -buf_exp;
+		}
+		char exp_digits[12];
+		int num_exp_digits = 0;
+		do
+		{
+			exp_digits[num_exp_digits] = static_cast<char>('0' + buf_exp % 10);
+			++ num_exp_digits;
+			buf_exp /= 10;
+		} while (buf_exp != 0);
+		while (num_exp_digits > 0)
+		{
+			-- num_exp_digits;
+			*out = exp_digits[num_exp_digits];
+			++ out;
+		}
+		*out = '\0';
+
+		float const f = std::strtof(buf, nullptr);
+		if ((f == std::numeric_limits<float>::infinity()) || (f == -std::numeric_limits<float>::infinity()))
+		{
+			return first;
+		}
+		val = f;
+		return p;
+	}
 }
@@ -46,6 +46,46 @@
 
 #include <KFL/XMLDom.hpp>
 
+namespace
+{
+	using namespace KlayGE;
+
+	// FromChars for the common case. Everything else, such as inf, nan, or "-1" for an unsigned, keeps the
+	//  behavior of boost::lexical_cast.
+	template <typename T>
+	bool TryConvertValue(std::string_view str, T& val)
+	{
+		char const * last = str.data() + str.size();
+		if (!str.empty() && (FromChars(str.data(), last, val) == last))
+		{
+			return true;
+		}
+		return boost::conversion::try_lexical_convert(str.data(), str.size(), val);
+	}
+
+	template <typename T>
+	T ConvertValue(std::string_view str)
+	{
+		T val;
+		char const * last = str.data() + str.size();
+		if (!str.empty() && (FromChars(str.data(), last, val) == last))
+		{
+			return val;
+		}
+		return boost::lexical_cast<T>(str.data(), str.size());
+	}
+
+	rapidxml::xml_node<>* CastNode(void* node)
+	{
+		return static_cast<rapidxml::xml_node<>*>(node);
+	}
+
+	rapidxml::xml_attribute<>* CastAttrib(void* attr)
+	{
+		return static_cast<rapidxml::xml_attribute<>*>(attr);
+	}
+}
+
 namespace KlayGE
 {
 	XMLDocument::XMLDocument()
@@ -110,14 +150,259 @@ namespace KlayGE
 		root_ = new_node;
 	}
 
+	XMLNodeView XMLDocument::RootView() const
+	{
+		return XMLNodeView(root_ ? root_->node_ : nullptr);
+	}
+
+
+	std::string_view XMLNodeView::Name() const
+	{
+		return std::string_view(CastNode(node_)->name(), CastNode(node_)->name_size());
+	}
+
+	XMLNodeType XMLNodeView::Type() const
+	{
+		switch (CastNode(node_)->type())
+		{
+		case rapidxml::node_document:
+			return XNT_Document;
+
+		case rapidxml::node_element:
+			return XNT_Element;
+
+		case rapidxml::node_data:
+			return XNT_Data;
+
+		case rapidxml::node_cdata:
+			return XNT_CData;
+
+		case rapidxml::node_comment:
+			return XNT_Comment;
+
+		case rapidxml::node_declaration:
+			return XNT_Declaration;
+
+		case rapidxml::node_doctype:
+			return XNT_Doctype;
+
+		case rapidxml::node_pi:
+		default:
+			return XNT_PI;
+		}
+	}
+
+	XMLNodeView XMLNodeView::Parent() const
+	{
+		return XMLNodeView(CastNode(node_)->parent());
+	}
+
+	XMLAttributeView XMLNodeView::FirstAttrib(std::string_view name) const
+	{
+		return XMLAttributeView(CastNode(node_)->first_attribute(name.data(), name.size()));
+	}
+
+	XMLAttributeView XMLNodeView::LastAttrib(std::string_view name) const
+	{
+		return XMLAttributeView(CastNode(node_)->last_attribute(name.data(), name.size()));
+	}
+
+	XMLAttributeView XMLNodeView::FirstAttrib() const
+	{
+		return XMLAttributeView(CastNode(node_)->first_attribute());
+	}
+
+	XMLAttributeView XMLNodeView::LastAttrib() const
+	{
+		return XMLAttributeView(CastNode(node_)->last_attribute());
+	}
+
+	XMLAttributeView XMLNodeView::Attrib(std::string_view name) const
+	{
+		return this->FirstAttrib(name);
+	}
+
+	bool XMLNodeView::TryConvertAttrib(std::string_view name, int32_t& val, int32_t default_val) const
+	{
+		val = default_val;
+
+		XMLAttributeView const attr = this->Attrib(name);
+		return attr ? attr.TryConvert(val) : true;
+	}
+
+	bool XMLNodeView::TryConvertAttrib(std::string_view name, uint32_t& val, uint32_t default_val) const
+	{
+		val = default_val;
+
+		XMLAttributeView const attr = this->Attrib(name);
+		return attr ? attr.TryConvert(val) : true;
+	}
+
+	bool XMLNodeView::TryConvertAttrib(std::string_view name, float& val, float default_val) const
+	{
+		val = default_val;
+
+		XMLAttributeView const attr = this->Attrib(name);
+		return attr ? attr.TryConvert(val) : true;
+	}
+
+	int32_t XMLNodeView::AttribInt(std::string_view name, int32_t default_val) const
+	{
+		XMLAttributeView const attr = this->Attrib(name);
+		return attr ? attr.ValueInt() : default_val;
+	}
+
+	uint32_t XMLNodeView::AttribUInt(std::string_view name, uint32_t default_val) const
+	{
+		XMLAttributeView const attr = this->Attrib(name);
+		return attr ? attr.ValueUInt() : default_val;
+	}
+
+	float XMLNodeView::AttribFloat(std::string_view name, float default_val) const
+	{
+		XMLAttributeView const attr = this->Attrib(name);
+		return attr ? attr.ValueFloat() : default_val;
+	}
+
+	std::string_view XMLNodeView::AttribString(std::string_view name, std::string_view default_val) const
+	{
+		XMLAttributeView const attr = this->Attrib(name);
+		return attr ? attr.ValueString() : default_val;
+	}
+
+	XMLNodeView XMLNodeView::FirstNode(std::string_view name) const
+	{
+		return XMLNodeView(CastNode(node_)->first_node(name.data(), name.size()));
+	}
+
+	XMLNodeView XMLNodeView::LastNode(std::string_view name) const
+	{
+		return XMLNodeView(CastNode(node_)->last_node(name.data(), name.size()));
+	}
+
+	XMLNodeView XMLNodeView::FirstNode() const
+	{
+		return XMLNodeView(CastNode(node_)->first_node());
+	}
+
+	XMLNodeView XMLNodeView::LastNode() const
+	{
+		return XMLNodeView(CastNode(node_)->last_node());
+	}
+
+	XMLNodeView XMLNodeView::PrevSibling(std::string_view name) const
+	{
+		return XMLNodeView(CastNode(node_)->previous_sibling(name.data(), name.size()));
+	}
+
+	XMLNodeView XMLNodeView::NextSibling(std::string_view name) const
+	{
+		return XMLNodeView(CastNode(node_)->next_sibling(name.data(), name.size()));
+	}
+
+	XMLNodeView XMLNodeView::PrevSibling() const
+	{
+		return XMLNodeView(CastNode(node_)->previous_sibling());
+	}
+
+	XMLNodeView XMLNodeView::NextSibling() const
+	{
+		return XMLNodeView(CastNode(node_)->next_sibling());
+	}
+
+	bool XMLNodeView::TryConvert(int32_t& val) const
+	{
+		return TryConvertValue(this->ValueString(), val);
+	}
+
+	bool XMLNodeView::TryConvert(uint32_t& val) const
+	{
+		return TryConvertValue(this->ValueString(), val);
+	}
+
+	bool XMLNodeView::TryConvert(float& val) const
+	{
+		return TryConvertValue(this->ValueString(), val);
+	}
+
+	int32_t XMLNodeView::ValueInt() const
+	{
+		return ConvertValue<int32_t>(this->ValueString());
+	}
+
+	uint32_t XMLNodeView::ValueUInt() const
+	{
+		return ConvertValue<uint32_t>(this->ValueString());
+	}
+
+	float XMLNodeView::ValueFloat() const
+	{
+		return ConvertValue<float>(this->ValueString());
+	}
+
+	std::string_view XMLNodeView::ValueString() const
+	{
+		return std::string_view(CastNode(node_)->value(), CastNode(node_)->value_size());
+	}
+
+
+	std::string_view XMLAttributeView::Name() const
+	{
+		return std::string_view(CastAttrib(attr_)->name(), CastAttrib(attr_)->name_size());
+	}
+
+	XMLAttributeView XMLAttributeView::NextAttrib(std::string_view name) const
+	{
+		return XMLAttributeView(CastAttrib(attr_)->next_attribute(name.data(), name.size()));
+	}
+
+	XMLAttributeView XMLAttributeView::NextAttrib() const
+	{
+		return XMLAttributeView(CastAttrib(attr_)->next_attribute());
+	}
+
+	bool XMLAttributeView::TryConvert(int32_t& val) const
+	{
+		return TryConvertValue(this->ValueString(), val);
+	}
+
+	bool XMLAttributeView::TryConvert(uint32_t& val) const
+	{
+		return TryConvertValue(this->ValueString(), val);
+	}
+
+	bool XMLAttributeView::TryConvert(float& val) const
+	{
+		return TryConvertValue(this->ValueString(), val);
+	}
+
+	int32_t XMLAttributeView::ValueInt() const
+	{
+		return ConvertValue<int32_t>(this->ValueString());
+	}
+
+	uint32_t XMLAttributeView::ValueUInt() const
+	{
+		return ConvertValue<uint32_t>(this->ValueString());
+	}
+
+	float XMLAttributeView::ValueFloat() const
+	{
+		return ConvertValue<float>(this->ValueString());
+	}
+
+	std::string_view XMLAttributeView::ValueString() const
+	{
+		return std::string_view(CastAttrib(attr_)->value(), CastAttrib(attr_)->value_size());
+	}
+
 
 	XMLNode::XMLNode(void* node)
 		: node_(node)
 	{
 		if (node_ != nullptr)
 		{
-			name_ = std::string(static_cast<rapidxml::xml_node<>*>(node_)->name(),
-				static_cast<rapidxml::xml_node<>*>(node_)->name_size());
+			name_ = std::string(this->View().Name());
 		}
 	}
 
@@ -161,7 +446,15 @@ namespace KlayGE
 			break;
 		}
 
-		node_ = static_cast<rapidxml::xml_document<>*>(doc)->allocate_node(xtype, name.data(), nullptr, name.size());
+		// The name is copied into the document, so that views of the node don't point to the caller's string
+		auto xml_doc = static_cast<rapidxml::xml_document<>*>(doc);
+		char* xml_name = name.empty() ? nullptr : xml_doc->allocate_string(name.data(), name.size());
+		node_ = xml_doc->allocate_node(xtype, xml_name, nullptr, name.size());
+	}
+
+	XMLNodeView XMLNode::View() const
+	{
+		return XMLNodeView(node_);
 	}
 
 	std::string const & XMLNode::Name() const
@@ -171,98 +464,37 @@ namespace KlayGE
 
 	XMLNodeType XMLNode::Type() const
 	{
-		switch (static_cast<rapidxml::xml_node<>*>(node_)->type())
-		{
-		case rapidxml::node_document:
-			return XNT_Document;
-
-		case rapidxml::node_element:
-			return XNT_Element;
-
-		case rapidxml::node_data:
-			return XNT_Data;
-
-		case rapidxml::node_cdata:
-			return XNT_CData;
-
-		case rapidxml::node_comment:
-			return XNT_Comment;
-
-		case rapidxml::node_declaration:
-			return XNT_Declaration;
-
-		case rapidxml::node_doctype:
-			return XNT_Doctype;
-
-		case rapidxml::node_pi:
-		default:
-			return XNT_PI;
-		}
+		return this->View().Type();
 	}
 
 	XMLNodePtr XMLNode::Parent() const
 	{
-		rapidxml::xml_node<>* node = static_cast<rapidxml::xml_node<>*>(node_)->parent();
-		if (node)
-		{
-			return MakeSharedPtr<XMLNode>(node);
-		}
-		else
-		{
-			return XMLNodePtr();
-		}
+		XMLNodeView const node = this->View().Parent();
+		return node ? MakeSharedPtr<XMLNode>(node.node_) : XMLNodePtr();
 	}
 
 	XMLAttributePtr XMLNode::FirstAttrib(std::string_view name) const
 	{
-		rapidxml::xml_attribute<>* attr = static_cast<rapidxml::xml_node<>*>(node_)->first_attribute(name.data(), name.size());
-		if (attr)
-		{
-			return MakeSharedPtr<XMLAttribute>(attr);
-		}
-		else
-		{
-			return XMLAttributePtr();
-		}
+		XMLAttributeView const attr = this->View().FirstAttrib(name);
+		return attr ? MakeSharedPtr<XMLAttribute>(attr.attr_) : XMLAttributePtr();
 	}
 	
 	XMLAttributePtr XMLNode::LastAttrib(std::string_view name) const
 	{
-		rapidxml::xml_attribute<>* attr = static_cast<rapidxml::xml_node<>*>(node_)->last_attribute(name.data(), name.size());
-		if (attr)
-		{
-			return MakeSharedPtr<XMLAttribute>(attr);
-		}
-		else
-		{
-			return XMLAttributePtr();
-		}
+		XMLAttributeView const attr = this->View().LastAttrib(name);
+		return attr ? MakeSharedPtr<XMLAttribute>(attr.attr_) : XMLAttributePtr();
 	}
 
 	XMLAttributePtr XMLNode::FirstAttrib() const
 	{
-		rapidxml::xml_attribute<>* attr = static_cast<rapidxml::xml_node<>*>(node_)->first_attribute();
-		if (attr)
-		{
-			return MakeSharedPtr<XMLAttribute>(attr);
-		}
-		else
-		{
-			return XMLAttributePtr();
-		}
+		XMLAttributeView const attr = this->View().FirstAttrib();
+		return attr ? MakeSharedPtr<XMLAttribute>(attr.attr_) : XMLAttributePtr();
 	}
 
 	XMLAttributePtr XMLNode::LastAttrib() const
 	{
-		rapidxml::xml_attribute<>* attr = static_cast<rapidxml::xml_node<>*>(node_)->last_attribute();
-		if (attr)
-		{
-			return MakeSharedPtr<XMLAttribute>(attr);
-		}
-		else
-		{
-			return XMLAttributePtr();
-		}
+		XMLAttributeView const attr = this->View().LastAttrib();
+		return attr ? MakeSharedPtr<XMLAttribute>(attr.attr_) : XMLAttributePtr();
 	}
 
 	XMLAttributePtr XMLNode::Attrib(std::string_view name) const
@@ -272,154 +504,86 @@ namespace KlayGE
 
 	bool XMLNode::TryConvertAttrib(std::string_view name, int32_t& val, int32_t default_val) const
 	{
-		val = default_val;
-
-		XMLAttributePtr attr = this->Attrib(name);
-		return attr ? attr->TryConvert(val) : true;
+		return this->View().TryConvertAttrib(name, val, default_val);
 	}
 
 	bool XMLNode::TryConvertAttrib(std::string_view name, uint32_t& val, uint32_t default_val) const
 	{
-		val = default_val;
-
-		XMLAttributePtr attr = this->Attrib(name);
-		return attr ? attr->TryConvert(val) : true;
+		return this->View().TryConvertAttrib(name, val, default_val);
 	}
 
 	bool XMLNode::TryConvertAttrib(std::string_view name, float& val, float default_val) const
 	{
-		val = default_val;
-
-		XMLAttributePtr attr = this->Attrib(name);
-		return attr ? attr->TryConvert(val) : true;
+		return this->View().TryConvertAttrib(name, val, default_val);
 	}
 
 	int32_t XMLNode::AttribInt(std::string_view name, int32_t default_val) const
 	{
-		XMLAttributePtr attr = this->Attrib(name);
-		return attr ? attr->ValueInt() : default_val;
+		return this->View().AttribInt(name, default_val);
 	}
 
 	uint32_t XMLNode::AttribUInt(std::string_view name, uint32_t default_val) const
 	{
-		XMLAttributePtr attr = this->Attrib(name);
-		return attr ? attr->ValueUInt() : default_val;
+		return this->View().AttribUInt(name, default_val);
 	}
 
 	float XMLNode::AttribFloat(std::string_view name, float default_val) const
 	{
-		XMLAttributePtr attr = this->Attrib(name);
-		return attr ? attr->ValueFloat() : default_val;
+		return this->View().AttribFloat(name, default_val);
 	}
 
 	std::string XMLNode::AttribString(std::string_view name, std::string default_val) const
 	{
-		XMLAttributePtr attr = this->Attrib(name);
-		return attr ? attr->ValueString() : default_val;
+		XMLAttributeView const attr = this->View().Attrib(name);
+		return attr ? std::string(attr.ValueString()) : default_val;
 	}
 
 	XMLNodePtr XMLNode::FirstNode(std::string_view name) const
 	{
-		rapidxml::xml_node<>* node = static_cast<rapidxml::xml_node<>*>(node_)->first_node(name.data(), name.size());
-		if (node)
-		{
-			return MakeSharedPtr<XMLNode>(node);
-		}
-		else
-		{
-			return XMLNodePtr();
-		}
+		XMLNodeView const node = this->View().FirstNode(name);
+		return node ? MakeSharedPtr<XMLNode>(node.node_) : XMLNodePtr();
 	}
 
 	XMLNodePtr XMLNode::LastNode(std::string_view name) const
 	{
-		rapidxml::xml_node<>* node = static_cast<rapidxml::xml_node<>*>(node_)->last_node(name.data(), name.size());
-		if (node)
-		{
-			return MakeSharedPtr<XMLNode>(node);
-		}
-		else
-		{
-			return XMLNodePtr();
-		}
+		XMLNodeView const node = this->View().LastNode(name);
+		return node ? MakeSharedPtr<XMLNode>(node.node_) : XMLNodePtr();
 	}
 
 	XMLNodePtr XMLNode::FirstNode() const
 	{
-		rapidxml::xml_node<>* node = static_cast<rapidxml::xml_node<>*>(node_)->first_node();
-		if (node)
-		{
-			return MakeSharedPtr<XMLNode>(node);
-		}
-		else
-		{
-			return XMLNodePtr();
-		}
+		XMLNodeView const node = this->View().FirstNode();
+		return node ? MakeSharedPtr<XMLNode>(node.node_) : XMLNodePtr();
 	}
 
 	XMLNodePtr XMLNode::LastNode() const
 	{
-		rapidxml::xml_node<>* node = static_cast<rapidxml::xml_node<>*>(node_)->last_node();
-		if (node)
-		{
-			return MakeSharedPtr<XMLNode>(node);
-		}
-		else
-		{
-			return XMLNodePtr();
-		}
+		XMLNodeView const node = this->View().LastNode();
+		return node ? MakeSharedPtr<XMLNode>(node.node_) : XMLNodePtr();
 	}
 
 	XMLNodePtr XMLNode::PrevSibling(std::string_view name) const
 	{
-		rapidxml::xml_node<>* node = static_cast<rapidxml::xml_node<>*>(node_)->previous_sibling(name.data(), name.size());
-		if (node)
-		{
-			return MakeSharedPtr<XMLNode>(node);
-		}
-		else
-		{
-			return XMLNodePtr();
-		}
+		XMLNodeView const node = this->View().PrevSibling(name);
+		return node ? MakeSharedPtr<XMLNode>(node.node_) : XMLNodePtr();
 	}
 
 	XMLNodePtr XMLNode::NextSibling(std::string_view name) const
 	{
-		rapidxml::xml_node<>* node = static_cast<rapidxml::xml_node<>*>(node_)->next_sibling(name.data(), name.size());
-		if (node)
-		{
-			return MakeSharedPtr<XMLNode>(node);
-		}
-		else
-		{
-			return XMLNodePtr();
-		}
+		XMLNodeView const node = this->View().NextSibling(name);
+		return node ? MakeSharedPtr<XMLNode>(node.node_) : XMLNodePtr();
 	}
 
 	XMLNodePtr XMLNode::PrevSibling() const
 	{
-		rapidxml::xml_node<>* node = static_cast<rapidxml::xml_node<>*>(node_)->previous_sibling();
-		if (node)
-		{
-			return MakeSharedPtr<XMLNode>(node);
-		}
-		else
-		{
-			return XMLNodePtr();
-		}
+		XMLNodeView const node = this->View().PrevSibling();
+		return node ? MakeSharedPtr<XMLNode>(node.node_) : XMLNodePtr();
 	}
 
 	XMLNodePtr XMLNode::NextSibling() const
 	{
-		rapidxml::xml_node<>* node = static_cast<rapidxml::xml_node<>*>(node_)->next_sibling();
-		if (node)
-		{
-			return MakeSharedPtr<XMLNode>(node);
-		}
-		else
-		{
-			return XMLNodePtr();
-		}
+		XMLNodeView const node = this->View().NextSibling();
+		return node ? MakeSharedPtr<XMLNode>(node.node_) : XMLNodePtr();
 	}
 
 	void XMLNode::InsertNode(XMLNodePtr const & location, XMLNodePtr const & new_node)
@@ -490,38 +654,37 @@ namespace KlayGE
 
 	bool XMLNode::TryConvert(int32_t& val) const
 	{
-		return boost::conversion::try_lexical_convert(this->ValueString(), val);
+		return this->View().TryConvert(val);
 	}
 
 	bool XMLNode::TryConvert(uint32_t& val) const
 	{
-		return boost::conversion::try_lexical_convert(this->ValueString(), val);
+		return this->View().TryConvert(val);
 	}
 
 	bool XMLNode::TryConvert(float& val) const
 	{
-		return boost::conversion::try_lexical_convert(this->ValueString(), val);
+		return this->View().TryConvert(val);
 	}
 
 	int32_t XMLNode::ValueInt() const
 	{
-		return boost::lexical_cast<int32_t>(this->ValueString());
+		return this->View().ValueInt();
 	}
 
 	uint32_t XMLNode::ValueUInt() const
 	{
-		return boost::lexical_cast<uint32_t>(this->ValueString());
+		return this->View().ValueUInt();
 	}
 
 	float XMLNode::ValueFloat() const
 	{
-		return boost::lexical_cast<float>(this->ValueString());
+		return this->View().ValueFloat();
 	}
 
 	std::string XMLNode::ValueString() const
 	{
-		return std::string(static_cast<rapidxml::xml_node<>*>(node_)->value(),
-			static_cast<rapidxml::xml_node<>*>(node_)->value_size());
+		return std::string(this->View().ValueString());
 	}
 
 
@@ -530,16 +693,25 @@ namespace KlayGE
 	{
 		if (attr_ != nullptr)
 		{
-			auto const xml_attr = static_cast<rapidxml::xml_attribute<>*>(attr_);
-			name_ = std::string(xml_attr->name(), xml_attr->name_size());
-			value_ = std::string(xml_attr->value(), xml_attr->value_size());
+			XMLAttributeView const view = this->View();
+			name_ = std::string(view.Name());
+			value_ = std::string(view.ValueString());
 		}
 	}
 
 	XMLAttribute::XMLAttribute(void* doc, std::string_view name, std::string_view value)
 		: name_(name), value_(value)
 	{
-		attr_ = static_cast<rapidxml::xml_document<>*>(doc)->allocate_attribute(name.data(), value.data(), name.size(), value.size());
+		// Copied into the document, like the names of nodes
+		auto xml_doc = static_cast<rapidxml::xml_document<>*>(doc);
+		char* xml_name = name.empty() ? nullptr : xml_doc->allocate_string(name.data(), name.size());
+		char* xml_value = value.empty() ? nullptr : xml_doc->allocate_string(value.data(), value.size());
+		attr_ = xml_doc->allocate_attribute(xml_name, xml_value, name.size(), value.size());
+	}
+
+	XMLAttributeView XMLAttribute::View() const
+	{
+		return XMLAttributeView(attr_);
 	}
 
 	std::string const & XMLAttribute::Name() const
@@ -549,58 +721,44 @@ namespace KlayGE
 
 	XMLAttributePtr XMLAttribute::NextAttrib(std::string_view name) const
 	{
-		rapidxml::xml_attribute<>* attr = static_cast<rapidxml::xml_attribute<>*>(attr_)->next_attribute(name.data(), name.size());
-		if (attr)
-		{
-			return MakeSharedPtr<XMLAttribute>(attr);
-		}
-		else
-		{
-			return XMLAttributePtr();
-		}
+		XMLAttributeView const attr = this->View().NextAttrib(name);
+		return attr ? MakeSharedPtr<XMLAttribute>(attr.attr_) : XMLAttributePtr();
 	}
 
 	XMLAttributePtr XMLAttribute::NextAttrib() const
 	{
-		rapidxml::xml_attribute<>* attr = static_cast<rapidxml::xml_attribute<>*>(attr_)->next_attribute();
-		if (attr)
-		{
-			return MakeSharedPtr<XMLAttribute>(attr);
-		}
-		else
-		{
-			return XMLAttributePtr();
-		}
+		XMLAttributeView const attr = this->View().NextAttrib();
+		return attr ? MakeSharedPtr<XMLAttribute>(attr.attr_) : XMLAttributePtr();
 	}
 
 	bool XMLAttribute::TryConvert(int32_t& val) const
 	{
-		return boost::conversion::try_lexical_convert(value_, val);
+		return TryConvertValue(value_, val);
 	}
 
 	bool XMLAttribute::TryConvert(uint32_t& val) const
 	{
-		return boost::conversion::try_lexical_convert(value_, val);
+		return TryConvertValue(value_, val);
 	}
 
 	bool XMLAttribute::TryConvert(float& val) const
 	{
-		return boost::conversion::try_lexical_convert(value_, val);
+		return TryConvertValue(value_, val);
 	}
 
 	int32_t XMLAttribute::ValueInt() const
 	{
-		return boost::lexical_cast<int32_t>(value_);
+		return ConvertValue<int32_t>(value_);
 	}
 
 	uint32_t XMLAttribute::ValueUInt() const
 	{
-		return boost::lexical_cast<uint32_t>(value_);
+		return ConvertValue<uint32_t>(value_);
 	}
 
 	float XMLAttribute::ValueFloat() const
 	{
-		return boost::lexical_cast<float>(value_);
+		return ConvertValue<float>(value_);
 	}
 
 	std::string const & XMLAttribute::ValueString() const
@@ -0,0 +1,870 @@
+/**
+ * @file SIMDBatch.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KFL, a subproject of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KFL/KFL.hpp>
+#include <KFL/CpuInfo.hpp>
+#include <KFL/SIMDMath.hpp>
+
+#include <atomic>
+#include <limits>
+
+#ifdef SIMD_MATH_SSE
+	#include <emmintrin.h>
+
+	// The AVX2 kernels are compiled for AVX2 and FMA function by function, and only called when the CPU has both.
+	//  The rest of the file, including anything inlined from other headers, stays at the baseline.
+	#if !defined(KLAYGE_PLATFORM_ANDROID)
+		#define SIMD_BATCH_AVX2
+		#include <immintrin.h>
+		#if defined(KLAYGE_COMPILER_GCC) || defined(KLAYGE_COMPILER_CLANG)
+			#define AVX2_TARGET __attribute__((target("avx2,fma")))
+		#else
+			#define AVX2_TARGET
+		#endif
+	#endif
+#endif
+
+namespace
+{
+	using namespace KlayGE;
+	using namespace KlayGE::SIMDMathLib;
+
+	static_assert(sizeof(float3) == 3 * sizeof(float), "float3 must be packed.");
+	static_assert(sizeof(AABBox) == sizeof(Bound_T<float>) + 2 * sizeof(float3), "min and max of AABBox must be packed.");
+	static_assert(sizeof(Quaternion) == 4 * sizeof(float), "Quaternion must be packed.");
+
+	std::atomic<int32_t>& ActiveBatchTargetStorage()
+	{
+		static std::atomic<int32_t> target([]
+			{
+				BatchTarget best = BT_Scalar;
+				if (IsBatchTargetSupported(BT_AVX2))
+				{
+					best = BT_AVX2;
+				}
+				else if (IsBatchTargetSupported(BT_SSE))
+				{
+					best = BT_SSE;
+				}
+				return static_cast<int32_t>(best);
+			}());
+		return target;
+	}
+
+	// For each frustum plane, the arrays the corner farthest along the normal (v0) and the nearest one (v1) come from
+	struct FrustumCorners
+	{
+		float const * v0[6][3];
+		float const * v1[6][3];
+		float plane[6][4];
+	};
+
+	void WriteOverlaps(BoundOverlap* results, uint32_t no_mask, uint32_t partial_mask, uint32_t n)
+	{
+		for (uint32_t j = 0; j < n; ++ j)
+		{
+			if (no_mask & (1UL << j))
+			{
+				results[j] = BO_No;
+			}
+			else
+			{
+				results[j] = (partial_mask & (1UL << j)) ? BO_Partial : BO_Yes;
+			}
+		}
+	}
+
+	void TransformAABBScalar(float* out, float const * in, float4x4 const & mat)
+	{
+		float center[3];
+		float extent[3];
+		for (int c = 0; c < 3; ++ c)
+		{
+			center[c] = (in[c] + in[3 + c]) * 0.5f;
+			extent[c] = (in[3 + c] - in[c]) * 0.5f;
+		}
+		for (int c = 0; c < 3; ++ c)
+		{
+			float const new_center = center[0] * mat(0, c) + center[1] * mat(1, c) + center[2] * mat(2, c) + mat(3, c);
+			float const new_extent = extent[0] * MathLib::abs(mat(0, c)) + extent[1] * MathLib::abs(mat(1, c))
+				+ extent[2] * MathLib::abs(mat(2, c));
+			out[c] = new_center - new_extent;
+			out[3 + c] = new_center + new_extent;
+		}
+	}
+
+#ifdef SIMD_MATH_SSE
+	// Polynomials for SlerpQuats, from Abramowitz and Stegun. acos is for [0, 1], sin for [0, PI / 2].
+	float const ACOS_COEFFS[] = { 1.5707963050f, -0.2145988016f, 0.0889789874f, -0.0501743046f,
+		0.0308918810f, -0.0170881256f, 0.0066700901f, -0.0012624911f };
+	float const SIN_COEFFS[] = { 1.0f, -1.0f / 6, 1.0f / 120, -1.0f / 5040, 1.0f / 362880, -1.0f / 39916800 };
+
+	// 4 float3 to x, y and z of 4 lanes
+	void LoadFloat3x4(__m128& x, __m128& y, __m128& z, float const * p)
+	{
+		__m128 const m0 = _mm_loadu_ps(p + 0);
+		__m128 const m1 = _mm_loadu_ps(p + 4);
+		__m128 const m2 = _mm_loadu_ps(p + 8);
+		__m128 const xy = _mm_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 1, 3, 2));
+		__m128 const yz = _mm_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 0, 2, 1));
+		x = _mm_shuffle_ps(m0, xy, _MM_SHUFFLE(2, 0, 3, 0));
+		y = _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+		z = _mm_shuffle_ps(yz, m2, _MM_SHUFFLE(3, 0, 3, 1));
+	}
+
+	void StoreFloat3x4(float* p, __m128 x, __m128 y, __m128 z)
+	{
+		__m128 const xy = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+		__m128 const yz = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+		__m128 const zx = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+		_mm_storeu_ps(p + 0, _mm_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0)));
+		_mm_storeu_ps(p + 4, _mm_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0)));
+		_mm_storeu_ps(p + 8, _mm_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1)));
+	}
+
+	void LoadQuatx4(__m128 q[4], float const * p)
+	{
+		for (int i = 0; i < 4; ++ i)
+		{
+			q[i] = _mm_loadu_ps(p + i * 4);
+		}
+		_MM_TRANSPOSE4_PS(q[0], q[1], q[2], q[3]);
+	}
+
+	void StoreQuatx4(float* p, __m128 q[4])
+	{
+		_MM_TRANSPOSE4_PS(q[0], q[1], q[2], q[3]);
+		for (int i = 0; i < 4; ++ i)
+		{
+			_mm_storeu_ps(p + i * 4, q[i]);
+		}
+	}
+
+	__m128 Select(__m128 mask, __m128 a, __m128 b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	__m128 Abs(__m128 v)
+	{
+		return _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)));
+	}
+
+	__m128 AcosUnit(__m128 x)
+	{
+		__m128 ret = _mm_set1_ps(ACOS_COEFFS[7]);
+		for (int i = 6; i >= 0; -- i)
+		{
+			ret = _mm_add_ps(_mm_mul_ps(ret, x), _mm_set1_ps(ACOS_COEFFS[i]));
+		}
+		return _mm_mul_ps(ret, _mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1), x)));
+	}
+
+	__m128 SinHalfPI(__m128 x)
+	{
+		__m128 const x2 = _mm_mul_ps(x, x);
+		__m128 ret = _mm_set1_ps(SIN_COEFFS[5]);
+		for (int i = 4; i >= 0; -- i)
+		{
+			ret = _mm_add_ps(_mm_mul_ps(ret, x2), _mm_set1_ps(SIN_COEFFS[i]));
+		}
+		return _mm_mul_ps(ret, x);
+	}
+
+	uint32_t TransformCoordsSSE(float3* out, float3 const * in, uint32_t num, float4x4 const & mat)
+	{
+		__m128 m[4][4];
+		for (int r = 0; r < 4; ++ r)
+		{
+			for (int c = 0; c < 4; ++ c)
+			{
+				m[r][c] = _mm_set1_ps(mat(r, c));
+			}
+		}
+		__m128 const epsilon = _mm_set1_ps(std::numeric_limits<float>::epsilon());
+
+		uint32_t const n = num & ~3U;
+		for (uint32_t i = 0; i < n; i += 4)
+		{
+			__m128 v[3];
+			LoadFloat3x4(v[0], v[1], v[2], &in[i].x());
+
+			__m128 t[4];
+			for (int c = 0; c < 4; ++ c)
+			{
+				t[c] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(v[0], m[0][c]), _mm_mul_ps(v[1], m[1][c])),
+					_mm_add_ps(_mm_mul_ps(v[2], m[2][c]), m[3][c]));
+			}
+
+			// Zero when w is 0, like transform_coord
+			__m128 const valid = _mm_cmpgt_ps(Abs(t[3]), epsilon);
+			for (int c = 0; c < 3; ++ c)
+			{
+				v[c] = _mm_and_ps(valid, _mm_div_ps(t[c], t[3]));
+			}
+			StoreFloat3x4(&out[i].x(), v[0], v[1], v[2]);
+		}
+		return n;
+	}
+
+	uint32_t TransformAABBsSSE(AABBox* out, AABBox const * in, uint32_t num, float4x4 const & mat)
+	{
+		__m128 m[4][3];
+		__m128 abs_m[3][3];
+		for (int r = 0; r < 4; ++ r)
+		{
+			for (int c = 0; c < 3; ++ c)
+			{
+				m[r][c] = _mm_set1_ps(mat(r, c));
+				if (r < 3)
+				{
+					abs_m[r][c] = _mm_set1_ps(MathLib::abs(mat(r, c)));
+				}
+			}
+		}
+		__m128 const half = _mm_set1_ps(0.5f);
+
+		uint32_t const n = num & ~3U;
+		for (uint32_t i = 0; i < n; i += 4)
+		{
+			// AABBox has a vtable, so each box is loaded as min_x, min_y, min_z, max_x and min_z, max_x, max_y, max_z.
+			//  Both stay inside the box.
+			__m128 lo[4];
+			__m128 hi[4];
+			for (int j = 0; j < 4; ++ j)
+			{
+				lo[j] = _mm_loadu_ps(&in[i + j].Min().x());
+				hi[j] = _mm_loadu_ps(&in[i + j].Min().z());
+			}
+			_MM_TRANSPOSE4_PS(lo[0], lo[1], lo[2], lo[3]);
+			_MM_TRANSPOSE4_PS(hi[0], hi[1], hi[2], hi[3]);
+
+			__m128 center[3];
+			__m128 extent[3];
+			for (int c = 0; c < 3; ++ c)
+			{
+				center[c] = _mm_mul_ps(_mm_add_ps(lo[c], hi[c + 1]), half);
+				extent[c] = _mm_mul_ps(_mm_sub_ps(hi[c + 1], lo[c]), half);
+			}
+
+			for (int c = 0; c < 3; ++ c)
+			{
+				__m128 const new_center = _mm_add_ps(_mm_add_ps(_mm_mul_ps(center[0], m[0][c]), _mm_mul_ps(center[1], m[1][c])),
+					_mm_add_ps(_mm_mul_ps(center[2], m[2][c]), m[3][c]));
+				__m128 const new_extent = _mm_add_ps(_mm_add_ps(_mm_mul_ps(extent[0], abs_m[0][c]),
+					_mm_mul_ps(extent[1], abs_m[1][c])), _mm_mul_ps(extent[2], abs_m[2][c]));
+				lo[c] = _mm_sub_ps(new_center, new_extent);
+				hi[c + 1] = _mm_add_ps(new_center, new_extent);
+			}
+			lo[3] = hi[1];
+			hi[0] = lo[2];
+
+			_MM_TRANSPOSE4_PS(lo[0], lo[1], lo[2], lo[3]);
+			_MM_TRANSPOSE4_PS(hi[0], hi[1], hi[2], hi[3]);
+			for (int j = 0; j < 4; ++ j)
+			{
+				_mm_storeu_ps(&out[i + j].Min().x(), lo[j]);
+				_mm_storeu_ps(&out[i + j].Min().z(), hi[j]);
+			}
+		}
+		return n;
+	}
+
+	uint32_t MultiplyQuatsSSE(Quaternion* out, Quaternion const * lhs, Quaternion const * rhs, uint32_t num)
+	{
+		uint32_t const n = num & ~3U;
+		for (uint32_t i = 0; i < n; i += 4)
+		{
+			__m128 l[4];
+			__m128 r[4];
+			LoadQuatx4(l, &lhs[i].x());
+			LoadQuatx4(r, &rhs[i].x());
+
+			__m128 q[4];
+			q[0] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(l[0], r[3]), _mm_mul_ps(l[1], r[2])),
+				_mm_add_ps(_mm_mul_ps(l[2], r[1]), _mm_mul_ps(l[3], r[0])));
+			q[1] = _mm_add_ps(_mm_sub_ps(_mm_add_ps(_mm_mul_ps(l[0], r[2]), _mm_mul_ps(l[1], r[3])), _mm_mul_ps(l[2], r[0])),
+				_mm_mul_ps(l[3], r[1]));
+			q[2] = _mm_add_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(l[1], r[0]), _mm_mul_ps(l[0], r[1])), _mm_mul_ps(l[2], r[3])),
+				_mm_mul_ps(l[3], r[2]));
+			q[3] = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(l[3], r[3]), _mm_mul_ps(l[0], r[0])), _mm_mul_ps(l[1], r[1])),
+				_mm_mul_ps(l[2], r[2]));
+			StoreQuatx4(&out[i].x(), q);
+		}
+		return n;
+	}
+
+	uint32_t SlerpQuatsSSE(Quaternion* out, Quaternion const * lhs, Quaternion const * rhs, float const * s, uint32_t num)
+	{
+		__m128 const one = _mm_set1_ps(1);
+		__m128 const lerp_threshold = _mm_set1_ps(1 - std::numeric_limits<float>::epsilon());
+		__m128 const sign_mask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+
+		uint32_t const n = num & ~3U;
+		for (uint32_t i = 0; i < n; i += 4)
+		{
+			__m128 l[4];
+			__m128 r[4];
+			LoadQuatx4(l, &lhs[i].x());
+			LoadQuatx4(r, &rhs[i].x());
+			__m128 const t = _mm_loadu_ps(s + i);
+
+			__m128 cosom = _mm_add_ps(_mm_add_ps(_mm_mul_ps(l[0], r[0]), _mm_mul_ps(l[1], r[1])),
+				_mm_add_ps(_mm_mul_ps(l[2], r[2]), _mm_mul_ps(l[3], r[3])));
+			// Takes the shorter way by flipping rhs
+			__m128 const dir = _mm_and_ps(cosom, sign_mask);
+			cosom = _mm_xor_ps(cosom, dir);
+
+			__m128 const omega = AcosUnit(cosom);
+			__m128 const isinom = _mm_div_ps(one, SinHalfPI(omega));
+			__m128 const one_minus_t = _mm_sub_ps(one, t);
+			__m128 const lerp = _mm_cmpge_ps(cosom, lerp_threshold);
+			__m128 const scale0 = Select(lerp, one_minus_t, _mm_mul_ps(SinHalfPI(_mm_mul_ps(one_minus_t, omega)), isinom));
+			__m128 const scale1 = _mm_xor_ps(Select(lerp, t, _mm_mul_ps(SinHalfPI(_mm_mul_ps(t, omega)), isinom)), dir);
+
+			__m128 q[4];
+			for (int c = 0; c < 4; ++ c)
+			{
+				q[c] = _mm_add_ps(_mm_mul_ps(l[c], scale0), _mm_mul_ps(r[c], scale1));
+			}
+			StoreQuatx4(&out[i].x(), q);
+		}
+		return n;
+	}
+
+	uint32_t IntersectAABBFrustumSSE(BoundOverlap* results, FrustumCorners const & corners, uint32_t first, uint32_t num)
+	{
+		__m128 plane[6][4];
+		for (int p = 0; p < 6; ++ p)
+		{
+			for (int c = 0; c < 4; ++ c)
+			{
+				plane[p][c] = _mm_set1_ps(corners.plane[p][c]);
+			}
+		}
+		__m128 const zero = _mm_setzero_ps();
+
+		// The arrays are padded to a multiple of 4
+		uint32_t const n = (num + 3) & ~3U;
+		for (uint32_t i = first; i < n; i += 4)
+		{
+			__m128 min_v0_dist = _mm_set1_ps(+1e30f);
+			__m128 min_v1_dist = _mm_set1_ps(+1e30f);
+			for (int p = 0; p < 6; ++ p)
+			{
+				// Summed in the order of MathLib::dot_coord
+				__m128 const v0 = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(corners.v0[p][0] + i), plane[p][0]),
+					_mm_mul_ps(_mm_load_ps(corners.v0[p][1] + i), plane[p][1])),
+					_mm_mul_ps(_mm_load_ps(corners.v0[p][2] + i), plane[p][2])), plane[p][3]);
+				__m128 const v1 = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(corners.v1[p][0] + i), plane[p][0]),
+					_mm_mul_ps(_mm_load_ps(corners.v1[p][1] + i), plane[p][1])),
+					_mm_mul_ps(_mm_load_ps(corners.v1[p][2] + i), plane[p][2])), plane[p][3]);
+				min_v0_dist = _mm_min_ps(min_v0_dist, v0);
+				min_v1_dist = _mm_min_ps(min_v1_dist, v1);
+			}
+
+			uint32_t const no_mask = _mm_movemask_ps(_mm_cmplt_ps(min_v0_dist, zero));
+			uint32_t const partial_mask = _mm_movemask_ps(_mm_cmplt_ps(min_v1_dist, zero));
+			uint32_t const left = num - i;
+			WriteOverlaps(results + i, no_mask, partial_mask, (left < 4) ? left : 4);
+		}
+		return num;
+	}
+#endif
+
+#ifdef SIMD_BATCH_AVX2
+	AVX2_TARGET void LoadFloat3x8(__m256& x, __m256& y, __m256& z, float const * p)
+	{
+		// Float3 0 to 3 in the low lane, 4 to 7 in the high lane
+		__m256 const m0 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 0)), _mm_loadu_ps(p + 12), 1);
+		__m256 const m1 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 4)), _mm_loadu_ps(p + 16), 1);
+		__m256 const m2 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 8)), _mm_loadu_ps(p + 20), 1);
+		__m256 const xy = _mm256_shuffle_ps(m1, m2, _MM_SHUFFLE(2, 1, 3, 2));
+		__m256 const yz = _mm256_shuffle_ps(m0, m1, _MM_SHUFFLE(1, 0, 2, 1));
+		x = _mm256_shuffle_ps(m0, xy, _MM_SHUFFLE(2, 0, 3, 0));
+		y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+		z = _mm256_shuffle_ps(yz, m2, _MM_SHUFFLE(3, 0, 3, 1));
+	}
+
+	AVX2_TARGET void StoreFloat3x8(float* p, __m256 x, __m256 y, __m256 z)
+	{
+		__m256 const xy = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+		__m256 const yz = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+		__m256 const zx = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+		__m256 const m0 = _mm256_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0));
+		__m256 const m1 = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+		__m256 const m2 = _mm256_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1));
+		_mm_storeu_ps(p + 0, _mm256_castps256_ps128(m0));
+		_mm_storeu_ps(p + 4, _mm256_castps256_ps128(m1));
+		_mm_storeu_ps(p + 8, _mm256_castps256_ps128(m2));
+		_mm_storeu_ps(p + 12, _mm256_extractf128_ps(m0, 1));
+		_mm_storeu_ps(p + 16, _mm256_extractf128_ps(m1, 1));
+		_mm_storeu_ps(p + 20, _mm256_extractf128_ps(m2, 1));
+	}
+
+	// A 4x4 transpose in each lane. Its own inverse.
+	AVX2_TARGET void Transpose4x8(__m256 q[4])
+	{
+		__m256 const t0 = _mm256_unpacklo_ps(q[0], q[1]);
+		__m256 const t1 = _mm256_unpacklo_ps(q[2], q[3]);
+		__m256 const t2 = _mm256_unpackhi_ps(q[0], q[1]);
+		__m256 const t3 = _mm256_unpackhi_ps(q[2], q[3]);
+		q[0] = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+		q[1] = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+		q[2] = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+		q[3] = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+	}
+
+	AVX2_TARGET void LoadQuatx8(__m256 q[4], float const * p)
+	{
+		// Quaternion i in the low lane, i + 4 in the high lane
+		for (int i = 0; i < 4; ++ i)
+		{
+			q[i] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + i * 4)), _mm_loadu_ps(p + i * 4 + 16), 1);
+		}
+		Transpose4x8(q);
+	}
+
+	AVX2_TARGET void StoreQuatx8(float* p, __m256 q[4])
+	{
+		Transpose4x8(q);
+		for (int i = 0; i < 4; ++ i)
+		{
+			_mm_storeu_ps(p + i * 4, _mm256_castps256_ps128(q[i]));
+			_mm_storeu_ps(p + i * 4 + 16, _mm256_extractf128_ps(q[i], 1));
+		}
+	}
+
+	AVX2_TARGET __m256 AcosUnit(__m256 x)
+	{
+		__m256 ret = _mm256_set1_ps(ACOS_COEFFS[7]);
+		for (int i = 6; i >= 0; -- i)
+		{
+			ret = _mm256_fmadd_ps(ret, x, _mm256_set1_ps(ACOS_COEFFS[i]));
+		}
+		return _mm256_mul_ps(ret, _mm256_sqrt_ps(_mm256_sub_ps(_mm256_set1_ps(1), x)));
+	}
+
+	AVX2_TARGET __m256 SinHalfPI(__m256 x)
+	{
+		__m256 const x2 = _mm256_mul_ps(x, x);
+		__m256 ret = _mm256_set1_ps(SIN_COEFFS[5]);
+		for (int i = 4; i >= 0; -- i)
+		{
+			ret = _mm256_fmadd_ps(ret, x2, _mm256_set1_ps(SIN_COEFFS[i]));
+		}
+		return _mm256_mul_ps(ret, x);
+	}
+
+	AVX2_TARGET uint32_t TransformCoordsAVX2(float3* out, float3 const * in, uint32_t num, float4x4 const & mat)
+	{
+		__m256 m[4][4];
+		for (int r = 0; r < 4; ++ r)
+		{
+			for (int c = 0; c < 4; ++ c)
+			{
+				m[r][c] = _mm256_set1_ps(mat(r, c));
+			}
+		}
+		__m256 const epsilon = _mm256_set1_ps(std::numeric_limits<float>::epsilon());
+		__m256 const abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+
+		uint32_t const n = num & ~7U;
+		for (uint32_t i = 0; i < n; i += 8)
+		{
+			__m256 v[3];
+			LoadFloat3x8(v[0], v[1], v[2], &in[i].x());
+
+			__m256 t[4];
+			for (int c = 0; c < 4; ++ c)
+			{
+				t[c] = _mm256_fmadd_ps(v[0], m[0][c], _mm256_fmadd_ps(v[1], m[1][c], _mm256_fmadd_ps(v[2], m[2][c], m[3][c])));
+			}
+
+			__m256 const valid = _mm256_cmp_ps(_mm256_and_ps(t[3], abs_mask), epsilon, _CMP_GT_OQ);
+			for (int c = 0; c < 3; ++ c)
+			{
+				v[c] = _mm256_and_ps(valid, _mm256_div_ps(t[c], t[3]));
+			}
+			StoreFloat3x8(&out[i].x(), v[0], v[1], v[2]);
+		}
+		return n;
+	}
+
+	AVX2_TARGET uint32_t TransformAABBsAVX2(AABBox* out, AABBox const * in, uint32_t num, float4x4 const & mat)
+	{
+		__m256 m[4][3];
+		__m256 abs_m[3][3];
+		for (int r = 0; r < 4; ++ r)
+		{
+			for (int c = 0; c < 3; ++ c)
+			{
+				m[r][c] = _mm256_set1_ps(mat(r, c));
+				if (r < 3)
+				{
+					abs_m[r][c] = _mm256_set1_ps(MathLib::abs(mat(r, c)));
+				}
+			}
+		}
+		__m256 const half = _mm256_set1_ps(0.5f);
+
+		uint32_t const n = num & ~7U;
+		for (uint32_t i = 0; i < n; i += 8)
+		{
+			// Same as the SSE one, box j in the low lane and j + 4 in the high lane
+			__m256 lo[4];
+			__m256 hi[4];
+			for (int j = 0; j < 4; ++ j)
+			{
+				lo[j] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&in[i + j].Min().x())),
+					_mm_loadu_ps(&in[i + j + 4].Min().x()), 1);
+				hi[j] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&in[i + j].Min().z())),
+					_mm_loadu_ps(&in[i + j + 4].Min().z()), 1);
+			}
+			Transpose4x8(lo);
+			Transpose4x8(hi);
+
+			__m256 center[3];
+			__m256 extent[3];
+			for (int c = 0; c < 3; ++ c)
+			{
+				center[c] = _mm256_mul_ps(_mm256_add_ps(lo[c], hi[c + 1]), half);
+				extent[c] = _mm256_mul_ps(_mm256_sub_ps(hi[c + 1], lo[c]), half);
+			}
+
+			for (int c = 0; c < 3; ++ c)
+			{
+				__m256 const new_center = _mm256_fmadd_ps(center[0], m[0][c],
+					_mm256_fmadd_ps(center[1], m[1][c], _mm256_fmadd_ps(center[2], m[2][c], m[3][c])));
+				__m256 const new_extent = _mm256_fmadd_ps(extent[0], abs_m[0][c],
+					_mm256_fmadd_ps(extent[1], abs_m[1][c], _mm256_mul_ps(extent[2], abs_m[2][c])));
+				lo[c] = _mm256_sub_ps(new_center, new_extent);
+				hi[c + 1] = _mm256_add_ps(new_center, new_extent);
+			}
+			lo[3] = hi[1];
+			hi[0] = lo[2];
+
+			Transpose4x8(lo);
+			Transpose4x8(hi);
+			for (int j = 0; j < 4; ++ j)
+			{
+				_mm_storeu_ps(&out[i + j].Min().x(), _mm256_castps256_ps128(lo[j]));
+				_mm_storeu_ps(&out[i + j].Min().z(), _mm256_castps256_ps128(hi[j]));
+				_mm_storeu_ps(&out[i + j + 4].Min().x(), _mm256_extractf128_ps(lo[j], 1));
+				_mm_storeu_ps(&out[i + j + 4].Min().z(), _mm256_extractf128_ps(hi[j], 1));
+			}
+		}
+		return n;
+	}
+
+	AVX2_TARGET uint32_t MultiplyQuatsAVX2(Quaternion* out, Quaternion const * lhs, Quaternion const * rhs, uint32_t num)
+	{
+		uint32_t const n = num & ~7U;
+		for (uint32_t i = 0; i < n; i += 8)
+		{
+			__m256 l[4];
+			__m256 r[4];
+			LoadQuatx8(l, &lhs[i].x());
+			LoadQuatx8(r, &rhs[i].x());
+
+			__m256 q[4];
+			q[0] = _mm256_fmadd_ps(l[3], r[0], _mm256_fmadd_ps(l[2], r[1], _mm256_fmsub_ps(l[0], r[3], _mm256_mul_ps(l[1], r[2]))));
+			q[1] = _mm256_fmadd_ps(l[3], r[1], _mm256_fnmadd_ps(l[2], r[0], _mm256_fmadd_ps(l[0], r[2], _mm256_mul_ps(l[1], r[3]))));
+			q[2] = _mm256_fmadd_ps(l[3], r[2], _mm256_fmadd_ps(l[2], r[3], _mm256_fmsub_ps(l[1], r[0], _mm256_mul_ps(l[0], r[1]))));
+			q[3] = _mm256_fnmadd_ps(l[2], r[2], _mm256_fnmadd_ps(l[1], r[1], _mm256_fmsub_ps(l[3], r[3], _mm256_mul_ps(l[0], r[0]))));
+			StoreQuatx8(&out[i].x(), q);
+		}
+		return n;
+	}
+
+	AVX2_TARGET uint32_t SlerpQuatsAVX2(Quaternion* out, Quaternion const * lhs, Quaternion const * rhs, float const * s, uint32_t num)
+	{
+		__m256 const one = _mm256_set1_ps(1);
+		__m256 const lerp_threshold = _mm256_set1_ps(1 - std::numeric_limits<float>::epsilon());
+		__m256 const sign_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x80000000));
+
+		uint32_t const n = num & ~7U;
+		for (uint32_t i = 0; i < n; i += 8)
+		{
+			__m256 l[4];
+			__m256 r[4];
+			LoadQuatx8(l, &lhs[i].x());
+			LoadQuatx8(r, &rhs[i].x());
+			// The same order as the quaternions
+			__m256 const t = _mm256_permute2f128_ps(_mm256_castps128_ps256(_mm_loadu_ps(s + i)),
+				_mm256_castps128_ps256(_mm_loadu_ps(s + i + 4)), 0x20);
+
+			__m256 cosom = _mm256_fmadd_ps(l[0], r[0], _mm256_fmadd_ps(l[1], r[1], _mm256_fmadd_ps(l[2], r[2], _mm256_mul_ps(l[3], r[3]))));
+			__m256 const dir = _mm256_and_ps(cosom, sign_mask);
+			cosom = _mm256_xor_ps(cosom, dir);
+
+			__m256 const omega = AcosUnit(cosom);
+			__m256 const isinom = _mm256_div_ps(one, SinHalfPI(omega));
+			__m256 const one_minus_t = _mm256_sub_ps(one, t);
+			__m256 const lerp = _mm256_cmp_ps(cosom, lerp_threshold, _CMP_GE_OQ);
+			__m256 const scale0 = _mm256_blendv_ps(_mm256_mul_ps(SinHalfPI(_mm256_mul_ps(one_minus_t, omega)), isinom), one_minus_t, lerp);
+			__m256 const scale1 = _mm256_xor_ps(_mm256_blendv_ps(_mm256_mul_ps(SinHalfPI(_mm256_mul_ps(t, omega)), isinom), t, lerp), dir);
+
+			__m256 q[4];
+			for (int c = 0; c < 4; ++ c)
+			{
+				q[c] = _mm256_fmadd_ps(l[c], scale0, _mm256_mul_ps(r[c], scale1));
+			}
+			StoreQuatx8(&out[i].x(), q);
+		}
+		return n;
+	}
+
+	AVX2_TARGET uint32_t IntersectAABBFrustumAVX2(BoundOverlap* results, FrustumCorners const & corners, uint32_t num)
+	{
+		__m256 plane[6][4];
+		for (int p = 0; p < 6; ++ p)
+		{
+			for (int c = 0; c < 4; ++ c)
+			{
+				plane[p][c] = _mm256_set1_ps(corners.plane[p][c]);
+			}
+		}
+		__m256 const zero = _mm256_setzero_ps();
+
+		uint32_t const n = num & ~7U;
+		for (uint32_t i = 0; i < n; i += 8)
+		{
+			__m256 min_v0_dist = _mm256_set1_ps(+1e30f);
+			__m256 min_v1_dist = _mm256_set1_ps(+1e30f);
+			for (int p = 0; p < 6; ++ p)
+			{
+				// No FMA, and summed in the order of MathLib::dot_coord, so boxes touching a plane are classified the same
+				__m256 const v0 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(corners.v0[p][0] + i), plane[p][0]),
+					_mm256_mul_ps(_mm256_loadu_ps(corners.v0[p][1] + i), plane[p][1])),
+					_mm256_mul_ps(_mm256_loadu_ps(corners.v0[p][2] + i), plane[p][2])), plane[p][3]);
+				__m256 const v1 = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(corners.v1[p][0] + i), plane[p][0]),
+					_mm256_mul_ps(_mm256_loadu_ps(corners.v1[p][1] + i), plane[p][1])),
+					_mm256_mul_ps(_mm256_loadu_ps(corners.v1[p][2] + i), plane[p][2])), plane[p][3]);
+				min_v0_dist = _mm256_min_ps(min_v0_dist, v0);
+				min_v1_dist = _mm256_min_ps(min_v1_dist, v1);
+			}
+
+			uint32_t const no_mask = _mm256_movemask_ps(_mm256_cmp_ps(min_v0_dist, zero, _CMP_LT_OQ));
+			uint32_t const partial_mask = _mm256_movemask_ps(_mm256_cmp_ps(min_v1_dist, zero, _CMP_LT_OQ));
+			WriteOverlaps(results + i, no_mask, partial_mask, 8);
+		}
+		return n;
+	}
+#endif
+}
+
+namespace KlayGE
+{
+	namespace SIMDMathLib
+	{
+		bool IsBatchTargetSupported(BatchTarget target)
+		{
+			switch (target)
+			{
+			case BT_Scalar:
+				return true;
+
+#ifdef SIMD_MATH_SSE
+			case BT_SSE:
+				return true;
+#endif
+
+#ifdef SIMD_BATCH_AVX2
+			case BT_AVX2:
+				{
+					static bool const supported = []
+						{
+							CPUInfo const cpu;
+							return cpu.IsFeatureSupport(CPUInfo::CF_AVX2) && cpu.IsFeatureSupport(CPUInfo::CF_FMA3);
+						}();
+					return supported;
+				}
+#endif
+
+			default:
+				return false;
+			}
+		}
+
+		BatchTarget ActiveBatchTarget()
+		{
+			return static_cast<BatchTarget>(ActiveBatchTargetStorage().load(std::memory_order_relaxed));
+		}
+
+		void ActiveBatchTarget(BatchTarget target)
+		{
+			BOOST_ASSERT(IsBatchTargetSupported(target));
+			ActiveBatchTargetStorage() = target;
+		}
+
+		void TransformCoords(float3* out, float3 const * in, uint32_t num, float4x4 const & mat)
+		{
+			BatchTarget const target = ActiveBatchTarget();
+			KFL_UNUSED(target);
+
+			uint32_t i = 0;
+#ifdef SIMD_BATCH_AVX2
+			if (target >= BT_AVX2)
+			{
+				i += TransformCoordsAVX2(out + i, in + i, num - i, mat);
+			}
+#endif
+#ifdef SIMD_MATH_SSE
+			if (target >= BT_SSE)
+			{
+				i += TransformCoordsSSE(out + i, in + i, num - i, mat);
+			}
+#endif
+			for (; i < num; ++ i)
+			{
+				out[i] = MathLib::transform_coord(in[i], mat);
+			}
+		}
+
+		void TransformAABBs(AABBox* out, AABBox const * in, uint32_t num, float4x4 const & mat)
+		{
+			BatchTarget const target = ActiveBatchTarget();
+			KFL_UNUSED(target);
+
+			uint32_t i = 0;
+#ifdef SIMD_BATCH_AVX2
+			if (target >= BT_AVX2)
+			{
+				i += TransformAABBsAVX2(out + i, in + i, num - i, mat);
+			}
+#endif
+#ifdef SIMD_MATH_SSE
+			if (target >= BT_SSE)
+			{
+				i += TransformAABBsSSE(out + i, in + i, num - i, mat);
+			}
+#endif
+			for (; i < num; ++ i)
+			{
+				TransformAABBScalar(&out[i].Min().x(), &in[i].Min().x(), mat);
+			}
+		}
+
+		void MultiplyQuats(Quaternion* out, Quaternion const * lhs, Quaternion const * rhs, uint32_t num)
+		{
+			BatchTarget const target = ActiveBatchTarget();
+			KFL_UNUSED(target);
+
+			uint32_t i = 0;
+#ifdef SIMD_BATCH_AVX2
+			if (target >= BT_AVX2)
+			{
+				i += MultiplyQuatsAVX2(out + i, lhs + i, rhs + i, num - i);
+			}
+#endif
+#ifdef SIMD_MATH_SSE
+			if (target >= BT_SSE)
+			{
+				i += MultiplyQuatsSSE(out + i, lhs + i, rhs + i, num - i);
+			}
+#endif
+			for (; i < num; ++ i)
+			{
+				out[i] = MathLib::mul(lhs[i], rhs[i]);
+			}
+		}
+
+		void SlerpQuats(Quaternion* out, Quaternion const * lhs, Quaternion const * rhs, float const * s, uint32_t num)
+		{
+			BatchTarget const target = ActiveBatchTarget();
+			KFL_UNUSED(target);
+
+			uint32_t i = 0;
+#ifdef SIMD_BATCH_AVX2
+			if (target >= BT_AVX2)
+			{
+				i += SlerpQuatsAVX2(out + i, lhs + i, rhs + i, s + i, num - i);
+			}
+#endif
+#ifdef SIMD_MATH_SSE
+			if (target >= BT_SSE)
+			{
+				i += SlerpQuatsSSE(out + i, lhs + i, rhs + i, s + i, num - i);
+			}
+#endif
+			for (; i < num; ++ i)
+			{
+				out[i] = MathLib::slerp(lhs[i], rhs[i], s[i]);
+			}
+		}
+
+		void IntersectAABBFrustum(BoundOverlap* results,
+			float const * min_x, float const * min_y, float const * min_z,
+			float const * max_x, float const * max_y, float const * max_z,
+			uint32_t num, Frustum const & frustum)
+		{
+			// For a plane, v0 and v1 pick from the same arrays for all boxes. So the selection is done once per plane,
+			//  and all lanes share each plane equation.
+			FrustumCorners corners;
+			for (int p = 0; p < 6; ++ p)
+			{
+				Plane const & plane = frustum.FrustumPlane(p);
+				corners.v0[p][0] = (plane.a() < 0) ? min_x : max_x;
+				corners.v0[p][1] = (plane.b() < 0) ? min_y : max_y;
+				corners.v0[p][2] = (plane.c() < 0) ? min_z : max_z;
+				corners.v1[p][0] = (plane.a() < 0) ? max_x : min_x;
+				corners.v1[p][1] = (plane.b() < 0) ? max_y : min_y;
+				corners.v1[p][2] = (plane.c() < 0) ? max_z : min_z;
+				corners.plane[p][0] = plane.a();
+				corners.plane[p][1] = plane.b();
+				corners.plane[p][2] = plane.c();
+				corners.plane[p][3] = plane.d();
+			}
+
+			BatchTarget const target = ActiveBatchTarget();
+			KFL_UNUSED(target);
+
+			uint32_t i = 0;
+#ifdef SIMD_BATCH_AVX2
+			if (target >= BT_AVX2)
+			{
+				i = IntersectAABBFrustumAVX2(results, corners, num);
+			}
+#endif
+#ifdef SIMD_MATH_SSE
+			if (target >= BT_SSE)
+			{
+				i = IntersectAABBFrustumSSE(results, corners, i, num);
+			}
+#endif
+			for (; i < num; ++ i)
+			{
+				results[i] = MathLib::intersect_aabb_frustum(AABBox(float3(min_x[i], min_y[i], min_z[i]),
+					float3(max_x[i], max_y[i], max_z[i])), frustum);
+			}
+		}
+	}
+}
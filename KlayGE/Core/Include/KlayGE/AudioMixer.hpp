@@ -0,0 +1,189 @@
+/**
+ * @file AudioMixer.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#ifndef _KLAYGE_AUDIO_MIXER_HPP
+#define _KLAYGE_AUDIO_MIXER_HPP
+
+#pragma once
+
+#include <KlayGE/PreDeclare.hpp>
+#include <KFL/Vector.hpp>
+#include <KFL/Thread.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <KlayGE/AudioDataSource.hpp>
+
+namespace KlayGE
+{
+	// Where the mixed audio goes. Always stereo float.
+	class KLAYGE_CORE_API AudioSink : boost::noncopyable
+	{
+	public:
+		explicit AudioSink(uint32_t sample_rate);
+		virtual ~AudioSink();
+
+		uint32_t SampleRate() const
+		{
+			return sample_rate_;
+		}
+
+		// Interleaved left and right samples, in [-1, 1]
+		virtual void Write(float const * samples, uint32_t num_frames) = 0;
+
+	protected:
+		uint32_t sample_rate_;
+	};
+
+	class KLAYGE_CORE_API NullAudioSink : public AudioSink
+	{
+	public:
+		explicit NullAudioSink(uint32_t sample_rate);
+
+		void Write(float const * samples, uint32_t num_frames) override;
+
+		uint64_t NumFrames() const
+		{
+			return num_frames_;
+		}
+
+	private:
+		std::atomic<uint64_t> num_frames_;
+	};
+
+	// 16-bit PCM. The sizes in the header are filled in when it's destroyed.
+	class KLAYGE_CORE_API WavFileAudioSink : public AudioSink
+	{
+	public:
+		WavFileAudioSink(std::string const & path, uint32_t sample_rate);
+		~WavFileAudioSink() override;
+
+		void Write(float const * samples, uint32_t num_frames) override;
+
+	private:
+		std::ofstream file_;
+		uint32_t data_size_;
+		std::vector<int16_t> pcm_;
+	};
+
+	// A software mixer with one thread that both decodes and mixes. Sounds are decoded whole, a chunk at a time.
+	//  Music is decoded a few seconds ahead. Both are served from a priority queue ordered by how soon a voice
+	//  runs out of data. Voices are positioned in 3D with distance attenuation and equal-power panning, and are
+	//  resampled linearly to the rate of the sink, 4 frames at a time with SSE2.
+	class KLAYGE_CORE_API AudioMixer : boost::noncopyable
+	{
+	public:
+		static uint32_t const BLOCK_FRAMES = 256;
+		// Blocks the thread mixes ahead of the wall clock
+		static uint32_t const LATENCY_BLOCKS = 4;
+		// Source frames decoded per block at most, over all voices
+		static uint32_t const DECODE_FRAMES_PER_BLOCK = 16384;
+
+		explicit AudioMixer(AudioSinkPtr const & sink);
+		~AudioMixer();
+
+		void Sink(AudioSinkPtr const & sink);
+		AudioSinkPtr Sink() const;
+
+		// Mixes in real time on a thread of the pool. Without it, call Mix.
+		void StartThread();
+		void StopThread();
+
+		// Streamed voices keep buffer_seconds of data decoded. The others share the decoded data with their clones.
+		uint32_t CreateVoice(AudioDataSourcePtr const & source, bool streamed, uint32_t buffer_seconds = 2);
+		uint32_t CloneVoice(uint32_t voice);
+		void DestroyVoice(uint32_t voice);
+
+		void Play(uint32_t voice, bool loop);
+		// Rewinds too. The data source isn't read any more when it returns.
+		void Stop(uint32_t voice);
+		bool IsPlaying(uint32_t voice) const;
+		void Volume(uint32_t voice, float vol);
+		void Position(uint32_t voice, float3 const & pos);
+
+		void ListenerPos(float3 const & pos);
+		void ListenerOri(float3 const & face, float3 const & up);
+
+		// Decodes what's most urgent, mixes a block and writes it to the sink
+		void Mix();
+
+		uint64_t MixedFrames() const
+		{
+			return mixed_frames_;
+		}
+		uint32_t NumPlayingVoices() const;
+
+	private:
+		struct Clip;
+		struct Voice;
+
+		void ServiceStreams();
+		bool MixVoice(Voice& voice, float3 const & listener_pos, float3 const & listener_right, uint32_t sample_rate);
+		void ThreadFunc();
+
+	private:
+		AudioSinkPtr sink_;
+
+		// Guards voices_, the parameters of the voices and the listener
+		mutable std::mutex mutex_;
+		// Held while a data source is read
+		std::mutex source_mutex_;
+
+		std::vector<std::unique_ptr<Voice>> voices_;
+		std::vector<uint32_t> free_voices_;
+		// Clips not fully decoded yet
+		std::vector<std::shared_ptr<Clip>> pending_clips_;
+
+		float3 listener_pos_;
+		float3 listener_face_;
+		float3 listener_up_;
+
+		// Only touched by Mix
+		std::vector<Voice*> active_voices_;
+		std::vector<std::shared_ptr<Clip>> decoding_clips_;
+		std::vector<float> mix_buf_;
+		std::vector<uint8_t> decode_buf_;
+		std::atomic<uint64_t> mixed_frames_;
+
+		joiner<void> thread_;
+		bool thread_running_;
+		bool thread_quit_;
+		std::mutex thread_mutex_;
+		std::condition_variable thread_cv_;
+	};
+}
+
+#endif		// _KLAYGE_AUDIO_MIXER_HPP
@@ -157,6 +157,10 @@ namespace KlayGE
 		{
 			return *gtp_instance_;
 		}
+		task_scheduler& TaskScheduler()
+		{
+			return *task_scheduler_instance_;
+		}
 
 	private:
 		void DestroyAll();
@@ -191,6 +195,7 @@ namespace KlayGE
 		DllLoader ads_loader_;
 
 		std::unique_ptr<thread_pool> gtp_instance_;
+		std::unique_ptr<task_scheduler> task_scheduler_instance_;
 	};
 }
 
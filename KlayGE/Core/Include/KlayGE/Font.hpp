@@ -49,6 +49,51 @@ namespace KlayGE
 {
 	class FontRenderable;
 
+	// The cells of a glyph atlas, kept in LRU order. Once they're all taken, a new glyph takes the cell of the least
+	//  recently used one, and the glyph dropped from it has to be rasterized again when it's used next.
+	class KLAYGE_CORE_API GlyphAtlas
+	{
+	public:
+		explicit GlyphAtlas(uint32_t num_cells);
+
+		uint32_t NumCells() const
+		{
+			return static_cast<uint32_t>(cells_.size() - 1);
+		}
+		uint32_t NumGlyphs() const
+		{
+			return this->NumCells() - static_cast<uint32_t>(free_cells_.size());
+		}
+		wchar_t Glyph(uint32_t cell) const
+		{
+			BOOST_ASSERT(cell < this->NumCells());
+			return cells_[cell].ch;
+		}
+
+		// Makes the glyph in the cell the most recently used one
+		void Touch(uint32_t cell);
+		// Returns the cell of a new glyph, which becomes the most recently used one. When the atlas is full, evicted is
+		//  set and evicted_ch is the glyph dropped for it.
+		uint32_t Add(wchar_t ch, bool& evicted, wchar_t& evicted_ch);
+
+	private:
+		void LinkCell(uint32_t cell);
+		void UnlinkCell(uint32_t cell);
+
+	private:
+		struct CellInfo
+		{
+			wchar_t ch;
+			uint32_t prev;
+			uint32_t next;
+		};
+
+		// One per cell, plus a sentinel at the end. The most recently used cell goes before the sentinel, the least
+		//  recently used one is after it.
+		std::vector<CellInfo> cells_;
+		std::vector<uint32_t> free_cells_;
+	};
+
 	// 3Dл
 	/////////////////////////////////////////////////////////////////////////////////
 	class KLAYGE_CORE_API Font : boost::noncopyable
@@ -22,9 +22,12 @@
 
 #include <vector>
 #include <deque>
+#include <list>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 
-#include <KlayGE/LZMACodec.hpp>
+#include <KFL/Thread.hpp>
 
 namespace KlayGE
 {
@@ -62,6 +65,9 @@ namespace KlayGE
 
 		static uint32_t const LEVEL_SHIFT = 28;
 
+		static uint32_t const MAX_DECODED_BLOCKS = 64;
+		static uint32_t const MAX_IN_FLIGHT_TILES = 64;
+
 	public:
 		JudaTexture(uint32_t num_tiles, uint32_t tile_size, ElementFormat format);
 
@@ -88,12 +94,37 @@ namespace KlayGE
 
 		void SetParams(RenderEffect const & effect);
 
+		// Missing tiles are decoded on the task scheduler and show up in later frames. Until then the nearest
+		//  resident parent tile is used.
 		void UpdateCache(std::vector<uint32_t> const & tile_ids);
 
+		// Max number of decoded tiles uploaded to the cache in one UpdateCache
+		void UploadBudget(uint32_t budget);
+		uint32_t UploadBudget() const;
+
+		uint32_t NumResidentTiles() const;
+		// Tiles being decoded, or waiting to be uploaded
+		uint32_t NumInFlightTiles() const;
+		// Returns the tile in the cache standing in for tile_id, levels_up levels above it, or 0xFFFFFFFF if there is none
+		uint32_t FindResidentTile(uint32_t& levels_up, uint32_t tile_id) const;
+
 	private:
+		struct StreamedTile
+		{
+			uint32_t tile_id;
+			uint32_t attr;
+			std::vector<std::vector<uint8_t>> mip_data;
+			std::vector<uint32_t> mip_row_pitches;
+		};
+
 		void DecodeATile(std::vector<uint8_t>* data, uint32_t shuff, uint32_t mipmaps);
 		uint32_t DecodeAAttr(uint32_t shuff);
-		uint8_t* RetriveATile(uint32_t data_index);
+		std::shared_ptr<std::vector<uint8_t>> RetriveATile(uint32_t data_index);
+
+		void BuildCacheTile(StreamedTile& tile);
+		void RequestTile(uint32_t tile_id);
+		void TouchTile(uint32_t tile_id);
+		void UploadTile(StreamedTile const & tile);
 
 		uint32_t NumNonEmptySubNodes(quadtree_node_ptr const & node) const;
 		quadtree_node_ptr const & GetNode(uint32_t shuff);
@@ -169,19 +200,19 @@ namespace KlayGE
 		// Input only
 		ResIdentifierPtr input_file_;
 		uint32_t data_blocks_offset_;
-		LZMACodec lzma_dec_;
 		struct DecodedBlockInfo
 		{
 			std::shared_ptr<std::vector<uint8_t>> data;
-			uint64_t tick;
+			std::list<uint32_t>::iterator lru_iter;
 
-			DecodedBlockInfo(std::shared_ptr<std::vector<uint8_t>> const & d, uint64_t t)
-				: data(d), tick(t)
+			DecodedBlockInfo(std::shared_ptr<std::vector<uint8_t>> const & d, std::list<uint32_t>::iterator iter)
+				: data(d), lru_iter(iter)
 			{
 			}
 		};
 		std::unordered_map<uint32_t, DecodedBlockInfo> decoded_block_cache_;
-		uint64_t decode_tick_;
+		std::list<uint32_t> decoded_block_lru_;
+		std::mutex decoded_block_mutex_;
 
 	private:
 		// Cache
@@ -197,10 +228,22 @@ namespace KlayGE
 			uint32_t x, y, z;
 			uint32_t attr;
 			uint64_t tick;
+			std::list<uint32_t>::iterator lru_iter;
 		};
 		std::unordered_map<uint32_t, TileInfo> tile_info_map_;
-		std::deque<std::pair<uint32_t, uint32_t>> tile_free_list_;
+		std::list<uint32_t> tile_lru_;
+		std::vector<uint32_t> tile_free_slots_;
 		uint64_t tile_tick_;
+
+		// Indirect texels written so far, to skip redundant uploads
+		std::unordered_map<uint32_t, uint32_t> tile_indirect_map_;
+
+		uint32_t upload_budget_;
+		std::unordered_set<uint32_t> in_flight_tiles_;
+		std::deque<std::unique_ptr<StreamedTile>> streamed_tiles_;
+		std::mutex streamed_tiles_mutex_;
+		// Declared last, so it's destroyed first, after waiting for the decoding tasks.
+		std::unique_ptr<task_group> stream_tasks_;
 	};
 }
 
@@ -18,8 +18,12 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
-#include <list>
+
 #include <KlayGE/Socket.hpp>
 
 #ifndef KLAYGE_PLATFORM_WINDOWS_STORE
@@ -41,70 +45,141 @@ namespace KlayGE
 		virtual void OnQuit(uint32_t /*ID*/) const
 		{
 		}
-		virtual void OnDefault(void* /*revBuf*/, int /*maxSize*/,
+		// revBuf holds size bytes, the message type first. The reply goes to sendBuf after its type byte.
+		virtual void OnDefault(void* /*revBuf*/, int /*size*/,
 			void* /*sendBuf*/, int& /*numSend*/, sockaddr_in& /*from*/) const
 		{
 		}
 	};
 
-	// Player
 	struct PlayerDes
 	{
+		// The index + 1 in the low PLAYER_INDEX_BITS and the generation above, so the ids of a reused slot differ.
+		//  0 when the slot is free.
+		uint32_t		id;
+		// Tells the timer wheel entries of a reused slot apart
+		uint32_t		generation;
+
 		std::string		name;
 		sockaddr_in		addr;
 
-		uint32_t		time;
-
-		std::list<std::vector<char>> msgs;
+		// The tick anything was last received from the player
+		uint64_t		last_active;
 	};
 
+	// A UDP lobby served by one thread. It waits on the socket with epoll on Linux and select elsewhere, and reads and
+	//  writes datagrams in batches, with recvmmsg/sendmmsg where they're available.
 	class KLAYGE_CORE_API Lobby : boost::noncopyable
 	{
-		typedef std::vector<std::pair<uint32_t, PlayerDes>>	PlayerAddrs;
-		typedef PlayerAddrs::iterator		PlayerAddrsIter;
-
 	public:
+		// Datagrams read or written by one system call
+		static uint32_t const BATCH_SIZE = 64;
+		// Resolution of the player timeouts
+		static uint32_t const TICK_MS = 100;
+		static uint32_t const NUM_WHEEL_SLOTS = 256;
+		// Bits of a player id holding the slot, see PlayerDes::id
+		static uint32_t const PLAYER_INDEX_BITS = 20;
+
 		Lobby();
 		~Lobby();
 
-		void Create(std::string const & Name, char maxPlayers, uint16_t port, Processor const & pro);
+		// Binds the socket. Port 0 picks a free one, see SockAddr.
+		void Create(std::string const & name, uint32_t maxPlayers, uint16_t port);
+		// Serves the lobby on the calling thread until Close
+		void Run(Processor const & pro);
+		void Create(std::string const & name, uint32_t maxPlayers, uint16_t port, Processor const & pro);
+		// Can be called from any thread
 		void Close();
 
-		void LobbyName(std::string const & Name);
+		void LobbyName(std::string const & name);
 		std::string const & LobbyName() const;
 
-		char NumPlayer() const;
+		uint32_t NumPlayer() const;
 
-		void MaxPlayers(char maxPlayers);
-		char MaxPlayers() const;
+		void MaxPlayers(uint32_t maxPlayers);
+		uint32_t MaxPlayers() const;
 
-		int Receive(void* buf, int maxSize, sockaddr_in& from);
-		int Send(void const * buf, int maxSize, sockaddr_in const & to);
+		// The largest datagram received or sent, up to 65507 bytes
+		void MaxDatagramSize(uint32_t size);
+		uint32_t MaxDatagramSize() const;
 
-		void TimeOut(uint32_t timeOut)
-			{ this->socket_.TimeOut(timeOut); }
-		uint32_t TimeOut()
-			{ return this->socket_.TimeOut(); }
+		// Players not heard from for this long are dropped
+		void PlayerTimeOut(uint32_t ms);
+		uint32_t PlayerTimeOut() const;
+
+		// Queued from any thread, and sent with the next batch
+		void Send(void const * buf, int size, sockaddr_in const & to);
+		// Dropped if the player has left, even when the slot is taken again
+		void SendToPlayer(uint32_t id, void const * buf, int size);
 
 		sockaddr_in const & SockAddr() const
 			{ return this->sockAddr_; }
 
 	private:
-		void OnJoin(char* revbuf, char* sendbuf, int& sendnum, sockaddr_in& From, Processor const & pro);
-		void OnQuit(PlayerAddrsIter iter, char* sendbuf, int& sendnum, Processor const & pro);
-
-		void OnGetLobbyInfo(char* sendbuf, int& sendnum, Processor const & pro);
-		void OnNop(PlayerAddrsIter iter);
+		// A datagram waiting to be sent. When player_id isn't 0, it goes to that player instead of addr.
+		struct OutMsg
+		{
+			sockaddr_in	addr;
+			uint32_t	player_id;
+			uint32_t	offset;
+			uint32_t	size;
+		};
 
-		PlayerAddrsIter ID(sockaddr_in const & Addr);
+	private:
+		void OnReceive(char* revBuf, int size, sockaddr_in const & from, char* sendBuf, Processor const & pro);
+
+		void OnJoin(char* revBuf, int size, char* sendBuf, int& numSend, sockaddr_in const & from, Processor const & pro);
+		void OnQuit(uint32_t index, char* sendBuf, int& numSend, Processor const & pro);
+		void OnGetLobbyInfo(char* sendBuf, int& numSend);
+
+		// Index into players_, or -1
+		uint32_t ID(sockaddr_in const & addr) const;
+		// Index into players_ of the player with the id, or -1 if the player has left
+		uint32_t PlayerIndex(uint32_t id) const;
+		void RemovePlayer(uint32_t index, Processor const & pro);
+		void ScheduleTimeOut(uint32_t index);
+		void Tick(uint64_t tick, Processor const & pro);
+
+		void QueueSend(void const * buf, int size, sockaddr_in const & to);
+		void QueuePending(void const * buf, int size, sockaddr_in const & to, uint32_t player_id);
+		// Returns false when the socket is full, and the rest have to wait
+		bool FlushSends();
+		// Gets Run out of its wait with an empty datagram to itself
+		void Wake();
 
 	private:
 		Socket			socket_;
-		PlayerAddrs		players_;
-
 		sockaddr_in		sockAddr_;
 
 		std::string		name_;
+
+		std::vector<PlayerDes>	players_;
+		std::vector<uint32_t>	free_players_;
+		std::atomic<uint32_t>	num_players_;
+		// From the IP and port to the index in players_
+		std::unordered_map<uint64_t, uint32_t>	player_indices_;
+
+		uint32_t		max_datagram_size_;
+		uint32_t		player_time_out_;
+
+		// Every slot holds (index, generation) of the players that may expire on the ticks falling in it. Activity
+		//  only updates last_active, and an expired entry is put back if the player was heard from since.
+		std::vector<std::vector<std::pair<uint32_t, uint32_t>>> timer_wheel_;
+		uint64_t		curr_tick_;
+
+		std::vector<char>		send_data_;
+		std::vector<OutMsg>		send_msgs_;
+		size_t					num_sent_msgs_;
+
+		// Queued by Send and SendToPlayer, moved to send_msgs_ by Run
+		std::mutex				pending_mutex_;
+		std::vector<char>		pending_data_;
+		std::vector<OutMsg>		pending_msgs_;
+
+		std::atomic<bool>	quit_;
+#if defined KLAYGE_PLATFORM_LINUX
+		int		epoll_fd_;
+#endif
 	};
 }
 
@@ -32,7 +32,9 @@
 #include <KlayGE/RenderLayout.hpp>
 #include <KFL/Math.hpp>
 #include <KlayGE/SceneObject.hpp>
+#include <KFL/ArrayRef.hpp>
 
+#include <array>
 #include <vector>
 #include <string>
 
@@ -268,6 +270,19 @@ namespace KlayGE
 	};
 	typedef std::vector<KeyFrames> KeyFramesType;
 
+	// Key frames of all joints of a skeleton, with one array per component, so several joints can be evaluated at once.
+	struct KLAYGE_CORE_API KeyFrameTracks
+	{
+		explicit KeyFrameTracks(KeyFramesType const & kfs);
+
+		// Keys of joint i are in [key_starts[i], key_starts[i + 1])
+		std::vector<uint32_t> key_starts;
+		std::vector<uint32_t> frame_ids;
+		std::array<std::vector<float>, 4> bind_reals;
+		std::array<std::vector<float>, 4> bind_duals;
+		std::vector<float> bind_scales;
+	};
+
 	struct KLAYGE_CORE_API AABBKeyFrames
 	{
 		std::vector<uint32_t> frame_id;
@@ -329,14 +344,16 @@ namespace KlayGE
 		{
 			return bind_duals_;
 		}
-		void AttachKeyFrames(std::shared_ptr<KeyFramesType> const & kf)
-		{
-			key_frames_ = kf;
-		}
+		void AttachKeyFrames(std::shared_ptr<KeyFramesType> const & kf);
+		void AttachKeyFrames(std::shared_ptr<KeyFramesType> const & kf, std::shared_ptr<KeyFrameTracks> const & tracks);
 		std::shared_ptr<KeyFramesType> const & GetKeyFrames() const
 		{
 			return key_frames_;
 		}
+		std::shared_ptr<KeyFrameTracks> const & GetKeyFrameTracks() const
+		{
+			return key_frame_tracks_;
+		}
 		uint32_t NumFrames() const
 		{
 			return num_frames_;
@@ -357,6 +374,9 @@ namespace KlayGE
 		float GetFrame() const;
 		void SetFrame(float frame);
 
+		// Same as calling SetFrame on each model, but the models are spread over the task scheduler.
+		static void SetFrames(ArrayRef<SkinnedModel*> models, ArrayRef<float> frames);
+
 		void RebindJoints();
 		void UnbindJoints();
 
@@ -374,14 +394,28 @@ namespace KlayGE
 		void BuildBones(float frame);
 		void UpdateBinds();
 
+	private:
+		void InterpolateKeyFrames(float frame);
+		void UpdateBind(uint32_t index);
+
 	protected:
 		JointsType joints_;
 		RotationsType bind_reals_;
 		RotationsType bind_duals_;
 
 		std::shared_ptr<KeyFramesType> key_frames_;
+		std::shared_ptr<KeyFrameTracks> key_frame_tracks_;
 		float last_frame_;
 
+		// Per joint, the key before the current frame, relative to the joint's track. Frames usually move forward a
+		//  little at a time, so the search starts from here.
+		std::vector<uint32_t> key_cursors_;
+		std::vector<float> key_factors_;
+		// Interpolated local transforms of the joints
+		std::vector<Quaternion> local_reals_;
+		std::vector<Quaternion> local_duals_;
+		std::vector<float> local_scales_;
+
 		uint32_t num_frames_;
 		uint32_t frame_rate_;
 
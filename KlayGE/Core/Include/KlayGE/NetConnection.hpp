@@ -0,0 +1,226 @@
+/**
+* @file NetConnection.hpp
+* @author Minmin Gong
+*
+* @section DESCRIPTION
+*
+* This source file is part of KlayGE
+* For the latest info, see http://www.klayge.org
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* You may alternatively use this source under the terms of
+* the KlayGE Proprietary License (KPL). You can obtained such a license
+* from http://www.klayge.org/licensing/.
+*/
+
+#ifndef _KLAYGE_NETCONNECTION_HPP
+#define _KLAYGE_NETCONNECTION_HPP
+
+#pragma once
+
+#include <KlayGE/PreDeclare.hpp>
+#include <KlayGE/Socket.hpp>
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <vector>
+
+#ifndef KLAYGE_PLATFORM_WINDOWS_STORE
+
+namespace KlayGE
+{
+	// A message layer over datagrams, one per remote peer. Every packet carries a sequence number and acks the last
+	//  33 packets from the other side. Messages go through channels:
+	//   reliable-ordered ones are resent until acked and delivered in order,
+	//   unreliable-sequenced ones are sent once and dropped when older than the last delivered one.
+	//  Messages larger than a packet are fragmented. Snapshots of the game state are delta-compressed against the
+	//  last one the peer acked.
+	class KLAYGE_CORE_API NetConnection : boost::noncopyable
+	{
+	public:
+		enum ChannelType
+		{
+			CT_ReliableOrdered,
+			CT_UnreliableSequenced
+		};
+
+		// Fits in a UDP datagram on almost any path
+		static uint32_t const DEFAULT_MTU = 1200;
+		static uint32_t const MAX_CHANNELS = 127;
+		static uint32_t const MAX_FRAGMENTS = 256;
+		// Packets remembered for acks, and reliable messages in flight
+		static uint32_t const PACKET_WINDOW = 1024;
+		// Snapshots kept as baselines
+		static uint32_t const SNAPSHOT_HISTORY = 32;
+
+		typedef std::function<void(void const * packet, uint32_t size)> PacketSender;
+
+		explicit NetConnection(PacketSender const & sender);
+		// Sends with SendTo. The socket can be shared by many connections.
+		NetConnection(Socket& socket, sockaddr_in const & remote);
+
+		// Both sides have to use the same MTU. Fragments larger than it are dropped.
+		void MTU(uint32_t mtu);
+		uint32_t MTU() const
+		{
+			return mtu_;
+		}
+
+		// Returns the index of the new channel. Both sides have to add the same channels.
+		uint32_t AddChannel(ChannelType type);
+
+		void Send(uint32_t channel, void const * data, uint32_t size);
+		// Pops the next delivered message
+		bool Receive(uint32_t& channel, std::vector<uint8_t>& msg);
+
+		void SendSnapshot(void const * state, uint32_t size);
+		// Gets the newest snapshot, if one arrived since the last call
+		bool ReceiveSnapshot(std::vector<uint8_t>& state);
+
+		// Feeds a packet from the peer. time is in seconds, on the same clock as Update.
+		void OnPacket(void const * packet, uint32_t size, double time);
+		// Sends the queued messages, the due resends and the acks
+		void Update(double time);
+
+		float RTT() const
+		{
+			return rtt_;
+		}
+		uint64_t BytesSent() const
+		{
+			return bytes_sent_;
+		}
+		uint64_t PacketsSent() const
+		{
+			return packets_sent_;
+		}
+
+	private:
+		struct OutMessage
+		{
+			uint16_t id;
+			std::vector<uint8_t> data;
+			uint32_t num_frags;
+			// Negative when not sent yet
+			std::vector<double> frag_sent_times;
+			std::vector<bool> frag_acked;
+			uint32_t num_acked;
+		};
+
+		struct InMessage
+		{
+			std::vector<uint8_t> data;
+			uint32_t num_frags;
+			std::vector<bool> frag_received;
+			uint32_t num_received;
+		};
+
+		struct Channel
+		{
+			ChannelType type;
+
+			uint16_t next_send_id;
+			std::deque<OutMessage> send_queue;
+
+			// Reliable: the next id to deliver. Unreliable: the last delivered one.
+			uint16_t recv_id;
+			bool received_any;
+			std::map<uint16_t, InMessage> recv_messages;
+		};
+
+		struct FragRef
+		{
+			uint8_t channel;
+			uint16_t msg_id;
+			uint8_t frag_index;
+		};
+
+		struct SentPacket
+		{
+			uint16_t seq;
+			bool valid;
+			bool acked;
+			double time;
+			std::vector<FragRef> frags;
+		};
+
+		struct SnapshotRecord
+		{
+			uint16_t id;
+			bool valid;
+			std::vector<uint8_t> state;
+			uint32_t num_frags;
+			std::vector<bool> frag_acked;
+			uint32_t num_acked;
+		};
+
+	private:
+		static void ResetChannel(Channel& channel, ChannelType type);
+		Channel& ChannelAt(uint8_t index);
+		uint32_t NumFragments(uint32_t size) const;
+		uint32_t FragmentStride(uint32_t size, uint32_t num_frags) const;
+		void QueueMessage(Channel& channel, uint16_t id, void const * data, uint32_t size);
+
+		void OnFragment(uint8_t channel_index, uint16_t msg_id, uint32_t frag_index, uint32_t num_frags,
+			uint32_t total_size, uint8_t const * data, uint32_t size);
+		void OnMessage(uint8_t channel_index, uint16_t msg_id, std::vector<uint8_t>& msg);
+		void OnSnapshot(uint16_t id, std::vector<uint8_t> const & msg);
+		void OnPacketAcked(SentPacket& packet);
+
+		void FlushPacket(double time);
+
+	private:
+		PacketSender sender_;
+		uint32_t mtu_;
+
+		std::vector<Channel> channels_;
+		Channel snapshot_channel_;
+
+		std::deque<std::pair<uint32_t, std::vector<uint8_t>>> received_;
+
+		uint16_t local_seq_;
+		std::vector<SentPacket> sent_packets_;
+
+		uint16_t remote_seq_;
+		uint32_t remote_ack_bits_;
+		bool received_any_packet_;
+		bool ack_pending_;
+
+		std::vector<SnapshotRecord> sent_snapshots_;
+		uint16_t baseline_id_;
+		bool has_baseline_;
+
+		std::vector<SnapshotRecord> received_snapshots_;
+		uint16_t newest_snapshot_id_;
+		bool has_new_snapshot_;
+		bool received_any_snapshot_;
+
+		// The packet being built
+		std::vector<uint8_t> packet_;
+		std::vector<FragRef> packet_frags_;
+
+		float rtt_;
+		uint64_t bytes_sent_;
+		uint64_t packets_sent_;
+	};
+}
+
+#endif
+
+#endif		// _KLAYGE_NETCONNECTION_HPP
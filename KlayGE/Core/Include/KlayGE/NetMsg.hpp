@@ -26,6 +26,9 @@ namespace KlayGE
 		MSG_GETLOBBYINFO,
 
 		MSG_NOP,
+
+		// This and the following types go to Processor::OnDefault
+		MSG_USER
 	};
 }
 
@@ -0,0 +1,99 @@
+/**
+ * @file Package.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#ifndef _KLAYGE_PACKAGE_HPP
+#define _KLAYGE_PACKAGE_HPP
+
+#pragma once
+
+#include <KlayGE/PreDeclare.hpp>
+#include <KFL/CXX17/string_view.hpp>
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+namespace KlayGE
+{
+	// An uncompressed package with a table of contents. The file is mapped into memory once, and members are opened as
+	//  views on the mapping, without decompressing or copying. Member paths are case insensitive, as in 7z packages.
+	class KLAYGE_CORE_API Package : boost::noncopyable, public std::enable_shared_from_this<Package>
+	{
+	public:
+		explicit Package(std::string const & path);
+		~Package();
+
+		static void Write(std::ostream& os, std::vector<std::pair<std::string, ResIdentifierPtr>> const & members);
+
+		// False if the file is not a package, for example a 7z one
+		bool Valid() const
+		{
+			return data_ != nullptr;
+		}
+
+		uint64_t Timestamp() const
+		{
+			return timestamp_;
+		}
+
+		uint32_t NumMembers() const
+		{
+			return static_cast<uint32_t>(toc_.size());
+		}
+
+		bool HasMember(std::string_view name) const;
+		ResIdentifierPtr OpenMember(std::string_view name, std::string_view res_name);
+
+	private:
+		bool ParseToc();
+		void Unmap();
+
+	private:
+		struct Member
+		{
+			uint64_t offset;
+			uint64_t size;
+		};
+
+		uint8_t const * data_;
+		uint64_t size_;
+		uint64_t timestamp_;
+		bool mapped_;
+		std::vector<uint8_t> content_;
+
+		std::unordered_map<std::string, Member> toc_;
+	};
+}
+
+#endif		// _KLAYGE_PACKAGE_HPP
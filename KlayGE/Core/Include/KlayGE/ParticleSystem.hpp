@@ -55,6 +55,37 @@ namespace KlayGE
 		float init_life;
 	};
 
+	// Particles with one array per component, so updaters can go through 4 of them at a time.
+	//  The live ones are packed in [0, num).
+	struct KLAYGE_CORE_API ParticleSoA
+	{
+		explicit ParticleSoA(uint32_t capacity);
+
+		uint32_t Capacity() const
+		{
+			return static_cast<uint32_t>(life.size());
+		}
+
+		Particle Get(uint32_t index) const;
+		void Set(uint32_t index, Particle const & par);
+		// Drops the particles whose life ran out. The last live ones move into the holes.
+		void RemoveDead();
+
+		uint32_t num;
+
+		std::vector<float> pos_x;
+		std::vector<float> pos_y;
+		std::vector<float> pos_z;
+		std::vector<float> vel_x;
+		std::vector<float> vel_y;
+		std::vector<float> vel_z;
+		std::vector<float> life;
+		std::vector<float> spin;
+		std::vector<float> size;
+		std::vector<float> alpha;
+		std::vector<float> init_life;
+	};
+
 	class KLAYGE_CORE_API ParticleEmitter
 	{
 	public:
@@ -216,6 +247,8 @@ namespace KlayGE
 		virtual ParticleUpdaterPtr Clone() = 0;
 
 		virtual void Update(Particle& par, float elapse_time) = 0;
+		// Updates particles [first, last). The default one calls Update on them one by one.
+		virtual void UpdateBatch(ParticleSoA& particles, uint32_t first, uint32_t last, float elapse_time);
 
 	protected:
 		void DoClone(ParticleUpdaterPtr const & rhs);
@@ -288,29 +321,38 @@ namespace KlayGE
 		virtual void SubThreadUpdate(float app_time, float elapsed_time) override;
 		virtual bool MainThreadUpdate(float app_time, float elapsed_time) override;
 
+		// Live particles. They wait for an update running on the update thread.
 		uint32_t NumParticles() const
 		{
-			return static_cast<uint32_t>(particles_.size());
+			std::lock_guard<std::mutex> lock(particles_mutex_);
+			return particles_.num;
 		}
-		uint32_t NumActiveParticles() const
+		Particle GetParticle(uint32_t i) const
 		{
-			return static_cast<uint32_t>(active_particles_.size());
+			std::lock_guard<std::mutex> lock(particles_mutex_);
+			BOOST_ASSERT(i < particles_.num);
+			return particles_.Get(i);
 		}
-		uint32_t GetActiveParticleIndex(uint32_t i) const
+		void SetParticle(uint32_t i, Particle const & par)
 		{
-			return active_particles_[i].first;
+			std::lock_guard<std::mutex> lock(particles_mutex_);
+			BOOST_ASSERT(i < particles_.num);
+			particles_.Set(i, par);
 		}
-		Particle const & GetParticle(uint32_t i) const
+		void ClearParticles();
+
+		// Particles of the last finished update, back to front
+		uint32_t NumActiveParticles() const
 		{
-			BOOST_ASSERT(i < particles_.size());
-			return particles_[i];
+			std::lock_guard<std::mutex> lock(update_mutex_);
+			return static_cast<uint32_t>(active_particles_.size());
 		}
-		Particle& GetParticle(uint32_t i)
+		Particle GetActiveParticle(uint32_t i) const
 		{
-			BOOST_ASSERT(i < particles_.size());
-			return particles_[i];
+			std::lock_guard<std::mutex> lock(update_mutex_);
+			BOOST_ASSERT(i < active_particles_.size());
+			return active_particles_[i];
 		}
-		void ClearParticles();
 
 		void ParticleAlphaFromTex(std::string const & tex_name);
 		std::string const & ParticleAlphaFromTex() const
@@ -339,8 +381,13 @@ namespace KlayGE
 		std::vector<ParticleEmitterPtr> emitters_;
 		std::vector<ParticleUpdaterPtr> updaters_;
 
-		std::vector<Particle> particles_;
-		std::vector<std::pair<uint32_t, float>> active_particles_;
+		ParticleSoA particles_;
+		// The update thread fills back_active_particles_, and swaps it in under update_mutex_
+		std::vector<Particle> active_particles_;
+		std::vector<Particle> back_active_particles_;
+		// Depth key in the high 32 bits, particle index in the low 32 bits
+		std::vector<uint64_t> depth_items_;
+		std::vector<uint64_t> depth_scratch_;
 
 		float gravity_;
 		float3 force_;
@@ -353,7 +400,9 @@ namespace KlayGE
 
 		bool gs_support_;
 
-		std::mutex update_mutex_;
+		// Held by SubThreadUpdate while it changes particles_, so that the render path never waits for it
+		mutable std::mutex particles_mutex_;
+		mutable std::mutex update_mutex_;
 	};
 
 	KLAYGE_CORE_API ParticleSystemPtr SyncLoadParticleSystem(std::string const & psml_name);
@@ -417,6 +466,7 @@ namespace KlayGE
 		}
 
 		virtual void Update(Particle& par, float elapse_time) override;
+		virtual void UpdateBatch(ParticleSoA& particles, uint32_t first, uint32_t last, float elapse_time) override;
 
 	private:
 		std::mutex update_mutex_;
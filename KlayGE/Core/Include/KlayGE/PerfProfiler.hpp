@@ -36,16 +36,22 @@
 #include <KlayGE/PreDeclare.hpp>
 #include <KFL/Timer.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <tuple>
+#include <vector>
 
 namespace KlayGE
 {
 	class KLAYGE_CORE_API PerfRange : boost::noncopyable
 	{
 	public:
-		PerfRange();
+		explicit PerfRange(char const * name);
 
 		void Begin();
 		void End();
@@ -57,6 +63,8 @@ namespace KlayGE
 		bool Dirty() const;
 
 	private:
+		char const * name_;
+
 		Timer cpu_timer_;
 		QueryPtr gpu_timer_query_;
 
@@ -66,10 +74,20 @@ namespace KlayGE
 		bool dirty_;
 	};
 
+	// Besides the ranges, PerfProfiler records a timeline of trace events from any thread. Every thread writes to a
+	//  ring buffer of its own without locking, and the oldest events are overwritten when it's full. Every slot of the
+	//  ring is a seqlock, so the exporter skips the events being overwritten instead of reading them torn. The ring of a
+	//  thread that exits is reused by the next thread that starts tracing.
 	class KLAYGE_CORE_API PerfProfiler : boost::noncopyable
 	{
 	public:
+		// Frames of samples kept for a range
+		static uint32_t const MAX_FRAMES = 1024;
+		// Trace events kept for a thread
+		static uint32_t const MAX_EVENTS_PER_THREAD = 32 * 1024;
+
 		PerfProfiler();
+		~PerfProfiler();
 
 		static PerfProfiler& Instance();
 		static void Destroy();
@@ -80,14 +98,129 @@ namespace KlayGE
 		PerfRangePtr CreatePerfRange(int category, std::string const & name);
 		void CollectData();
 
+		// On by default when perf_profiler is set in the config
+		void Tracing(bool tracing);
+		bool Tracing() const;
+
+		// The names have to live as long as the profiler, e.g. literals or from InternName
+		void BeginEvent(char const * name);
+		void EndEvent();
+		void Counter(char const * name, double value);
+		// Links events on different threads, e.g. where a job is queued and where it runs.
+		//  FlowBegin returns the id for the steps and the end.
+		uint64_t FlowBegin(char const * name);
+		void FlowStep(char const * name, uint64_t id);
+		void FlowEnd(char const * name, uint64_t id);
+
+		// The name of the calling thread in the trace
+		void ThreadName(std::string const & name);
+		char const * InternName(std::string const & name);
+		// Rings allocated so far, one for each thread tracing at the same time
+		uint32_t NumThreadTraces() const;
+
 		void ExportToCSV(std::string const & file_name) const;
+		// Opens in chrome://tracing and Perfetto
+		void ExportToChromeTrace(std::string const & file_name) const;
+
+	private:
+		enum TraceEventType
+		{
+			TET_Begin,
+			TET_End,
+			TET_Counter,
+			TET_FlowBegin,
+			TET_FlowStep,
+			TET_FlowEnd
+		};
+
+		struct TraceEvent
+		{
+			uint64_t time;
+			char const * name;
+			uint64_t id;
+			double value;
+			TraceEventType type;
+		};
+
+		// A TraceEvent in the ring. seq is 2 * (index + 1) once the event with the index is written, and odd while
+		//  it's being written. The fields are atomics only so they can be read while being written.
+		struct TraceSlot
+		{
+			std::atomic<uint64_t> seq;
+			std::atomic<uint64_t> time;
+			std::atomic<char const *> name;
+			std::atomic<uint64_t> id;
+			std::atomic<double> value;
+			std::atomic<uint32_t> type;
+		};
+
+		struct ThreadTrace
+		{
+			uint32_t tid;
+			char const * name;
+			// Events written so far. The last MAX_EVENTS_PER_THREAD are in slots.
+			std::atomic<uint64_t> head;
+			// Events before it are from the threads that had the trace before
+			uint64_t first;
+			std::unique_ptr<TraceSlot[]> slots;
+		};
+
+		// Gives the trace back to its profiler when the thread exits
+		struct ThreadTraceOwner
+		{
+			uint32_t generation = 0;
+			ThreadTrace* trace = nullptr;
+
+			~ThreadTraceOwner();
+		};
+
+		ThreadTrace& CurrentThreadTrace();
+		ThreadTrace* AcquireThreadTrace();
+		static void RetireThreadTrace(uint32_t generation, ThreadTrace* trace);
+		void Record(TraceEventType type, char const * name, uint64_t id, double value);
 
 	private:
 		static std::unique_ptr<PerfProfiler> perf_profiler_instance_;
 
-		std::vector<std::tuple<int, std::string, PerfRangePtr,
-			std::vector<std::tuple<uint32_t, double, double>>>> perf_ranges_;
+		struct PerfRangeRecord
+		{
+			int category;
+			std::string name;
+			char const * gpu_counter_name;
+			PerfRangePtr range;
+
+			// A ring of (frame, cpu time, gpu time)
+			std::vector<std::tuple<uint32_t, double, double>> samples;
+			uint32_t num_samples;
+		};
+		std::vector<PerfRangeRecord> perf_ranges_;
 		uint32_t frame_id_;
+
+		std::atomic<bool> tracing_;
+		std::atomic<uint32_t> generation_;
+		std::chrono::steady_clock::time_point start_time_;
+		std::atomic<uint64_t> next_flow_id_;
+
+		mutable std::mutex trace_mutex_;
+		std::vector<std::unique_ptr<ThreadTrace>> thread_traces_;
+		// The ones left by the threads that exited. Their events are exported until they're reused.
+		std::vector<ThreadTrace*> free_thread_traces_;
+		uint32_t next_tid_;
+		std::set<std::string> interned_names_;
+	};
+
+	// Records an event for the lifetime of the scope
+	class PerfEventScope : boost::noncopyable
+	{
+	public:
+		explicit PerfEventScope(char const * name)
+		{
+			PerfProfiler::Instance().BeginEvent(name);
+		}
+		~PerfEventScope()
+		{
+			PerfProfiler::Instance().EndEvent();
+		}
 	};
 }
 
@@ -18,10 +18,9 @@
 
 #pragma once
 
-#include <list>
-#include <vector>
+#include <chrono>
+#include <string>
 
-#include <KFL/Thread.hpp>
 #include <KlayGE/Socket.hpp>
 
 #ifndef KLAYGE_PLATFORM_WINDOWS_STORE
@@ -30,12 +29,13 @@ namespace KlayGE
 {
 	struct LobbyDes
 	{
-		char			numPlayer;
-		char			maxPlayers;
+		uint32_t		numPlayer;
+		uint32_t		maxPlayers;
 		std::string		name;
 		sockaddr_in		addr;
 	};
 
+	// The socket is non-blocking once joined. Call Update regularly, it sends a keep-alive every 5 seconds.
 	class KLAYGE_CORE_API Player : boost::noncopyable
 	{
 	public:
@@ -51,21 +51,27 @@ namespace KlayGE
 		std::string const & Name()
 			{ return this->name_; }
 
+		uint32_t ID() const
+			{ return this->playerID_; }
+
+		// Returns -1 when nothing has arrived
 		int Receive(void* buf, int maxSize, sockaddr_in& from);
 		int Send(void const * buf, int size);
 
-		void ReceiveFunc();
+		void Update();
+
+	private:
+		// Waits up to 2 seconds for a reply of that type, dropping anything else
+		int ReceiveReply(char type, char* buf, int maxSize);
 
 	private:
 		Socket		socket_;
 
-		char		playerID_;
+		uint32_t	playerID_;
 		std::string	name_;
 
-		joiner<void>	receiveThread_;
-		bool			receiveLoop_;
-
-		std::list<std::vector<char>> sendQueue_;
+		bool		joined_;
+		std::chrono::steady_clock::time_point	last_send_;
 	};
 }
 
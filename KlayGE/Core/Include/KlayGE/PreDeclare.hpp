@@ -40,6 +40,8 @@ namespace KlayGE
 	class ResLoadingDesc;
 	typedef std::shared_ptr<ResLoadingDesc> ResLoadingDescPtr;
 	class ResLoader;
+	class Package;
+	typedef std::shared_ptr<Package> PackagePtr;
 	class PerfRange;
 	typedef std::shared_ptr<PerfRange> PerfRangePtr;
 	class PerfProfiler;
@@ -58,6 +60,7 @@ namespace KlayGE
 	typedef std::shared_ptr<SceneObjectLightSourceProxy> SceneObjectLightSourceProxyPtr;
 	class SceneObjectCameraProxy;
 	typedef std::shared_ptr<SceneObjectCameraProxy> SceneObjectCameraProxyPtr;
+	class TransformHierarchy;
 
 	class Blitter;
 	typedef std::shared_ptr<Blitter> BlitterPtr;
@@ -122,6 +125,9 @@ namespace KlayGE
 	typedef std::shared_ptr<ShaderObject> ShaderObjectPtr;
 	class Texture;
 	typedef std::shared_ptr<Texture> TexturePtr;
+	class StreamedTexture;
+	typedef std::shared_ptr<StreamedTexture> StreamedTexturePtr;
+	class TextureStreamingManager;
 	class TexCompression;
 	typedef std::shared_ptr<TexCompression> TexCompressionPtr;
 	class TexCompressionBC1;
@@ -335,6 +341,8 @@ namespace KlayGE
 	class Socket;
 	class Lobby;
 	class Player;
+	class NetConnection;
+	typedef std::shared_ptr<NetConnection> NetConnectionPtr;
 
 	class AudioEngine;
 	class AudioBuffer;
@@ -345,6 +353,12 @@ namespace KlayGE
 	typedef std::shared_ptr<AudioDataSource> AudioDataSourcePtr;
 	class AudioFactory;
 	class AudioDataSourceFactory;
+	class AudioSink;
+	typedef std::shared_ptr<AudioSink> AudioSinkPtr;
+	class NullAudioSink;
+	class WavFileAudioSink;
+	class AudioMixer;
+	typedef std::shared_ptr<AudioMixer> AudioMixerPtr;
 
 	class App3DFramework;
 	class Window;
@@ -180,6 +180,14 @@ namespace KlayGE
 			return instances_[index];
 		}
 
+		// The closest view space depth of all instances. view_mat_z is the 3rd column of the view matrix.
+		float MinViewDepth(float4 const & view_mat_z) const;
+
+		RenderMaterialPtr const & GetMaterial() const
+		{
+			return mtl_;
+		}
+
 		virtual void ModelMatrix(float4x4 const & mat);
 
 		template <typename ForwardIterator>
@@ -327,6 +335,8 @@ namespace KlayGE
 		RenderEffectParameter* alpha_test_threshold_param_;
 
 		std::array<TexturePtr, RenderMaterial::TS_NumTextureSlots> textures_;
+		// textures_ of these slots are refreshed from them every time they're bound
+		std::array<StreamedTexturePtr, RenderMaterial::TS_NumTextureSlots> streamed_textures_;
 
 		std::vector<RenderablePtr> subrenderables_;
 	};
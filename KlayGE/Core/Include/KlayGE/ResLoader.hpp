@@ -34,25 +34,18 @@
 #pragma once
 
 #include <KlayGE/PreDeclare.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <istream>
+#include <queue>
 #include <vector>
 #include <string>
-#if defined(KLAYGE_COMPILER_MSVC)
-#pragma warning(push)
-#pragma warning(disable: 4512) // consume_via_copy in lockfree doesn't have assignment operator.
-#elif defined(KLAYGE_COMPILER_CLANG)
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wunused-parameter" // Ignore unused parameter 'x', 'alloc'
-#endif
-#include <boost/lockfree/spsc_queue.hpp>
-#if defined(KLAYGE_COMPILER_MSVC)
-#pragma warning(pop)
-#elif defined(KLAYGE_COMPILER_CLANG)
-#pragma clang diagnostic pop
-#endif
+#include <unordered_map>
 
 #include <KFL/ResIdentifier.hpp>
 #include <KFL/Thread.hpp>
+#include <KFL/Timer.hpp>
 
 namespace KlayGE
 {
@@ -75,14 +68,35 @@ namespace KlayGE
 		virtual void MainThreadStage() = 0;
 
 		virtual bool HasSubThreadStage() const = 0;
+		// Descs that return true run their sub thread stages alongside any other desc. The others run them one at a
+		//  time with the descs of the same type.
+		virtual bool ConcurrentSubThreadStage() const
+		{
+			return false;
+		}
 
 		virtual bool Match(ResLoadingDesc const & rhs) const = 0;
+		// Stable over the lifetime of the desc, and the same for descs that match each other
+		virtual size_t Hash() const = 0;
 		virtual void CopyDataFrom(ResLoadingDesc const & rhs) = 0;
 		virtual std::shared_ptr<void> CloneResourceFrom(std::shared_ptr<void> const & resource) = 0;
 
 		virtual std::shared_ptr<void> Resource() const = 0;
 	};
 
+	// Where the time of an async request went, in seconds
+	struct ResLoadingTiming
+	{
+		uint64_t type;
+		std::weak_ptr<void> resource;
+		float priority;
+		bool cancelled;
+
+		double wait_time;
+		double sub_thread_time;
+		double main_thread_time;
+	};
+
 	class KLAYGE_CORE_API ResLoader : boost::noncopyable
 	{
 	public:
@@ -107,7 +121,9 @@ namespace KlayGE
 		std::string AbsPath(std::string const & path);
 
 		std::shared_ptr<void> SyncQuery(ResLoadingDescPtr const & res_desc);
-		std::shared_ptr<void> ASyncQuery(ResLoadingDescPtr const & res_desc);
+		// Requests with higher priority go to the loading threads first. Unloading a resource before it's loaded
+		//  cancels the request.
+		std::shared_ptr<void> ASyncQuery(ResLoadingDescPtr const & res_desc, float priority = 0);
 		void Unload(std::shared_ptr<void> const & res);
 
 		template <typename T>
@@ -117,9 +133,9 @@ namespace KlayGE
 		}
 
 		template <typename T>
-		std::shared_ptr<T> ASyncQueryT(ResLoadingDescPtr const & res_desc)
+		std::shared_ptr<T> ASyncQueryT(ResLoadingDescPtr const & res_desc, float priority = 0)
 		{
-			return std::static_pointer_cast<T>(this->ASyncQuery(res_desc));
+			return std::static_pointer_cast<T>(this->ASyncQuery(res_desc, priority));
 		}
 
 		template <typename T>
@@ -130,17 +146,99 @@ namespace KlayGE
 
 		void Update();
 
+		void NumLoadingThreads(uint32_t num);
+		uint32_t NumLoadingThreads() const
+		{
+			return static_cast<uint32_t>(loading_threads_.size());
+		}
+
+		// Moves out the timings of async requests finished or cancelled since the last call
+		void CollectLoadingTimings(std::vector<ResLoadingTiming>& timings);
+
+		uint64_t NumCacheHits() const
+		{
+			return num_cache_hits_;
+		}
+		uint64_t NumCacheMisses() const
+		{
+			return num_cache_misses_;
+		}
+		uint64_t NumCacheClones() const
+		{
+			return num_cache_clones_;
+		}
+
 	private:
+		enum LoadingStatus
+		{
+			LS_Loading,
+			LS_Running,
+			LS_Complete,
+			LS_CanBeRemoved,
+			LS_Cancelled
+		};
+
+		// Shared by all descs waiting for the same resource
+		struct LoadingRequest
+		{
+			ResLoadingDescPtr res_desc;
+			std::atomic<LoadingStatus> status;
+			std::atomic<float> priority;
+			// Held by the loading thread while the request is LS_Running
+			std::mutex running_mutex;
+
+			double queued_time;
+			double start_time;
+			double sub_thread_time;
+
+			// Links the queuing and the two stages in the trace
+			uint64_t flow_id;
+		};
+		typedef std::shared_ptr<LoadingRequest> LoadingRequestPtr;
+
+		// A request is queued again when asked with a higher priority. Whichever copy is popped first runs it.
+		struct LoadingQueueItem
+		{
+			float priority;
+			uint64_t seq;
+			LoadingRequestPtr request;
+
+			bool operator<(LoadingQueueItem const & rhs) const
+			{
+				// FIFO for the same priority
+				return (priority < rhs.priority) || ((priority == rhs.priority) && (seq > rhs.seq));
+			}
+		};
+
+		struct LoadedResShard
+		{
+			std::mutex mutex;
+			std::unordered_multimap<size_t, std::pair<ResLoadingDescPtr, std::weak_ptr<void>>> res;
+			size_t sweep_size = 0;
+		};
+
 		std::string RealPath(std::string const & path);
 
 		void AddLoadedResource(ResLoadingDescPtr const & res_desc, std::shared_ptr<void> const & res);
 		std::shared_ptr<void> FindMatchLoadedResource(ResLoadingDescPtr const & res_desc);
-		void RemoveUnrefResources();
+		std::shared_ptr<void> CloneLoadedResource(ResLoadingDescPtr const & res_desc, std::shared_ptr<void> const & loaded_res);
+		bool FindMatchLoadingResource(ResLoadingDescPtr const & res_desc, std::shared_ptr<void>& res,
+			LoadingRequestPtr& request);
+		void AddLoadingResource(ResLoadingDescPtr const & res_desc, LoadingRequestPtr const & request);
+		void EraseLoadingResourceIndex(ResLoadingDescPtr const & res_desc);
+		void QueueLoadingRequest(LoadingRequestPtr const & request, float priority);
+		void CancelLoadingResource(std::shared_ptr<void> const & res);
+		void AddLoadingTiming(LoadingRequestPtr const & request, double main_thread_time);
+		void StopLoadingThreads();
+		LoadingRequestPtr PopRunnableRequest(uint32_t& stage_slot);
+		LoadedResShard& LoadedShard(size_t hash);
+		void SweepLoadedShard(LoadedResShard& shard);
 
 		void LoadingThreadFunc();
 
 		ResIdentifierPtr LocatePkt(std::string const & name, std::string const & res_name,
 			std::string& password, std::string& internal_name);
+		PackagePtr LocatePackage(std::string const & res_name, std::string& internal_name);
 #if defined(KLAYGE_PLATFORM_ANDROID)
 		AAsset* LocateFileAndroid(std::string const & name);
 #elif defined(KLAYGE_PLATFORM_IOS)
@@ -152,27 +250,44 @@ namespace KlayGE
 	private:
 		static std::unique_ptr<ResLoader> res_loader_instance_;
 
-		enum LoadingStatus
-		{
-			LS_Loading,
-			LS_Complete,
-			LS_CanBeRemoved
-		};
+		static uint32_t constexpr NUM_LOADED_RES_SHARDS = 16;
 
 		std::string exe_path_;
 		std::string local_path_;
 		std::vector<std::string> paths_;
 		std::mutex paths_mutex_;
+		// Opened packages, or null for 7z ones. Guarded by paths_mutex_.
+		std::unordered_map<std::string, PackagePtr> packages_;
+
+		// Loaded resources are keyed by ResLoadingDesc::Hash. Each shard has its own lock, and expired entries are swept
+		//  when they are met, or when a shard doubles its size.
+		std::array<LoadedResShard, NUM_LOADED_RES_SHARDS> loaded_res_shards_;
+		std::atomic<uint64_t> num_cache_hits_;
+		std::atomic<uint64_t> num_cache_misses_;
+		std::atomic<uint64_t> num_cache_clones_;
 
-		std::mutex loaded_mutex_;
 		std::mutex loading_mutex_;
-		std::vector<std::pair<ResLoadingDescPtr, std::weak_ptr<void>>> loaded_res_;
-		std::vector<std::pair<ResLoadingDescPtr, std::shared_ptr<volatile LoadingStatus>>> loading_res_;
-		boost::lockfree::spsc_queue<std::pair<ResLoadingDescPtr, std::shared_ptr<volatile LoadingStatus>>,
-			boost::lockfree::capacity<1024>> loading_res_queue_;
+		std::vector<std::pair<ResLoadingDescPtr, LoadingRequestPtr>> loading_res_;
+		std::unordered_multimap<size_t, std::pair<ResLoadingDescPtr, LoadingRequestPtr>> loading_res_index_;
+
+		// Cancelled requests stay in the queue, and are dropped when popped
+		std::mutex loading_queue_mutex_;
+		std::condition_variable loading_queue_cond_;
+		std::priority_queue<LoadingQueueItem> loading_queue_;
+		uint64_t loading_seq_;
+		bool quit_;
+
+		// Set while a loading thread runs the sub thread stage of a desc that isn't concurrent, picked by
+		//  ResLoadingDesc::Type. Guarded by loading_queue_mutex_. Types sharing a slot only wait for each other more
+		//  than needed.
+		static uint32_t constexpr NUM_SUB_THREAD_STAGE_SLOTS = 16;
+		std::array<bool, NUM_SUB_THREAD_STAGE_SLOTS> sub_thread_stage_busy_;
+
+		std::vector<std::unique_ptr<joiner<void>>> loading_threads_;
 
-		std::unique_ptr<joiner<void>> loading_thread_;
-		volatile bool quit_;
+		Timer timer_;
+		std::mutex loading_timings_mutex_;
+		std::vector<ResLoadingTiming> loading_timings_;
 	};
 }
 
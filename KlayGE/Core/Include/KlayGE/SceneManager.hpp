@@ -24,9 +24,13 @@
 #include <KlayGE/PreDeclare.hpp>
 
 #include <KlayGE/Renderable.hpp>
+#include <KlayGE/TransientBuffer.hpp>
+#include <KlayGE/TransformHierarchy.hpp>
 #include <KFL/Frustum.hpp>
 #include <KFL/Thread.hpp>
+#include <KFL/AlignedAllocator.hpp>
 
+#include <array>
 #include <vector>
 #include <unordered_map>
 
@@ -87,6 +91,16 @@ namespace KlayGE
 		uint32_t NumDrawCalls() const;
 		uint32_t NumDispatchCalls() const;
 
+		// Renderables with instance data that share the geometry, effect, technique and material are drawn in one
+		//  call. On by default. Turn it off if renderables like that still set different states in OnRenderBegin.
+		void AutoInstancing(bool auto_instancing);
+		bool AutoInstancing() const;
+
+		// Packs the instance data of the objects into a transient buffer that lives for this frame. Returns the
+		//  buffer, and the location of the first instance in it.
+		GraphicsBufferPtr const & PackInstances(uint32_t& start_instance, std::vector<SceneObject const *> const & objs,
+			uint32_t instance_size);
+
 	protected:
 		void Flush(uint32_t urt);
 
@@ -104,6 +118,17 @@ namespace KlayGE
 		BoundOverlap VisibleTestFromParent(SceneObject* obj, float3 const & view_dir, float3 const & eye_pos,
 			float4x4 const & view_proj);
 
+		// Brings the abs model matrices and world bounds of objects up to date, after their model matrices or the
+		//  ones of their ancestors changed. Called at the beginning of clipping.
+		void UpdateTransforms();
+
+		// Clips root objects on the task scheduler. World AABBs are gathered into SoA arrays and tested against the
+		//  frustum 4 at a time. Children are left to the caller, since they depend on the parent.
+		//  skip_static_cullable and skip_moveable_cullable are for scene managers that cull those objects in their
+		//  own structure.
+		void ClipRootObjects(Camera const & camera, float4x4 const & view_proj, bool skip_static_cullable,
+			bool skip_moveable_cullable);
+
 	protected:
 		std::vector<CameraPtr> cameras_;
 		Frustum const * frustum_;
@@ -113,16 +138,38 @@ namespace KlayGE
 
 		std::unordered_map<size_t, std::shared_ptr<std::vector<BoundOverlap>>> visible_marks_map_;
 
+		// Model matrices of all non-overlay objects, and the objects indexed by their nodes
+		TransformHierarchy transforms_;
+		std::vector<SceneObject*> transform_objs_;
+
+		std::array<std::vector<float, aligned_allocator<float, 16>>, 6> aabbs_ws_soa_;
+		std::vector<BoundOverlap> frustum_results_;
+
 		float small_obj_threshold_;
 		float update_elapse_;
 
 	private:
 		void FlushScene();
 
+	private:
+		struct RenderQueueItem
+		{
+			uint64_t key;
+			Renderable* renderable;
+		};
+
 	private:
 		uint32_t urt_;
 
-		std::vector<std::pair<RenderTechnique const *, std::vector<Renderable*>>> render_queue_;
+		// The renderables of the current flush, and their sort keys. The arrays keep their capacity between flushes.
+		std::vector<Renderable*> render_queue_;
+		std::vector<RenderQueueItem> render_queue_items_;
+		std::vector<RenderQueueItem> render_queue_scratch_;
+		std::vector<RenderQueueItem> tech_rank_items_;
+		std::vector<RenderQueueItem> instancing_items_;
+		std::vector<uint32_t> tech_ranks_;
+		std::unordered_map<RenderTechnique const *, uint32_t> tech_slots_;
+		std::unordered_map<RenderMaterial const *, uint32_t> mtl_slots_;
 
 		uint32_t num_objects_rendered_;
 		uint32_t num_renderables_rendered_;
@@ -131,6 +178,11 @@ namespace KlayGE
 		uint32_t num_draw_calls_;
 		uint32_t num_dispatch_calls_;
 
+		bool auto_instancing_;
+		std::unique_ptr<TransientBuffer> instance_buffer_;
+		std::vector<SubAlloc> instance_allocs_;
+		std::vector<uint8_t> instance_data_;
+
 		std::mutex update_mutex_;
 		std::unique_ptr<joiner<void>> update_thread_;
 		volatile bool quit_;
@@ -43,6 +43,7 @@ namespace KlayGE
 		virtual ~SceneObject();
 
 		SceneObject* Parent() const;
+		// Also moves the node in the transform hierarchy when the object is in a scene manager
 		void Parent(SceneObject* so);
 		uint32_t NumChildren() const;
 		const SceneObjectPtr& Child(uint32_t index) const;
@@ -53,7 +54,18 @@ namespace KlayGE
 		virtual float4x4 const & ModelMatrix() const;
 		virtual float4x4 const & AbsModelMatrix() const;
 		virtual AABBox const & PosBoundWS() const;
+		// Call it when the bound of the renderable changes. Objects in a scene manager are updated by its transform
+		//  hierarchy on the next clip, the others at once. New model matrices are picked up without it.
 		void UpdateAbsModelMatrix();
+		// Only updates abs model matrix and world bound, without touching the renderable, which could be shared.
+		//  Safe to be called on different objects concurrently.
+		void CalcAbsModelMatrix();
+
+		// Set by the scene manager. The parent has to be set before.
+		void TransformNode(TransformHierarchy* transforms, uint32_t node);
+		uint32_t TransformNode() const;
+		// Copies the abs model matrix and world bound from the transform hierarchy, and passes the matrix to the renderable
+		void SyncAbsModelMatrix();
 		void VisibleMark(BoundOverlap vm);
 		BoundOverlap VisibleMark() const;
 
@@ -105,6 +117,8 @@ namespace KlayGE
 		float4x4 model_;
 		float4x4 abs_model_;
 		std::unique_ptr<AABBox> pos_aabb_ws_;
+		TransformHierarchy* transforms_;
+		uint32_t transform_node_;
 		BoundOverlap visible_mark_;
 
 		std::function<void(SceneObject&, float, float)> sub_thread_update_func_;
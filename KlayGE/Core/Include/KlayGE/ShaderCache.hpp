@@ -0,0 +1,118 @@
+/**
+ * @file ShaderCache.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#ifndef _KLAYGE_SHADER_CACHE_HPP
+#define _KLAYGE_SHADER_CACHE_HPP
+
+#pragma once
+
+#include <KlayGE/PreDeclare.hpp>
+
+#if KLAYGE_IS_DEV_PLATFORM
+
+#include <KlayGE/ShaderObject.hpp>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace KlayGE
+{
+	// Everything that goes into the HLSL compiler for one shader, except the HLSL text. The caps of the device are
+	//  in the macros.
+	struct KLAYGE_CORE_API ShaderCompileRequest
+	{
+		ShaderObject::ShaderType type;
+		std::string func_name;
+		std::string profile;
+		uint32_t flags;
+		std::vector<std::pair<std::string, std::string>> macros;
+
+		bool operator==(ShaderCompileRequest const & rhs) const;
+		bool operator!=(ShaderCompileRequest const & rhs) const
+		{
+			return !(*this == rhs);
+		}
+	};
+
+	// Compiled DXBC in a folder, found by a 64-bit hash of the compiler version, the HLSL text and the request. The
+	//  request and the hash of the text are stored with each entry and compared on a hit, so two inputs with the
+	//  same hash never share code. The blobs are stored by the hash of their content, so the same stage compiled
+	//  for different effects is only stored once.
+	//  The index is appended to while running, and compacted when it's loaded. Only the newest MAX_ENTRIES are kept.
+	class KLAYGE_CORE_API ShaderCache : boost::noncopyable
+	{
+	public:
+		static uint32_t const MAX_ENTRIES = 16384;
+
+		// An empty folder, or one that can't be created, makes a cache that misses everything
+		ShaderCache(std::string const & folder, std::string const & compiler_version);
+
+		bool Contains(uint64_t hlsl_hash, ShaderCompileRequest const & request);
+		bool Find(uint64_t hlsl_hash, ShaderCompileRequest const & request, std::vector<uint8_t>& code);
+		void Add(uint64_t hlsl_hash, ShaderCompileRequest const & request, std::vector<uint8_t> const & code);
+		uint32_t NumEntries();
+
+		// The requests of the effects being loaded, written to their manifests when they finish
+		void Record(uint64_t manifest_key, uint64_t hlsl_hash, ShaderCompileRequest const & request);
+		std::vector<ShaderCompileRequest> LoadManifest(uint64_t manifest_key);
+		void SaveManifest(uint64_t manifest_key);
+
+	private:
+		struct Entry
+		{
+			uint64_t blob_hash;
+			uint64_t hlsl_hash;
+			ShaderCompileRequest request;
+			// Where it is in the index. The newest ones have the largest numbers.
+			uint64_t order;
+		};
+
+		uint64_t Key(uint64_t hlsl_hash, ShaderCompileRequest const & request) const;
+		Entry const * FindEntry(uint64_t hlsl_hash, ShaderCompileRequest const & request) const;
+		void LoadIndex();
+		void WriteIndex();
+		std::string CachePath(uint64_t hash, char const * ext) const;
+
+	private:
+		std::mutex mutex_;
+		std::string folder_;
+		std::string compiler_version_;
+		std::unordered_map<uint64_t, Entry> index_;
+		uint64_t next_order_;
+		std::unordered_map<uint64_t, std::vector<std::pair<uint64_t, ShaderCompileRequest>>> recorded_;
+	};
+}
+
+#endif
+
+#endif		// _KLAYGE_SHADER_CACHE_HPP
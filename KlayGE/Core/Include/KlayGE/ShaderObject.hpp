@@ -147,6 +147,12 @@ namespace KlayGE
 			return cs_block_size_z_;
 		}
 
+		// Compiles in parallel the shaders that the last load of this effect used and the shader cache doesn't have,
+		//  so loading the passes finds all of them in the cache.
+		static void PrecompileShaders(RenderEffect const & effect);
+		// Remembers the shaders this load of the effect used, for PrecompileShaders next time.
+		static void SaveShaderManifest(RenderEffect const & effect);
+
 	protected:
 		std::vector<uint8_t> CompileToDXBC(ShaderType type, RenderEffect const & effect,
 			RenderTechnique const & tech, RenderPass const & pass,
@@ -92,9 +92,15 @@ namespace KlayGE
 			this->IOCtl(FIONBIO, &on);
 		}
 
-		void TimeOut(uint32_t microSecs);
+		// In milliseconds
+		void TimeOut(uint32_t milliSecs);
 		uint32_t TimeOut();
 
+		SOCKET Handle() const
+		{
+			return this->socket_;
+		}
+
 	private:
 		SOCKET		socket_;
 	};
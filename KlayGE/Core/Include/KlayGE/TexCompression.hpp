@@ -80,9 +80,14 @@ namespace KlayGE
 			return decoded_fmt_;
 		}
 
+		// Creates a new codec of the same type. Some codecs keep scratch state in EncodeBlock, so every thread that
+		//  encodes in parallel needs its own instance.
+		virtual TexCompressionPtr Clone() const = 0;
+
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) = 0;
 		virtual void DecodeBlock(void* output, void const * input) = 0;
 
+		// Rows of blocks are encoded in parallel on the task scheduler. The result is the same as encoding block by block.
 		virtual void EncodeMem(uint32_t width, uint32_t height, 
 			void* output, uint32_t out_row_pitch, uint32_t out_slice_pitch,
 			void const * input, uint32_t in_row_pitch, uint32_t in_slice_pitch,
@@ -94,6 +99,11 @@ namespace KlayGE
 		virtual void EncodeTex(TexturePtr const & out_tex, TexturePtr const & in_tex, TexCompressionMethod method);
 		virtual void DecodeTex(TexturePtr const & out_tex, TexturePtr const & in_tex);
 
+	private:
+		void EncodeBlockRows(TexCompression& codec, uint32_t first_row, uint32_t last_row,
+			uint32_t width, uint32_t height, void* output, uint32_t out_row_pitch,
+			void const * input, uint32_t in_row_pitch, TexCompressionMethod method) const;
+
 	protected:
 		uint32_t block_width_;
 		uint32_t block_height_;
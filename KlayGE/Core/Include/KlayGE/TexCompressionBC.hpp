@@ -33,7 +33,9 @@
 
 #pragma once
 
+#include <array>
 #include <cstring>
+#include <vector>
 
 #include <KlayGE/TexCompression.hpp>
 
@@ -80,6 +82,8 @@ namespace KlayGE
 	public:
 		TexCompressionBC1();
 
+		virtual TexCompressionPtr Clone() const override;
+
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
@@ -98,6 +102,8 @@ namespace KlayGE
 	public:
 		TexCompressionBC2();
 
+		virtual TexCompressionPtr Clone() const override;
+
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
@@ -110,6 +116,8 @@ namespace KlayGE
 	public:
 		TexCompressionBC4();
 
+		virtual TexCompressionPtr Clone() const override;
+
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 	};
@@ -119,6 +127,8 @@ namespace KlayGE
 	public:
 		TexCompressionBC3();
 
+		virtual TexCompressionPtr Clone() const override;
+
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
@@ -132,6 +142,8 @@ namespace KlayGE
 	public:
 		TexCompressionBC5();
 
+		virtual TexCompressionPtr Clone() const override;
+
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
@@ -144,6 +156,8 @@ namespace KlayGE
 	public:
 		TexCompressionBC6U();
 
+		virtual TexCompressionPtr Clone() const override;
+
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
@@ -205,6 +219,8 @@ namespace KlayGE
 	public:
 		TexCompressionBC6S();
 
+		virtual TexCompressionPtr Clone() const override;
+
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
@@ -270,6 +286,8 @@ namespace KlayGE
 	public:
 		TexCompressionBC7();
 
+		virtual TexCompressionPtr Clone() const override;
+
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
@@ -297,6 +315,7 @@ namespace KlayGE
 		void ClampEndpoints(float4& p1, float4& p2) const;
 		void ClampEndpointsToGrid(ModeInfo const & mode_info,
 			float4& p1, float4& p2, uint8_t& best_pbit_combo) const;
+		uint32_t Random() const;
 		uint64_t TryCompress(int mode, int simulated_annealing_steps, TexCompressionErrorMetric metric,
 			CompressParams& params, uint32_t shape_index, RGBACluster& cluster);
 
@@ -310,6 +329,9 @@ namespace KlayGE
 		TexCompressionErrorMetric error_metric_;
 		int rotate_mode_;
 		int index_mode_;
+		// State of the private random generator. Annealing of every block restarts it from the same seed.
+		mutable std::array<uint32_t, 31> rand_state_;
+		mutable uint32_t rand_pos_;
 
 		static ModeInfo const mode_info_[];
 	};
@@ -129,6 +129,8 @@ namespace KlayGE
 	public:
 		TexCompressionETC1();
 
+		virtual TexCompressionPtr Clone() const override;
+
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
@@ -206,6 +208,8 @@ namespace KlayGE
 	public:
 		TexCompressionETC2RGB8();
 
+		virtual TexCompressionPtr Clone() const override;
+
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
@@ -222,6 +226,8 @@ namespace KlayGE
 	public:
 		TexCompressionETC2RGB8A1();
 
+		virtual TexCompressionPtr Clone() const override;
+
 		virtual void EncodeBlock(void* output, void const * input, TexCompressionMethod method) override;
 		virtual void DecodeBlock(void* output, void const * input) override;
 
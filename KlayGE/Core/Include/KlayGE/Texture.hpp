@@ -327,6 +327,9 @@ namespace KlayGE
 		ElementFormat& format, std::vector<ElementInitData>& init_data, std::vector<uint8_t>& data_block);
 	KLAYGE_CORE_API TexturePtr SyncLoadTexture(std::string const & tex_name, uint32_t access_hint);
 	KLAYGE_CORE_API TexturePtr ASyncLoadTexture(std::string const & tex_name, uint32_t access_hint);
+	// Only the coarsest mips are on the GPU at first, see TextureStreamingManager
+	KLAYGE_CORE_API StreamedTexturePtr SyncLoadStreamedTexture(std::string const & tex_name, uint32_t access_hint);
+	KLAYGE_CORE_API StreamedTexturePtr ASyncLoadStreamedTexture(std::string const & tex_name, uint32_t access_hint);
 
 	KLAYGE_CORE_API void SaveTexture(std::string const & tex_name, Texture::TextureType type,
 		uint32_t width, uint32_t height, uint32_t depth, uint32_t num_mipmaps, uint32_t array_size,
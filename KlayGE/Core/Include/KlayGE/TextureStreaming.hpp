@@ -0,0 +1,200 @@
+/**
+* @file TextureStreaming.hpp
+* @author Minmin Gong
+*
+* @section DESCRIPTION
+*
+* This source file is part of KlayGE
+* For the latest info, see http://www.klayge.org
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* You may alternatively use this source under the terms of
+* the KlayGE Proprietary License (KPL). You can obtained such a license
+* from http://www.klayge.org/licensing/.
+*/
+
+#ifndef _KLAYGE_TEXTURESTREAMING_HPP
+#define _KLAYGE_TEXTURESTREAMING_HPP
+
+#pragma once
+
+#include <KlayGE/PreDeclare.hpp>
+#include <KlayGE/Texture.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace KlayGE
+{
+	// A texture that has only the coarser part of its mip chain on the GPU, and the finer mips in system memory.
+	//  The GPU texture is recreated when that part grows or shrinks, so get it from ResidentTexture() every frame.
+	class KLAYGE_CORE_API StreamedTexture : boost::noncopyable
+	{
+		friend class TextureStreamingManager;
+
+	public:
+		StreamedTexture(Texture::TextureType type, uint32_t width, uint32_t height, uint32_t depth,
+			uint32_t num_mip_maps, uint32_t array_size, ElementFormat format, uint32_t access_hint);
+
+		Texture::TextureType Type() const
+		{
+			return type_;
+		}
+		uint32_t Width() const
+		{
+			return width_;
+		}
+		uint32_t Height() const
+		{
+			return height_;
+		}
+		uint32_t Depth() const
+		{
+			return depth_;
+		}
+		uint32_t NumMipMaps() const
+		{
+			return num_mip_maps_;
+		}
+		uint32_t ArraySize() const
+		{
+			return array_size_;
+		}
+		ElementFormat Format() const
+		{
+			return format_;
+		}
+
+		TexturePtr const & ResidentTexture() const
+		{
+			return resident_tex_;
+		}
+		// The level of the full chain that is level 0 of the resident texture
+		uint32_t ResidentMip() const
+		{
+			return resident_mip_;
+		}
+		uint64_t ResidentBytes() const
+		{
+			return resident_bytes_;
+		}
+		uint64_t MipChainBytes(uint32_t first_mip) const;
+
+		// Asks for the mips from level on. The finest level asked for in a frame wins.
+		void RequestMip(uint32_t level);
+		// Asks for the mip with about one texel per pixel, when the whole texture spans that many pixels on screen
+		void RequestScreenSize(float pixels);
+
+		// The whole chain, from the loader. The base mips are dropped from it once they are on the GPU.
+		void SourceData(std::vector<ElementInitData>&& init_data, std::vector<uint8_t>&& data_block);
+		bool SourceDataReady() const
+		{
+			return !init_data_.empty();
+		}
+		void CreateHWResource();
+		// Bytes of the mips kept in system memory
+		uint64_t SourceBytes() const;
+
+	private:
+		// Block compressed textures can only start at a level that is a whole number of blocks
+		bool CanStartAt(uint32_t level) const;
+		void ReleaseBaseSourceData();
+		void MakeResident(uint32_t first_mip);
+		void CopyMip(Texture& target, uint32_t array_index, uint32_t face, uint32_t dst_level, uint32_t src_level);
+		void UploadMip(Texture& target, uint32_t array_index, uint32_t face, uint32_t dst_level, uint32_t level);
+
+	private:
+		Texture::TextureType type_;
+		uint32_t width_, height_, depth_;
+		uint32_t num_mip_maps_;
+		uint32_t array_size_;
+		ElementFormat format_;
+		// Without EAH_Immutable, the resident textures are filled after they're created
+		uint32_t access_hint_;
+
+		std::vector<ElementInitData> init_data_;
+		std::vector<uint8_t> data_block_;
+
+		TexturePtr resident_tex_;
+		uint32_t resident_mip_;
+		// Always resident, never evicted
+		uint32_t base_mip_;
+		uint64_t resident_bytes_;
+
+		uint32_t requested_mip_;
+		uint32_t wanted_mip_;
+		uint32_t last_request_frame_;
+		bool managed_;
+	};
+
+	class KLAYGE_CORE_API TextureStreamingManager : boost::noncopyable
+	{
+	public:
+		TextureStreamingManager();
+
+		static TextureStreamingManager& Instance();
+		static void Destroy();
+
+		// Material textures of meshes are streamed when it's active. Off by default.
+		void Active(bool active);
+		bool Active() const;
+
+		// Bytes the streamed textures can take on the GPU. 0 means no limit.
+		void Budget(uint64_t bytes);
+		uint64_t Budget() const;
+
+		// Streamed textures start with the mips no larger than this
+		void InitialMipSize(uint32_t size);
+		uint32_t InitialMipSize() const;
+
+		// Growing a texture uploads its new mips, so only a few are grown in a frame
+		void MaxUploadsPerFrame(uint32_t num);
+		uint32_t MaxUploadsPerFrame() const;
+
+		// Called at the beginning of Update, to add requests from elsewhere, e.g. a mip feedback pass read back from the GPU
+		void MipFeedback(std::function<void()> const & callback);
+
+		void Add(StreamedTexturePtr const & tex);
+
+		// Grows the requested textures, and shrinks the least recently used ones to stay in the budget.
+		//  Main thread only.
+		void Update();
+
+		uint64_t ResidentBytes() const;
+		uint32_t NumStreamedTextures() const;
+
+	private:
+		// Shrinks the textures not requested since frame, least recently used first
+		uint64_t Shrink(std::vector<StreamedTexture*> const & lru_textures, uint64_t bytes, uint32_t frame);
+
+	private:
+		static std::unique_ptr<TextureStreamingManager> texture_streaming_manager_instance_;
+
+		bool active_;
+		uint64_t budget_;
+		uint32_t initial_mip_size_;
+		uint32_t max_uploads_per_frame_;
+		std::function<void()> mip_feedback_;
+
+		std::vector<std::weak_ptr<StreamedTexture>> textures_;
+		uint64_t resident_bytes_;
+		uint32_t frame_;
+	};
+}
+
+#endif			// _KLAYGE_TEXTURESTREAMING_HPP
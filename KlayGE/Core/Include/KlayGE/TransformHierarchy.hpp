@@ -0,0 +1,119 @@
+/**
+ * @file TransformHierarchy.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#ifndef _KLAYGE_TRANSFORM_HIERARCHY_HPP
+#define _KLAYGE_TRANSFORM_HIERARCHY_HPP
+
+#pragma once
+
+#include <KlayGE/PreDeclare.hpp>
+#include <KFL/AlignedAllocator.hpp>
+#include <KFL/AABBox.hpp>
+#include <KFL/Matrix.hpp>
+#include <KFL/Thread.hpp>
+
+#include <atomic>
+#include <vector>
+
+namespace KlayGE
+{
+	// Local and world matrices of a tree of nodes, and the bounds in both spaces, kept in arrays sorted by the
+	//  depth in the tree. Parents always come before their children, so the world data is updated with one pass
+	//  over the arrays, a depth level at a time. Only dirty nodes are updated. A new local matrix makes the node
+	//  and all its descendants dirty, a new local bound only the node itself.
+	//  Nodes are referred to by handles that stay the same when the arrays are sorted.
+	class KLAYGE_CORE_API TransformHierarchy : boost::noncopyable
+	{
+	public:
+		static uint32_t const INVALID_NODE = 0xFFFFFFFFU;
+
+		TransformHierarchy();
+
+		// The parent has to be added before its children and deleted after them
+		uint32_t AddNode(uint32_t parent, float4x4 const & local);
+		void DelNode(uint32_t node);
+		void Clear();
+
+		uint32_t NumNodes() const;
+		// Moves the node and its descendants under another parent, or makes it a root with INVALID_NODE. The new
+		//  parent can't be in the subtree. It's O(number of nodes), and the arrays are sorted again by the next Update.
+		void Parent(uint32_t node, uint32_t parent);
+		uint32_t Parent(uint32_t node) const;
+		uint32_t Depth(uint32_t node) const;
+
+		// Setting the same matrix again doesn't make the node dirty
+		void LocalMatrix(uint32_t node, float4x4 const & mat);
+		float4x4 const & LocalMatrix(uint32_t node) const;
+		void LocalBound(uint32_t node, AABBox const & aabb);
+		AABBox LocalBound(uint32_t node) const;
+
+		float4x4 const & WorldMatrix(uint32_t node) const;
+		AABBox WorldBound(uint32_t node) const;
+		bool Dirty(uint32_t node) const;
+
+		// Computes the world data of dirty nodes and their descendants. Nodes in one level are split across the
+		//  workers of the scheduler, or updated on the calling thread if it's null.
+		void Update(task_scheduler* scheduler);
+		// The nodes updated by the last Update
+		std::vector<uint32_t> const & UpdatedNodes() const;
+
+	private:
+		void MarkDirty(uint32_t node, uint32_t index, uint8_t flags);
+		void Sort();
+		void UpdateRange(uint32_t first, uint32_t last);
+
+	private:
+		// Indexed by handles
+		std::vector<uint32_t> node_parents_;
+		std::vector<uint32_t> node_depths_;
+		std::vector<uint32_t> node_indices_;
+		std::vector<uint32_t> node_num_children_;
+		std::vector<uint32_t> free_nodes_;
+
+		// Indexed by the position in the depth order. Bounds are stored as center and extent, padded to 4 floats.
+		std::vector<uint32_t> handles_;
+		std::vector<uint32_t> parents_;
+		std::vector<float4x4, aligned_allocator<float4x4, 16>> locals_;
+		std::vector<float4x4, aligned_allocator<float4x4, 16>> worlds_;
+		std::vector<float4, aligned_allocator<float4, 16>> local_bounds_;
+		std::vector<float4, aligned_allocator<float4, 16>> world_bounds_;
+		std::vector<uint8_t> dirty_;
+
+		// Where each depth level ends
+		std::vector<uint32_t> level_ends_;
+		bool sorted_;
+		// The smallest depth of dirty nodes, or INVALID_NODE if none is dirty
+		std::atomic<uint32_t> min_dirty_depth_;
+
+		std::vector<uint32_t> updated_nodes_;
+	};
+}
+
+#endif		// _KLAYGE_TRANSFORM_HIERARCHY_HPP
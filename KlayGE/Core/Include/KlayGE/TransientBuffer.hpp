@@ -80,10 +80,13 @@ namespace KlayGE
 	public:
 		TransientBuffer(uint32_t size_in_byte, BindFlag bind_flag);
 
-		// Allocate a sub space from transient buffer
-		SubAlloc Alloc(uint32_t size_in_byte, void const * data);
+		// Allocate a sub space from transient buffer. The offset is a multiple of alignment, which doesn't need to be
+		//  a power of 2, so the sub space can be addressed in elements, like instances in an instance stream.
+		SubAlloc Alloc(uint32_t size_in_byte, void const * data, uint32_t alignment = 1);
 		// Knowtify transient buffer that this alloc is unused and will be freed at the end of the frame.
 		void Dealloc(SubAlloc const & alloc);
+		// Uploads what was allocated since the last call, so calling it after every Alloc costs no more than calling
+		//  it once.
 		void EnsureDataReady();
 		// Do with retired frames
 		void OnPresent();
@@ -110,6 +113,9 @@ namespace KlayGE
 		std::vector<uint8_t> simulate_buffer_;
 		uint32_t valid_min_;
 		uint32_t valid_max_;
+		// The part of simulate_buffer_ that is newer than buffer_
+		uint32_t dirty_min_;
+		uint32_t dirty_max_;
 	};
 }
 
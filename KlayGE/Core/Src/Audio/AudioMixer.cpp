@@ -0,0 +1,861 @@
+/**
+ * @file AudioMixer.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/ErrorHandling.hpp>
+#include <KFL/Math.hpp>
+#include <KFL/Util.hpp>
+#include <KlayGE/Context.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+
+#if defined(KLAYGE_SSE2_SUPPORT) && !defined(KLAYGE_COMPILER_CLANGC2)
+#define AUDIO_MIXER_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <KlayGE/AudioMixer.hpp>
+
+namespace
+{
+	using namespace KlayGE;
+
+	// Zeros after the data, so the interpolation can always read one frame ahead
+	uint32_t const GUARD_FRAMES = 2;
+
+	uint32_t NumChannels(AudioFormat format)
+	{
+		return ((AF_Stereo8 == format) || (AF_Stereo16 == format)) ? 2 : 1;
+	}
+
+	uint32_t SampleBytes(AudioFormat format)
+	{
+		return ((AF_Mono8 == format) || (AF_Stereo8 == format)) ? 1 : 2;
+	}
+
+	uint32_t DecodeFrames(AudioDataSource& source, AudioFormat format, std::vector<uint8_t>& tmp,
+		float* dst, uint32_t max_frames)
+	{
+		uint32_t const channels = NumChannels(format);
+		uint32_t const sample_bytes = SampleBytes(format);
+		uint32_t const frame_bytes = channels * sample_bytes;
+
+		tmp.resize(max_frames * frame_bytes);
+		size_t const read = source.Read(tmp.data(), tmp.size());
+		uint32_t const num_frames = static_cast<uint32_t>(read / frame_bytes);
+		uint32_t const num_samples = num_frames * channels;
+		if (1 == sample_bytes)
+		{
+			// 8-bit PCM is unsigned
+			for (uint32_t i = 0; i < num_samples; ++ i)
+			{
+				dst[i] = (static_cast<int>(tmp[i]) - 128) / 128.0f;
+			}
+		}
+		else
+		{
+			for (uint32_t i = 0; i < num_samples; ++ i)
+			{
+				int16_t s;
+				std::memcpy(&s, &tmp[i * 2], sizeof(s));
+				dst[i] = LE2Native(s) / 32768.0f;
+			}
+		}
+		return num_frames;
+	}
+
+	// Adds num_frames frames to the interleaved stereo out, resampled linearly from src starting at frac,
+	//  advancing step source frames per frame.
+	void MixMono(float* out, uint32_t num_frames, float const * src, float frac, float step, float gain_l, float gain_r)
+	{
+		uint32_t i = 0;
+#ifdef AUDIO_MIXER_SSE2
+		__m128 const v_frac = _mm_set1_ps(frac);
+		__m128 const v_step = _mm_set1_ps(step);
+		__m128 const v_gain_l = _mm_set1_ps(gain_l);
+		__m128 const v_gain_r = _mm_set1_ps(gain_r);
+		__m128 v_i = _mm_setr_ps(0, 1, 2, 3);
+		__m128 const v_four = _mm_set1_ps(4);
+		for (; i + 4 <= num_frames; i += 4)
+		{
+			__m128 const pos = _mm_add_ps(v_frac, _mm_mul_ps(v_i, v_step));
+			__m128i const idx = _mm_cvttps_epi32(pos);
+			__m128 const t = _mm_sub_ps(pos, _mm_cvtepi32_ps(idx));
+
+			alignas(16) int32_t indices[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(indices), idx);
+			__m128 const s0 = _mm_setr_ps(src[indices[0]], src[indices[1]], src[indices[2]], src[indices[3]]);
+			__m128 const s1 = _mm_setr_ps(src[indices[0] + 1], src[indices[1] + 1], src[indices[2] + 1], src[indices[3] + 1]);
+			__m128 const s = _mm_add_ps(s0, _mm_mul_ps(_mm_sub_ps(s1, s0), t));
+
+			__m128 const l = _mm_mul_ps(s, v_gain_l);
+			__m128 const r = _mm_mul_ps(s, v_gain_r);
+			float* dst = out + i * 2;
+			_mm_storeu_ps(dst + 0, _mm_add_ps(_mm_loadu_ps(dst + 0), _mm_unpacklo_ps(l, r)));
+			_mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_unpackhi_ps(l, r)));
+
+			v_i = _mm_add_ps(v_i, v_four);
+		}
+#endif
+		for (; i < num_frames; ++ i)
+		{
+			float const pos = frac + i * step;
+			uint32_t const idx = static_cast<uint32_t>(pos);
+			float const t = pos - idx;
+			float const s = src[idx] + (src[idx + 1] - src[idx]) * t;
+			out[i * 2 + 0] += s * gain_l;
+			out[i * 2 + 1] += s * gain_r;
+		}
+	}
+
+	void MixStereo(float* out, uint32_t num_frames, float const * src, float frac, float step, float gain_l, float gain_r)
+	{
+		uint32_t i = 0;
+#ifdef AUDIO_MIXER_SSE2
+		__m128 const v_frac = _mm_set1_ps(frac);
+		__m128 const v_step = _mm_set1_ps(step);
+		__m128 const v_gain_l = _mm_set1_ps(gain_l);
+		__m128 const v_gain_r = _mm_set1_ps(gain_r);
+		__m128 v_i = _mm_setr_ps(0, 1, 2, 3);
+		__m128 const v_four = _mm_set1_ps(4);
+		for (; i + 4 <= num_frames; i += 4)
+		{
+			__m128 const pos = _mm_add_ps(v_frac, _mm_mul_ps(v_i, v_step));
+			__m128i const idx = _mm_cvttps_epi32(pos);
+			__m128 const t = _mm_sub_ps(pos, _mm_cvtepi32_ps(idx));
+
+			alignas(16) int32_t indices[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_add_epi32(idx, idx));
+			__m128 const l0 = _mm_setr_ps(src[indices[0] + 0], src[indices[1] + 0], src[indices[2] + 0], src[indices[3] + 0]);
+			__m128 const r0 = _mm_setr_ps(src[indices[0] + 1], src[indices[1] + 1], src[indices[2] + 1], src[indices[3] + 1]);
+			__m128 const l1 = _mm_setr_ps(src[indices[0] + 2], src[indices[1] + 2], src[indices[2] + 2], src[indices[3] + 2]);
+			__m128 const r1 = _mm_setr_ps(src[indices[0] + 3], src[indices[1] + 3], src[indices[2] + 3], src[indices[3] + 3]);
+
+			__m128 const l = _mm_mul_ps(_mm_add_ps(l0, _mm_mul_ps(_mm_sub_ps(l1, l0), t)), v_gain_l);
+			__m128 const r = _mm_mul_ps(_mm_add_ps(r0, _mm_mul_ps(_mm_sub_ps(r1, r0), t)), v_gain_r);
+			float* dst = out + i * 2;
+			_mm_storeu_ps(dst + 0, _mm_add_ps(_mm_loadu_ps(dst + 0), _mm_unpacklo_ps(l, r)));
+			_mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_unpackhi_ps(l, r)));
+
+			v_i = _mm_add_ps(v_i, v_four);
+		}
+#endif
+		for (; i < num_frames; ++ i)
+		{
+			float const pos = frac + i * step;
+			uint32_t const idx = static_cast<uint32_t>(pos);
+			float const t = pos - idx;
+			float const * s0 = &src[idx * 2];
+			out[i * 2 + 0] += (s0[0] + (s0[2] - s0[0]) * t) * gain_l;
+			out[i * 2 + 1] += (s0[1] + (s0[3] - s0[1]) * t) * gain_r;
+		}
+	}
+
+	template <typename T>
+	void WriteLE(std::ostream& os, T v)
+	{
+		v = Native2LE(v);
+		os.write(reinterpret_cast<char const *>(&v), sizeof(v));
+	}
+}
+
+namespace KlayGE
+{
+	// Decoded whole, shared by a voice and its clones
+	struct AudioMixer::Clip
+	{
+		AudioDataSourcePtr source;
+		AudioFormat format;
+		uint32_t channels;
+		uint32_t freq;
+		uint32_t num_frames;
+		uint32_t decoded_frames;
+		bool decoded;
+		// Seconds of decoded data left before the most urgent voice playing it runs out
+		float urgency;
+		std::vector<float> samples;
+	};
+
+	struct AudioMixer::Voice
+	{
+		std::atomic<bool> playing;
+
+		// Guarded by mutex_
+		bool destroyed;
+		bool rewind;
+		bool loop;
+		float volume;
+		float3 pos;
+
+		// Only touched by Mix
+		std::shared_ptr<Clip> clip;
+		AudioDataSourcePtr source;
+		AudioFormat format;
+		uint32_t channels;
+		uint32_t freq;
+		std::vector<float> stream_buf;
+		uint32_t stream_capacity;
+		uint32_t stream_frames;
+		bool stream_ended;
+		bool reset_source;
+		double cursor;
+
+		bool mix_loop;
+		float mix_volume;
+		float3 mix_pos;
+	};
+
+
+	AudioSink::AudioSink(uint32_t sample_rate)
+		: sample_rate_(sample_rate)
+	{
+	}
+
+	AudioSink::~AudioSink()
+	{
+	}
+
+
+	NullAudioSink::NullAudioSink(uint32_t sample_rate)
+		: AudioSink(sample_rate), num_frames_(0)
+	{
+	}
+
+	void NullAudioSink::Write(float const * samples, uint32_t num_frames)
+	{
+		KFL_UNUSED(samples);
+		num_frames_ += num_frames;
+	}
+
+
+	WavFileAudioSink::WavFileAudioSink(std::string const & path, uint32_t sample_rate)
+		: AudioSink(sample_rate), file_(path.c_str(), std::ios_base::binary), data_size_(0)
+	{
+		if (!file_)
+		{
+			TERRC(std::errc::io_error);
+		}
+
+		file_.write("RIFF", 4);
+		WriteLE<uint32_t>(file_, 36);
+		file_.write("WAVEfmt ", 8);
+		WriteLE<uint32_t>(file_, 16);
+		WriteLE<uint16_t>(file_, 1);
+		WriteLE<uint16_t>(file_, 2);
+		WriteLE<uint32_t>(file_, sample_rate);
+		WriteLE<uint32_t>(file_, sample_rate * 4);
+		WriteLE<uint16_t>(file_, 4);
+		WriteLE<uint16_t>(file_, 16);
+		file_.write("data", 4);
+		WriteLE<uint32_t>(file_, 0);
+	}
+
+	WavFileAudioSink::~WavFileAudioSink()
+	{
+		file_.seekp(4);
+		WriteLE<uint32_t>(file_, 36 + data_size_);
+		file_.seekp(40);
+		WriteLE<uint32_t>(file_, data_size_);
+	}
+
+	void WavFileAudioSink::Write(float const * samples, uint32_t num_frames)
+	{
+		pcm_.resize(num_frames * 2);
+		for (uint32_t i = 0; i < num_frames * 2; ++ i)
+		{
+			float const s = MathLib::clamp(samples[i], -1.0f, 1.0f);
+			pcm_[i] = Native2LE(static_cast<int16_t>(s * 32767 + (s < 0 ? -0.5f : 0.5f)));
+		}
+		file_.write(reinterpret_cast<char const *>(pcm_.data()), pcm_.size() * sizeof(pcm_[0]));
+		data_size_ += num_frames * 4;
+	}
+
+
+	AudioMixer::AudioMixer(AudioSinkPtr const & sink)
+		: sink_(sink),
+			listener_pos_(0, 0, 0), listener_face_(0, 0, 1), listener_up_(0, 1, 0),
+			mix_buf_(BLOCK_FRAMES * 2), mixed_frames_(0),
+			thread_running_(false), thread_quit_(false)
+	{
+	}
+
+	AudioMixer::~AudioMixer()
+	{
+		this->StopThread();
+	}
+
+	void AudioMixer::Sink(AudioSinkPtr const & sink)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		sink_ = sink;
+	}
+
+	AudioSinkPtr AudioMixer::Sink() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return sink_;
+	}
+
+	void AudioMixer::StartThread()
+	{
+		if (!thread_running_)
+		{
+			thread_quit_ = false;
+			thread_ = Context::Instance().ThreadPool()(std::bind(&AudioMixer::ThreadFunc, this));
+			thread_running_ = true;
+		}
+	}
+
+	void AudioMixer::StopThread()
+	{
+		if (thread_running_)
+		{
+			{
+				std::lock_guard<std::mutex> lock(thread_mutex_);
+				thread_quit_ = true;
+			}
+			thread_cv_.notify_all();
+			thread_();
+			thread_running_ = false;
+		}
+	}
+
+	uint32_t AudioMixer::CreateVoice(AudioDataSourcePtr const & source, bool streamed, uint32_t buffer_seconds)
+	{
+		auto voice = MakeUniquePtr<Voice>();
+		voice->playing = false;
+		voice->destroyed = false;
+		voice->rewind = false;
+		voice->loop = false;
+		voice->volume = 1;
+		voice->pos = float3(0, 0, 0);
+		voice->format = source->Format();
+		voice->channels = NumChannels(voice->format);
+		voice->freq = source->Freq();
+		voice->stream_capacity = 0;
+		voice->stream_frames = 0;
+		voice->stream_ended = false;
+		voice->reset_source = false;
+		voice->cursor = 0;
+
+		std::shared_ptr<Clip> clip;
+		if (streamed)
+		{
+			voice->source = source;
+			voice->stream_capacity = std::max(buffer_seconds, 1U) * voice->freq;
+			voice->stream_buf.assign((voice->stream_capacity + GUARD_FRAMES) * voice->channels, 0.0f);
+		}
+		else
+		{
+			clip = MakeSharedPtr<Clip>();
+			clip->source = source;
+			clip->format = voice->format;
+			clip->channels = voice->channels;
+			clip->freq = voice->freq;
+			clip->num_frames = static_cast<uint32_t>(source->Size() / (clip->channels * SampleBytes(clip->format)));
+			clip->decoded_frames = 0;
+			clip->decoded = (0 == clip->num_frames);
+			clip->urgency = 0;
+			clip->samples.assign((clip->num_frames + GUARD_FRAMES) * clip->channels, 0.0f);
+			voice->clip = clip;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (clip && !clip->decoded)
+		{
+			pending_clips_.push_back(clip);
+		}
+
+		uint32_t id;
+		if (free_voices_.empty())
+		{
+			id = static_cast<uint32_t>(voices_.size());
+			voices_.push_back(std::move(voice));
+		}
+		else
+		{
+			id = free_voices_.back();
+			free_voices_.pop_back();
+			voices_[id] = std::move(voice);
+		}
+		return id;
+	}
+
+	uint32_t AudioMixer::CloneVoice(uint32_t voice)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		Voice const & src = *voices_[voice];
+		BOOST_ASSERT(src.clip);
+
+		auto clone = MakeUniquePtr<Voice>();
+		clone->playing = false;
+		clone->destroyed = false;
+		clone->rewind = false;
+		clone->loop = false;
+		clone->volume = src.volume;
+		clone->pos = src.pos;
+		clone->clip = src.clip;
+		clone->format = src.format;
+		clone->channels = src.channels;
+		clone->freq = src.freq;
+		clone->stream_capacity = 0;
+		clone->stream_frames = 0;
+		clone->stream_ended = false;
+		clone->reset_source = false;
+		clone->cursor = 0;
+
+		uint32_t id;
+		if (free_voices_.empty())
+		{
+			id = static_cast<uint32_t>(voices_.size());
+			voices_.push_back(std::move(clone));
+		}
+		else
+		{
+			id = free_voices_.back();
+			free_voices_.pop_back();
+			voices_[id] = std::move(clone);
+		}
+		return id;
+	}
+
+	void AudioMixer::DestroyVoice(uint32_t voice)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			voices_[voice]->playing = false;
+			voices_[voice]->destroyed = true;
+		}
+		{
+			std::lock_guard<std::mutex> lock(source_mutex_);
+		}
+	}
+
+	void AudioMixer::Play(uint32_t voice, bool loop)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		Voice& v = *voices_[voice];
+		v.loop = loop;
+		v.rewind = true;
+		v.playing = true;
+	}
+
+	void AudioMixer::Stop(uint32_t voice)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			Voice& v = *voices_[voice];
+			v.playing = false;
+			v.rewind = true;
+		}
+		{
+			// Waits for a read of the source in progress
+			std::lock_guard<std::mutex> lock(source_mutex_);
+		}
+	}
+
+	bool AudioMixer::IsPlaying(uint32_t voice) const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return voices_[voice]->playing;
+	}
+
+	void AudioMixer::Volume(uint32_t voice, float vol)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		voices_[voice]->volume = vol;
+	}
+
+	void AudioMixer::Position(uint32_t voice, float3 const & pos)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		voices_[voice]->pos = pos;
+	}
+
+	void AudioMixer::ListenerPos(float3 const & pos)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		listener_pos_ = pos;
+	}
+
+	void AudioMixer::ListenerOri(float3 const & face, float3 const & up)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		listener_face_ = face;
+		listener_up_ = up;
+	}
+
+	uint32_t AudioMixer::NumPlayingVoices() const
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		uint32_t num = 0;
+		for (auto const & voice : voices_)
+		{
+			if (voice && voice->playing)
+			{
+				++ num;
+			}
+		}
+		return num;
+	}
+
+	void AudioMixer::Mix()
+	{
+		AudioSinkPtr sink;
+		float3 listener_pos;
+		float3 listener_right;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+
+			sink = sink_;
+			listener_pos = listener_pos_;
+			listener_right = MathLib::normalize(MathLib::cross(listener_up_, listener_face_));
+
+			active_voices_.clear();
+			for (uint32_t i = 0; i < voices_.size(); ++ i)
+			{
+				Voice* voice = voices_[i].get();
+				if (!voice)
+				{
+					continue;
+				}
+				if (voice->destroyed)
+				{
+					voices_[i].reset();
+					free_voices_.push_back(i);
+					continue;
+				}
+
+				if (voice->rewind)
+				{
+					voice->rewind = false;
+					voice->cursor = 0;
+					if (voice->source)
+					{
+						voice->stream_frames = 0;
+						voice->stream_ended = false;
+						voice->reset_source = true;
+					}
+				}
+				if (voice->playing)
+				{
+					voice->mix_loop = voice->loop;
+					voice->mix_volume = voice->volume;
+					voice->mix_pos = voice->pos;
+					active_voices_.push_back(voice);
+				}
+			}
+
+			pending_clips_.erase(std::remove_if(pending_clips_.begin(), pending_clips_.end(),
+				[](std::shared_ptr<Clip> const & clip)
+				{
+					return clip->decoded;
+				}), pending_clips_.end());
+			decoding_clips_ = pending_clips_;
+		}
+
+		this->ServiceStreams();
+
+		std::fill(mix_buf_.begin(), mix_buf_.end(), 0.0f);
+		uint32_t const sample_rate = sink ? sink->SampleRate() : 48000;
+		std::vector<Voice*> finished;
+		for (auto* voice : active_voices_)
+		{
+			if (this->MixVoice(*voice, listener_pos, listener_right, sample_rate))
+			{
+				finished.push_back(voice);
+			}
+		}
+
+		if (!finished.empty())
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			for (auto* voice : finished)
+			{
+				// Unless it's been played again meanwhile
+				if (!voice->rewind)
+				{
+					voice->playing = false;
+				}
+			}
+		}
+
+		if (sink)
+		{
+			sink->Write(mix_buf_.data(), BLOCK_FRAMES);
+		}
+		mixed_frames_ += BLOCK_FRAMES;
+	}
+
+	void AudioMixer::ServiceStreams()
+	{
+		struct Request
+		{
+			float urgency;
+			Voice* voice;
+			Clip* clip;
+
+			bool operator<(Request const & rhs) const
+			{
+				// The least data left on top
+				return urgency > rhs.urgency;
+			}
+		};
+
+		// Clips nothing is playing yet are decoded after anything with less than a second left
+		for (auto const & clip : decoding_clips_)
+		{
+			clip->urgency = 1;
+		}
+
+		std::priority_queue<Request> queue;
+		for (auto* voice : active_voices_)
+		{
+			if (voice->clip)
+			{
+				Clip& clip = *voice->clip;
+				if (!clip.decoded)
+				{
+					float const left = static_cast<float>((clip.decoded_frames - voice->cursor) / clip.freq);
+					clip.urgency = std::min(clip.urgency, left);
+				}
+			}
+			else if (!voice->stream_ended)
+			{
+				double const buffered = voice->stream_frames - voice->cursor;
+				if (voice->reset_source || (buffered < voice->stream_capacity * 3 / 4))
+				{
+					queue.push({ static_cast<float>(buffered / voice->freq), voice, nullptr });
+				}
+			}
+		}
+		for (auto const & clip : decoding_clips_)
+		{
+			queue.push({ clip->urgency, nullptr, clip.get() });
+		}
+
+		uint32_t budget = DECODE_FRAMES_PER_BLOCK;
+		while (!queue.empty() && (budget > 0))
+		{
+			Request const req = queue.top();
+			queue.pop();
+
+			if (req.clip)
+			{
+				Clip& clip = *req.clip;
+				uint32_t decoded = 0;
+				uint32_t const max_frames = std::min(clip.num_frames - clip.decoded_frames, budget);
+				{
+					std::lock_guard<std::mutex> lock(source_mutex_);
+					decoded = DecodeFrames(*clip.source, clip.format, decode_buf_,
+						&clip.samples[clip.decoded_frames * clip.channels], max_frames);
+				}
+				clip.decoded_frames += decoded;
+				if ((0 == decoded) || (clip.decoded_frames == clip.num_frames))
+				{
+					// A source shorter than its Size() is cut short
+					clip.num_frames = clip.decoded_frames;
+					std::fill(clip.samples.begin() + clip.num_frames * clip.channels, clip.samples.end(), 0.0f);
+					clip.decoded = true;
+				}
+				budget -= std::min(budget, std::max(decoded, 1U));
+			}
+			else
+			{
+				Voice& voice = *req.voice;
+
+				// Moves what hasn't been played to the front
+				uint32_t const consumed = static_cast<uint32_t>(voice.cursor);
+				if (consumed > 0)
+				{
+					std::memmove(&voice.stream_buf[0], &voice.stream_buf[consumed * voice.channels],
+						(voice.stream_frames - consumed) * voice.channels * sizeof(float));
+					voice.stream_frames -= consumed;
+					voice.cursor -= consumed;
+				}
+
+				uint32_t const max_frames = std::min(voice.stream_capacity - voice.stream_frames, budget);
+				uint32_t decoded = 0;
+				{
+					std::lock_guard<std::mutex> lock(source_mutex_);
+					if (!voice.playing)
+					{
+						continue;
+					}
+
+					if (voice.reset_source)
+					{
+						voice.source->Reset();
+						voice.reset_source = false;
+					}
+
+					float* dst = &voice.stream_buf[voice.stream_frames * voice.channels];
+					decoded = DecodeFrames(*voice.source, voice.format, decode_buf_, dst, max_frames);
+					if ((0 == decoded) && (max_frames > 0))
+					{
+						if (voice.mix_loop)
+						{
+							voice.source->Reset();
+							decoded = DecodeFrames(*voice.source, voice.format, decode_buf_, dst, max_frames);
+						}
+						if (0 == decoded)
+						{
+							voice.stream_ended = true;
+						}
+					}
+				}
+				voice.stream_frames += decoded;
+				if (voice.stream_ended)
+				{
+					std::fill(voice.stream_buf.begin() + voice.stream_frames * voice.channels, voice.stream_buf.end(), 0.0f);
+				}
+				budget -= std::min(budget, std::max(decoded, 1U));
+			}
+		}
+	}
+
+	bool AudioMixer::MixVoice(Voice& voice, float3 const & listener_pos, float3 const & listener_right, uint32_t sample_rate)
+	{
+		float gain_l = voice.mix_volume;
+		float gain_r = voice.mix_volume;
+		if (1 == voice.channels)
+		{
+			// Inverse distance beyond 1 unit, and equal-power panning on the listener's left-right axis
+			float3 const dir = voice.mix_pos - listener_pos;
+			float const dist = MathLib::length(dir);
+			float const attenuation = (dist > 1) ? 1 / dist : 1;
+			float const x = (dist > 1e-4f) ? MathLib::clamp(MathLib::dot(dir, listener_right) / dist, -1.0f, 1.0f) : 0;
+			float const angle = (x + 1) * PI / 4;
+			gain_l *= attenuation * MathLib::cos(angle);
+			gain_r *= attenuation * MathLib::sin(angle);
+		}
+
+		double const step = static_cast<double>(voice.freq) / sample_rate;
+		uint32_t out_frame = 0;
+		while (out_frame < BLOCK_FRAMES)
+		{
+			// Frames before end can be played. Positions before limit have the next frame decoded to interpolate with.
+			float const * data;
+			double limit;
+			double end;
+			if (voice.clip)
+			{
+				Clip const & clip = *voice.clip;
+				data = clip.samples.data();
+				end = clip.num_frames;
+				limit = clip.decoded ? end : clip.decoded_frames - 1.0;
+			}
+			else
+			{
+				data = voice.stream_buf.data();
+				if (voice.stream_ended)
+				{
+					end = voice.stream_frames;
+					limit = end;
+				}
+				else
+				{
+					end = std::numeric_limits<double>::max();
+					limit = voice.stream_frames - 1.0;
+				}
+			}
+
+			if (voice.cursor >= end)
+			{
+				if (voice.clip && voice.mix_loop && (end > 0))
+				{
+					voice.cursor = std::fmod(voice.cursor, end);
+					continue;
+				}
+				return true;
+			}
+
+			double const room = std::min(limit, end) - voice.cursor;
+			if (room <= 0)
+			{
+				// Not decoded yet. Plays silence rather than waiting.
+				break;
+			}
+
+			uint32_t const num_frames = std::min(BLOCK_FRAMES - out_frame, static_cast<uint32_t>(std::ceil(room / step)));
+			uint32_t const base = static_cast<uint32_t>(voice.cursor);
+			float const frac = static_cast<float>(voice.cursor - base);
+			float* out = &mix_buf_[out_frame * 2];
+			if (1 == voice.channels)
+			{
+				MixMono(out, num_frames, data + base, frac, static_cast<float>(step), gain_l, gain_r);
+			}
+			else
+			{
+				MixStereo(out, num_frames, data + base * 2, frac, static_cast<float>(step), gain_l, gain_r);
+			}
+
+			voice.cursor += num_frames * step;
+			out_frame += num_frames;
+		}
+
+		return false;
+	}
+
+	void AudioMixer::ThreadFunc()
+	{
+		auto const start_time = std::chrono::steady_clock::now();
+		uint64_t const start_frames = mixed_frames_;
+
+		std::unique_lock<std::mutex> lock(thread_mutex_);
+		while (!thread_quit_)
+		{
+			lock.unlock();
+
+			AudioSinkPtr const sink = this->Sink();
+			uint32_t const sample_rate = sink ? sink->SampleRate() : 48000;
+			double const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+			uint64_t const target = start_frames + static_cast<uint64_t>(elapsed * sample_rate) + BLOCK_FRAMES * LATENCY_BLOCKS;
+			while (mixed_frames_ < target)
+			{
+				this->Mix();
+			}
+
+			lock.lock();
+			thread_cv_.wait_for(lock, std::chrono::microseconds(1000000ULL * BLOCK_FRAMES / sample_rate),
+				[this]
+				{
+					return thread_quit_;
+				});
+		}
+	}
+}
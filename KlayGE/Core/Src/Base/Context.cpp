@@ -36,6 +36,7 @@
 #include <KlayGE/DeferredRenderingLayer.hpp>
 #include <KFL/Thread.hpp>
 #include <KlayGE/PerfProfiler.hpp>
+#include <KlayGE/TextureStreaming.hpp>
 #include <KlayGE/UI.hpp>
 #include <KFL/Hash.hpp>
 
@@ -102,6 +103,7 @@ namespace KlayGE
 #endif
 
 		gtp_instance_ = MakeUniquePtr<thread_pool>(1, 16);
+		task_scheduler_instance_ = MakeUniquePtr<task_scheduler>();
 	}
 
 	Context::~Context()
@@ -113,6 +115,7 @@ namespace KlayGE
 		scene_mgr_.reset();
 
 		ResLoader::Destroy();
+		TextureStreamingManager::Destroy();
 		PerfProfiler::Destroy();
 		UIManager::Destroy();
 
@@ -126,6 +129,7 @@ namespace KlayGE
 
 		app_ = nullptr;
 
+		task_scheduler_instance_.reset();
 		gtp_instance_.reset();
 	}
 
@@ -236,6 +240,7 @@ namespace KlayGE
 
 	void Context::LoadCfg(std::string const & cfg_file)
 	{
+		// SoftAudio has no device output yet, so it's loaded explicitly instead of being listed here
 #if defined(KLAYGE_PLATFORM_WINDOWS_DESKTOP)
 		static char const * available_rfs_array[] = { "D3D11", "OpenGL", "OpenGLES", "D3D12" };
 		static char const * available_afs_array[] = { "OpenAL", "DSound", "XAudio" };
@@ -33,7 +33,9 @@
 #include <KlayGE/RenderEngine.hpp>
 #include <KlayGE/Query.hpp>
 #include <KFL/Thread.hpp>
+#include <KFL/ErrorHandling.hpp>
 
+#include <algorithm>
 #include <fstream>
 
 #include <KlayGE/PerfProfiler.hpp>
@@ -41,14 +43,44 @@
 namespace
 {
 	std::mutex singleton_mutex;
+
+	// Bumped for every profiler
+	std::atomic<uint32_t> profiler_generation(0);
+
+	// The profilers alive, for the threads that exit to find where their traces go
+	std::mutex live_profilers_mutex;
+	std::vector<KlayGE::PerfProfiler*> live_profilers;
+
+	std::string EscapeJson(char const * str)
+	{
+		std::string ret;
+		for (; *str; ++ str)
+		{
+			char const ch = *str;
+			if (('"' == ch) || ('\\' == ch))
+			{
+				ret += '\\';
+				ret += ch;
+			}
+			else if (static_cast<unsigned char>(ch) < 0x20)
+			{
+				ret += ' ';
+			}
+			else
+			{
+				ret += ch;
+			}
+		}
+		return ret;
+	}
 }
 
 namespace KlayGE
 {
 	std::unique_ptr<PerfProfiler> PerfProfiler::perf_profiler_instance_;
 
-	PerfRange::PerfRange()
-		: cpu_time_(0), gpu_time_(0), dirty_(false)
+	PerfRange::PerfRange(char const * name)
+		: name_(name), cpu_time_(0), gpu_time_(0), dirty_(false)
 	{
 		RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 		gpu_timer_query_ = rf.MakeTimerQuery();
@@ -59,6 +91,7 @@ namespace KlayGE
 		if (Context::Instance().Config().perf_profiler)
 		{
 			dirty_ = true;
+			PerfProfiler::Instance().BeginEvent(name_);
 			cpu_timer_.restart();
 			if (gpu_timer_query_)
 			{
@@ -76,6 +109,7 @@ namespace KlayGE
 			{
 				gpu_timer_query_->End();
 			}
+			PerfProfiler::Instance().EndEvent();
 		}
 	}
 
@@ -108,8 +142,18 @@ namespace KlayGE
 
 
 	PerfProfiler::PerfProfiler()
-		: frame_id_(0)
+		: frame_id_(0),
+			tracing_(Context::Instance().Config().perf_profiler), generation_(++ profiler_generation),
+			start_time_(std::chrono::steady_clock::now()), next_flow_id_(0), next_tid_(0)
 	{
+		std::lock_guard<std::mutex> lock(live_profilers_mutex);
+		live_profilers.push_back(this);
+	}
+
+	PerfProfiler::~PerfProfiler()
+	{
+		std::lock_guard<std::mutex> lock(live_profilers_mutex);
+		live_profilers.erase(std::find(live_profilers.begin(), live_profilers.end(), this));
 	}
 
 	PerfProfiler& PerfProfiler::Instance()
@@ -141,10 +185,14 @@ namespace KlayGE
 
 	PerfRangePtr PerfProfiler::CreatePerfRange(int category, std::string const & name)
 	{
-		PerfRangePtr range = MakeSharedPtr<PerfRange>();
-		typedef std::remove_reference<decltype(std::get<3>(perf_ranges_[0]))>::type PerfDataType;
-		perf_ranges_.push_back(std::make_tuple(category, name, range, PerfDataType()));
-		return range;
+		PerfRangeRecord record;
+		record.category = category;
+		record.name = name;
+		record.gpu_counter_name = this->InternName("GPU " + name);
+		record.range = MakeSharedPtr<PerfRange>(this->InternName(name));
+		record.num_samples = 0;
+		perf_ranges_.push_back(std::move(record));
+		return perf_ranges_.back().range;
 	}
 
 	void PerfProfiler::CollectData()
@@ -155,13 +203,27 @@ namespace KlayGE
 			RenderEngine& re = rf.RenderEngineInstance();
 			re.UpdateGPUTimestampsFrequency();
 
-			for (auto& range : perf_ranges_)
+			for (auto& record : perf_ranges_)
 			{
-				if (std::get<2>(range)->Dirty())
+				if (record.range->Dirty())
 				{
-					std::get<2>(range)->CollectData();
-					std::get<3>(range).push_back(std::make_tuple(frame_id_,
-						std::get<2>(range)->CPUTime(), std::get<2>(range)->GPUTime()));
+					record.range->CollectData();
+
+					auto sample = std::make_tuple(frame_id_, record.range->CPUTime(), record.range->GPUTime());
+					if (record.samples.size() < MAX_FRAMES)
+					{
+						record.samples.push_back(sample);
+					}
+					else
+					{
+						record.samples[record.num_samples % MAX_FRAMES] = sample;
+					}
+					++ record.num_samples;
+
+					if (std::get<2>(sample) >= 0)
+					{
+						this->Counter(record.gpu_counter_name, std::get<2>(sample) * 1000);
+					}
 				}
 			}
 
@@ -169,6 +231,170 @@ namespace KlayGE
 		}
 	}
 
+	void PerfProfiler::Tracing(bool tracing)
+	{
+		tracing_ = tracing;
+	}
+
+	bool PerfProfiler::Tracing() const
+	{
+		return tracing_;
+	}
+
+	void PerfProfiler::BeginEvent(char const * name)
+	{
+		this->Record(TET_Begin, name, 0, 0);
+	}
+
+	void PerfProfiler::EndEvent()
+	{
+		this->Record(TET_End, nullptr, 0, 0);
+	}
+
+	void PerfProfiler::Counter(char const * name, double value)
+	{
+		this->Record(TET_Counter, name, 0, value);
+	}
+
+	uint64_t PerfProfiler::FlowBegin(char const * name)
+	{
+		uint64_t const id = ++ next_flow_id_;
+		this->Record(TET_FlowBegin, name, id, 0);
+		return id;
+	}
+
+	void PerfProfiler::FlowStep(char const * name, uint64_t id)
+	{
+		this->Record(TET_FlowStep, name, id, 0);
+	}
+
+	void PerfProfiler::FlowEnd(char const * name, uint64_t id)
+	{
+		this->Record(TET_FlowEnd, name, id, 0);
+	}
+
+	void PerfProfiler::ThreadName(std::string const & name)
+	{
+		char const * interned = this->InternName(name);
+		ThreadTrace& trace = this->CurrentThreadTrace();
+
+		std::lock_guard<std::mutex> lock(trace_mutex_);
+		trace.name = interned;
+	}
+
+	char const * PerfProfiler::InternName(std::string const & name)
+	{
+		std::lock_guard<std::mutex> lock(trace_mutex_);
+		return interned_names_.insert(name).first->c_str();
+	}
+
+	uint32_t PerfProfiler::NumThreadTraces() const
+	{
+		std::lock_guard<std::mutex> lock(trace_mutex_);
+		return static_cast<uint32_t>(thread_traces_.size());
+	}
+
+	PerfProfiler::ThreadTrace& PerfProfiler::CurrentThreadTrace()
+	{
+		// Threads outlive profilers, the generation tells if the trace is from this one
+		thread_local ThreadTraceOwner tls_owner;
+
+		uint32_t const generation = generation_.load(std::memory_order_relaxed);
+		if (tls_owner.generation != generation)
+		{
+			if (tls_owner.trace != nullptr)
+			{
+				RetireThreadTrace(tls_owner.generation, tls_owner.trace);
+			}
+			tls_owner.trace = this->AcquireThreadTrace();
+			tls_owner.generation = generation;
+		}
+
+		return *tls_owner.trace;
+	}
+
+	PerfProfiler::ThreadTrace* PerfProfiler::AcquireThreadTrace()
+	{
+		{
+			std::lock_guard<std::mutex> lock(trace_mutex_);
+			if (!free_thread_traces_.empty())
+			{
+				// Drops the events of the thread that exited. The head keeps going, so the slots it left can't be
+				//  taken for new events.
+				ThreadTrace* trace = free_thread_traces_.back();
+				free_thread_traces_.pop_back();
+				trace->tid = next_tid_;
+				++ next_tid_;
+				trace->name = nullptr;
+				trace->first = trace->head.load(std::memory_order_relaxed);
+				return trace;
+			}
+		}
+
+		auto trace = MakeUniquePtr<ThreadTrace>();
+		trace->name = nullptr;
+		trace->head = 0;
+		trace->first = 0;
+		trace->slots.reset(new TraceSlot[MAX_EVENTS_PER_THREAD]);
+		for (uint32_t i = 0; i < MAX_EVENTS_PER_THREAD; ++ i)
+		{
+			trace->slots[i].seq.store(0, std::memory_order_relaxed);
+		}
+
+		std::lock_guard<std::mutex> lock(trace_mutex_);
+		trace->tid = next_tid_;
+		++ next_tid_;
+		thread_traces_.push_back(std::move(trace));
+		return thread_traces_.back().get();
+	}
+
+	void PerfProfiler::RetireThreadTrace(uint32_t generation, ThreadTrace* trace)
+	{
+		// Nothing to do if the profiler is gone, it has freed the trace
+		std::lock_guard<std::mutex> lock(live_profilers_mutex);
+		for (auto profiler : live_profilers)
+		{
+			if (profiler->generation_.load(std::memory_order_relaxed) == generation)
+			{
+				std::lock_guard<std::mutex> trace_lock(profiler->trace_mutex_);
+				profiler->free_thread_traces_.push_back(trace);
+				break;
+			}
+		}
+	}
+
+	PerfProfiler::ThreadTraceOwner::~ThreadTraceOwner()
+	{
+		if (trace != nullptr)
+		{
+			PerfProfiler::RetireThreadTrace(generation, trace);
+		}
+	}
+
+	void PerfProfiler::Record(TraceEventType type, char const * name, uint64_t id, double value)
+	{
+		if (tracing_.load(std::memory_order_relaxed))
+		{
+			ThreadTrace& trace = this->CurrentThreadTrace();
+
+			uint64_t const time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - start_time_).count();
+
+			// Only this thread writes the head and the slots
+			uint64_t const head = trace.head.load(std::memory_order_relaxed);
+			TraceSlot& slot = trace.slots[head % MAX_EVENTS_PER_THREAD];
+			slot.seq.store(head * 2 + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			slot.time.store(time, std::memory_order_relaxed);
+			slot.name.store(name, std::memory_order_relaxed);
+			slot.id.store(id, std::memory_order_relaxed);
+			slot.value.store(value, std::memory_order_relaxed);
+			slot.type.store(type, std::memory_order_relaxed);
+			slot.seq.store(head * 2 + 2, std::memory_order_release);
+			trace.head.store(head + 1, std::memory_order_release);
+		}
+	}
+
 	void PerfProfiler::ExportToCSV(std::string const & file_name) const
 	{
 		if (Context::Instance().Config().perf_profiler)
@@ -177,11 +403,14 @@ namespace KlayGE
 			ofs << "Frame" << ',' << "Category" << ',' << "Name" << ','
 				<< "CPU Timing (ms)" << ',' << "GPU Timing (ms)" << std::endl;
 
-			for (auto const & range : perf_ranges_)
+			for (auto const & record : perf_ranges_)
 			{
-				for (auto const & data : std::get<3>(range))
+				// Oldest first
+				uint32_t const start = (record.num_samples > MAX_FRAMES) ? record.num_samples % MAX_FRAMES : 0;
+				for (size_t i = 0; i < record.samples.size(); ++ i)
 				{
-					ofs << std::get<0>(data) << ',' << std::get<0>(range) << ',' << std::get<1>(range) << ','
+					auto const & data = record.samples[(start + i) % record.samples.size()];
+					ofs << std::get<0>(data) << ',' << record.category << ',' << record.name << ','
 						<< std::get<1>(data) * 1000 << ',';
 					if (std::get<2>(data) >= 0)
 					{
@@ -194,4 +423,118 @@ namespace KlayGE
 			ofs << std::endl;
 		}
 	}
+
+	void PerfProfiler::ExportToChromeTrace(std::string const & file_name) const
+	{
+		std::vector<std::tuple<uint32_t, char const *, std::vector<TraceEvent>>> threads;
+		{
+			std::lock_guard<std::mutex> lock(trace_mutex_);
+			for (auto const & trace : thread_traces_)
+			{
+				uint64_t const head = trace->head.load(std::memory_order_acquire);
+				uint64_t const first = std::max(trace->first,
+					(head > MAX_EVENTS_PER_THREAD) ? head - MAX_EVENTS_PER_THREAD : 0);
+				std::vector<TraceEvent> events;
+				events.reserve(static_cast<size_t>(head - first));
+				for (uint64_t i = first; i < head; ++ i)
+				{
+					// The ones overwritten before or while copying are dropped
+					TraceSlot const & slot = trace->slots[i % MAX_EVENTS_PER_THREAD];
+					uint64_t const seq = slot.seq.load(std::memory_order_acquire);
+					if (seq != i * 2 + 2)
+					{
+						continue;
+					}
+
+					TraceEvent event;
+					event.time = slot.time.load(std::memory_order_relaxed);
+					event.name = slot.name.load(std::memory_order_relaxed);
+					event.id = slot.id.load(std::memory_order_relaxed);
+					event.value = slot.value.load(std::memory_order_relaxed);
+					event.type = static_cast<TraceEventType>(slot.type.load(std::memory_order_relaxed));
+					std::atomic_thread_fence(std::memory_order_acquire);
+					if (slot.seq.load(std::memory_order_relaxed) == seq)
+					{
+						events.push_back(event);
+					}
+				}
+
+				threads.emplace_back(trace->tid, trace->name, std::move(events));
+			}
+		}
+
+		std::ofstream ofs(file_name.c_str());
+		ofs << std::fixed;
+		ofs.precision(3);
+		ofs << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		bool first_event = true;
+		auto begin_event = [&ofs, &first_event](char const * phase, char const * name, uint32_t tid)
+		{
+			ofs << (first_event ? "\n" : ",\n");
+			first_event = false;
+
+			ofs << "{\"ph\":\"" << phase << "\",\"pid\":1,\"tid\":" << tid;
+			if (name)
+			{
+				ofs << ",\"name\":\"" << EscapeJson(name) << '"';
+			}
+		};
+
+		for (auto const & thread : threads)
+		{
+			uint32_t const tid = std::get<0>(thread);
+			if (std::get<1>(thread))
+			{
+				begin_event("M", "thread_name", tid);
+				ofs << ",\"args\":{\"name\":\"" << EscapeJson(std::get<1>(thread)) << "\"}}";
+			}
+
+			// Ends whose begins have been overwritten are dropped
+			uint32_t depth = 0;
+			for (auto const & event : std::get<2>(thread))
+			{
+				double const ts = event.time / 1000.0;
+				switch (event.type)
+				{
+				case TET_Begin:
+					begin_event("B", event.name, tid);
+					ofs << ",\"ts\":" << ts << '}';
+					++ depth;
+					break;
+
+				case TET_End:
+					if (depth > 0)
+					{
+						begin_event("E", nullptr, tid);
+						ofs << ",\"ts\":" << ts << '}';
+						-- depth;
+					}
+					break;
+
+				case TET_Counter:
+					begin_event("C", event.name, tid);
+					ofs << ",\"ts\":" << ts << ",\"args\":{\"value\":" << event.value << "}}";
+					break;
+
+				case TET_FlowBegin:
+				case TET_FlowStep:
+				case TET_FlowEnd:
+					begin_event((TET_FlowBegin == event.type) ? "s" : ((TET_FlowStep == event.type) ? "t" : "f"), event.name, tid);
+					ofs << ",\"cat\":\"flow\",\"id\":" << event.id << ",\"ts\":" << ts;
+					if (TET_FlowEnd == event.type)
+					{
+						ofs << ",\"bp\":\"e\"";
+					}
+					ofs << '}';
+					break;
+
+				default:
+					KFL_UNREACHABLE("Invalid trace event type");
+				}
+			}
+		}
+
+		ofs << "\n]}" << std::endl;
+	}
 }
@@ -31,7 +31,9 @@
 #include <KlayGE/KlayGE.hpp>
 #include <KFL/Util.hpp>
 #include <KlayGE/Extract7z.hpp>
+#include <KlayGE/Package.hpp>
 #include <KFL/CXX17/filesystem.hpp>
+#include <KlayGE/PerfProfiler.hpp>
 
 #include <fstream>
 #include <sstream>
@@ -69,6 +71,9 @@ namespace
 {
 	std::mutex singleton_mutex;
 
+	// Old timings are dropped if nobody collects them
+	size_t const MAX_LOADING_TIMINGS = 4096;
+
 #ifdef KLAYGE_PLATFORM_ANDROID
 	class AAssetStreamBuf : public KlayGE::MemStreamBuf
 	{
@@ -97,8 +102,11 @@ namespace KlayGE
 	std::unique_ptr<ResLoader> ResLoader::res_loader_instance_;
 
 	ResLoader::ResLoader()
-		: quit_(false)
+		: num_cache_hits_(0), num_cache_misses_(0), num_cache_clones_(0),
+			loading_seq_(0), quit_(false)
 	{
+		sub_thread_stage_busy_.fill(false);
+
 #if defined KLAYGE_PLATFORM_WINDOWS
 #if defined KLAYGE_PLATFORM_WINDOWS_DESKTOP
 		char buf[MAX_PATH];
@@ -225,14 +233,13 @@ namespace KlayGE
 #endif
 #endif
 
-		loading_thread_ = MakeUniquePtr<joiner<void>>(Context::Instance().ThreadPool()(
-				std::bind(&ResLoader::LoadingThreadFunc, this)));
+		// Leave the other cores to rendering and the task scheduler
+		this->NumLoadingThreads(std::min(std::max(std::thread::hardware_concurrency() / 2, 1U), 4U));
 	}
 
 	ResLoader::~ResLoader()
 	{
-		quit_ = true;
-		(*loading_thread_)();
+		this->StopLoadingThreads();
 	}
 
 	ResLoader& ResLoader::Instance()
@@ -361,8 +368,18 @@ namespace KlayGE
 				}
 				else
 				{
-					std::string password;
 					std::string internal_name;
+					PackagePtr package = this->LocatePackage(res_name, internal_name);
+					if (package)
+					{
+						if (package->HasMember(internal_name))
+						{
+							return res_name;
+						}
+						continue;
+					}
+
+					std::string password;
 					ResIdentifierPtr pkt_file = LocatePkt(name, res_name, password, internal_name);
 					if (pkt_file && *pkt_file)
 					{
@@ -434,8 +451,19 @@ namespace KlayGE
 				}
 				else
 				{
-					std::string password;
 					std::string internal_name;
+					PackagePtr package = this->LocatePackage(res_name, internal_name);
+					if (package)
+					{
+						ResIdentifierPtr member = package->OpenMember(internal_name, name);
+						if (member)
+						{
+							return member;
+						}
+						continue;
+					}
+
+					std::string password;
 					ResIdentifierPtr pkt_file = LocatePkt(name, res_name, password, internal_name);
 					if (pkt_file && *pkt_file)
 					{
@@ -460,55 +488,51 @@ namespace KlayGE
 
 	std::shared_ptr<void> ResLoader::SyncQuery(ResLoadingDescPtr const & res_desc)
 	{
-		this->RemoveUnrefResources();
-
 		std::shared_ptr<void> loaded_res = this->FindMatchLoadedResource(res_desc);
 		std::shared_ptr<void> res;
 		if (loaded_res)
 		{
-			if (res_desc->StateLess())
-			{
-				res = loaded_res;
-			}
-			else
-			{
-				res = res_desc->CloneResourceFrom(loaded_res);
-				if (res != loaded_res)
-				{
-					this->AddLoadedResource(res_desc, res);
-				}
-			}
+			++ num_cache_hits_;
+			res = this->CloneLoadedResource(res_desc, loaded_res);
 		}
 		else
 		{
-			std::shared_ptr<volatile LoadingStatus> async_is_done;
-			bool found = false;
-			{
-				std::lock_guard<std::mutex> lock(loading_mutex_);
+			++ num_cache_misses_;
 
-				for (auto const & lrq : loading_res_)
+			bool run_sub_thread_stage = res_desc->HasSubThreadStage();
+			LoadingRequestPtr request;
+			if (this->FindMatchLoadingResource(res_desc, res, request))
+			{
+				// Takes it over if no loading thread has started it. Otherwise the desc shares its data with the one
+				//  being loaded, so it waits for the loading thread instead of running the stage a second time.
+				LoadingStatus status = request->status;
+				for (;;)
 				{
-					if (lrq.first->Match(*res_desc))
+					if ((LS_Loading == status) || (LS_Cancelled == status))
 					{
-						res_desc->CopyDataFrom(*lrq.first);
-						res = lrq.first->Resource();
-						async_is_done = lrq.second;
-						found = true;
+						if (request->status.compare_exchange_weak(status, LS_Complete))
+						{
+							break;
+						}
+					}
+					else if (LS_Running == status)
+					{
+						std::lock_guard<std::mutex> lock(request->running_mutex);
+						status = request->status;
+					}
+					else
+					{
+						run_sub_thread_stage = false;
 						break;
 					}
 				}
 			}
-
-			if (found)
-			{
-				*async_is_done = LS_Complete;
-			}
 			else
 			{
 				res = res_desc->CreateResource();
 			}
 
-			if (res_desc->HasSubThreadStage())
+			if (run_sub_thread_stage)
 			{
 				res_desc->SubThreadStage();
 			}
@@ -521,53 +545,29 @@ namespace KlayGE
 		return res;
 	}
 
-	std::shared_ptr<void> ResLoader::ASyncQuery(ResLoadingDescPtr const & res_desc)
+	std::shared_ptr<void> ResLoader::ASyncQuery(ResLoadingDescPtr const & res_desc, float priority)
 	{
-		this->RemoveUnrefResources();
-
 		std::shared_ptr<void> res;
 		std::shared_ptr<void> loaded_res = this->FindMatchLoadedResource(res_desc);
 		if (loaded_res)
 		{
-			if (res_desc->StateLess())
-			{
-				res = loaded_res;
-			}
-			else
-			{
-				res = res_desc->CloneResourceFrom(loaded_res);
-				if (res != loaded_res)
-				{
-					this->AddLoadedResource(res_desc, res);
-				}
-			}
+			++ num_cache_hits_;
+			res = this->CloneLoadedResource(res_desc, loaded_res);
 		}
 		else
 		{
-			std::shared_ptr<volatile LoadingStatus> async_is_done;
-			bool found = false;
-			{
-				std::lock_guard<std::mutex> lock(loading_mutex_);
+			++ num_cache_misses_;
 
-				for (auto const & lrq : loading_res_)
-				{
-					if (lrq.first->Match(*res_desc))
-					{
-						res_desc->CopyDataFrom(*lrq.first);
-						res = lrq.first->Resource();
-						async_is_done = lrq.second;
-						found = true;
-						break;
-					}
-				}
-			}
-
-			if (found)
+			LoadingRequestPtr request;
+			if (this->FindMatchLoadingResource(res_desc, res, request))
 			{
 				if (!res_desc->StateLess())
 				{
-					std::lock_guard<std::mutex> lock(loading_mutex_);
-					loading_res_.emplace_back(res_desc, async_is_done);
+					this->AddLoadingResource(res_desc, request);
+				}
+				if ((priority > request->priority) && (LS_Loading == request->status))
+				{
+					this->QueueLoadingRequest(request, priority);
 				}
 			}
 			else
@@ -576,13 +576,17 @@ namespace KlayGE
 				{
 					res = res_desc->CreateResource();
 
-					async_is_done = MakeSharedPtr<LoadingStatus>(LS_Loading);
-
-					{
-						std::lock_guard<std::mutex> lock(loading_mutex_);
-						loading_res_.emplace_back(res_desc, async_is_done);
-					}
-					loading_res_queue_.push(std::make_pair(res_desc, async_is_done));
+					request = MakeSharedPtr<LoadingRequest>();
+					request->res_desc = res_desc;
+					request->status = LS_Loading;
+					request->priority = priority;
+					request->queued_time = timer_.current_time();
+					request->start_time = request->queued_time;
+					request->sub_thread_time = 0;
+					request->flow_id = PerfProfiler::Instance().FlowBegin("ResLoader load");
+
+					this->AddLoadingResource(res_desc, request);
+					this->QueueLoadingRequest(request, priority);
 				}
 				else
 				{
@@ -597,74 +601,327 @@ namespace KlayGE
 
 	void ResLoader::Unload(std::shared_ptr<void> const & res)
 	{
-		std::lock_guard<std::mutex> lock(loaded_mutex_);
+		this->CancelLoadingResource(res);
 
-		for (auto iter = loaded_res_.begin(); iter != loaded_res_.end(); ++ iter)
+		// No key for a resource, but it's rare enough to go through all shards
+		for (auto& shard : loaded_res_shards_)
 		{
-			if (res == iter->second.lock())
+			std::lock_guard<std::mutex> lock(shard.mutex);
+
+			for (auto iter = shard.res.begin(); iter != shard.res.end(); ++ iter)
 			{
-				loaded_res_.erase(iter);
-				break;
+				if (res == iter->second.second.lock())
+				{
+					shard.res.erase(iter);
+					return;
+				}
 			}
 		}
 	}
 
 	void ResLoader::AddLoadedResource(ResLoadingDescPtr const & res_desc, std::shared_ptr<void> const & res)
 	{
-		std::lock_guard<std::mutex> lock(loaded_mutex_);
+		size_t const hash = res_desc->Hash();
+		LoadedResShard& shard = this->LoadedShard(hash);
+
+		std::lock_guard<std::mutex> lock(shard.mutex);
 
 		bool found = false;
-		for (auto& c_desc : loaded_res_)
+		auto const range = shard.res.equal_range(hash);
+		for (auto iter = range.first; iter != range.second; ++ iter)
 		{
-			if (c_desc.first == res_desc)
+			if (iter->second.first == res_desc)
 			{
-				c_desc.second = std::weak_ptr<void>(res);
+				iter->second.second = std::weak_ptr<void>(res);
 				found = true;
 				break;
 			}
 		}
 		if (!found)
 		{
-			loaded_res_.emplace_back(res_desc, std::weak_ptr<void>(res));
+			shard.res.emplace(hash, std::make_pair(res_desc, std::weak_ptr<void>(res)));
+			if (shard.res.size() >= shard.sweep_size)
+			{
+				this->SweepLoadedShard(shard);
+			}
 		}
 	}
 
 	std::shared_ptr<void> ResLoader::FindMatchLoadedResource(ResLoadingDescPtr const & res_desc)
 	{
-		std::lock_guard<std::mutex> lock(loaded_mutex_);
+		size_t const hash = res_desc->Hash();
+		LoadedResShard& shard = this->LoadedShard(hash);
+
+		std::lock_guard<std::mutex> lock(shard.mutex);
 
 		std::shared_ptr<void> loaded_res;
-		for (auto const & lr : loaded_res_)
+		auto const range = shard.res.equal_range(hash);
+		for (auto iter = range.first; iter != range.second;)
 		{
-			if (lr.first->Match(*res_desc))
+			if (iter->second.first->Match(*res_desc))
 			{
-				loaded_res = lr.second.lock();
-				break;
+				loaded_res = iter->second.second.lock();
+				if (loaded_res)
+				{
+					break;
+				}
+				else
+				{
+					iter = shard.res.erase(iter);
+				}
+			}
+			else
+			{
+				++ iter;
 			}
 		}
 		return loaded_res;
 	}
 
-	void ResLoader::RemoveUnrefResources()
+	std::shared_ptr<void> ResLoader::CloneLoadedResource(ResLoadingDescPtr const & res_desc,
+		std::shared_ptr<void> const & loaded_res)
+	{
+		std::shared_ptr<void> res;
+		if (res_desc->StateLess())
+		{
+			res = loaded_res;
+		}
+		else
+		{
+			res = res_desc->CloneResourceFrom(loaded_res);
+			if (res != loaded_res)
+			{
+				++ num_cache_clones_;
+				this->AddLoadedResource(res_desc, res);
+			}
+		}
+		return res;
+	}
+
+	bool ResLoader::FindMatchLoadingResource(ResLoadingDescPtr const & res_desc, std::shared_ptr<void>& res,
+		LoadingRequestPtr& request)
+	{
+		size_t const hash = res_desc->Hash();
+
+		std::lock_guard<std::mutex> lock(loading_mutex_);
+
+		auto const range = loading_res_index_.equal_range(hash);
+		for (auto iter = range.first; iter != range.second; ++ iter)
+		{
+			if (iter->second.first->Match(*res_desc))
+			{
+				res_desc->CopyDataFrom(*iter->second.first);
+				res = iter->second.first->Resource();
+				request = iter->second.second;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void ResLoader::AddLoadingResource(ResLoadingDescPtr const & res_desc, LoadingRequestPtr const & request)
+	{
+		std::lock_guard<std::mutex> lock(loading_mutex_);
+
+		loading_res_.emplace_back(res_desc, request);
+		loading_res_index_.emplace(res_desc->Hash(), std::make_pair(res_desc, request));
+	}
+
+	void ResLoader::EraseLoadingResourceIndex(ResLoadingDescPtr const & res_desc)
+	{
+		auto const range = loading_res_index_.equal_range(res_desc->Hash());
+		for (auto iter = range.first; iter != range.second; ++ iter)
+		{
+			if (iter->second.first == res_desc)
+			{
+				loading_res_index_.erase(iter);
+				break;
+			}
+		}
+	}
+
+	void ResLoader::QueueLoadingRequest(LoadingRequestPtr const & request, float priority)
+	{
+		{
+			std::lock_guard<std::mutex> lock(loading_queue_mutex_);
+
+			request->priority = priority;
+			loading_queue_.push(LoadingQueueItem{ priority, loading_seq_, request });
+			++ loading_seq_;
+		}
+		loading_queue_cond_.notify_one();
+	}
+
+	void ResLoader::CancelLoadingResource(std::shared_ptr<void> const & res)
 	{
-		std::lock_guard<std::mutex> lock(loaded_mutex_);
+		std::lock_guard<std::mutex> lock(loading_mutex_);
 
-		for (auto iter = loaded_res_.begin(); iter != loaded_res_.end();)
+		std::vector<LoadingRequestPtr> requests;
+		for (auto iter = loading_res_.begin(); iter != loading_res_.end();)
 		{
-			if (iter->second.lock())
+			if (iter->first->Resource() == res)
+			{
+				requests.push_back(iter->second);
+				this->EraseLoadingResourceIndex(iter->first);
+				iter = loading_res_.erase(iter);
+			}
+			else
 			{
 				++ iter;
 			}
+		}
+
+		// A request could be shared with descs of other resources. Only cancel it when nobody else waits.
+		for (auto const & request : requests)
+		{
+			bool waited = false;
+			for (auto const & lr : loading_res_)
+			{
+				if (lr.second == request)
+				{
+					waited = true;
+					break;
+				}
+			}
+
+			if (!waited)
+			{
+				LoadingStatus expected = LS_Loading;
+				if (request->status.compare_exchange_strong(expected, LS_Cancelled))
+				{
+					request->start_time = timer_.current_time();
+					this->AddLoadingTiming(request, 0);
+				}
+			}
+		}
+	}
+
+	void ResLoader::AddLoadingTiming(LoadingRequestPtr const & request, double main_thread_time)
+	{
+		ResLoadingTiming timing;
+		timing.type = request->res_desc->Type();
+		timing.resource = request->res_desc->Resource();
+		timing.priority = request->priority;
+		timing.cancelled = (LS_Cancelled == request->status);
+		timing.wait_time = request->start_time - request->queued_time;
+		timing.sub_thread_time = request->sub_thread_time;
+		timing.main_thread_time = main_thread_time;
+
+		std::lock_guard<std::mutex> lock(loading_timings_mutex_);
+		if (loading_timings_.size() >= MAX_LOADING_TIMINGS)
+		{
+			loading_timings_.erase(loading_timings_.begin(), loading_timings_.begin() + MAX_LOADING_TIMINGS / 2);
+		}
+		loading_timings_.push_back(timing);
+	}
+
+	void ResLoader::CollectLoadingTimings(std::vector<ResLoadingTiming>& timings)
+	{
+		std::lock_guard<std::mutex> lock(loading_timings_mutex_);
+		timings = std::move(loading_timings_);
+		loading_timings_.clear();
+	}
+
+	void ResLoader::NumLoadingThreads(uint32_t num)
+	{
+		this->StopLoadingThreads();
+
+		num = std::max(num, 1U);
+		for (uint32_t i = 0; i < num; ++ i)
+		{
+			loading_threads_.push_back(MakeUniquePtr<joiner<void>>(Context::Instance().ThreadPool()(
+				std::bind(&ResLoader::LoadingThreadFunc, this))));
+		}
+	}
+
+	void ResLoader::StopLoadingThreads()
+	{
+		{
+			std::lock_guard<std::mutex> lock(loading_queue_mutex_);
+			quit_ = true;
+		}
+		loading_queue_cond_.notify_all();
+
+		for (auto& thread : loading_threads_)
+		{
+			(*thread)();
+		}
+		loading_threads_.clear();
+
+		quit_ = false;
+	}
+
+	// Called with loading_queue_mutex_ held. Pops the most important request that can run now. The ones already run or
+	//  cancelled are dropped, and the ones whose type is busy in another loading thread stay in the queue.
+	ResLoader::LoadingRequestPtr ResLoader::PopRunnableRequest(uint32_t& stage_slot)
+	{
+		LoadingRequestPtr ret;
+		std::vector<LoadingQueueItem> busy_items;
+		while (!loading_queue_.empty())
+		{
+			LoadingQueueItem item = loading_queue_.top();
+			loading_queue_.pop();
+
+			if (item.request->status != LS_Loading)
+			{
+				continue;
+			}
+
+			ResLoadingDesc const & res_desc = *item.request->res_desc;
+			if (res_desc.ConcurrentSubThreadStage())
+			{
+				stage_slot = NUM_SUB_THREAD_STAGE_SLOTS;
+				ret = item.request;
+				break;
+			}
+
+			uint32_t const slot = static_cast<uint32_t>(res_desc.Type() % NUM_SUB_THREAD_STAGE_SLOTS);
+			if (!sub_thread_stage_busy_[slot])
+			{
+				sub_thread_stage_busy_[slot] = true;
+				stage_slot = slot;
+				ret = item.request;
+				break;
+			}
+
+			busy_items.push_back(std::move(item));
+		}
+
+		for (auto& item : busy_items)
+		{
+			loading_queue_.push(std::move(item));
+		}
+
+		return ret;
+	}
+
+	ResLoader::LoadedResShard& ResLoader::LoadedShard(size_t hash)
+	{
+		// The low bits pick the buckets inside a shard, use the high ones here
+		return loaded_res_shards_[(hash ^ (hash >> 16) ^ (hash >> 24)) % NUM_LOADED_RES_SHARDS];
+	}
+
+	void ResLoader::SweepLoadedShard(LoadedResShard& shard)
+	{
+		for (auto iter = shard.res.begin(); iter != shard.res.end();)
+		{
+			if (iter->second.second.expired())
+			{
+				iter = shard.res.erase(iter);
+			}
 			else
 			{
-				iter = loaded_res_.erase(iter);
+				++ iter;
 			}
 		}
+
+		// Next sweep when the live entries double, so the cost is amortized over the insertions
+		shard.sweep_size = std::max<size_t>(shard.res.size() * 2, 64);
 	}
 
 	void ResLoader::Update()
 	{
-		std::vector<std::pair<ResLoadingDescPtr, std::shared_ptr<volatile LoadingStatus>>> tmp_loading_res;
+		std::vector<std::pair<ResLoadingDescPtr, LoadingRequestPtr>> tmp_loading_res;
 		{
 			std::lock_guard<std::mutex> lock(loading_mutex_);
 			tmp_loading_res = loading_res_;
@@ -672,31 +929,27 @@ namespace KlayGE
 
 		for (auto& lrq : tmp_loading_res)
 		{
-			if (LS_Complete == *lrq.second)
+			if (LS_Complete == lrq.second->status)
 			{
 				ResLoadingDescPtr const & res_desc = lrq.first;
+				double const start_time = timer_.current_time();
+
+				PerfEventScope scope("ResLoader::MainThreadStage");
+				PerfProfiler::Instance().FlowEnd("ResLoader load", lrq.second->flow_id);
 
-				std::shared_ptr<void> res;
 				std::shared_ptr<void> loaded_res = this->FindMatchLoadedResource(res_desc);
 				if (loaded_res)
 				{
-					if (!res_desc->StateLess())
-					{
-						res = res_desc->CloneResourceFrom(loaded_res);
-						if (res != loaded_res)
-						{
-							this->AddLoadedResource(res_desc, res);
-						}
-					}
+					this->CloneLoadedResource(res_desc, loaded_res);
 				}
 				else
 				{
 					res_desc->MainThreadStage();
-					res = res_desc->Resource();
-					this->AddLoadedResource(res_desc, res);
+					this->AddLoadedResource(res_desc, res_desc->Resource());
 				}
 
-				*lrq.second = LS_CanBeRemoved;
+				lrq.second->status = LS_CanBeRemoved;
+				this->AddLoadingTiming(lrq.second, timer_.current_time() - start_time);
 			}
 		}
 
@@ -704,8 +957,9 @@ namespace KlayGE
 			std::lock_guard<std::mutex> lock(loading_mutex_);
 			for (auto iter = loading_res_.begin(); iter != loading_res_.end();)
 			{
-				if (LS_CanBeRemoved == *(iter->second))
+				if (LS_CanBeRemoved == iter->second->status)
 				{
+					this->EraseLoadingResourceIndex(iter->first);
 					iter = loading_res_.erase(iter);
 				}
 				else
@@ -718,19 +972,54 @@ namespace KlayGE
 
 	void ResLoader::LoadingThreadFunc()
 	{
-		while (!quit_)
+		PerfProfiler::Instance().ThreadName("ResLoader");
+
+		for (;;)
 		{
-			std::pair<ResLoadingDescPtr, std::shared_ptr<volatile LoadingStatus>> res_pair;
-			while (loading_res_queue_.pop(res_pair))
+			LoadingRequestPtr request;
+			uint32_t stage_slot = NUM_SUB_THREAD_STAGE_SLOTS;
 			{
-				if (LS_Loading == *res_pair.second)
+				std::unique_lock<std::mutex> lock(loading_queue_mutex_);
+				while (!quit_)
 				{
-					res_pair.first->SubThreadStage();
-					*res_pair.second = LS_Complete;
+					request = this->PopRunnableRequest(stage_slot);
+					if (request)
+					{
+						break;
+					}
+					loading_queue_cond_.wait(lock);
 				}
 			}
+			if (!request)
+			{
+				break;
+			}
 
-			Sleep(10);
+			{
+				std::lock_guard<std::mutex> running_lock(request->running_mutex);
+
+				// Skips the ones cancelled or taken over by SyncQuery since popped
+				LoadingStatus expected = LS_Loading;
+				if (request->status.compare_exchange_strong(expected, LS_Running))
+				{
+					request->start_time = timer_.current_time();
+
+					PerfEventScope scope("ResLoader::SubThreadStage");
+					PerfProfiler::Instance().FlowStep("ResLoader load", request->flow_id);
+					request->res_desc->SubThreadStage();
+					request->sub_thread_time = timer_.current_time() - request->start_time;
+					request->status = LS_Complete;
+				}
+			}
+
+			if (stage_slot < NUM_SUB_THREAD_STAGE_SLOTS)
+			{
+				{
+					std::lock_guard<std::mutex> lock(loading_queue_mutex_);
+					sub_thread_stage_busy_[stage_slot] = false;
+				}
+				loading_queue_cond_.notify_all();
+			}
 		}
 	}
 
@@ -770,6 +1059,45 @@ namespace KlayGE
 		return res;
 	}
 
+	PackagePtr ResLoader::LocatePackage(std::string const & res_name, std::string& internal_name)
+	{
+		PackagePtr package;
+		std::string::size_type const pkt_offset(res_name.find("//"));
+		if (pkt_offset != std::string::npos)
+		{
+			std::string const pkt_name = res_name.substr(0, pkt_offset);
+			auto iter = packages_.find(pkt_name);
+			if (iter == packages_.end())
+			{
+				// Only existing files are remembered. The ones with password are always 7z.
+				std::filesystem::path pkt_path(pkt_name);
+				if ((pkt_name.find("|") == std::string::npos)
+					&& std::filesystem::exists(pkt_path)
+					&& (std::filesystem::is_regular_file(pkt_path)
+						|| std::filesystem::is_symlink(pkt_path)))
+				{
+					package = MakeSharedPtr<Package>(pkt_name);
+					if (!package->Valid())
+					{
+						package.reset();
+					}
+					packages_.emplace(pkt_name, package);
+				}
+			}
+			else
+			{
+				package = iter->second;
+			}
+
+			if (package)
+			{
+				internal_name = res_name.substr(pkt_offset + 2);
+			}
+		}
+
+		return package;
+	}
+
 #if defined(KLAYGE_PLATFORM_ANDROID)
 	AAsset* ResLoader::LocateFileAndroid(std::string const & name)
 	{
@@ -0,0 +1,882 @@
+#include <KlayGE/KlayGE.hpp>
+
+// DON'T EDIT THIS FILE. Automatically generated by TableGen.py
+
+namespace KlayGE
+{
+	namespace TexCompressionLUT
+	{
+		uint8_t EXPAND5[32] =
+		{
+			0, 8, 16, 24, 33, 41, 49, 57, 66, 74, 82, 90, 99, 107, 115, 123, 132, 140, 148, 156, 165, 173, 181, 189, 198, 206, 214, 222, 231, 239, 247, 255 
+		};
+
+		uint8_t EXPAND6[64] =
+		{
+			0, 4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 44, 48, 52, 56, 60, 65, 69, 73, 77, 81, 85, 89, 93, 97, 101, 105, 109, 113, 117, 121, 125, 130, 134, 138, 142, 146, 150, 154, 158, 162, 166, 170, 174, 178, 182, 186, 190, 195, 199, 203, 207, 211, 215, 219, 223, 227, 231, 235, 239, 243, 247, 251, 255 
+		};
+
+		uint8_t EXPAND7[128] =
+		{
+			0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30, 32, 34, 36, 38, 40, 42, 44, 46, 48, 50, 52, 54, 56, 58, 60, 62, 64, 66, 68, 70, 72, 74, 76, 78, 80, 82, 84, 86, 88, 90, 92, 94, 96, 98, 100, 102, 104, 106, 108, 110, 112, 114, 116, 118, 120, 122, 124, 126, 129, 131, 133, 135, 137, 139, 141, 143, 145, 147, 149, 151, 153, 155, 157, 159, 161, 163, 165, 167, 169, 171, 173, 175, 177, 179, 181, 183, 185, 187, 189, 191, 193, 195, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221, 223, 225, 227, 229, 231, 233, 235, 237, 239, 241, 243, 245, 247, 249, 251, 253, 255 
+		};
+
+		uint8_t O_MATCH5[256][2] =
+		{
+			{ 0, 0 },
+			{ 0, 0 },
+			{ 0, 1 },
+			{ 0, 1 },
+			{ 1, 0 },
+			{ 1, 0 },
+			{ 1, 0 },
+			{ 1, 1 },
+			{ 1, 1 },
+			{ 1, 1 },
+			{ 2, 0 },
+			{ 2, 0 },
+			{ 2, 0 },
+			{ 2, 1 },
+			{ 0, 5 },
+			{ 3, 0 },
+			{ 3, 0 },
+			{ 3, 0 },
+			{ 3, 1 },
+			{ 3, 1 },
+			{ 3, 1 },
+			{ 3, 2 },
+			{ 4, 0 },
+			{ 4, 0 },
+			{ 3, 3 },
+			{ 4, 1 },
+			{ 5, 0 },
+			{ 5, 0 },
+			{ 5, 0 },
+			{ 5, 1 },
+			{ 5, 1 },
+			{ 5, 1 },
+			{ 3, 6 },
+			{ 6, 0 },
+			{ 6, 0 },
+			{ 6, 1 },
+			{ 4, 5 },
+			{ 7, 0 },
+			{ 7, 0 },
+			{ 7, 0 },
+			{ 7, 1 },
+			{ 7, 1 },
+			{ 7, 1 },
+			{ 7, 2 },
+			{ 8, 0 },
+			{ 8, 0 },
+			{ 7, 3 },
+			{ 8, 1 },
+			{ 9, 0 },
+			{ 9, 0 },
+			{ 9, 0 },
+			{ 9, 1 },
+			{ 9, 1 },
+			{ 9, 1 },
+			{ 7, 6 },
+			{ 10, 0 },
+			{ 10, 0 },
+			{ 10, 1 },
+			{ 8, 5 },
+			{ 11, 0 },
+			{ 11, 0 },
+			{ 11, 0 },
+			{ 11, 1 },
+			{ 11, 1 },
+			{ 11, 1 },
+			{ 11, 2 },
+			{ 12, 0 },
+			{ 12, 0 },
+			{ 11, 3 },
+			{ 12, 1 },
+			{ 13, 0 },
+			{ 13, 0 },
+			{ 13, 0 },
+			{ 13, 1 },
+			{ 13, 1 },
+			{ 13, 1 },
+			{ 11, 6 },
+			{ 14, 0 },
+			{ 14, 0 },
+			{ 14, 1 },
+			{ 12, 5 },
+			{ 15, 0 },
+			{ 15, 0 },
+			{ 15, 0 },
+			{ 15, 1 },
+			{ 15, 1 },
+			{ 15, 1 },
+			{ 15, 2 },
+			{ 16, 0 },
+			{ 16, 0 },
+			{ 15, 3 },
+			{ 16, 1 },
+			{ 17, 0 },
+			{ 17, 0 },
+			{ 17, 0 },
+			{ 17, 1 },
+			{ 17, 1 },
+			{ 17, 1 },
+			{ 15, 6 },
+			{ 18, 0 },
+			{ 18, 0 },
+			{ 18, 1 },
+			{ 16, 5 },
+			{ 19, 0 },
+			{ 19, 0 },
+			{ 19, 0 },
+			{ 19, 1 },
+			{ 19, 1 },
+			{ 19, 1 },
+			{ 19, 2 },
+			{ 20, 0 },
+			{ 20, 0 },
+			{ 19, 3 },
+			{ 20, 1 },
+			{ 21, 0 },
+			{ 21, 0 },
+			{ 21, 0 },
+			{ 21, 1 },
+			{ 21, 1 },
+			{ 21, 1 },
+			{ 19, 6 },
+			{ 22, 0 },
+			{ 22, 0 },
+			{ 22, 1 },
+			{ 20, 5 },
+			{ 23, 0 },
+			{ 23, 0 },
+			{ 23, 0 },
+			{ 23, 1 },
+			{ 23, 1 },
+			{ 23, 1 },
+			{ 23, 2 },
+			{ 24, 0 },
+			{ 24, 0 },
+			{ 23, 3 },
+			{ 24, 1 },
+			{ 25, 0 },
+			{ 25, 0 },
+			{ 25, 0 },
+			{ 25, 1 },
+			{ 25, 1 },
+			{ 25, 1 },
+			{ 23, 6 },
+			{ 26, 0 },
+			{ 26, 0 },
+			{ 26, 1 },
+			{ 24, 5 },
+			{ 27, 0 },
+			{ 27, 0 },
+			{ 27, 0 },
+			{ 27, 1 },
+			{ 27, 1 },
+			{ 27, 1 },
+			{ 27, 2 },
+			{ 28, 0 },
+			{ 28, 0 },
+			{ 27, 3 },
+			{ 28, 1 },
+			{ 29, 0 },
+			{ 29, 0 },
+			{ 29, 0 },
+			{ 29, 1 },
+			{ 29, 1 },
+			{ 29, 1 },
+			{ 27, 6 },
+			{ 30, 0 },
+			{ 30, 0 },
+			{ 30, 1 },
+			{ 28, 5 },
+			{ 31, 0 },
+			{ 31, 0 },
+			{ 31, 0 },
+			{ 31, 1 },
+			{ 31, 1 },
+			{ 31, 1 },
+			{ 31, 2 },
+			{ 30, 4 },
+			{ 31, 3 },
+			{ 31, 3 },
+			{ 28, 9 },
+			{ 31, 4 },
+			{ 31, 4 },
+			{ 31, 4 },
+			{ 31, 5 },
+			{ 31, 5 },
+			{ 31, 5 },
+			{ 31, 6 },
+			{ 30, 8 },
+			{ 31, 7 },
+			{ 31, 7 },
+			{ 28, 13 },
+			{ 31, 8 },
+			{ 31, 8 },
+			{ 31, 8 },
+			{ 31, 9 },
+			{ 31, 9 },
+			{ 31, 9 },
+			{ 31, 10 },
+			{ 30, 12 },
+			{ 31, 11 },
+			{ 31, 11 },
+			{ 28, 17 },
+			{ 31, 12 },
+			{ 31, 12 },
+			{ 31, 12 },
+			{ 31, 13 },
+			{ 31, 13 },
+			{ 31, 13 },
+			{ 31, 14 },
+			{ 30, 16 },
+			{ 31, 15 },
+			{ 31, 15 },
+			{ 28, 21 },
+			{ 31, 16 },
+			{ 31, 16 },
+			{ 31, 16 },
+			{ 31, 17 },
+			{ 31, 17 },
+			{ 31, 17 },
+			{ 31, 18 },
+			{ 30, 20 },
+			{ 31, 19 },
+			{ 31, 19 },
+			{ 28, 25 },
+			{ 31, 20 },
+			{ 31, 20 },
+			{ 31, 20 },
+			{ 31, 21 },
+			{ 31, 21 },
+			{ 31, 21 },
+			{ 31, 22 },
+			{ 30, 24 },
+			{ 31, 23 },
+			{ 31, 23 },
+			{ 28, 29 },
+			{ 31, 24 },
+			{ 31, 24 },
+			{ 31, 24 },
+			{ 31, 25 },
+			{ 31, 25 },
+			{ 31, 25 },
+			{ 31, 26 },
+			{ 30, 28 },
+			{ 31, 27 },
+			{ 31, 27 },
+			{ 31, 27 },
+			{ 31, 28 },
+			{ 31, 28 },
+			{ 31, 28 },
+			{ 31, 29 },
+			{ 31, 29 },
+			{ 31, 29 },
+			{ 31, 30 },
+			{ 31, 30 },
+			{ 31, 31 },
+			{ 31, 31 }
+		};
+
+		uint8_t O_MATCH6[256][2] =
+		{
+			{ 0, 0 },
+			{ 0, 1 },
+			{ 1, 0 },
+			{ 1, 0 },
+			{ 1, 1 },
+			{ 2, 0 },
+			{ 2, 0 },
+			{ 2, 1 },
+			{ 3, 0 },
+			{ 3, 1 },
+			{ 4, 0 },
+			{ 4, 0 },
+			{ 4, 1 },
+			{ 5, 0 },
+			{ 5, 0 },
+			{ 5, 1 },
+			{ 6, 0 },
+			{ 6, 1 },
+			{ 7, 0 },
+			{ 7, 0 },
+			{ 7, 1 },
+			{ 8, 0 },
+			{ 0, 16 },
+			{ 8, 1 },
+			{ 9, 0 },
+			{ 9, 1 },
+			{ 1, 17 },
+			{ 10, 0 },
+			{ 10, 1 },
+			{ 11, 0 },
+			{ 3, 16 },
+			{ 11, 1 },
+			{ 12, 0 },
+			{ 12, 1 },
+			{ 4, 17 },
+			{ 13, 0 },
+			{ 13, 1 },
+			{ 14, 0 },
+			{ 6, 16 },
+			{ 14, 1 },
+			{ 15, 0 },
+			{ 15, 1 },
+			{ 7, 17 },
+			{ 16, 0 },
+			{ 15, 3 },
+			{ 16, 1 },
+			{ 17, 0 },
+			{ 17, 1 },
+			{ 15, 6 },
+			{ 18, 0 },
+			{ 18, 1 },
+			{ 19, 0 },
+			{ 15, 9 },
+			{ 19, 1 },
+			{ 20, 0 },
+			{ 20, 1 },
+			{ 15, 12 },
+			{ 21, 0 },
+			{ 21, 1 },
+			{ 22, 0 },
+			{ 15, 15 },
+			{ 22, 1 },
+			{ 23, 0 },
+			{ 23, 1 },
+			{ 15, 18 },
+			{ 24, 0 },
+			{ 24, 1 },
+			{ 25, 0 },
+			{ 17, 16 },
+			{ 25, 1 },
+			{ 26, 0 },
+			{ 26, 1 },
+			{ 18, 17 },
+			{ 27, 0 },
+			{ 27, 1 },
+			{ 28, 0 },
+			{ 20, 16 },
+			{ 28, 1 },
+			{ 29, 0 },
+			{ 29, 1 },
+			{ 21, 17 },
+			{ 30, 0 },
+			{ 30, 1 },
+			{ 31, 0 },
+			{ 23, 16 },
+			{ 31, 1 },
+			{ 31, 2 },
+			{ 32, 0 },
+			{ 32, 1 },
+			{ 33, 0 },
+			{ 31, 5 },
+			{ 33, 1 },
+			{ 34, 0 },
+			{ 34, 1 },
+			{ 31, 8 },
+			{ 35, 0 },
+			{ 35, 1 },
+			{ 36, 0 },
+			{ 31, 11 },
+			{ 36, 1 },
+			{ 37, 0 },
+			{ 37, 1 },
+			{ 31, 14 },
+			{ 38, 0 },
+			{ 38, 1 },
+			{ 39, 0 },
+			{ 31, 17 },
+			{ 39, 1 },
+			{ 40, 0 },
+			{ 40, 1 },
+			{ 32, 17 },
+			{ 41, 0 },
+			{ 41, 1 },
+			{ 42, 0 },
+			{ 34, 16 },
+			{ 42, 1 },
+			{ 43, 0 },
+			{ 43, 1 },
+			{ 35, 17 },
+			{ 44, 0 },
+			{ 44, 1 },
+			{ 45, 0 },
+			{ 37, 16 },
+			{ 45, 1 },
+			{ 46, 0 },
+			{ 46, 1 },
+			{ 38, 17 },
+			{ 47, 0 },
+			{ 47, 1 },
+			{ 47, 2 },
+			{ 48, 0 },
+			{ 48, 1 },
+			{ 47, 4 },
+			{ 49, 0 },
+			{ 49, 1 },
+			{ 50, 0 },
+			{ 47, 7 },
+			{ 50, 1 },
+			{ 51, 0 },
+			{ 51, 1 },
+			{ 47, 10 },
+			{ 52, 0 },
+			{ 52, 1 },
+			{ 53, 0 },
+			{ 47, 13 },
+			{ 53, 1 },
+			{ 54, 0 },
+			{ 54, 1 },
+			{ 47, 16 },
+			{ 55, 0 },
+			{ 55, 1 },
+			{ 56, 0 },
+			{ 48, 16 },
+			{ 56, 1 },
+			{ 57, 0 },
+			{ 57, 1 },
+			{ 49, 17 },
+			{ 58, 0 },
+			{ 58, 1 },
+			{ 59, 0 },
+			{ 51, 16 },
+			{ 59, 1 },
+			{ 60, 0 },
+			{ 60, 1 },
+			{ 52, 17 },
+			{ 61, 0 },
+			{ 61, 1 },
+			{ 62, 0 },
+			{ 54, 16 },
+			{ 62, 1 },
+			{ 63, 0 },
+			{ 63, 1 },
+			{ 55, 17 },
+			{ 63, 2 },
+			{ 63, 3 },
+			{ 63, 4 },
+			{ 57, 16 },
+			{ 63, 5 },
+			{ 63, 6 },
+			{ 63, 7 },
+			{ 58, 17 },
+			{ 63, 8 },
+			{ 63, 9 },
+			{ 63, 10 },
+			{ 60, 16 },
+			{ 63, 11 },
+			{ 63, 12 },
+			{ 63, 13 },
+			{ 61, 17 },
+			{ 63, 14 },
+			{ 63, 15 },
+			{ 54, 33 },
+			{ 63, 16 },
+			{ 63, 17 },
+			{ 63, 18 },
+			{ 56, 32 },
+			{ 63, 19 },
+			{ 63, 20 },
+			{ 63, 21 },
+			{ 57, 33 },
+			{ 63, 22 },
+			{ 63, 23 },
+			{ 63, 24 },
+			{ 59, 32 },
+			{ 63, 25 },
+			{ 63, 26 },
+			{ 63, 27 },
+			{ 60, 33 },
+			{ 63, 28 },
+			{ 63, 29 },
+			{ 63, 30 },
+			{ 62, 32 },
+			{ 63, 31 },
+			{ 63, 32 },
+			{ 55, 48 },
+			{ 63, 33 },
+			{ 63, 34 },
+			{ 63, 35 },
+			{ 56, 49 },
+			{ 63, 36 },
+			{ 63, 37 },
+			{ 63, 38 },
+			{ 58, 48 },
+			{ 63, 39 },
+			{ 63, 40 },
+			{ 63, 41 },
+			{ 59, 49 },
+			{ 63, 42 },
+			{ 63, 43 },
+			{ 63, 44 },
+			{ 61, 48 },
+			{ 63, 45 },
+			{ 63, 46 },
+			{ 63, 47 },
+			{ 62, 49 },
+			{ 63, 48 },
+			{ 63, 49 },
+			{ 63, 49 },
+			{ 63, 50 },
+			{ 63, 51 },
+			{ 63, 52 },
+			{ 63, 52 },
+			{ 63, 53 },
+			{ 63, 54 },
+			{ 63, 55 },
+			{ 63, 55 },
+			{ 63, 56 },
+			{ 63, 57 },
+			{ 63, 58 },
+			{ 63, 58 },
+			{ 63, 59 },
+			{ 63, 60 },
+			{ 63, 61 },
+			{ 63, 61 },
+			{ 63, 62 },
+			{ 63, 63 }
+		};
+
+		uint8_t O_MATCH7[256][2] =
+		{
+			{ 0, 0 },
+			{ 0, 1 },
+			{ 0, 3 },
+			{ 0, 4 },
+			{ 0, 6 },
+			{ 0, 7 },
+			{ 0, 9 },
+			{ 0, 10 },
+			{ 0, 12 },
+			{ 0, 13 },
+			{ 0, 15 },
+			{ 0, 16 },
+			{ 0, 18 },
+			{ 0, 20 },
+			{ 0, 21 },
+			{ 0, 23 },
+			{ 0, 24 },
+			{ 0, 26 },
+			{ 0, 27 },
+			{ 0, 29 },
+			{ 0, 30 },
+			{ 0, 32 },
+			{ 0, 33 },
+			{ 0, 35 },
+			{ 0, 36 },
+			{ 0, 38 },
+			{ 0, 39 },
+			{ 0, 41 },
+			{ 0, 42 },
+			{ 0, 44 },
+			{ 0, 45 },
+			{ 0, 47 },
+			{ 0, 48 },
+			{ 0, 50 },
+			{ 0, 52 },
+			{ 0, 53 },
+			{ 0, 55 },
+			{ 0, 56 },
+			{ 0, 58 },
+			{ 0, 59 },
+			{ 0, 61 },
+			{ 0, 62 },
+			{ 0, 64 },
+			{ 0, 65 },
+			{ 0, 66 },
+			{ 0, 68 },
+			{ 0, 69 },
+			{ 0, 71 },
+			{ 0, 72 },
+			{ 0, 74 },
+			{ 0, 75 },
+			{ 0, 77 },
+			{ 0, 78 },
+			{ 0, 80 },
+			{ 0, 82 },
+			{ 0, 83 },
+			{ 0, 85 },
+			{ 0, 86 },
+			{ 0, 88 },
+			{ 0, 89 },
+			{ 0, 91 },
+			{ 0, 92 },
+			{ 0, 94 },
+			{ 0, 95 },
+			{ 0, 97 },
+			{ 0, 98 },
+			{ 0, 100 },
+			{ 0, 101 },
+			{ 0, 103 },
+			{ 0, 104 },
+			{ 0, 106 },
+			{ 0, 107 },
+			{ 0, 109 },
+			{ 0, 110 },
+			{ 0, 112 },
+			{ 0, 114 },
+			{ 0, 115 },
+			{ 0, 117 },
+			{ 0, 118 },
+			{ 0, 120 },
+			{ 0, 121 },
+			{ 0, 123 },
+			{ 0, 124 },
+			{ 0, 126 },
+			{ 0, 127 },
+			{ 1, 127 },
+			{ 2, 126 },
+			{ 3, 126 },
+			{ 3, 127 },
+			{ 4, 127 },
+			{ 5, 126 },
+			{ 6, 126 },
+			{ 6, 127 },
+			{ 7, 127 },
+			{ 8, 126 },
+			{ 9, 126 },
+			{ 9, 127 },
+			{ 10, 127 },
+			{ 11, 126 },
+			{ 12, 126 },
+			{ 12, 127 },
+			{ 13, 127 },
+			{ 14, 126 },
+			{ 15, 125 },
+			{ 15, 127 },
+			{ 16, 126 },
+			{ 17, 126 },
+			{ 17, 127 },
+			{ 18, 127 },
+			{ 19, 126 },
+			{ 20, 126 },
+			{ 20, 127 },
+			{ 21, 127 },
+			{ 22, 126 },
+			{ 23, 126 },
+			{ 23, 127 },
+			{ 24, 127 },
+			{ 25, 126 },
+			{ 26, 126 },
+			{ 26, 127 },
+			{ 27, 127 },
+			{ 28, 126 },
+			{ 29, 126 },
+			{ 29, 127 },
+			{ 30, 127 },
+			{ 31, 126 },
+			{ 32, 126 },
+			{ 32, 127 },
+			{ 33, 127 },
+			{ 34, 126 },
+			{ 35, 126 },
+			{ 35, 127 },
+			{ 36, 127 },
+			{ 37, 126 },
+			{ 38, 126 },
+			{ 38, 127 },
+			{ 39, 127 },
+			{ 40, 126 },
+			{ 41, 126 },
+			{ 41, 127 },
+			{ 42, 127 },
+			{ 43, 126 },
+			{ 44, 126 },
+			{ 44, 127 },
+			{ 45, 127 },
+			{ 46, 126 },
+			{ 47, 125 },
+			{ 47, 127 },
+			{ 48, 126 },
+			{ 49, 126 },
+			{ 49, 127 },
+			{ 50, 127 },
+			{ 51, 126 },
+			{ 52, 126 },
+			{ 52, 127 },
+			{ 53, 127 },
+			{ 54, 126 },
+			{ 55, 126 },
+			{ 55, 127 },
+			{ 56, 127 },
+			{ 57, 126 },
+			{ 58, 126 },
+			{ 58, 127 },
+			{ 59, 127 },
+			{ 60, 126 },
+			{ 61, 126 },
+			{ 61, 127 },
+			{ 62, 127 },
+			{ 63, 126 },
+			{ 64, 125 },
+			{ 64, 126 },
+			{ 65, 126 },
+			{ 65, 127 },
+			{ 66, 127 },
+			{ 67, 126 },
+			{ 68, 126 },
+			{ 68, 127 },
+			{ 69, 127 },
+			{ 70, 126 },
+			{ 71, 126 },
+			{ 71, 127 },
+			{ 72, 127 },
+			{ 73, 126 },
+			{ 74, 126 },
+			{ 74, 127 },
+			{ 75, 127 },
+			{ 76, 126 },
+			{ 77, 125 },
+			{ 77, 127 },
+			{ 78, 126 },
+			{ 79, 126 },
+			{ 79, 127 },
+			{ 80, 127 },
+			{ 81, 126 },
+			{ 82, 126 },
+			{ 82, 127 },
+			{ 83, 127 },
+			{ 84, 126 },
+			{ 85, 126 },
+			{ 85, 127 },
+			{ 86, 127 },
+			{ 87, 126 },
+			{ 88, 126 },
+			{ 88, 127 },
+			{ 89, 127 },
+			{ 90, 126 },
+			{ 91, 126 },
+			{ 91, 127 },
+			{ 92, 127 },
+			{ 93, 126 },
+			{ 94, 126 },
+			{ 94, 127 },
+			{ 95, 127 },
+			{ 96, 126 },
+			{ 97, 126 },
+			{ 97, 127 },
+			{ 98, 127 },
+			{ 99, 126 },
+			{ 100, 126 },
+			{ 100, 127 },
+			{ 101, 127 },
+			{ 102, 126 },
+			{ 103, 126 },
+			{ 103, 127 },
+			{ 104, 127 },
+			{ 105, 126 },
+			{ 106, 126 },
+			{ 106, 127 },
+			{ 107, 127 },
+			{ 108, 126 },
+			{ 109, 125 },
+			{ 109, 127 },
+			{ 110, 126 },
+			{ 111, 126 },
+			{ 111, 127 },
+			{ 112, 127 },
+			{ 113, 126 },
+			{ 114, 126 },
+			{ 114, 127 },
+			{ 115, 127 },
+			{ 116, 126 },
+			{ 117, 126 },
+			{ 117, 127 },
+			{ 118, 127 },
+			{ 119, 126 },
+			{ 120, 126 },
+			{ 120, 127 },
+			{ 121, 127 },
+			{ 122, 126 },
+			{ 123, 126 },
+			{ 123, 127 },
+			{ 124, 127 },
+			{ 125, 126 },
+			{ 126, 126 },
+			{ 126, 127 },
+			{ 127, 127 }
+		};
+
+		uint8_t QUANT_5_TAB[272] =
+		{
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 8, 8, 8, 8, 8, 8, 8, 16, 16, 16, 16, 16, 16, 16, 16, 24, 24, 24, 24, 24, 24, 24, 24, 33, 33, 33, 33, 33, 33, 33, 33, 33, 41, 41, 41, 41, 41, 41, 41, 41, 49, 49, 49, 49, 49, 49, 49, 49, 57, 57, 57, 57, 57, 57, 57, 57, 66, 66, 66, 66, 66, 66, 66, 66, 74, 74, 74, 74, 74, 74, 74, 74, 74, 82, 82, 82, 82, 82, 82, 82, 82, 90, 90, 90, 90, 90, 90, 90, 90, 99, 99, 99, 99, 99, 99, 99, 99, 107, 107, 107, 107, 107, 107, 107, 107, 107, 115, 115, 115, 115, 115, 115, 115, 115, 123, 123, 123, 123, 123, 123, 123, 123, 132, 132, 132, 132, 132, 132, 132, 132, 140, 140, 140, 140, 140, 140, 140, 140, 148, 148, 148, 148, 148, 148, 148, 148, 148, 156, 156, 156, 156, 156, 156, 156, 156, 165, 165, 165, 165, 165, 165, 165, 165, 173, 173, 173, 173, 173, 173, 173, 173, 181, 181, 181, 181, 181, 181, 181, 181, 181, 189, 189, 189, 189, 189, 189, 189, 189, 198, 198, 198, 198, 198, 198, 198, 198, 206, 206, 206, 206, 206, 206, 206, 206, 214, 214, 214, 214, 214, 214, 214, 214, 222, 222, 222, 222, 222, 222, 222, 222, 222, 231, 231, 231, 231, 231, 231, 231, 231, 239, 239, 239, 239, 239, 239, 239, 239, 247, 247, 247, 247, 247, 247, 247, 247, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255 
+		};
+
+		uint8_t QUANT_6_TAB[272] =
+		{
+			0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12, 16, 16, 16, 16, 20, 20, 20, 20, 24, 24, 24, 24, 28, 28, 28, 28, 32, 32, 32, 32, 36, 36, 36, 36, 40, 40, 40, 40, 44, 44, 44, 44, 48, 48, 48, 48, 52, 52, 52, 52, 56, 56, 56, 56, 60, 60, 60, 60, 65, 65, 65, 65, 69, 69, 69, 69, 73, 73, 73, 73, 77, 77, 77, 77, 81, 81, 81, 81, 85, 85, 85, 85, 85, 89, 89, 89, 89, 93, 93, 93, 93, 97, 97, 97, 97, 101, 101, 101, 101, 105, 105, 105, 105, 109, 109, 109, 109, 113, 113, 113, 113, 117, 117, 117, 117, 121, 121, 121, 121, 125, 125, 125, 125, 130, 130, 130, 130, 134, 134, 134, 134, 138, 138, 138, 138, 142, 142, 142, 142, 146, 146, 146, 146, 150, 150, 150, 150, 154, 154, 154, 154, 158, 158, 158, 158, 162, 162, 162, 162, 166, 166, 166, 166, 170, 170, 170, 170, 170, 174, 174, 174, 174, 178, 178, 178, 178, 182, 182, 182, 182, 186, 186, 186, 186, 190, 190, 190, 190, 195, 195, 195, 195, 199, 199, 199, 199, 203, 203, 203, 203, 207, 207, 207, 207, 211, 211, 211, 211, 215, 215, 215, 215, 219, 219, 219, 219, 223, 223, 223, 223, 227, 227, 227, 227, 231, 231, 231, 231, 235, 235, 235, 235, 239, 239, 239, 239, 243, 243, 243, 243, 247, 247, 247, 247, 251, 251, 251, 251, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255 
+		};
+
+		uint16_t ETC1_INVERSE_LOOKUP[64][256] =
+		{
+			{ 0, 256, 512, 768, 1024, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527, 783, 1039, 1295, 1551, 1807, 2063 },
+			{ 0, 256, 512, 768, 1024, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543, 799, 1055, 1311, 1567, 1823, 2079 },
+			{ 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527, 783, 1039, 1295, 1551, 1807, 2063, 2319, 2575, 2831, 3087, 3343, 3599, 3855, 4111, 4367 },
+			{ 0, 256, 512, 768, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543, 799, 1055, 1311, 1567, 1823, 2079, 2335, 2591, 2847, 3103, 3359, 3615, 3871, 4127, 4383 },
+			{ 0, 256, 512, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527, 783, 1039, 1295, 1551, 1807, 2063, 2319, 2575, 2831, 3087, 3343, 3599, 3855, 4111, 4367, 4623, 4879, 5135, 5391, 5647, 5903, 6159, 6415, 6671, 6927, 7183, 7439 },
+			{ 0, 256, 512, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543, 799, 1055, 1311, 1567, 1823, 2079, 2335, 2591, 2847, 3103, 3359, 3615, 3871, 4127, 4383, 4639, 4895, 5151, 5407, 5663, 5919, 6175, 6431, 6687, 6943, 7199, 7455 },
+			{ 0, 256, 512, 768, 1024, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527, 783, 1039, 1295, 1551, 1807, 2063, 2319, 2575, 2831, 3087, 3343, 3599, 3855, 4111, 4367, 4623, 4879, 5135, 5391, 5647, 5903, 6159, 6415, 6671, 6927, 7183, 7439, 7695, 7951, 8207, 8463, 8719, 8975, 9231, 9487, 9743, 9999, 10255, 10511, 10767 },
+			{ 0, 256, 512, 768, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543, 799, 1055, 1311, 1567, 1823, 2079, 2335, 2591, 2847, 3103, 3359, 3615, 3871, 4127, 4383, 4639, 4895, 5151, 5407, 5663, 5919, 6175, 6431, 6687, 6943, 7199, 7455, 7711, 7967, 8223, 8479, 8735, 8991, 9247, 9503, 9759, 10015, 10271, 10527, 10783 },
+			{ 0, 256, 512, 768, 1024, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527, 783, 1039, 1295, 1551, 1807, 2063, 2319, 2575, 2831, 3087, 3343, 3599, 3855, 4111, 4367, 4623, 4879, 5135, 5391, 5647, 5903, 6159, 6415, 6671, 6927, 7183, 7439, 7695, 7951, 8207, 8463, 8719, 8975, 9231, 9487, 9743, 9999, 10255, 10511, 10767, 11023, 11279, 11535, 11791, 12047, 12303, 12559, 12815, 13071, 13327, 13583, 13839, 14095, 14351, 14607, 14863, 15119, 15375 },
+			{ 0, 256, 512, 768, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543, 799, 1055, 1311, 1567, 1823, 2079, 2335, 2591, 2847, 3103, 3359, 3615, 3871, 4127, 4383, 4639, 4895, 5151, 5407, 5663, 5919, 6175, 6431, 6687, 6943, 7199, 7455, 7711, 7967, 8223, 8479, 8735, 8991, 9247, 9503, 9759, 10015, 10271, 10527, 10783, 11039, 11295, 11551, 11807, 12063, 12319, 12575, 12831, 13087, 13343, 13599, 13855, 14111, 14367, 14623, 14879, 15135, 15391 },
+			{ 0, 256, 512, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527, 783, 1039, 1295, 1551, 1807, 2063, 2319, 2575, 2831, 3087, 3343, 3599, 3855, 4111, 4367, 4623, 4879, 5135, 5391, 5647, 5903, 6159, 6415, 6671, 6927, 7183, 7439, 7695, 7951, 8207, 8463, 8719, 8975, 9231, 9487, 9743, 9999, 10255, 10511, 10767, 11023, 11279, 11535, 11791, 12047, 12303, 12559, 12815, 13071, 13327, 13583, 13839, 14095, 14351, 14607, 14863, 15119, 15375, 15631, 15887, 16143, 16399, 16655, 16911, 17167, 17423, 17679, 17935, 18191, 18447, 18703, 18959, 19215, 19471, 19727, 19983, 20239, 20495 },
+			{ 0, 256, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543, 799, 1055, 1311, 1567, 1823, 2079, 2335, 2591, 2847, 3103, 3359, 3615, 3871, 4127, 4383, 4639, 4895, 5151, 5407, 5663, 5919, 6175, 6431, 6687, 6943, 7199, 7455, 7711, 7967, 8223, 8479, 8735, 8991, 9247, 9503, 9759, 10015, 10271, 10527, 10783, 11039, 11295, 11551, 11807, 12063, 12319, 12575, 12831, 13087, 13343, 13599, 13855, 14111, 14367, 14623, 14879, 15135, 15391, 15647, 15903, 16159, 16415, 16671, 16927, 17183, 17439, 17695, 17951, 18207, 18463, 18719, 18975, 19231, 19487, 19743, 19999, 20255, 20511 },
+			{ 0, 256, 512, 768, 1024, 1280, 1536, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527, 783, 1039, 1295, 1551, 1807, 2063, 2319, 2575, 2831, 3087, 3343, 3599, 3855, 4111, 4367, 4623, 4879, 5135, 5391, 5647, 5903, 6159, 6415, 6671, 6927, 7183, 7439, 7695, 7951, 8207, 8463, 8719, 8975, 9231, 9487, 9743, 9999, 10255, 10511, 10767, 11023, 11279, 11535, 11791, 12047, 12303, 12559, 12815, 13071, 13327, 13583, 13839, 14095, 14351, 14607, 14863, 15119, 15375, 15631, 15887, 16143, 16399, 16655, 16911, 17167, 17423, 17679, 17935, 18191, 18447, 18703, 18959, 19215, 19471, 19727, 19983, 20239, 20495, 20751, 21007, 21263, 21519, 21775, 22031, 22287, 22543, 22799, 23055, 23311, 23567, 23823, 24079, 24335, 24591, 24847, 25103, 25359, 25615, 25871, 26127, 26383, 26639, 26895, 27151 },
+			{ 0, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543, 799, 1055, 1311, 1567, 1823, 2079, 2335, 2591, 2847, 3103, 3359, 3615, 3871, 4127, 4383, 4639, 4895, 5151, 5407, 5663, 5919, 6175, 6431, 6687, 6943, 7199, 7455, 7711, 7967, 8223, 8479, 8735, 8991, 9247, 9503, 9759, 10015, 10271, 10527, 10783, 11039, 11295, 11551, 11807, 12063, 12319, 12575, 12831, 13087, 13343, 13599, 13855, 14111, 14367, 14623, 14879, 15135, 15391, 15647, 15903, 16159, 16415, 16671, 16927, 17183, 17439, 17695, 17951, 18207, 18463, 18719, 18975, 19231, 19487, 19743, 19999, 20255, 20511, 20767, 21023, 21279, 21535, 21791, 22047, 22303, 22559, 22815, 23071, 23327, 23583, 23839, 24095, 24351, 24607, 24863, 25119, 25375, 25631, 25887, 26143, 26399, 26655, 26911, 27167 },
+			{ 0, 256, 512, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527, 783, 1039, 1295, 1551, 1807, 2063, 2319, 2575, 2831, 3087, 3343, 3599, 3855, 4111, 4367, 4623, 4879, 5135, 5391, 5647, 5903, 6159, 6415, 6671, 6927, 7183, 7439, 7695, 7951, 8207, 8463, 8719, 8975, 9231, 9487, 9743, 9999, 10255, 10511, 10767, 11023, 11279, 11535, 11791, 12047, 12303, 12559, 12815, 13071, 13327, 13583, 13839, 14095, 14351, 14607, 14863, 15119, 15375, 15631, 15887, 16143, 16399, 16655, 16911, 17167, 17423, 17679, 17935, 18191, 18447, 18703, 18959, 19215, 19471, 19727, 19983, 20239, 20495, 20751, 21007, 21263, 21519, 21775, 22031, 22287, 22543, 22799, 23055, 23311, 23567, 23823, 24079, 24335, 24591, 24847, 25103, 25359, 25615, 25871, 26127, 26383, 26639, 26895, 27151, 27407, 27663, 27919, 28175, 28431, 28687, 28943, 29199, 29455, 29711, 29967, 30223, 30479, 30735, 30991, 31247, 31503, 31759, 32015, 32271, 32527, 32783, 33039, 33295, 33551, 33807, 34063, 34319, 34575, 34831, 35087, 35343, 35599, 35855, 36111, 36367, 36623, 36879, 37135, 37391, 37647, 37903, 38159, 38415, 38671, 38927, 39183, 39439, 39695, 39951, 40207, 40463, 40719, 40975, 41231, 41487, 41743, 41999, 42255, 42511, 42767, 43023, 43279, 43535, 43791, 44047, 44303, 44559, 44815, 45071, 45327, 45583, 45839, 46095, 46351, 46607, 46863 },
+			{ 0, 256, 512, 768, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543, 799, 1055, 1311, 1567, 1823, 2079, 2335, 2591, 2847, 3103, 3359, 3615, 3871, 4127, 4383, 4639, 4895, 5151, 5407, 5663, 5919, 6175, 6431, 6687, 6943, 7199, 7455, 7711, 7967, 8223, 8479, 8735, 8991, 9247, 9503, 9759, 10015, 10271, 10527, 10783, 11039, 11295, 11551, 11807, 12063, 12319, 12575, 12831, 13087, 13343, 13599, 13855, 14111, 14367, 14623, 14879, 15135, 15391, 15647, 15903, 16159, 16415, 16671, 16927, 17183, 17439, 17695, 17951, 18207, 18463, 18719, 18975, 19231, 19487, 19743, 19999, 20255, 20511, 20767, 21023, 21279, 21535, 21791, 22047, 22303, 22559, 22815, 23071, 23327, 23583, 23839, 24095, 24351, 24607, 24863, 25119, 25375, 25631, 25887, 26143, 26399, 26655, 26911, 27167, 27423, 27679, 27935, 28191, 28447, 28703, 28959, 29215, 29471, 29727, 29983, 30239, 30495, 30751, 31007, 31263, 31519, 31775, 32031, 32287, 32543, 32799, 33055, 33311, 33567, 33823, 34079, 34335, 34591, 34847, 35103, 35359, 35615, 35871, 36127, 36383, 36639, 36895, 37151, 37407, 37663, 37919, 38175, 38431, 38687, 38943, 39199, 39455, 39711, 39967, 40223, 40479, 40735, 40991, 41247, 41503, 41759, 42015, 42271, 42527, 42783, 43039, 43295, 43551, 43807, 44063, 44319, 44575, 44831, 45087, 45343, 45599, 45855, 46111, 46367, 46623, 46879 },
+			{ 0, 256, 512, 768, 1024, 1280, 1536, 1792, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527 },
+			{ 0, 256, 512, 768, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543 },
+			{ 0, 256, 512, 768, 1024, 1280, 1536, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527, 783, 1039, 1295 },
+			{ 0, 256, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543, 799, 1055, 1311 },
+			{ 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527, 783, 1039, 1295, 1551, 1807, 2063, 2319 },
+			{ 0, 256, 512, 768, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543, 799, 1055, 1311, 1567, 1823, 2079, 2335 },
+			{ 0, 256, 512, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527, 783, 1039, 1295, 1551, 1807, 2063, 2319, 2575, 2831, 3087, 3343 },
+			{ 0, 256, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543, 799, 1055, 1311, 1567, 1823, 2079, 2335, 2591, 2847, 3103, 3359 },
+			{ 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527, 783, 1039, 1295, 1551, 1807, 2063, 2319, 2575, 2831, 3087, 3343, 3599, 3855, 4111, 4367, 4623 },
+			{ 0, 256, 512, 768, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543, 799, 1055, 1311, 1567, 1823, 2079, 2335, 2591, 2847, 3103, 3359, 3615, 3871, 4127, 4383, 4639 },
+			{ 0, 256, 512, 768, 1024, 1280, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527, 783, 1039, 1295, 1551, 1807, 2063, 2319, 2575, 2831, 3087, 3343, 3599, 3855, 4111, 4367, 4623, 4879, 5135, 5391, 5647, 5903, 6159 },
+			{ 0, 256, 512, 768, 1024, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543, 799, 1055, 1311, 1567, 1823, 2079, 2335, 2591, 2847, 3103, 3359, 3615, 3871, 4127, 4383, 4639, 4895, 5151, 5407, 5663, 5919, 6175 },
+			{ 0, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527, 783, 1039, 1295, 1551, 1807, 2063, 2319, 2575, 2831, 3087, 3343, 3599, 3855, 4111, 4367, 4623, 4879, 5135, 5391, 5647, 5903, 6159, 6415, 6671, 6927, 7183, 7439, 7695, 7951, 8207, 8463 },
+			{ 0, 256, 512, 768, 1024, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543, 799, 1055, 1311, 1567, 1823, 2079, 2335, 2591, 2847, 3103, 3359, 3615, 3871, 4127, 4383, 4639, 4895, 5151, 5407, 5663, 5919, 6175, 6431, 6687, 6943, 7199, 7455, 7711, 7967, 8223, 8479 },
+			{ 0, 256, 512, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 2062, 2063, 1807, 1551, 1295, 1039, 783, 527, 271, 15, 271, 527, 783, 1039, 1295, 1551, 1807, 2063, 2319, 2575, 2831, 3087, 3343, 3599, 3855, 4111, 4367, 4623, 4879, 5135, 5391, 5647, 5903, 6159, 6415, 6671, 6927, 7183, 7439, 7695, 7951, 8207, 8463, 8719, 8975, 9231, 9487, 9743, 9999, 10255, 10511, 10767, 11023, 11279, 11535, 11791, 12047 },
+			{ 0, 256, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 1054, 799, 543, 287, 31, 287, 543, 799, 1055, 1311, 1567, 1823, 2079, 2335, 2591, 2847, 3103, 3359, 3615, 3871, 4127, 4383, 4639, 4895, 5151, 5407, 5663, 5919, 6175, 6431, 6687, 6943, 7199, 7455, 7711, 7967, 8223, 8479, 8735, 8991, 9247, 9503, 9759, 10015, 10271, 10527, 10783, 11039, 11295, 11551, 11807, 12063 },
+			{ 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1806, 1807, 1551, 1295, 1039, 783, 527, 271, 15 },
+			{ 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 542, 798, 543, 287, 31 },
+			{ 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1294, 1550, 1295, 1039, 783, 527, 271, 15 },
+			{ 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30, 286, 287, 31 },
+			{ 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15 },
+			{ 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 798, 542, 286, 30 },
+			{ 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 271, 15 },
+			{ 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 286, 30 },
+			{ 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 1806, 1550, 1294, 1038, 782, 526, 270, 14 },
+			{ 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 541, 285, 29 },
+			{ 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1038, 782, 526, 270, 14 },
+			{ 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28 },
+			{ 8448, 8192, 7936, 7680, 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 14 },
+			{ 8448, 8192, 7936, 7680, 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27 },
+			{ 12032, 11776, 11520, 11264, 11008, 10752, 10496, 10240, 9984, 9728, 9472, 9216, 8960, 8704, 8448, 8192, 7936, 7680, 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 269, 13 },
+			{ 12032, 11776, 11520, 11264, 11008, 10752, 10496, 10240, 9984, 9728, 9472, 9216, 8960, 8704, 8448, 8192, 7936, 7680, 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 26 },
+			{ 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14, 270, 526, 782, 1038, 1039, 783, 527, 271, 15 },
+			{ 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 1052, 797, 541, 285, 29, 285, 541, 797, 1053, 798, 542, 286, 30 },
+			{ 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 781, 1037, 1293, 1549, 1805, 2061, 2062, 1806, 1550, 1294, 1038, 782, 526, 270, 14 },
+			{ 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 795, 1051, 1052, 796, 540, 284, 28, 284, 540, 796, 797, 541, 285, 29 },
+			{ 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1292, 1548, 1804, 2060, 2061, 1805, 1549, 1293, 1037, 781, 525, 269, 13, 269, 525, 526, 270, 14 },
+			{ 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 1049, 794, 538, 282, 26, 282, 538, 794, 1050, 795, 539, 283, 27, 283, 539, 284, 28 },
+			{ 10752, 10496, 10240, 9984, 9728, 9472, 9216, 8960, 8704, 8448, 8192, 7936, 7680, 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 1291, 1547, 1803, 2059, 2060, 1804, 1548, 1292, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 1037, 781, 525, 269, 13 },
+			{ 10752, 10496, 10240, 9984, 9728, 9472, 9216, 8960, 8704, 8448, 8192, 7936, 7680, 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 1047, 1048, 792, 536, 280, 24, 280, 536, 792, 1048, 793, 537, 281, 25, 281, 537, 793, 794, 538, 282, 26 },
+			{ 15360, 15104, 14848, 14592, 14336, 14080, 13824, 13568, 13312, 13056, 12800, 12544, 12288, 12032, 11776, 11520, 11264, 11008, 10752, 10496, 10240, 9984, 9728, 9472, 9216, 8960, 8704, 8448, 8192, 7936, 7680, 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 778, 1034, 1290, 1546, 1802, 2058, 2059, 1803, 1547, 1291, 1035, 779, 523, 267, 11, 267, 523, 779, 1035, 780, 524, 268, 12 },
+			{ 15360, 15104, 14848, 14592, 14336, 14080, 13824, 13568, 13312, 13056, 12800, 12544, 12288, 12032, 11776, 11520, 11264, 11008, 10752, 10496, 10240, 9984, 9728, 9472, 9216, 8960, 8704, 8448, 8192, 7936, 7680, 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 533, 789, 1045, 790, 534, 278, 22, 278, 534, 790, 1046, 791, 535, 279, 23, 279, 535, 791, 536, 280, 24 },
+			{ 20480, 20224, 19968, 19712, 19456, 19200, 18944, 18688, 18432, 18176, 17920, 17664, 17408, 17152, 16896, 16640, 16384, 16128, 15872, 15616, 15360, 15104, 14848, 14592, 14336, 14080, 13824, 13568, 13312, 13056, 12800, 12544, 12288, 12032, 11776, 11520, 11264, 11008, 10752, 10496, 10240, 9984, 9728, 9472, 9216, 8960, 8704, 8448, 8192, 7936, 7680, 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1800, 2056, 2057, 1801, 1545, 1289, 1033, 777, 521, 265, 9, 265, 521, 777, 1033, 1289, 1545, 1801, 2057, 2058, 1802, 1546, 1290, 1034, 778, 522, 266, 10, 266, 522, 523, 267, 11 },
+			{ 20480, 20224, 19968, 19712, 19456, 19200, 18944, 18688, 18432, 18176, 17920, 17664, 17408, 17152, 16896, 16640, 16384, 16128, 15872, 15616, 15360, 15104, 14848, 14592, 14336, 14080, 13824, 13568, 13312, 13056, 12800, 12544, 12288, 12032, 11776, 11520, 11264, 11008, 10752, 10496, 10240, 9984, 9728, 9472, 9216, 8960, 8704, 8448, 8192, 7936, 7680, 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 274, 530, 786, 1042, 787, 531, 275, 19, 275, 531, 787, 1043, 1044, 788, 532, 276, 20, 276, 532, 788, 1044, 789, 533, 277, 21, 277, 22 },
+			{ 27136, 26880, 26624, 26368, 26112, 25856, 25600, 25344, 25088, 24832, 24576, 24320, 24064, 23808, 23552, 23296, 23040, 22784, 22528, 22272, 22016, 21760, 21504, 21248, 20992, 20736, 20480, 20224, 19968, 19712, 19456, 19200, 18944, 18688, 18432, 18176, 17920, 17664, 17408, 17152, 16896, 16640, 16384, 16128, 15872, 15616, 15360, 15104, 14848, 14592, 14336, 14080, 13824, 13568, 13312, 13056, 12800, 12544, 12288, 12032, 11776, 11520, 11264, 11008, 10752, 10496, 10240, 9984, 9728, 9472, 9216, 8960, 8704, 8448, 8192, 7936, 7680, 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 1284, 1540, 1796, 2052, 2053, 1797, 1541, 1285, 1029, 773, 517, 261, 5, 261, 517, 773, 1029, 1285, 1541, 1797, 2053, 2054, 1798, 1542, 1286, 1030, 774, 518, 262, 6, 262, 518, 774, 1030, 1286, 1542, 1798, 2054, 2055, 1799, 1543, 1287, 1031, 775, 519, 263, 7, 263, 519, 775, 1031, 1287, 1543, 1799, 2055, 2056, 1800, 1544, 1288, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 1288, 1544, 1545, 1289, 1033, 777, 521, 265, 9 },
+			{ 27136, 26880, 26624, 26368, 26112, 25856, 25600, 25344, 25088, 24832, 24576, 24320, 24064, 23808, 23552, 23296, 23040, 22784, 22528, 22272, 22016, 21760, 21504, 21248, 20992, 20736, 20480, 20224, 19968, 19712, 19456, 19200, 18944, 18688, 18432, 18176, 17920, 17664, 17408, 17152, 16896, 16640, 16384, 16128, 15872, 15616, 15360, 15104, 14848, 14592, 14336, 14080, 13824, 13568, 13312, 13056, 12800, 12544, 12288, 12032, 11776, 11520, 11264, 11008, 10752, 10496, 10240, 9984, 9728, 9472, 9216, 8960, 8704, 8448, 8192, 7936, 7680, 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 1032, 777, 521, 265, 9, 265, 521, 777, 1033, 778, 522, 266, 10, 266, 522, 778, 1034, 779, 523, 267, 11, 267, 523, 779, 1035, 1036, 780, 524, 268, 12, 268, 524, 780, 1036, 781, 525, 269, 13, 269, 525, 781, 1037, 782, 526, 270, 14, 270, 526, 782, 1038, 783, 527, 271, 15, 271, 527, 783, 1039, 1040, 784, 528, 272, 16, 272, 528, 784, 1040, 785, 529, 273, 17, 273, 529, 785, 1041, 786, 530, 274, 18, 19 },
+			{ 46848, 46592, 46336, 46080, 45824, 45568, 45312, 45056, 44800, 44544, 44288, 44032, 43776, 43520, 43264, 43008, 42752, 42496, 42240, 41984, 41728, 41472, 41216, 40960, 40704, 40448, 40192, 39936, 39680, 39424, 39168, 38912, 38656, 38400, 38144, 37888, 37632, 37376, 37120, 36864, 36608, 36352, 36096, 35840, 35584, 35328, 35072, 34816, 34560, 34304, 34048, 33792, 33536, 33280, 33024, 32768, 32512, 32256, 32000, 31744, 31488, 31232, 30976, 30720, 30464, 30208, 29952, 29696, 29440, 29184, 28928, 28672, 28416, 28160, 27904, 27648, 27392, 27136, 26880, 26624, 26368, 26112, 25856, 25600, 25344, 25088, 24832, 24576, 24320, 24064, 23808, 23552, 23296, 23040, 22784, 22528, 22272, 22016, 21760, 21504, 21248, 20992, 20736, 20480, 20224, 19968, 19712, 19456, 19200, 18944, 18688, 18432, 18176, 17920, 17664, 17408, 17152, 16896, 16640, 16384, 16128, 15872, 15616, 15360, 15104, 14848, 14592, 14336, 14080, 13824, 13568, 13312, 13056, 12800, 12544, 12288, 12032, 11776, 11520, 11264, 11008, 10752, 10496, 10240, 9984, 9728, 9472, 9216, 8960, 8704, 8448, 8192, 7936, 7680, 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048, 2049, 1793, 1537, 1281, 1025, 769, 513, 257, 1, 257, 513, 769, 1025, 1281, 1537, 1793, 2049, 2050, 1794, 1538, 1282, 1026, 770, 514, 258, 2, 258, 514, 770, 1026, 1282, 1538, 1794, 2050, 2051, 1795, 1539, 1283, 1027, 771, 515, 259, 3, 259, 515, 771, 1027, 1283, 1539, 1795, 2051, 2052, 1796, 1540, 1284, 1028, 772, 516, 260, 4, 260, 516, 261, 5 },
+			{ 46848, 46592, 46336, 46080, 45824, 45568, 45312, 45056, 44800, 44544, 44288, 44032, 43776, 43520, 43264, 43008, 42752, 42496, 42240, 41984, 41728, 41472, 41216, 40960, 40704, 40448, 40192, 39936, 39680, 39424, 39168, 38912, 38656, 38400, 38144, 37888, 37632, 37376, 37120, 36864, 36608, 36352, 36096, 35840, 35584, 35328, 35072, 34816, 34560, 34304, 34048, 33792, 33536, 33280, 33024, 32768, 32512, 32256, 32000, 31744, 31488, 31232, 30976, 30720, 30464, 30208, 29952, 29696, 29440, 29184, 28928, 28672, 28416, 28160, 27904, 27648, 27392, 27136, 26880, 26624, 26368, 26112, 25856, 25600, 25344, 25088, 24832, 24576, 24320, 24064, 23808, 23552, 23296, 23040, 22784, 22528, 22272, 22016, 21760, 21504, 21248, 20992, 20736, 20480, 20224, 19968, 19712, 19456, 19200, 18944, 18688, 18432, 18176, 17920, 17664, 17408, 17152, 16896, 16640, 16384, 16128, 15872, 15616, 15360, 15104, 14848, 14592, 14336, 14080, 13824, 13568, 13312, 13056, 12800, 12544, 12288, 12032, 11776, 11520, 11264, 11008, 10752, 10496, 10240, 9984, 9728, 9472, 9216, 8960, 8704, 8448, 8192, 7936, 7680, 7424, 7168, 6912, 6656, 6400, 6144, 5888, 5632, 5376, 5120, 4864, 4608, 4352, 4096, 3840, 3584, 3328, 3072, 2816, 2560, 2304, 2048, 1792, 1536, 1280, 1024, 768, 512, 256, 0, 256, 512, 768, 1024, 769, 513, 257, 1, 257, 513, 769, 1025, 770, 514, 258, 2, 258, 514, 770, 1026, 771, 515, 259, 3, 259, 515, 771, 1027, 1028, 772, 516, 260, 4, 260, 516, 772, 1028, 773, 517, 261, 5, 261, 517, 773, 1029, 774, 518, 262, 6, 262, 518, 774, 1030, 775, 519, 263, 7, 263, 519, 775, 1031, 1032, 776, 520, 264, 8, 264, 520, 776, 521, 265, 9 }
+		};
+	}
+}
@@ -11,10 +11,11 @@
 /////////////////////////////////////////////////////////////////////////////////
 
 #include <KlayGE/KlayGE.hpp>
-#include <KlayGE/Player.hpp>
+#include <KFL/ErrorHandling.hpp>
 
 #include <algorithm>
-#include <ctime>
+#include <cerrno>
+#include <chrono>
 #include <cstring>
 
 #include <KlayGE/NetMsg.hpp>
@@ -22,12 +23,149 @@
 
 #ifndef KLAYGE_PLATFORM_WINDOWS_STORE
 
+#if defined KLAYGE_PLATFORM_LINUX
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	using namespace KlayGE;
+
+	// The largest UDP payload over IPv4
+	uint32_t const MAX_UDP_PAYLOAD = 65507;
+	uint32_t const NAME_LEN = 16;
+
+	uint64_t AddrKey(sockaddr_in const & addr)
+	{
+		return (static_cast<uint64_t>(addr.sin_addr.s_addr) << 16) | addr.sin_port;
+	}
+
+	// Reads up to max_num datagrams without blocking, each into a stride bytes slot of data. Truncated ones get
+	//  a size of -1. Returns the number read.
+	uint32_t ReceiveBatch(SOCKET s, char* data, uint32_t stride, sockaddr_in* froms, int* sizes, uint32_t max_num)
+	{
+#if defined KLAYGE_PLATFORM_LINUX
+		mmsghdr msgs[Lobby::BATCH_SIZE];
+		iovec iovs[Lobby::BATCH_SIZE];
+		if (max_num > Lobby::BATCH_SIZE)
+		{
+			max_num = Lobby::BATCH_SIZE;
+		}
+		for (uint32_t i = 0; i < max_num; ++ i)
+		{
+			iovs[i].iov_base = data + i * stride;
+			iovs[i].iov_len = stride;
+
+			std::memset(&msgs[i], 0, sizeof(msgs[i]));
+			msgs[i].msg_hdr.msg_name = &froms[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(froms[i]);
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		int const num = recvmmsg(s, msgs, max_num, MSG_DONTWAIT, nullptr);
+		if (num <= 0)
+		{
+			return 0;
+		}
+
+		for (int i = 0; i < num; ++ i)
+		{
+			sizes[i] = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) ? -1 : static_cast<int>(msgs[i].msg_len);
+		}
+		return static_cast<uint32_t>(num);
+#else
+		uint32_t num = 0;
+		for (; num < max_num; ++ num)
+		{
+			socklen_t from_len = sizeof(froms[num]);
+			int const size = recvfrom(s, data + num * stride, static_cast<int>(stride), 0,
+				reinterpret_cast<sockaddr*>(&froms[num]), &from_len);
+			if (size < 0)
+			{
+#if defined KLAYGE_PLATFORM_WINDOWS
+				if (WSAGetLastError() == WSAEMSGSIZE)
+				{
+					sizes[num] = -1;
+					continue;
+				}
+#endif
+				break;
+			}
+			sizes[num] = size;
+		}
+		return num;
+#endif
+	}
+
+	// Sends the datagrams until the socket would block. Ones failing for other reasons are dropped. Returns the
+	//  number of datagrams done with.
+	template <typename OutMsg>
+	uint32_t SendBatch(SOCKET s, char const * data, OutMsg const * out_msgs, uint32_t num)
+	{
+#if defined KLAYGE_PLATFORM_LINUX
+		mmsghdr msgs[Lobby::BATCH_SIZE];
+		iovec iovs[Lobby::BATCH_SIZE];
+		if (num > Lobby::BATCH_SIZE)
+		{
+			num = Lobby::BATCH_SIZE;
+		}
+		for (uint32_t i = 0; i < num; ++ i)
+		{
+			iovs[i].iov_base = const_cast<char*>(data + out_msgs[i].offset);
+			iovs[i].iov_len = out_msgs[i].size;
+
+			std::memset(&msgs[i], 0, sizeof(msgs[i]));
+			msgs[i].msg_hdr.msg_name = const_cast<sockaddr_in*>(&out_msgs[i].addr);
+			msgs[i].msg_hdr.msg_namelen = sizeof(out_msgs[i].addr);
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+
+		int const sent = sendmmsg(s, msgs, num, MSG_DONTWAIT);
+		if (sent < 0)
+		{
+			return ((EAGAIN == errno) || (EWOULDBLOCK == errno)) ? 0 : 1;
+		}
+		return static_cast<uint32_t>(sent);
+#else
+		uint32_t i = 0;
+		for (; i < num; ++ i)
+		{
+			if (sendto(s, data + out_msgs[i].offset, static_cast<int>(out_msgs[i].size), 0,
+				reinterpret_cast<sockaddr const *>(&out_msgs[i].addr), sizeof(out_msgs[i].addr)) < 0)
+			{
+#if defined KLAYGE_PLATFORM_WINDOWS
+				if (WSAGetLastError() == WSAEWOULDBLOCK)
+#else
+				if ((EAGAIN == errno) || (EWOULDBLOCK == errno))
+#endif
+				{
+					break;
+				}
+			}
+		}
+		return i;
+#endif
+	}
+}
+
 namespace KlayGE
 {
 	// 캯
 	/////////////////////////////////////////////////////////////////////////////////
 	Lobby::Lobby()
+		: num_players_(0),
+			max_datagram_size_(1472), player_time_out_(20 * 1000),
+			timer_wheel_(NUM_WHEEL_SLOTS), curr_tick_(0),
+			num_sent_msgs_(0),
+			quit_(false)
+#if defined KLAYGE_PLATFORM_LINUX
+			, epoll_fd_(-1)
+#endif
 	{
+		std::memset(&sockAddr_, 0, sizeof(sockAddr_));
 		this->socket_.Create(SOCK_DGRAM);
 	}
 
@@ -35,122 +173,237 @@ namespace KlayGE
 	/////////////////////////////////////////////////////////////////////////////////
 	Lobby::~Lobby()
 	{
-		Close();
+#if defined KLAYGE_PLATFORM_LINUX
+		if (epoll_fd_ != -1)
+		{
+			close(epoll_fd_);
+		}
+#endif
 	}
 
-	Lobby::PlayerAddrsIter Lobby::ID(sockaddr_in const & addr)
+	uint32_t Lobby::ID(sockaddr_in const & addr) const
 	{
-		for (auto iter = players_.begin(); iter != players_.end(); ++ iter)
+		auto iter = player_indices_.find(AddrKey(addr));
+		if (iter != player_indices_.end())
 		{
-			if (0 == std::memcmp(&addr, &(iter->second.addr), sizeof(addr)))
-			{
-				return iter;
-			}
+			return iter->second;
+		}
+
+		return static_cast<uint32_t>(-1);
+	}
+
+	uint32_t Lobby::PlayerIndex(uint32_t id) const
+	{
+		uint32_t const index = (id & ((1UL << PLAYER_INDEX_BITS) - 1)) - 1;
+		if ((index < players_.size()) && (players_[index].id == id))
+		{
+			return index;
 		}
 
-		return players_.end();
+		return static_cast<uint32_t>(-1);
 	}
 
 	// Ϸ
 	/////////////////////////////////////////////////////////////////////////////////
-	void Lobby::Create(std::string const & Name, char maxPlayers, uint16_t port, Processor const & pro)
+	void Lobby::Create(std::string const & name, uint32_t maxPlayers, uint16_t port)
 	{
-		this->LobbyName(Name);
-
+		this->LobbyName(name);
 		this->MaxPlayers(maxPlayers);
 
 		this->socket_.Bind(TransAddr("", port));
+		this->socket_.NonBlock(true);
 
-		sockaddr_in from;
-		char revBuf[Max_Buffer];
-		char sendBuf[Max_Buffer];
-		int numSend = 0;
-		for (;;)
-		{
-			this->Receive(revBuf, sizeof(revBuf), from);
+		// Bursts from thousands of players overflow the default buffers. The OS caps these silently.
+		int buf_size = 4 * 1024 * 1024;
+		this->socket_.SetSockOpt(SO_RCVBUF, &buf_size, sizeof(buf_size));
+		this->socket_.SetSockOpt(SO_SNDBUF, &buf_size, sizeof(buf_size));
 
-			// ÿϢǰ涼1ֽڵϢ
-			char* revPtr(&revBuf[1]);
-			char* sendPtr(&sendBuf[1]);
-			sendBuf[0] = revBuf[0];
+		socklen_t len = sizeof(sockAddr_);
+		this->socket_.SockName(sockAddr_, len);
 
-			switch (revBuf[0])
-			{
-			case MSG_JOIN:
-				this->OnJoin(revPtr, sendPtr, numSend, from, pro);
-				break;
+#if defined KLAYGE_PLATFORM_LINUX
+		if (epoll_fd_ == -1)
+		{
+			epoll_fd_ = epoll_create1(0);
+			Verify(epoll_fd_ != -1);
+		}
+		epoll_event ev;
+		ev.events = EPOLLIN;
+		ev.data.u64 = 0;
+		Verify(epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, socket_.Handle(), &ev) != -1);
+#endif
 
-			case MSG_QUIT:
-				this->OnQuit(this->ID(from), sendPtr, numSend, pro);
-				break;
+		quit_ = false;
+	}
 
-			case MSG_GETLOBBYINFO:
-				this->OnGetLobbyInfo(sendPtr, numSend, pro);
-				break;
+	void Lobby::Create(std::string const & name, uint32_t maxPlayers, uint16_t port, Processor const & pro)
+	{
+		this->Create(name, maxPlayers, port);
+		this->Run(pro);
+	}
 
-			case MSG_NOP:
-				this->OnNop(this->ID(from));
-				break;
+	void Lobby::Run(Processor const & pro)
+	{
+		std::vector<char> rev_data(BATCH_SIZE * max_datagram_size_);
+		std::vector<char> send_buf(max_datagram_size_);
+		sockaddr_in froms[BATCH_SIZE];
+		int sizes[BATCH_SIZE];
+
+		auto const start_time = std::chrono::steady_clock::now();
+		uint64_t const start_tick = curr_tick_;
+		bool send_blocked = false;
+#if defined KLAYGE_PLATFORM_LINUX
+		bool waiting_out = false;
+#endif
 
-			default:
-				pro.OnDefault(revBuf, sizeof(revBuf), sendBuf, numSend, from);
-				break;
+		while (!quit_)
+		{
+#if defined KLAYGE_PLATFORM_LINUX
+			if (waiting_out != send_blocked)
+			{
+				epoll_event ev;
+				ev.events = send_blocked ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+				ev.data.u64 = 0;
+				Verify(epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, socket_.Handle(), &ev) != -1);
+				waiting_out = send_blocked;
 			}
 
-			if (numSend != 0)
+			epoll_event events[1];
+			epoll_wait(epoll_fd_, events, 1, TICK_MS);
+#else
+			fd_set read_fds;
+			fd_set write_fds;
+			FD_ZERO(&read_fds);
+			FD_ZERO(&write_fds);
+			FD_SET(socket_.Handle(), &read_fds);
+			if (send_blocked)
 			{
-				this->Send(sendBuf, numSend + 1, from);
+				FD_SET(socket_.Handle(), &write_fds);
 			}
+			timeval time_out;
+			time_out.tv_sec = 0;
+			time_out.tv_usec = TICK_MS * 1000;
+			select(static_cast<int>(socket_.Handle() + 1), &read_fds, &write_fds, nullptr, &time_out);
+#endif
 
-			// Ϣ
-			for (auto const & player : players_)
+			// A few batches at most, so the replies go out before the socket is drained
+			for (int batch = 0; batch < 16; ++ batch)
 			{
-				auto const & msgs = player.second.msgs;
-				for (auto const & msg : msgs)
+				uint32_t const num = ReceiveBatch(socket_.Handle(), &rev_data[0], max_datagram_size_,
+					froms, sizes, BATCH_SIZE);
+				for (uint32_t i = 0; i < num; ++ i)
+				{
+					this->OnReceive(&rev_data[i * max_datagram_size_], sizes[i], froms[i], &send_buf[0], pro);
+				}
+				if (num < BATCH_SIZE)
 				{
-					socket_.SendTo(&msg[0], static_cast<int>(msg.size()), player.second.addr);
+					break;
 				}
 			}
 
-			// Ƿûʱ
-			for (auto iter = players_.begin(); iter != players_.end();)
 			{
-				// 20
-				if (std::time(nullptr) - iter->second.time >= 20 * 1000)
+				std::lock_guard<std::mutex> lock(pending_mutex_);
+				for (auto const & msg : pending_msgs_)
 				{
-					iter = players_.erase(iter);
-				}
-				else
-				{
-					++ iter;
+					if (msg.player_id != 0)
+					{
+						uint32_t const index = this->PlayerIndex(msg.player_id);
+						if (index != static_cast<uint32_t>(-1))
+						{
+							this->QueueSend(&pending_data_[msg.offset], msg.size, players_[index].addr);
+						}
+					}
+					else
+					{
+						this->QueueSend(&pending_data_[msg.offset], msg.size, msg.addr);
+					}
 				}
+				pending_data_.clear();
+				pending_msgs_.clear();
+			}
+
+			send_blocked = !this->FlushSends();
+
+			uint64_t const now_tick = start_tick + std::chrono::duration_cast<std::chrono::milliseconds>(
+				std::chrono::steady_clock::now() - start_time).count() / TICK_MS;
+			while (curr_tick_ < now_tick)
+			{
+				++ curr_tick_;
+				this->Tick(curr_tick_, pro);
 			}
 		}
 	}
 
-	// 
-	/////////////////////////////////////////////////////////////////////////////////
-	char Lobby::NumPlayer() const
+	void Lobby::OnReceive(char* revBuf, int size, sockaddr_in const & from, char* sendBuf, Processor const & pro)
 	{
-		char n = 0;
-		for (auto const & player : players_)
+		// Empty ones only wake Run up
+		if (size <= 0)
+		{
+			return;
+		}
+
+		uint32_t const index = this->ID(from);
+		if (index != static_cast<uint32_t>(-1))
+		{
+			players_[index].last_active = curr_tick_;
+		}
+
+		// ÿϢǰ涼1ֽڵϢ
+		char* revPtr(&revBuf[1]);
+		char* sendPtr(&sendBuf[1]);
+		sendBuf[0] = revBuf[0];
+		int numSend = 0;
+
+		switch (revBuf[0])
 		{
-			if (player.first != 0)
+		case MSG_JOIN:
+			this->OnJoin(revPtr, size - 1, sendPtr, numSend, from, pro);
+			break;
+
+		case MSG_QUIT:
+			this->OnQuit(index, sendPtr, numSend, pro);
+			break;
+
+		case MSG_GETLOBBYINFO:
+			this->OnGetLobbyInfo(sendPtr, numSend);
+			break;
+
+		case MSG_NOP:
+			break;
+
+		default:
 			{
-				++ n;
+				sockaddr_in reply_to = from;
+				pro.OnDefault(revBuf, size, sendBuf, numSend, reply_to);
+				if (numSend != 0)
+				{
+					this->QueueSend(sendBuf, numSend + 1, reply_to);
+				}
+				numSend = 0;
 			}
+			break;
 		}
 
-		return n;
+		if (numSend != 0)
+		{
+			this->QueueSend(sendBuf, numSend + 1, from);
+		}
+	}
+
+	// 
+	/////////////////////////////////////////////////////////////////////////////////
+	uint32_t Lobby::NumPlayer() const
+	{
+		return num_players_;
 	}
 
 	// ô
 	/////////////////////////////////////////////////////////////////////////////////
 	void Lobby::LobbyName(std::string const & name)
 	{
-		if (name.length() > 16)
+		if (name.length() > NAME_LEN)
 		{
-			this->name_ = name.substr(0, 16);
+			this->name_ = name.substr(0, NAME_LEN);
 		}
 		else
 		{
@@ -167,96 +420,199 @@ namespace KlayGE
 
 	// 
 	/////////////////////////////////////////////////////////////////////////////////
-	void Lobby::MaxPlayers(char maxPlayers)
+	void Lobby::MaxPlayers(uint32_t maxPlayers)
 	{
-		players_.resize(maxPlayers);
-		PlayerAddrs(players_).swap(players_);
+		BOOST_ASSERT(maxPlayers < (1UL << PLAYER_INDEX_BITS));
 
+		players_.assign(maxPlayers, PlayerDes());
 		for (auto& player : players_)
 		{
-			player.first = 0;
+			player.id = 0;
+			player.generation = 0;
+			player.last_active = 0;
+		}
+
+		free_players_.resize(maxPlayers);
+		for (uint32_t i = 0; i < maxPlayers; ++ i)
+		{
+			free_players_[i] = maxPlayers - 1 - i;
+		}
+
+		player_indices_.clear();
+		player_indices_.reserve(maxPlayers);
+		num_players_ = 0;
+
+		for (auto& slot : timer_wheel_)
+		{
+			slot.clear();
 		}
 	}
 
 	// ȡ
 	/////////////////////////////////////////////////////////////////////////////////
-	char Lobby::MaxPlayers() const
+	uint32_t Lobby::MaxPlayers() const
+	{
+		return static_cast<uint32_t>(this->players_.size());
+	}
+
+	void Lobby::MaxDatagramSize(uint32_t size)
+	{
+		max_datagram_size_ = std::min(std::max(size, Max_Buffer), MAX_UDP_PAYLOAD);
+	}
+
+	uint32_t Lobby::MaxDatagramSize() const
+	{
+		return max_datagram_size_;
+	}
+
+	void Lobby::PlayerTimeOut(uint32_t ms)
 	{
-		return static_cast<char>(this->players_.size());
+		player_time_out_ = ms;
+	}
+
+	uint32_t Lobby::PlayerTimeOut() const
+	{
+		return player_time_out_;
 	}
 
 	// رϷ
 	/////////////////////////////////////////////////////////////////////////////////
 	void Lobby::Close()
 	{
-		this->socket_.Close();
+		quit_ = true;
+		this->Wake();
 	}
 
 	// 
 	/////////////////////////////////////////////////////////////////////////////////
-	int Lobby::Receive(void* buf, int maxSize, sockaddr_in& from)
+	void Lobby::Send(void const * buf, int size, sockaddr_in const & to)
 	{
-		return this->socket_.ReceiveFrom(buf, maxSize, from);
+		this->QueuePending(buf, size, to, 0);
 	}
 
-	// 
-	/////////////////////////////////////////////////////////////////////////////////
-	int Lobby::Send(void const * buf, int maxSize, sockaddr_in const & to)
+	void Lobby::SendToPlayer(uint32_t id, void const * buf, int size)
 	{
-		return this->socket_.SendTo(buf, maxSize, to);
+		sockaddr_in to;
+		std::memset(&to, 0, sizeof(to));
+		this->QueuePending(buf, size, to, id);
 	}
 
+	void Lobby::QueuePending(void const * buf, int size, sockaddr_in const & to, uint32_t player_id)
+	{
+		BOOST_ASSERT(static_cast<uint32_t>(size) <= max_datagram_size_);
+
+		// Run drains the whole queue, so only the first message after a drain has to wake it up
+		bool was_empty;
+		{
+			std::lock_guard<std::mutex> lock(pending_mutex_);
+
+			was_empty = pending_msgs_.empty();
+
+			OutMsg msg;
+			msg.addr = to;
+			msg.player_id = player_id;
+			msg.offset = static_cast<uint32_t>(pending_data_.size());
+			msg.size = size;
+			pending_msgs_.push_back(msg);
+
+			char const * p = static_cast<char const *>(buf);
+			pending_data_.insert(pending_data_.end(), p, p + size);
+		}
+
+		if (was_empty)
+		{
+			this->Wake();
+		}
+	}
 
-	void Lobby::OnJoin(char* revBuf, char* sendBuf, int& numSend,
-							sockaddr_in& from, Processor const & pro)
+	void Lobby::QueueSend(void const * buf, int size, sockaddr_in const & to)
 	{
-		// ʽ:
-		//			Player		16 ֽ
+		OutMsg msg;
+		msg.addr = to;
+		msg.player_id = 0;
+		msg.offset = static_cast<uint32_t>(send_data_.size());
+		msg.size = size;
+		send_msgs_.push_back(msg);
+
+		char const * p = static_cast<char const *>(buf);
+		send_data_.insert(send_data_.end(), p, p + size);
+	}
 
-		char id = 1;
-		auto iter = players_.begin();
-		for (; iter != this->players_.end(); ++ iter, ++ id)
+	bool Lobby::FlushSends()
+	{
+		while (num_sent_msgs_ < send_msgs_.size())
 		{
-			if (0 == iter->first)
+			uint32_t const num = SendBatch(socket_.Handle(), &send_data_[0], &send_msgs_[num_sent_msgs_],
+				static_cast<uint32_t>(std::min<size_t>(send_msgs_.size() - num_sent_msgs_, BATCH_SIZE)));
+			if (0 == num)
 			{
-				size_t i(0);
-				while (revBuf[i] != 0)
-				{
-					++ i;
-				}
-				std::string name(&revBuf[0], i);
-				iter->first			= id;
-				iter->second.name	= name;
-				iter->second.addr	= from;
-
-				pro.OnJoin(iter->first);
-				break;
+				return false;
 			}
+			num_sent_msgs_ += num;
 		}
 
-		// ظʽ:
-		//			Player ID		1 ֽ
+		send_data_.clear();
+		send_msgs_.clear();
+		num_sent_msgs_ = 0;
+		return true;
+	}
 
-		// Ѿ
-		if (iter == players_.end())
+	void Lobby::Wake()
+	{
+		if (sockAddr_.sin_port != 0)
 		{
-			sendBuf[0] = 1;
+			sockaddr_in to = sockAddr_;
+			if (htonl(INADDR_ANY) == to.sin_addr.s_addr)
+			{
+				to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			}
+
+			char dummy = 0;
+			socket_.SendTo(&dummy, 0, to);
 		}
-		else
+	}
+
+	void Lobby::OnJoin(char* revBuf, int size, char* sendBuf, int& numSend,
+							sockaddr_in const & from, Processor const & pro)
+	{
+		// ʽ:
+		//			Player		16 ֽ
+
+		// A player whose reply got lost asks again
+		uint32_t index = this->ID(from);
+		if ((index == static_cast<uint32_t>(-1)) && !free_players_.empty())
 		{
-			sendBuf[0] = 0;
+			index = free_players_.back();
+			free_players_.pop_back();
+
+			PlayerDes& player = players_[index];
+			++ player.generation;
+			player.id = (player.generation << PLAYER_INDEX_BITS) | (index + 1);
+			size_t const max_len = std::min<size_t>(std::max(size, 0), NAME_LEN);
+			player.name.assign(revBuf, std::find(revBuf, revBuf + max_len, '\0'));
+			player.addr = from;
+			player.last_active = curr_tick_;
+
+			player_indices_.emplace(AddrKey(from), index);
+			++ num_players_;
+			this->ScheduleTimeOut(index);
+
+			pro.OnJoin(player.id);
 		}
 
-		numSend = 1;
+		// ظʽ:
+		//			Player ID		4 ֽ, Ѿ˾0
+
+		uint32_t const id = (index == static_cast<uint32_t>(-1)) ? 0 : players_[index].id;
+		std::memcpy(sendBuf, &id, sizeof(id));
+		numSend = sizeof(id);
 	}
 
-	void Lobby::OnQuit(PlayerAddrsIter iter, char* sendBuf,
-							int& numSend, Processor const & pro)
+	void Lobby::OnQuit(uint32_t index, char* sendBuf, int& numSend, Processor const & pro)
 	{
-		if (iter != this->players_.end())
+		if (index != static_cast<uint32_t>(-1))
 		{
-			pro.OnQuit(iter->first);
-			iter->first = 0;
+			this->RemovePlayer(index, pro);
 			sendBuf[0] = 0;
 		}
 		else
@@ -267,25 +623,68 @@ namespace KlayGE
 		numSend = 1;
 	}
 
-	void Lobby::OnGetLobbyInfo(char* sendBuf, int& numSend, Processor const & /*pro*/)
+	void Lobby::OnGetLobbyInfo(char* sendBuf, int& numSend)
 	{
 		// ظʽ:
-		//			ǰPlayers	1 ֽ
-		//			Players	1 ֽ
+		//			ǰPlayers	4 ֽ
+		//			Players	4 ֽ
 		//			Lobby		16 ֽ
 
-		memset(sendBuf, 0, 18);
-		sendBuf[0] = this->NumPlayer();
-		sendBuf[1] = this->MaxPlayers();
-		this->LobbyName().copy(&sendBuf[2], this->LobbyName().length());
-		numSend = 18;
+		uint32_t const num_players = this->NumPlayer();
+		uint32_t const max_players = this->MaxPlayers();
+		std::memset(sendBuf, 0, 8 + NAME_LEN);
+		std::memcpy(&sendBuf[0], &num_players, sizeof(num_players));
+		std::memcpy(&sendBuf[4], &max_players, sizeof(max_players));
+		this->LobbyName().copy(&sendBuf[8], this->LobbyName().length());
+		numSend = 8 + NAME_LEN;
+	}
+
+	void Lobby::RemovePlayer(uint32_t index, Processor const & pro)
+	{
+		PlayerDes& player = players_[index];
+		pro.OnQuit(player.id);
+
+		player_indices_.erase(AddrKey(player.addr));
+		player.id = 0;
+		free_players_.push_back(index);
+		-- num_players_;
+	}
+
+	void Lobby::ScheduleTimeOut(uint32_t index)
+	{
+		PlayerDes const & player = players_[index];
+		uint64_t const expire_tick = player.last_active + std::max(player_time_out_ / TICK_MS, 1U);
+		timer_wheel_[expire_tick % NUM_WHEEL_SLOTS].emplace_back(index, player.generation);
 	}
 
-	void Lobby::OnNop(PlayerAddrsIter iter)
+	void Lobby::Tick(uint64_t tick, Processor const & pro)
 	{
-		if (iter != this->players_.end())
+		// Entries are put back in the same slot when they expire a whole turn later
+		std::vector<std::pair<uint32_t, uint32_t>> expiring;
+		expiring.swap(timer_wheel_[tick % NUM_WHEEL_SLOTS]);
+
+		uint64_t const time_out_ticks = std::max(player_time_out_ / TICK_MS, 1U);
+		for (auto const & entry : expiring)
+		{
+			PlayerDes const & player = players_[entry.first];
+			if ((player.id != 0) && (player.generation == entry.second))
+			{
+				if (player.last_active + time_out_ticks <= tick)
+				{
+					this->RemovePlayer(entry.first, pro);
+				}
+				else
+				{
+					this->ScheduleTimeOut(entry.first);
+				}
+			}
+		}
+
+		if (timer_wheel_[tick % NUM_WHEEL_SLOTS].empty())
 		{
-			iter->second.time = static_cast<uint32_t>(std::time(nullptr));
+			// Keeps the capacity
+			expiring.clear();
+			timer_wheel_[tick % NUM_WHEEL_SLOTS].swap(expiring);
 		}
 	}
 }
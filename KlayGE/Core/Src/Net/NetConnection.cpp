@@ -0,0 +1,852 @@
+/**
+* @file NetConnection.cpp
+* @author Minmin Gong
+*
+* @section DESCRIPTION
+*
+* This source file is part of KlayGE
+* For the latest info, see http://www.klayge.org
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* You may alternatively use this source under the terms of
+* the KlayGE Proprietary License (KPL). You can obtained such a license
+* from http://www.klayge.org/licensing/.
+*/
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/ErrorHandling.hpp>
+#include <KFL/Util.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <system_error>
+
+#include <KlayGE/NetConnection.hpp>
+
+#ifndef KLAYGE_PLATFORM_WINDOWS_STORE
+
+namespace
+{
+	using namespace KlayGE;
+
+	// Sequence number, ack, ack bits
+	uint32_t const PACKET_HEADER_SIZE = 2 + 2 + 4;
+	// Channel, message id, size
+	uint32_t const MSG_HEADER_SIZE = 1 + 2 + 2;
+	// Fragment index, number of fragments - 1, total size
+	uint32_t const FRAG_HEADER_SIZE = 1 + 1 + 4;
+	// Has baseline, baseline id, state size
+	uint32_t const SNAPSHOT_HEADER_SIZE = 1 + 2 + 4;
+
+	uint8_t const SNAPSHOT_CHANNEL = 0x7F;
+	uint8_t const FRAGMENTED_BIT = 0x80;
+
+	// Keeps a big backlog from flooding the link in one go
+	uint32_t const MAX_PACKETS_PER_UPDATE = 64;
+
+	bool SeqGreater(uint16_t lhs, uint16_t rhs)
+	{
+		return static_cast<int16_t>(static_cast<uint16_t>(lhs - rhs)) > 0;
+	}
+
+	void Write8(std::vector<uint8_t>& buf, uint8_t v)
+	{
+		buf.push_back(v);
+	}
+
+	void Write16(std::vector<uint8_t>& buf, uint16_t v)
+	{
+		v = Native2LE(v);
+		uint8_t const * p = reinterpret_cast<uint8_t const *>(&v);
+		buf.insert(buf.end(), p, p + sizeof(v));
+	}
+
+	void Write32(std::vector<uint8_t>& buf, uint32_t v)
+	{
+		v = Native2LE(v);
+		uint8_t const * p = reinterpret_cast<uint8_t const *>(&v);
+		buf.insert(buf.end(), p, p + sizeof(v));
+	}
+
+	uint16_t Read16(uint8_t const * p)
+	{
+		uint16_t v;
+		std::memcpy(&v, p, sizeof(v));
+		return LE2Native(v);
+	}
+
+	uint32_t Read32(uint8_t const * p)
+	{
+		uint32_t v;
+		std::memcpy(&v, p, sizeof(v));
+		return LE2Native(v);
+	}
+
+	void WriteVarint(std::vector<uint8_t>& buf, uint32_t v)
+	{
+		while (v >= 0x80)
+		{
+			buf.push_back(static_cast<uint8_t>(v | 0x80));
+			v >>= 7;
+		}
+		buf.push_back(static_cast<uint8_t>(v));
+	}
+
+	bool ReadVarint(uint8_t const * data, uint32_t size, uint32_t& pos, uint32_t& v)
+	{
+		v = 0;
+		for (uint32_t shift = 0; shift < 35; shift += 7)
+		{
+			if (pos >= size)
+			{
+				return false;
+			}
+			uint8_t const b = data[pos];
+			++ pos;
+			v |= static_cast<uint32_t>(b & 0x7F) << shift;
+			if (!(b & 0x80))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// The state XORed with the baseline, as runs of unchanged bytes and literals. Bytes past the end of the baseline
+	//  count as 0.
+	void EncodeDelta(std::vector<uint8_t>& out, uint8_t const * state, uint32_t size, std::vector<uint8_t> const * baseline)
+	{
+		uint32_t const base_size = baseline ? static_cast<uint32_t>(baseline->size()) : 0;
+		auto delta = [state, baseline, base_size](uint32_t i)
+		{
+			return static_cast<uint8_t>(state[i] ^ ((i < base_size) ? (*baseline)[i] : 0));
+		};
+
+		uint32_t i = 0;
+		while (i < size)
+		{
+			uint32_t const run_start = i;
+			while ((i < size) && (0 == delta(i)))
+			{
+				++ i;
+			}
+			uint32_t const lit_start = i;
+			while ((i < size) && (delta(i) != 0))
+			{
+				++ i;
+			}
+
+			WriteVarint(out, lit_start - run_start);
+			WriteVarint(out, i - lit_start);
+			for (uint32_t j = lit_start; j < i; ++ j)
+			{
+				out.push_back(delta(j));
+			}
+		}
+	}
+
+	bool DecodeDelta(std::vector<uint8_t>& state, uint32_t size, uint8_t const * data, uint32_t data_size,
+		std::vector<uint8_t> const * baseline)
+	{
+		uint32_t const base_size = baseline ? static_cast<uint32_t>(baseline->size()) : 0;
+		state.resize(size);
+		for (uint32_t i = 0; i < size; ++ i)
+		{
+			state[i] = (i < base_size) ? (*baseline)[i] : 0;
+		}
+
+		uint32_t pos = 0;
+		uint32_t i = 0;
+		while (i < size)
+		{
+			uint32_t run;
+			uint32_t lit;
+			if (!ReadVarint(data, data_size, pos, run) || !ReadVarint(data, data_size, pos, lit)
+				|| (run > size - i) || (lit > size - i - run) || (lit > data_size - pos))
+			{
+				return false;
+			}
+
+			i += run;
+			for (uint32_t j = 0; j < lit; ++ j, ++ i, ++ pos)
+			{
+				state[i] ^= data[pos];
+			}
+		}
+
+		return pos == data_size;
+	}
+}
+
+namespace KlayGE
+{
+	NetConnection::NetConnection(PacketSender const & sender)
+		: sender_(sender), mtu_(DEFAULT_MTU),
+			local_seq_(0), sent_packets_(PACKET_WINDOW),
+			remote_seq_(0), remote_ack_bits_(0), received_any_packet_(false), ack_pending_(false),
+			sent_snapshots_(SNAPSHOT_HISTORY), baseline_id_(0), has_baseline_(false),
+			received_snapshots_(SNAPSHOT_HISTORY), newest_snapshot_id_(0), has_new_snapshot_(false),
+			received_any_snapshot_(false),
+			rtt_(0.1f), bytes_sent_(0), packets_sent_(0)
+	{
+		ResetChannel(snapshot_channel_, CT_UnreliableSequenced);
+
+		for (auto& packet : sent_packets_)
+		{
+			packet.valid = false;
+		}
+		for (auto& snapshot : sent_snapshots_)
+		{
+			snapshot.valid = false;
+		}
+		for (auto& snapshot : received_snapshots_)
+		{
+			snapshot.valid = false;
+		}
+	}
+
+	NetConnection::NetConnection(Socket& socket, sockaddr_in const & remote)
+		: NetConnection([&socket, remote](void const * packet, uint32_t size)
+			{
+				socket.SendTo(packet, static_cast<int>(size), remote);
+			})
+	{
+	}
+
+	void NetConnection::ResetChannel(Channel& channel, ChannelType type)
+	{
+		channel.type = type;
+		channel.next_send_id = 0;
+		channel.send_queue.clear();
+		channel.recv_id = 0;
+		channel.received_any = false;
+		channel.recv_messages.clear();
+	}
+
+	NetConnection::Channel& NetConnection::ChannelAt(uint8_t index)
+	{
+		return (SNAPSHOT_CHANNEL == index) ? snapshot_channel_ : channels_[index];
+	}
+
+	void NetConnection::MTU(uint32_t mtu)
+	{
+		BOOST_ASSERT(mtu >= PACKET_HEADER_SIZE + MSG_HEADER_SIZE + FRAG_HEADER_SIZE + 64);
+		mtu_ = mtu;
+	}
+
+	uint32_t NetConnection::AddChannel(ChannelType type)
+	{
+		BOOST_ASSERT(channels_.size() < MAX_CHANNELS);
+
+		channels_.emplace_back();
+		ResetChannel(channels_.back(), type);
+		return static_cast<uint32_t>(channels_.size() - 1);
+	}
+
+	uint32_t NetConnection::NumFragments(uint32_t size) const
+	{
+		uint32_t const max_single = mtu_ - PACKET_HEADER_SIZE - MSG_HEADER_SIZE;
+		if (size <= max_single)
+		{
+			return 1;
+		}
+
+		uint32_t const max_frag = max_single - FRAG_HEADER_SIZE;
+		return (size + max_frag - 1) / max_frag;
+	}
+
+	uint32_t NetConnection::FragmentStride(uint32_t size, uint32_t num_frags) const
+	{
+		return (size + num_frags - 1) / num_frags;
+	}
+
+	void NetConnection::QueueMessage(Channel& channel, uint16_t id, void const * data, uint32_t size)
+	{
+		uint32_t const num_frags = this->NumFragments(size);
+		if (num_frags > MAX_FRAGMENTS)
+		{
+			TERRC(std::errc::message_size);
+		}
+
+		channel.send_queue.emplace_back();
+		OutMessage& msg = channel.send_queue.back();
+		msg.id = id;
+		msg.data.assign(static_cast<uint8_t const *>(data), static_cast<uint8_t const *>(data) + size);
+		msg.num_frags = num_frags;
+		msg.frag_sent_times.assign(num_frags, -1);
+		msg.frag_acked.assign(num_frags, false);
+		msg.num_acked = 0;
+	}
+
+	void NetConnection::Send(uint32_t channel, void const * data, uint32_t size)
+	{
+		BOOST_ASSERT(channel < channels_.size());
+
+		Channel& ch = channels_[channel];
+		this->QueueMessage(ch, ch.next_send_id, data, size);
+		++ ch.next_send_id;
+	}
+
+	bool NetConnection::Receive(uint32_t& channel, std::vector<uint8_t>& msg)
+	{
+		if (received_.empty())
+		{
+			return false;
+		}
+
+		channel = received_.front().first;
+		msg.swap(received_.front().second);
+		received_.pop_front();
+		return true;
+	}
+
+	void NetConnection::SendSnapshot(void const * state, uint32_t size)
+	{
+		uint16_t const id = snapshot_channel_.next_send_id;
+		++ snapshot_channel_.next_send_id;
+
+		SnapshotRecord const * baseline = nullptr;
+		if (has_baseline_ && (static_cast<uint16_t>(id - baseline_id_) < SNAPSHOT_HISTORY))
+		{
+			SnapshotRecord const & rec = sent_snapshots_[baseline_id_ % SNAPSHOT_HISTORY];
+			if (rec.valid && (rec.id == baseline_id_))
+			{
+				baseline = &rec;
+			}
+		}
+
+		std::vector<uint8_t> payload;
+		Write8(payload, baseline ? 1 : 0);
+		Write16(payload, baseline_id_);
+		Write32(payload, size);
+		EncodeDelta(payload, static_cast<uint8_t const *>(state), size, baseline ? &baseline->state : nullptr);
+
+		this->QueueMessage(snapshot_channel_, id, payload.data(), static_cast<uint32_t>(payload.size()));
+
+		SnapshotRecord& rec = sent_snapshots_[id % SNAPSHOT_HISTORY];
+		rec.id = id;
+		rec.valid = true;
+		rec.state.assign(static_cast<uint8_t const *>(state), static_cast<uint8_t const *>(state) + size);
+		rec.num_frags = snapshot_channel_.send_queue.back().num_frags;
+		rec.frag_acked.assign(rec.num_frags, false);
+		rec.num_acked = 0;
+	}
+
+	bool NetConnection::ReceiveSnapshot(std::vector<uint8_t>& state)
+	{
+		if (!has_new_snapshot_)
+		{
+			return false;
+		}
+
+		state = received_snapshots_[newest_snapshot_id_ % SNAPSHOT_HISTORY].state;
+		has_new_snapshot_ = false;
+		return true;
+	}
+
+	void NetConnection::Update(double time)
+	{
+		double const resend_delay = std::max(rtt_ * 1.5, 0.03);
+		uint32_t num_packets = 0;
+
+		auto append = [this, time, &num_packets](uint8_t channel_index, OutMessage& msg, uint32_t frag_index, bool track)
+		{
+			uint32_t const total_size = static_cast<uint32_t>(msg.data.size());
+			uint32_t const stride = this->FragmentStride(total_size, msg.num_frags);
+			uint32_t const offset = frag_index * stride;
+			uint32_t const size = std::min(stride, total_size - offset);
+			uint32_t const header_size = MSG_HEADER_SIZE + ((msg.num_frags > 1) ? FRAG_HEADER_SIZE : 0);
+
+			if (packet_.size() + header_size + size > mtu_)
+			{
+				this->FlushPacket(time);
+				++ num_packets;
+			}
+			if (num_packets >= MAX_PACKETS_PER_UPDATE)
+			{
+				return false;
+			}
+			if (packet_.empty())
+			{
+				// Filled by FlushPacket
+				packet_.resize(PACKET_HEADER_SIZE);
+			}
+
+			Write8(packet_, channel_index | ((msg.num_frags > 1) ? FRAGMENTED_BIT : 0));
+			Write16(packet_, msg.id);
+			if (msg.num_frags > 1)
+			{
+				Write8(packet_, static_cast<uint8_t>(frag_index));
+				Write8(packet_, static_cast<uint8_t>(msg.num_frags - 1));
+				Write32(packet_, total_size);
+			}
+			Write16(packet_, static_cast<uint16_t>(size));
+			packet_.insert(packet_.end(), msg.data.begin() + offset, msg.data.begin() + offset + size);
+
+			if (track)
+			{
+				FragRef ref;
+				ref.channel = channel_index;
+				ref.msg_id = msg.id;
+				ref.frag_index = static_cast<uint8_t>(frag_index);
+				packet_frags_.push_back(ref);
+			}
+			msg.frag_sent_times[frag_index] = time;
+			return true;
+		};
+
+		bool full = false;
+		for (uint32_t c = 0; (c <= channels_.size()) && !full; ++ c)
+		{
+			uint8_t const channel_index = (c < channels_.size()) ? static_cast<uint8_t>(c) : SNAPSHOT_CHANNEL;
+			Channel& ch = this->ChannelAt(channel_index);
+
+			if (CT_ReliableOrdered == ch.type)
+			{
+				size_t const num_msgs = std::min<size_t>(ch.send_queue.size(), PACKET_WINDOW);
+				for (size_t i = 0; (i < num_msgs) && !full; ++ i)
+				{
+					OutMessage& msg = ch.send_queue[i];
+					for (uint32_t f = 0; (f < msg.num_frags) && !full; ++ f)
+					{
+						if (!msg.frag_acked[f]
+							&& ((msg.frag_sent_times[f] < 0) || (time - msg.frag_sent_times[f] >= resend_delay)))
+						{
+							full = !append(channel_index, msg, f, true);
+						}
+					}
+				}
+			}
+			else
+			{
+				// Only the acks of snapshots matter
+				bool const track = (SNAPSHOT_CHANNEL == channel_index);
+				while (!ch.send_queue.empty() && !full)
+				{
+					OutMessage& msg = ch.send_queue.front();
+					for (uint32_t f = 0; (f < msg.num_frags) && !full; ++ f)
+					{
+						if (msg.frag_sent_times[f] < 0)
+						{
+							full = !append(channel_index, msg, f, track);
+						}
+					}
+					if (!full)
+					{
+						ch.send_queue.pop_front();
+					}
+				}
+			}
+		}
+
+		if (!packet_.empty() || ack_pending_)
+		{
+			if (packet_.empty())
+			{
+				packet_.resize(PACKET_HEADER_SIZE);
+			}
+			this->FlushPacket(time);
+		}
+	}
+
+	void NetConnection::FlushPacket(double time)
+	{
+		std::vector<uint8_t> header;
+		Write16(header, local_seq_);
+		Write16(header, remote_seq_);
+		Write32(header, remote_ack_bits_);
+		std::memcpy(&packet_[0], &header[0], PACKET_HEADER_SIZE);
+
+		SentPacket& sent = sent_packets_[local_seq_ % PACKET_WINDOW];
+		sent.seq = local_seq_;
+		sent.valid = true;
+		sent.acked = false;
+		sent.time = time;
+		sent.frags.swap(packet_frags_);
+		packet_frags_.clear();
+
+		sender_(packet_.data(), static_cast<uint32_t>(packet_.size()));
+		bytes_sent_ += packet_.size();
+		++ packets_sent_;
+
+		++ local_seq_;
+		ack_pending_ = false;
+		packet_.clear();
+	}
+
+	void NetConnection::OnPacket(void const * packet, uint32_t size, double time)
+	{
+		if (size < PACKET_HEADER_SIZE)
+		{
+			return;
+		}
+
+		uint8_t const * data = static_cast<uint8_t const *>(packet);
+		uint16_t const seq = Read16(&data[0]);
+		uint16_t const ack = Read16(&data[2]);
+		uint32_t const ack_bits = Read32(&data[4]);
+
+		if (!received_any_packet_)
+		{
+			remote_seq_ = seq;
+			remote_ack_bits_ = 0;
+			received_any_packet_ = true;
+		}
+		else if (SeqGreater(seq, remote_seq_))
+		{
+			uint32_t const shift = static_cast<uint16_t>(seq - remote_seq_);
+			remote_ack_bits_ = ((shift >= 32) ? 0 : (remote_ack_bits_ << shift))
+				| ((shift <= 32) ? (1U << (shift - 1)) : 0);
+			remote_seq_ = seq;
+		}
+		else
+		{
+			uint32_t const diff = static_cast<uint16_t>(remote_seq_ - seq);
+			if ((diff >= 1) && (diff <= 32))
+			{
+				remote_ack_bits_ |= 1U << (diff - 1);
+			}
+		}
+		ack_pending_ = true;
+
+		for (uint32_t i = 0; i <= 32; ++ i)
+		{
+			if ((0 == i) || ((ack_bits >> (i - 1)) & 1))
+			{
+				uint16_t const acked_seq = static_cast<uint16_t>(ack - i);
+				SentPacket& sent = sent_packets_[acked_seq % PACKET_WINDOW];
+				if (sent.valid && (sent.seq == acked_seq) && !sent.acked)
+				{
+					if (0 == i)
+					{
+						rtt_ += (static_cast<float>(time - sent.time) - rtt_) * 0.1f;
+					}
+					this->OnPacketAcked(sent);
+				}
+			}
+		}
+
+		uint32_t pos = PACKET_HEADER_SIZE;
+		while (pos + MSG_HEADER_SIZE <= size)
+		{
+			uint8_t const channel = data[pos] & ~FRAGMENTED_BIT;
+			bool const fragmented = (data[pos] & FRAGMENTED_BIT) != 0;
+			uint16_t const msg_id = Read16(&data[pos + 1]);
+			pos += 3;
+
+			uint32_t frag_index = 0;
+			uint32_t num_frags = 1;
+			uint32_t total_size = 0;
+			if (fragmented)
+			{
+				if (pos + FRAG_HEADER_SIZE + 2 > size)
+				{
+					break;
+				}
+				frag_index = data[pos];
+				num_frags = data[pos + 1] + 1U;
+				total_size = Read32(&data[pos + 2]);
+				pos += FRAG_HEADER_SIZE;
+			}
+
+			uint32_t const msg_size = Read16(&data[pos]);
+			pos += 2;
+			if (pos + msg_size > size)
+			{
+				break;
+			}
+			if (!fragmented)
+			{
+				total_size = msg_size;
+			}
+
+			if ((SNAPSHOT_CHANNEL == channel) || (channel < channels_.size()))
+			{
+				this->OnFragment(channel, msg_id, frag_index, num_frags, total_size, &data[pos], msg_size);
+			}
+			pos += msg_size;
+		}
+	}
+
+	void NetConnection::OnPacketAcked(SentPacket& packet)
+	{
+		packet.acked = true;
+
+		for (auto const & ref : packet.frags)
+		{
+			if (SNAPSHOT_CHANNEL == ref.channel)
+			{
+				SnapshotRecord& rec = sent_snapshots_[ref.msg_id % SNAPSHOT_HISTORY];
+				if (rec.valid && (rec.id == ref.msg_id) && !rec.frag_acked[ref.frag_index])
+				{
+					rec.frag_acked[ref.frag_index] = true;
+					++ rec.num_acked;
+					if ((rec.num_acked == rec.num_frags) && (!has_baseline_ || SeqGreater(rec.id, baseline_id_)))
+					{
+						baseline_id_ = rec.id;
+						has_baseline_ = true;
+					}
+				}
+			}
+			else
+			{
+				Channel& ch = channels_[ref.channel];
+				if (!ch.send_queue.empty())
+				{
+					uint16_t const index = static_cast<uint16_t>(ref.msg_id - ch.send_queue.front().id);
+					if (index < ch.send_queue.size())
+					{
+						OutMessage& msg = ch.send_queue[index];
+						if (!msg.frag_acked[ref.frag_index])
+						{
+							msg.frag_acked[ref.frag_index] = true;
+							++ msg.num_acked;
+						}
+					}
+				}
+			}
+		}
+
+		for (auto& ch : channels_)
+		{
+			while (!ch.send_queue.empty() && (ch.send_queue.front().num_acked == ch.send_queue.front().num_frags))
+			{
+				ch.send_queue.pop_front();
+			}
+		}
+	}
+
+	void NetConnection::OnFragment(uint8_t channel_index, uint16_t msg_id, uint32_t frag_index, uint32_t num_frags,
+		uint32_t total_size, uint8_t const * data, uint32_t size)
+	{
+		Channel& ch = this->ChannelAt(channel_index);
+
+		if (frag_index >= num_frags)
+		{
+			return;
+		}
+		if (CT_ReliableOrdered == ch.type)
+		{
+			// Delivered already, or too far ahead
+			if (static_cast<uint16_t>(msg_id - ch.recv_id) >= PACKET_WINDOW)
+			{
+				return;
+			}
+		}
+		else if (SNAPSHOT_CHANNEL == channel_index)
+		{
+			// Too old to be decoded or be a baseline
+			if (received_any_snapshot_
+				&& !SeqGreater(msg_id, static_cast<uint16_t>(newest_snapshot_id_ - SNAPSHOT_HISTORY)))
+			{
+				return;
+			}
+		}
+		else if (ch.received_any && !SeqGreater(msg_id, ch.recv_id))
+		{
+			return;
+		}
+
+		if (1 == num_frags)
+		{
+			if (CT_ReliableOrdered == ch.type)
+			{
+				auto iter = ch.recv_messages.find(msg_id);
+				if (iter != ch.recv_messages.end())
+				{
+					return;
+				}
+			}
+
+			std::vector<uint8_t> msg(data, data + size);
+			this->OnMessage(channel_index, msg_id, msg);
+			return;
+		}
+
+		// The header comes from the wire, so it has to describe a message that fits in num_frags fragments of the
+		//  MTU, and this fragment has to be where that message puts it, before anything is allocated
+		uint32_t const max_frag = mtu_ - PACKET_HEADER_SIZE - MSG_HEADER_SIZE - FRAG_HEADER_SIZE;
+		if ((num_frags > MAX_FRAGMENTS) || (total_size > static_cast<uint64_t>(num_frags) * max_frag))
+		{
+			return;
+		}
+		uint32_t const stride = this->FragmentStride(total_size, num_frags);
+		uint32_t const offset = frag_index * stride;
+		if ((total_size <= (num_frags - 1) * stride) || (size != std::min(stride, total_size - offset)))
+		{
+			return;
+		}
+
+		auto iter = ch.recv_messages.find(msg_id);
+		if (iter == ch.recv_messages.end())
+		{
+			iter = ch.recv_messages.emplace(msg_id, InMessage()).first;
+			InMessage& in = iter->second;
+			in.data.resize(total_size);
+			in.num_frags = num_frags;
+			in.frag_received.assign(num_frags, false);
+			in.num_received = 0;
+
+			if ((ch.type != CT_ReliableOrdered) && (ch.recv_messages.size() > SNAPSHOT_HISTORY))
+			{
+				// Drops the oldest partial message
+				auto oldest = ch.recv_messages.begin();
+				for (auto i = ch.recv_messages.begin(); i != ch.recv_messages.end(); ++ i)
+				{
+					if (SeqGreater(oldest->first, i->first))
+					{
+						oldest = i;
+					}
+				}
+				if (oldest == iter)
+				{
+					ch.recv_messages.erase(oldest);
+					return;
+				}
+				ch.recv_messages.erase(oldest);
+			}
+		}
+
+		InMessage& in = iter->second;
+		if ((in.num_received == in.num_frags) || (in.num_frags != num_frags) || (in.data.size() != total_size)
+			|| in.frag_received[frag_index])
+		{
+			return;
+		}
+
+		std::memcpy(&in.data[offset], data, size);
+		in.frag_received[frag_index] = true;
+		++ in.num_received;
+
+		if (in.num_received == in.num_frags)
+		{
+			std::vector<uint8_t> msg;
+			msg.swap(in.data);
+			ch.recv_messages.erase(iter);
+			this->OnMessage(channel_index, msg_id, msg);
+		}
+	}
+
+	void NetConnection::OnMessage(uint8_t channel_index, uint16_t msg_id, std::vector<uint8_t>& msg)
+	{
+		if (SNAPSHOT_CHANNEL == channel_index)
+		{
+			this->OnSnapshot(msg_id, msg);
+			return;
+		}
+
+		Channel& ch = channels_[channel_index];
+		if (CT_ReliableOrdered == ch.type)
+		{
+			if (msg_id == ch.recv_id)
+			{
+				received_.emplace_back(channel_index, std::move(msg));
+				++ ch.recv_id;
+
+				for (;;)
+				{
+					auto iter = ch.recv_messages.find(ch.recv_id);
+					if ((iter == ch.recv_messages.end()) || (iter->second.num_received != iter->second.num_frags))
+					{
+						break;
+					}
+
+					received_.emplace_back(channel_index, std::move(iter->second.data));
+					ch.recv_messages.erase(iter);
+					++ ch.recv_id;
+				}
+			}
+			else
+			{
+				// Waits for the ones before it
+				InMessage& in = ch.recv_messages[msg_id];
+				in.data.swap(msg);
+				in.num_frags = 1;
+				in.frag_received.assign(1, true);
+				in.num_received = 1;
+			}
+		}
+		else
+		{
+			ch.recv_id = msg_id;
+			ch.received_any = true;
+			received_.emplace_back(channel_index, std::move(msg));
+
+			for (auto iter = ch.recv_messages.begin(); iter != ch.recv_messages.end();)
+			{
+				if (!SeqGreater(iter->first, msg_id))
+				{
+					iter = ch.recv_messages.erase(iter);
+				}
+				else
+				{
+					++ iter;
+				}
+			}
+		}
+	}
+
+	void NetConnection::OnSnapshot(uint16_t id, std::vector<uint8_t> const & msg)
+	{
+		if (msg.size() < SNAPSHOT_HEADER_SIZE)
+		{
+			return;
+		}
+
+		bool const has_baseline = (msg[0] != 0);
+		uint16_t const baseline_id = Read16(&msg[1]);
+		uint32_t const size = Read32(&msg[3]);
+
+		std::vector<uint8_t> const * baseline = nullptr;
+		if (has_baseline)
+		{
+			SnapshotRecord const & rec = received_snapshots_[baseline_id % SNAPSHOT_HISTORY];
+			if (!rec.valid || (rec.id != baseline_id))
+			{
+				return;
+			}
+			baseline = &rec.state;
+		}
+
+		std::vector<uint8_t> state;
+		if (!DecodeDelta(state, size, &msg[SNAPSHOT_HEADER_SIZE], static_cast<uint32_t>(msg.size() - SNAPSHOT_HEADER_SIZE),
+			baseline))
+		{
+			return;
+		}
+
+		// Kept even when older than the newest one, since the sender may take it as a baseline
+		SnapshotRecord& rec = received_snapshots_[id % SNAPSHOT_HISTORY];
+		if (rec.valid && (rec.id != id) && SeqGreater(rec.id, id))
+		{
+			return;
+		}
+		rec.id = id;
+		rec.valid = true;
+		rec.state.swap(state);
+
+		if (!received_any_snapshot_ || SeqGreater(id, newest_snapshot_id_))
+		{
+			newest_snapshot_id_ = id;
+			has_new_snapshot_ = true;
+			received_any_snapshot_ = true;
+		}
+	}
+}
+
+#endif
@@ -17,7 +17,6 @@
 #include <KlayGE/Lobby.hpp>
 
 #include <algorithm>
-#include <ctime>
 #include <cstring>
 
 #include <KlayGE/NetMsg.hpp>
@@ -27,19 +26,8 @@
 
 namespace
 {
-	class ReceiveThreadFunc
-	{
-	public:
-		explicit ReceiveThreadFunc(KlayGE::Player* player)
-			: player_(player)
-			{ }
-
-		void operator()()
-			{ player_->ReceiveFunc(); }
-
-	private:
-		KlayGE::Player* player_;
-	};
+	// Well within the 20 seconds lobbies wait by default
+	std::chrono::milliseconds const KEEP_ALIVE_TIME(5 * 1000);
 }
 
 namespace KlayGE
@@ -47,6 +35,7 @@ namespace KlayGE
 	// 캯
 	/////////////////////////////////////////////////////////////////////////////////
 	Player::Player()
+		: playerID_(0), joined_(false)
 	{
 	}
 
@@ -57,88 +46,57 @@ namespace KlayGE
 		this->Destroy();
 	}
 
-	// Ϣܺ
-	/////////////////////////////////////////////////////////////////////////////////
-	void Player::ReceiveFunc()
+	int Player::ReceiveReply(char type, char* buf, int maxSize)
 	{
-		static time_t lastTime = std::time(nullptr);
+		socket_.NonBlock(false);
+		socket_.TimeOut(2000);
 
+		int size;
 		for (;;)
 		{
-			if (std::time(nullptr) - lastTime >= 10 * 1000)
+			size = socket_.Receive(buf, maxSize);
+			if ((size <= 0) || (type == buf[0]))
 			{
-				char msg(MSG_NOP);
-				socket_.Send(&msg, sizeof(msg));
-				lastTime = std::time(nullptr);
-			}
-
-			if (!sendQueue_.empty())
-			{
-				// ͶϢ
-				for (auto const & msg : sendQueue_)
-				{
-					socket_.Send(&msg[0], static_cast<int>(msg.size()));
-				}
-			}
-
-			char revBuf[Max_Buffer];
-			memset(revBuf, 0, sizeof(revBuf));
-			if (socket_.Receive(revBuf, sizeof(revBuf)) != -1)
-			{
-				uint32_t ID;
-				std::memcpy(&ID, &revBuf[1], 4);
-
-				// ɾѷ͵Ϣ
-				for (auto iter = sendQueue_.begin(); iter != sendQueue_.end();)
-				{
-					std::vector<char>& msg = *iter;
-
-					uint32_t sendID;
-					std::memcpy(&sendID, &msg[1], 4);
-					if (sendID == ID)
-					{
-						iter = sendQueue_.erase(iter);
-					}
-					else
-					{
-						++ iter;
-					}
-				}
-
-				if (MSG_QUIT == revBuf[0])
-				{
-					break;
-				}
+				break;
 			}
 		}
+
+		socket_.NonBlock(true);
+		return size;
 	}
 
 	// 
 	/////////////////////////////////////////////////////////////////////////////////
 	bool Player::Join(sockaddr_in const & lobbyAddr)
 	{
+		joined_ = false;
+		playerID_ = 0;
+
 		socket_.Close();
 		socket_.Create(SOCK_DGRAM);
 		socket_.Connect(lobbyAddr);
 
-		socket_.TimeOut(2000);
-
 		char buf[Max_Buffer];
-		memset(buf, 0, sizeof(buf));
+		std::memset(buf, 0, sizeof(buf));
 
 		buf[0] = MSG_JOIN;
 		name_.copy(&buf[1], this->name_.length());
+		socket_.Send(buf, 1 + 16);
 
-		socket_.Send(buf, sizeof(buf));
-
-		socket_.Receive(&playerID_, sizeof(playerID_));
+		// ظʽ:
+		//			Player ID		4 ֽ
+		if (this->ReceiveReply(MSG_JOIN, buf, sizeof(buf)) < 5)
+		{
+			return false;
+		}
+		std::memcpy(&playerID_, &buf[1], sizeof(playerID_));
 		if (0 == playerID_)
 		{
 			return false;
 		}
 
-		receiveLoop_ = true;
-		receiveThread_ = Context::Instance().ThreadPool()(ReceiveThreadFunc(this));
+		joined_ = true;
+		last_send_ = std::chrono::steady_clock::now();
 
 		return true;
 	}
@@ -147,13 +105,13 @@ namespace KlayGE
 	/////////////////////////////////////////////////////////////////////////////////
 	void Player::Quit()
 	{
-		if (receiveLoop_)
+		if (joined_)
 		{
 			char msg(MSG_QUIT);
 			socket_.Send(&msg, sizeof(msg));
 
-			receiveLoop_ = false;
-			receiveThread_();
+			joined_ = false;
+			playerID_ = 0;
 		}
 	}
 
@@ -172,20 +130,14 @@ namespace KlayGE
 		lobbydes.maxPlayers = 0;
 
 		char msg(MSG_GETLOBBYINFO);
-		socket_.Send(&msg, sizeof(msg));
+		this->Send(&msg, sizeof(msg));
 
-		char buf[18];
-		socket_.Receive(buf, sizeof(buf));
-		if (MSG_GETLOBBYINFO == buf[0])
+		char buf[1 + 8 + 16];
+		if (this->ReceiveReply(MSG_GETLOBBYINFO, buf, sizeof(buf)) == sizeof(buf))
 		{
-			lobbydes.numPlayer = buf[1];
-			lobbydes.maxPlayers = buf[2];
-			size_t i(0);
-			while (buf[3 + i] != 0)
-			{
-				++ i;
-			}
-			lobbydes.name = std::string(&buf[3], i);
+			std::memcpy(&lobbydes.numPlayer, &buf[1], sizeof(lobbydes.numPlayer));
+			std::memcpy(&lobbydes.maxPlayers, &buf[5], sizeof(lobbydes.maxPlayers));
+			lobbydes.name.assign(&buf[9], std::find(&buf[9], &buf[9] + 16, '\0'));
 		}
 
 		return lobbydes;
@@ -216,8 +168,18 @@ namespace KlayGE
 	/////////////////////////////////////////////////////////////////////////////////
 	int Player::Send(void const * buf, int size)
 	{
+		last_send_ = std::chrono::steady_clock::now();
 		return socket_.Send(buf, size);
 	}
+
+	void Player::Update()
+	{
+		if (joined_ && (std::chrono::steady_clock::now() - last_send_ >= KEEP_ALIVE_TIME))
+		{
+			char msg(MSG_NOP);
+			this->Send(&msg, sizeof(msg));
+		}
+	}
 }
 
 #endif
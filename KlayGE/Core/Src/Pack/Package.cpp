@@ -0,0 +1,325 @@
+/**
+ * @file Package.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Util.hpp>
+#include <KFL/ResIdentifier.hpp>
+#include <KFL/CustomizedStreamBuf.hpp>
+#include <KFL/CXX17/filesystem.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+
+#if defined(KLAYGE_PLATFORM_WINDOWS_DESKTOP)
+#include <windows.h>
+#elif !defined(KLAYGE_PLATFORM_WINDOWS)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <KlayGE/Package.hpp>
+
+namespace
+{
+	using namespace KlayGE;
+
+	// File layout, all little endian:
+	//   Header: fourcc "KPKG", version, number of members
+	//   TOC: for each member, offset from the start of file, size, length of path, path
+	//   Data: members, each aligned to DATA_ALIGNMENT
+	uint32_t const PACKAGE_FOURCC = MakeFourCC<'K', 'P', 'K', 'G'>::value;
+	uint32_t const PACKAGE_VERSION = 1;
+	uint32_t const HEADER_SIZE = sizeof(uint32_t) * 3;
+	uint32_t const TOC_ENTRY_SIZE = sizeof(uint64_t) * 2 + sizeof(uint32_t);
+	uint32_t const DATA_ALIGNMENT = 16;
+
+	std::string NormalizeName(std::string_view name)
+	{
+		std::string ret(name);
+		std::replace(ret.begin(), ret.end(), '\\', '/');
+		std::transform(ret.begin(), ret.end(), ret.begin(),
+			[](char ch)
+			{
+				return static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+			});
+		return ret;
+	}
+
+	template <typename T>
+	T ReadLE(uint8_t const * p)
+	{
+		T ret;
+		std::memcpy(&ret, p, sizeof(ret));
+		return LE2Native(ret);
+	}
+
+	template <typename T>
+	void WriteLE(std::ostream& os, T v)
+	{
+		v = Native2LE(v);
+		os.write(reinterpret_cast<char const *>(&v), sizeof(v));
+	}
+
+	// Keeps the package, so the mapping, alive as long as the stream
+	class PackageStreamBuf : public MemStreamBuf
+	{
+	public:
+		PackageStreamBuf(PackagePtr const & package, void const * begin, void const * end)
+			: MemStreamBuf(begin, end), package_(package)
+		{
+		}
+
+	private:
+		PackagePtr package_;
+	};
+}
+
+namespace KlayGE
+{
+	Package::Package(std::string const & path)
+		: data_(nullptr), size_(0), timestamp_(0), mapped_(false)
+	{
+		std::filesystem::path pkg_path(path);
+		if (!std::filesystem::exists(pkg_path))
+		{
+			return;
+		}
+
+#if defined(KLAYGE_CXX17_LIBRARY_FILESYSTEM_SUPPORT) || defined(KLAYGE_TS_LIBRARY_FILESYSTEM_SUPPORT)
+		timestamp_ = std::filesystem::last_write_time(pkg_path).time_since_epoch().count();
+#else
+		timestamp_ = std::filesystem::last_write_time(pkg_path);
+#endif
+
+#if defined(KLAYGE_PLATFORM_WINDOWS_DESKTOP)
+		HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+			FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file != INVALID_HANDLE_VALUE)
+		{
+			LARGE_INTEGER file_size;
+			if (::GetFileSizeEx(file, &file_size) && (file_size.QuadPart > 0))
+			{
+				HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (mapping != nullptr)
+				{
+					// The view keeps the mapping and the file open
+					data_ = static_cast<uint8_t const *>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+					size_ = file_size.QuadPart;
+					mapped_ = (data_ != nullptr);
+					::CloseHandle(mapping);
+				}
+			}
+			::CloseHandle(file);
+		}
+#elif !defined(KLAYGE_PLATFORM_WINDOWS)
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd != -1)
+		{
+			struct stat st;
+			if ((::fstat(fd, &st) == 0) && (st.st_size > 0))
+			{
+				void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+				if (p != MAP_FAILED)
+				{
+					data_ = static_cast<uint8_t const *>(p);
+					size_ = st.st_size;
+					mapped_ = true;
+				}
+			}
+			::close(fd);
+		}
+#endif
+
+		if (!mapped_)
+		{
+			// No mapping on this platform. Read it once, the members are still views. The header is checked first,
+			//  so that other archives, e.g. 7z, aren't read as a whole.
+			std::ifstream ifs(path.c_str(), std::ios_base::binary);
+			uint8_t header[HEADER_SIZE];
+			if (ifs.read(reinterpret_cast<char*>(header), sizeof(header))
+				&& (ReadLE<uint32_t>(header) == PACKAGE_FOURCC) && (ReadLE<uint32_t>(header + 4) == PACKAGE_VERSION))
+			{
+				ifs.seekg(0, std::ios_base::end);
+				content_.resize(static_cast<size_t>(ifs.tellg()));
+				ifs.seekg(0, std::ios_base::beg);
+				if (ifs.read(reinterpret_cast<char*>(content_.data()), static_cast<std::streamsize>(content_.size())))
+				{
+					data_ = content_.data();
+					size_ = content_.size();
+				}
+				else
+				{
+					content_.clear();
+				}
+			}
+		}
+
+		if (data_ && !this->ParseToc())
+		{
+			this->Unmap();
+		}
+	}
+
+	Package::~Package()
+	{
+		this->Unmap();
+	}
+
+	void Package::Write(std::ostream& os, std::vector<std::pair<std::string, ResIdentifierPtr>> const & members)
+	{
+		uint64_t toc_size = 0;
+		for (auto const & member : members)
+		{
+			toc_size += TOC_ENTRY_SIZE + member.first.size();
+		}
+
+		std::vector<std::vector<char>> contents(members.size());
+		std::vector<uint64_t> offsets(members.size());
+		uint64_t offset = HEADER_SIZE + toc_size;
+		for (size_t i = 0; i < members.size(); ++ i)
+		{
+			ResIdentifierPtr const & res = members[i].second;
+			res->seekg(0, std::ios_base::end);
+			contents[i].resize(static_cast<size_t>(res->tellg()));
+			res->seekg(0, std::ios_base::beg);
+			res->read(contents[i].data(), contents[i].size());
+
+			offset = (offset + DATA_ALIGNMENT - 1) & ~static_cast<uint64_t>(DATA_ALIGNMENT - 1);
+			offsets[i] = offset;
+			offset += contents[i].size();
+		}
+
+		WriteLE<uint32_t>(os, PACKAGE_FOURCC);
+		WriteLE<uint32_t>(os, PACKAGE_VERSION);
+		WriteLE<uint32_t>(os, static_cast<uint32_t>(members.size()));
+		for (size_t i = 0; i < members.size(); ++ i)
+		{
+			std::string const name = NormalizeName(members[i].first);
+			WriteLE<uint64_t>(os, offsets[i]);
+			WriteLE<uint64_t>(os, contents[i].size());
+			WriteLE<uint32_t>(os, static_cast<uint32_t>(name.size()));
+			os.write(name.data(), name.size());
+		}
+
+		offset = HEADER_SIZE + toc_size;
+		for (size_t i = 0; i < members.size(); ++ i)
+		{
+			for (; offset < offsets[i]; ++ offset)
+			{
+				os.put(0);
+			}
+			os.write(contents[i].data(), contents[i].size());
+			offset += contents[i].size();
+		}
+	}
+
+	bool Package::HasMember(std::string_view name) const
+	{
+		return toc_.find(NormalizeName(name)) != toc_.end();
+	}
+
+	ResIdentifierPtr Package::OpenMember(std::string_view name, std::string_view res_name)
+	{
+		ResIdentifierPtr ret;
+		auto iter = toc_.find(NormalizeName(name));
+		if (iter != toc_.end())
+		{
+			uint8_t const * begin = data_ + iter->second.offset;
+			auto sb = MakeSharedPtr<PackageStreamBuf>(this->shared_from_this(), begin, begin + iter->second.size);
+			ret = MakeSharedPtr<ResIdentifier>(res_name, timestamp_, MakeSharedPtr<std::istream>(sb.get()), sb);
+		}
+		return ret;
+	}
+
+	bool Package::ParseToc()
+	{
+		if ((size_ < HEADER_SIZE) || (ReadLE<uint32_t>(data_) != PACKAGE_FOURCC)
+			|| (ReadLE<uint32_t>(data_ + 4) != PACKAGE_VERSION))
+		{
+			return false;
+		}
+
+		// Each member takes at least TOC_ENTRY_SIZE bytes of the TOC
+		uint32_t const num_members = ReadLE<uint32_t>(data_ + 8);
+		if (num_members > (size_ - HEADER_SIZE) / TOC_ENTRY_SIZE)
+		{
+			return false;
+		}
+		toc_.reserve(num_members);
+
+		uint64_t pos = HEADER_SIZE;
+		for (uint32_t i = 0; i < num_members; ++ i)
+		{
+			if (pos + TOC_ENTRY_SIZE > size_)
+			{
+				return false;
+			}
+
+			Member member;
+			member.offset = ReadLE<uint64_t>(data_ + pos);
+			member.size = ReadLE<uint64_t>(data_ + pos + 8);
+			uint32_t const name_len = ReadLE<uint32_t>(data_ + pos + 16);
+			pos += TOC_ENTRY_SIZE;
+
+			if ((pos + name_len > size_) || (member.offset > size_) || (member.size > size_ - member.offset))
+			{
+				return false;
+			}
+
+			toc_.emplace(std::string(reinterpret_cast<char const *>(data_ + pos), name_len), member);
+			pos += name_len;
+		}
+
+		return true;
+	}
+
+	void Package::Unmap()
+	{
+		if (mapped_)
+		{
+#if defined(KLAYGE_PLATFORM_WINDOWS_DESKTOP)
+			::UnmapViewOfFile(data_);
+#elif !defined(KLAYGE_PLATFORM_WINDOWS)
+			::munmap(const_cast<uint8_t*>(data_), static_cast<size_t>(size_));
+#endif
+			mapped_ = false;
+		}
+
+		content_.clear();
+		content_.shrink_to_fit();
+		data_ = nullptr;
+		size_ = 0;
+		toc_.clear();
+	}
+}
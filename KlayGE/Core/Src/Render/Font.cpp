@@ -31,6 +31,7 @@
 #include <KlayGE/KlayGE.hpp>
 #include <KFL/Util.hpp>
 #include <KFL/Half.hpp>
+#include <KFL/Thread.hpp>
 #include <KlayGE/RenderLayout.hpp>
 #include <KFL/Math.hpp>
 #include <KlayGE/Viewport.hpp>
@@ -50,6 +51,7 @@
 #include <KlayGE/Window.hpp>
 
 #include <algorithm>
+#include <deque>
 #include <vector>
 #include <cstring>
 #include <fstream>
@@ -65,6 +67,67 @@
 
 namespace KlayGE
 {
+	GlyphAtlas::GlyphAtlas(uint32_t num_cells)
+		: cells_(num_cells + 1)
+	{
+		BOOST_ASSERT(num_cells > 0);
+
+		cells_[num_cells].prev = num_cells;
+		cells_[num_cells].next = num_cells;
+
+		// Cell 0 is handed out first
+		free_cells_.resize(num_cells);
+		for (uint32_t i = 0; i < num_cells; ++ i)
+		{
+			free_cells_[i] = num_cells - 1 - i;
+		}
+	}
+
+	void GlyphAtlas::Touch(uint32_t cell)
+	{
+		BOOST_ASSERT(cell < this->NumCells());
+
+		this->UnlinkCell(cell);
+		this->LinkCell(cell);
+	}
+
+	uint32_t GlyphAtlas::Add(wchar_t ch, bool& evicted, wchar_t& evicted_ch)
+	{
+		uint32_t cell;
+		if (!free_cells_.empty())
+		{
+			cell = free_cells_.back();
+			free_cells_.pop_back();
+			evicted = false;
+		}
+		else
+		{
+			cell = cells_.back().next;
+			this->UnlinkCell(cell);
+			evicted = true;
+			evicted_ch = cells_[cell].ch;
+		}
+		cells_[cell].ch = ch;
+		this->LinkCell(cell);
+		return cell;
+	}
+
+	void GlyphAtlas::LinkCell(uint32_t cell)
+	{
+		uint32_t const sentinel = this->NumCells();
+		cells_[cell].prev = cells_[sentinel].prev;
+		cells_[cell].next = sentinel;
+		cells_[cells_[sentinel].prev].next = cell;
+		cells_[sentinel].prev = cell;
+	}
+
+	void GlyphAtlas::UnlinkCell(uint32_t cell)
+	{
+		cells_[cells_[cell].prev].next = cells_[cell].next;
+		cells_[cells_[cell].next].prev = cells_[cell].prev;
+	}
+
+
 	class FontRenderable : public RenderableHelper
 	{
 	public:
@@ -72,7 +135,7 @@ namespace KlayGE
 				: RenderableHelper(L"Font"),
 					three_dim_(false),
 					kfont_loader_(kfl),
-					tick_(0)
+					decode_group_(Context::Instance().TaskScheduler())
 		{
 			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 
@@ -94,9 +157,11 @@ namespace KlayGE
 			RenderDeviceCaps const & caps = renderEngine.DeviceCaps();
 			uint32_t size = std::min<uint32_t>(2048U, std::min<uint32_t>(caps.max_texture_width, caps.max_texture_height)) / kfont_char_size * kfont_char_size;
 			dist_texture_ = rf.MakeTexture2D(size, size, 1, 1, EF_R8, 1, 0, EAH_GPU_Read);
-			a_char_data_.resize(kfont_char_size * kfont_char_size);
+			dist_data_.resize(size * size);
 
-			char_free_list_.emplace_back(0, size * size / kfont_char_size / kfont_char_size);
+			atlas_ = MakeUniquePtr<GlyphAtlas>((size / kfont_char_size) * (size / kfont_char_size));
+			dirty_min_ = int2(size, size);
+			dirty_max_ = int2(0, 0);
 
 			effect_ = SyncLoadRenderEffect("Font.fxml");
 			*(effect_->ParameterByName("distance_tex")) = dist_texture_;
@@ -143,6 +208,8 @@ namespace KlayGE
 				*dpi_scale_ep_ = Context::Instance().AppInstance().MainWnd()->DPIScale();
 			}
 
+			this->FlushGlyphs();
+
 			tb_vb_->EnsureDataReady();
 			tb_ib_->EnsureDataReady();
 
@@ -530,17 +597,13 @@ namespace KlayGE
 		/////////////////////////////////////////////////////////////////////////////////
 		void UpdateTexture(std::wstring_view text)
 		{
-			++ tick_;
-
 			uint32_t const tex_size = dist_texture_->Width(0);
 
 			KFont& kl = *kfont_loader_;
 			auto& cim = char_info_map_;
 
 			uint32_t const kfont_char_size = kl.CharSize();
-
 			uint32_t const num_chars_a_row = tex_size / kfont_char_size;
-			uint32_t const num_total_chars = num_chars_a_row * num_chars_a_row;
 
 			for (auto const & ch : text)
 			{
@@ -552,121 +615,101 @@ namespace KlayGE
 					{
 						// ҵ
 
-						cmiter->second.tick = tick_;
+						atlas_->Touch(cmiter->second.cell);
 					}
 					else
 					{
 						// ҲԵ
 
-						KFont::font_info const & ci = kl.CharInfo(offset);
-
-						uint32_t width = ci.width;
-						uint32_t height = ci.height;
-
-						int2 char_pos;
-						CharInfo charInfo;
-						if (cim.size() < num_total_chars)
+						bool evicted;
+						wchar_t evicted_ch;
+						uint32_t const cell = atlas_->Add(ch, evicted, evicted_ch);
+						if (evicted)
 						{
-							// пռ
+							cim.erase(evicted_ch);
+						}
 
-							uint32_t const s = char_free_list_.front().first;
-						
-							char_pos.y() = s / num_chars_a_row;
-							char_pos.x() = s - char_pos.y() * num_chars_a_row;
+						int2 const char_pos((cell % num_chars_a_row) * kfont_char_size, (cell / num_chars_a_row) * kfont_char_size);
 
-							char_pos.x() *= kfont_char_size;
-							char_pos.y() *= kfont_char_size;
+						KFont::font_info const & ci = kl.CharInfo(offset);
 
-							charInfo.rc.left() = static_cast<float>(char_pos.x()) / tex_size;
-							charInfo.rc.top() = static_cast<float>(char_pos.y()) / tex_size;
+						CharInfo charInfo;
+						charInfo.rc.left()		= static_cast<float>(char_pos.x()) / tex_size;
+						charInfo.rc.top()		= static_cast<float>(char_pos.y()) / tex_size;
+						charInfo.rc.right()		= charInfo.rc.left() + static_cast<float>(ci.width) / tex_size;
+						charInfo.rc.bottom()	= charInfo.rc.top() + static_cast<float>(ci.height) / tex_size;
+						charInfo.cell			= cell;
+						cim.emplace(ch, charInfo);
 
-							++ char_free_list_.front().first;
-							if (char_free_list_.front().first == char_free_list_.front().second)
+						// The font file is read here, the decompression goes to a worker
+						pending_glyphs_.emplace_back();
+						PendingGlyph& glyph = pending_glyphs_.back();
+						glyph.pos = char_pos;
+						uint32_t size;
+						kl.GetLZMADistanceData(nullptr, size, offset);
+						glyph.lzma_data.resize(size);
+						kl.GetLZMADistanceData(&glyph.lzma_data[0], size, offset);
+						glyph.decoded.resize(kfont_char_size * kfont_char_size);
+						decode_group_.run([&glyph]
 							{
-								char_free_list_.pop_front();
-							}
-						}
-						else
-						{
-							// ҵʹʱûʹõ
+								LZMACodec lzma;
+								lzma.Decode(&glyph.decoded[0], &glyph.lzma_data[0], glyph.lzma_data.size(), glyph.decoded.size());
+							});
 
-							uint64_t min_tick = cim.begin()->second.tick;
-							auto min_chiter = cim.begin();
-							for (auto chiter = cim.begin(); chiter != cim.end(); ++ chiter)
-							{
-								if (chiter->second.tick < min_tick)
-								{
-									min_tick = chiter->second.tick;
-									min_chiter = chiter;
-								}
-							}
-
-							char_pos.x() = static_cast<int32_t>(min_chiter->second.rc.left() * tex_size);
-							char_pos.y() = static_cast<int32_t>(min_chiter->second.rc.top() * tex_size);
-							charInfo.rc.left() = min_chiter->second.rc.left();
-							charInfo.rc.top() = min_chiter->second.rc.top();
-
-							for (auto chiter = cim.begin(); chiter != cim.end(); ++ chiter)
-							{
-								if (chiter->second.tick == min_tick)
-								{
-									uint32_t const x = static_cast<int32_t>(chiter->second.rc.left() * tex_size);
-									uint32_t const y = static_cast<int32_t>(chiter->second.rc.top() * tex_size);
-									uint32_t const id = y * num_chars_a_row + x;
-									auto freeiter = char_free_list_.begin();
-									while ((freeiter != char_free_list_.end()) && (freeiter->second <= id))
-									{
-										++ freeiter;
-									}
-									char_free_list_.emplace(freeiter, id, id + 1);
-
-									cim.erase(chiter);
-									break;
-								}
-							}
-							for (auto freeiter = char_free_list_.begin(); freeiter != char_free_list_.end();)
-							{
-								auto nextiter = freeiter;
-								++ nextiter;
-
-								if (nextiter != char_free_list_.end())
-								{
-									if (freeiter->second == nextiter->first)
-									{
-										freeiter->second = nextiter->second;
-										char_free_list_.erase(nextiter);
-									}
-									else
-									{
-										++ freeiter;
-									}
-								}
-								else
-								{
-									break;
-								}
-							}
-						}
+						dirty_min_ = MathLib::minimize(dirty_min_, char_pos);
+						dirty_max_ = MathLib::maximize(dirty_max_, char_pos + int2(kfont_char_size, kfont_char_size));
+					}
+				}
+			}
+		}
 
-						charInfo.rc.right()		= charInfo.rc.left() + static_cast<float>(width) / tex_size;
-						charInfo.rc.bottom()	= charInfo.rc.top() + static_cast<float>(height) / tex_size;
-						charInfo.tick			= tick_;
+	private:
+		// Glyphs added since the last flush go to the texture in one update of the rectangle that covers them.
+		//  A cell reused in between gets the data of its last glyph, since they are copied in order.
+		void FlushGlyphs()
+		{
+			if (pending_glyphs_.empty())
+			{
+				return;
+			}
 
-						kl.GetDistanceData(&a_char_data_[0], kfont_char_size, offset);
-						dist_texture_->UpdateSubresource2D(0, 0, char_pos.x(), char_pos.y(), kfont_char_size, kfont_char_size,
-							&a_char_data_[0], kfont_char_size);
+			decode_group_.wait();
 
-						cim.emplace(ch, charInfo);
-					}
+			uint32_t const tex_size = dist_texture_->Width(0);
+			uint32_t const kfont_char_size = kfont_loader_->CharSize();
+			for (auto const & glyph : pending_glyphs_)
+			{
+				uint8_t* dst = &dist_data_[glyph.pos.y() * tex_size + glyph.pos.x()];
+				uint8_t const * src = &glyph.decoded[0];
+				for (uint32_t y = 0; y < kfont_char_size; ++ y)
+				{
+					std::memcpy(dst, src, kfont_char_size);
+					dst += tex_size;
+					src += kfont_char_size;
 				}
 			}
+			pending_glyphs_.clear();
+
+			dist_texture_->UpdateSubresource2D(0, 0, dirty_min_.x(), dirty_min_.y(),
+				dirty_max_.x() - dirty_min_.x(), dirty_max_.y() - dirty_min_.y(),
+				&dist_data_[dirty_min_.y() * tex_size + dirty_min_.x()], tex_size);
+
+			dirty_min_ = int2(tex_size, tex_size);
+			dirty_max_ = int2(0, 0);
 		}
 
 	private:
 		struct CharInfo
 		{
 			Rect rc;
-			uint64_t tick;
+			uint32_t cell;
+		};
+
+		struct PendingGlyph
+		{
+			int2 pos;
+			std::vector<uint8_t> lzma_data;
+			std::vector<uint8_t> decoded;
 		};
 
 #ifdef KLAYGE_HAS_STRUCT_PACK
@@ -693,7 +736,7 @@ namespace KlayGE
 		bool restart_;
 
 		std::unordered_map<wchar_t, CharInfo> char_info_map_;
-		std::list<std::pair<uint32_t, uint32_t>> char_free_list_;
+		std::unique_ptr<GlyphAtlas> atlas_;
 
 		bool three_dim_;
 
@@ -703,7 +746,10 @@ namespace KlayGE
 		std::vector<SubAlloc> tb_ib_sub_allocs_;
 
 		TexturePtr		dist_texture_;
-		std::vector<uint8_t> a_char_data_;
+		// A copy of the texture, so the dirty rectangle can be uploaded at once
+		std::vector<uint8_t> dist_data_;
+		int2 dirty_min_;
+		int2 dirty_max_;
 
 		RenderEffectParameter* half_width_height_ep_;
 		RenderEffectParameter* dpi_scale_ep_;
@@ -711,7 +757,10 @@ namespace KlayGE
 
 		std::shared_ptr<KFont> kfont_loader_;
 
-		uint64_t tick_;
+		// Elements of a deque stay in place while more are added, so the decoding tasks can hold them.
+		//  decode_group_ is destroyed first, after it waits for the tasks.
+		std::deque<PendingGlyph> pending_glyphs_;
+		task_group decode_group_;
 	};
 }
 
@@ -793,6 +842,14 @@ namespace
 			return false;
 		}
 
+		size_t Hash() const override
+		{
+			size_t seed = static_cast<size_t>(this->Type());
+			HashRange(seed, font_desc_.res_name.begin(), font_desc_.res_name.end());
+			HashCombine(seed, font_desc_.flag);
+			return seed;
+		}
+
 		void CopyDataFrom(ResLoadingDesc const & rhs) override
 		{
 			BOOST_ASSERT(this->Type() == rhs.Type());
@@ -16,9 +16,12 @@
 #include <KlayGE/RenderFactory.hpp>
 #include <KlayGE/RenderEngine.hpp>
 #include <KlayGE/RenderEffect.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/LZMACodec.hpp>
 
 #include <fstream>
 #include <cstring>
+#include <algorithm>
 #include <boost/assert.hpp>
 #include <boost/lexical_cast.hpp>
 
@@ -117,7 +120,7 @@ namespace KlayGE
 		: root_(MakeSharedPtr<quadtree_node>()),
 			num_tiles_(num_tiles), tile_size_(tile_size), format_(format),
 			texel_size_(NumFormatBytes(format)),
-			decode_tick_(0), tile_tick_(0)
+			tile_tick_(0), upload_budget_(8)
 	{
 		BOOST_ASSERT(num_tiles_ <= MAX_NUM_TILES);
 		BOOST_ASSERT(tile_size_ <= MAX_TILE_SIZE);
@@ -447,15 +450,13 @@ namespace KlayGE
 
 	void JudaTexture::DecodeATile(std::vector<uint8_t>* data, uint32_t shuff, uint32_t mipmaps)
 	{
-		++ decode_tick_;
-
 		uint32_t const full_tile_bytes = cache_tile_size_ * cache_tile_size_ * texel_size_;
 		uint32_t target_level = this->ShuffLevel(shuff);
 
 		quadtree_node_ptr node = root_;
 		if (0 == target_level)
 		{
-			std::memcpy(&data[0][0], this->RetriveATile(root_->data_index), full_tile_bytes);
+			std::memcpy(&data[0][0], &(*this->RetriveATile(root_->data_index))[0], full_tile_bytes);
 		}
 		else
 		{
@@ -505,10 +506,12 @@ namespace KlayGE
 					{
 						uint32_t start_x = (start_sub_tile_x >> shift) * used_w;
 						uint32_t start_y = (start_sub_tile_y >> shift) * used_h;
+						std::shared_ptr<std::vector<uint8_t>> root_data;
 						uint8_t const * src;
 						if (1 == ll_b)
 						{
-							src = this->RetriveATile(root_->data_index);
+							root_data = this->RetriveATile(root_->data_index);
+							src = &(*root_data)[0];
 						}
 						else
 						{
@@ -532,7 +535,8 @@ namespace KlayGE
 						{
 							uint32_t start_x = (start_sub_tile_x >> shift) * used_w * 2;
 							uint32_t start_y = (start_sub_tile_y >> shift) * used_h * 2;
-							uint8_t const * start_src = this->RetriveATile(node->data_index) + (start_y * tile_size_ + start_x) * texel_size_;
+							auto const node_data = this->RetriveATile(node->data_index);
+							uint8_t const * start_src = &(*node_data)[0] + (start_y * tile_size_ + start_x) * texel_size_;
 							uint8_t* dst = &temp[0];
 							for (size_t y = 0; y < used_h * 2; ++ y)
 							{
@@ -609,72 +613,67 @@ namespace KlayGE
 		return ret_attr;
 	}
 
-	uint8_t* JudaTexture::RetriveATile(uint32_t data_index)
+	std::shared_ptr<std::vector<uint8_t>> JudaTexture::RetriveATile(uint32_t data_index)
 	{
-		if (data_blocks_.empty())
+		if (!data_blocks_.empty())
+		{
+			return std::shared_ptr<std::vector<uint8_t>>(std::shared_ptr<std::vector<uint8_t>>(), &data_blocks_[data_index]);
+		}
+
+		// Called from the streaming tasks. The lock only covers the cache and the file, decoding runs in parallel.
+		std::vector<uint8_t> comed_data;
 		{
+			std::lock_guard<std::mutex> lock(decoded_block_mutex_);
+
 			auto iter = decoded_block_cache_.find(data_index);
 			if (iter != decoded_block_cache_.end())
 			{
-				iter->second.tick = decode_tick_;
+				decoded_block_lru_.splice(decoded_block_lru_.end(), decoded_block_lru_, iter->second.lru_iter);
+				return iter->second.data;
 			}
-			else
-			{
-				if (decoded_block_cache_.size() >= 64)
-				{
-					auto min_iter = decoded_block_cache_.begin();
-					uint64_t min_tick = min_iter->second.tick;
-					for (auto dbiter = decoded_block_cache_.begin();
-						dbiter != decoded_block_cache_.end(); ++ dbiter)
-					{
-						if (dbiter->second.tick < min_tick)
-						{
-							min_tick = dbiter->second.tick;
-							min_iter = dbiter;
-						}
-					}
-
-					for (auto dbiter = decoded_block_cache_.begin();
-						dbiter != decoded_block_cache_.end();)
-					{
-						if (dbiter->second.tick == min_tick)
-						{
-							dbiter = decoded_block_cache_.erase(dbiter);
-						}
-						else
-						{
-							++ dbiter;
-						}
-					}
-				}
-
-				uint32_t const full_tile_bytes = tile_size_ * tile_size_ * texel_size_;
-				std::shared_ptr<std::vector<uint8_t>> data = MakeSharedPtr<std::vector<uint8_t>>(full_tile_bytes);
-				if (data_index != EMPTY_DATA_INDEX)
-				{
-					uint64_t offsets[2];
-					input_file_->seekg(data_blocks_offset_ + data_index * sizeof(uint64_t), std::ios_base::beg);
-					input_file_->read(offsets, sizeof(offsets));
-					uint32_t const comed_len = static_cast<uint32_t>(offsets[1] - offsets[0]);
-					std::vector<uint8_t> comed_data(comed_len);
-					input_file_->seekg(offsets[0], std::ios_base::beg);
-					input_file_->read(&comed_data[0], comed_len);
-					lzma_dec_.Decode(&(*data)[0], &comed_data[0], comed_len, full_tile_bytes);
-				}
-				else
-				{
-					memset(&(*data)[0], 0, full_tile_bytes);
-				}
 
-				iter = decoded_block_cache_.emplace(data_index, DecodedBlockInfo(data, decode_tick_)).first;
+			if (data_index != EMPTY_DATA_INDEX)
+			{
+				uint64_t offsets[2];
+				input_file_->seekg(data_blocks_offset_ + data_index * sizeof(uint64_t), std::ios_base::beg);
+				input_file_->read(offsets, sizeof(offsets));
+				uint32_t const comed_len = static_cast<uint32_t>(offsets[1] - offsets[0]);
+				comed_data.resize(comed_len);
+				input_file_->seekg(offsets[0], std::ios_base::beg);
+				input_file_->read(&comed_data[0], comed_len);
 			}
+		}
 
-			return &(*iter->second.data)[0];
+		uint32_t const full_tile_bytes = tile_size_ * tile_size_ * texel_size_;
+		std::shared_ptr<std::vector<uint8_t>> data = MakeSharedPtr<std::vector<uint8_t>>(full_tile_bytes);
+		if (data_index != EMPTY_DATA_INDEX)
+		{
+			LZMACodec lzma_dec;
+			lzma_dec.Decode(&(*data)[0], &comed_data[0], comed_data.size(), full_tile_bytes);
 		}
 		else
 		{
-			return &data_blocks_[data_index][0];
+			memset(&(*data)[0], 0, full_tile_bytes);
+		}
+
+		std::lock_guard<std::mutex> lock(decoded_block_mutex_);
+
+		auto iter = decoded_block_cache_.find(data_index);
+		if (iter != decoded_block_cache_.end())
+		{
+			// Another task decoded it first
+			return iter->second.data;
+		}
+
+		if (decoded_block_cache_.size() >= MAX_DECODED_BLOCKS)
+		{
+			decoded_block_cache_.erase(decoded_block_lru_.front());
+			decoded_block_lru_.pop_front();
 		}
+		decoded_block_cache_.emplace(data_index,
+			DecodedBlockInfo(data, decoded_block_lru_.insert(decoded_block_lru_.end(), data_index)));
+
+		return data;
 	}
 
 	uint32_t JudaTexture::NumNonEmptySubNodes(quadtree_node_ptr const & node) const
@@ -1203,7 +1202,16 @@ namespace KlayGE
 
 			tex_indirect_ = rf.MakeTexture2D(num_tiles_, num_tiles_, 1, 1, EF_ABGR8, 1, 0, EAH_GPU_Read);
 
-			tile_free_list_.emplace_back(0, pages);
+			uint32_t const num_layers = tex_cache_ ? tex_cache_->ArraySize() : array_size;
+			uint32_t const num_cache_tiles = std::min(pages, s * s * num_layers);
+			tile_free_slots_.resize(num_cache_tiles);
+			for (uint32_t i = 0; i < num_cache_tiles; ++ i)
+			{
+				// Slot 0 is handed out first
+				tile_free_slots_[i] = num_cache_tiles - 1 - i;
+			}
+
+			stream_tasks_ = MakeUniquePtr<task_group>(Context::Instance().TaskScheduler());
 		}
 	}
 
@@ -1247,1317 +1255,1379 @@ namespace KlayGE
 				static_cast<float>(cache_tile_border_size_));
 	}
 
+	void JudaTexture::UploadBudget(uint32_t budget)
+	{
+		upload_budget_ = budget;
+	}
+
+	uint32_t JudaTexture::UploadBudget() const
+	{
+		return upload_budget_;
+	}
+
+	uint32_t JudaTexture::NumResidentTiles() const
+	{
+		return static_cast<uint32_t>(tile_info_map_.size());
+	}
+
+	uint32_t JudaTexture::NumInFlightTiles() const
+	{
+		return static_cast<uint32_t>(in_flight_tiles_.size());
+	}
+
 	void JudaTexture::UpdateCache(std::vector<uint32_t> const & tile_ids)
 	{
 		BOOST_ASSERT(tex_cache_ || !tex_cache_array_.empty());
 
 		++ tile_tick_;
 
+		// Tiles in use in this frame, including the parents standing in for missing tiles, can't be evicted
+		for (auto const tile_id : tile_ids)
+		{
+			uint32_t levels_up;
+			uint32_t const resident_id = this->FindResidentTile(levels_up, tile_id);
+			if (resident_id != 0xFFFFFFFF)
+			{
+				this->TouchTile(resident_id);
+			}
+		}
+
+		std::vector<std::unique_ptr<StreamedTile>> finished_tiles;
+		{
+			std::lock_guard<std::mutex> lock(streamed_tiles_mutex_);
+			while (!streamed_tiles_.empty() && (finished_tiles.size() < upload_budget_))
+			{
+				finished_tiles.push_back(std::move(streamed_tiles_.front()));
+				streamed_tiles_.pop_front();
+			}
+		}
+		for (auto const & tile : finished_tiles)
+		{
+			this->UploadTile(*tile);
+			in_flight_tiles_.erase(tile->tile_id);
+		}
+
+		for (auto const tile_id : tile_ids)
+		{
+			uint32_t level, tile_x, tile_y;
+			this->DecodeTileID(level, tile_x, tile_y, tile_id);
+
+			uint32_t levels_up;
+			uint32_t const resident_id = this->FindResidentTile(levels_up, tile_id);
+			if (levels_up > 1)
+			{
+				// The parent is shared by 4 tiles, and it's a better stand-in than the current one
+				this->RequestTile(this->EncodeTileID(level - 1, tile_x / 2, tile_y / 2));
+			}
+			if (levels_up > 0)
+			{
+				this->RequestTile(tile_id);
+			}
+
+			if (resident_id != 0xFFFFFFFF)
+			{
+				TileInfo const & tile_info = tile_info_map_.find(resident_id)->second;
+
+				// The alpha channel is the number of levels up to the tile actually in the cache
+				uint8_t const a_tile_indirect[] =
+				{
+					static_cast<uint8_t>(tile_info.x),
+					static_cast<uint8_t>(tile_info.y),
+					static_cast<uint8_t>(tile_info.z),
+					static_cast<uint8_t>(levels_up)
+				};
+				uint32_t indirect;
+				std::memcpy(&indirect, a_tile_indirect, sizeof(indirect));
+
+				uint32_t const texel = tile_y * num_tiles_ + tile_x;
+				auto iter = tile_indirect_map_.find(texel);
+				if ((iter == tile_indirect_map_.end()) || (iter->second != indirect))
+				{
+					tex_indirect_->UpdateSubresource2D(0, 0, tile_x, tile_y, 1, 1, a_tile_indirect, sizeof(a_tile_indirect));
+					tile_indirect_map_[texel] = indirect;
+				}
+			}
+		}
+	}
+
+	void JudaTexture::RequestTile(uint32_t tile_id)
+	{
+		if ((in_flight_tiles_.size() < MAX_IN_FLIGHT_TILES) && in_flight_tiles_.insert(tile_id).second)
+		{
+			stream_tasks_->run([this, tile_id]
+				{
+					auto tile = MakeUniquePtr<StreamedTile>();
+					tile->tile_id = tile_id;
+					this->BuildCacheTile(*tile);
+
+					std::lock_guard<std::mutex> lock(streamed_tiles_mutex_);
+					streamed_tiles_.push_back(std::move(tile));
+				});
+		}
+	}
+
+	void JudaTexture::TouchTile(uint32_t tile_id)
+	{
+		auto iter = tile_info_map_.find(tile_id);
+		BOOST_ASSERT(iter != tile_info_map_.end());
+
+		iter->second.tick = tile_tick_;
+		tile_lru_.splice(tile_lru_.end(), tile_lru_, iter->second.lru_iter);
+	}
+
+	uint32_t JudaTexture::FindResidentTile(uint32_t& levels_up, uint32_t tile_id) const
+	{
+		uint32_t level, tile_x, tile_y;
+		this->DecodeTileID(level, tile_x, tile_y, tile_id);
+
+		for (levels_up = 0; levels_up <= level; ++ levels_up)
+		{
+			uint32_t const id = this->EncodeTileID(level - levels_up, tile_x >> levels_up, tile_y >> levels_up);
+			if (tile_info_map_.find(id) != tile_info_map_.end())
+			{
+				return id;
+			}
+		}
+
+		return 0xFFFFFFFF;
+	}
+
+	void JudaTexture::UploadTile(StreamedTile const & tile)
+	{
 		uint32_t const tex_width = tex_cache_ ? tex_cache_->Width(0) : tex_cache_array_[0]->Width(0);
 		uint32_t const tex_height = tex_cache_ ? tex_cache_->Height(0) : tex_cache_array_[0]->Height(0);
-		uint32_t const tex_layer = tex_cache_ ? tex_cache_->ArraySize() : static_cast<uint32_t>(tex_cache_array_.size());
 		uint32_t const tile_with_border_size = cache_tile_size_ + cache_tile_border_size_ * 2;
 
 		uint32_t const num_cache_tiles_a_row = tex_width / tile_with_border_size;
 		uint32_t const num_cache_tiles_a_layer = num_cache_tiles_a_row * tex_height / tile_with_border_size;
-		uint32_t const num_cache_total_tiles = num_cache_tiles_a_layer * tex_layer;
 
-		std::unordered_map<uint32_t, uint32_t> neighbor_id_map;
-		std::vector<uint32_t> all_neighbor_ids;
-		std::vector<uint32_t> neighbor_ids;
-		std::vector<uint32_t> tile_attrs;
-		std::vector<bool> in_same_image;
-		auto& tim = tile_info_map_;
-		for (size_t i = 0; i < tile_ids.size(); ++ i)
+		TileInfo tile_info;
+		if (!tile_free_slots_.empty())
 		{
-			auto tmiter = tim.find(tile_ids[i]);
-			if (tmiter != tim.end())
-			{
-				// Exists in cache
+			// Still has space in cache
 
-				tmiter->second.tick = tile_tick_;
-			}
-			else
+			uint32_t const s = tile_free_slots_.back();
+			tile_free_slots_.pop_back();
+
+			tile_info.z = s / num_cache_tiles_a_layer;
+			tile_info.y = (s - tile_info.z * num_cache_tiles_a_layer) / num_cache_tiles_a_row;
+			tile_info.x = s - tile_info.z * num_cache_tiles_a_layer - tile_info.y * num_cache_tiles_a_row;
+		}
+		else
+		{
+			// Reuses the tile that is not used for the longest time
+
+			auto lru_iter = tile_info_map_.find(tile_lru_.front());
+			if (lru_iter->second.tick == tile_tick_)
 			{
-				uint32_t level, tile_x, tile_y;
-				this->DecodeTileID(level, tile_x, tile_y, tile_ids[i]);
+				// Everything in the cache is in use. Drops this one, it's requested again in later frames.
+				return;
+			}
 
-				std::array<uint32_t, 9> new_tile_id_with_neighbors;
-				new_tile_id_with_neighbors.fill(0xFFFFFFFF);
-				new_tile_id_with_neighbors[0] = tile_ids[i];
+			tile_info.x = lru_iter->second.x;
+			tile_info.y = lru_iter->second.y;
+			tile_info.z = lru_iter->second.z;
 
-				std::array<bool, 9> new_in_same_image;
-				new_in_same_image.fill(false);
-				new_in_same_image[0] = true;
+			tile_lru_.pop_front();
+			tile_info_map_.erase(lru_iter);
+		}
 
-				uint32_t attr = this->DecodeAAttr(this->Pos2Shuff(level, tile_x, tile_y));
-				tile_attrs.push_back(attr);
-				if (attr != 0xFFFFFFFF)
-				{
-					std::array<int32_t, 9> new_tile_id_x;
-					std::array<int32_t, 9> new_tile_id_y;
+		TexturePtr target_tex;
+		uint32_t target_array_index;
+		if (tex_cache_)
+		{
+			target_tex = tex_cache_;
+			target_array_index = tile_info.z;
+		}
+		else
+		{
+			target_tex = tex_cache_array_[tile_info.z];
+			target_array_index = 0;
+		}
 
-					int32_t left = tile_x - 1;
-					int32_t right = tile_x + 1;
-					int32_t up = tile_y - 1;
-					int32_t down = tile_y + 1;
+		uint32_t mip_tile_with_border_size = tile_with_border_size;
+		for (uint32_t l = 0; l < tile.mip_data.size(); ++ l)
+		{
+			target_tex->UpdateSubresource2D(target_array_index, l,
+				tile_info.x * mip_tile_with_border_size, tile_info.y * mip_tile_with_border_size,
+				mip_tile_with_border_size, mip_tile_with_border_size,
+				&tile.mip_data[l][0], tile.mip_row_pitches[l]);
 
-					ImageEntry const & entry = image_entries_[attr];
-					if (TAM_Wrap == (entry.addr_u_v & 0xF))
-					{
-						left = entry.x + (left - entry.x + entry.w) % entry.w;
-						right = entry.x + (right - entry.x + entry.w) % entry.w;
-					}
-					if (TAM_Wrap == ((entry.addr_u_v >> 4) & 0xF))
-					{
-						up = entry.y + (up - entry.y + entry.h) % entry.h;
-						down = entry.y + (down - entry.y + entry.h) % entry.h;
-					}
+			mip_tile_with_border_size /= 2;
+		}
 
-					new_tile_id_x[1] = left;
-					new_tile_id_y[1] = up;
-					new_tile_id_x[2] = tile_x;
-					new_tile_id_y[2] = up;
-					new_tile_id_x[3] = right;
-					new_tile_id_y[3] = up;
-
-					new_tile_id_x[4] = left;
-					new_tile_id_y[4] = tile_y;
-					new_tile_id_x[5] = right;
-					new_tile_id_y[5] = tile_y;
-
-					new_tile_id_x[6] = left;
-					new_tile_id_y[6] = down;
-					new_tile_id_x[7] = tile_x;
-					new_tile_id_y[7] = down;
-					new_tile_id_x[8] = right;
-					new_tile_id_y[8] = down;
-
-					for (int j = 1; j < 9; ++ j)
-					{
-						if ((new_tile_id_x[j] >= 0) && (new_tile_id_y[j] >= 0)
-							&& (new_tile_id_x[j] < static_cast<int32_t>(num_tiles_) - 1)
-							&& (new_tile_id_y[j] < static_cast<int32_t>(num_tiles_) - 1))
-						{
-							new_tile_id_with_neighbors[j] = this->EncodeTileID(level, new_tile_id_x[j], new_tile_id_y[j]);
-							if (new_tile_id_with_neighbors[j] != 0xFFFFFFFF)
-							{
-								if (attr == this->DecodeAAttr(this->Pos2Shuff(level, new_tile_id_x[j], new_tile_id_y[j])))
-								{
-									new_in_same_image[j] = true;
-								}
-							}
-						}
-						else
-						{
-							new_tile_id_with_neighbors[j] = 0xFFFFFFFF;
-						}
-					}
-				}
+		tile_info.attr = tile.attr;
+		tile_info.tick = tile_tick_;
+		tile_info.lru_iter = tile_lru_.insert(tile_lru_.end(), tile.tile_id);
+		tile_info_map_.emplace(tile.tile_id, tile_info);
+	}
 
-				for (size_t j = 0; j < new_tile_id_with_neighbors.size(); ++ j)
+	void JudaTexture::BuildCacheTile(StreamedTile& tile)
+	{
+		uint32_t level, tile_x, tile_y;
+		this->DecodeTileID(level, tile_x, tile_y, tile.tile_id);
+
+		std::array<uint32_t, 9> new_tile_id_with_neighbors;
+		new_tile_id_with_neighbors.fill(0xFFFFFFFF);
+		new_tile_id_with_neighbors[0] = tile.tile_id;
+
+		std::array<bool, 9> new_in_same_image;
+		new_in_same_image.fill(false);
+		new_in_same_image[0] = true;
+
+		uint32_t attr = this->DecodeAAttr(this->Pos2Shuff(level, tile_x, tile_y));
+		tile.attr = attr;
+		if (attr != 0xFFFFFFFF)
+		{
+			std::array<int32_t, 9> new_tile_id_x;
+			std::array<int32_t, 9> new_tile_id_y;
+
+			int32_t left = tile_x - 1;
+			int32_t right = tile_x + 1;
+			int32_t up = tile_y - 1;
+			int32_t down = tile_y + 1;
+
+			ImageEntry const & entry = image_entries_[attr];
+			if (TAM_Wrap == (entry.addr_u_v & 0xF))
+			{
+				left = entry.x + (left - entry.x + entry.w) % entry.w;
+				right = entry.x + (right - entry.x + entry.w) % entry.w;
+			}
+			if (TAM_Wrap == ((entry.addr_u_v >> 4) & 0xF))
+			{
+				up = entry.y + (up - entry.y + entry.h) % entry.h;
+				down = entry.y + (down - entry.y + entry.h) % entry.h;
+			}
+
+			new_tile_id_x[1] = left;
+			new_tile_id_y[1] = up;
+			new_tile_id_x[2] = tile_x;
+			new_tile_id_y[2] = up;
+			new_tile_id_x[3] = right;
+			new_tile_id_y[3] = up;
+
+			new_tile_id_x[4] = left;
+			new_tile_id_y[4] = tile_y;
+			new_tile_id_x[5] = right;
+			new_tile_id_y[5] = tile_y;
+
+			new_tile_id_x[6] = left;
+			new_tile_id_y[6] = down;
+			new_tile_id_x[7] = tile_x;
+			new_tile_id_y[7] = down;
+			new_tile_id_x[8] = right;
+			new_tile_id_y[8] = down;
+
+			for (int j = 1; j < 9; ++ j)
+			{
+				if ((new_tile_id_x[j] >= 0) && (new_tile_id_y[j] >= 0)
+					&& (new_tile_id_x[j] < static_cast<int32_t>(num_tiles_) - 1)
+					&& (new_tile_id_y[j] < static_cast<int32_t>(num_tiles_) - 1))
 				{
+					new_tile_id_with_neighbors[j] = this->EncodeTileID(level, new_tile_id_x[j], new_tile_id_y[j]);
 					if (new_tile_id_with_neighbors[j] != 0xFFFFFFFF)
 					{
-						if (neighbor_id_map.find(new_tile_id_with_neighbors[j]) == neighbor_id_map.end())
+						if (attr == this->DecodeAAttr(this->Pos2Shuff(level, new_tile_id_x[j], new_tile_id_y[j])))
 						{
-							neighbor_id_map.emplace(new_tile_id_with_neighbors[j], static_cast<uint32_t>(neighbor_ids.size()));
-							neighbor_ids.push_back(new_tile_id_with_neighbors[j]);
+							new_in_same_image[j] = true;
 						}
 					}
-					all_neighbor_ids.push_back(new_tile_id_with_neighbors[j]);
-					in_same_image.push_back(new_in_same_image[j]);
+				}
+				else
+				{
+					new_tile_id_with_neighbors[j] = 0xFFFFFFFF;
 				}
 			}
 		}
 
-		uint32_t mipmaps = tex_cache_->NumMipMaps();
-		std::vector<std::vector<uint8_t>> neighbor_data;
-		this->DecodeTiles(neighbor_data, neighbor_ids, mipmaps);
-
-		TileInfo tile_info;
-		tile_info.tick = tile_tick_;
-		for (size_t i = 0; i < all_neighbor_ids.size(); i += 9)
+		std::vector<uint32_t> neighbor_ids;
+		std::array<uint32_t, 9> index_with_neighbors;
+		for (size_t j = 0; j < new_tile_id_with_neighbors.size(); ++ j)
 		{
-			tile_info.attr = tile_attrs[i / 9];
-			uint8_t border_clr[4];
-			TexAddressingMode addr_u, addr_v;
-			if (tile_info.attr != 0xFFFFFFFF)
-			{
-				ImageEntry const & entry = image_entries_[tile_info.attr];
-				addr_u = static_cast<TexAddressingMode>(entry.addr_u_v & 0xF);
-				addr_v = static_cast<TexAddressingMode>((entry.addr_u_v >> 4) & 0xF);
-				texel_op_.from_float4(border_clr, &entry.border_clr.r());
-			}
-			else
-			{
-				addr_u = TAM_Clamp;
-				addr_v = TAM_Clamp;
-				border_clr[0] = border_clr[1] = border_clr[2] = border_clr[3] = 0;
-			}
-
-			if (tile_info_map_.size() < num_cache_total_tiles)
+			if (new_tile_id_with_neighbors[j] != 0xFFFFFFFF)
 			{
-				// Still has space in cache
-
-				uint32_t const s = tile_free_list_.front().first;
-				tile_info.z = s / num_cache_tiles_a_layer;
-				tile_info.y = (s - tile_info.z * num_cache_tiles_a_layer) / num_cache_tiles_a_row;
-				tile_info.x = s - tile_info.z * num_cache_tiles_a_layer - tile_info.y * num_cache_tiles_a_row;
-
-				++ tile_free_list_.front().first;
-				if (tile_free_list_.front().first == tile_free_list_.front().second)
+				auto iter = std::find(neighbor_ids.begin(), neighbor_ids.end(), new_tile_id_with_neighbors[j]);
+				index_with_neighbors[j] = static_cast<uint32_t>(iter - neighbor_ids.begin());
+				if (iter == neighbor_ids.end())
 				{
-					tile_free_list_.pop_front();
+					neighbor_ids.push_back(new_tile_id_with_neighbors[j]);
 				}
 			}
 			else
 			{
-				// Find tiles that are not used for the longest time
+				index_with_neighbors[j] = 0xFFFFFFFF;
+			}
+		}
+		BOOST_ASSERT(index_with_neighbors[0] != 0xFFFFFFFF);
 
-				uint64_t min_tick = tim.begin()->second.tick;
-				auto min_tileiter = tim.begin();
-				for (auto tileiter = tim.begin(); tileiter != tim.end(); ++ tileiter)
-				{
-					if (tileiter->second.tick < min_tick)
-					{
-						min_tick = tileiter->second.tick;
-						min_tileiter = tileiter;
-					}
-				}
+		TexturePtr const & cache_tex = tex_cache_ ? tex_cache_ : tex_cache_array_[0];
+		uint32_t const mipmaps = cache_tex->NumMipMaps();
+		ElementFormat const format = cache_tex->Format();
 
-				tile_info.x = min_tileiter->second.x;
-				tile_info.y = min_tileiter->second.y;
-				tile_info.z = min_tileiter->second.z;
+		std::vector<std::vector<uint8_t>> neighbor_data;
+		this->DecodeTiles(neighbor_data, neighbor_ids, mipmaps);
 
-				for (auto tileiter = tim.begin(); tileiter != tim.end();)
-				{
-					if (tileiter->second.tick == min_tick)
-					{
-						uint32_t const id = tileiter->second.z * num_cache_tiles_a_layer + tileiter->second.y * num_cache_tiles_a_row + tileiter->second.x;
-						auto freeiter = tile_free_list_.begin();
-						while ((freeiter != tile_free_list_.end()) && (freeiter->second <= id))
-						{
-							++ freeiter;
-						}
-						tile_free_list_.emplace(freeiter, id, id + 1);
+		uint8_t border_clr[4];
+		TexAddressingMode addr_u, addr_v;
+		if (attr != 0xFFFFFFFF)
+		{
+			ImageEntry const & entry = image_entries_[attr];
+			addr_u = static_cast<TexAddressingMode>(entry.addr_u_v & 0xF);
+			addr_v = static_cast<TexAddressingMode>((entry.addr_u_v >> 4) & 0xF);
+			texel_op_.from_float4(border_clr, &entry.border_clr.r());
+		}
+		else
+		{
+			addr_u = TAM_Clamp;
+			addr_v = TAM_Clamp;
+			border_clr[0] = border_clr[1] = border_clr[2] = border_clr[3] = 0;
+		}
 
-						tileiter = tim.erase(tileiter);
-					}
-					else
-					{
-						 ++ tileiter;
-					}
-				}
-				for (auto freeiter = tile_free_list_.begin(); freeiter != tile_free_list_.end() - 1;)
-				{
-					auto nextiter = freeiter;
-					++ nextiter;
+		// Tiles are built in parallel, each one has its own codec
+		TexCompressionPtr codec;
+		if (IsCompressedFormat(format))
+		{
+			codec = tex_codec_->Clone();
+		}
 
-					if (freeiter->second == nextiter->first)
-					{
-						freeiter->second = nextiter->second;
-						freeiter = tile_free_list_.erase(nextiter);
-						-- freeiter;
-					}
-					else
-					{
-						++ freeiter;
-					}
-				}
-			}
+		uint32_t const tile_with_border_size = cache_tile_size_ + cache_tile_border_size_ * 2;
+		tile.mip_data.resize(mipmaps);
+		tile.mip_row_pitches.resize(mipmaps);
 
-			std::array<uint32_t, 9> index_with_neighbors = { { 0 } };
-			for (size_t j = 0; j < index_with_neighbors.size(); ++ j)
+		uint32_t mip_tile_size = cache_tile_size_;
+		uint32_t mip_tile_with_border_size = tile_with_border_size;
+		uint32_t mip_border_size = cache_tile_border_size_;
+		for (uint32_t l = 0; l < mipmaps; ++ l)
+		{
+#if defined(KLAYGE_COMPILER_MSVC)
+			std::array<uint8_t const *, 9> neighbor_data_ptr{};
+#else
+			std::array<uint8_t const *, 9> neighbor_data_ptr;
+#endif
+			for (uint32_t j = 0; j < neighbor_data_ptr.size(); ++ j)
 			{
-				if (all_neighbor_ids[i + j] != 0xFFFFFFFF)
+				if (index_with_neighbors[j] != 0xFFFFFFFF)
 				{
-					BOOST_ASSERT(neighbor_id_map.find(all_neighbor_ids[i + j]) != neighbor_id_map.end());
-
-					index_with_neighbors[j] = neighbor_id_map[all_neighbor_ids[i + j]];
+					neighbor_data_ptr[j] = &neighbor_data[index_with_neighbors[j] * mipmaps + l][0];
 				}
 				else
 				{
-					index_with_neighbors[j] = 0xFFFFFFFF;
+					neighbor_data_ptr[j] = nullptr;
 				}
 			}
-			BOOST_ASSERT(index_with_neighbors[0] != 0xFFFFFFFF);
 
-			uint32_t mip_tile_size = cache_tile_size_;
-			uint32_t mip_tile_with_border_size = tile_with_border_size;
-			uint32_t mip_border_size = cache_tile_border_size_;
-			for (uint32_t l = 0; l < mipmaps; ++ l)
+			std::vector<uint8_t> tex_a_tile_data(mip_tile_with_border_size * mip_tile_with_border_size * texel_size_);
 			{
-#if defined(KLAYGE_COMPILER_MSVC)
-				std::array<uint8_t const *, 9> neighbor_data_ptr{};
-#else
-				std::array<uint8_t const *, 9> neighbor_data_ptr;
-#endif
-				for (uint32_t j = 0; j < neighbor_data_ptr.size(); ++ j)
+				uint8_t* data_with_border = &tex_a_tile_data[0];
+				uint32_t const data_pitch = mip_tile_with_border_size * texel_size_;
+			
+				for (uint32_t y = 0; y < mip_tile_size; ++ y)
 				{
-					if (index_with_neighbors[j] != 0xFFFFFFFF)
-					{
-						neighbor_data_ptr[j] = &neighbor_data[index_with_neighbors[j] * mipmaps + l][0];
-					}
-					else
-					{
-						neighbor_data_ptr[j] = nullptr;
-					}
+					texel_op_.copy_array(data_with_border + (y + mip_border_size) * data_pitch + mip_border_size * texel_size_,
+						neighbor_data_ptr[0] + y * mip_tile_size * texel_size_, mip_tile_size);
 				}
 
-				std::vector<uint8_t> tex_a_tile_data(mip_tile_with_border_size * mip_tile_with_border_size * texel_size_);
+				if ((neighbor_data_ptr[1] != nullptr) && new_in_same_image[1])
 				{
-					uint8_t* data_with_border = &tex_a_tile_data[0];
-					uint32_t const data_pitch = mip_tile_with_border_size * texel_size_;
-				
-					for (uint32_t y = 0; y < mip_tile_size; ++ y)
-					{
-						texel_op_.copy_array(data_with_border + (y + mip_border_size) * data_pitch + mip_border_size * texel_size_,
-							neighbor_data_ptr[0] + y * mip_tile_size * texel_size_, mip_tile_size);
-					}
-
-					if ((neighbor_data_ptr[1] != nullptr) && in_same_image[i + 1])
+					for (uint32_t y = 0; y < mip_border_size; ++ y)
 					{
-						for (uint32_t y = 0; y < mip_border_size; ++ y)
-						{
-							texel_op_.copy_array(data_with_border + y * data_pitch,
-								neighbor_data_ptr[1] + ((y + mip_tile_size - mip_border_size) * mip_tile_size + (mip_tile_size - mip_border_size)) * texel_size_,
-								mip_border_size);
-						}
+						texel_op_.copy_array(data_with_border + y * data_pitch,
+							neighbor_data_ptr[1] + ((y + mip_tile_size - mip_border_size) * mip_tile_size + (mip_tile_size - mip_border_size)) * texel_size_,
+							mip_border_size);
 					}
-					else
+				}
+				else
+				{
+					if (attr != 0xFFFFFFFF)
 					{
-						if (tile_info.attr != 0xFFFFFFFF)
+						std::vector<int32_t> border_coords_x(mip_border_size * mip_border_size);
+						std::vector<int32_t> border_coords_y(mip_border_size * mip_border_size);
+						switch (addr_u)
 						{
-							std::vector<int32_t> border_coords_x(mip_border_size * mip_border_size);
-							std::vector<int32_t> border_coords_y(mip_border_size * mip_border_size);
-							switch (addr_u)
+						case TAM_Mirror:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
-								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = mip_border_size - 1 - x;
-									}
-								}
-								break;
-
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
-								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = 0;
-									}
-								}
-								break;
-
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = -1;
-									}
+									border_coords_x[y * mip_border_size + x] = mip_border_size - 1 - x;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
-							switch (addr_v)
-							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
-								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = mip_border_size - 1 - y;
-									}
-								}
-								break;
-
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
-								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = 0;
-									}
-								}
-								break;
+							break;
 
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = -1;
-									}
+									border_coords_x[y * mip_border_size + x] = 0;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
+							break;
 
+						case TAM_Border:
 							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
 								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									if ((border_coords_x[y * mip_border_size + x] >= 0) && (border_coords_y[y * mip_border_size + x] >= 0))
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
-											neighbor_data_ptr[0] + border_coords_y[y * mip_border_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_border_size + x]);
-									}
-									else
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
-									}
+									border_coords_x[y * mip_border_size + x] = -1;
 								}
 							}
-						}
-						else
+							break;
+
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
+						}
+						switch (addr_v)
 						{
+						case TAM_Mirror:
 							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
 								for (uint32_t x = 0; x < mip_border_size; ++ x)
+								{
+									border_coords_y[y * mip_border_size + x] = mip_border_size - 1 - y;
+								}
+							}
+							break;
+
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
+								{
+									border_coords_y[y * mip_border_size + x] = 0;
+								}
+							}
+							break;
+
+						case TAM_Border:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
+								{
+									border_coords_y[y * mip_border_size + x] = -1;
+								}
+							}
+							break;
+
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
+						}
+
+						for (uint32_t y = 0; y < mip_border_size; ++ y)
+						{
+							for (uint32_t x = 0; x < mip_border_size; ++ x)
+							{
+								if ((border_coords_x[y * mip_border_size + x] >= 0) && (border_coords_y[y * mip_border_size + x] >= 0))
 								{
 									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
-											neighbor_data_ptr[0]);
+										neighbor_data_ptr[0] + border_coords_y[y * mip_border_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_border_size + x]);
+								}
+								else
+								{
+									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
 								}
 							}
 						}
 					}
-					if ((neighbor_data_ptr[2] != nullptr) && in_same_image[i + 2])
+					else
 					{
 						for (uint32_t y = 0; y < mip_border_size; ++ y)
 						{
-							texel_op_.copy_array(data_with_border + y * data_pitch + mip_border_size * texel_size_,
-								neighbor_data_ptr[2] + ((y + mip_tile_size - mip_border_size) * mip_tile_size) * texel_size_, mip_tile_size);
+							for (uint32_t x = 0; x < mip_border_size; ++ x)
+							{
+								texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
+										neighbor_data_ptr[0]);
+							}
 						}
 					}
-					else
+				}
+				if ((neighbor_data_ptr[2] != nullptr) && new_in_same_image[2])
+				{
+					for (uint32_t y = 0; y < mip_border_size; ++ y)
+					{
+						texel_op_.copy_array(data_with_border + y * data_pitch + mip_border_size * texel_size_,
+							neighbor_data_ptr[2] + ((y + mip_tile_size - mip_border_size) * mip_tile_size) * texel_size_, mip_tile_size);
+					}
+				}
+				else
+				{
+					if (attr != 0xFFFFFFFF)
 					{
-						if (tile_info.attr != 0xFFFFFFFF)
+						std::vector<int32_t> border_coords_x(mip_tile_size * mip_border_size);
+						std::vector<int32_t> border_coords_y(mip_tile_size * mip_border_size);
+						switch (addr_u)
 						{
-							std::vector<int32_t> border_coords_x(mip_tile_size * mip_border_size);
-							std::vector<int32_t> border_coords_y(mip_tile_size * mip_border_size);
-							switch (addr_u)
+						case TAM_Mirror:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
-								{
-									for (uint32_t x = 0; x < mip_tile_size; ++ x)
-									{
-										border_coords_x[y * mip_tile_size + x] = x;
-									}
-								}
-								break;
-
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+								for (uint32_t x = 0; x < mip_tile_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_tile_size; ++ x)
-									{
-										border_coords_x[y * mip_tile_size + x] = x;
-									}
+									border_coords_x[y * mip_tile_size + x] = x;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_tile_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_tile_size; ++ x)
-									{
-										border_coords_x[y * mip_tile_size + x] = -1;
-									}
+									border_coords_x[y * mip_tile_size + x] = x;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
-							switch (addr_v)
+							break;
+
+						case TAM_Border:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+								for (uint32_t x = 0; x < mip_tile_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_tile_size; ++ x)
-									{
-										border_coords_y[y * mip_tile_size + x] = mip_border_size - 1 - y;
-									}
+									border_coords_x[y * mip_tile_size + x] = -1;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
+						}
+						switch (addr_v)
+						{
+						case TAM_Mirror:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_tile_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_tile_size; ++ x)
-									{
-										border_coords_y[y * mip_tile_size + x] = 0;
-									}
+									border_coords_y[y * mip_tile_size + x] = mip_border_size - 1 - y;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_tile_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_tile_size; ++ x)
-									{
-										border_coords_y[y * mip_tile_size + x] = -1;
-									}
+									border_coords_y[y * mip_tile_size + x] = 0;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
+							break;
 
+						case TAM_Border:
 							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
 								for (uint32_t x = 0; x < mip_tile_size; ++ x)
 								{
-									if ((border_coords_x[y * mip_tile_size + x] >= 0) && (border_coords_y[y * mip_tile_size + x] >= 0))
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
-											neighbor_data_ptr[0] + border_coords_y[y * mip_tile_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_tile_size + x]);
-									}
-									else
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
-									}
+									border_coords_y[y * mip_tile_size + x] = -1;
 								}
 							}
+							break;
+
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
 						}
-						else
+
+						for (uint32_t y = 0; y < mip_border_size; ++ y)
 						{
-							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							for (uint32_t x = 0; x < mip_tile_size; ++ x)
 							{
-								texel_op_.copy_array(data_with_border + y * data_pitch + mip_border_size * texel_size_,
-									neighbor_data_ptr[0], mip_tile_size);
+								if ((border_coords_x[y * mip_tile_size + x] >= 0) && (border_coords_y[y * mip_tile_size + x] >= 0))
+								{
+									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
+										neighbor_data_ptr[0] + border_coords_y[y * mip_tile_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_tile_size + x]);
+								}
+								else
+								{
+									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
+								}
 							}
 						}
 					}
-					if ((neighbor_data_ptr[3] != nullptr) && in_same_image[i + 3])
+					else
 					{
 						for (uint32_t y = 0; y < mip_border_size; ++ y)
 						{
-							texel_op_.copy_array(data_with_border + y * data_pitch + (mip_border_size + mip_tile_size) * texel_size_,
-								neighbor_data_ptr[3] + (y + mip_tile_size - mip_border_size) * mip_tile_size * texel_size_, mip_border_size);
+							texel_op_.copy_array(data_with_border + y * data_pitch + mip_border_size * texel_size_,
+								neighbor_data_ptr[0], mip_tile_size);
 						}
 					}
-					else
+				}
+				if ((neighbor_data_ptr[3] != nullptr) && new_in_same_image[3])
+				{
+					for (uint32_t y = 0; y < mip_border_size; ++ y)
 					{
-						if (tile_info.attr != 0xFFFFFFFF)
+						texel_op_.copy_array(data_with_border + y * data_pitch + (mip_border_size + mip_tile_size) * texel_size_,
+							neighbor_data_ptr[3] + (y + mip_tile_size - mip_border_size) * mip_tile_size * texel_size_, mip_border_size);
+					}
+				}
+				else
+				{
+					if (attr != 0xFFFFFFFF)
+					{
+						std::vector<int32_t> border_coords_x(mip_border_size * mip_border_size);
+						std::vector<int32_t> border_coords_y(mip_border_size * mip_border_size);
+						switch (addr_u)
 						{
-							std::vector<int32_t> border_coords_x(mip_border_size * mip_border_size);
-							std::vector<int32_t> border_coords_y(mip_border_size * mip_border_size);
-							switch (addr_u)
+						case TAM_Mirror:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
-								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = mip_tile_size - 1 - x;
-									}
-								}
-								break;
-
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = mip_tile_size - 1;
-									}
+									border_coords_x[y * mip_border_size + x] = mip_tile_size - 1 - x;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = -1;
-									}
+									border_coords_x[y * mip_border_size + x] = mip_tile_size - 1;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
-							switch (addr_v)
+							break;
+
+						case TAM_Border:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = mip_border_size - 1 - y;
-									}
+									border_coords_x[y * mip_border_size + x] = -1;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
+						}
+						switch (addr_v)
+						{
+						case TAM_Mirror:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = 0;
-									}
+									border_coords_y[y * mip_border_size + x] = mip_border_size - 1 - y;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = -1;
-									}
+									border_coords_y[y * mip_border_size + x] = 0;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
+							break;
 
+						case TAM_Border:
 							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
 								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									if ((border_coords_x[y * mip_border_size + x] >= 0) && (border_coords_y[y * mip_border_size + x] >= 0))
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
-											neighbor_data_ptr[0] + border_coords_y[y * mip_border_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_border_size + x]);
-									}
-									else
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
-									}
+									border_coords_y[y * mip_border_size + x] = -1;
 								}
 							}
+							break;
+
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
 						}
-						else
+
+						for (uint32_t y = 0; y < mip_border_size; ++ y)
 						{
-							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							for (uint32_t x = 0; x < mip_border_size; ++ x)
 							{
-								for (uint32_t x = 0; x < mip_border_size; ++ x)
+								if ((border_coords_x[y * mip_border_size + x] >= 0) && (border_coords_y[y * mip_border_size + x] >= 0))
+								{
+									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
+										neighbor_data_ptr[0] + border_coords_y[y * mip_border_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_border_size + x]);
+								}
+								else
 								{
-									texel_op_.copy(data_with_border + y * data_pitch + (x + mip_border_size + mip_tile_size) * texel_size_,
-										neighbor_data_ptr[0] + (mip_tile_size - 1) * texel_size_);
+									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
 								}
 							}
 						}
 					}
-
-					if ((neighbor_data_ptr[4] != nullptr) && in_same_image[i + 4])
+					else
 					{
-						for (uint32_t y = 0; y < mip_tile_size; ++ y)
+						for (uint32_t y = 0; y < mip_border_size; ++ y)
 						{
-							texel_op_.copy_array(data_with_border + (y + mip_border_size) * data_pitch,
-								neighbor_data_ptr[4] + (y * mip_tile_size + (mip_tile_size - mip_border_size)) * texel_size_, mip_border_size);
+							for (uint32_t x = 0; x < mip_border_size; ++ x)
+							{
+								texel_op_.copy(data_with_border + y * data_pitch + (x + mip_border_size + mip_tile_size) * texel_size_,
+									neighbor_data_ptr[0] + (mip_tile_size - 1) * texel_size_);
+							}
 						}
 					}
-					else
+				}
+
+				if ((neighbor_data_ptr[4] != nullptr) && new_in_same_image[4])
+				{
+					for (uint32_t y = 0; y < mip_tile_size; ++ y)
 					{
-						if (tile_info.attr != 0xFFFFFFFF)
+						texel_op_.copy_array(data_with_border + (y + mip_border_size) * data_pitch,
+							neighbor_data_ptr[4] + (y * mip_tile_size + (mip_tile_size - mip_border_size)) * texel_size_, mip_border_size);
+					}
+				}
+				else
+				{
+					if (attr != 0xFFFFFFFF)
+					{
+						std::vector<int32_t> border_coords_x(mip_border_size * mip_tile_size);
+						std::vector<int32_t> border_coords_y(mip_border_size * mip_tile_size);
+						switch (addr_u)
 						{
-							std::vector<int32_t> border_coords_x(mip_border_size * mip_tile_size);
-							std::vector<int32_t> border_coords_y(mip_border_size * mip_tile_size);
-							switch (addr_u)
+						case TAM_Mirror:
+							for (uint32_t y = 0; y < mip_tile_size; ++ y)
 							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_tile_size; ++ y)
-								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = mip_border_size - 1 - x;
-									}
-								}
-								break;
-
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_tile_size; ++ y)
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = 0;
-									}
+									border_coords_x[y * mip_border_size + x] = mip_border_size - 1 - x;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_tile_size; ++ y)
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_tile_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = -1;
-									}
+									border_coords_x[y * mip_border_size + x] = 0;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
-							switch (addr_v)
+							break;
+
+						case TAM_Border:
+							for (uint32_t y = 0; y < mip_tile_size; ++ y)
 							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_tile_size; ++ y)
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = y;
-									}
+									border_coords_x[y * mip_border_size + x] = -1;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_tile_size; ++ y)
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
+						}
+						switch (addr_v)
+						{
+						case TAM_Mirror:
+							for (uint32_t y = 0; y < mip_tile_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = y;
-									}
+									border_coords_y[y * mip_border_size + x] = y;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_tile_size; ++ y)
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_tile_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = -1;
-									}
+									border_coords_y[y * mip_border_size + x] = y;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
+							break;
 
+						case TAM_Border:
 							for (uint32_t y = 0; y < mip_tile_size; ++ y)
 							{
 								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									if ((border_coords_x[y * mip_border_size + x] >= 0) && (border_coords_y[y * mip_border_size + x] >= 0))
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
-											neighbor_data_ptr[0] + border_coords_y[y * mip_border_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_border_size + x]);
-									}
-									else
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
-									}
+									border_coords_y[y * mip_border_size + x] = -1;
 								}
 							}
+							break;
+
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
 						}
-						else
+
+						for (uint32_t y = 0; y < mip_tile_size; ++ y)
 						{
-							for (uint32_t y = 0; y < mip_tile_size; ++ y)
+							for (uint32_t x = 0; x < mip_border_size; ++ x)
 							{
-								for (uint32_t x = 0; x < mip_border_size; ++ x)
+								if ((border_coords_x[y * mip_border_size + x] >= 0) && (border_coords_y[y * mip_border_size + x] >= 0))
 								{
-									texel_op_.copy(data_with_border + (y + mip_border_size) * data_pitch + x * texel_size_,
-										neighbor_data_ptr[0] + y * mip_tile_size * texel_size_);
+									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
+										neighbor_data_ptr[0] + border_coords_y[y * mip_border_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_border_size + x]);
+								}
+								else
+								{
+									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
 								}
 							}
 						}
 					}
-					if ((neighbor_data_ptr[5] != nullptr) && in_same_image[i + 5])
+					else
 					{
 						for (uint32_t y = 0; y < mip_tile_size; ++ y)
 						{
-							texel_op_.copy_array(data_with_border + (y + mip_border_size) * data_pitch + (mip_border_size + mip_tile_size) * texel_size_,
-								neighbor_data_ptr[5] + y * mip_tile_size * texel_size_, mip_border_size);
+							for (uint32_t x = 0; x < mip_border_size; ++ x)
+							{
+								texel_op_.copy(data_with_border + (y + mip_border_size) * data_pitch + x * texel_size_,
+									neighbor_data_ptr[0] + y * mip_tile_size * texel_size_);
+							}
 						}
 					}
-					else
+				}
+				if ((neighbor_data_ptr[5] != nullptr) && new_in_same_image[5])
+				{
+					for (uint32_t y = 0; y < mip_tile_size; ++ y)
+					{
+						texel_op_.copy_array(data_with_border + (y + mip_border_size) * data_pitch + (mip_border_size + mip_tile_size) * texel_size_,
+							neighbor_data_ptr[5] + y * mip_tile_size * texel_size_, mip_border_size);
+					}
+				}
+				else
+				{
+					if (attr != 0xFFFFFFFF)
 					{
-						if (tile_info.attr != 0xFFFFFFFF)
+						std::vector<int32_t> border_coords_x(mip_border_size * mip_tile_size);
+						std::vector<int32_t> border_coords_y(mip_border_size * mip_tile_size);
+						switch (addr_u)
 						{
-							std::vector<int32_t> border_coords_x(mip_border_size * mip_tile_size);
-							std::vector<int32_t> border_coords_y(mip_border_size * mip_tile_size);
-							switch (addr_u)
+						case TAM_Mirror:
+							for (uint32_t y = 0; y < mip_tile_size; ++ y)
 							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_tile_size; ++ y)
-								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = mip_tile_size - 1 - x;
-									}
-								}
-								break;
-
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_tile_size; ++ y)
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = mip_tile_size - 1;
-									}
+									border_coords_x[y * mip_border_size + x] = mip_tile_size - 1 - x;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_tile_size; ++ y)
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_tile_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = -1;
-									}
+									border_coords_x[y * mip_border_size + x] = mip_tile_size - 1;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
-							switch (addr_v)
+							break;
+
+						case TAM_Border:
+							for (uint32_t y = 0; y < mip_tile_size; ++ y)
 							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_tile_size; ++ y)
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = y;
-									}
+									border_coords_x[y * mip_border_size + x] = -1;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_tile_size; ++ y)
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
+						}
+						switch (addr_v)
+						{
+						case TAM_Mirror:
+							for (uint32_t y = 0; y < mip_tile_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = y;
-									}
+									border_coords_y[y * mip_border_size + x] = y;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_tile_size; ++ y)
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_tile_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = -1;
-									}
+									border_coords_y[y * mip_border_size + x] = y;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
+							break;
 
+						case TAM_Border:
 							for (uint32_t y = 0; y < mip_tile_size; ++ y)
 							{
 								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									if ((border_coords_x[y * mip_border_size + x] >= 0) && (border_coords_y[y * mip_border_size + x] >= 0))
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
-											neighbor_data_ptr[0] + border_coords_y[y * mip_border_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_border_size + x]);
-									}
-									else
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
-									}
+									border_coords_y[y * mip_border_size + x] = -1;
 								}
 							}
+							break;
+
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
 						}
-						else
+
+						for (uint32_t y = 0; y < mip_tile_size; ++ y)
 						{
-							for (uint32_t y = 0; y < mip_tile_size; ++ y)
+							for (uint32_t x = 0; x < mip_border_size; ++ x)
 							{
-								for (uint32_t x = 0; x < mip_border_size; ++ x)
+								if ((border_coords_x[y * mip_border_size + x] >= 0) && (border_coords_y[y * mip_border_size + x] >= 0))
+								{
+									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
+										neighbor_data_ptr[0] + border_coords_y[y * mip_border_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_border_size + x]);
+								}
+								else
 								{
-									texel_op_.copy(data_with_border + (y + mip_border_size) * data_pitch + (x + mip_border_size + mip_tile_size) * texel_size_,
-										neighbor_data_ptr[0] + (y * mip_tile_size + mip_tile_size - 1) * texel_size_);
+									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
 								}
 							}
 						}
 					}
-
-					if ((neighbor_data_ptr[6] != nullptr) && in_same_image[i + 6])
+					else
 					{
-						for (uint32_t y = 0; y < mip_border_size; ++ y)
+						for (uint32_t y = 0; y < mip_tile_size; ++ y)
 						{
-							texel_op_.copy_array(data_with_border + (y + mip_border_size + mip_tile_size) * data_pitch,
-								neighbor_data_ptr[6] + (y * mip_tile_size + (mip_tile_size - mip_border_size)) * texel_size_, mip_border_size);
+							for (uint32_t x = 0; x < mip_border_size; ++ x)
+							{
+								texel_op_.copy(data_with_border + (y + mip_border_size) * data_pitch + (x + mip_border_size + mip_tile_size) * texel_size_,
+									neighbor_data_ptr[0] + (y * mip_tile_size + mip_tile_size - 1) * texel_size_);
+							}
 						}
 					}
-					else
+				}
+
+				if ((neighbor_data_ptr[6] != nullptr) && new_in_same_image[6])
+				{
+					for (uint32_t y = 0; y < mip_border_size; ++ y)
+					{
+						texel_op_.copy_array(data_with_border + (y + mip_border_size + mip_tile_size) * data_pitch,
+							neighbor_data_ptr[6] + (y * mip_tile_size + (mip_tile_size - mip_border_size)) * texel_size_, mip_border_size);
+					}
+				}
+				else
+				{
+					if (attr != 0xFFFFFFFF)
 					{
-						if (tile_info.attr != 0xFFFFFFFF)
+						std::vector<int32_t> border_coords_x(mip_border_size * mip_border_size);
+						std::vector<int32_t> border_coords_y(mip_border_size * mip_border_size);
+						switch (addr_u)
 						{
-							std::vector<int32_t> border_coords_x(mip_border_size * mip_border_size);
-							std::vector<int32_t> border_coords_y(mip_border_size * mip_border_size);
-							switch (addr_u)
+						case TAM_Mirror:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
-								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = mip_border_size - 1 - x;
-									}
-								}
-								break;
-
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = 0;
-									}
+									border_coords_x[y * mip_border_size + x] = mip_border_size - 1 - x;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = -1;
-									}
+									border_coords_x[y * mip_border_size + x] = 0;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
-							switch (addr_v)
+							break;
+
+						case TAM_Border:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = mip_tile_size - 1 - y;
-									}
+									border_coords_x[y * mip_border_size + x] = -1;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
+						}
+						switch (addr_v)
+						{
+						case TAM_Mirror:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = mip_tile_size - 1;
-									}
+									border_coords_y[y * mip_border_size + x] = mip_tile_size - 1 - y;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = -1;
-									}
+									border_coords_y[y * mip_border_size + x] = mip_tile_size - 1;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
+							break;
 
+						case TAM_Border:
 							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
 								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									if ((border_coords_x[y * mip_border_size + x] >= 0) && (border_coords_y[y * mip_border_size + x] >= 0))
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
-											neighbor_data_ptr[0] + border_coords_y[y * mip_border_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_border_size + x]);
-									}
-									else
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
-									}
+									border_coords_y[y * mip_border_size + x] = -1;
 								}
 							}
+							break;
+
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
 						}
-						else
+
+						for (uint32_t y = 0; y < mip_border_size; ++ y)
 						{
-							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							for (uint32_t x = 0; x < mip_border_size; ++ x)
 							{
-								for (uint32_t x = 0; x < mip_border_size; ++ x)
+								if ((border_coords_x[y * mip_border_size + x] >= 0) && (border_coords_y[y * mip_border_size + x] >= 0))
+								{
+									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
+										neighbor_data_ptr[0] + border_coords_y[y * mip_border_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_border_size + x]);
+								}
+								else
 								{
-									texel_op_.copy(data_with_border + (y + mip_border_size + mip_tile_size) * data_pitch + x * texel_size_,
-										neighbor_data_ptr[0] + (mip_tile_size - 1) * mip_tile_size * texel_size_);
+									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
 								}
 							}
 						}
 					}
-					if ((neighbor_data_ptr[7] != nullptr) && in_same_image[i + 7])
+					else
 					{
 						for (uint32_t y = 0; y < mip_border_size; ++ y)
 						{
-							texel_op_.copy_array(data_with_border + (y + mip_border_size + mip_tile_size) * data_pitch + mip_border_size * texel_size_,
-								neighbor_data_ptr[7] + y * mip_tile_size * texel_size_, mip_tile_size);
+							for (uint32_t x = 0; x < mip_border_size; ++ x)
+							{
+								texel_op_.copy(data_with_border + (y + mip_border_size + mip_tile_size) * data_pitch + x * texel_size_,
+									neighbor_data_ptr[0] + (mip_tile_size - 1) * mip_tile_size * texel_size_);
+							}
 						}
 					}
-					else
+				}
+				if ((neighbor_data_ptr[7] != nullptr) && new_in_same_image[7])
+				{
+					for (uint32_t y = 0; y < mip_border_size; ++ y)
 					{
-						if (tile_info.attr != 0xFFFFFFFF)
+						texel_op_.copy_array(data_with_border + (y + mip_border_size + mip_tile_size) * data_pitch + mip_border_size * texel_size_,
+							neighbor_data_ptr[7] + y * mip_tile_size * texel_size_, mip_tile_size);
+					}
+				}
+				else
+				{
+					if (attr != 0xFFFFFFFF)
+					{
+						std::vector<int32_t> border_coords_x(mip_tile_size * mip_border_size);
+						std::vector<int32_t> border_coords_y(mip_tile_size * mip_border_size);
+						switch (addr_u)
 						{
-							std::vector<int32_t> border_coords_x(mip_tile_size * mip_border_size);
-							std::vector<int32_t> border_coords_y(mip_tile_size * mip_border_size);
-							switch (addr_u)
+						case TAM_Mirror:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
-								{
-									for (uint32_t x = 0; x < mip_tile_size; ++ x)
-									{
-										border_coords_x[y * mip_tile_size + x] = x;
-									}
-								}
-								break;
-
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+								for (uint32_t x = 0; x < mip_tile_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_tile_size; ++ x)
-									{
-										border_coords_x[y * mip_tile_size + x] = x;
-									}
+									border_coords_x[y * mip_tile_size + x] = x;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_tile_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_tile_size; ++ x)
-									{
-										border_coords_x[y * mip_tile_size + x] = -1;
-									}
+									border_coords_x[y * mip_tile_size + x] = x;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
-							switch (addr_v)
+							break;
+
+						case TAM_Border:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+								for (uint32_t x = 0; x < mip_tile_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_tile_size; ++ x)
-									{
-										border_coords_y[y * mip_tile_size + x] = mip_tile_size - 1 - y;
-									}
+									border_coords_x[y * mip_tile_size + x] = -1;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
+						}
+						switch (addr_v)
+						{
+						case TAM_Mirror:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_tile_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_tile_size; ++ x)
-									{
-										border_coords_y[y * mip_tile_size + x] = mip_tile_size - 1;
-									}
+									border_coords_y[y * mip_tile_size + x] = mip_tile_size - 1 - y;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_tile_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_tile_size; ++ x)
-									{
-										border_coords_y[y * mip_tile_size + x] = -1;
-									}
+									border_coords_y[y * mip_tile_size + x] = mip_tile_size - 1;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
+							break;
 
+						case TAM_Border:
 							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
 								for (uint32_t x = 0; x < mip_tile_size; ++ x)
 								{
-									if ((border_coords_x[y * mip_tile_size + x] >= 0) && (border_coords_y[y * mip_tile_size + x] >= 0))
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
-											neighbor_data_ptr[0] + border_coords_y[y * mip_tile_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_tile_size + x]);
-									}
-									else
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
-									}
+									border_coords_y[y * mip_tile_size + x] = -1;
 								}
 							}
+							break;
+
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
 						}
-						else
+
+						for (uint32_t y = 0; y < mip_border_size; ++ y)
 						{
-							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							for (uint32_t x = 0; x < mip_tile_size; ++ x)
 							{
-								texel_op_.copy_array(data_with_border + (y + mip_border_size + mip_tile_size) * data_pitch + mip_border_size * texel_size_,
-									neighbor_data_ptr[0] + (mip_tile_size - 1) * mip_tile_size * texel_size_, mip_tile_size);
+								if ((border_coords_x[y * mip_tile_size + x] >= 0) && (border_coords_y[y * mip_tile_size + x] >= 0))
+								{
+									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
+										neighbor_data_ptr[0] + border_coords_y[y * mip_tile_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_tile_size + x]);
+								}
+								else
+								{
+									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
+								}
 							}
 						}
-					}			
-					if ((neighbor_data_ptr[8] != nullptr) && in_same_image[i + 8])
+					}
+					else
 					{
 						for (uint32_t y = 0; y < mip_border_size; ++ y)
 						{
-							texel_op_.copy_array(data_with_border + (y + mip_border_size + mip_tile_size) * data_pitch + (mip_border_size + mip_tile_size) * texel_size_,
-								neighbor_data_ptr[8] + y * mip_tile_size * texel_size_, mip_border_size);
+							texel_op_.copy_array(data_with_border + (y + mip_border_size + mip_tile_size) * data_pitch + mip_border_size * texel_size_,
+								neighbor_data_ptr[0] + (mip_tile_size - 1) * mip_tile_size * texel_size_, mip_tile_size);
 						}
 					}
-					else
+				}			
+				if ((neighbor_data_ptr[8] != nullptr) && new_in_same_image[8])
+				{
+					for (uint32_t y = 0; y < mip_border_size; ++ y)
+					{
+						texel_op_.copy_array(data_with_border + (y + mip_border_size + mip_tile_size) * data_pitch + (mip_border_size + mip_tile_size) * texel_size_,
+							neighbor_data_ptr[8] + y * mip_tile_size * texel_size_, mip_border_size);
+					}
+				}
+				else
+				{
+					if (attr != 0xFFFFFFFF)
 					{
-						if (tile_info.attr != 0xFFFFFFFF)
+						std::vector<int32_t> border_coords_x(mip_border_size * mip_border_size);
+						std::vector<int32_t> border_coords_y(mip_border_size * mip_border_size);
+						switch (addr_u)
 						{
-							std::vector<int32_t> border_coords_x(mip_border_size * mip_border_size);
-							std::vector<int32_t> border_coords_y(mip_border_size * mip_border_size);
-							switch (addr_u)
+						case TAM_Mirror:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
-								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = mip_tile_size - 1 - x;
-									}
-								}
-								break;
-
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = mip_tile_size - 1;
-									}
+									border_coords_x[y * mip_border_size + x] = mip_tile_size - 1 - x;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_x[y * mip_border_size + x] = -1;
-									}
+									border_coords_x[y * mip_border_size + x] = mip_tile_size - 1;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
-							switch (addr_v)
+							break;
+
+						case TAM_Border:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
-							case TAM_Mirror:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = mip_tile_size - 1 - y;
-									}
+									border_coords_x[y * mip_border_size + x] = -1;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Clamp:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
+						}
+						switch (addr_v)
+						{
+						case TAM_Mirror:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = mip_tile_size - 1;
-									}
+									border_coords_y[y * mip_border_size + x] = mip_tile_size - 1 - y;
 								}
-								break;
+							}
+							break;
 
-							case TAM_Border:
-								for (uint32_t y = 0; y < mip_border_size; ++ y)
+						case TAM_Clamp:
+							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							{
+								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_border_size; ++ x)
-									{
-										border_coords_y[y * mip_border_size + x] = -1;
-									}
+									border_coords_y[y * mip_border_size + x] = mip_tile_size - 1;
 								}
-								break;
-
-							default:
-								KFL_UNREACHABLE("Invalid texture addressing mode");
 							}
+							break;
 
+						case TAM_Border:
 							for (uint32_t y = 0; y < mip_border_size; ++ y)
 							{
 								for (uint32_t x = 0; x < mip_border_size; ++ x)
 								{
-									if ((border_coords_x[y * mip_border_size + x] >= 0) && (border_coords_y[y * mip_border_size + x] >= 0))
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
-											neighbor_data_ptr[0] + border_coords_y[y * mip_border_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_border_size + x]);
-									}
-									else
-									{
-										texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
-									}
+									border_coords_y[y * mip_border_size + x] = -1;
 								}
 							}
+							break;
+
+						default:
+							KFL_UNREACHABLE("Invalid texture addressing mode");
 						}
-						else
+
+						for (uint32_t y = 0; y < mip_border_size; ++ y)
 						{
-							for (uint32_t y = 0; y < mip_border_size; ++ y)
+							for (uint32_t x = 0; x < mip_border_size; ++ x)
 							{
-								for (uint32_t x = 0; x < mip_border_size; ++ x)
+								if ((border_coords_x[y * mip_border_size + x] >= 0) && (border_coords_y[y * mip_border_size + x] >= 0))
+								{
+									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_,
+										neighbor_data_ptr[0] + border_coords_y[y * mip_border_size + x] * mip_tile_with_border_size + border_coords_x[y * mip_border_size + x]);
+								}
+								else
 								{
-									texel_op_.copy(data_with_border + (y + mip_border_size + mip_tile_size) * data_pitch + (x + mip_border_size + mip_tile_size) * texel_size_,
-										neighbor_data_ptr[0] + (mip_tile_size - 1) * mip_tile_size * texel_size_);
+									texel_op_.copy(data_with_border + y * data_pitch + x * texel_size_, border_clr);
 								}
 							}
 						}
 					}
+					else
+					{
+						for (uint32_t y = 0; y < mip_border_size; ++ y)
+						{
+							for (uint32_t x = 0; x < mip_border_size; ++ x)
+							{
+								texel_op_.copy(data_with_border + (y + mip_border_size + mip_tile_size) * data_pitch + (x + mip_border_size + mip_tile_size) * texel_size_,
+									neighbor_data_ptr[0] + (mip_tile_size - 1) * mip_tile_size * texel_size_);
+							}
+						}
+					}
 				}
+			}
 
-				ElementFormat format;
-				if (tex_cache_)
-				{
-					format = tex_cache_->Format();
-				}
-				else
-				{
-					format = tex_cache_array_[tile_info.z]->Format();
-				}
-
-				TexturePtr target_tex;
-				uint32_t target_array_index;
-				if (tex_cache_)
-				{
-					target_tex = tex_cache_;
-					target_array_index = tile_info.z;
-				}
-				else
-				{
-					target_tex = tex_cache_array_[tile_info.z];
-					target_array_index = 0;
-				}
-
-				if (IsCompressedFormat(format))
+			if (codec)
+			{
+				uint32_t const block_width = codec->BlockWidth();
+				uint32_t const block_height = codec->BlockHeight();
+				uint32_t const block_bytes = NumFormatBytes(format) * 4;
+				uint32_t const bc_row_pitch = (mip_tile_with_border_size + block_width - 1) / block_width * block_bytes;
+				uint32_t const bc_slice_pitch = (mip_tile_with_border_size + block_height - 1) / block_height * bc_row_pitch;
+				std::vector<uint8_t> bc(bc_slice_pitch);
 				{
-					uint32_t const block_width = tex_codec_->BlockWidth();
-					uint32_t const block_height = tex_codec_->BlockHeight();
-					uint32_t const block_bytes = NumFormatBytes(format) * 4;
-					uint32_t const bc_row_pitch = (mip_tile_with_border_size + block_width - 1) / block_width * block_bytes;
-					uint32_t const bc_slice_pitch = (mip_tile_with_border_size + block_height - 1) / block_height * bc_row_pitch;
-					std::vector<uint8_t> bc(bc_slice_pitch);
+					uint8_t const * data_with_border = &tex_a_tile_data[0];
+					uint32_t const data_row_pitch = mip_tile_with_border_size * texel_size_;
+					uint32_t const data_slice_pitch = mip_tile_with_border_size
+						* mip_tile_with_border_size * texel_size_;
+
+					uint32_t const * p_argb;
+					uint32_t row_pitch;
+					uint32_t slice_pitch;
+					std::vector<uint32_t> argb_data;
+					switch (format_)
 					{
-						uint8_t const * data_with_border = &tex_a_tile_data[0];
-						uint32_t const data_row_pitch = mip_tile_with_border_size * texel_size_;
-						uint32_t const data_slice_pitch = mip_tile_with_border_size
-							* mip_tile_with_border_size * texel_size_;
-
-						uint32_t const * p_argb;
-						uint32_t row_pitch;
-						uint32_t slice_pitch;
-						std::vector<uint32_t> argb_data;
-						switch (format_)
+					case EF_R8:
 						{
-						case EF_R8:
+							argb_data.resize(mip_tile_with_border_size * mip_tile_with_border_size, 0);
+							for (uint32_t y = 0; y < mip_tile_with_border_size; ++ y)
 							{
-								argb_data.resize(mip_tile_with_border_size * mip_tile_with_border_size, 0);
-								for (uint32_t y = 0; y < mip_tile_with_border_size; ++ y)
+								for (uint32_t x = 0; x < mip_tile_with_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_tile_with_border_size; ++ x)
-									{
-										argb_data[y * mip_tile_with_border_size + x] = data_with_border[y * data_row_pitch + x] << 16;
-									}
+									argb_data[y * mip_tile_with_border_size + x] = data_with_border[y * data_row_pitch + x] << 16;
 								}
-								p_argb = &argb_data[0];
-								row_pitch = mip_tile_with_border_size * 4;
-								slice_pitch = mip_tile_with_border_size * row_pitch;
 							}
-							break;
+							p_argb = &argb_data[0];
+							row_pitch = mip_tile_with_border_size * 4;
+							slice_pitch = mip_tile_with_border_size * row_pitch;
+						}
+						break;
 
-						case EF_GR8:
+					case EF_GR8:
+						{
+							argb_data.resize(mip_tile_with_border_size * mip_tile_with_border_size, 0);
+							for (uint32_t y = 0; y < mip_tile_with_border_size; ++ y)
 							{
-								argb_data.resize(mip_tile_with_border_size * mip_tile_with_border_size, 0);
-								for (uint32_t y = 0; y < mip_tile_with_border_size; ++ y)
+								for (uint32_t x = 0; x < mip_tile_with_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_tile_with_border_size; ++ x)
-									{
-										argb_data[y * mip_tile_with_border_size + x] = (data_with_border[y * data_row_pitch + x * 2 + 0] << 16)
-											| (data_with_border[y * data_row_pitch + x * 2 + 1] << 8);
-									}
+									argb_data[y * mip_tile_with_border_size + x] = (data_with_border[y * data_row_pitch + x * 2 + 0] << 16)
+										| (data_with_border[y * data_row_pitch + x * 2 + 1] << 8);
 								}
-								p_argb = &argb_data[0];
-								row_pitch = mip_tile_with_border_size * 4;
-								slice_pitch = mip_tile_with_border_size * row_pitch;
 							}
-							break;
+							p_argb = &argb_data[0];
+							row_pitch = mip_tile_with_border_size * 4;
+							slice_pitch = mip_tile_with_border_size * row_pitch;
+						}
+						break;
 
-						case EF_ABGR8:
+					case EF_ABGR8:
+						{
+							argb_data.resize(mip_tile_with_border_size * mip_tile_with_border_size, 0);
+							for (uint32_t y = 0; y < mip_tile_with_border_size; ++ y)
 							{
-								argb_data.resize(mip_tile_with_border_size * mip_tile_with_border_size, 0);
-								for (uint32_t y = 0; y < mip_tile_with_border_size; ++ y)
+								for (uint32_t x = 0; x < mip_tile_with_border_size; ++ x)
 								{
-									for (uint32_t x = 0; x < mip_tile_with_border_size; ++ x)
-									{
-										argb_data[y * mip_tile_with_border_size + x] = (data_with_border[y * data_row_pitch + x * 4 + 0] << 16)
-											| (data_with_border[y * data_row_pitch + x * 4 + 1] << 8)
-											| (data_with_border[y * data_row_pitch + x * 4 + 2] << 0)
-											| (data_with_border[y * data_row_pitch + x * 4 + 3] << 24);
-									}
+									argb_data[y * mip_tile_with_border_size + x] = (data_with_border[y * data_row_pitch + x * 4 + 0] << 16)
+										| (data_with_border[y * data_row_pitch + x * 4 + 1] << 8)
+										| (data_with_border[y * data_row_pitch + x * 4 + 2] << 0)
+										| (data_with_border[y * data_row_pitch + x * 4 + 3] << 24);
 								}
-								p_argb = &argb_data[0];
-								row_pitch = mip_tile_with_border_size * 4;
-								slice_pitch = mip_tile_with_border_size * row_pitch;
 							}
-							break;
-
-						case EF_ARGB8:
-							p_argb = reinterpret_cast<uint32_t const *>(data_with_border);
-							row_pitch = data_row_pitch;
-							slice_pitch = data_slice_pitch;
-							break;
-
-						default:
-							KFL_UNREACHABLE("Not supported element format");
+							p_argb = &argb_data[0];
+							row_pitch = mip_tile_with_border_size * 4;
+							slice_pitch = mip_tile_with_border_size * row_pitch;
 						}
+						break;
+
+					case EF_ARGB8:
+						p_argb = reinterpret_cast<uint32_t const *>(data_with_border);
+						row_pitch = data_row_pitch;
+						slice_pitch = data_slice_pitch;
+						break;
 
-						tex_codec_->EncodeMem(mip_tile_with_border_size, mip_tile_with_border_size,
-							&bc[0], bc_row_pitch, bc_slice_pitch, p_argb, row_pitch, slice_pitch, TCM_Quality);
+					default:
+						KFL_UNREACHABLE("Not supported element format");
 					}
 
-					target_tex->UpdateSubresource2D(target_array_index, l,
-						tile_info.x * mip_tile_with_border_size, tile_info.y * mip_tile_with_border_size,
-						mip_tile_with_border_size, mip_tile_with_border_size,
-						&bc[0], bc_row_pitch);
-				}
-				else
-				{
-					target_tex->UpdateSubresource2D(target_array_index, l,
-						tile_info.x * mip_tile_with_border_size, tile_info.y * mip_tile_with_border_size,
-						mip_tile_with_border_size, mip_tile_with_border_size,
-						&tex_a_tile_data[0], mip_tile_with_border_size * texel_size_);
+					codec->EncodeMem(mip_tile_with_border_size, mip_tile_with_border_size,
+						&bc[0], bc_row_pitch, bc_slice_pitch, p_argb, row_pitch, slice_pitch, TCM_Quality);
 				}
 
-				mip_tile_size /= 2;
-				mip_tile_with_border_size /= 2;
-				mip_border_size /= 2;
+				tile.mip_data[l].swap(bc);
+				tile.mip_row_pitches[l] = bc_row_pitch;
 			}
-
-			uint8_t const a_tile_indirect[] =
+			else
 			{
-				static_cast<uint8_t>(tile_info.x),
-				static_cast<uint8_t>(tile_info.y),
-				static_cast<uint8_t>(tile_info.z),
-				0
-			};
-			uint32_t level, tile_x, tile_y;
-			this->DecodeTileID(level, tile_x, tile_y, all_neighbor_ids[i]);
-			tex_indirect_->UpdateSubresource2D(0, 0, tile_x, tile_y, 1, 1, a_tile_indirect, sizeof(a_tile_indirect));
+				tile.mip_data[l].swap(tex_a_tile_data);
+				tile.mip_row_pitches[l] = mip_tile_with_border_size * texel_size_;
+			}
 
-			tim.emplace(all_neighbor_ids[i], tile_info);
+			mip_tile_size /= 2;
+			mip_tile_with_border_size /= 2;
+			mip_border_size /= 2;
 		}
 	}
 }
@@ -24,6 +24,7 @@
 #include <KlayGE/Context.hpp>
 #include <KlayGE/RenderFactory.hpp>
 #include <KlayGE/Texture.hpp>
+#include <KlayGE/TextureStreaming.hpp>
 #include <KlayGE/RenderEffect.hpp>
 #include <KlayGE/ResLoader.hpp>
 #include <KlayGE/App3D.hpp>
@@ -33,8 +34,10 @@
 #include <KlayGE/Light.hpp>
 #include <KlayGE/RenderMaterial.hpp>
 #include <KFL/Hash.hpp>
+#include <KFL/Thread.hpp>
 
 #include <algorithm>
+#include <array>
 #include <fstream>
 #include <sstream>
 #include <cstring>
@@ -170,6 +173,14 @@ namespace
 			return false;
 		}
 
+		size_t Hash() const override
+		{
+			size_t seed = static_cast<size_t>(this->Type());
+			HashRange(seed, model_desc_.res_name.begin(), model_desc_.res_name.end());
+			HashCombine(seed, model_desc_.access_hint);
+			return seed;
+		}
+
 		void CopyDataFrom(ResLoadingDesc const & rhs) override
 		{
 			BOOST_ASSERT(this->Type() == rhs.Type());
@@ -236,7 +247,7 @@ namespace
 						joints[i] = rhs_skinned_model->GetJoint(i);
 					}
 					skinned_model->AssignJoints(joints.begin(), joints.end());
-					skinned_model->AttachKeyFrames(rhs_skinned_model->GetKeyFrames());
+					skinned_model->AttachKeyFrames(rhs_skinned_model->GetKeyFrames(), rhs_skinned_model->GetKeyFrameTracks());
 
 					skinned_model->NumFrames(rhs_skinned_model->NumFrames());
 					skinned_model->FrameRate(rhs_skinned_model->FrameRate());
@@ -381,6 +392,111 @@ namespace
 		ModelDesc model_desc_;
 		std::mutex main_thread_stage_mutex_;
 	};
+
+
+	// Four quaternions, one per lane. Plain float4 math, the compiler turns it into SIMD.
+	struct QuaternionSoA
+	{
+		float4 x;
+		float4 y;
+		float4 z;
+		float4 w;
+	};
+
+	QuaternionSoA GatherQuaternions(std::array<std::vector<float>, 4> const & comps, std::array<uint32_t, 4> const & indices)
+	{
+		QuaternionSoA ret;
+		for (size_t j = 0; j < 4; ++ j)
+		{
+			ret.x[j] = comps[0][indices[j]];
+			ret.y[j] = comps[1][indices[j]];
+			ret.z[j] = comps[2][indices[j]];
+			ret.w[j] = comps[3][indices[j]];
+		}
+		return ret;
+	}
+
+	QuaternionSoA GatherQuaternions(std::array<Quaternion const *, 4> const & quats)
+	{
+		QuaternionSoA ret;
+		for (size_t j = 0; j < 4; ++ j)
+		{
+			ret.x[j] = quats[j]->x();
+			ret.y[j] = quats[j]->y();
+			ret.z[j] = quats[j]->z();
+			ret.w[j] = quats[j]->w();
+		}
+		return ret;
+	}
+
+	// Lane j goes to out[j]
+	void ScatterQuaternions(QuaternionSoA const & q, float4 const & scale, float4* out, uint32_t num)
+	{
+		for (uint32_t j = 0; j < num; ++ j)
+		{
+			out[j] = float4(q.x[j], q.y[j], q.z[j], q.w[j]) * scale[j];
+		}
+	}
+
+	void ScatterQuaternions(QuaternionSoA const & q, Quaternion* out, uint32_t num)
+	{
+		for (uint32_t j = 0; j < num; ++ j)
+		{
+			out[j] = Quaternion(q.x[j], q.y[j], q.z[j], q.w[j]);
+		}
+	}
+
+	QuaternionSoA operator+(QuaternionSoA const & lhs, QuaternionSoA const & rhs)
+	{
+		return QuaternionSoA{ lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z, lhs.w + rhs.w };
+	}
+
+	QuaternionSoA operator-(QuaternionSoA const & lhs, QuaternionSoA const & rhs)
+	{
+		return QuaternionSoA{ lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z, lhs.w - rhs.w };
+	}
+
+	QuaternionSoA operator*(QuaternionSoA const & lhs, float4 const & rhs)
+	{
+		return QuaternionSoA{ lhs.x * rhs, lhs.y * rhs, lhs.z * rhs, lhs.w * rhs };
+	}
+
+	float4 Dot(QuaternionSoA const & lhs, QuaternionSoA const & rhs)
+	{
+		return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z + lhs.w * rhs.w;
+	}
+
+	// Same as MathLib::mul(lhs, rhs)
+	QuaternionSoA Mul(QuaternionSoA const & lhs, QuaternionSoA const & rhs)
+	{
+		QuaternionSoA ret;
+		ret.x = lhs.x * rhs.w - lhs.y * rhs.z + lhs.z * rhs.y + lhs.w * rhs.x;
+		ret.y = lhs.x * rhs.z + lhs.y * rhs.w - lhs.z * rhs.x + lhs.w * rhs.y;
+		ret.z = lhs.y * rhs.x - lhs.x * rhs.y + lhs.z * rhs.w + lhs.w * rhs.z;
+		ret.w = lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z;
+		return ret;
+	}
+
+	// 1 where x >= 0, -1 where x < 0
+	float4 SignNotZero(float4 const & x)
+	{
+		float4 ret;
+		for (size_t j = 0; j < 4; ++ j)
+		{
+			ret[j] = (x[j] < 0) ? -1.0f : 1.0f;
+		}
+		return ret;
+	}
+
+	float4 RecipSqrt(float4 const & x)
+	{
+		float4 ret;
+		for (size_t j = 0; j < 4; ++ j)
+		{
+			ret[j] = 1 / std::sqrt(x[j]);
+		}
+		return ret;
+	}
 }
 
 namespace KlayGE
@@ -531,13 +647,22 @@ namespace KlayGE
 
 		mtl_ = model->GetMaterial(this->MaterialID());
 
+		bool const streaming = TextureStreamingManager::Instance().Active();
 		for (size_t i = 0; i < RenderMaterial::TS_NumTextureSlots; ++ i)
 		{
 			if (!mtl_->tex_names[i].empty())
 			{
 				if (!ResLoader::Instance().Locate(mtl_->tex_names[i]).empty())
 				{
-					textures_[i] = ASyncLoadTexture(mtl_->tex_names[i], EAH_GPU_Read | EAH_Immutable);
+					if (streaming)
+					{
+						streamed_textures_[i] = ASyncLoadStreamedTexture(mtl_->tex_names[i], EAH_GPU_Read | EAH_Immutable);
+						textures_[i] = streamed_textures_[i]->ResidentTexture();
+					}
+					else
+					{
+						textures_[i] = ASyncLoadTexture(mtl_->tex_names[i], EAH_GPU_Read | EAH_Immutable);
+					}
 				}
 			}
 		}
@@ -672,43 +797,200 @@ namespace KlayGE
 	}
 
 
+	KeyFrameTracks::KeyFrameTracks(KeyFramesType const & kfs)
+	{
+		size_t num_keys = 0;
+		for (auto const & kf : kfs)
+		{
+			num_keys += kf.frame_id.size();
+		}
+
+		key_starts.resize(kfs.size() + 1);
+		frame_ids.reserve(num_keys);
+		for (size_t c = 0; c < 4; ++ c)
+		{
+			bind_reals[c].reserve(num_keys);
+			bind_duals[c].reserve(num_keys);
+		}
+		bind_scales.reserve(num_keys);
+
+		for (size_t i = 0; i < kfs.size(); ++ i)
+		{
+			KeyFrames const & kf = kfs[i];
+
+			key_starts[i] = static_cast<uint32_t>(frame_ids.size());
+			frame_ids.insert(frame_ids.end(), kf.frame_id.begin(), kf.frame_id.end());
+			for (size_t k = 0; k < kf.frame_id.size(); ++ k)
+			{
+				for (size_t c = 0; c < 4; ++ c)
+				{
+					bind_reals[c].push_back(kf.bind_real[k][c]);
+					bind_duals[c].push_back(kf.bind_dual[k][c]);
+				}
+			}
+			bind_scales.insert(bind_scales.end(), kf.bind_scale.begin(), kf.bind_scale.end());
+		}
+		key_starts.back() = static_cast<uint32_t>(frame_ids.size());
+	}
+
+
 	SkinnedModel::SkinnedModel(std::wstring const & name)
 		: RenderModel(name),
 			last_frame_(-1),
 			num_frames_(0), frame_rate_(0)
 	{
 	}
+
+	void SkinnedModel::AttachKeyFrames(std::shared_ptr<KeyFramesType> const & kf)
+	{
+		this->AttachKeyFrames(kf, kf ? MakeSharedPtr<KeyFrameTracks>(*kf) : std::shared_ptr<KeyFrameTracks>());
+	}
+
+	void SkinnedModel::AttachKeyFrames(std::shared_ptr<KeyFramesType> const & kf, std::shared_ptr<KeyFrameTracks> const & tracks)
+	{
+		key_frames_ = kf;
+		key_frame_tracks_ = tracks;
+
+		key_cursors_.clear();
+	}
+
+	void SkinnedModel::InterpolateKeyFrames(float frame)
+	{
+		// A forward step further than this is left to the binary search
+		uint32_t const MAX_CURSOR_STEPS = 4;
+
+		BOOST_ASSERT(key_frame_tracks_);
+		KeyFrameTracks const & tracks = *key_frame_tracks_;
+
+		uint32_t const num_joints = static_cast<uint32_t>(joints_.size());
+		BOOST_ASSERT(tracks.key_starts.size() == num_joints + 1);
+
+		key_cursors_.resize(num_joints, 0);
+		key_factors_.resize(num_joints);
+		local_reals_.resize(num_joints);
+		local_duals_.resize(num_joints);
+		local_scales_.resize(num_joints);
+
+		for (uint32_t i = 0; i < num_joints; ++ i)
+		{
+			uint32_t const num_keys = tracks.key_starts[i + 1] - tracks.key_starts[i];
+			if (num_keys == 1)
+			{
+				key_cursors_[i] = 0;
+				key_factors_[i] = 0;
+				continue;
+			}
+
+			uint32_t const * ids = &tracks.frame_ids[tracks.key_starts[i]];
+			float const f = std::fmod(frame, static_cast<float>(ids[num_keys - 1] + 1));
+
+			uint32_t cursor = key_cursors_[i];
+			if ((cursor < num_keys) && !(f < ids[cursor]))
+			{
+				uint32_t const last = std::min(cursor + MAX_CURSOR_STEPS, num_keys - 1);
+				while ((cursor < last) && !(f < ids[cursor + 1]))
+				{
+					++ cursor;
+				}
+			}
+			else
+			{
+				cursor = num_keys;
+			}
+			if ((cursor == num_keys) || ((cursor + 1 < num_keys) && !(f < ids[cursor + 1])))
+			{
+				cursor = static_cast<uint32_t>(std::upper_bound(ids, ids + num_keys, f) - ids);
+				cursor = (cursor > 0) ? cursor - 1 : 0;
+			}
+			key_cursors_[i] = cursor;
+
+			int const frame0 = ids[cursor];
+			int const frame1 = ids[(cursor + 1) % num_keys];
+			key_factors_[i] = (f - frame0) / (frame1 - frame0);
+		}
+
+		// Dual quaternion linear blending of 4 joints at a time. Adjacent keys are close, so it's indistinguishable from
+		//  sclerp, at a fraction of the cost.
+		for (uint32_t i = 0; i < num_joints; i += 4)
+		{
+			uint32_t const num = std::min(num_joints - i, 4U);
+
+			std::array<uint32_t, 4> keys0;
+			std::array<uint32_t, 4> keys1;
+			float4 t;
+			for (uint32_t j = 0; j < 4; ++ j)
+			{
+				uint32_t const joint = i + std::min(j, num - 1);
+				uint32_t const start = tracks.key_starts[joint];
+				uint32_t const num_keys = tracks.key_starts[joint + 1] - start;
+				keys0[j] = start + key_cursors_[joint];
+				keys1[j] = start + (key_cursors_[joint] + 1) % num_keys;
+				t[j] = key_factors_[joint];
+			}
+
+			QuaternionSoA const real0 = GatherQuaternions(tracks.bind_reals, keys0);
+			QuaternionSoA const dual0 = GatherQuaternions(tracks.bind_duals, keys0);
+			QuaternionSoA const real1 = GatherQuaternions(tracks.bind_reals, keys1);
+			QuaternionSoA const dual1 = GatherQuaternions(tracks.bind_duals, keys1);
+			float4 const scale0(tracks.bind_scales[keys0[0]], tracks.bind_scales[keys0[1]],
+				tracks.bind_scales[keys0[2]], tracks.bind_scales[keys0[3]]);
+			float4 const scale1(tracks.bind_scales[keys1[0]], tracks.bind_scales[keys1[1]],
+				tracks.bind_scales[keys1[2]], tracks.bind_scales[keys1[3]]);
+
+			float4 const w0 = float4(1, 1, 1, 1) - t;
+			// Takes the shortest path
+			float4 const w1 = t * SignNotZero(Dot(real0, real1));
+
+			QuaternionSoA real = real0 * w0 + real1 * w1;
+			QuaternionSoA dual = dual0 * w0 + dual1 * w1;
+			float4 const inv_len = RecipSqrt(Dot(real, real));
+			real = real * inv_len;
+			dual = dual * inv_len;
+			dual = dual - real * Dot(real, dual);
+
+			ScatterQuaternions(real, &local_reals_[i], num);
+			ScatterQuaternions(dual, &local_duals_[i], num);
+			float4 const scale = scale0 + (scale1 - scale0) * t;
+			for (uint32_t j = 0; j < num; ++ j)
+			{
+				local_scales_[i + j] = scale[j];
+			}
+		}
+	}
 	
 	void SkinnedModel::BuildBones(float frame)
 	{
+		this->InterpolateKeyFrames(frame);
+
 		for (size_t i = 0; i < joints_.size(); ++ i)
 		{
 			Joint& joint = joints_[i];
-			KeyFrames const & kf = (*key_frames_)[i];
 
-			std::pair<std::pair<Quaternion, Quaternion>, float> key_dq = kf.Frame(frame);
+			Quaternion key_real = local_reals_[i];
+			Quaternion key_dual = local_duals_[i];
+			float const key_scale = local_scales_[i];
 
 			if (joint.parent != -1)
 			{
 				Joint const & parent(joints_[joint.parent]);
 
-				if (MathLib::dot(key_dq.first.first, parent.bind_real) < 0)
+				if (MathLib::dot(key_real, parent.bind_real) < 0)
 				{
-					key_dq.first.first = -key_dq.first.first;
-					key_dq.first.second = -key_dq.first.second;
+					key_real = -key_real;
+					key_dual = -key_dual;
 				}
 
-				if ((MathLib::SignBit(key_dq.second) > 0) && (MathLib::SignBit(parent.bind_scale) > 0))
+				if ((MathLib::SignBit(key_scale) > 0) && (MathLib::SignBit(parent.bind_scale) > 0))
 				{
-					joint.bind_real = MathLib::mul_real(key_dq.first.first, parent.bind_real);
-					joint.bind_dual = MathLib::mul_dual(key_dq.first.first, key_dq.first.second * parent.bind_scale, parent.bind_real, parent.bind_dual);
-					joint.bind_scale = key_dq.second * parent.bind_scale;
+					joint.bind_real = MathLib::mul_real(key_real, parent.bind_real);
+					joint.bind_dual = MathLib::mul_dual(key_real, key_dual * parent.bind_scale, parent.bind_real, parent.bind_dual);
+					joint.bind_scale = key_scale * parent.bind_scale;
 				}
 				else
 				{
-					float4x4 tmp_mat = MathLib::scaling(MathLib::abs(key_dq.second), MathLib::abs(key_dq.second), key_dq.second)
-						* MathLib::to_matrix(key_dq.first.first)
-						* MathLib::translation(MathLib::udq_to_trans(key_dq.first.first, key_dq.first.second))
+					float4x4 tmp_mat = MathLib::scaling(MathLib::abs(key_scale), MathLib::abs(key_scale), key_scale)
+						* MathLib::to_matrix(key_real)
+						* MathLib::translation(MathLib::udq_to_trans(key_real, key_dual))
 						* MathLib::scaling(MathLib::abs(parent.bind_scale), MathLib::abs(parent.bind_scale), parent.bind_scale)
 						* MathLib::to_matrix(parent.bind_real)
 						* MathLib::translation(MathLib::udq_to_trans(parent.bind_real, parent.bind_dual));
@@ -737,9 +1019,9 @@ namespace KlayGE
 			}
 			else
 			{
-				joint.bind_real = key_dq.first.first;
-				joint.bind_dual = key_dq.first.second;
-				joint.bind_scale = key_dq.second;
+				joint.bind_real = key_real;
+				joint.bind_dual = key_dual;
+				joint.bind_scale = key_scale;
 			}
 		}
 
@@ -748,67 +1030,109 @@ namespace KlayGE
 
 	void SkinnedModel::UpdateBinds()
 	{
-		bind_reals_.resize(joints_.size());
-		bind_duals_.resize(joints_.size());
-		for (size_t i = 0; i < joints_.size(); ++ i)
+		uint32_t const num_joints = static_cast<uint32_t>(joints_.size());
+
+		bind_reals_.resize(num_joints);
+		bind_duals_.resize(num_joints);
+		for (uint32_t i = 0; i < num_joints; i += 4)
 		{
-			Joint const & joint = joints_[i];
+			uint32_t const num = std::min(num_joints - i, 4U);
 
-			Quaternion bind_real, bind_dual;
-			float bind_scale;
-			if ((MathLib::SignBit(joint.inverse_origin_scale) > 0) && (MathLib::SignBit(joint.bind_scale) > 0))
+			std::array<Quaternion const *, 4> io_reals;
+			std::array<Quaternion const *, 4> io_duals;
+			std::array<Quaternion const *, 4> reals;
+			std::array<Quaternion const *, 4> duals;
+			float4 io_scales;
+			float4 scales;
+			for (uint32_t j = 0; j < 4; ++ j)
 			{
-				bind_real = MathLib::mul_real(joint.inverse_origin_real, joint.bind_real);
-				bind_dual = MathLib::mul_dual(joint.inverse_origin_real, joint.inverse_origin_dual,
-					joint.bind_real, joint.bind_dual);
-				bind_scale = joint.inverse_origin_scale * joint.bind_scale;
+				Joint const & joint = joints_[i + std::min(j, num - 1)];
+				io_reals[j] = &joint.inverse_origin_real;
+				io_duals[j] = &joint.inverse_origin_dual;
+				reals[j] = &joint.bind_real;
+				duals[j] = &joint.bind_dual;
+				io_scales[j] = joint.inverse_origin_scale;
+				scales[j] = joint.bind_scale;
+			}
+
+			QuaternionSoA const io_real = GatherQuaternions(io_reals);
+			QuaternionSoA const bind_real = GatherQuaternions(reals);
+			QuaternionSoA real = Mul(io_real, bind_real);
+			QuaternionSoA dual = Mul(io_real, GatherQuaternions(duals)) + Mul(GatherQuaternions(io_duals), bind_real);
+			float4 const scale = io_scales * scales;
+
+			float4 const sign = SignNotZero(real.w);
+			ScatterQuaternions(real, sign * scale, &bind_reals_[i], num);
+			ScatterQuaternions(dual, sign, &bind_duals_[i], num);
 
-				if (MathLib::SignBit(bind_real.w()) < 0)
+			for (uint32_t j = 0; j < num; ++ j)
+			{
+				if ((MathLib::SignBit(io_scales[j]) < 0) || (MathLib::SignBit(scales[j]) < 0))
 				{
-					bind_real = -bind_real;
-					bind_dual = -bind_dual;
+					this->UpdateBind(i + j);
 				}
 			}
-			else
-			{
-				float4x4 tmp_mat = MathLib::scaling(MathLib::abs(joint.inverse_origin_scale), MathLib::abs(joint.inverse_origin_scale), joint.inverse_origin_scale)
-					* MathLib::to_matrix(joint.inverse_origin_real)
-					* MathLib::translation(MathLib::udq_to_trans(joint.inverse_origin_real, joint.inverse_origin_dual))
-					* MathLib::scaling(MathLib::abs(joint.bind_scale), MathLib::abs(joint.bind_scale), joint.bind_scale)
-					* MathLib::to_matrix(joint.bind_real)
-					* MathLib::translation(MathLib::udq_to_trans(joint.bind_real, joint.bind_dual));
-
-				float flip = 1;
-				if (MathLib::dot(MathLib::cross(float3(tmp_mat(0, 0), tmp_mat(0, 1), tmp_mat(0, 2)),
-					float3(tmp_mat(1, 0), tmp_mat(1, 1), tmp_mat(1, 2))),
-					float3(tmp_mat(2, 0), tmp_mat(2, 1), tmp_mat(2, 2))) < 0)
-				{
-					tmp_mat(2, 0) = -tmp_mat(2, 0);
-					tmp_mat(2, 1) = -tmp_mat(2, 1);
-					tmp_mat(2, 2) = -tmp_mat(2, 2);
+		}
+	}
 
-					flip = -1;
-				}
+	void SkinnedModel::UpdateBind(uint32_t index)
+	{
+		Joint const & joint = joints_[index];
 
-				float3 scale;
-				Quaternion rot;
-				float3 trans;
-				MathLib::decompose(scale, rot, trans, tmp_mat);
+		Quaternion bind_real, bind_dual;
+		float bind_scale;
+		if ((MathLib::SignBit(joint.inverse_origin_scale) > 0) && (MathLib::SignBit(joint.bind_scale) > 0))
+		{
+			bind_real = MathLib::mul_real(joint.inverse_origin_real, joint.bind_real);
+			bind_dual = MathLib::mul_dual(joint.inverse_origin_real, joint.inverse_origin_dual,
+				joint.bind_real, joint.bind_dual);
+			bind_scale = joint.inverse_origin_scale * joint.bind_scale;
 
-				bind_real = rot;
-				bind_dual = MathLib::quat_trans_to_udq(rot, trans);
-				bind_scale = scale.x();
+			if (MathLib::SignBit(bind_real.w()) < 0)
+			{
+				bind_real = -bind_real;
+				bind_dual = -bind_dual;
+			}
+		}
+		else
+		{
+			float4x4 tmp_mat = MathLib::scaling(MathLib::abs(joint.inverse_origin_scale), MathLib::abs(joint.inverse_origin_scale), joint.inverse_origin_scale)
+				* MathLib::to_matrix(joint.inverse_origin_real)
+				* MathLib::translation(MathLib::udq_to_trans(joint.inverse_origin_real, joint.inverse_origin_dual))
+				* MathLib::scaling(MathLib::abs(joint.bind_scale), MathLib::abs(joint.bind_scale), joint.bind_scale)
+				* MathLib::to_matrix(joint.bind_real)
+				* MathLib::translation(MathLib::udq_to_trans(joint.bind_real, joint.bind_dual));
+
+			float flip = 1;
+			if (MathLib::dot(MathLib::cross(float3(tmp_mat(0, 0), tmp_mat(0, 1), tmp_mat(0, 2)),
+				float3(tmp_mat(1, 0), tmp_mat(1, 1), tmp_mat(1, 2))),
+				float3(tmp_mat(2, 0), tmp_mat(2, 1), tmp_mat(2, 2))) < 0)
+			{
+				tmp_mat(2, 0) = -tmp_mat(2, 0);
+				tmp_mat(2, 1) = -tmp_mat(2, 1);
+				tmp_mat(2, 2) = -tmp_mat(2, 2);
 
-				if (flip * MathLib::SignBit(bind_real.w()) < 0)
-				{
-					bind_real = -bind_real;
-					bind_dual = -bind_dual;
-				}
+				flip = -1;
 			}
 
-			bind_reals_[i] = float4(bind_real.x(), bind_real.y(), bind_real.z(), bind_real.w()) * bind_scale;
-			bind_duals_[i] = float4(bind_dual.x(), bind_dual.y(), bind_dual.z(), bind_dual.w());
+			float3 scale;
+			Quaternion rot;
+			float3 trans;
+			MathLib::decompose(scale, rot, trans, tmp_mat);
+
+			bind_real = rot;
+			bind_dual = MathLib::quat_trans_to_udq(rot, trans);
+			bind_scale = scale.x();
+
+			if (flip * MathLib::SignBit(bind_real.w()) < 0)
+			{
+				bind_real = -bind_real;
+				bind_dual = -bind_dual;
+			}
 		}
+
+		bind_reals_[index] = float4(bind_real.x(), bind_real.y(), bind_real.z(), bind_real.w()) * bind_scale;
+		bind_duals_[index] = float4(bind_dual.x(), bind_dual.y(), bind_dual.z(), bind_dual.w());
 	}
 
 	float SkinnedModel::GetFrame() const
@@ -826,6 +1150,20 @@ namespace KlayGE
 		}
 	}
 
+	void SkinnedModel::SetFrames(ArrayRef<SkinnedModel*> models, ArrayRef<float> frames)
+	{
+		BOOST_ASSERT(models.size() == frames.size());
+
+		Context::Instance().TaskScheduler().parallel_for(0, static_cast<uint32_t>(models.size()), 0,
+			[&models, &frames](uint32_t first, uint32_t last)
+			{
+				for (uint32_t i = first; i < last; ++ i)
+				{
+					models[i]->SetFrame(frames[i]);
+				}
+			});
+	}
+
 	void SkinnedModel::RebindJoints()
 	{
 		this->BuildBones(last_frame_);
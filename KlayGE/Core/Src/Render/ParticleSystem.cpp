@@ -41,7 +41,11 @@
 #include <KFL/XMLDom.hpp>
 #include <KlayGE/DeferredRenderingLayer.hpp>
 #include <KFL/Hash.hpp>
+#include <KFL/RadixSort.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <fstream>
 
 #if defined(KLAYGE_COMPILER_GCC)
@@ -79,15 +83,19 @@ namespace
 				Color particle_color_from;
 				Color particle_color_to;
 
-				std::string emitter_type;
-				float frequency;
-				float angle;
-				float3 min_pos;
-				float3 max_pos;
-				float min_vel;
-				float max_vel;
-				float min_life;
-				float max_life;
+				struct EmitterData
+				{
+					std::string type;
+					float frequency;
+					float angle;
+					float3 min_pos;
+					float3 max_pos;
+					float min_vel;
+					float max_vel;
+					float min_life;
+					float max_life;
+				};
+				std::vector<EmitterData> emitters;
 
 				std::string updater_type;
 				std::vector<KlayGE::float2> size_over_life_ctrl_pts;
@@ -189,31 +197,33 @@ namespace
 				}
 			}
 
+			for (XMLNodePtr emitter_node = root->FirstNode("emitter"); emitter_node; emitter_node = emitter_node->NextSibling("emitter"))
 			{
-				XMLNodePtr emitter_node = root->FirstNode("emitter");
+				ps_desc_.ps_data->emitters.emplace_back();
+				auto& emitter_data = ps_desc_.ps_data->emitters.back();
 
 				XMLAttributePtr type_attr = emitter_node->Attrib("type");
 				if (type_attr)
 				{
-					ps_desc_.ps_data->emitter_type = type_attr->ValueString();
+					emitter_data.type = type_attr->ValueString();
 				}
 				else
 				{
-					ps_desc_.ps_data->emitter_type = "point";
+					emitter_data.type = "point";
 				}
 
 				XMLNodePtr freq_node = emitter_node->FirstNode("frequency");
 				if (freq_node)
 				{
 					XMLAttributePtr attr = freq_node->Attrib("value");
-					ps_desc_.ps_data->frequency = attr->ValueFloat();
+					emitter_data.frequency = attr->ValueFloat();
 				}
 
 				XMLNodePtr angle_node = emitter_node->FirstNode("angle");
 				if (angle_node)
 				{
 					XMLAttributePtr attr = angle_node->Attrib("value");
-					ps_desc_.ps_data->angle = attr->ValueInt() * DEG2RAD;
+					emitter_data.angle = attr->ValueInt() * DEG2RAD;
 				}
 
 				XMLNodePtr pos_node = emitter_node->FirstNode("pos");
@@ -238,7 +248,7 @@ namespace
 							}
 						}
 					}
-					ps_desc_.ps_data->min_pos = min_pos;
+					emitter_data.min_pos = min_pos;
 			
 					float3 max_pos(0, 0, 0);
 					attr = pos_node->Attrib("max");
@@ -259,27 +269,27 @@ namespace
 							}
 						}
 					}			
-					ps_desc_.ps_data->max_pos = max_pos;
+					emitter_data.max_pos = max_pos;
 				}
 
 				XMLNodePtr vel_node = emitter_node->FirstNode("vel");
 				if (vel_node)
 				{
 					XMLAttributePtr attr = vel_node->Attrib("min");
-					ps_desc_.ps_data->min_vel = attr->ValueFloat();
+					emitter_data.min_vel = attr->ValueFloat();
 
 					attr = vel_node->Attrib("max");
-					ps_desc_.ps_data->max_vel = attr->ValueFloat();
+					emitter_data.max_vel = attr->ValueFloat();
 				}
 
 				XMLNodePtr life_node = emitter_node->FirstNode("life");
 				if (life_node)
 				{
 					XMLAttributePtr attr = life_node->Attrib("min");
-					ps_desc_.ps_data->min_life = attr->ValueFloat();
+					emitter_data.min_life = attr->ValueFloat();
 
 					attr = life_node->Attrib("max");
-					ps_desc_.ps_data->max_life = attr->ValueFloat();
+					emitter_data.max_life = attr->ValueFloat();
 				}
 			}
 
@@ -356,6 +366,13 @@ namespace
 			return false;
 		}
 
+		size_t Hash() const override
+		{
+			size_t seed = static_cast<size_t>(this->Type());
+			HashRange(seed, ps_desc_.res_name.begin(), ps_desc_.res_name.end());
+			return seed;
+		}
+
 		void CopyDataFrom(ResLoadingDesc const & rhs) override
 		{
 			BOOST_ASSERT(this->Type() == rhs.Type());
@@ -389,17 +406,20 @@ namespace
 				ps->ParticleColorFrom(ps_desc_.ps_data->particle_color_from);
 				ps->ParticleColorTo(ps_desc_.ps_data->particle_color_to);
 
-				ParticleEmitterPtr emitter = ps->MakeEmitter(ps_desc_.ps_data->emitter_type);
-				ps->AddEmitter(emitter);
-
-				emitter->Frequency(ps_desc_.ps_data->frequency);
-				emitter->EmitAngle(ps_desc_.ps_data->angle);
-				emitter->MinPosition(ps_desc_.ps_data->min_pos);
-				emitter->MaxPosition(ps_desc_.ps_data->max_pos);
-				emitter->MinVelocity(ps_desc_.ps_data->min_vel);
-				emitter->MaxVelocity(ps_desc_.ps_data->max_vel);
-				emitter->MinLife(ps_desc_.ps_data->min_life);
-				emitter->MaxLife(ps_desc_.ps_data->max_life);
+				for (auto const & emitter_data : ps_desc_.ps_data->emitters)
+				{
+					ParticleEmitterPtr emitter = ps->MakeEmitter(emitter_data.type);
+					ps->AddEmitter(emitter);
+
+					emitter->Frequency(emitter_data.frequency);
+					emitter->EmitAngle(emitter_data.angle);
+					emitter->MinPosition(emitter_data.min_pos);
+					emitter->MaxPosition(emitter_data.max_pos);
+					emitter->MinVelocity(emitter_data.min_vel);
+					emitter->MaxVelocity(emitter_data.max_vel);
+					emitter->MinLife(emitter_data.min_life);
+					emitter->MaxLife(emitter_data.max_life);
+				}
 
 				ParticleUpdaterPtr updater = ps->MakeUpdater(ps_desc_.ps_data->updater_type);
 				ps->AddUpdater(updater);
@@ -550,18 +570,118 @@ namespace
 		using RenderableHelper::PosBound;
 	};
 
-	class ParticleCmp
+	// Particles are updated in groups of 4, one per float4 lane. A task takes this many groups.
+	uint32_t const GROUPS_PER_TASK = 256;
+
+	// Lanes past num are left 0. They are computed on, but never stored.
+	float4 LoadLanes(float const * src, uint32_t num)
 	{
-	public:
-		bool operator()(std::pair<uint32_t, float> const & lhs, std::pair<uint32_t, float> const & rhs) const
+		float4 ret;
+		if (4 == num)
 		{
-			return lhs.second > rhs.second;
+			memcpy(&ret, src, sizeof(ret));
 		}
-	};
+		else
+		{
+			ret = float4(0, 0, 0, 0);
+			for (uint32_t j = 0; j < num; ++ j)
+			{
+				ret[j] = src[j];
+			}
+		}
+		return ret;
+	}
+
+	void StoreLanes(float* dst, float4 const & v, uint32_t num)
+	{
+		if (4 == num)
+		{
+			memcpy(dst, &v, sizeof(v));
+		}
+		else
+		{
+			for (uint32_t j = 0; j < num; ++ j)
+			{
+				dst[j] = v[j];
+			}
+		}
+	}
+
+	float EvalPolyline(std::vector<float2> const & ctrl_pts, float pos)
+	{
+		float ret = ctrl_pts.back().y();
+		for (auto iter = ctrl_pts.begin(); iter != ctrl_pts.end() - 1; ++ iter)
+		{
+			if ((iter + 1)->x() >= pos)
+			{
+				float const s = (pos - iter->x()) / ((iter + 1)->x() - iter->x());
+				ret = MathLib::lerp(iter->y(), (iter + 1)->y(), s);
+				break;
+			}
+		}
+		return ret;
+	}
 }
 
 namespace KlayGE
 {
+	ParticleSoA::ParticleSoA(uint32_t capacity)
+		: num(0),
+			pos_x(capacity), pos_y(capacity), pos_z(capacity),
+			vel_x(capacity), vel_y(capacity), vel_z(capacity),
+			life(capacity), spin(capacity), size(capacity), alpha(capacity), init_life(capacity)
+	{
+	}
+
+	Particle ParticleSoA::Get(uint32_t index) const
+	{
+		Particle par;
+		par.pos = float3(pos_x[index], pos_y[index], pos_z[index]);
+		par.vel = float3(vel_x[index], vel_y[index], vel_z[index]);
+		par.life = life[index];
+		par.spin = spin[index];
+		par.size = size[index];
+		par.alpha = alpha[index];
+		par.init_life = init_life[index];
+		return par;
+	}
+
+	void ParticleSoA::Set(uint32_t index, Particle const & par)
+	{
+		pos_x[index] = par.pos.x();
+		pos_y[index] = par.pos.y();
+		pos_z[index] = par.pos.z();
+		vel_x[index] = par.vel.x();
+		vel_y[index] = par.vel.y();
+		vel_z[index] = par.vel.z();
+		life[index] = par.life;
+		spin[index] = par.spin;
+		size[index] = par.size;
+		alpha[index] = par.alpha;
+		init_life[index] = par.init_life;
+	}
+
+	void ParticleSoA::RemoveDead()
+	{
+		uint32_t i = 0;
+		while (i < num)
+		{
+			if (life[i] > 0)
+			{
+				++ i;
+			}
+			else
+			{
+				-- num;
+				if (i != num)
+				{
+					this->Set(i, this->Get(num));
+				}
+			}
+		}
+	}
+
+
 	ParticleEmitter::ParticleEmitter(SceneObjectPtr const & ps)
 			: ps_(checked_pointer_cast<ParticleSystem>(ps)),
 				model_mat_(float4x4::Identity()),
@@ -606,6 +726,16 @@ namespace KlayGE
 		rhs->ps_ = ps_;
 	}
 
+	void ParticleUpdater::UpdateBatch(ParticleSoA& particles, uint32_t first, uint32_t last, float elapse_time)
+	{
+		for (uint32_t i = first; i < last; ++ i)
+		{
+			Particle par = particles.Get(i);
+			this->Update(par, elapse_time);
+			particles.Set(i, par);
+		}
+	}
+
 
 	ParticleSystem::ParticleSystem(uint32_t max_num_particles)
 		: SceneObjectHelper(SOA_Moveable | SOA_NotCastShadow),
@@ -717,80 +847,86 @@ namespace KlayGE
 
 	void ParticleSystem::ClearParticles()
 	{
-		for (auto& particle : particles_)
-		{
-			particle.life = 0;
-		}
+		std::lock_guard<std::mutex> lock(particles_mutex_);
+		particles_.num = 0;
 	}
 
 	void ParticleSystem::SubThreadUpdate(float /*app_time*/, float elapsed_time)
 	{
-		auto emitter_iter = emitters_.begin();
-		uint32_t new_particle = (*emitter_iter)->Update(elapsed_time);
-
-		float4x4 const & view_mat = Context::Instance().AppInstance().ActiveCamera().ViewMatrix();
-		std::vector<std::pair<uint32_t, float>> active_particles;
+		std::unique_lock<std::mutex> particles_lock(particles_mutex_);
 
-		float3 min_bb(+1e10f, +1e10f, +1e10f);
-		float3 max_bb(-1e10f, -1e10f, -1e10f);
-		
-		for (uint32_t i = 0; i < particles_.size(); ++ i)
+		for (auto const & updater : updaters_)
 		{
-			Particle& particle = particles_[i];
+			updater->UpdateBatch(particles_, 0, particles_.num, elapsed_time);
+		}
+		particles_.RemoveDead();
 
-			if (particle.life > 0)
+		// Emitters take the free slots in turn, the new particles go after the live ones
+		uint32_t const first_new = particles_.num;
+		Particle particle;
+		for (auto const & emitter : emitters_)
+		{
+			uint32_t const num_new = std::min(emitter->Update(elapsed_time), particles_.Capacity() - particles_.num);
+			for (uint32_t i = 0; i < num_new; ++ i)
 			{
-				for (auto const & updater : updaters_)
-				{
-					updater->Update(particle, elapsed_time);
-				}
+				emitter->Emit(particle);
+				particles_.Set(particles_.num, particle);
+				++ particles_.num;
 			}
-			else
+		}
+		for (auto const & updater : updaters_)
+		{
+			updater->UpdateBatch(particles_, first_new, particles_.num, 0);
+		}
+		particles_.RemoveDead();
+
+		uint32_t const num_particles = particles_.num;
+		float4x4 const & view_mat = Context::Instance().AppInstance().ActiveCamera().ViewMatrix();
+		depth_items_.resize(num_particles);
+		Context::Instance().TaskScheduler().parallel_for(0, (num_particles + 3) / 4, GROUPS_PER_TASK,
+			[this, &view_mat, num_particles](uint32_t first_group, uint32_t last_group)
 			{
-				if (new_particle > 0)
+				for (uint32_t g = first_group; g < last_group; ++ g)
 				{
-					(*emitter_iter)->Emit(particle);
-					for (auto const & updater : updaters_)
-					{
-						updater->Update(particle, 0);
-					}
-					-- new_particle;
-				}
-				else
-				{
-					if (emitter_iter != emitters_.end())
+					uint32_t const i = g * 4;
+					uint32_t const n = std::min(num_particles - i, 4U);
+
+					float4 const x = LoadLanes(&particles_.pos_x[i], n);
+					float4 const y = LoadLanes(&particles_.pos_y[i], n);
+					float4 const z = LoadLanes(&particles_.pos_z[i], n);
+					float4 const depth = (x * view_mat(0, 2) + y * view_mat(1, 2) + z * view_mat(2, 2) + view_mat(3, 2))
+						/ (x * view_mat(0, 3) + y * view_mat(1, 3) + z * view_mat(2, 3) + view_mat(3, 3));
+
+					for (uint32_t j = 0; j < n; ++ j)
 					{
-						++ emitter_iter;
-						if (emitter_iter != emitters_.end())
-						{
-							new_particle = (*emitter_iter)->Update(elapsed_time);
-						}
+						depth_items_[i + j] = (static_cast<uint64_t>(~SortableFloat(depth[j])) << 32) | (i + j);
 					}
 				}
-			}
+			});
+		// Keys of bigger depths are smaller, so the particles are sorted back to front. The low 32 bits are indices.
+		RadixSort(depth_items_, depth_scratch_, [](uint64_t item) { return item; }, 32);
 
-			if (particle.life > 0)
-			{
-				float3 const & pos = particle.pos;
-				float p_to_v = (pos.x() * view_mat(0, 2) + pos.y() * view_mat(1, 2) + pos.z() * view_mat(2, 2) + view_mat(3, 2))
-					/ (pos.x() * view_mat(0, 3) + pos.y() * view_mat(1, 3) + pos.z() * view_mat(2, 3) + view_mat(3, 3));
-
-				active_particles.emplace_back(i, p_to_v);
+		float3 min_bb(+1e10f, +1e10f, +1e10f);
+		float3 max_bb(-1e10f, -1e10f, -1e10f);
+		back_active_particles_.resize(num_particles);
+		for (uint32_t i = 0; i < num_particles; ++ i)
+		{
+			Particle& par = back_active_particles_[i];
+			par = particles_.Get(static_cast<uint32_t>(depth_items_[i]));
 
-				min_bb = MathLib::minimize(min_bb, pos);
-				max_bb = MathLib::maximize(min_bb, pos);
-			}
+			min_bb = MathLib::minimize(min_bb, par.pos);
+			max_bb = MathLib::maximize(max_bb, par.pos);
 		}
+		particles_lock.unlock();
 
-		if (!active_particles.empty())
+		if (num_particles > 0)
 		{
-			std::sort(active_particles.begin(), active_particles.end(), ParticleCmp());
-
 			checked_pointer_cast<RenderParticles>(renderable_)->PosBound(AABBox(min_bb, max_bb));
+			this->UpdateAbsModelMatrix();
 		}
 
 		std::lock_guard<std::mutex> lock(update_mutex_);
-		active_particles_ = active_particles;
+		active_particles_.swap(back_active_particles_);
 	}
 
 	bool ParticleSystem::MainThreadUpdate(float app_time, float elapsed_time)
@@ -849,7 +985,7 @@ namespace KlayGE
 				ParticleInstance* instance_data = mapper.Pointer<ParticleInstance>();
 				for (uint32_t i = 0; i < num_active_particles; ++ i, ++ instance_data)
 				{
-					Particle const & par = particles_[active_particles_[i].first];
+					Particle const & par = active_particles_[i];
 					instance_data->pos = par.pos;
 					instance_data->life = par.life;
 					instance_data->spin = par.spin;
@@ -1136,38 +1272,9 @@ namespace KlayGE
 
 		float pos = (par.init_life - par.life) / par.init_life;
 
-		float cur_size = size_over_life_.back().y();
-		for (auto iter = size_over_life_.begin(); iter != size_over_life_.end() - 1; ++ iter)
-		{
-			if ((iter + 1)->x() >= pos)
-			{
-				float const s = (pos - iter->x()) / ((iter + 1)->x() - iter->x());
-				cur_size = MathLib::lerp(iter->y(), (iter + 1)->y(), s);
-				break;
-			}
-		}
-
-		float cur_mass = mass_over_life_.back().y();
-		for (auto iter = mass_over_life_.begin(); iter != mass_over_life_.end() - 1; ++ iter)
-		{
-			if ((iter + 1)->x() >= pos)
-			{
-				float const s = (pos - iter->x()) / ((iter + 1)->x() - iter->x());
-				cur_mass = MathLib::lerp(iter->y(), (iter + 1)->y(), s);
-				break;
-			}
-		}
-
-		float cur_alpha = opacity_over_life_.back().y();
-		for (auto iter = opacity_over_life_.begin(); iter != opacity_over_life_.end() - 1; ++ iter)
-		{
-			if ((iter + 1)->x() >= pos)
-			{
-				float const s = (pos - iter->x()) / ((iter + 1)->x() - iter->x());
-				cur_alpha = MathLib::lerp(iter->y(), (iter + 1)->y(), s);
-				break;
-			}
-		}
+		float cur_size = EvalPolyline(size_over_life_, pos);
+		float cur_mass = EvalPolyline(mass_over_life_, pos);
+		float cur_alpha = EvalPolyline(opacity_over_life_, pos);
 
 		ParticleSystemPtr ps = ps_.lock();
 		float buoyancy = 4.0f / 3 * PI * MathLib::cube(cur_size) * ps->MediaDensity() * ps->Gravity();
@@ -1179,4 +1286,58 @@ namespace KlayGE
 		par.size = cur_size;
 		par.alpha = cur_alpha;
 	}
+
+	void PolylineParticleUpdater::UpdateBatch(ParticleSoA& particles, uint32_t first, uint32_t last, float elapse_time)
+	{
+		std::lock_guard<std::mutex> lock(update_mutex_);
+
+		BOOST_ASSERT(!size_over_life_.empty());
+		BOOST_ASSERT(!mass_over_life_.empty());
+		BOOST_ASSERT(!opacity_over_life_.empty());
+
+		ParticleSystemPtr ps = ps_.lock();
+		float const gravity = ps->Gravity();
+		float const buoyancy_scale = 4.0f / 3 * PI * ps->MediaDensity() * gravity;
+		float3 const force = ps->Force();
+
+		uint32_t const num_groups = (last - first + 3) / 4;
+		Context::Instance().TaskScheduler().parallel_for(0, num_groups, GROUPS_PER_TASK,
+			[this, &particles, first, last, elapse_time, gravity, buoyancy_scale, &force](uint32_t first_group, uint32_t last_group)
+			{
+				for (uint32_t g = first_group; g < last_group; ++ g)
+				{
+					uint32_t const i = first + g * 4;
+					uint32_t const n = std::min(last - i, 4U);
+
+					// The curves are piecewise, so they are evaluated per lane
+					float4 cur_size(0.0f);
+					float4 cur_mass(1.0f);
+					float4 cur_alpha(0.0f);
+					for (uint32_t j = 0; j < n; ++ j)
+					{
+						float const pos = (particles.init_life[i + j] - particles.life[i + j]) / particles.init_life[i + j];
+						cur_size[j] = EvalPolyline(size_over_life_, pos);
+						cur_mass[j] = EvalPolyline(mass_over_life_, pos);
+						cur_alpha[j] = EvalPolyline(opacity_over_life_, pos);
+					}
+
+					// Same as Update, 4 particles at a time
+					float4 const inv_mass = float4(1.0f) / cur_mass;
+					float4 const buoyancy = cur_size * cur_size * cur_size * buoyancy_scale;
+					float4 const vel_x = LoadLanes(&particles.vel_x[i], n) + inv_mass * force.x() * elapse_time;
+					float4 const vel_y = LoadLanes(&particles.vel_y[i], n) + ((buoyancy + force.y()) * inv_mass - gravity) * elapse_time;
+					float4 const vel_z = LoadLanes(&particles.vel_z[i], n) + inv_mass * force.z() * elapse_time;
+					StoreLanes(&particles.vel_x[i], vel_x, n);
+					StoreLanes(&particles.vel_y[i], vel_y, n);
+					StoreLanes(&particles.vel_z[i], vel_z, n);
+					StoreLanes(&particles.pos_x[i], LoadLanes(&particles.pos_x[i], n) + vel_x * elapse_time, n);
+					StoreLanes(&particles.pos_y[i], LoadLanes(&particles.pos_y[i], n) + vel_y * elapse_time, n);
+					StoreLanes(&particles.pos_z[i], LoadLanes(&particles.pos_z[i], n) + vel_z * elapse_time, n);
+					StoreLanes(&particles.life[i], LoadLanes(&particles.life[i], n) - elapse_time, n);
+					StoreLanes(&particles.spin[i], LoadLanes(&particles.spin[i], n) + 0.001f, n);
+					StoreLanes(&particles.size[i], cur_size, n);
+					StoreLanes(&particles.alpha[i], cur_alpha, n);
+				}
+			});
+	}
 }
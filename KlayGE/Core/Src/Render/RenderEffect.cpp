@@ -2703,6 +2703,13 @@ namespace KlayGE
 			return false;
 		}
 
+		size_t Hash() const override
+		{
+			size_t seed = static_cast<size_t>(this->Type());
+			HashRange(seed, effect_desc_.res_name.begin(), effect_desc_.res_name.end());
+			return seed;
+		}
+
 		void CopyDataFrom(ResLoadingDesc const & rhs) override
 		{
 			BOOST_ASSERT(this->Type() == rhs.Type());
@@ -3160,6 +3167,7 @@ namespace KlayGE
 				}
 
 				this->GenHLSLShaderText(effect);
+				ShaderObject::PrecompileShaders(effect);
 
 				uint32_t index = 0;
 				for (XMLNodePtr node = root->FirstNode("technique"); node; node = node->NextSibling("technique"), ++ index)
@@ -3167,6 +3175,8 @@ namespace KlayGE
 					techniques_.push_back(MakeUniquePtr<RenderTechnique>());
 					techniques_.back()->Load(effect, node, index);
 				}
+
+				ShaderObject::SaveShaderManifest(effect);
 			}
 
 			std::ofstream ofs(kfx_name.c_str(), std::ios_base::binary | std::ios_base::out);
@@ -29,6 +29,9 @@
 #include <KlayGE/Camera.hpp>
 #include <KlayGE/RenderMaterial.hpp>
 #include <KlayGE/DeferredRenderingLayer.hpp>
+#include <KlayGE/TextureStreaming.hpp>
+
+#include <algorithm>
 
 #include <KlayGE/Renderable.hpp>
 
@@ -60,6 +63,26 @@ namespace KlayGE
 		AABBox const & pos_bb = this->PosBound();
 		AABBox const & tc_bb = this->TexcoordBound();
 
+		if (std::any_of(streamed_textures_.begin(), streamed_textures_.end(),
+			[](StreamedTexturePtr const & tex) { return !!tex; }))
+		{
+			// How many pixels one repeat of the textures spans on screen, from the bounds
+			float3 const center = MathLib::transform_coord(pos_bb.Center(), mv);
+			float const radius = MathLib::length(MathLib::transform_normal(pos_bb.HalfSize(), mv));
+			float const depth = std::max(center.z() - radius, camera.NearPlane());
+			float const repeats = std::max(std::max(tc_bb.HalfSize().x(), tc_bb.HalfSize().y()) * 2, 1e-3f);
+			float const pixels = radius * proj(1, 1) / depth * re.CurFrameBuffer()->Height() / repeats;
+
+			for (size_t i = 0; i < RenderMaterial::TS_NumTextureSlots; ++ i)
+			{
+				if (streamed_textures_[i])
+				{
+					streamed_textures_[i]->RequestScreenSize(pixels);
+					textures_[i] = streamed_textures_[i]->ResidentTexture();
+				}
+			}
+		}
+
 		auto drl = Context::Instance().DeferredRenderingLayerInstance();
 
 		if (drl)
@@ -236,6 +259,26 @@ namespace KlayGE
 		instances_.resize(0);
 	}
 
+	float Renderable::MinViewDepth(float4 const & view_mat_z) const
+	{
+		// The min of a linear function over a box is at center - |extent|, no need to go through all 8 corners
+		AABBox const & box = this->PosBound();
+		float3 const center = box.Center();
+		float3 const extent = box.HalfSize();
+
+		float md = 1e10f;
+		for (auto const & inst : instances_)
+		{
+			float4x4 const & mat = inst->ModelMatrix();
+			float4 const zvec(MathLib::dot(mat.Row(0), view_mat_z),
+				MathLib::dot(mat.Row(1), view_mat_z), MathLib::dot(mat.Row(2), view_mat_z),
+				MathLib::dot(mat.Row(3), view_mat_z));
+			md = std::min(md, center.x() * zvec.x() + center.y() * zvec.y() + center.z() * zvec.z() + zvec.w()
+				- (MathLib::abs(extent.x() * zvec.x()) + MathLib::abs(extent.y() * zvec.y()) + MathLib::abs(extent.z() * zvec.z())));
+		}
+		return md;
+	}
+
 	void Renderable::UpdateInstanceStream()
 	{
 		if (!instances_.empty() && !instances_[0]->InstanceFormat().empty())
@@ -247,33 +290,25 @@ namespace KlayGE
 				size += vet[i].element_size();
 			}
 
-			uint32_t const inst_size = static_cast<uint32_t>(size * instances_.size());
+			for (size_t i = 0; i < instances_.size(); ++ i)
+			{
+				BOOST_ASSERT(vet == instances_[i]->InstanceFormat());
+			}
 
 			RenderLayout& rl = this->GetRenderLayout();
 
-			GraphicsBufferPtr inst_stream = rl.InstanceStream();
-			if (inst_stream && (inst_stream->Size() >= inst_size))
-			{
-				for (size_t i = 0; i < instances_.size(); ++ i)
-				{
-					BOOST_ASSERT(rl.InstanceStreamFormat() == instances_[i]->InstanceFormat());
-				}
-			}
-			else
+			// The data goes to the scene manager's transient buffer, which is shared by all renderables in a frame
+			uint32_t start_instance;
+			GraphicsBufferPtr const & inst_stream = Context::Instance().SceneManagerInstance().PackInstances(start_instance,
+				instances_, size);
+			if (rl.InstanceStream() != inst_stream)
 			{
-				RenderFactory& rf(Context::Instance().RenderFactoryInstance());
-				inst_stream = rf.MakeVertexBuffer(BU_Dynamic, EAH_CPU_Write | EAH_GPU_Read, inst_size, nullptr);
 				rl.BindVertexStream(inst_stream, vet, RenderLayout::ST_Instance, 1);
 				rl.InstanceStream(inst_stream);
 			}
-
+			if (rl.StartInstanceLocation() != start_instance)
 			{
-				GraphicsBuffer::Mapper mapper(*inst_stream, BA_Write_Only);
-				for (size_t i = 0; i < instances_.size(); ++ i)
-				{
-					uint8_t const * src = static_cast<uint8_t const *>(instances_[i]->InstanceData());
-					std::copy(src, src + size, mapper.Pointer<uint8_t>() + i * size);
-				}
+				rl.StartInstanceLocation(start_instance);
 			}
 
 			for (uint32_t i = 0; i < rl.NumVertexStreams(); ++ i)
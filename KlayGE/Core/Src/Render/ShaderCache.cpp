@@ -0,0 +1,491 @@
+/**
+ * @file ShaderCache.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+
+#if KLAYGE_IS_DEV_PLATFORM
+
+#include <KFL/Hash.hpp>
+#include <KFL/Util.hpp>
+#include <KFL/CXX17/filesystem.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <KlayGE/ShaderCache.hpp>
+
+namespace
+{
+	using namespace KlayGE;
+
+	uint32_t const SHADER_CACHE_VERSION = 2;
+
+	// Anything longer is a corrupted file
+	uint32_t const MAX_STRING_LEN = 64 * 1024;
+	uint32_t const MAX_NUM_MACROS = 64 * 1024;
+
+	void WriteU32(std::ostream& os, uint32_t val)
+	{
+		val = Native2LE(val);
+		os.write(reinterpret_cast<char const *>(&val), sizeof(val));
+	}
+
+	void WriteU64(std::ostream& os, uint64_t val)
+	{
+		val = Native2LE(val);
+		os.write(reinterpret_cast<char const *>(&val), sizeof(val));
+	}
+
+	void WriteString(std::ostream& os, std::string const & str)
+	{
+		WriteU32(os, static_cast<uint32_t>(str.size()));
+		os.write(str.data(), str.size());
+	}
+
+	uint32_t ReadU32(std::istream& is)
+	{
+		uint32_t val = 0;
+		is.read(reinterpret_cast<char*>(&val), sizeof(val));
+		return LE2Native(val);
+	}
+
+	uint64_t ReadU64(std::istream& is)
+	{
+		uint64_t val = 0;
+		is.read(reinterpret_cast<char*>(&val), sizeof(val));
+		return LE2Native(val);
+	}
+
+	bool ReadString(std::istream& is, std::string& str)
+	{
+		uint32_t const len = ReadU32(is);
+		if (!is || (len > MAX_STRING_LEN))
+		{
+			return false;
+		}
+		str.resize(len);
+		if (len > 0)
+		{
+			is.read(&str[0], len);
+		}
+		return static_cast<bool>(is);
+	}
+
+	void WriteRequest(std::ostream& os, ShaderCompileRequest const & request)
+	{
+		WriteU32(os, static_cast<uint32_t>(request.type));
+		WriteString(os, request.func_name);
+		WriteString(os, request.profile);
+		WriteU32(os, request.flags);
+		WriteU32(os, static_cast<uint32_t>(request.macros.size()));
+		for (auto const & macro : request.macros)
+		{
+			WriteString(os, macro.first);
+			WriteString(os, macro.second);
+		}
+	}
+
+	bool ReadRequest(std::istream& is, ShaderCompileRequest& request)
+	{
+		uint32_t const type = ReadU32(is);
+		if (!is || (type >= ShaderObject::ST_NumShaderTypes))
+		{
+			return false;
+		}
+		request.type = static_cast<ShaderObject::ShaderType>(type);
+		if (!ReadString(is, request.func_name) || !ReadString(is, request.profile))
+		{
+			return false;
+		}
+		request.flags = ReadU32(is);
+
+		uint32_t const num_macros = ReadU32(is);
+		if (!is || (num_macros > MAX_NUM_MACROS))
+		{
+			return false;
+		}
+		request.macros.resize(num_macros);
+		for (auto& macro : request.macros)
+		{
+			if (!ReadString(is, macro.first) || !ReadString(is, macro.second))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+namespace KlayGE
+{
+	bool ShaderCompileRequest::operator==(ShaderCompileRequest const & rhs) const
+	{
+		return (type == rhs.type) && (func_name == rhs.func_name) && (profile == rhs.profile) && (flags == rhs.flags)
+			&& (macros == rhs.macros);
+	}
+
+
+	ShaderCache::ShaderCache(std::string const & folder, std::string const & compiler_version)
+		: folder_(folder), compiler_version_(compiler_version), next_order_(0)
+	{
+		if (folder_.empty())
+		{
+			return;
+		}
+
+		try
+		{
+			std::filesystem::create_directories(folder_);
+		}
+		catch (...)
+		{
+			folder_.clear();
+			return;
+		}
+
+		this->LoadIndex();
+	}
+
+	bool ShaderCache::Contains(uint64_t hlsl_hash, ShaderCompileRequest const & request)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return this->FindEntry(hlsl_hash, request) != nullptr;
+	}
+
+	bool ShaderCache::Find(uint64_t hlsl_hash, ShaderCompileRequest const & request, std::vector<uint8_t>& code)
+	{
+		uint64_t blob_hash;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			Entry const * entry = this->FindEntry(hlsl_hash, request);
+			if (!entry)
+			{
+				return false;
+			}
+			blob_hash = entry->blob_hash;
+		}
+
+		std::ifstream ifs(this->CachePath(blob_hash, ".dxbc").c_str(), std::ios_base::binary);
+		if (ifs)
+		{
+			ifs.seekg(0, std::ios_base::end);
+			code.resize(static_cast<size_t>(ifs.tellg()));
+			ifs.seekg(0, std::ios_base::beg);
+			if (!code.empty())
+			{
+				ifs.read(reinterpret_cast<char*>(&code[0]), code.size());
+			}
+		}
+		if (!ifs || code.empty() || (HashBytes64(code.data(), code.size()) != blob_hash))
+		{
+			code.clear();
+			return false;
+		}
+		return true;
+	}
+
+	void ShaderCache::Add(uint64_t hlsl_hash, ShaderCompileRequest const & request, std::vector<uint8_t> const & code)
+	{
+		BOOST_ASSERT(!code.empty());
+
+		uint64_t const key = this->Key(hlsl_hash, request);
+		uint64_t const blob_hash = HashBytes64(code.data(), code.size());
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (folder_.empty())
+		{
+			return;
+		}
+
+		std::string const blob_name = this->CachePath(blob_hash, ".dxbc");
+		if (!std::filesystem::exists(blob_name))
+		{
+			std::ofstream ofs(blob_name.c_str(), std::ios_base::binary);
+			ofs.write(reinterpret_cast<char const *>(&code[0]), code.size());
+		}
+
+		Entry& entry = index_[key];
+		entry.blob_hash = blob_hash;
+		entry.hlsl_hash = hlsl_hash;
+		entry.request = request;
+		entry.order = next_order_;
+		++ next_order_;
+
+		std::ofstream ofs((folder_ + "index.bin").c_str(), std::ios_base::binary | std::ios_base::app);
+		WriteU64(ofs, key);
+		WriteU64(ofs, blob_hash);
+		WriteU64(ofs, hlsl_hash);
+		WriteRequest(ofs, request);
+	}
+
+	uint32_t ShaderCache::NumEntries()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return static_cast<uint32_t>(index_.size());
+	}
+
+	void ShaderCache::Record(uint64_t manifest_key, uint64_t hlsl_hash, ShaderCompileRequest const & request)
+	{
+		uint64_t const key = this->Key(hlsl_hash, request);
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto& requests = recorded_[manifest_key];
+		for (auto const & recorded : requests)
+		{
+			if ((recorded.first == key) && (recorded.second == request))
+			{
+				return;
+			}
+		}
+		requests.emplace_back(key, request);
+	}
+
+	std::vector<ShaderCompileRequest> ShaderCache::LoadManifest(uint64_t manifest_key)
+	{
+		std::vector<ShaderCompileRequest> requests;
+		if (folder_.empty())
+		{
+			return requests;
+		}
+
+		std::ifstream ifs(this->CachePath(manifest_key, ".kmf").c_str(), std::ios_base::binary);
+		uint32_t const fourcc = ReadU32(ifs);
+		uint32_t const version = ReadU32(ifs);
+		uint32_t const num_requests = ReadU32(ifs);
+		if (!ifs || (fourcc != MakeFourCC<'K', 'S', 'M', 'F'>::value) || (version != SHADER_CACHE_VERSION)
+			|| (num_requests > MAX_ENTRIES))
+		{
+			return requests;
+		}
+
+		requests.resize(num_requests);
+		for (auto& request : requests)
+		{
+			if (!ReadRequest(ifs, request))
+			{
+				requests.clear();
+				break;
+			}
+		}
+
+		return requests;
+	}
+
+	void ShaderCache::SaveManifest(uint64_t manifest_key)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		auto iter = recorded_.find(manifest_key);
+		if (iter == recorded_.end())
+		{
+			return;
+		}
+
+		if (!folder_.empty())
+		{
+			std::ofstream ofs(this->CachePath(manifest_key, ".kmf").c_str(), std::ios_base::binary);
+			WriteU32(ofs, MakeFourCC<'K', 'S', 'M', 'F'>::value);
+			WriteU32(ofs, SHADER_CACHE_VERSION);
+			WriteU32(ofs, static_cast<uint32_t>(iter->second.size()));
+			for (auto const & recorded : iter->second)
+			{
+				WriteRequest(ofs, recorded.second);
+			}
+		}
+
+		recorded_.erase(iter);
+	}
+
+	uint64_t ShaderCache::Key(uint64_t hlsl_hash, ShaderCompileRequest const & request) const
+	{
+		uint64_t seed = HashString64(HASH64_SEED, compiler_version_);
+		seed = HashBytes64(seed, &hlsl_hash, sizeof(hlsl_hash));
+		uint32_t const type = static_cast<uint32_t>(request.type);
+		seed = HashBytes64(seed, &type, sizeof(type));
+		seed = HashString64(seed, request.func_name);
+		seed = HashString64(seed, request.profile);
+		seed = HashBytes64(seed, &request.flags, sizeof(request.flags));
+		uint32_t const num_macros = static_cast<uint32_t>(request.macros.size());
+		seed = HashBytes64(seed, &num_macros, sizeof(num_macros));
+		for (auto const & macro : request.macros)
+		{
+			seed = HashString64(seed, macro.first);
+			seed = HashString64(seed, macro.second);
+		}
+		return seed;
+	}
+
+	ShaderCache::Entry const * ShaderCache::FindEntry(uint64_t hlsl_hash, ShaderCompileRequest const & request) const
+	{
+		auto iter = index_.find(this->Key(hlsl_hash, request));
+		if ((iter != index_.end()) && (iter->second.hlsl_hash == hlsl_hash) && (iter->second.request == request))
+		{
+			return &iter->second;
+		}
+		return nullptr;
+	}
+
+	void ShaderCache::LoadIndex()
+	{
+		uint64_t num_records = 0;
+		bool valid = false;
+		{
+			std::ifstream ifs((folder_ + "index.bin").c_str(), std::ios_base::binary);
+			uint32_t const fourcc = ReadU32(ifs);
+			uint32_t const version = ReadU32(ifs);
+			if (ifs && (fourcc == MakeFourCC<'K', 'S', 'H', 'C'>::value) && (version == SHADER_CACHE_VERSION))
+			{
+				valid = true;
+
+				// A truncated record at the end is from a run that didn't finish writing it
+				for (;;)
+				{
+					uint64_t const key = ReadU64(ifs);
+					Entry entry;
+					entry.blob_hash = ReadU64(ifs);
+					entry.hlsl_hash = ReadU64(ifs);
+					if (!ifs || !ReadRequest(ifs, entry.request))
+					{
+						valid = ifs.eof();
+						break;
+					}
+					entry.order = next_order_;
+					++ next_order_;
+					index_[key] = std::move(entry);
+					++ num_records;
+				}
+			}
+		}
+
+		if (index_.size() > MAX_ENTRIES)
+		{
+			std::vector<uint64_t> orders;
+			orders.reserve(index_.size());
+			for (auto const & entry : index_)
+			{
+				orders.push_back(entry.second.order);
+			}
+			std::nth_element(orders.begin(), orders.end() - MAX_ENTRIES, orders.end());
+			uint64_t const min_order = *(orders.end() - MAX_ENTRIES);
+			for (auto iter = index_.begin(); iter != index_.end();)
+			{
+				if (iter->second.order < min_order)
+				{
+					iter = index_.erase(iter);
+				}
+				else
+				{
+					++ iter;
+				}
+			}
+		}
+
+		if (!valid || (num_records != index_.size()))
+		{
+			this->WriteIndex();
+		}
+	}
+
+	// Rewrites the index with one record per entry, oldest first, and removes the blobs nothing refers to
+	void ShaderCache::WriteIndex()
+	{
+		std::vector<std::pair<uint64_t, Entry const *>> entries;
+		entries.reserve(index_.size());
+		for (auto const & entry : index_)
+		{
+			entries.emplace_back(entry.first, &entry.second);
+		}
+		std::sort(entries.begin(), entries.end(),
+			[](std::pair<uint64_t, Entry const *> const & lhs, std::pair<uint64_t, Entry const *> const & rhs)
+			{
+				return lhs.second->order < rhs.second->order;
+			});
+
+		std::string const index_name = folder_ + "index.bin";
+		std::string const tmp_name = index_name + ".tmp";
+		{
+			std::ofstream ofs(tmp_name.c_str(), std::ios_base::binary);
+			WriteU32(ofs, MakeFourCC<'K', 'S', 'H', 'C'>::value);
+			WriteU32(ofs, SHADER_CACHE_VERSION);
+			for (auto const & entry : entries)
+			{
+				WriteU64(ofs, entry.first);
+				WriteU64(ofs, entry.second->blob_hash);
+				WriteU64(ofs, entry.second->hlsl_hash);
+				WriteRequest(ofs, entry.second->request);
+			}
+		}
+		std::remove(index_name.c_str());
+		std::rename(tmp_name.c_str(), index_name.c_str());
+
+		std::unordered_map<uint64_t, bool> blobs;
+		for (auto const & entry : entries)
+		{
+			blobs[entry.second->blob_hash] = true;
+		}
+		try
+		{
+			std::vector<std::filesystem::path> unused_blobs;
+			for (std::filesystem::directory_iterator iter(folder_), end; iter != end; ++ iter)
+			{
+				std::filesystem::path const & path = iter->path();
+				if (path.extension() == ".dxbc")
+				{
+					std::istringstream ss(path.stem().string());
+					uint64_t blob_hash = 0;
+					ss >> std::hex >> blob_hash;
+					if (blobs.find(blob_hash) == blobs.end())
+					{
+						unused_blobs.push_back(path);
+					}
+				}
+			}
+			for (auto const & path : unused_blobs)
+			{
+				std::filesystem::remove(path);
+			}
+		}
+		catch (...)
+		{
+		}
+	}
+
+	std::string ShaderCache::CachePath(uint64_t hash, char const * ext) const
+	{
+		std::ostringstream ss;
+		ss << folder_ << std::hex << std::setw(16) << std::setfill('0') << hash << ext;
+		return ss.str();
+	}
+}
+
+#endif
@@ -13,6 +13,8 @@
 #include <KlayGE/KlayGE.hpp>
 #include <KFL/ErrorHandling.hpp>
 #include <KFL/Util.hpp>
+#include <KFL/Hash.hpp>
+#include <KFL/Thread.hpp>
 #include <KlayGE/RenderEffect.hpp>
 #include <KlayGE/Context.hpp>
 #include <KlayGE/RenderFactory.hpp>
@@ -24,12 +26,15 @@
 #include <map>
 #include <sstream>
 #include <fstream>
+#include <mutex>
+#include <atomic>
 
 #include <boost/lexical_cast.hpp>
 
 #include <KlayGE/ShaderObject.hpp>
 
 #if KLAYGE_IS_DEV_PLATFORM
+#include <KlayGE/ShaderCache.hpp>
 
 #ifdef KLAYGE_PLATFORM_WINDOWS
 #define CALL_D3DCOMPILER_DIRECTLY
@@ -39,6 +44,8 @@
 #include <KlayGE/SALWrapper.hpp>
 #include <d3dcompiler.h>
 #else
+#include <sys/stat.h>
+
 // http://msdn.microsoft.com/en-us/library/windows/desktop/aa383751(v=vs.85).aspx
 typedef char const * LPCSTR;
 typedef long HRESULT;
@@ -92,6 +99,12 @@ namespace
 			return initer;
 		}
 
+		// Changes when the compiler is replaced, so that the cached code from the old one isn't used
+		std::string const & Version() const
+		{
+			return version_;
+		}
+
 		HRESULT D3DCompile(std::string const & src_data,
 			D3D_SHADER_MACRO const * defines, char const * entry_point,
 			char const * target, uint32_t flags1, uint32_t flags2,
@@ -125,7 +138,10 @@ namespace
 			}
 			return hr;
 #else
-			std::string mark = boost::lexical_cast<std::string>(static_cast<void const *>(src_data.c_str()));
+			// Several shaders of the same effect can be compiled at the same time
+			static std::atomic<uint32_t> compile_index(0);
+			std::string mark = boost::lexical_cast<std::string>(static_cast<void const *>(src_data.c_str()))
+				+ "_" + boost::lexical_cast<std::string>(compile_index ++);
 			std::string compile_input_file = entry_point + mark + "Input.tmp";
 			std::string compile_output_file = entry_point + mark + "Output.tmp";
 
@@ -163,15 +179,14 @@ namespace
 #ifdef KLAYGE_PLATFORM_WINDOWS
 			ss << d3dcompiler_wrapper_name << ".exe";
 #else
-			static bool first = true;
-			if (first)
-			{
-				ss << WINE_PATH << "wineserver -p";
-				system(ss.str().c_str());
-				// We should hold on a persistant wineserver, or XCode will lost connection after wineserver instance close and wine may not be able to find '.exe.so' file
-				first = false;
-				ss.str(std::string());
-			}
+			static std::once_flag wineserver_flag;
+			std::call_once(wineserver_flag, []
+				{
+					std::ostringstream wineserver_ss;
+					wineserver_ss << WINE_PATH << "wineserver -p";
+					system(wineserver_ss.str().c_str());
+					// We should hold on a persistant wineserver, or XCode will lost connection after wineserver instance close and wine may not be able to find '.exe.so' file
+				});
 			d3dcompiler_wrapper_name += ".exe.so";
 			std::string wrapper_path = ResLoader::Instance().Locate(d3dcompiler_wrapper_name);
 			ss << WINE_PATH << "wine " << wrapper_path;
@@ -267,6 +282,34 @@ namespace
 			DynamicD3DCompile_ = reinterpret_cast<pD3DCompile>(::GetProcAddress(mod_d3dcompiler_, "D3DCompile"));
 			DynamicD3DReflect_ = reinterpret_cast<D3DReflectFunc>(::GetProcAddress(mod_d3dcompiler_, "D3DReflect"));
 			DynamicD3DStripShader_ = reinterpret_cast<D3DStripShaderFunc>(::GetProcAddress(mod_d3dcompiler_, "D3DStripShader"));
+
+			char path[MAX_PATH];
+			::GetModuleFileNameA(mod_d3dcompiler_, path, sizeof(path));
+			std::ostringstream ss;
+			ss << path;
+			WIN32_FILE_ATTRIBUTE_DATA attr;
+			if (::GetFileAttributesExA(path, GetFileExInfoStandard, &attr))
+			{
+				ss << ' ' << attr.nFileSizeHigh << ' ' << attr.nFileSizeLow
+					<< ' ' << attr.ftLastWriteTime.dwHighDateTime << ' ' << attr.ftLastWriteTime.dwLowDateTime;
+			}
+			version_ = ss.str();
+#else
+			// The wrapper runs d3dcompiler_47.dll under wine. It's deployed with the wrapper, so the wrapper stands
+			//  for both.
+			std::string d3dcompiler_wrapper_name = "D3DCompilerWrapper";
+#ifdef KLAYGE_DEBUG
+			d3dcompiler_wrapper_name += "_d";
+#endif
+			std::string const wrapper_path = ResLoader::Instance().Locate(d3dcompiler_wrapper_name + ".exe.so");
+			std::ostringstream ss;
+			ss << wrapper_path;
+			struct stat st;
+			if (0 == stat(wrapper_path.c_str(), &st))
+			{
+				ss << ' ' << st.st_size << ' ' << st.st_mtime;
+			}
+			version_ = ss.str();
 #endif
 		}
 
@@ -281,142 +324,70 @@ namespace
 		D3DReflectFunc DynamicD3DReflect_;
 		D3DStripShaderFunc DynamicD3DStripShader_;
 #endif
+		std::string version_;
 	};
-}
-
-#endif
-
-namespace KlayGE
-{
-	ShaderObject::ShaderObject()
-		: has_discard_(false), has_tessellation_(false),
-			cs_block_size_x_(0), cs_block_size_y_(0), cs_block_size_z_(0)
-	{
-	}
 
-#if KLAYGE_IS_DEV_PLATFORM
-	std::vector<uint8_t> ShaderObject::CompileToDXBC(ShaderType type, RenderEffect const & effect,
-			RenderTechnique const & tech, RenderPass const & pass,
-			std::vector<std::pair<char const *, char const *>> const & api_special_macros,
-			char const * func_name, char const * shader_profile, uint32_t flags)
+	// The macros every shader gets from the device
+	std::vector<std::pair<std::string, std::string>> DeviceMacros()
 	{
 		RenderEngine const & re = Context::Instance().RenderFactoryInstance().RenderEngineInstance();
 		RenderDeviceCaps const & caps = re.DeviceCaps();
 
-		std::vector<uint8_t> code;
-
-		std::string const & hlsl_shader_text = effect.HLSLShaderText();
-
-		std::string max_sm_str = boost::lexical_cast<std::string>(caps.max_shader_model.FullVersion());
-		std::string max_tex_array_str = boost::lexical_cast<std::string>(caps.max_texture_array_length);
-		std::string max_tex_depth_str = boost::lexical_cast<std::string>(caps.max_texture_depth);
-		std::string max_tex_units_str = boost::lexical_cast<std::string>(static_cast<int>(caps.max_pixel_texture_units));
-		std::string flipping_str = boost::lexical_cast<std::string>(re.RequiresFlipping() ? -1 : +1);
-		std::string render_to_tex_array_str = boost::lexical_cast<std::string>(caps.render_to_texture_array_support ? 1 : 0);
-
-		std::string err_msg;
-		std::vector<D3D_SHADER_MACRO> macros;
-
-		for (uint32_t i = 0; i < api_special_macros.size(); ++ i)
-		{
-			D3D_SHADER_MACRO macro = { api_special_macros[i].first, api_special_macros[i].second };
-			macros.push_back(macro);
-		}
-
-		{
-			D3D_SHADER_MACRO macro = { "KLAYGE_SHADER_MODEL", max_sm_str.c_str() };
-			macros.push_back(macro);
-		}
-		{
-			D3D_SHADER_MACRO macro = { "KLAYGE_MAX_TEX_ARRAY_LEN", max_tex_array_str.c_str() };
-			macros.push_back(macro);
-		}
-		{
-			D3D_SHADER_MACRO macro = { "KLAYGE_MAX_TEX_DEPTH", max_tex_depth_str.c_str() };
-			macros.push_back(macro);
-		}
-		{
-			D3D_SHADER_MACRO macro = { "KLAYGE_MAX_TEX_UNITS", max_tex_units_str.c_str() };
-			macros.push_back(macro);
-		}
-		{
-			D3D_SHADER_MACRO macro = { "KLAYGE_FLIPPING", flipping_str.c_str() };
-			macros.push_back(macro);
-		}
-		{
-			D3D_SHADER_MACRO macro = { "KLAYGE_RENDER_TO_TEX_ARRAY", render_to_tex_array_str.c_str() };
-			macros.push_back(macro);
-		}
+		std::vector<std::pair<std::string, std::string>> macros;
+		macros.emplace_back("KLAYGE_SHADER_MODEL", boost::lexical_cast<std::string>(caps.max_shader_model.FullVersion()));
+		macros.emplace_back("KLAYGE_MAX_TEX_ARRAY_LEN", boost::lexical_cast<std::string>(caps.max_texture_array_length));
+		macros.emplace_back("KLAYGE_MAX_TEX_DEPTH", boost::lexical_cast<std::string>(caps.max_texture_depth));
+		macros.emplace_back("KLAYGE_MAX_TEX_UNITS", boost::lexical_cast<std::string>(static_cast<int>(caps.max_pixel_texture_units)));
+		macros.emplace_back("KLAYGE_FLIPPING", boost::lexical_cast<std::string>(re.RequiresFlipping() ? -1 : +1));
+		macros.emplace_back("KLAYGE_RENDER_TO_TEX_ARRAY", boost::lexical_cast<std::string>(caps.render_to_texture_array_support ? 1 : 0));
 		if (!caps.fp_color_support)
 		{
-			D3D_SHADER_MACRO macro = { "KLAYGE_NO_FP_COLOR", "1" };
-			macros.push_back(macro);
+			macros.emplace_back("KLAYGE_NO_FP_COLOR", "1");
 		}
 		if (caps.pack_to_rgba_required)
 		{
-			D3D_SHADER_MACRO macro = { "KLAYGE_PACK_TO_RGBA", "1" };
-			macros.push_back(macro);
+			macros.emplace_back("KLAYGE_PACK_TO_RGBA", "1");
 		}
-		{
-			D3D_SHADER_MACRO macro_shader_type = { "", "1" };
-			switch (type)
-			{
-			case ST_VertexShader:
-				macro_shader_type.Name = "KLAYGE_VERTEX_SHADER";
-				break;
-
-			case ST_PixelShader:
-				macro_shader_type.Name = "KLAYGE_PIXEL_SHADER";
-				break;
-
-			case ST_GeometryShader:
-				macro_shader_type.Name = "KLAYGE_GEOMETRY_SHADER";
-				break;
-
-			case ST_ComputeShader:
-				macro_shader_type.Name = "KLAYGE_COMPUTE_SHADER";
-				break;
-
-			case ST_HullShader:
-				macro_shader_type.Name = "KLAYGE_HULL_SHADER";
-				break;
-
-			case ST_DomainShader:
-				macro_shader_type.Name = "KLAYGE_DOMAIN_SHADER";
-				break;
+		return macros;
+	}
 
-			default:
-				KFL_UNREACHABLE("Invalid shader type");
-			}
-			macros.push_back(macro_shader_type);
-		}
+	// The shaders an effect needs depend on the API and the device, so they are recorded per effect and device
+	uint64_t ShaderManifestKey(RenderEffect const & effect)
+	{
+		RenderEngine const & re = Context::Instance().RenderFactoryInstance().RenderEngineInstance();
 
-		for (uint32_t i = 0; i < tech.NumMacros(); ++ i)
+		uint64_t seed = HashString64(HASH64_SEED, effect.ResName());
+		seed = HashString64(seed, re.NativeShaderPlatformName());
+		for (auto const & macro : DeviceMacros())
 		{
-			std::pair<std::string, std::string> const & name_value = tech.MacroByIndex(i);
-			D3D_SHADER_MACRO macro = { name_value.first.c_str(), name_value.second.c_str() };
-			macros.push_back(macro);
+			seed = HashString64(seed, macro.first);
+			seed = HashString64(seed, macro.second);
 		}
+		return seed;
+	}
 
-		for (uint32_t i = 0; i < pass.NumMacros(); ++ i)
+	std::vector<uint8_t> CompileDXBC(std::string const & hlsl_shader_text, ShaderCompileRequest const & request,
+		bool report_errors)
+	{
+		std::vector<D3D_SHADER_MACRO> macros;
+		for (auto const & macro : request.macros)
 		{
-			std::pair<std::string, std::string> const & name_value = pass.MacroByIndex(i);
-			D3D_SHADER_MACRO macro = { name_value.first.c_str(), name_value.second.c_str() };
-			macros.push_back(macro);
+			D3D_SHADER_MACRO d3d_macro = { macro.first.c_str(), macro.second.c_str() };
+			macros.push_back(d3d_macro);
 		}
-
 		{
 			D3D_SHADER_MACRO macro_end = { nullptr, nullptr };
 			macros.push_back(macro_end);
 		}
 
+		std::vector<uint8_t> code;
+		std::string err_msg;
 		D3DCompilerLoader::Instance().D3DCompile(hlsl_shader_text, &macros[0],
-			func_name, shader_profile,
-			flags, 0, code, err_msg);
-		if (!err_msg.empty())
+			request.func_name.c_str(), request.profile.c_str(),
+			request.flags, 0, code, err_msg);
+		if (!err_msg.empty() && report_errors)
 		{
-			LogError("Error when compiling %s:", func_name);
-
+			LogError("Error when compiling %s:", request.func_name.c_str());
 			std::map<int, std::vector<std::string>> err_lines;
 			{
 				std::istringstream err_iss(err_msg);
@@ -500,9 +471,145 @@ namespace KlayGE
 			}
 		}
 
+
 		return code;
 	}
 
+	ShaderCache& TheShaderCache()
+	{
+		static ShaderCache cache(ResLoader::Instance().LocalFolder() + "ShaderCache/",
+			D3DCompilerLoader::Instance().Version());
+		return cache;
+	}
+}
+
+#endif
+
+namespace KlayGE
+{
+	ShaderObject::ShaderObject()
+		: has_discard_(false), has_tessellation_(false),
+			cs_block_size_x_(0), cs_block_size_y_(0), cs_block_size_z_(0)
+	{
+	}
+
+#if KLAYGE_IS_DEV_PLATFORM
+	std::vector<uint8_t> ShaderObject::CompileToDXBC(ShaderType type, RenderEffect const & effect,
+			RenderTechnique const & tech, RenderPass const & pass,
+			std::vector<std::pair<char const *, char const *>> const & api_special_macros,
+			char const * func_name, char const * shader_profile, uint32_t flags)
+	{
+		ShaderCompileRequest request;
+		request.type = type;
+		request.func_name = func_name;
+		request.profile = shader_profile;
+		request.flags = flags;
+		for (auto const & macro : api_special_macros)
+		{
+			request.macros.emplace_back(macro.first, macro.second);
+		}
+		{
+			auto const device_macros = DeviceMacros();
+			request.macros.insert(request.macros.end(), device_macros.begin(), device_macros.end());
+		}
+		{
+			char const * shader_type_macro;
+			switch (type)
+			{
+			case ST_VertexShader:
+				shader_type_macro = "KLAYGE_VERTEX_SHADER";
+				break;
+
+			case ST_PixelShader:
+				shader_type_macro = "KLAYGE_PIXEL_SHADER";
+				break;
+
+			case ST_GeometryShader:
+				shader_type_macro = "KLAYGE_GEOMETRY_SHADER";
+				break;
+
+			case ST_ComputeShader:
+				shader_type_macro = "KLAYGE_COMPUTE_SHADER";
+				break;
+
+			case ST_HullShader:
+				shader_type_macro = "KLAYGE_HULL_SHADER";
+				break;
+
+			case ST_DomainShader:
+				shader_type_macro = "KLAYGE_DOMAIN_SHADER";
+				break;
+
+			default:
+				KFL_UNREACHABLE("Invalid shader type");
+			}
+			request.macros.emplace_back(shader_type_macro, "1");
+		}
+		for (uint32_t i = 0; i < tech.NumMacros(); ++ i)
+		{
+			request.macros.push_back(tech.MacroByIndex(i));
+		}
+		for (uint32_t i = 0; i < pass.NumMacros(); ++ i)
+		{
+			request.macros.push_back(pass.MacroByIndex(i));
+		}
+
+		std::string const & hlsl_shader_text = effect.HLSLShaderText();
+		uint64_t const hlsl_hash = HashBytes64(hlsl_shader_text.data(), hlsl_shader_text.size());
+
+		ShaderCache& cache = TheShaderCache();
+		cache.Record(ShaderManifestKey(effect), hlsl_hash, request);
+
+		std::vector<uint8_t> code;
+		if (!cache.Find(hlsl_hash, request, code))
+		{
+			code = CompileDXBC(hlsl_shader_text, request, true);
+			if (!code.empty())
+			{
+				cache.Add(hlsl_hash, request, code);
+			}
+		}
+
+		return code;
+	}
+
+	void ShaderObject::PrecompileShaders(RenderEffect const & effect)
+	{
+		ShaderCache& cache = TheShaderCache();
+		std::vector<ShaderCompileRequest> const requests = cache.LoadManifest(ShaderManifestKey(effect));
+
+		std::string const & hlsl_shader_text = effect.HLSLShaderText();
+		uint64_t const hlsl_hash = HashBytes64(hlsl_shader_text.data(), hlsl_shader_text.size());
+
+		std::vector<ShaderCompileRequest const *> missing;
+		for (auto const & request : requests)
+		{
+			if (!cache.Contains(hlsl_hash, request))
+			{
+				missing.push_back(&request);
+			}
+		}
+
+		Context::Instance().TaskScheduler().parallel_for(0, static_cast<uint32_t>(missing.size()), 1,
+			[&cache, &hlsl_shader_text, hlsl_hash, &missing](uint32_t first, uint32_t last)
+			{
+				for (uint32_t i = first; i < last; ++ i)
+				{
+					// Errors are reported when the pass compiles it again
+					std::vector<uint8_t> code = CompileDXBC(hlsl_shader_text, *missing[i], false);
+					if (!code.empty())
+					{
+						cache.Add(hlsl_hash, *missing[i], code);
+					}
+				}
+			});
+	}
+
+	void ShaderObject::SaveShaderManifest(RenderEffect const & effect)
+	{
+		TheShaderCache().SaveManifest(ShaderManifestKey(effect));
+	}
+
 	void ShaderObject::ReflectDXBC(std::vector<uint8_t> const & code, void** reflector)
 	{
 		D3DCompilerLoader::Instance().D3DReflect(code, reflector);
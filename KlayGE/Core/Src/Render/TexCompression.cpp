@@ -32,7 +32,9 @@
 #include <KlayGE/Context.hpp>
 #include <KlayGE/RenderFactory.hpp>
 #include <KlayGE/Texture.hpp>
+#include <KFL/Thread.hpp>
 
+#include <algorithm>
 #include <vector>
 #include <cstring>
 
@@ -48,36 +50,68 @@ namespace KlayGE
 		KFL_UNUSED(out_slice_pitch);
 		KFL_UNUSED(in_slice_pitch);
 
+		// Small enough to not be worth a task of its own
+		uint32_t const MIN_BLOCKS_PER_TASK = 64;
+
+		uint32_t const num_block_rows = (height + block_height_ - 1) / block_height_;
+		uint32_t const num_block_cols = (width + block_width_ - 1) / block_width_;
+		if ((0 == num_block_rows) || (0 == num_block_cols))
+		{
+			return;
+		}
+
+		task_scheduler& scheduler = Context::Instance().TaskScheduler();
+		uint32_t const grain_size = std::max((MIN_BLOCKS_PER_TASK + num_block_cols - 1) / num_block_cols,
+			num_block_rows / ((scheduler.num_workers() + 1) * 4));
+		scheduler.parallel_for(0, num_block_rows, grain_size,
+			[this, width, height, output, out_row_pitch, input, in_row_pitch, method, num_block_rows](
+				uint32_t first_row, uint32_t last_row)
+			{
+				// The last range always runs on the calling thread, so it can use this codec. Others need their own.
+				TexCompressionPtr clone;
+				TexCompression* codec = this;
+				if (last_row != num_block_rows)
+				{
+					clone = this->Clone();
+					codec = clone.get();
+				}
+
+				this->EncodeBlockRows(*codec, first_row, last_row, width, height, output, out_row_pitch,
+					input, in_row_pitch, method);
+			});
+	}
+
+	void TexCompression::EncodeBlockRows(TexCompression& codec, uint32_t first_row, uint32_t last_row,
+		uint32_t width, uint32_t height, void* output, uint32_t out_row_pitch,
+		void const * input, uint32_t in_row_pitch, TexCompressionMethod method) const
+	{
 		uint32_t const elem_size = NumFormatBytes(decoded_fmt_);
+		uint32_t const block_row_bytes = block_width_ * elem_size;
 
 		uint8_t const * src = static_cast<uint8_t const *>(input);
 
 		std::vector<uint8_t> uncompressed(block_width_ * block_height_ * elem_size);
-		for (uint32_t y_base = 0; y_base < height; y_base += block_height_)
+		for (uint32_t y_base = first_row * block_height_; y_base < last_row * block_height_; y_base += block_height_)
 		{
 			uint8_t* dst = static_cast<uint8_t*>(output) + (y_base / block_height_) * out_row_pitch;
+			uint32_t const block_h = std::min(block_height_, height - y_base);
 
 			for (uint32_t x_base = 0; x_base < width; x_base += block_width_)
 			{
-				for (uint32_t y = 0; y < block_height_; ++ y)
+				uint32_t const block_w = std::min(block_width_, width - x_base);
+				uint32_t const copy_bytes = block_w * elem_size;
+
+				if ((block_w < block_width_) || (block_h < block_height_))
 				{
-					for (uint32_t x = 0; x < block_width_; ++ x)
-					{
-						if ((x_base + x < width) && (y_base + y < height))
-						{
-							memcpy(&uncompressed[(y * block_width_ + x) * elem_size],
-								&src[(y_base + y) * in_row_pitch + (x_base + x) * elem_size],
-								elem_size);
-						}
-						else
-						{
-							memset(&uncompressed[(y * block_width_ + x) * elem_size],
-								0, elem_size);
-						}
-					}
+					memset(&uncompressed[0], 0, uncompressed.size());
+				}
+				for (uint32_t y = 0; y < block_h; ++ y)
+				{
+					memcpy(&uncompressed[y * block_row_bytes], &src[(y_base + y) * in_row_pitch + x_base * elem_size],
+						copy_bytes);
 				}
 
-				this->EncodeBlock(dst, &uncompressed[0], method);
+				codec.EncodeBlock(dst, &uncompressed[0], method);
 				dst += block_bytes_;
 			}
 		}
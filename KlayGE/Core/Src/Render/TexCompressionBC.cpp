@@ -39,11 +39,16 @@
 #include <KFL/Half.hpp>
 
 #include <vector>
+#include <cstdlib>
 #include <cstring>
 #include <boost/assert.hpp>
 #ifdef KLAYGE_COMPILER_MSVC
 	#include <intrin.h>		// For _BitScanForward
 #endif
+#if defined(KLAYGE_SSE2_SUPPORT) && !defined(KLAYGE_COMPILER_CLANGC2)
+	#define TEX_COMPRESSION_SSE2
+	#include <emmintrin.h>
+#endif
 
 #include <KlayGE/TexCompressionBC.hpp>
 #include "../Base/TableGen/Tables.hpp"
@@ -54,6 +59,31 @@ namespace
 
 	std::mutex singleton_mutex;
 
+	// The additive feedback generator behind rand() of glibc, seeded with 1. BC7 uses its own copy, so that the output
+	//  is the same on every platform, and doesn't touch the state of rand() the rest of the process uses.
+	uint32_t const BC7_RANDOM_MAX = 0x7FFFFFFF;
+
+	std::array<uint32_t, 31> const & BC7InitRandomState()
+	{
+		static std::array<uint32_t, 31> const init_state = []
+			{
+				std::array<uint32_t, 31> state;
+				state[0] = 1;
+				for (size_t i = 1; i < state.size(); ++ i)
+				{
+					state[i] = static_cast<uint32_t>(16807ULL * state[i - 1] % 2147483647);
+				}
+
+				// glibc throws away the first 310 numbers
+				for (uint32_t i = 0; i < 310; ++ i)
+				{
+					state[(i + 3) % state.size()] += state[i % state.size()];
+				}
+				return state;
+			}();
+		return init_state;
+	}
+
 	static int const BC67_PREC_WEIGHTS[][16] =
 	{
 		{ 0, 21, 43, 64 },
@@ -881,6 +911,55 @@ namespace
 			KFL_UNREACHABLE("Invalid rotation mode");
 		}
 	}
+
+	// dots[i] = argb[i].r() * dir_r + argb[i].g() * dir_g + argb[i].b() * dir_b, for the 16 pixels of a block.
+	//  Directions have to fit in 16 bits.
+	void DotBlockColors(int* dots, ARGBColor32 const * argb, int dir_r, int dir_g, int dir_b)
+	{
+#ifdef TEX_COMPRESSION_SSE2
+		// A pixel is b, g, r, a in memory. Widened to 16-bit, it's multiplied and pairwise added with
+		//  (dir_b, dir_g, dir_r, 0), then the two halves are added together.
+		__m128i const dir = _mm_set_epi16(0, static_cast<short>(dir_r), static_cast<short>(dir_g), static_cast<short>(dir_b),
+			0, static_cast<short>(dir_r), static_cast<short>(dir_g), static_cast<short>(dir_b));
+		__m128i const zero = _mm_setzero_si128();
+		for (int i = 0; i < 16; i += 4)
+		{
+			__m128i const clr = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&argb[i]));
+			__m128 const lo = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpacklo_epi8(clr, zero), dir));
+			__m128 const hi = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpackhi_epi8(clr, zero), dir));
+			__m128i const bg = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)));
+			__m128i const r = _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&dots[i]), _mm_add_epi32(bg, r));
+		}
+#else
+		for (int i = 0; i < 16; ++ i)
+		{
+			dots[i] = argb[i].r() * dir_r + argb[i].g() * dir_g + argb[i].b() * dir_b;
+		}
+#endif
+	}
+
+	bool IsUniformBlock(ARGBColor32 const * argb)
+	{
+#ifdef TEX_COMPRESSION_SSE2
+		__m128i const first = _mm_set1_epi32(static_cast<int>(argb[0].ARGB()));
+		__m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const *>(&argb[0])), first);
+		for (int i = 4; i < 16; i += 4)
+		{
+			eq = _mm_and_si128(eq, _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const *>(&argb[i])), first));
+		}
+		return 0xFFFF == _mm_movemask_epi8(eq);
+#else
+		for (int i = 1; i < 16; ++ i)
+		{
+			if (argb[i] != argb[0])
+			{
+				return false;
+			}
+		}
+		return true;
+#endif
+	}
 }
 
 namespace KlayGE
@@ -895,6 +974,11 @@ namespace KlayGE
 		decoded_fmt_ = EF_ARGB8;
 	}
 
+	TexCompressionPtr TexCompressionBC1::Clone() const
+	{
+		return MakeSharedPtr<TexCompressionBC1>();
+	}
+
 	void TexCompressionBC1::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
 		BOOST_ASSERT(output);
@@ -1000,10 +1084,7 @@ namespace KlayGE
 		int dirb = color[0].b() - color[1].b();
 
 		int dots[16];
-		for (int i = 0; i < 16; ++ i)
-		{
-			dots[i] = argb[i].r() * dirr + argb[i].g() * dirg + argb[i].b() * dirb;
-		}
+		DotBlockColors(dots, argb, dirr, dirg, dirb);
 
 		if (alpha)
 		{
@@ -1045,6 +1126,28 @@ namespace KlayGE
 			int half_point = (stops[3] + stops[2]) >> 1;
 			int c3_point = (stops[2] + stops[0]) >> 1;
 
+#ifdef TEX_COMPRESSION_SSE2
+			__m128i const v_c0_point = _mm_set1_epi32(c0_point);
+			__m128i const v_half_point = _mm_set1_epi32(half_point);
+			__m128i const v_c3_point = _mm_set1_epi32(c3_point);
+			__m128i const two = _mm_set1_epi32(2);
+			__m128i const three = _mm_set1_epi32(3);
+			int indices[16];
+			for (int i = 0; i < 16; i += 4)
+			{
+				__m128i const dot = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&dots[i]));
+				__m128i const lt_half = _mm_cmplt_epi32(dot, v_half_point);
+				__m128i const lower = _mm_sub_epi32(three, _mm_and_si128(_mm_cmplt_epi32(dot, v_c0_point), two));
+				__m128i const upper = _mm_and_si128(_mm_cmplt_epi32(dot, v_c3_point), two);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(&indices[i]),
+					_mm_or_si128(_mm_and_si128(lt_half, lower), _mm_andnot_si128(lt_half, upper)));
+			}
+			for (int i = 15; i >= 0; -- i)
+			{
+				mask <<= 2;
+				mask |= indices[i];
+			}
+#else
 			for (int i = 15; i >= 0; -- i)
 			{
 				mask <<= 2;
@@ -1059,6 +1162,7 @@ namespace KlayGE
 					mask |= (dot < c3_point) ? 2 : 0;
 				}
 			}
+#endif
 		}
 
 		return mask;
@@ -1175,11 +1279,14 @@ namespace KlayGE
 			}
 
 			// Pick colors at extreme points
+			int dots[16];
+			DotBlockColors(dots, argb, v_r, v_g, v_b);
+
 			int min_d = 0x7FFFFFFF, max_d = -min_d;
 			min_clr = max_clr = ARGBColor32(0, 0, 0, 0);
 			for (int i = 0; i < 16; ++ i)
 			{
-				int dot = argb[i].r() * v_r + argb[i].g() * v_g + argb[i].b() * v_b;
+				int const dot = dots[i];
 				if (dot < min_d)
 				{
 					min_d = dot;
@@ -1278,18 +1385,9 @@ namespace KlayGE
 	{
 		BOOST_ASSERT(argb);
 
-		// check if block is constant
-		uint32_t min32, max32;
-		min32 = max32 = argb[0].ARGB();
-		for (int i = 1; i < 16; ++ i)
-		{
-			min32 = std::min(min32, argb[i].ARGB());
-			max32 = std::max(max32, argb[i].ARGB());
-		}
-
 		uint32_t mask;
 		uint16_t max16, min16;
-		if (min32 != max32) // no constant color
+		if (!IsUniformBlock(argb)) // no constant color
 		{
 			ARGBColor32 max_clr, min_clr;
 			this->OptimizeColorsBlock(argb, min_clr, max_clr, method);
@@ -1385,6 +1483,11 @@ namespace KlayGE
 		decoded_fmt_ = EF_ARGB8;
 	}
 
+	TexCompressionPtr TexCompressionBC2::Clone() const
+	{
+		return MakeSharedPtr<TexCompressionBC2>();
+	}
+
 	void TexCompressionBC2::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
 		BOOST_ASSERT(output);
@@ -1439,6 +1542,11 @@ namespace KlayGE
 		decoded_fmt_ = EF_ARGB8;
 	}
 
+	TexCompressionPtr TexCompressionBC3::Clone() const
+	{
+		return MakeSharedPtr<TexCompressionBC3>();
+	}
+
 	void TexCompressionBC3::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
 		BOOST_ASSERT(output);
@@ -1488,6 +1596,11 @@ namespace KlayGE
 		decoded_fmt_ = EF_R8;
 	}
 
+	TexCompressionPtr TexCompressionBC4::Clone() const
+	{
+		return MakeSharedPtr<TexCompressionBC4>();
+	}
+
 	// Alpha block compression (this is easy for a change)
 	void TexCompressionBC4::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
@@ -1501,6 +1614,19 @@ namespace KlayGE
 
 		// find min/max color
 		int min, max;
+#ifdef TEX_COMPRESSION_SSE2
+		__m128i const r8 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(r));
+		__m128i v_min = _mm_min_epu8(r8, _mm_srli_si128(r8, 8));
+		__m128i v_max = _mm_max_epu8(r8, _mm_srli_si128(r8, 8));
+		v_min = _mm_min_epu8(v_min, _mm_srli_si128(v_min, 4));
+		v_max = _mm_max_epu8(v_max, _mm_srli_si128(v_max, 4));
+		v_min = _mm_min_epu8(v_min, _mm_srli_si128(v_min, 2));
+		v_max = _mm_max_epu8(v_max, _mm_srli_si128(v_max, 2));
+		v_min = _mm_min_epu8(v_min, _mm_srli_si128(v_min, 1));
+		v_max = _mm_max_epu8(v_max, _mm_srli_si128(v_max, 1));
+		min = _mm_cvtsi128_si32(v_min) & 0xFF;
+		max = _mm_cvtsi128_si32(v_max) & 0xFF;
+#else
 		min = max = r[0];
 
 		for (int i = 1; i < 16; ++ i)
@@ -1508,6 +1634,7 @@ namespace KlayGE
 			min = std::min<int>(min, r[i]);
 			max = std::max<int>(max, r[i]);
 		}
+#endif
 
 		// encode them
 		bc4.alpha_0 = static_cast<uint8_t>(max);
@@ -1520,9 +1647,45 @@ namespace KlayGE
 		int dist2 = dist * 2;
 		int bits = 0, mask = 0;
 
+#ifdef TEX_COMPRESSION_SSE2
+		// The same bit magic as below, on 8 values at a time. Everything fits in 16 bits.
+		int16_t indices[16];
+		{
+			__m128i const zero = _mm_setzero_si128();
+			__m128i const one = _mm_set1_epi16(1);
+			__m128i const two = _mm_set1_epi16(2);
+			__m128i const four = _mm_set1_epi16(4);
+			__m128i const seven = _mm_set1_epi16(7);
+			__m128i const v_bias = _mm_set1_epi16(static_cast<short>(bias));
+			__m128i const v_dist = _mm_set1_epi16(static_cast<short>(dist));
+			__m128i const v_dist2 = _mm_set1_epi16(static_cast<short>(dist2));
+			__m128i const v_dist4 = _mm_set1_epi16(static_cast<short>(dist4));
+			for (int i = 0; i < 2; ++ i)
+			{
+				__m128i a = _mm_sub_epi16(_mm_mullo_epi16(i ? _mm_unpackhi_epi8(r8, zero) : _mm_unpacklo_epi8(r8, zero),
+					seven), v_bias);
+				__m128i t = _mm_srai_epi16(_mm_sub_epi16(v_dist4, a), 15);
+				__m128i ind = _mm_and_si128(t, four);
+				a = _mm_sub_epi16(a, _mm_and_si128(v_dist4, t));
+				t = _mm_srai_epi16(_mm_sub_epi16(v_dist2, a), 15);
+				ind = _mm_add_epi16(ind, _mm_and_si128(t, two));
+				a = _mm_sub_epi16(a, _mm_and_si128(v_dist2, t));
+				t = _mm_srai_epi16(_mm_sub_epi16(v_dist, a), 15);
+				ind = _mm_add_epi16(ind, _mm_and_si128(t, one));
+
+				ind = _mm_and_si128(_mm_sub_epi16(zero, ind), seven);
+				ind = _mm_xor_si128(ind, _mm_and_si128(_mm_cmpgt_epi16(two, ind), one));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(&indices[i * 8]), ind);
+			}
+		}
+#endif
+
 		int dest = 0;
 		for (int i = 0; i < 16; ++ i)
 		{
+#ifdef TEX_COMPRESSION_SSE2
+			int const ind = indices[i];
+#else
 			int a = r[i] * 7 - bias;
 			int ind, t;
 
@@ -1533,6 +1696,7 @@ namespace KlayGE
 
 			ind = -ind & 7;
 			ind ^= (2 > ind);
+#endif
 
 			// write index
 			mask |= ind << bits;
@@ -1597,6 +1761,11 @@ namespace KlayGE
 		decoded_fmt_ = EF_GR8;
 	}
 
+	TexCompressionPtr TexCompressionBC5::Clone() const
+	{
+		return MakeSharedPtr<TexCompressionBC5>();
+	}
+
 	void TexCompressionBC5::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
 		BOOST_ASSERT(output);
@@ -1900,6 +2069,11 @@ namespace KlayGE
 		decoded_fmt_ = EF_ABGR16F;
 	}
 
+	TexCompressionPtr TexCompressionBC6U::Clone() const
+	{
+		return MakeSharedPtr<TexCompressionBC6U>();
+	}
+
 	void TexCompressionBC6U::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
 		KFL_UNUSED(output);
@@ -2154,6 +2328,11 @@ namespace KlayGE
 		decoded_fmt_ = EF_ABGR16F;
 	}
 
+	TexCompressionPtr TexCompressionBC6S::Clone() const
+	{
+		return MakeSharedPtr<TexCompressionBC6S>();
+	}
+
 	void TexCompressionBC6S::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
 		KFL_UNUSED(output);
@@ -2191,7 +2370,7 @@ namespace KlayGE
 	};
 
 	TexCompressionBC7::TexCompressionBC7()
-		: index_mode_(0)
+		: index_mode_(0), rand_state_(BC7InitRandomState()), rand_pos_(0)
 	{
 		block_width_ = block_height_ = 4;
 		block_depth_ = 1;
@@ -2199,6 +2378,11 @@ namespace KlayGE
 		decoded_fmt_ = EF_ARGB8;
 	}
 
+	TexCompressionPtr TexCompressionBC7::Clone() const
+	{
+		return MakeSharedPtr<TexCompressionBC7>();
+	}
+
 	void TexCompressionBC7::EncodeBlock(void* output, void const * input, TexCompressionMethod method)
 	{
 		BOOST_ASSERT(output);
@@ -2208,16 +2392,7 @@ namespace KlayGE
 
 		ARGBColor32 const * argb = static_cast<ARGBColor32 const *>(input);
 
-		bool uniform_block = true;
-		for (int i = 1; i < 16; ++ i)
-		{
-			if (argb[i] != argb[0])
-			{
-				uniform_block = false;
-				break;
-			}
-		}
-		if (uniform_block)
+		if (IsUniformBlock(argb))
 		{
 			this->PackBC7UniformBlock(output, argb[0]);
 			return;
@@ -2241,6 +2416,10 @@ namespace KlayGE
 			KFL_UNREACHABLE("Invalid compression method");
 		}
 
+		// Annealing of every block starts from the same seed, so the result doesn't depend on the order of blocks
+		rand_state_ = BC7InitRandomState();
+		rand_pos_ = 0;
+
 		RGBACluster block_cluster(argb, block_width_ * block_height_, GetPartition);
 		ShapeSelection selection = BoxSelection(block_cluster, metric);
 		BOOST_ASSERT(selection.selected_modes > 0);
@@ -2907,7 +3086,7 @@ namespace KlayGE
 		{
 			float4 const & p = pt ? p1 : p2;
 			float4& np = pt ? np1 : np2;
-			uint32_t const rdir = rand() & 0xF;
+			uint32_t const rdir = this->Random() & 0xF;
 
 			np = p;
 			if (has_pbits)
@@ -2939,8 +3118,8 @@ namespace KlayGE
 			return true;
 		}
 
-		size_t const p = static_cast<size_t>(exp(0.1f * static_cast<int64_t>(old_err - new_err) / temp) * RAND_MAX);
-		size_t const r = rand();
+		size_t const p = static_cast<size_t>(exp(0.1f * static_cast<int64_t>(old_err - new_err) / temp) * BC7_RANDOM_MAX);
+		size_t const r = this->Random();
 
 		return r < p;
 	}
@@ -3585,6 +3764,14 @@ namespace KlayGE
 		p2 = bp2;
 	}
 
+	uint32_t TexCompressionBC7::Random() const
+	{
+		uint32_t const front = (rand_pos_ + 3) % rand_state_.size();
+		rand_state_[front] += rand_state_[rand_pos_];
+		rand_pos_ = (rand_pos_ + 1) % rand_state_.size();
+		return rand_state_[front] >> 1;
+	}
+
 	uint64_t TexCompressionBC7::TryCompress(int mode, int simulated_annealing_steps, TexCompressionErrorMetric metric,
 			CompressParams& params, uint32_t shape_index, RGBACluster& cluster)
 	{
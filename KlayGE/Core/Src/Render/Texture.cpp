@@ -38,6 +38,7 @@
 #include <KFL/Util.hpp>
 #include <KlayGE/TexCompressionBC.hpp>
 #include <KlayGE/TexCompressionETC.hpp>
+#include <KlayGE/TextureStreaming.hpp>
 #include <KFL/Half.hpp>
 #include <KFL/Hash.hpp>
 
@@ -1076,158 +1077,385 @@ namespace
 	}
 
 
-	class TextureLoadingDesc : public ResLoadingDesc
+	struct TexData
 	{
-	private:
-		struct TexDesc
-		{
-			std::string res_name;
-			uint32_t access_hint;
+		Texture::TextureType type;
+		uint32_t width, height, depth;
+		uint32_t num_mipmaps;
+		uint32_t array_size;
+		ElementFormat format;
+		std::vector<ElementInitData> init_data;
+		std::vector<uint8_t> data_block;
+	};
 
-			struct TexData
-			{
-				Texture::TextureType type;
-				uint32_t width, height, depth;
-				uint32_t num_mipmaps;
-				uint32_t array_size;
-				ElementFormat format;
-				std::vector<ElementInitData> init_data;
-				std::vector<uint8_t> data_block;
-			};
-			std::shared_ptr<TexData> tex_data;
+	// The image info, with the type and format the texture will have on this device
+	void GetSupportedImageInfo(std::string const & res_name, TexData& tex_data)
+	{
+		{
+			uint32_t row_pitch, slice_pitch;
+			GetImageInfo(res_name, tex_data.type, tex_data.width, tex_data.height, tex_data.depth,
+				tex_data.num_mipmaps, tex_data.array_size, tex_data.format,
+				row_pitch, slice_pitch);
+		}
 
-			std::shared_ptr<TexturePtr> tex;
-		};
+		RenderFactory& rf = Context::Instance().RenderFactoryInstance();
+		RenderDeviceCaps const & caps = rf.RenderEngineInstance().DeviceCaps();
 
-	public:
-		TextureLoadingDesc(std::string const & res_name, uint32_t access_hint)
+		if ((Texture::TT_3D == tex_data.type) && (caps.max_texture_depth < tex_data.depth))
 		{
-			tex_desc_.res_name = res_name;
-			tex_desc_.access_hint = access_hint;
-			tex_desc_.tex_data = MakeSharedPtr<TexDesc::TexData>();
-			tex_desc_.tex = MakeSharedPtr<TexturePtr>();
+			tex_data.type = Texture::TT_2D;
+			tex_data.height *= tex_data.depth;
+			tex_data.depth = 1;
+			tex_data.num_mipmaps = 1;
+			tex_data.init_data.resize(1);
 		}
 
-		uint64_t Type() const override
+		uint32_t array_size = tex_data.array_size;
+		if (Texture::TT_Cube == tex_data.type)
 		{
-			static uint64_t const type = CT_HASH("TextureLoadingDesc");
-			return type;
+			array_size *= 6;
 		}
 
-		bool StateLess() const override
+		if (((EF_BC5 == tex_data.format) && !caps.texture_format_support(EF_BC5))
+			|| ((EF_BC5_SRGB == tex_data.format) && !caps.texture_format_support(EF_BC5_SRGB)))
 		{
-			return true;
+			if (IsSRGB(tex_data.format))
+			{
+				tex_data.format = EF_BC3_SRGB;
+			}
+			else
+			{
+				tex_data.format = EF_BC3;
+			}
 		}
-
-		virtual std::shared_ptr<void> CreateResource() override
+		if (((EF_BC4 == tex_data.format) && !caps.texture_format_support(EF_BC4))
+			|| ((EF_BC4_SRGB == tex_data.format) && !caps.texture_format_support(EF_BC4_SRGB)))
 		{
-			TexDesc::TexData& tex_data = *tex_desc_.tex_data;
-
+			if (IsSRGB(tex_data.format))
 			{
-				uint32_t row_pitch, slice_pitch;
-				GetImageInfo(tex_desc_.res_name, tex_data.type, tex_data.width, tex_data.height, tex_data.depth,
-					tex_data.num_mipmaps, tex_data.array_size, tex_data.format,
-					row_pitch, slice_pitch);
+				tex_data.format = EF_BC1_SRGB;
 			}
+			else
+			{
+				tex_data.format = EF_BC1;
+			}
+		}
 
-			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
-			RenderDeviceCaps const & caps = rf.RenderEngineInstance().DeviceCaps();
-
-			if ((Texture::TT_3D == tex_data.type) && (caps.max_texture_depth < tex_data.depth))
+		static ElementFormat const convert_fmts[][2] =
+		{
+			{ EF_BC1, EF_ARGB8 },
+			{ EF_BC1_SRGB, EF_ARGB8_SRGB },
+			{ EF_BC2, EF_ARGB8 },
+			{ EF_BC2_SRGB, EF_ARGB8_SRGB },
+			{ EF_BC3, EF_ARGB8 },
+			{ EF_BC3_SRGB, EF_ARGB8_SRGB },
+			{ EF_BC4, EF_R8 },
+			{ EF_BC4_SRGB, EF_R8 },
+			{ EF_SIGNED_BC4, EF_SIGNED_R8 },
+			{ EF_BC5, EF_GR8 },
+			{ EF_BC5_SRGB, EF_GR8 },
+			{ EF_SIGNED_BC5, EF_SIGNED_GR8 },
+			{ EF_BC6, EF_ABGR16F },
+			{ EF_SIGNED_BC6, EF_ABGR16F },
+			{ EF_BC7, EF_ARGB8 },
+			{ EF_BC7_SRGB, EF_ARGB8 },
+			{ EF_ETC1, EF_ARGB8 },
+			{ EF_ETC2_BGR8, EF_ARGB8 },
+			{ EF_ETC2_BGR8_SRGB, EF_ARGB8_SRGB },
+			{ EF_ETC2_A1BGR8, EF_ARGB8 },
+			{ EF_ETC2_A1BGR8_SRGB, EF_ARGB8_SRGB },
+			{ EF_ETC2_ABGR8, EF_ARGB8 },
+			{ EF_ETC2_ABGR8_SRGB, EF_ARGB8_SRGB },
+			{ EF_R8, EF_ARGB8 },
+			{ EF_SIGNED_R8, EF_SIGNED_ABGR8 },
+			{ EF_GR8, EF_ARGB8 },
+			{ EF_SIGNED_GR8, EF_SIGNED_ABGR8 },
+			{ EF_ARGB8_SRGB, EF_ARGB8 },
+			{ EF_ARGB8, EF_ABGR8 },
+			{ EF_R16, EF_R16F },
+			{ EF_R16F, EF_R8 },
+		};
+		while (!caps.texture_format_support(tex_data.format))
+		{
+			bool found = false;
+			for (size_t i = 0; i < std::size(convert_fmts); ++ i)
 			{
-				tex_data.type = Texture::TT_2D;
-				tex_data.height *= tex_data.depth;
-				tex_data.depth = 1;
-				tex_data.num_mipmaps = 1;
-				tex_data.init_data.resize(1);
+				if (convert_fmts[i][0] == tex_data.format)
+				{
+					tex_data.format = convert_fmts[i][1];
+					found = true;
+					break;
+				}
 			}
 
-			uint32_t array_size = tex_data.array_size;
-			if (Texture::TT_Cube == tex_data.type)
+			if (!found)
 			{
-				array_size *= 6;
+				LogError("%s's format (%ld) is not supported.",
+					res_name.c_str(), tex_data.format);
+				break;
 			}
+		}
+	}
+
+	// Loads all the sub-resources, converted to a format this device supports
+	void LoadSupportedImage(std::string const & res_name, TexData& tex_data)
+	{
+		LoadTexture(res_name, tex_data.type,
+			tex_data.width, tex_data.height, tex_data.depth,
+			tex_data.num_mipmaps, tex_data.array_size, tex_data.format,
+			tex_data.init_data, tex_data.data_block);
+
+		RenderFactory& rf = Context::Instance().RenderFactoryInstance();
+		RenderDeviceCaps const & caps = rf.RenderEngineInstance().DeviceCaps();
+		if ((Texture::TT_3D == tex_data.type) && (caps.max_texture_depth < tex_data.depth))
+		{
+			tex_data.type = Texture::TT_2D;
+			tex_data.height *= tex_data.depth;
+			tex_data.depth = 1;
+			tex_data.num_mipmaps = 1;
+			tex_data.init_data.resize(1);
+		}
+
+		uint32_t array_size = tex_data.array_size;
+		if (Texture::TT_Cube == tex_data.type)
+		{
+			array_size *= 6;
+		}
 
-			if (((EF_BC5 == tex_data.format) && !caps.texture_format_support(EF_BC5))
-				|| ((EF_BC5_SRGB == tex_data.format) && !caps.texture_format_support(EF_BC5_SRGB)))
+		if (((EF_BC5 == tex_data.format) && !caps.texture_format_support(EF_BC5))
+			|| ((EF_BC5_SRGB == tex_data.format) && !caps.texture_format_support(EF_BC5_SRGB)))
+		{
+			BC1Block tmp;
+			for (size_t i = 0; i < tex_data.init_data.size(); ++ i)
 			{
-				if (IsSRGB(tex_data.format))
-				{
-					tex_data.format = EF_BC3_SRGB;
-				}
-				else
+				for (size_t j = 0; j < tex_data.init_data[i].slice_pitch; j += sizeof(BC4Block) * 2)
 				{
-					tex_data.format = EF_BC3;
+					char* p = static_cast<char*>(const_cast<void*>(tex_data.init_data[i].data)) + j;
+
+					BC4ToBC1G(tmp, *reinterpret_cast<BC4Block const *>(p + sizeof(BC4Block)));
+					std::memcpy(p + sizeof(BC4Block), &tmp, sizeof(BC1Block));
 				}
 			}
-			if (((EF_BC4 == tex_data.format) && !caps.texture_format_support(EF_BC4))
-				|| ((EF_BC4_SRGB == tex_data.format) && !caps.texture_format_support(EF_BC4_SRGB)))
+
+			if (IsSRGB(tex_data.format))
 			{
-				if (IsSRGB(tex_data.format))
-				{
-					tex_data.format = EF_BC1_SRGB;
-				}
-				else
+				tex_data.format = EF_BC3_SRGB;
+			}
+			else
+			{
+				tex_data.format = EF_BC3;
+			}
+		}
+		if (((EF_BC4 == tex_data.format) && !caps.texture_format_support(EF_BC4))
+			|| ((EF_BC4_SRGB == tex_data.format) && !caps.texture_format_support(EF_BC4_SRGB)))
+		{
+			BC1Block tmp;
+			for (size_t i = 0; i < tex_data.init_data.size(); ++ i)
+			{
+				for (size_t j = 0; j < tex_data.init_data[i].slice_pitch; j += sizeof(BC4Block))
 				{
-					tex_data.format = EF_BC1;
+					char* p = static_cast<char*>(const_cast<void*>(tex_data.init_data[i].data)) + j;
+
+					BC4ToBC1G(tmp, *reinterpret_cast<BC4Block const *>(p));
+					std::memcpy(p, &tmp, sizeof(BC1Block));
 				}
 			}
 
-			static ElementFormat const convert_fmts[][2] =
+			if (IsSRGB(tex_data.format))
 			{
-				{ EF_BC1, EF_ARGB8 },
-				{ EF_BC1_SRGB, EF_ARGB8_SRGB },
-				{ EF_BC2, EF_ARGB8 },
-				{ EF_BC2_SRGB, EF_ARGB8_SRGB },
-				{ EF_BC3, EF_ARGB8 },
-				{ EF_BC3_SRGB, EF_ARGB8_SRGB },
-				{ EF_BC4, EF_R8 },
-				{ EF_BC4_SRGB, EF_R8 },
-				{ EF_SIGNED_BC4, EF_SIGNED_R8 },
-				{ EF_BC5, EF_GR8 },
-				{ EF_BC5_SRGB, EF_GR8 },
-				{ EF_SIGNED_BC5, EF_SIGNED_GR8 },
-				{ EF_BC6, EF_ABGR16F },
-				{ EF_SIGNED_BC6, EF_ABGR16F },
-				{ EF_BC7, EF_ARGB8 },
-				{ EF_BC7_SRGB, EF_ARGB8 },
-				{ EF_ETC1, EF_ARGB8 },
-				{ EF_ETC2_BGR8, EF_ARGB8 },
-				{ EF_ETC2_BGR8_SRGB, EF_ARGB8_SRGB },
-				{ EF_ETC2_A1BGR8, EF_ARGB8 },
-				{ EF_ETC2_A1BGR8_SRGB, EF_ARGB8_SRGB },
-				{ EF_ETC2_ABGR8, EF_ARGB8 },
-				{ EF_ETC2_ABGR8_SRGB, EF_ARGB8_SRGB },
-				{ EF_R8, EF_ARGB8 },
-				{ EF_SIGNED_R8, EF_SIGNED_ABGR8 },
-				{ EF_GR8, EF_ARGB8 },
-				{ EF_SIGNED_GR8, EF_SIGNED_ABGR8 },
-				{ EF_ARGB8_SRGB, EF_ARGB8 },
-				{ EF_ARGB8, EF_ABGR8 },
-				{ EF_R16, EF_R16F },
-				{ EF_R16F, EF_R8 },
-			};
-			while (!caps.texture_format_support(tex_data.format))
+				tex_data.format = EF_BC1_SRGB;
+			}
+			else
 			{
-				bool found = false;
-				for (size_t i = 0; i < std::size(convert_fmts); ++ i)
+				tex_data.format = EF_BC1;
+			}
+		}
+
+		static ElementFormat const convert_fmts[][2] =
+		{
+			{ EF_BC1, EF_ARGB8 },
+			{ EF_BC1_SRGB, EF_ARGB8_SRGB },
+			{ EF_BC2, EF_ARGB8 },
+			{ EF_BC2_SRGB, EF_ARGB8_SRGB },
+			{ EF_BC3, EF_ARGB8 },
+			{ EF_BC3_SRGB, EF_ARGB8_SRGB },
+			{ EF_BC4, EF_R8 },
+			{ EF_BC4_SRGB, EF_R8 },
+			{ EF_SIGNED_BC4, EF_SIGNED_R8 },
+			{ EF_BC5, EF_GR8 },
+			{ EF_BC5_SRGB, EF_GR8 },
+			{ EF_SIGNED_BC5, EF_SIGNED_GR8 },
+			{ EF_BC6, EF_ABGR16F },
+			{ EF_SIGNED_BC6, EF_ABGR16F },
+			{ EF_BC7, EF_ARGB8 },
+			{ EF_BC7_SRGB, EF_ARGB8 },
+			{ EF_ETC1, EF_ARGB8 },
+			{ EF_ETC2_BGR8, EF_ARGB8 },
+			{ EF_ETC2_BGR8_SRGB, EF_ARGB8_SRGB },
+			{ EF_ETC2_A1BGR8, EF_ARGB8 },
+			{ EF_ETC2_A1BGR8_SRGB, EF_ARGB8_SRGB },
+			{ EF_ETC2_ABGR8, EF_ARGB8 },
+			{ EF_ETC2_ABGR8_SRGB, EF_ARGB8_SRGB },
+			{ EF_R8, EF_ARGB8 },
+			{ EF_SIGNED_R8, EF_SIGNED_ABGR8 },
+			{ EF_GR8, EF_ARGB8 },
+			{ EF_SIGNED_GR8, EF_SIGNED_ABGR8 },
+			{ EF_ARGB8_SRGB, EF_ARGB8 },
+			{ EF_ARGB8, EF_ABGR8 },
+			{ EF_R16, EF_R16F },
+			{ EF_R16F, EF_R8 },
+		};
+		while (!caps.texture_format_support(tex_data.format))
+		{
+			bool found = false;
+			for (size_t i = 0; i < std::size(convert_fmts); ++ i)
+			{
+				if (convert_fmts[i][0] == tex_data.format)
 				{
-					if (convert_fmts[i][0] == tex_data.format)
+					uint32_t const src_elem_size = NumFormatBytes(convert_fmts[i][0]);
+					uint32_t const dst_elem_size = NumFormatBytes(convert_fmts[i][1]);
+
+					bool needs_new_data_block = (src_elem_size < dst_elem_size)
+						|| (IsCompressedFormat(convert_fmts[i][0]) && !IsCompressedFormat(convert_fmts[i][1]));
+
+					std::vector<uint8_t> new_data_block;
+					std::vector<uint32_t> new_sub_res_start;
+					if (needs_new_data_block)
 					{
-						tex_data.format = convert_fmts[i][1];
-						found = true;
-						break;
+						uint32_t new_data_block_size = 0;
+						new_sub_res_start.resize(array_size * tex_data.num_mipmaps);
+
+						for (size_t index = 0; index < array_size; ++ index)
+						{
+							uint32_t width = tex_data.width;
+							uint32_t height = tex_data.height;
+							for (size_t level = 0; level < tex_data.num_mipmaps; ++ level)
+							{
+								uint32_t slice_pitch;
+								if (IsCompressedFormat(convert_fmts[i][1]))
+								{
+									slice_pitch = ((width + 3) & ~3) * (height + 3) / 4 * dst_elem_size;
+								}
+								else
+								{
+									slice_pitch = width * height * dst_elem_size;
+								}
+
+								size_t sub_res = index * tex_data.num_mipmaps + level;
+								new_sub_res_start[sub_res] = new_data_block_size;
+								new_data_block_size += slice_pitch;
+
+								width = std::max<uint32_t>(1U, width / 2);
+								height = std::max<uint32_t>(1U, height / 2);
+							}
+						}
+
+						new_data_block.resize(new_data_block_size);
 					}
-				}
 
-				if (!found)
-				{
-					LogError("%s's format (%ld) is not supported.",
-						tex_desc_.res_name.c_str(), tex_data.format);
+					for (size_t index = 0; index < array_size; ++ index)
+					{
+						uint32_t width = tex_data.width;
+						uint32_t height = tex_data.height;
+						uint32_t depth = tex_data.depth;
+						for (size_t level = 0; level < tex_data.num_mipmaps; ++ level)
+						{
+							uint32_t row_pitch, slice_pitch;
+							if (IsCompressedFormat(convert_fmts[i][1]))
+							{
+								row_pitch = ((width + 3) & ~3) * dst_elem_size;
+								slice_pitch = (height + 3) / 4 * row_pitch;
+							}
+							else
+							{
+								row_pitch = width * dst_elem_size;
+								slice_pitch = height * row_pitch;
+							}
+
+							size_t sub_res = index * tex_data.num_mipmaps + level;
+							uint8_t* sub_data_block;
+							if (needs_new_data_block)
+							{
+								sub_data_block = &new_data_block[new_sub_res_start[sub_res]];
+							}
+							else
+							{
+								sub_data_block = static_cast<uint8_t*>(
+									const_cast<void*>(tex_data.init_data[sub_res].data));
+							}
+							ResizeTexture(sub_data_block, row_pitch, slice_pitch,
+								convert_fmts[i][1], width, height, depth,
+								tex_data.init_data[sub_res].data,
+								tex_data.init_data[sub_res].row_pitch,
+								tex_data.init_data[sub_res].slice_pitch,
+								convert_fmts[i][0], width, height, depth, false);
+
+							width = std::max<uint32_t>(1U, width / 2);
+							height = std::max<uint32_t>(1U, height / 2);
+							depth = std::max<uint32_t>(1U, depth / 2);
+
+							tex_data.init_data[sub_res].row_pitch = row_pitch;
+							tex_data.init_data[sub_res].slice_pitch = slice_pitch;
+							tex_data.init_data[sub_res].data = sub_data_block;
+						}
+					}
+
+					if (needs_new_data_block)
+					{
+						tex_data.data_block.swap(new_data_block);
+					}
+
+					tex_data.format = convert_fmts[i][1];
+					found = true;
 					break;
 				}
 			}
 
+			if (!found)
+			{
+				break;
+			}
+		}
+	}
+
+
+	class TextureLoadingDesc : public ResLoadingDesc
+	{
+	private:
+		struct TexDesc
+		{
+			std::string res_name;
+			uint32_t access_hint;
+
+			std::shared_ptr<TexData> tex_data;
+
+			std::shared_ptr<TexturePtr> tex;
+		};
+
+	public:
+		TextureLoadingDesc(std::string const & res_name, uint32_t access_hint)
+		{
+			tex_desc_.res_name = res_name;
+			tex_desc_.access_hint = access_hint;
+			tex_desc_.tex_data = MakeSharedPtr<TexData>();
+			tex_desc_.tex = MakeSharedPtr<TexturePtr>();
+		}
+
+		uint64_t Type() const override
+		{
+			static uint64_t const type = CT_HASH("TextureLoadingDesc");
+			return type;
+		}
+
+		bool StateLess() const override
+		{
+			return true;
+		}
+
+		virtual std::shared_ptr<void> CreateResource() override
+		{
+			GetSupportedImageInfo(tex_desc_.res_name, *tex_desc_.tex_data);
+
 			*tex_desc_.tex = this->CreateTexture();
 			return *tex_desc_.tex;
 		}
@@ -1256,6 +1484,12 @@ namespace
 			return true;
 		}
 
+		// Only touches its own data, and creates the HW resource here only on devices that can do it from any thread
+		bool ConcurrentSubThreadStage() const override
+		{
+			return true;
+		}
+
 		bool Match(ResLoadingDesc const & rhs) const override
 		{
 			if (this->Type() == rhs.Type())
@@ -1267,6 +1501,14 @@ namespace
 			return false;
 		}
 
+		size_t Hash() const override
+		{
+			size_t seed = static_cast<size_t>(this->Type());
+			HashRange(seed, tex_desc_.res_name.begin(), tex_desc_.res_name.end());
+			HashCombine(seed, tex_desc_.access_hint);
+			return seed;
+		}
+
 		void CopyDataFrom(ResLoadingDesc const & rhs) override
 		{
 			BOOST_ASSERT(this->Type() == rhs.Type());
@@ -1291,225 +1533,10 @@ namespace
 	private:
 		void LoadDDS()
 		{
-			TexDesc::TexData& tex_data = *tex_desc_.tex_data;
-
-			LoadTexture(tex_desc_.res_name, tex_data.type,
-				tex_data.width, tex_data.height, tex_data.depth,
-				tex_data.num_mipmaps, tex_data.array_size, tex_data.format,
-				tex_data.init_data, tex_data.data_block);
+			LoadSupportedImage(tex_desc_.res_name, *tex_desc_.tex_data);
 
 			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
 			RenderDeviceCaps const & caps = rf.RenderEngineInstance().DeviceCaps();
-			if ((Texture::TT_3D == tex_data.type) && (caps.max_texture_depth < tex_data.depth))
-			{
-				tex_data.type = Texture::TT_2D;
-				tex_data.height *= tex_data.depth;
-				tex_data.depth = 1;
-				tex_data.num_mipmaps = 1;
-				tex_data.init_data.resize(1);
-			}
-
-			uint32_t array_size = tex_data.array_size;
-			if (Texture::TT_Cube == tex_data.type)
-			{
-				array_size *= 6;
-			}
-
-			if (((EF_BC5 == tex_data.format) && !caps.texture_format_support(EF_BC5))
-				|| ((EF_BC5_SRGB == tex_data.format) && !caps.texture_format_support(EF_BC5_SRGB)))
-			{
-				BC1Block tmp;
-				for (size_t i = 0; i < tex_data.init_data.size(); ++ i)
-				{
-					for (size_t j = 0; j < tex_data.init_data[i].slice_pitch; j += sizeof(BC4Block) * 2)
-					{
-						char* p = static_cast<char*>(const_cast<void*>(tex_data.init_data[i].data)) + j;
-
-						BC4ToBC1G(tmp, *reinterpret_cast<BC4Block const *>(p + sizeof(BC4Block)));
-						std::memcpy(p + sizeof(BC4Block), &tmp, sizeof(BC1Block));
-					}
-				}
-
-				if (IsSRGB(tex_data.format))
-				{
-					tex_data.format = EF_BC3_SRGB;
-				}
-				else
-				{
-					tex_data.format = EF_BC3;
-				}
-			}
-			if (((EF_BC4 == tex_data.format) && !caps.texture_format_support(EF_BC4))
-				|| ((EF_BC4_SRGB == tex_data.format) && !caps.texture_format_support(EF_BC4_SRGB)))
-			{
-				BC1Block tmp;
-				for (size_t i = 0; i < tex_data.init_data.size(); ++ i)
-				{
-					for (size_t j = 0; j < tex_data.init_data[i].slice_pitch; j += sizeof(BC4Block))
-					{
-						char* p = static_cast<char*>(const_cast<void*>(tex_data.init_data[i].data)) + j;
-
-						BC4ToBC1G(tmp, *reinterpret_cast<BC4Block const *>(p));
-						std::memcpy(p, &tmp, sizeof(BC1Block));
-					}
-				}
-
-				if (IsSRGB(tex_data.format))
-				{
-					tex_data.format = EF_BC1_SRGB;
-				}
-				else
-				{
-					tex_data.format = EF_BC1;
-				}
-			}
-
-			static ElementFormat const convert_fmts[][2] =
-			{
-				{ EF_BC1, EF_ARGB8 },
-				{ EF_BC1_SRGB, EF_ARGB8_SRGB },
-				{ EF_BC2, EF_ARGB8 },
-				{ EF_BC2_SRGB, EF_ARGB8_SRGB },
-				{ EF_BC3, EF_ARGB8 },
-				{ EF_BC3_SRGB, EF_ARGB8_SRGB },
-				{ EF_BC4, EF_R8 },
-				{ EF_BC4_SRGB, EF_R8 },
-				{ EF_SIGNED_BC4, EF_SIGNED_R8 },
-				{ EF_BC5, EF_GR8 },
-				{ EF_BC5_SRGB, EF_GR8 },
-				{ EF_SIGNED_BC5, EF_SIGNED_GR8 },
-				{ EF_BC6, EF_ABGR16F },
-				{ EF_SIGNED_BC6, EF_ABGR16F },
-				{ EF_BC7, EF_ARGB8 },
-				{ EF_BC7_SRGB, EF_ARGB8 },
-				{ EF_ETC1, EF_ARGB8 },
-				{ EF_ETC2_BGR8, EF_ARGB8 },
-				{ EF_ETC2_BGR8_SRGB, EF_ARGB8_SRGB },
-				{ EF_ETC2_A1BGR8, EF_ARGB8 },
-				{ EF_ETC2_A1BGR8_SRGB, EF_ARGB8_SRGB },
-				{ EF_ETC2_ABGR8, EF_ARGB8 },
-				{ EF_ETC2_ABGR8_SRGB, EF_ARGB8_SRGB },
-				{ EF_R8, EF_ARGB8 },
-				{ EF_SIGNED_R8, EF_SIGNED_ABGR8 },
-				{ EF_GR8, EF_ARGB8 },
-				{ EF_SIGNED_GR8, EF_SIGNED_ABGR8 },
-				{ EF_ARGB8_SRGB, EF_ARGB8 },
-				{ EF_ARGB8, EF_ABGR8 },
-				{ EF_R16, EF_R16F },
-				{ EF_R16F, EF_R8 },
-			};
-			while (!caps.texture_format_support(tex_data.format))
-			{
-				bool found = false;
-				for (size_t i = 0; i < std::size(convert_fmts); ++ i)
-				{
-					if (convert_fmts[i][0] == tex_data.format)
-					{
-						uint32_t const src_elem_size = NumFormatBytes(convert_fmts[i][0]);
-						uint32_t const dst_elem_size = NumFormatBytes(convert_fmts[i][1]);
-
-						bool needs_new_data_block = (src_elem_size < dst_elem_size)
-							|| (IsCompressedFormat(convert_fmts[i][0]) && !IsCompressedFormat(convert_fmts[i][1]));
-
-						std::vector<uint8_t> new_data_block;
-						std::vector<uint32_t> new_sub_res_start;
-						if (needs_new_data_block)
-						{
-							uint32_t new_data_block_size = 0;
-							new_sub_res_start.resize(array_size * tex_data.num_mipmaps);
-
-							for (size_t index = 0; index < array_size; ++ index)
-							{
-								uint32_t width = tex_data.width;
-								uint32_t height = tex_data.height;
-								for (size_t level = 0; level < tex_data.num_mipmaps; ++ level)
-								{
-									uint32_t slice_pitch;
-									if (IsCompressedFormat(convert_fmts[i][1]))
-									{
-										slice_pitch = ((width + 3) & ~3) * (height + 3) / 4 * dst_elem_size;
-									}
-									else
-									{
-										slice_pitch = width * height * dst_elem_size;
-									}
-
-									size_t sub_res = index * tex_data.num_mipmaps + level;
-									new_sub_res_start[sub_res] = new_data_block_size;
-									new_data_block_size += slice_pitch;
-
-									width = std::max<uint32_t>(1U, width / 2);
-									height = std::max<uint32_t>(1U, height / 2);
-								}
-							}
-
-							new_data_block.resize(new_data_block_size);
-						}
-
-						for (size_t index = 0; index < array_size; ++ index)
-						{
-							uint32_t width = tex_data.width;
-							uint32_t height = tex_data.height;
-							uint32_t depth = tex_data.depth;
-							for (size_t level = 0; level < tex_data.num_mipmaps; ++ level)
-							{
-								uint32_t row_pitch, slice_pitch;
-								if (IsCompressedFormat(convert_fmts[i][1]))
-								{
-									row_pitch = ((width + 3) & ~3) * dst_elem_size;
-									slice_pitch = (height + 3) / 4 * row_pitch;
-								}
-								else
-								{
-									row_pitch = width * dst_elem_size;
-									slice_pitch = height * row_pitch;
-								}
-
-								size_t sub_res = index * tex_data.num_mipmaps + level;
-								uint8_t* sub_data_block;
-								if (needs_new_data_block)
-								{
-									sub_data_block = &new_data_block[new_sub_res_start[sub_res]];
-								}
-								else
-								{
-									sub_data_block = static_cast<uint8_t*>(
-										const_cast<void*>(tex_data.init_data[sub_res].data));
-								}
-								ResizeTexture(sub_data_block, row_pitch, slice_pitch,
-									convert_fmts[i][1], width, height, depth,
-									tex_data.init_data[sub_res].data,
-									tex_data.init_data[sub_res].row_pitch,
-									tex_data.init_data[sub_res].slice_pitch,
-									convert_fmts[i][0], width, height, depth, false);
-
-								width = std::max<uint32_t>(1U, width / 2);
-								height = std::max<uint32_t>(1U, height / 2);
-								depth = std::max<uint32_t>(1U, depth / 2);
-
-								tex_data.init_data[sub_res].row_pitch = row_pitch;
-								tex_data.init_data[sub_res].slice_pitch = slice_pitch;
-								tex_data.init_data[sub_res].data = sub_data_block;
-							}
-						}
-
-						if (needs_new_data_block)
-						{
-							tex_data.data_block.swap(new_data_block);
-						}
-
-						tex_data.format = convert_fmts[i][1];
-						found = true;
-						break;
-					}
-				}
-
-				if (!found)
-				{
-					break;
-				}
-			}
-
 			if (caps.multithread_res_creating_support)
 			{
 				this->MainThreadStageNoLock();
@@ -1518,7 +1545,7 @@ namespace
 
 		TexturePtr CreateTexture()
 		{
-			TexDesc::TexData const & tex_data = *tex_desc_.tex_data;
+			TexData const & tex_data = *tex_desc_.tex_data;
 
 			TexturePtr texture;
 			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
@@ -1565,6 +1592,136 @@ namespace
 		TexDesc tex_desc_;
 		std::mutex main_thread_stage_mutex_;
 	};
+
+	class StreamedTextureLoadingDesc : public ResLoadingDesc
+	{
+	private:
+		struct TexDesc
+		{
+			std::string res_name;
+			uint32_t access_hint;
+
+			std::shared_ptr<TexData> tex_data;
+
+			std::shared_ptr<StreamedTexturePtr> tex;
+		};
+
+	public:
+		StreamedTextureLoadingDesc(std::string const & res_name, uint32_t access_hint)
+		{
+			tex_desc_.res_name = res_name;
+			tex_desc_.access_hint = access_hint;
+			tex_desc_.tex_data = MakeSharedPtr<TexData>();
+			tex_desc_.tex = MakeSharedPtr<StreamedTexturePtr>();
+		}
+
+		uint64_t Type() const override
+		{
+			static uint64_t const type = CT_HASH("StreamedTextureLoadingDesc");
+			return type;
+		}
+
+		bool StateLess() const override
+		{
+			return true;
+		}
+
+		std::shared_ptr<void> CreateResource() override
+		{
+			TexData& tex_data = *tex_desc_.tex_data;
+			GetSupportedImageInfo(tex_desc_.res_name, tex_data);
+
+			*tex_desc_.tex = MakeSharedPtr<StreamedTexture>(tex_data.type, tex_data.width, tex_data.height, tex_data.depth,
+				tex_data.num_mipmaps, tex_data.array_size, tex_data.format, tex_desc_.access_hint);
+			return *tex_desc_.tex;
+		}
+
+		void SubThreadStage() override
+		{
+			std::lock_guard<std::mutex> lock(main_thread_stage_mutex_);
+
+			StreamedTexturePtr const & tex = *tex_desc_.tex;
+			if (tex->SourceDataReady())
+			{
+				return;
+			}
+
+			TexData& tex_data = *tex_desc_.tex_data;
+			LoadSupportedImage(tex_desc_.res_name, tex_data);
+			tex->SourceData(std::move(tex_data.init_data), std::move(tex_data.data_block));
+
+			RenderFactory& rf = Context::Instance().RenderFactoryInstance();
+			RenderDeviceCaps const & caps = rf.RenderEngineInstance().DeviceCaps();
+			if (caps.multithread_res_creating_support)
+			{
+				tex->CreateHWResource();
+			}
+		}
+
+		void MainThreadStage() override
+		{
+			std::lock_guard<std::mutex> lock(main_thread_stage_mutex_);
+
+			StreamedTexturePtr const & tex = *tex_desc_.tex;
+			tex->CreateHWResource();
+			TextureStreamingManager::Instance().Add(tex);
+		}
+
+		bool HasSubThreadStage() const override
+		{
+			return true;
+		}
+
+		// Same as TextureLoadingDesc
+		bool ConcurrentSubThreadStage() const override
+		{
+			return true;
+		}
+
+		bool Match(ResLoadingDesc const & rhs) const override
+		{
+			if (this->Type() == rhs.Type())
+			{
+				StreamedTextureLoadingDesc const & stld = static_cast<StreamedTextureLoadingDesc const &>(rhs);
+				return (tex_desc_.res_name == stld.tex_desc_.res_name)
+					&& (tex_desc_.access_hint == stld.tex_desc_.access_hint);
+			}
+			return false;
+		}
+
+		size_t Hash() const override
+		{
+			size_t seed = static_cast<size_t>(this->Type());
+			HashRange(seed, tex_desc_.res_name.begin(), tex_desc_.res_name.end());
+			HashCombine(seed, tex_desc_.access_hint);
+			return seed;
+		}
+
+		void CopyDataFrom(ResLoadingDesc const & rhs) override
+		{
+			BOOST_ASSERT(this->Type() == rhs.Type());
+
+			StreamedTextureLoadingDesc const & stld = static_cast<StreamedTextureLoadingDesc const &>(rhs);
+			tex_desc_.res_name = stld.tex_desc_.res_name;
+			tex_desc_.access_hint = stld.tex_desc_.access_hint;
+			tex_desc_.tex_data = stld.tex_desc_.tex_data;
+			tex_desc_.tex = stld.tex_desc_.tex;
+		}
+
+		std::shared_ptr<void> CloneResourceFrom(std::shared_ptr<void> const & resource) override
+		{
+			return resource;
+		}
+
+		std::shared_ptr<void> Resource() const override
+		{
+			return *tex_desc_.tex;
+		}
+
+	private:
+		TexDesc tex_desc_;
+		std::mutex main_thread_stage_mutex_;
+	};
 }
 
 namespace KlayGE
@@ -2199,6 +2356,16 @@ namespace KlayGE
 		return ResLoader::Instance().ASyncQueryT<Texture>(MakeSharedPtr<TextureLoadingDesc>(tex_name, access_hint));
 	}
 
+	StreamedTexturePtr SyncLoadStreamedTexture(std::string const & tex_name, uint32_t access_hint)
+	{
+		return ResLoader::Instance().SyncQueryT<StreamedTexture>(MakeSharedPtr<StreamedTextureLoadingDesc>(tex_name, access_hint));
+	}
+
+	StreamedTexturePtr ASyncLoadStreamedTexture(std::string const & tex_name, uint32_t access_hint)
+	{
+		return ResLoader::Instance().ASyncQueryT<StreamedTexture>(MakeSharedPtr<StreamedTextureLoadingDesc>(tex_name, access_hint));
+	}
+
 	void SaveTexture(std::string const & tex_name, Texture::TextureType type,
 		uint32_t width, uint32_t height, uint32_t depth, uint32_t numMipMaps, uint32_t array_size,
 		ElementFormat format, ArrayRef<ElementInitData> init_data)
@@ -0,0 +1,569 @@
+/**
+* @file TextureStreaming.cpp
+* @author Minmin Gong
+*
+* @section DESCRIPTION
+*
+* This source file is part of KlayGE
+* For the latest info, see http://www.klayge.org
+*
+* @section LICENSE
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published
+* by the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*
+* You may alternatively use this source under the terms of
+* the KlayGE Proprietary License (KPL). You can obtained such a license
+* from http://www.klayge.org/licensing/.
+*/
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/ErrorHandling.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/RenderFactory.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+#include <KlayGE/TextureStreaming.hpp>
+
+namespace
+{
+	std::mutex singleton_mutex;
+
+	uint32_t const NO_REQUEST = std::numeric_limits<uint32_t>::max();
+}
+
+namespace KlayGE
+{
+	std::unique_ptr<TextureStreamingManager> TextureStreamingManager::texture_streaming_manager_instance_;
+
+	StreamedTexture::StreamedTexture(Texture::TextureType type, uint32_t width, uint32_t height, uint32_t depth,
+			uint32_t num_mip_maps, uint32_t array_size, ElementFormat format, uint32_t access_hint)
+		: type_(type), width_(width), height_(height), depth_(depth),
+			num_mip_maps_(num_mip_maps), array_size_(array_size), format_(format),
+			access_hint_(access_hint & ~EAH_Immutable),
+			resident_bytes_(0),
+			requested_mip_(NO_REQUEST), last_request_frame_(0), managed_(false)
+	{
+		uint32_t const initial_size = TextureStreamingManager::Instance().InitialMipSize();
+		uint32_t level = 0;
+		while ((level + 1 < num_mip_maps_) && (std::max({ width_ >> level, height_ >> level, depth_ >> level }) > initial_size))
+		{
+			++ level;
+		}
+		while (!this->CanStartAt(level))
+		{
+			-- level;
+		}
+		base_mip_ = level;
+		resident_mip_ = level;
+		wanted_mip_ = level;
+
+		uint32_t const width_l = std::max(1U, width_ >> level);
+		uint32_t const height_l = std::max(1U, height_ >> level);
+		uint32_t const depth_l = std::max(1U, depth_ >> level);
+		uint32_t const num_mips_l = num_mip_maps_ - level;
+
+		RenderFactory& rf = Context::Instance().RenderFactoryInstance();
+		switch (type_)
+		{
+		case Texture::TT_1D:
+			resident_tex_ = rf.MakeDelayCreationTexture1D(width_l, num_mips_l, array_size_, format_, 1, 0, access_hint_);
+			break;
+
+		case Texture::TT_2D:
+			resident_tex_ = rf.MakeDelayCreationTexture2D(width_l, height_l, num_mips_l, array_size_, format_, 1, 0, access_hint_);
+			break;
+
+		case Texture::TT_3D:
+			resident_tex_ = rf.MakeDelayCreationTexture3D(width_l, height_l, depth_l, num_mips_l, array_size_, format_,
+				1, 0, access_hint_);
+			break;
+
+		case Texture::TT_Cube:
+			resident_tex_ = rf.MakeDelayCreationTextureCube(width_l, num_mips_l, array_size_, format_, 1, 0, access_hint_);
+			break;
+
+		default:
+			KFL_UNREACHABLE("Invalid texture type");
+		}
+	}
+
+	uint64_t StreamedTexture::MipChainBytes(uint32_t first_mip) const
+	{
+		BOOST_ASSERT(this->SourceDataReady());
+
+		uint32_t const num_slices = (Texture::TT_Cube == type_) ? array_size_ * 6 : array_size_;
+		uint64_t bytes = 0;
+		for (uint32_t slice = 0; slice < num_slices; ++ slice)
+		{
+			for (uint32_t level = first_mip; level < num_mip_maps_; ++ level)
+			{
+				uint32_t const depth = (Texture::TT_3D == type_) ? std::max(1U, depth_ >> level) : 1;
+				bytes += static_cast<uint64_t>(init_data_[slice * num_mip_maps_ + level].slice_pitch) * depth;
+			}
+		}
+		return bytes;
+	}
+
+	void StreamedTexture::RequestMip(uint32_t level)
+	{
+		requested_mip_ = std::min(requested_mip_, std::min(level, num_mip_maps_ - 1));
+	}
+
+	void StreamedTexture::RequestScreenSize(float pixels)
+	{
+		uint32_t level = num_mip_maps_ - 1;
+		if (pixels > 0)
+		{
+			float const texels = static_cast<float>(std::max({ width_, height_, depth_ }));
+			level = static_cast<uint32_t>(std::max(0.0f, std::floor(std::log2(texels / pixels))));
+		}
+		this->RequestMip(level);
+	}
+
+	void StreamedTexture::SourceData(std::vector<ElementInitData>&& init_data, std::vector<uint8_t>&& data_block)
+	{
+		init_data_ = std::move(init_data);
+		data_block_ = std::move(data_block);
+	}
+
+	void StreamedTexture::CreateHWResource()
+	{
+		BOOST_ASSERT(this->SourceDataReady());
+
+		if (!resident_tex_->HWResourceReady())
+		{
+			uint32_t const num_slices = (Texture::TT_Cube == type_) ? array_size_ * 6 : array_size_;
+			std::vector<ElementInitData> init_data;
+			init_data.reserve(num_slices * (num_mip_maps_ - resident_mip_));
+			for (uint32_t slice = 0; slice < num_slices; ++ slice)
+			{
+				for (uint32_t level = resident_mip_; level < num_mip_maps_; ++ level)
+				{
+					init_data.push_back(init_data_[slice * num_mip_maps_ + level]);
+				}
+			}
+
+			resident_tex_->CreateHWResource(init_data);
+			resident_bytes_ = this->MipChainBytes(resident_mip_);
+
+			this->ReleaseBaseSourceData();
+		}
+	}
+
+	uint64_t StreamedTexture::SourceBytes() const
+	{
+		return data_block_.size();
+	}
+
+	bool StreamedTexture::CanStartAt(uint32_t level) const
+	{
+		return (0 == level) || !IsCompressedFormat(format_)
+			|| ((0 == ((width_ >> level) & 3)) && (0 == ((height_ >> level) & 3)));
+	}
+
+	// The base mips are always on the GPU, and copied from the old resident texture to the new one. Only the finer
+	//  mips are kept in system memory, to be uploaded when the texture grows.
+	void StreamedTexture::ReleaseBaseSourceData()
+	{
+		uint32_t const num_slices = (Texture::TT_Cube == type_) ? array_size_ * 6 : array_size_;
+
+		std::vector<uint8_t> data_block(static_cast<size_t>(this->MipChainBytes(0) - this->MipChainBytes(base_mip_)));
+		size_t offset = 0;
+		for (uint32_t slice = 0; slice < num_slices; ++ slice)
+		{
+			for (uint32_t level = 0; level < num_mip_maps_; ++ level)
+			{
+				ElementInitData& init_data = init_data_[slice * num_mip_maps_ + level];
+				if (level < base_mip_)
+				{
+					uint32_t const depth = (Texture::TT_3D == type_) ? std::max(1U, depth_ >> level) : 1;
+					size_t const size = static_cast<size_t>(init_data.slice_pitch) * depth;
+					std::memcpy(&data_block[offset], init_data.data, size);
+					init_data.data = &data_block[offset];
+					offset += size;
+				}
+				else
+				{
+					init_data.data = nullptr;
+				}
+			}
+		}
+		BOOST_ASSERT(offset == data_block.size());
+
+		data_block_.swap(data_block);
+	}
+
+	void StreamedTexture::MakeResident(uint32_t first_mip)
+	{
+		BOOST_ASSERT(this->CanStartAt(first_mip));
+		BOOST_ASSERT(first_mip <= base_mip_);
+
+		uint32_t const num_mips = num_mip_maps_ - first_mip;
+		uint32_t const width = std::max(1U, width_ >> first_mip);
+		uint32_t const height = std::max(1U, height_ >> first_mip);
+		uint32_t const depth = std::max(1U, depth_ >> first_mip);
+
+		RenderFactory& rf = Context::Instance().RenderFactoryInstance();
+		TexturePtr tex;
+		switch (type_)
+		{
+		case Texture::TT_1D:
+			tex = rf.MakeTexture1D(width, num_mips, array_size_, format_, 1, 0, access_hint_);
+			break;
+
+		case Texture::TT_2D:
+			tex = rf.MakeTexture2D(width, height, num_mips, array_size_, format_, 1, 0, access_hint_);
+			break;
+
+		case Texture::TT_3D:
+			tex = rf.MakeTexture3D(width, height, depth, num_mips, array_size_, format_, 1, 0, access_hint_);
+			break;
+
+		case Texture::TT_Cube:
+			tex = rf.MakeTextureCube(width, num_mips, array_size_, format_, 1, 0, access_hint_);
+			break;
+
+		default:
+			KFL_UNREACHABLE("Invalid texture type");
+		}
+
+		// The mips both textures have are copied on the GPU, only the new ones are uploaded
+		uint32_t const num_faces = (Texture::TT_Cube == type_) ? 6 : 1;
+		for (uint32_t array_index = 0; array_index < array_size_; ++ array_index)
+		{
+			for (uint32_t face = 0; face < num_faces; ++ face)
+			{
+				for (uint32_t level = first_mip; level < num_mip_maps_; ++ level)
+				{
+					if (level >= resident_mip_)
+					{
+						this->CopyMip(*tex, array_index, face, level - first_mip, level - resident_mip_);
+					}
+					else
+					{
+						this->UploadMip(*tex, array_index, face, level - first_mip, level);
+					}
+				}
+			}
+		}
+
+		resident_tex_ = tex;
+		resident_mip_ = first_mip;
+		resident_bytes_ = this->MipChainBytes(first_mip);
+	}
+
+	void StreamedTexture::CopyMip(Texture& target, uint32_t array_index, uint32_t face, uint32_t dst_level, uint32_t src_level)
+	{
+		uint32_t const width = target.Width(dst_level);
+		uint32_t const height = target.Height(dst_level);
+		switch (type_)
+		{
+		case Texture::TT_1D:
+			resident_tex_->CopyToSubTexture1D(target, array_index, dst_level, 0, width, array_index, src_level, 0, width);
+			break;
+
+		case Texture::TT_2D:
+			resident_tex_->CopyToSubTexture2D(target, array_index, dst_level, 0, 0, width, height,
+				array_index, src_level, 0, 0, width, height);
+			break;
+
+		case Texture::TT_3D:
+			{
+				uint32_t const depth = target.Depth(dst_level);
+				resident_tex_->CopyToSubTexture3D(target, array_index, dst_level, 0, 0, 0, width, height, depth,
+					array_index, src_level, 0, 0, 0, width, height, depth);
+			}
+			break;
+
+		case Texture::TT_Cube:
+			resident_tex_->CopyToSubTextureCube(target, array_index, static_cast<Texture::CubeFaces>(face), dst_level,
+				0, 0, width, height, array_index, static_cast<Texture::CubeFaces>(face), src_level, 0, 0, width, height);
+			break;
+
+		default:
+			KFL_UNREACHABLE("Invalid texture type");
+		}
+	}
+
+	void StreamedTexture::UploadMip(Texture& target, uint32_t array_index, uint32_t face, uint32_t dst_level, uint32_t level)
+	{
+		uint32_t const slice = (Texture::TT_Cube == type_) ? array_index * 6 + face : array_index;
+		ElementInitData const & init_data = init_data_[slice * num_mip_maps_ + level];
+		BOOST_ASSERT(init_data.data != nullptr);
+
+		uint32_t const width = target.Width(dst_level);
+		uint32_t const height = target.Height(dst_level);
+		switch (type_)
+		{
+		case Texture::TT_1D:
+			target.UpdateSubresource1D(array_index, dst_level, 0, width, init_data.data);
+			break;
+
+		case Texture::TT_2D:
+			target.UpdateSubresource2D(array_index, dst_level, 0, 0, width, height, init_data.data, init_data.row_pitch);
+			break;
+
+		case Texture::TT_3D:
+			target.UpdateSubresource3D(array_index, dst_level, 0, 0, 0, width, height, target.Depth(dst_level),
+				init_data.data, init_data.row_pitch, init_data.slice_pitch);
+			break;
+
+		case Texture::TT_Cube:
+			target.UpdateSubresourceCube(array_index, static_cast<Texture::CubeFaces>(face), dst_level, 0, 0, width, height,
+				init_data.data, init_data.row_pitch);
+			break;
+
+		default:
+			KFL_UNREACHABLE("Invalid texture type");
+		}
+	}
+
+
+	TextureStreamingManager::TextureStreamingManager()
+		: active_(false), budget_(0), initial_mip_size_(64), max_uploads_per_frame_(4),
+			resident_bytes_(0), frame_(0)
+	{
+	}
+
+	TextureStreamingManager& TextureStreamingManager::Instance()
+	{
+		if (!texture_streaming_manager_instance_)
+		{
+			std::lock_guard<std::mutex> lock(singleton_mutex);
+			if (!texture_streaming_manager_instance_)
+			{
+				texture_streaming_manager_instance_ = MakeUniquePtr<TextureStreamingManager>();
+			}
+		}
+		return *texture_streaming_manager_instance_;
+	}
+
+	void TextureStreamingManager::Destroy()
+	{
+		std::lock_guard<std::mutex> lock(singleton_mutex);
+		texture_streaming_manager_instance_.reset();
+	}
+
+	void TextureStreamingManager::Active(bool active)
+	{
+		active_ = active;
+	}
+
+	bool TextureStreamingManager::Active() const
+	{
+		return active_;
+	}
+
+	void TextureStreamingManager::Budget(uint64_t bytes)
+	{
+		budget_ = bytes;
+	}
+
+	uint64_t TextureStreamingManager::Budget() const
+	{
+		return budget_;
+	}
+
+	void TextureStreamingManager::InitialMipSize(uint32_t size)
+	{
+		initial_mip_size_ = std::max(1U, size);
+	}
+
+	uint32_t TextureStreamingManager::InitialMipSize() const
+	{
+		return initial_mip_size_;
+	}
+
+	void TextureStreamingManager::MaxUploadsPerFrame(uint32_t num)
+	{
+		max_uploads_per_frame_ = std::max(1U, num);
+	}
+
+	uint32_t TextureStreamingManager::MaxUploadsPerFrame() const
+	{
+		return max_uploads_per_frame_;
+	}
+
+	void TextureStreamingManager::MipFeedback(std::function<void()> const & callback)
+	{
+		mip_feedback_ = callback;
+	}
+
+	void TextureStreamingManager::Add(StreamedTexturePtr const & tex)
+	{
+		BOOST_ASSERT(tex->SourceDataReady());
+
+		if (!tex->managed_)
+		{
+			tex->managed_ = true;
+			tex->last_request_frame_ = frame_;
+			textures_.push_back(tex);
+			resident_bytes_ += tex->resident_bytes_;
+		}
+	}
+
+	void TextureStreamingManager::Update()
+	{
+		if (mip_feedback_)
+		{
+			mip_feedback_();
+		}
+
+		++ frame_;
+
+		std::vector<StreamedTexturePtr> textures;
+		textures.reserve(textures_.size());
+		for (auto const & weak_tex : textures_)
+		{
+			if (auto tex = weak_tex.lock())
+			{
+				textures.push_back(tex);
+			}
+		}
+		textures_.assign(textures.begin(), textures.end());
+
+		std::vector<StreamedTexture*> lru_textures;
+		lru_textures.reserve(textures.size());
+		resident_bytes_ = 0;
+		for (auto const & tex : textures)
+		{
+			if (tex->requested_mip_ != NO_REQUEST)
+			{
+				tex->wanted_mip_ = tex->requested_mip_;
+				tex->requested_mip_ = NO_REQUEST;
+				tex->last_request_frame_ = frame_;
+			}
+			resident_bytes_ += tex->resident_bytes_;
+			lru_textures.push_back(tex.get());
+		}
+		std::stable_sort(lru_textures.begin(), lru_textures.end(),
+			[](StreamedTexture const * lhs, StreamedTexture const * rhs)
+			{
+				return lhs->last_request_frame_ < rhs->last_request_frame_;
+			});
+
+		// Over the budget, e.g. after it's lowered
+		if ((budget_ > 0) && (resident_bytes_ > budget_))
+		{
+			resident_bytes_ -= this->Shrink(lru_textures, resident_bytes_ - budget_, frame_);
+		}
+
+		std::vector<std::pair<StreamedTexture*, uint32_t>> growing;
+		for (auto tex : lru_textures)
+		{
+			if (tex->last_request_frame_ == frame_)
+			{
+				uint32_t target = tex->wanted_mip_;
+				while (!tex->CanStartAt(target))
+				{
+					-- target;
+				}
+				if (target < tex->resident_mip_)
+				{
+					growing.emplace_back(tex, target);
+				}
+			}
+		}
+		// The blurriest ones first
+		std::stable_sort(growing.begin(), growing.end(),
+			[](std::pair<StreamedTexture*, uint32_t> const & lhs, std::pair<StreamedTexture*, uint32_t> const & rhs)
+			{
+				return lhs.first->resident_mip_ - lhs.second > rhs.first->resident_mip_ - rhs.second;
+			});
+
+		uint32_t num_uploads = 0;
+		for (auto& grow : growing)
+		{
+			if (num_uploads >= max_uploads_per_frame_)
+			{
+				break;
+			}
+
+			StreamedTexture* tex = grow.first;
+			uint32_t target = grow.second;
+			if (budget_ > 0)
+			{
+				uint64_t const new_bytes = tex->MipChainBytes(target) - tex->resident_bytes_;
+				if (resident_bytes_ + new_bytes > budget_)
+				{
+					resident_bytes_ -= this->Shrink(lru_textures, resident_bytes_ + new_bytes - budget_, frame_);
+				}
+
+				// Grows as far as the budget allows
+				while ((target < tex->resident_mip_) && (resident_bytes_ + tex->MipChainBytes(target) - tex->resident_bytes_ > budget_))
+				{
+					do
+					{
+						++ target;
+					} while ((target < tex->resident_mip_) && !tex->CanStartAt(target));
+				}
+			}
+
+			if (target < tex->resident_mip_)
+			{
+				resident_bytes_ -= tex->resident_bytes_;
+				tex->MakeResident(target);
+				resident_bytes_ += tex->resident_bytes_;
+				++ num_uploads;
+			}
+		}
+	}
+
+	uint64_t TextureStreamingManager::ResidentBytes() const
+	{
+		return resident_bytes_;
+	}
+
+	uint32_t TextureStreamingManager::NumStreamedTextures() const
+	{
+		return static_cast<uint32_t>(textures_.size());
+	}
+
+	uint64_t TextureStreamingManager::Shrink(std::vector<StreamedTexture*> const & lru_textures, uint64_t bytes, uint32_t frame)
+	{
+		uint64_t freed = 0;
+		for (auto tex : lru_textures)
+		{
+			if ((freed >= bytes) || (tex->last_request_frame_ >= frame))
+			{
+				break;
+			}
+
+			// Drops as few levels as needed, in one recreation
+			uint32_t level = tex->resident_mip_;
+			while ((level < tex->base_mip_) && (tex->resident_bytes_ - tex->MipChainBytes(level) < bytes - freed))
+			{
+				do
+				{
+					++ level;
+				} while ((level < tex->base_mip_) && !tex->CanStartAt(level));
+			}
+
+			if (level > tex->resident_mip_)
+			{
+				uint64_t const old_bytes = tex->resident_bytes_;
+				tex->MakeResident(level);
+				tex->wanted_mip_ = std::max(tex->wanted_mip_, level);
+				freed += old_bytes - tex->resident_bytes_;
+			}
+		}
+		return freed;
+	}
+}
@@ -59,6 +59,8 @@ namespace KlayGE
 			simulate_buffer_.resize(buffer_->Size());
 			valid_min_ = 0;
 			valid_max_ = 0;
+			dirty_min_ = 0;
+			dirty_max_ = 0;
 		}
 
 		SubAlloc alloc(0, size_in_byte);
@@ -88,8 +90,10 @@ namespace KlayGE
 		return buffer;
 	}
 
-	SubAlloc TransientBuffer::Alloc(uint32_t size_in_byte, void const * data)
+	SubAlloc TransientBuffer::Alloc(uint32_t size_in_byte, void const * data, uint32_t alignment)
 	{
+		BOOST_ASSERT(alignment > 0);
+
 		SubAlloc ret;
 
 		// Use first fit method to find a free sub alloc
@@ -98,7 +102,8 @@ namespace KlayGE
 		auto first_fit_iter = iter;
 		for (; iter != free_list_.end(); ++ iter)
 		{
-			if (iter->length_ >= size_in_byte)
+			uint32_t const padding = (alignment - iter->offset_ % alignment) % alignment;
+			if (iter->length_ >= size_in_byte + padding)
 			{
 				first_fit_iter = iter;
 				found = true;
@@ -110,7 +115,7 @@ namespace KlayGE
 		if (!found)
 		{
 			uint32_t const old_buffer_size = buffer_->Size();
-			uint32_t larger_buffer_size = std::max(old_buffer_size * 2, old_buffer_size + size_in_byte);
+			uint32_t larger_buffer_size = std::max(old_buffer_size * 2, old_buffer_size + size_in_byte + alignment - 1);
 			GraphicsBufferPtr larger_buffer = this->DoCreateBuffer(bind_flag_, larger_buffer_size);
 			SubAlloc alloc(old_buffer_size, larger_buffer_size - old_buffer_size);
 			if (!free_list_.empty() && (free_list_.back().offset_ + free_list_.back().length_ == alloc.offset_))
@@ -130,14 +135,37 @@ namespace KlayGE
 			else
 			{
 				simulate_buffer_.resize(larger_buffer_size);
+
+				// The new buffer has nothing in it yet
+				if (dirty_min_ < dirty_max_)
+				{
+					dirty_min_ = std::min(dirty_min_, valid_min_);
+					dirty_max_ = std::max(dirty_max_, valid_max_);
+				}
+				else
+				{
+					dirty_min_ = valid_min_;
+					dirty_max_ = valid_max_;
+				}
 			}
 			buffer_ = larger_buffer;
 		}
 
-		uint32_t left_size = first_fit_iter->length_ - size_in_byte;
+		uint32_t const padding = (alignment - first_fit_iter->offset_ % alignment) % alignment;
+		uint32_t left_size = first_fit_iter->length_ - padding - size_in_byte;
 		ret.length_ = size_in_byte;
-		ret.offset_ = first_fit_iter->offset_;
-		if (0 == left_size)
+		ret.offset_ = first_fit_iter->offset_ + padding;
+		if (padding > 0)
+		{
+			// The padding stays in the free list
+			first_fit_iter->length_ = padding;
+			if (left_size > 0)
+			{
+				++ first_fit_iter;
+				free_list_.emplace(first_fit_iter, ret.offset_ + size_in_byte, left_size);
+			}
+		}
+		else if (0 == left_size)
 		{
 			free_list_.erase(first_fit_iter);
 		}
@@ -158,6 +186,16 @@ namespace KlayGE
 			memcpy(&simulate_buffer_[ret.offset_], data, ret.length_);
 			valid_min_ = std::min(valid_min_, ret.offset_);
 			valid_max_ = std::max(valid_max_, ret.offset_ + ret.length_);
+			if (dirty_min_ < dirty_max_)
+			{
+				dirty_min_ = std::min(dirty_min_, ret.offset_);
+				dirty_max_ = std::max(dirty_max_, ret.offset_ + ret.length_);
+			}
+			else
+			{
+				dirty_min_ = ret.offset_;
+				dirty_max_ = ret.offset_ + ret.length_;
+			}
 		}
 
 		return ret;
@@ -284,11 +322,13 @@ namespace KlayGE
 
 	void TransientBuffer::EnsureDataReady()
 	{
-		if (!use_no_overwrite_)
+		// Mapping would discard the whole buffer, and everything still valid would have to be copied again. Only the
+		//  new part is updated instead, the rest is already in the buffer.
+		if (!use_no_overwrite_ && (dirty_min_ < dirty_max_))
 		{
-			GraphicsBuffer::Mapper mapper(*buffer_, BA_Write_Only);
-			memcpy(mapper.Pointer<uint8_t>() + valid_min_, &simulate_buffer_[valid_min_],
-				valid_max_ - valid_min_);
+			buffer_->UpdateSubresource(dirty_min_, dirty_max_ - dirty_min_, &simulate_buffer_[dirty_min_]);
+			dirty_min_ = 0;
+			dirty_max_ = 0;
 		}
 	}
 }
@@ -39,6 +39,7 @@
 #include <KFL/Util.hpp>
 #include <KlayGE/Context.hpp>
 #include <KFL/Math.hpp>
+#include <KFL/SIMDMath.hpp>
 #include <KlayGE/App3D.hpp>
 #include <KlayGE/Window.hpp>
 #include <KlayGE/Viewport.hpp>
@@ -46,6 +47,7 @@
 #include <KlayGE/RenderEngine.hpp>
 #include <KlayGE/RenderFactory.hpp>
 #include <KlayGE/Renderable.hpp>
+#include <KlayGE/RenderLayout.hpp>
 #include <KlayGE/RenderEffect.hpp>
 #include <KlayGE/Light.hpp>
 #include <KlayGE/SceneObject.hpp>
@@ -53,13 +55,111 @@
 #include <KlayGE/InputFactory.hpp>
 #include <KlayGE/FrameBuffer.hpp>
 #include <KlayGE/DeferredRenderingLayer.hpp>
+#include <KlayGE/TextureStreaming.hpp>
+#include <KlayGE/PerfProfiler.hpp>
 #include <KFL/Hash.hpp>
+#include <KFL/RadixSort.hpp>
 
 #include <map>
 #include <algorithm>
+#include <cstring>
 
 #include <KlayGE/SceneManager.hpp>
 
+namespace
+{
+	using namespace KlayGE;
+
+	bool IsSkippedCullable(uint32_t attr, bool skip_static_cullable, bool skip_moveable_cullable)
+	{
+		return (attr & SceneObject::SOA_Cullable)
+			&& ((attr & SceneObject::SOA_Moveable) ? skip_moveable_cullable : skip_static_cullable);
+	}
+
+	uint32_t const TECH_RANK_BITS = 16;
+	uint32_t const DEPTH_BITS = 32;
+	uint32_t const MTL_SLOT_BITS = 16;
+
+	// Small ids in the order of first use. Past the limit everything shares the last id, which only costs batching.
+	template <typename T>
+	uint32_t Slot(std::unordered_map<T const *, uint32_t>& slots, T const * ptr, uint32_t bits)
+	{
+		uint32_t const max_slot = (1U << bits) - 1;
+		auto iter = slots.emplace(ptr, std::min(static_cast<uint32_t>(slots.size()), max_slot)).first;
+		return iter->second;
+	}
+
+	bool HasInstanceData(Renderable const & renderable)
+	{
+		return (renderable.NumInstances() > 0) && !renderable.GetInstance(0)->InstanceFormat().empty();
+	}
+
+	// Only the instance data differs, so the instances of both can go into one draw
+	bool CanShareDraw(Renderable const & lhs, Renderable const & rhs)
+	{
+		if ((lhs.GetRenderTechnique() != rhs.GetRenderTechnique()) || (lhs.GetRenderEffect() != rhs.GetRenderEffect())
+			|| (lhs.GetMaterial() != rhs.GetMaterial())
+			|| (lhs.GetInstance(0)->InstanceFormat() != rhs.GetInstance(0)->InstanceFormat()))
+		{
+			return false;
+		}
+
+		RenderLayout const & lhs_rl = lhs.GetRenderLayout();
+		RenderLayout const & rhs_rl = rhs.GetRenderLayout();
+		if ((lhs_rl.TopologyType() != rhs_rl.TopologyType()) || (lhs_rl.NumVertexStreams() != rhs_rl.NumVertexStreams())
+			|| (lhs_rl.NumVertices() != rhs_rl.NumVertices()) || (lhs_rl.StartVertexLocation() != rhs_rl.StartVertexLocation())
+			|| (lhs_rl.NumIndices() != rhs_rl.NumIndices()))
+		{
+			return false;
+		}
+		for (uint32_t i = 0; i < lhs_rl.NumVertexStreams(); ++ i)
+		{
+			if ((lhs_rl.GetVertexStream(i) != rhs_rl.GetVertexStream(i))
+				|| (lhs_rl.VertexStreamFormat(i) != rhs_rl.VertexStreamFormat(i)))
+			{
+				return false;
+			}
+		}
+		if (lhs_rl.UseIndices())
+		{
+			if ((lhs_rl.GetIndexStream() != rhs_rl.GetIndexStream()) || (lhs_rl.IndexStreamFormat() != rhs_rl.IndexStreamFormat())
+				|| (lhs_rl.StartIndexLocation() != rhs_rl.StartIndexLocation()))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Equal for the renderables CanShareDraw accepts, so that they sort next to each other
+	uint32_t ShareDrawHash(Renderable const & renderable)
+	{
+		size_t seed = 0;
+		HashCombine(seed, renderable.GetRenderTechnique());
+		HashCombine(seed, renderable.GetRenderEffect().get());
+		HashCombine(seed, renderable.GetMaterial().get());
+
+		RenderLayout const & rl = renderable.GetRenderLayout();
+		HashCombine(seed, rl.TopologyType());
+		HashCombine(seed, rl.NumVertices());
+		HashCombine(seed, rl.StartVertexLocation());
+		HashCombine(seed, rl.NumIndices());
+		for (uint32_t i = 0; i < rl.NumVertexStreams(); ++ i)
+		{
+			HashCombine(seed, rl.GetVertexStream(i).get());
+		}
+		if (rl.UseIndices())
+		{
+			HashCombine(seed, rl.GetIndexStream().get());
+			HashCombine(seed, rl.StartIndexLocation());
+		}
+
+		uint64_t const hash = seed;
+		return static_cast<uint32_t>(hash ^ (hash >> 32));
+	}
+}
+
 namespace KlayGE
 {
 	// 캯
@@ -71,6 +171,7 @@ namespace KlayGE
 			num_objects_rendered_(0), num_renderables_rendered_(0),
 			num_primitives_rendered_(0), num_vertices_rendered_(0),
 			num_draw_calls_(0), num_dispatch_calls_(0),
+			auto_instancing_(true),
 			quit_(false), deferred_mode_(false)
 	{
 	}
@@ -111,6 +212,8 @@ namespace KlayGE
 	/////////////////////////////////////////////////////////////////////////////////
 	void SceneManager::ClipScene()
 	{
+		this->UpdateTransforms();
+
 		App3DFramework& app = Context::Instance().AppInstance();
 		Camera& camera = app.ActiveCamera();
 
@@ -125,9 +228,16 @@ namespace KlayGE
 			}
 		}
 
+		this->ClipRootObjects(camera, view_proj, false, false);
+
 		for (auto const & obj : scene_objs_)
 		{
 			auto so = obj.get();
+			if (!so->Parent())
+			{
+				continue;
+			}
+
 			BoundOverlap visible;
 			uint32_t const attr = so->Attrib();
 			if (so->Visible())
@@ -135,11 +245,6 @@ namespace KlayGE
 				visible = this->VisibleTestFromParent(so, camera.ForwardVec(), camera.EyePos(), view_proj);
 				if (BO_Partial == visible)
 				{
-					if (attr & SceneObject::SOA_Moveable)
-					{
-						so->UpdateAbsModelMatrix();
-					}
-
 					if (attr & SceneObject::SOA_Cullable)
 					{
 						if (small_obj_threshold_ > 0)
@@ -260,11 +365,29 @@ namespace KlayGE
 		}
 		else
 		{
-			if ((attr & SceneObject::SOA_Cullable)
-				&& !(attr & SceneObject::SOA_Moveable))
+			// Right now, since the scene manager could put it in its structure by the world bound
+			obj->CalcAbsModelMatrix();
+
+			// Could be added again when its renderable gets ready
+			if (TransformHierarchy::INVALID_NODE == obj->TransformNode())
 			{
-				obj->UpdateAbsModelMatrix();
+				uint32_t parent_node = TransformHierarchy::INVALID_NODE;
+				if (obj->Parent())
+				{
+					// Parents are added before their children
+					parent_node = obj->Parent()->TransformNode();
+					BOOST_ASSERT(parent_node != TransformHierarchy::INVALID_NODE);
+				}
+				uint32_t const node = transforms_.AddNode(parent_node, obj->ModelMatrix());
+				if (node >= transform_objs_.size())
+				{
+					transform_objs_.resize(node + 1, nullptr);
+				}
+				transform_objs_[node] = obj.get();
+				obj->TransformNode(&transforms_, node);
 			}
+			// Hands the bound of the renderable to the hierarchy
+			obj->UpdateAbsModelMatrix();
 
 			scene_objs_.push_back(obj);
 			this->OnAddSceneObject(obj);
@@ -300,6 +423,16 @@ namespace KlayGE
 	std::vector<SceneObjectPtr>::iterator SceneManager::DelSceneObjectLocked(std::vector<SceneObjectPtr>::iterator iter)
 	{
 		this->OnDelSceneObject(iter);
+
+		SceneObject* so = iter->get();
+		uint32_t const node = so->TransformNode();
+		if (node != TransformHierarchy::INVALID_NODE)
+		{
+			transforms_.DelNode(node);
+			transform_objs_[node] = nullptr;
+			so->TransformNode(nullptr, TransformHierarchy::INVALID_NODE);
+		}
+
 		return scene_objs_.erase(iter);
 	}
 
@@ -355,22 +488,8 @@ namespace KlayGE
 
 			if (add)
 			{
-				RenderTechnique const * obj_tech = obj->GetRenderTechnique();
-				BOOST_ASSERT(obj_tech);
-				bool found = false;
-				for (auto& items : render_queue_)
-				{
-					if (items.first == obj_tech)
-					{
-						items.second.push_back(obj);
-						found = true;
-						break;
-					}
-				}
-				if (!found)
-				{
-					render_queue_.emplace_back(obj_tech, std::vector<Renderable*>(1, obj));
-				}
+				BOOST_ASSERT(obj->GetRenderTechnique());
+				render_queue_.push_back(obj);
 			}
 		}
 	}
@@ -451,6 +570,12 @@ namespace KlayGE
 	void SceneManager::ClearObject()
 	{
 		std::lock_guard<std::mutex> lock(update_mutex_);
+		for (auto const & obj : scene_objs_)
+		{
+			obj->TransformNode(nullptr, TransformHierarchy::INVALID_NODE);
+		}
+		transforms_.Clear();
+		transform_objs_.clear();
 		scene_objs_.resize(0);
 		overlay_scene_objs_.resize(0);
 	}
@@ -459,6 +584,8 @@ namespace KlayGE
 	/////////////////////////////////////////////////////////////////////////////////
 	void SceneManager::Update()
 	{
+		PerfEventScope scope("SceneManager::Update");
+
 		deferred_mode_ = !!Context::Instance().DeferredRenderingLayerInstance();
 
 		App3DFramework& app = Context::Instance().AppInstance();
@@ -468,6 +595,8 @@ namespace KlayGE
 		RenderEngine& re = Context::Instance().RenderFactoryInstance().RenderEngineInstance();
 		re.BeginFrame();
 
+		TextureStreamingManager::Instance().Update();
+
 		this->FlushScene();
 
 		if (!update_thread_ && !quit_)
@@ -635,59 +764,133 @@ namespace KlayGE
 			}
 		}
 
-		std::sort(render_queue_.begin(), render_queue_.end(),
-			[](std::pair<RenderTechnique const *, std::vector<Renderable*>> const & lhs,
-				std::pair<RenderTechnique const *, std::vector<Renderable*>> const & rhs)
-			{
-				BOOST_ASSERT(lhs.first);
-				BOOST_ASSERT(rhs.first);
+		auto const item_key = [](RenderQueueItem const & item)
+		{
+			return item.key;
+		};
 
-				return lhs.first->Weight() < rhs.first->Weight();
-			});
+		// Techniques are ranked by weight. The same weights keep the order the techniques are first used in.
+		tech_slots_.clear();
+		for (auto const renderable : render_queue_)
+		{
+			Slot(tech_slots_, renderable->GetRenderTechnique(), TECH_RANK_BITS);
+		}
+		tech_rank_items_.clear();
+		for (auto const & slot : tech_slots_)
+		{
+			tech_rank_items_.push_back(RenderQueueItem{ (static_cast<uint64_t>(SortableFloat(slot.first->Weight())) << 32) | slot.second, nullptr });
+		}
+		RadixSort(tech_rank_items_, render_queue_scratch_, item_key);
+		tech_ranks_.resize(tech_rank_items_.size());
+		for (size_t i = 0; i < tech_rank_items_.size(); ++ i)
+		{
+			tech_ranks_[tech_rank_items_[i].key & 0xFFFFFFFFU] = std::min(static_cast<uint32_t>(i), (1U << TECH_RANK_BITS) - 1);
+		}
 
+		// From high bits to low, the key holds the technique rank, the depth and the material slot. Opaque ones go front
+		//  to back, transparent ones back to front. Techniques with discard aren't depth sorted.
 		float4 const & view_mat_z = camera.ViewMatrix().Col(2);
-		for (auto& items : render_queue_)
+		mtl_slots_.clear();
+		render_queue_items_.resize(render_queue_.size());
+		for (size_t i = 0; i < render_queue_.size(); ++ i)
 		{
-			if (!items.first->Transparent() && !items.first->HasDiscard() && (items.second.size() > 1))
+			Renderable* renderable = render_queue_[i];
+			RenderTechnique const * tech = renderable->GetRenderTechnique();
+
+			uint64_t key = static_cast<uint64_t>(tech_ranks_[tech_slots_[tech]]) << (DEPTH_BITS + MTL_SLOT_BITS);
+			if (tech->Transparent())
+			{
+				// The ones at the same depth stay in the order they were added
+				key |= static_cast<uint64_t>(~SortableFloat(renderable->MinViewDepth(view_mat_z))) << MTL_SLOT_BITS;
+			}
+			else
 			{
-				std::vector<std::pair<float, uint32_t>> min_depths(items.second.size());
-				for (size_t j = 0; j < min_depths.size(); ++ j)
+				if (!tech->HasDiscard())
 				{
-					Renderable const * renderable = items.second[j];
-					AABBox const & box = renderable->PosBound();
-					uint32_t const num = renderable->NumInstances();
-					float md = 1e10f;
-					for (uint32_t i = 0; i < num; ++ i)
-					{
-						float4x4 const & mat = renderable->GetInstance(i)->ModelMatrix();
-						float4 const zvec(MathLib::dot(mat.Row(0), view_mat_z),
-							MathLib::dot(mat.Row(1), view_mat_z), MathLib::dot(mat.Row(2), view_mat_z),
-							MathLib::dot(mat.Row(3), view_mat_z));
-						for (int k = 0; k < 8; ++ k)
-						{
-							float3 const v = box.Corner(k);
-							md = std::min(md, v.x() * zvec.x() + v.y() * zvec.y() + v.z() * zvec.z() + zvec.w());
-						}
-					}
+					key |= static_cast<uint64_t>(SortableFloat(renderable->MinViewDepth(view_mat_z))) << MTL_SLOT_BITS;
+				}
+				key |= Slot(mtl_slots_, renderable->GetMaterial().get(), MTL_SLOT_BITS);
+			}
+
+			render_queue_items_[i].key = key;
+			render_queue_items_[i].renderable = renderable;
+		}
 
-					min_depths[j] = std::make_pair(md, static_cast<uint32_t>(j));
+		RadixSort(render_queue_items_, render_queue_scratch_, item_key);
+
+		if (auto_instancing_)
+		{
+			// Opaque ones sharing everything but the instance data are drawn together, where the first of them is drawn.
+			//  They're sorted by the hash of what they share. The low 32 bits are the position in the render queue, so
+			//  the first one comes first.
+			instancing_items_.clear();
+			for (size_t i = 0; i < render_queue_items_.size(); ++ i)
+			{
+				Renderable* renderable = render_queue_items_[i].renderable;
+				if (HasInstanceData(*renderable) && !renderable->GetRenderTechnique()->Transparent())
+				{
+					instancing_items_.push_back(RenderQueueItem{ (static_cast<uint64_t>(ShareDrawHash(*renderable)) << 32) | i, renderable });
 				}
+			}
+			RadixSort(instancing_items_, render_queue_scratch_, item_key);
 
-				std::sort(min_depths.begin(), min_depths.end());
+			for (size_t begin = 0; begin < instancing_items_.size();)
+			{
+				uint64_t const hash = instancing_items_[begin].key >> 32;
+				size_t end = begin + 1;
+				while ((end < instancing_items_.size()) && ((instancing_items_[end].key >> 32) == hash))
+				{
+					++ end;
+				}
 
-				std::vector<Renderable*> sorted_items(min_depths.size());
-				for (size_t j = 0; j < min_depths.size(); ++ j)
+				// Usually all of them share a draw. Only the ones left by a hash collision take another pass.
+				for (size_t i = begin; i < end; ++ i)
 				{
-					sorted_items[j] = items.second[min_depths[j].second];
+					Renderable* renderable = instancing_items_[i].renderable;
+					if (!renderable)
+					{
+						continue;
+					}
+
+					bool collided = false;
+					for (size_t j = i + 1; j < end; ++ j)
+					{
+						Renderable* other = instancing_items_[j].renderable;
+						if (other)
+						{
+							if (CanShareDraw(*renderable, *other))
+							{
+								for (uint32_t k = 0; k < other->NumInstances(); ++ k)
+								{
+									renderable->AddInstance(other->GetInstance(k));
+								}
+								instancing_items_[j].renderable = nullptr;
+								render_queue_items_[instancing_items_[j].key & 0xFFFFFFFFU].renderable = nullptr;
+							}
+							else
+							{
+								collided = true;
+							}
+						}
+					}
+					if (!collided)
+					{
+						break;
+					}
 				}
-				items.second.swap(sorted_items);
+
+				begin = end;
 			}
+		}
 
-			for (auto const & item : items.second)
+		// The ones merged into an instanced draw aren't rendered on their own, so they aren't counted
+		for (auto const & item : render_queue_items_)
+		{
+			if (item.renderable)
 			{
-				item->Render();
+				item.renderable->Render();
+				++ num_renderables_rendered_;
 			}
-			num_renderables_rendered_ += static_cast<uint32_t>(items.second.size());
 		}
 		render_queue_.resize(0);
 
@@ -775,10 +978,61 @@ namespace KlayGE
 
 		num_draw_calls_ = re.NumDrawsJustCalled();
 		num_dispatch_calls_ = re.NumDispatchesJustCalled();
+		PerfProfiler::Instance().Counter("Draw calls", num_draw_calls_);
+
+		if (instance_buffer_)
+		{
+			for (auto const & alloc : instance_allocs_)
+			{
+				instance_buffer_->Dealloc(alloc);
+			}
+			instance_allocs_.clear();
+			instance_buffer_->OnPresent();
+		}
+	}
+
+	void SceneManager::AutoInstancing(bool auto_instancing)
+	{
+		auto_instancing_ = auto_instancing;
+	}
+
+	bool SceneManager::AutoInstancing() const
+	{
+		return auto_instancing_;
+	}
+
+	GraphicsBufferPtr const & SceneManager::PackInstances(uint32_t& start_instance, std::vector<SceneObject const *> const & objs,
+		uint32_t instance_size)
+	{
+		BOOST_ASSERT(!objs.empty());
+
+		uint32_t const size = static_cast<uint32_t>(objs.size() * instance_size);
+		if (!instance_buffer_)
+		{
+			instance_buffer_ = MakeUniquePtr<TransientBuffer>(std::max(size, 64U * 1024), TransientBuffer::BF_Vertex);
+		}
+
+		// Gathered in system memory first, so the mapped buffer only sees one sequential copy
+		instance_data_.resize(size);
+		for (size_t i = 0; i < objs.size(); ++ i)
+		{
+			std::memcpy(&instance_data_[i * instance_size], objs[i]->InstanceData(), instance_size);
+		}
+
+		SubAlloc const alloc = instance_buffer_->Alloc(size, &instance_data_[0], instance_size);
+		instance_allocs_.push_back(alloc);
+		// Renderables pack their instances right before they draw, so this runs once per renderable. It only uploads
+		//  this alloc.
+		instance_buffer_->EnsureDataReady();
+
+		start_instance = alloc.offset_ / instance_size;
+		return instance_buffer_->GetBuffer();
 	}
 
 	void SceneManager::UpdateThreadFunc()
 	{
+		PerfProfiler::Instance().ThreadName("SceneManager update");
+
 		Timer timer;
 		float app_time = 0;
 		while (!quit_)
@@ -792,6 +1046,7 @@ namespace KlayGE
 				WindowPtr const & win = Context::Instance().AppInstance().MainWnd();
 				if (win && win->Active())
 				{
+					PerfEventScope scope("SceneManager::SubThreadUpdate");
 					std::lock_guard<std::mutex> lock(update_mutex_);
 
 					for (auto const & scene_obj : scene_objs_)
@@ -812,6 +1067,115 @@ namespace KlayGE
 		}
 	}
 
+	void SceneManager::UpdateTransforms()
+	{
+		transforms_.Update(&Context::Instance().TaskScheduler());
+
+		// Renderables could be shared by many objects, so the matrices go to them serially
+		for (auto node : transforms_.UpdatedNodes())
+		{
+			transform_objs_[node]->SyncAbsModelMatrix();
+		}
+	}
+
+	void SceneManager::ClipRootObjects(Camera const & camera, float4x4 const & view_proj, bool skip_static_cullable,
+		bool skip_moveable_cullable)
+	{
+		// Each task takes a multiple of 4 objects, so a SIMD batch never straddles two tasks
+		uint32_t const BATCHES_PER_TASK = 64;
+
+		uint32_t const num_objs = static_cast<uint32_t>(scene_objs_.size());
+		uint32_t const num_padded = (num_objs + 3) & ~3U;
+		for (auto& soa : aabbs_ws_soa_)
+		{
+			soa.resize(num_padded);
+		}
+		frustum_results_.resize(num_padded);
+
+		bool const test_frustum = frustum_ && !camera.OmniDirectionalMode();
+		float3 const & view_dir = camera.ForwardVec();
+		float3 const & eye_pos = camera.EyePos();
+
+		Context::Instance().TaskScheduler().parallel_for(0, num_padded / 4, BATCHES_PER_TASK,
+			[this, &view_dir, &eye_pos, &view_proj, num_objs, test_frustum, skip_static_cullable, skip_moveable_cullable](
+				uint32_t first_batch, uint32_t last_batch)
+			{
+				uint32_t const first = first_batch * 4;
+				uint32_t const last = std::min(last_batch * 4, num_objs);
+
+				for (uint32_t i = first; i < last_batch * 4; ++ i)
+				{
+					AABBox aabb_ws(float3(0, 0, 0), float3(0, 0, 0));
+					if (i < num_objs)
+					{
+						SceneObject* so = scene_objs_[i].get();
+						uint32_t const attr = so->Attrib();
+						if (!so->Parent() && so->Visible())
+						{
+							if ((attr & SceneObject::SOA_Cullable)
+								&& !IsSkippedCullable(attr, skip_static_cullable, skip_moveable_cullable))
+							{
+								aabb_ws = so->PosBoundWS();
+							}
+						}
+					}
+
+					aabbs_ws_soa_[0][i] = aabb_ws.Min().x();
+					aabbs_ws_soa_[1][i] = aabb_ws.Min().y();
+					aabbs_ws_soa_[2][i] = aabb_ws.Min().z();
+					aabbs_ws_soa_[3][i] = aabb_ws.Max().x();
+					aabbs_ws_soa_[4][i] = aabb_ws.Max().y();
+					aabbs_ws_soa_[5][i] = aabb_ws.Max().z();
+				}
+
+				if (test_frustum)
+				{
+					SIMDMathLib::IntersectAABBFrustum(&frustum_results_[first],
+						&aabbs_ws_soa_[0][first], &aabbs_ws_soa_[1][first], &aabbs_ws_soa_[2][first],
+						&aabbs_ws_soa_[3][first], &aabbs_ws_soa_[4][first], &aabbs_ws_soa_[5][first],
+						last - first, *frustum_);
+				}
+
+				for (uint32_t i = first; i < last; ++ i)
+				{
+					SceneObject* so = scene_objs_[i].get();
+					uint32_t const attr = so->Attrib();
+					if (so->Parent() || IsSkippedCullable(attr, skip_static_cullable, skip_moveable_cullable))
+					{
+						continue;
+					}
+
+					BoundOverlap visible;
+					if (so->Visible())
+					{
+						if (attr & SceneObject::SOA_Cullable)
+						{
+							if ((small_obj_threshold_ > 0)
+								&& ((MathLib::ortho_area(view_dir, so->PosBoundWS()) <= small_obj_threshold_)
+									|| (MathLib::perspective_area(eye_pos, view_proj, so->PosBoundWS()) <= small_obj_threshold_)))
+							{
+								visible = BO_No;
+							}
+							else
+							{
+								visible = test_frustum ? frustum_results_[i] : BO_Yes;
+							}
+						}
+						else
+						{
+							visible = BO_Yes;
+						}
+					}
+					else
+					{
+						visible = BO_No;
+					}
+
+					so->VisibleMark(visible);
+				}
+			});
+	}
+
 	BoundOverlap SceneManager::VisibleTestFromParent(SceneObject* obj, float3 const & view_dir, float3 const & eye_pos,
 		float4x4 const & view_proj)
 	{
@@ -826,11 +1190,6 @@ namespace KlayGE
 			else
 			{
 				uint32_t const attr = obj->Attrib();
-				if (attr & SceneObject::SOA_Moveable)
-				{
-					obj->UpdateAbsModelMatrix();
-				}
-
 				if (attr & SceneObject::SOA_Cullable)
 				{
 					if (small_obj_threshold_ > 0)
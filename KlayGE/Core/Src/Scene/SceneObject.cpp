@@ -19,6 +19,7 @@
 #include <KlayGE/Context.hpp>
 #include <KFL/Math.hpp>
 #include <KlayGE/Renderable.hpp>
+#include <KlayGE/TransformHierarchy.hpp>
 
 #include <boost/assert.hpp>
 
@@ -29,6 +30,7 @@ namespace KlayGE
 	SceneObject::SceneObject(uint32_t attrib)
 		: attrib_(attrib), parent_(nullptr), renderable_hw_res_ready_(false),
 			model_(float4x4::Identity()), abs_model_(float4x4::Identity()),
+			transforms_(nullptr), transform_node_(TransformHierarchy::INVALID_NODE),
 			visible_mark_(BO_No)
 	{
 		if (!(attrib & SOA_Overlay) && (attrib & (SOA_Cullable | SOA_Moveable)))
@@ -49,6 +51,17 @@ namespace KlayGE
 	void SceneObject::Parent(SceneObject* so)
 	{
 		parent_ = so;
+		if (transforms_)
+		{
+			// Already in a scene manager, so the parent has to be there too
+			uint32_t parent_node = TransformHierarchy::INVALID_NODE;
+			if (so)
+			{
+				BOOST_ASSERT(so->transforms_ == transforms_);
+				parent_node = so->TransformNode();
+			}
+			transforms_->Parent(transform_node_, parent_node);
+		}
 	}
 
 	uint32_t SceneObject::NumChildren() const
@@ -70,6 +83,10 @@ namespace KlayGE
 	void SceneObject::ModelMatrix(float4x4 const & mat)
 	{
 		model_ = mat;
+		if (transforms_)
+		{
+			transforms_->LocalMatrix(transform_node_, mat);
+		}
 	}
 
 	float4x4 const & SceneObject::ModelMatrix() const
@@ -88,23 +105,72 @@ namespace KlayGE
 	}
 
 	void SceneObject::UpdateAbsModelMatrix()
+	{
+		if (transforms_)
+		{
+			if (renderable_)
+			{
+				if (pos_aabb_ws_)
+				{
+					transforms_->LocalBound(transform_node_, renderable_->PosBound());
+				}
+				else
+				{
+					renderable_->ModelMatrix(abs_model_);
+				}
+			}
+		}
+		else
+		{
+			this->CalcAbsModelMatrix();
+
+			if (renderable_)
+			{
+				renderable_->ModelMatrix(abs_model_);
+			}
+		}
+	}
+
+	void SceneObject::CalcAbsModelMatrix()
 	{
 		if (parent_)
 		{
-			abs_model_ = parent_->ModelMatrix() * model_;
+			abs_model_ = model_ * parent_->AbsModelMatrix();
 		}
 		else
 		{
 			abs_model_ = model_;
 		}
 
-		if (renderable_)
+		if (renderable_ && pos_aabb_ws_)
 		{
-			if (pos_aabb_ws_)
-			{
-				*pos_aabb_ws_ = MathLib::transform_aabb(renderable_->PosBound(), abs_model_);
-			}
+			*pos_aabb_ws_ = MathLib::transform_aabb(renderable_->PosBound(), abs_model_);
+		}
+	}
+
+	void SceneObject::TransformNode(TransformHierarchy* transforms, uint32_t node)
+	{
+		transforms_ = transforms;
+		transform_node_ = node;
+	}
+
+	uint32_t SceneObject::TransformNode() const
+	{
+		return transform_node_;
+	}
 
+	void SceneObject::SyncAbsModelMatrix()
+	{
+		BOOST_ASSERT(transforms_);
+
+		abs_model_ = transforms_->WorldMatrix(transform_node_);
+		if (pos_aabb_ws_)
+		{
+			*pos_aabb_ws_ = transforms_->WorldBound(transform_node_);
+		}
+
+		if (renderable_)
+		{
 			renderable_->ModelMatrix(abs_model_);
 		}
 	}
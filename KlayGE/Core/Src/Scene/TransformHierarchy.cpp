@@ -0,0 +1,511 @@
+/**
+ * @file TransformHierarchy.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Math.hpp>
+
+#include <algorithm>
+
+#include <boost/assert.hpp>
+
+#if defined(KLAYGE_SSE2_SUPPORT) && !defined(KLAYGE_COMPILER_CLANGC2)
+#define TRANSFORM_HIERARCHY_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <KlayGE/TransformHierarchy.hpp>
+
+namespace
+{
+	using namespace KlayGE;
+
+	// Nodes of one level updated by a task at least
+	uint32_t const UPDATE_GRAIN = 512;
+
+	// A new bound only changes the node itself, a new matrix changes the whole subtree
+	uint8_t const DIRTY_BOUND = 1U << 0;
+	uint8_t const DIRTY_MATRIX = 1U << 1;
+
+	// Row vectors, so it's the local matrix of the child times the world matrix of the parent
+	void MulMatrix(float4x4& out, float4x4 const & lhs, float4x4 const & rhs)
+	{
+#ifdef TRANSFORM_HIERARCHY_SSE2
+		float const * a = &lhs(0, 0);
+		float const * b = &rhs(0, 0);
+		__m128 const r0 = _mm_load_ps(b + 0);
+		__m128 const r1 = _mm_load_ps(b + 4);
+		__m128 const r2 = _mm_load_ps(b + 8);
+		__m128 const r3 = _mm_load_ps(b + 12);
+		for (int i = 0; i < 4; ++ i)
+		{
+			__m128 v = _mm_mul_ps(_mm_set1_ps(a[i * 4 + 0]), r0);
+			v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 1]), r1));
+			v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 2]), r2));
+			v = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(a[i * 4 + 3]), r3));
+			_mm_store_ps(&out(i, 0), v);
+		}
+#else
+		out = lhs * rhs;
+#endif
+	}
+
+	// Transforms the center, and sums the absolute values of the rotated and scaled extent. It's the exact bound
+	//  of the transformed box for affine matrices.
+	void TransformBound(float4* out, float4 const * bound, float4x4 const & mat)
+	{
+#ifdef TRANSFORM_HIERARCHY_SSE2
+		float const * m = &mat(0, 0);
+		__m128 const r0 = _mm_load_ps(m + 0);
+		__m128 const r1 = _mm_load_ps(m + 4);
+		__m128 const r2 = _mm_load_ps(m + 8);
+		__m128 const r3 = _mm_load_ps(m + 12);
+		__m128 const abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+		float const * c = &bound[0].x();
+		float const * e = &bound[1].x();
+		__m128 center = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(c[0]), r0), r3);
+		center = _mm_add_ps(center, _mm_mul_ps(_mm_set1_ps(c[1]), r1));
+		center = _mm_add_ps(center, _mm_mul_ps(_mm_set1_ps(c[2]), r2));
+		__m128 extent = _mm_mul_ps(_mm_set1_ps(e[0]), _mm_and_ps(r0, abs_mask));
+		extent = _mm_add_ps(extent, _mm_mul_ps(_mm_set1_ps(e[1]), _mm_and_ps(r1, abs_mask)));
+		extent = _mm_add_ps(extent, _mm_mul_ps(_mm_set1_ps(e[2]), _mm_and_ps(r2, abs_mask)));
+		_mm_store_ps(&out[0].x(), center);
+		_mm_store_ps(&out[1].x(), extent);
+#else
+		float4 const & c = bound[0];
+		float4 const & e = bound[1];
+		for (int i = 0; i < 4; ++ i)
+		{
+			out[0][i] = c.x() * mat(0, i) + c.y() * mat(1, i) + c.z() * mat(2, i) + mat(3, i);
+			out[1][i] = e.x() * MathLib::abs(mat(0, i)) + e.y() * MathLib::abs(mat(1, i)) + e.z() * MathLib::abs(mat(2, i));
+		}
+#endif
+	}
+}
+
+namespace KlayGE
+{
+	TransformHierarchy::TransformHierarchy()
+		: sorted_(true), min_dirty_depth_(INVALID_NODE)
+	{
+	}
+
+	uint32_t TransformHierarchy::AddNode(uint32_t parent, float4x4 const & local)
+	{
+		BOOST_ASSERT((INVALID_NODE == parent) || (node_indices_[parent] != INVALID_NODE));
+
+		uint32_t node;
+		if (free_nodes_.empty())
+		{
+			node = static_cast<uint32_t>(node_indices_.size());
+			node_parents_.push_back(parent);
+			node_depths_.push_back(0);
+			node_indices_.push_back(0);
+			node_num_children_.push_back(0);
+		}
+		else
+		{
+			node = free_nodes_.back();
+			free_nodes_.pop_back();
+			node_parents_[node] = parent;
+			node_num_children_[node] = 0;
+		}
+
+		uint32_t const index = static_cast<uint32_t>(handles_.size());
+		node_indices_[node] = index;
+		if (INVALID_NODE == parent)
+		{
+			node_depths_[node] = 0;
+			parents_.push_back(parent);
+		}
+		else
+		{
+			node_depths_[node] = node_depths_[parent] + 1;
+			parents_.push_back(node_indices_[parent]);
+			++ node_num_children_[parent];
+		}
+
+		// Appended for now, and moved to its level by the next Update
+		handles_.push_back(node);
+		locals_.push_back(local);
+		worlds_.push_back(local);
+		local_bounds_.push_back(float4(0, 0, 0, 1));
+		local_bounds_.push_back(float4(0, 0, 0, 0));
+		world_bounds_.push_back(float4(0, 0, 0, 1));
+		world_bounds_.push_back(float4(0, 0, 0, 0));
+		dirty_.push_back(0);
+		this->MarkDirty(node, index, DIRTY_MATRIX | DIRTY_BOUND);
+		sorted_ = false;
+
+		return node;
+	}
+
+	void TransformHierarchy::DelNode(uint32_t node)
+	{
+		BOOST_ASSERT(node_indices_[node] != INVALID_NODE);
+		BOOST_ASSERT(0 == node_num_children_[node]);
+
+		uint32_t const parent = node_parents_[node];
+		if (parent != INVALID_NODE)
+		{
+			-- node_num_children_[parent];
+		}
+
+		// The slot is dropped by the next sort
+		uint32_t const index = node_indices_[node];
+		handles_[index] = INVALID_NODE;
+		dirty_[index] = 0;
+		node_indices_[node] = INVALID_NODE;
+		free_nodes_.push_back(node);
+		sorted_ = false;
+	}
+
+	void TransformHierarchy::Clear()
+	{
+		node_parents_.clear();
+		node_depths_.clear();
+		node_indices_.clear();
+		node_num_children_.clear();
+		free_nodes_.clear();
+
+		handles_.clear();
+		parents_.clear();
+		locals_.clear();
+		worlds_.clear();
+		local_bounds_.clear();
+		world_bounds_.clear();
+		dirty_.clear();
+
+		level_ends_.clear();
+		sorted_ = true;
+		min_dirty_depth_ = INVALID_NODE;
+
+		updated_nodes_.clear();
+	}
+
+	uint32_t TransformHierarchy::NumNodes() const
+	{
+		return static_cast<uint32_t>(node_indices_.size() - free_nodes_.size());
+	}
+
+	void TransformHierarchy::Parent(uint32_t node, uint32_t parent)
+	{
+		BOOST_ASSERT(node_indices_[node] != INVALID_NODE);
+		BOOST_ASSERT((INVALID_NODE == parent) || (node_indices_[parent] != INVALID_NODE));
+
+		uint32_t const old_parent = node_parents_[node];
+		if (old_parent == parent)
+		{
+			return;
+		}
+
+#ifdef KLAYGE_DEBUG
+		for (uint32_t p = parent; p != INVALID_NODE; p = node_parents_[p])
+		{
+			BOOST_ASSERT(p != node);
+		}
+#endif
+
+		if (old_parent != INVALID_NODE)
+		{
+			-- node_num_children_[old_parent];
+		}
+		if (parent != INVALID_NODE)
+		{
+			++ node_num_children_[parent];
+		}
+		node_parents_[node] = parent;
+		node_depths_[node] = (INVALID_NODE == parent) ? 0 : node_depths_[parent] + 1;
+
+		// There are no child lists, so every node walks up until it reaches a node it knows is in the subtree or not.
+		//  The depths in the subtree are set on the way back down.
+		uint8_t const UNKNOWN = 0;
+		uint8_t const IN_SUBTREE = 1;
+		uint8_t const OUT_OF_SUBTREE = 2;
+		std::vector<uint8_t> states(node_indices_.size(), UNKNOWN);
+		states[node] = IN_SUBTREE;
+		std::vector<uint32_t> path;
+		for (uint32_t n = 0; n < node_indices_.size(); ++ n)
+		{
+			if ((node_indices_[n] == INVALID_NODE) || (states[n] != UNKNOWN))
+			{
+				continue;
+			}
+
+			uint32_t p = n;
+			while ((p != INVALID_NODE) && (UNKNOWN == states[p]))
+			{
+				path.push_back(p);
+				p = node_parents_[p];
+			}
+
+			uint8_t const state = (INVALID_NODE == p) ? OUT_OF_SUBTREE : states[p];
+			for (auto iter = path.rbegin(); iter != path.rend(); ++ iter)
+			{
+				states[*iter] = state;
+				if (IN_SUBTREE == state)
+				{
+					node_depths_[*iter] = node_depths_[node_parents_[*iter]] + 1;
+				}
+			}
+			path.clear();
+		}
+
+		sorted_ = false;
+		this->MarkDirty(node, node_indices_[node], DIRTY_MATRIX);
+	}
+
+	uint32_t TransformHierarchy::Parent(uint32_t node) const
+	{
+		return node_parents_[node];
+	}
+
+	uint32_t TransformHierarchy::Depth(uint32_t node) const
+	{
+		return node_depths_[node];
+	}
+
+	void TransformHierarchy::LocalMatrix(uint32_t node, float4x4 const & mat)
+	{
+		uint32_t const index = node_indices_[node];
+		if (!(locals_[index] == mat))
+		{
+			locals_[index] = mat;
+			this->MarkDirty(node, index, DIRTY_MATRIX);
+		}
+	}
+
+	float4x4 const & TransformHierarchy::LocalMatrix(uint32_t node) const
+	{
+		return locals_[node_indices_[node]];
+	}
+
+	void TransformHierarchy::LocalBound(uint32_t node, AABBox const & aabb)
+	{
+		uint32_t const index = node_indices_[node];
+		float3 const center = aabb.Center();
+		float3 const extent = aabb.HalfSize();
+		local_bounds_[index * 2 + 0] = float4(center.x(), center.y(), center.z(), 1);
+		local_bounds_[index * 2 + 1] = float4(extent.x(), extent.y(), extent.z(), 0);
+		this->MarkDirty(node, index, DIRTY_BOUND);
+	}
+
+	AABBox TransformHierarchy::LocalBound(uint32_t node) const
+	{
+		uint32_t const index = node_indices_[node];
+		float3 const center(&local_bounds_[index * 2 + 0].x());
+		float3 const extent(&local_bounds_[index * 2 + 1].x());
+		return AABBox(center - extent, center + extent);
+	}
+
+	float4x4 const & TransformHierarchy::WorldMatrix(uint32_t node) const
+	{
+		return worlds_[node_indices_[node]];
+	}
+
+	AABBox TransformHierarchy::WorldBound(uint32_t node) const
+	{
+		uint32_t const index = node_indices_[node];
+		float3 const center(&world_bounds_[index * 2 + 0].x());
+		float3 const extent(&world_bounds_[index * 2 + 1].x());
+		return AABBox(center - extent, center + extent);
+	}
+
+	bool TransformHierarchy::Dirty(uint32_t node) const
+	{
+		return dirty_[node_indices_[node]] != 0;
+	}
+
+	void TransformHierarchy::Update(task_scheduler* scheduler)
+	{
+		updated_nodes_.clear();
+		uint32_t const min_dirty_depth = min_dirty_depth_;
+		if (INVALID_NODE == min_dirty_depth)
+		{
+			return;
+		}
+
+		if (!sorted_)
+		{
+			this->Sort();
+		}
+
+		// Levels above the first dirty node are clean
+		uint32_t const start = (0 == min_dirty_depth) ? 0 : level_ends_[min_dirty_depth - 1];
+		uint32_t first = start;
+		for (uint32_t level = min_dirty_depth; level < level_ends_.size(); ++ level)
+		{
+			uint32_t const last = level_ends_[level];
+			if (scheduler)
+			{
+				scheduler->parallel_for(first, last, UPDATE_GRAIN,
+					[this](uint32_t range_first, uint32_t range_last)
+					{
+						this->UpdateRange(range_first, range_last);
+					});
+			}
+			else
+			{
+				this->UpdateRange(first, last);
+			}
+			first = last;
+		}
+
+		uint32_t const num = static_cast<uint32_t>(handles_.size());
+		for (uint32_t i = start; i < num; ++ i)
+		{
+			if (dirty_[i])
+			{
+				updated_nodes_.push_back(handles_[i]);
+				dirty_[i] = 0;
+			}
+		}
+		min_dirty_depth_ = INVALID_NODE;
+	}
+
+	std::vector<uint32_t> const & TransformHierarchy::UpdatedNodes() const
+	{
+		return updated_nodes_;
+	}
+
+	void TransformHierarchy::MarkDirty(uint32_t node, uint32_t index, uint8_t flags)
+	{
+		dirty_[index] |= flags;
+
+		// Objects could be moved by different threads
+		uint32_t const depth = node_depths_[node];
+		uint32_t min_depth = min_dirty_depth_;
+		while ((depth < min_depth) && !min_dirty_depth_.compare_exchange_weak(min_depth, depth))
+		{
+		}
+	}
+
+	// A stable counting sort by depth, which also drops deleted slots
+	void TransformHierarchy::Sort()
+	{
+		uint32_t const num_old = static_cast<uint32_t>(handles_.size());
+
+		level_ends_.clear();
+		for (uint32_t i = 0; i < num_old; ++ i)
+		{
+			uint32_t const node = handles_[i];
+			if (node != INVALID_NODE)
+			{
+				uint32_t const depth = node_depths_[node];
+				if (depth >= level_ends_.size())
+				{
+					level_ends_.resize(depth + 1, 0);
+				}
+				++ level_ends_[depth];
+			}
+		}
+		std::vector<uint32_t> offsets(level_ends_.size());
+		uint32_t num = 0;
+		for (size_t level = 0; level < level_ends_.size(); ++ level)
+		{
+			offsets[level] = num;
+			num += level_ends_[level];
+			level_ends_[level] = num;
+		}
+
+		std::vector<uint32_t> handles(num);
+		std::vector<uint32_t> parents(num);
+		std::vector<float4x4, aligned_allocator<float4x4, 16>> locals(num);
+		std::vector<float4x4, aligned_allocator<float4x4, 16>> worlds(num);
+		std::vector<float4, aligned_allocator<float4, 16>> local_bounds(num * 2);
+		std::vector<float4, aligned_allocator<float4, 16>> world_bounds(num * 2);
+		std::vector<uint8_t> dirty(num);
+		for (uint32_t i = 0; i < num_old; ++ i)
+		{
+			uint32_t const node = handles_[i];
+			if (node != INVALID_NODE)
+			{
+				uint32_t const index = offsets[node_depths_[node]];
+				++ offsets[node_depths_[node]];
+
+				handles[index] = node;
+				locals[index] = locals_[i];
+				worlds[index] = worlds_[i];
+				local_bounds[index * 2 + 0] = local_bounds_[i * 2 + 0];
+				local_bounds[index * 2 + 1] = local_bounds_[i * 2 + 1];
+				world_bounds[index * 2 + 0] = world_bounds_[i * 2 + 0];
+				world_bounds[index * 2 + 1] = world_bounds_[i * 2 + 1];
+				dirty[index] = dirty_[i];
+				node_indices_[node] = index;
+			}
+		}
+		for (uint32_t i = 0; i < num; ++ i)
+		{
+			uint32_t const parent = node_parents_[handles[i]];
+			parents[i] = (INVALID_NODE == parent) ? parent : node_indices_[parent];
+		}
+
+		handles_.swap(handles);
+		parents_.swap(parents);
+		locals_.swap(locals);
+		worlds_.swap(worlds);
+		local_bounds_.swap(local_bounds);
+		world_bounds_.swap(world_bounds);
+		dirty_.swap(dirty);
+		sorted_ = true;
+	}
+
+	// Parents are in the levels before, so they are done, and their dirty flags are final
+	void TransformHierarchy::UpdateRange(uint32_t first, uint32_t last)
+	{
+		for (uint32_t i = first; i < last; ++ i)
+		{
+			uint32_t const parent = parents_[i];
+			uint8_t dirty = dirty_[i];
+			if ((parent != INVALID_NODE) && (dirty_[parent] & DIRTY_MATRIX))
+			{
+				dirty |= DIRTY_MATRIX;
+			}
+			if (!dirty)
+			{
+				continue;
+			}
+
+			if (dirty & DIRTY_MATRIX)
+			{
+				dirty_[i] = dirty;
+				if (INVALID_NODE == parent)
+				{
+					worlds_[i] = locals_[i];
+				}
+				else
+				{
+					MulMatrix(worlds_[i], locals_[i], worlds_[parent]);
+				}
+			}
+			TransformBound(&world_bounds_[i * 2], &local_bounds_[i * 2], worlds_[i]);
+		}
+	}
+}
@@ -30,6 +30,7 @@
 #include <KFL/AABBox.hpp>
 
 #include <vector>
+#include <unordered_map>
 
 namespace KlayGE
 {
@@ -41,6 +42,11 @@ namespace KlayGE
 		void MaxTreeDepth(uint32_t max_tree_depth);
 		uint32_t MaxTreeDepth() const;
 
+		// Moveable objects are kept in the tree too, and re-inserted only when they leave the loose bound of their node.
+		//  Disable it to test them linearly in batches instead.
+		void MoveableObjectsInTree(bool in_tree);
+		bool MoveableObjectsInTree() const;
+
 		virtual void ClipScene() override;
 
 		virtual BoundOverlap AABBVisible(AABBox const & aabb) const override;
@@ -55,9 +61,14 @@ namespace KlayGE
 		virtual void DoSuspend() override;
 		virtual void DoResume() override;
 
-		void DivideNode(size_t index, uint32_t curr_depth);
-		void NodeVisible(size_t index);
-		void MarkNodeObjs(size_t index, bool force);
+		bool InTree(SceneObject const & so) const;
+		void RebuildTree();
+		void InsertObject(SceneObject* so);
+		void RemoveObject(SceneObject* so);
+		void RelocateMoveableObjects();
+		void CreateChildren(size_t index);
+		void MarkNodeObjs(size_t index, bool force, float3 const & view_dir, float3 const & eye_pos,
+			float4x4 const & view_proj);
 
 		BoundOverlap BoundVisible(size_t index, AABBox const & aabb) const;
 		BoundOverlap BoundVisible(size_t index, OBBox const & obb) const;
@@ -69,18 +80,26 @@ namespace KlayGE
 		OCTree& operator=(OCTree const & rhs);
 
 	private:
+		// A loose octree. Each object lives in exactly one node, the deepest one whose loose bound (the cell doubled)
+		//  contains it. Children are created on demand and kept until the tree is rebuilt.
 		struct octree_node_t
 		{
 			AABBox bb;
+			AABBox loose_bb;
 			int first_child_index;
+			int parent_index;
+			uint32_t depth;
+			uint32_t num_subtree_objs;
 			BoundOverlap visible;
 
 			std::vector<SceneObject*> obj_ptrs;
 		};
 
 		std::vector<octree_node_t> octree_;
+		std::unordered_map<SceneObject*, int> obj_node_indices_;
 
 		uint32_t max_tree_depth_;
+		bool moveable_in_tree_;
 
 		bool rebuild_tree_;
 
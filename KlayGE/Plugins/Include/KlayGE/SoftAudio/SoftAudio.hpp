@@ -0,0 +1,145 @@
+/**
+ * @file SoftAudio.hpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#ifndef KLAYGE_PLUGINS_SOFT_AUDIO_HPP
+#define KLAYGE_PLUGINS_SOFT_AUDIO_HPP
+
+#pragma once
+
+#include <KlayGE/PreDeclare.hpp>
+
+#include <vector>
+
+#include <KlayGE/Audio.hpp>
+
+namespace KlayGE
+{
+	class SoftSoundBuffer : public SoundBuffer
+	{
+	public:
+		SoftSoundBuffer(AudioDataSourcePtr const & data_source, uint32_t num_sources, float volume);
+		~SoftSoundBuffer() override;
+
+		void Play(bool loop = false) override;
+		void Stop() override;
+		void Reset() override;
+
+		void Volume(float vol) override;
+
+		bool IsPlaying() const override;
+
+		float3 Position() const override;
+		void Position(float3 const & v) override;
+		float3 Velocity() const override;
+		void Velocity(float3 const & v) override;
+		float3 Direction() const override;
+		void Direction(float3 const & v) override;
+
+	private:
+		void DoReset() override;
+
+	private:
+		AudioMixerPtr mixer_;
+		std::vector<uint32_t> voices_;
+
+		float3 pos_;
+		float3 vel_;
+		float3 dir_;
+	};
+
+	class SoftMusicBuffer : public MusicBuffer
+	{
+	public:
+		SoftMusicBuffer(AudioDataSourcePtr const & data_source, uint32_t buffer_seconds, float volume);
+		~SoftMusicBuffer() override;
+
+		void Volume(float vol) override;
+
+		bool IsPlaying() const override;
+
+		float3 Position() const override;
+		void Position(float3 const & v) override;
+		float3 Velocity() const override;
+		void Velocity(float3 const & v) override;
+		float3 Direction() const override;
+		void Direction(float3 const & v) override;
+
+	private:
+		void DoReset() override;
+		void DoPlay(bool loop) override;
+		void DoStop() override;
+
+	private:
+		AudioMixerPtr mixer_;
+		uint32_t voice_;
+
+		float3 pos_;
+		float3 vel_;
+		float3 dir_;
+	};
+
+	// Mixes in software on one thread, see AudioMixer. Writes to a null sink unless another one is set to the mixer.
+	//  There is no device sink yet, so it isn't one of the available audio factories. Load it with
+	//  Context::LoadAudioFactory("SoftAudio").
+	class SoftAudioEngine : public AudioEngine
+	{
+	public:
+		SoftAudioEngine();
+		~SoftAudioEngine() override;
+
+		std::wstring const & Name() const override;
+
+		AudioMixerPtr const & Mixer() const
+		{
+			return mixer_;
+		}
+
+		float3 GetListenerPos() const override;
+		void SetListenerPos(float3 const & v) override;
+		float3 GetListenerVel() const override;
+		void SetListenerVel(float3 const & v) override;
+		void GetListenerOri(float3& face, float3& up) const override;
+		void SetListenerOri(float3 const & face, float3 const & up) override;
+
+	private:
+		void DoSuspend() override;
+		void DoResume() override;
+
+	private:
+		AudioMixerPtr mixer_;
+
+		float3 pos_;
+		float3 vel_;
+		float3 face_;
+		float3 up_;
+	};
+}
+
+#endif		// KLAYGE_PLUGINS_SOFT_AUDIO_HPP
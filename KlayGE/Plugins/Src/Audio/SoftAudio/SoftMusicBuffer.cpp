@@ -0,0 +1,120 @@
+/**
+ * @file SoftMusicBuffer.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Util.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/AudioDataSource.hpp>
+#include <KlayGE/AudioFactory.hpp>
+#include <KlayGE/AudioMixer.hpp>
+
+#include <KlayGE/SoftAudio/SoftAudio.hpp>
+
+namespace KlayGE
+{
+	SoftMusicBuffer::SoftMusicBuffer(AudioDataSourcePtr const & data_source, uint32_t buffer_seconds, float volume)
+					: MusicBuffer(data_source),
+						mixer_(checked_cast<SoftAudioEngine*>(&Context::Instance().AudioFactoryInstance().AudioEngineInstance())->Mixer())
+	{
+		voice_ = mixer_->CreateVoice(data_source_, true, buffer_seconds);
+
+		this->Position(float3::Zero());
+		this->Velocity(float3::Zero());
+		this->Direction(float3::Zero());
+
+		this->Volume(volume);
+
+		this->Reset();
+	}
+
+	SoftMusicBuffer::~SoftMusicBuffer()
+	{
+		this->Stop();
+
+		mixer_->DestroyVoice(voice_);
+	}
+
+	void SoftMusicBuffer::DoReset()
+	{
+		// Not playing, so the mixer isn't reading it
+		data_source_->Reset();
+	}
+
+	void SoftMusicBuffer::DoPlay(bool loop)
+	{
+		mixer_->Play(voice_, loop);
+	}
+
+	void SoftMusicBuffer::DoStop()
+	{
+		mixer_->Stop(voice_);
+	}
+
+	bool SoftMusicBuffer::IsPlaying() const
+	{
+		return mixer_->IsPlaying(voice_);
+	}
+
+	void SoftMusicBuffer::Volume(float vol)
+	{
+		mixer_->Volume(voice_, vol);
+	}
+
+	float3 SoftMusicBuffer::Position() const
+	{
+		return pos_;
+	}
+
+	void SoftMusicBuffer::Position(float3 const & v)
+	{
+		pos_ = v;
+		mixer_->Position(voice_, v);
+	}
+
+	float3 SoftMusicBuffer::Velocity() const
+	{
+		return vel_;
+	}
+
+	void SoftMusicBuffer::Velocity(float3 const & v)
+	{
+		vel_ = v;
+	}
+
+	float3 SoftMusicBuffer::Direction() const
+	{
+		return dir_;
+	}
+
+	void SoftMusicBuffer::Direction(float3 const & v)
+	{
+		dir_ = v;
+	}
+}
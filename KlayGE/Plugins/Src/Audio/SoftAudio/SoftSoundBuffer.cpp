@@ -0,0 +1,163 @@
+/**
+ * @file SoftSoundBuffer.cpp
+ * @author Minmin Gong
+ *
+ * @section DESCRIPTION
+ *
+ * This source file is part of KlayGE
+ * For the latest info, see http://www.klayge.org
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published
+ * by the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *
+ * You may alternatively use this source under the terms of
+ * the KlayGE Proprietary License (KPL). You can obtained such a license
+ * from http://www.klayge.org/licensing/.
+ */
+
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Util.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/AudioFactory.hpp>
+#include <KlayGE/AudioMixer.hpp>
+
+#include <boost/assert.hpp>
+
+#include <KlayGE/SoftAudio/SoftAudio.hpp>
+
+namespace KlayGE
+{
+	SoftSoundBuffer::SoftSoundBuffer(AudioDataSourcePtr const & data_source, uint32_t num_sources, float volume)
+					: SoundBuffer(data_source),
+						mixer_(checked_cast<SoftAudioEngine*>(&Context::Instance().AudioFactoryInstance().AudioEngineInstance())->Mixer())
+	{
+		BOOST_ASSERT(num_sources > 0);
+
+		// The clones share the samples the mixer decodes
+		voices_.push_back(mixer_->CreateVoice(data_source_, false));
+		for (uint32_t i = 1; i < num_sources; ++ i)
+		{
+			voices_.push_back(mixer_->CloneVoice(voices_[0]));
+		}
+
+		this->Position(float3(0, 0, 0.1f));
+		this->Velocity(float3(0, 0, 0));
+		this->Direction(float3(0, 0, 0));
+
+		this->Reset();
+
+		this->Volume(volume);
+	}
+
+	SoftSoundBuffer::~SoftSoundBuffer()
+	{
+		this->Stop();
+
+		for (auto voice : voices_)
+		{
+			mixer_->DestroyVoice(voice);
+		}
+	}
+
+	void SoftSoundBuffer::Play(bool loop)
+	{
+		uint32_t voice = voices_[0];
+		for (auto v : voices_)
+		{
+			if (!mixer_->IsPlaying(v))
+			{
+				voice = v;
+				break;
+			}
+		}
+
+		mixer_->Position(voice, pos_);
+		mixer_->Play(voice, loop);
+	}
+
+	void SoftSoundBuffer::Stop()
+	{
+		for (auto voice : voices_)
+		{
+			mixer_->Stop(voice);
+		}
+	}
+
+	void SoftSoundBuffer::Reset()
+	{
+		// The mixer reads the data source on its thread until the sound is decoded, so it's not reset here
+		this->Stop();
+		this->DoReset();
+	}
+
+	void SoftSoundBuffer::DoReset()
+	{
+	}
+
+	bool SoftSoundBuffer::IsPlaying() const
+	{
+		for (auto voice : voices_)
+		{
+			if (mixer_->IsPlaying(voice))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void SoftSoundBuffer::Volume(float vol)
+	{
+		for (auto voice : voices_)
+		{
+			mixer_->Volume(voice, vol);
+		}
+	}
+
+	float3 SoftSoundBuffer::Position() const
+	{
+		return pos_;
+	}
+
+	void SoftSoundBuffer::Position(float3 const & v)
+	{
+		pos_ = v;
+		for (auto voice : voices_)
+		{
+			mixer_->Position(voice, v);
+		}
+	}
+
+	float3 SoftSoundBuffer::Velocity() const
+	{
+		return vel_;
+	}
+
+	void SoftSoundBuffer::Velocity(float3 const & v)
+	{
+		vel_ = v;
+	}
+
+	float3 SoftSoundBuffer::Direction() const
+	{
+		return dir_;
+	}
+
+	void SoftSoundBuffer::Direction(float3 const & v)
+	{
+		dir_ = v;
+	}
+}
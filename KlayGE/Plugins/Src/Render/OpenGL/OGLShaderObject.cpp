@@ -29,13 +29,16 @@
 #include <KFL/Matrix.hpp>
 #include <KlayGE/RenderEngine.hpp>
 #include <KlayGE/RenderEffect.hpp>
+#include <KlayGE/ResLoader.hpp>
 #include <KFL/Hash.hpp>
+#include <KFL/CXX17/filesystem.hpp>
 
 #include <cstdio>
 #include <string>
 #include <algorithm>
 #include <sstream>
 #include <cstring>
+#include <mutex>
 #include <boost/assert.hpp>
 #include <boost/lexical_cast.hpp>
 
@@ -164,6 +167,27 @@ namespace
 		RenderEffectParameter* tex_param_;
 		RenderEffectParameter* sampler_param_;
 	};
+
+	// Translations are kept next to the DXBC cache. Without a folder they are kept in memory only.
+	DXBC2GLSL::TranslationCache& GLSLTranslationCache()
+	{
+		static std::once_flag flag;
+		std::call_once(flag, []
+			{
+				std::string folder = ResLoader::Instance().LocalFolder() + "ShaderCache/";
+				try
+				{
+					std::filesystem::create_directories(folder);
+				}
+				catch (std::exception const & ex)
+				{
+					LogWarn("Can't create %s for the GLSL translations: %s", folder.c_str(), ex.what());
+					folder.clear();
+				}
+				DXBC2GLSL::TranslationCache::Instance().Folder(folder);
+			});
+		return DXBC2GLSL::TranslationCache::Instance();
+	}
 }
 
 namespace KlayGE
@@ -651,13 +675,13 @@ namespace KlayGE
 							gsv = GSV_410;
 						}
 
-						DXBC2GLSL::DXBC2GLSL dxbc2glsl;
 						uint32_t rules = DXBC2GLSL::DXBC2GLSL::DefaultRules(gsv);
 						rules &= ~GSR_UniformBlockBinding;
-						dxbc2glsl.FeedDXBC(&code[0],
+						std::shared_ptr<DXBC2GLSL::DXBC2GLSL const> translation = GLSLTranslationCache().Translate(&code[0],
 							has_gs, has_ps, static_cast<ShaderTessellatorPartitioning>(so_template_->ds_partitioning_),
 							static_cast<ShaderTessellatorOutputPrimitive>(so_template_->ds_output_primitive_),
 							gsv, rules);
+						DXBC2GLSL::DXBC2GLSL const & dxbc2glsl = *translation;
 						so_template_->glsl_srcs_[type] = MakeSharedPtr<std::string>(dxbc2glsl.GLSLString());
 						so_template_->pnames_[type] = MakeSharedPtr<std::vector<std::string>>();
 						so_template_->glsl_res_names_[type] = MakeSharedPtr<std::vector<std::string>>();
@@ -35,8 +35,12 @@
 #include <glloader/glloader.h>
 
 #if KLAYGE_IS_DEV_PLATFORM
+#include <KlayGE/ResLoader.hpp>
+#include <KFL/CXX17/filesystem.hpp>
 #include <DXBC2GLSL/DXBC2GLSL.hpp>
 
+#include <mutex>
+
 #ifndef D3DCOMPILE_SKIP_OPTIMIZATION
 #define D3DCOMPILE_SKIP_OPTIMIZATION 0x00000004
 #endif
@@ -161,6 +165,29 @@ namespace
 		RenderEffectParameter* tex_param_;
 		RenderEffectParameter* sampler_param_;
 	};
+
+#if KLAYGE_IS_DEV_PLATFORM
+	// Translations are kept next to the DXBC cache. Without a folder they are kept in memory only.
+	DXBC2GLSL::TranslationCache& GLSLTranslationCache()
+	{
+		static std::once_flag flag;
+		std::call_once(flag, []
+			{
+				std::string folder = ResLoader::Instance().LocalFolder() + "ShaderCache/";
+				try
+				{
+					std::filesystem::create_directories(folder);
+				}
+				catch (std::exception const & ex)
+				{
+					LogWarn("Can't create %s for the GLSL translations: %s", folder.c_str(), ex.what());
+					folder.clear();
+				}
+				DXBC2GLSL::TranslationCache::Instance().Folder(folder);
+			});
+		return DXBC2GLSL::TranslationCache::Instance();
+	}
+#endif
 }
 
 namespace KlayGE
@@ -612,7 +639,6 @@ namespace KlayGE
 							gsv = GSV_300_ES;
 						}
 
-						DXBC2GLSL::DXBC2GLSL dxbc2glsl;
 						uint32_t rules = DXBC2GLSL::DXBC2GLSL::DefaultRules(gsv);
 						rules &= ~GSR_UniformBlockBinding;
 						rules &= ~GSR_MatrixType;
@@ -622,10 +648,11 @@ namespace KlayGE
 						{
 							rules |= static_cast<uint32_t>(GSR_EXTTessellationShader);
 						}
-						dxbc2glsl.FeedDXBC(&code[0],
+						std::shared_ptr<DXBC2GLSL::DXBC2GLSL const> translation = GLSLTranslationCache().Translate(&code[0],
 							false, has_ps, static_cast<ShaderTessellatorPartitioning>(so_template_->ds_partitioning_),
 							static_cast<ShaderTessellatorOutputPrimitive>(so_template_->ds_output_primitive_),
 							gsv, rules);
+						DXBC2GLSL::DXBC2GLSL const & dxbc2glsl = *translation;
 						so_template_->glsl_srcs_[type] = MakeSharedPtr<std::string>(dxbc2glsl.GLSLString());
 						so_template_->pnames_[type] = MakeSharedPtr<std::vector<std::string>>();
 						so_template_->glsl_res_names_[type] = MakeSharedPtr<std::vector<std::string>>();
@@ -32,6 +32,7 @@
 #include <KlayGE/RenderableHelper.hpp>
 #include <KlayGE/Camera.hpp>
 #include <KlayGE/App3D.hpp>
+#include <KlayGE/Context.hpp>
 #include <KlayGE/DeferredRenderingLayer.hpp>
 
 #include <algorithm>
@@ -39,7 +40,6 @@
 #include <boost/assert.hpp>
 
 #ifdef KLAYGE_DRAW_NODES
-#include <KlayGE/Context.hpp>
 #include <KlayGE/RenderFactory.hpp>
 #include <KlayGE/RenderEffect.hpp>
 #endif
@@ -96,16 +96,45 @@ namespace
 }
 #endif
 
+namespace
+{
+	using namespace KlayGE;
+
+	AABBox LooseBound(AABBox const & bb)
+	{
+		float3 const half_size = bb.HalfSize();
+		return AABBox(bb.Min() - half_size, bb.Max() + half_size);
+	}
+
+	AABBox ChildBound(AABBox const & parent_bb, int j)
+	{
+		float3 const parent_center = parent_bb.Center();
+		return AABBox(float3((j & 1) ? parent_center.x() : parent_bb.Min().x(),
+				(j & 2) ? parent_center.y() : parent_bb.Min().y(),
+				(j & 4) ? parent_center.z() : parent_bb.Min().z()),
+			float3((j & 1) ? parent_bb.Max().x() : parent_center.x(),
+				(j & 2) ? parent_bb.Max().y() : parent_center.y(),
+				(j & 4) ? parent_bb.Max().z() : parent_center.z()));
+	}
+
+	bool AABBContains(AABBox const & outer, AABBox const & inner)
+	{
+		return (inner.Min().x() >= outer.Min().x()) && (inner.Min().y() >= outer.Min().y()) && (inner.Min().z() >= outer.Min().z())
+			&& (inner.Max().x() <= outer.Max().x()) && (inner.Max().y() <= outer.Max().y()) && (inner.Max().z() <= outer.Max().z());
+	}
+}
+
 namespace KlayGE
 {
 	OCTree::OCTree()
-		: max_tree_depth_(4), rebuild_tree_(false)
+		: max_tree_depth_(4), moveable_in_tree_(true), rebuild_tree_(true)
 	{
 	}
 
 	void OCTree::MaxTreeDepth(uint32_t max_tree_depth)
 	{
 		max_tree_depth_ = std::min<uint32_t>(max_tree_depth, 16UL);
+		rebuild_tree_ = true;
 	}
 
 	uint32_t OCTree::MaxTreeDepth() const
@@ -113,33 +142,28 @@ namespace KlayGE
 		return max_tree_depth_;
 	}
 
-	void OCTree::ClipScene()
+	void OCTree::MoveableObjectsInTree(bool in_tree)
 	{
-		if (rebuild_tree_)
+		if (moveable_in_tree_ != in_tree)
 		{
-			octree_.resize(1);
-			AABBox bb_root(float3(0, 0, 0), float3(0, 0, 0));
-			octree_[0].first_child_index = -1;
-			octree_[0].visible = BO_No;
-			for (auto const & obj : scene_objs_)
-			{
-				uint32_t const attr = obj->Attrib();
-				if ((attr & SceneObject::SOA_Cullable)
-					&& !(attr & SceneObject::SOA_Moveable))
-				{
-					bb_root |= obj->PosBoundWS();
-					octree_[0].obj_ptrs.push_back(obj.get());
-				}
-			}
-			float3 const & center = bb_root.Center();
-			float3 const & extent = bb_root.HalfSize();
-			float longest_dim = std::max(std::max(extent.x(), extent.y()), extent.z());
-			float3 new_extent(longest_dim, longest_dim, longest_dim);
-			octree_[0].bb = AABBox(center - new_extent, center + new_extent);
+			moveable_in_tree_ = in_tree;
+			rebuild_tree_ = true;
+		}
+	}
 
-			this->DivideNode(0, 1);
+	bool OCTree::MoveableObjectsInTree() const
+	{
+		return moveable_in_tree_;
+	}
+
+	void OCTree::ClipScene()
+	{
+		// The tree is built from up-to-date world bounds
+		this->UpdateTransforms();
 
-			rebuild_tree_ = false;
+		if (rebuild_tree_)
+		{
+			this->RebuildTree();
 		}
 
 #ifdef KLAYGE_DRAW_NODES
@@ -150,11 +174,6 @@ namespace KlayGE
 		checked_pointer_cast<NodeRenderable>(node_renderable_)->ClearInstances();
 #endif
 
-		if (!octree_.empty())
-		{
-			this->NodeVisible(0);
-		}
-
 		App3DFramework& app = Context::Instance().AppInstance();
 		Camera& camera = app.ActiveCamera();
 
@@ -171,16 +190,17 @@ namespace KlayGE
 
 		if (camera.OmniDirectionalMode())
 		{
+			// Only for the node visibility used by AABBVisible and friends. Objects are marked below.
+			if (!octree_.empty())
+			{
+				this->MarkNodeObjs(0, false, camera.ForwardVec(), camera.EyePos(), view_proj);
+			}
+
 			for (auto const & obj : scene_objs_)
 			{
 				if (obj->Visible())
 				{
 					uint32_t const attr = obj->Attrib();
-					if (attr & SceneObject::SOA_Moveable)
-					{
-						obj->UpdateAbsModelMatrix();
-					}
-
 					if (attr & SceneObject::SOA_Cullable)
 					{
 						BoundOverlap bo;
@@ -206,24 +226,27 @@ namespace KlayGE
 		}
 		else
 		{
+			// Root objects in the tree are marked by it. The rest are tested in batches.
+			this->ClipRootObjects(camera, view_proj, true, moveable_in_tree_);
+
+			if (moveable_in_tree_)
+			{
+				this->RelocateMoveableObjects();
+			}
+
 			if (!octree_.empty())
 			{
-				this->MarkNodeObjs(0, false);
+				this->MarkNodeObjs(0, false, camera.ForwardVec(), camera.EyePos(), view_proj);
 			}
 
 			for (auto const & obj : scene_objs_)
 			{
-				if (obj->Visible())
+				if (obj->Parent() && obj->Visible())
 				{
 					BoundOverlap visible = this->VisibleTestFromParent(obj.get(), camera.ForwardVec(), camera.EyePos(), view_proj);
 					if (BO_Partial == visible)
 					{
 						uint32_t const attr = obj->Attrib();
-						if (attr & SceneObject::SOA_Moveable)
-						{
-							obj->UpdateAbsModelMatrix();
-						}
-
 						if (attr & SceneObject::SOA_Cullable)
 						{
 							if (attr & SceneObject::SOA_Moveable)
@@ -258,16 +281,17 @@ namespace KlayGE
 		SceneManager::ClearObject();
 
 		octree_.clear();
+		obj_node_indices_.clear();
 		rebuild_tree_ = true;
 	}
 
 	void OCTree::OnAddSceneObject(SceneObjectPtr const & obj)
 	{
-		uint32_t const attr = obj->Attrib();
-		if ((attr & SceneObject::SOA_Cullable)
-			&& !(attr & SceneObject::SOA_Moveable))
+		if (!rebuild_tree_ && this->InTree(*obj))
 		{
-			rebuild_tree_ = true;
+			// Could be added again when its renderable gets ready, with a new bound
+			this->RemoveObject(obj.get());
+			this->InsertObject(obj.get());
 		}
 	}
 
@@ -275,11 +299,9 @@ namespace KlayGE
 	{
 		BOOST_ASSERT(iter != scene_objs_.end());
 
-		uint32_t const attr = (*iter)->Attrib();
-		if ((attr & SceneObject::SOA_Cullable)
-			&& !(attr & SceneObject::SOA_Moveable))
+		if (!rebuild_tree_)
 		{
-			rebuild_tree_ = true;
+			this->RemoveObject(iter->get());
 		}
 	}
 
@@ -293,159 +315,226 @@ namespace KlayGE
 		// TODO
 	}
 
-	void OCTree::DivideNode(size_t index, uint32_t curr_depth)
+	bool OCTree::InTree(SceneObject const & so) const
 	{
-		if (octree_[index].obj_ptrs.size() > 1)
-		{
-			size_t const this_size = octree_.size();
-			AABBox const parent_bb = octree_[index].bb;
-			float3 const parent_center = parent_bb.Center();
-			octree_[index].first_child_index = static_cast<int>(this_size);
-			octree_[index].visible = BO_No;
-
-			octree_.resize(this_size + 8);
-			for (auto so : octree_[index].obj_ptrs)
-			{
-				AABBox const & aabb = so->PosBoundWS();
-				int mark[6];
-				mark[0] = aabb.Min().x() >= parent_center.x() ? 1 : 0;
-				mark[1] = aabb.Min().y() >= parent_center.y() ? 2 : 0;
-				mark[2] = aabb.Min().z() >= parent_center.z() ? 4 : 0;
-				mark[3] = aabb.Max().x() >= parent_center.x() ? 1 : 0;
-				mark[4] = aabb.Max().y() >= parent_center.y() ? 2 : 0;
-				mark[5] = aabb.Max().z() >= parent_center.z() ? 4 : 0;
-				for (int j = 0; j < 8; ++ j)
-				{
-					if (j == ((j & 1) ? mark[3] : mark[0])
-						+ ((j & 2) ? mark[4] : mark[1])
-						+ ((j & 4) ? mark[5] : mark[2]))
-					{
-						octree_[this_size + j].obj_ptrs.push_back(so);
-					}
-				}
-			}
+		uint32_t const attr = so.Attrib();
+		return !so.Parent() && (attr & SceneObject::SOA_Cullable)
+			&& (moveable_in_tree_ || !(attr & SceneObject::SOA_Moveable));
+	}
 
-			for (size_t j = 0; j < 8; ++ j)
-			{
-				octree_node_t& new_node = octree_[this_size + j];
-				new_node.first_child_index = -1;
-				new_node.bb = AABBox(float3((j & 1) ? parent_center.x() : parent_bb.Min().x(),
-						(j & 2) ? parent_center.y() : parent_bb.Min().y(),
-						(j & 4) ? parent_center.z() : parent_bb.Min().z()),
-					float3((j & 1) ? parent_bb.Max().x() : parent_center.x(),
-						(j & 2) ? parent_bb.Max().y() : parent_center.y(),
-						(j & 4) ? parent_bb.Max().z() : parent_center.z()));
+	void OCTree::RebuildTree()
+	{
+		octree_.resize(1);
+		obj_node_indices_.clear();
 
-				if (curr_depth < max_tree_depth_)
-				{
-					this->DivideNode(this_size + j, curr_depth + 1);
-				}
+		AABBox bb_root(float3(0, 0, 0), float3(0, 0, 0));
+		for (auto const & obj : scene_objs_)
+		{
+			if (this->InTree(*obj))
+			{
+				bb_root |= obj->PosBoundWS();
 			}
+		}
+		float3 const & center = bb_root.Center();
+		float3 const & extent = bb_root.HalfSize();
+		float longest_dim = std::max(std::max(extent.x(), extent.y()), extent.z());
+		float3 new_extent(longest_dim, longest_dim, longest_dim);
+
+		octree_node_t& root = octree_[0];
+		root.bb = AABBox(center - new_extent, center + new_extent);
+		root.loose_bb = LooseBound(root.bb);
+		root.first_child_index = -1;
+		root.parent_index = -1;
+		root.depth = 1;
+		root.num_subtree_objs = 0;
+		root.visible = BO_No;
+		root.obj_ptrs.clear();
+
+		rebuild_tree_ = false;
 
-			octree_[index].obj_ptrs.clear();
-			octree_[index].obj_ptrs.shrink_to_fit();
+		for (auto const & obj : scene_objs_)
+		{
+			if (this->InTree(*obj))
+			{
+				this->InsertObject(obj.get());
+			}
 		}
 	}
 
-	void OCTree::NodeVisible(size_t index)
+	void OCTree::InsertObject(SceneObject* so)
 	{
-		BOOST_ASSERT(index < octree_.size());
+		BOOST_ASSERT(obj_node_indices_.find(so) == obj_node_indices_.end());
 
-		App3DFramework& app = Context::Instance().AppInstance();
-		Camera& camera = app.ActiveCamera();
+		AABBox const & aabb = so->PosBoundWS();
+		if (octree_.empty() || !AABBContains(octree_[0].loose_bb, aabb))
+		{
+			// Out of the tree, it has to grow
+			rebuild_tree_ = true;
+			return;
+		}
 
-		float4x4 view_proj = camera.ViewProjMatrix();
-		auto drl = Context::Instance().DeferredRenderingLayerInstance();
-		if (drl)
+		float3 const & extent = aabb.HalfSize();
+		float const longest_dim = std::max(std::max(extent.x(), extent.y()), extent.z());
+		float3 const center = aabb.Center();
+
+		size_t index = 0;
+		while (octree_[index].depth < max_tree_depth_)
 		{
-			int32_t cas_index = drl->CurrCascadeIndex();
-			if (cas_index >= 0)
+			AABBox const & bb = octree_[index].bb;
+			if (longest_dim > bb.HalfSize().x() * 0.5f)
 			{
-				view_proj *= drl->GetCascadedShadowLayer()->CascadeCropMatrix(cas_index);
+				// Too large for the loose bounds of children
+				break;
 			}
+
+			float3 const node_center = bb.Center();
+			int const j = (center.x() >= node_center.x() ? 1 : 0)
+				+ (center.y() >= node_center.y() ? 2 : 0)
+				+ (center.z() >= node_center.z() ? 4 : 0);
+			if (!AABBContains(LooseBound(ChildBound(bb, j)), aabb))
+			{
+				break;
+			}
+
+			if (-1 == octree_[index].first_child_index)
+			{
+				this->CreateChildren(index);
+			}
+			index = octree_[index].first_child_index + j;
 		}
 
-		octree_node_t& node = octree_[index];
-		if ((small_obj_threshold_ <= 0)
-			|| ((MathLib::ortho_area(camera.ForwardVec(), node.bb) > small_obj_threshold_)
-				&& (MathLib::perspective_area(camera.EyePos(), view_proj, node.bb) > small_obj_threshold_)))
+		octree_[index].obj_ptrs.push_back(so);
+		obj_node_indices_.emplace(so, static_cast<int>(index));
+		for (int i = static_cast<int>(index); i != -1; i = octree_[i].parent_index)
 		{
-			BoundOverlap const vis = frustum_->Intersect(node.bb);
-			node.visible = vis;
-			if (BO_Partial == vis)
+			++ octree_[i].num_subtree_objs;
+		}
+	}
+
+	void OCTree::RemoveObject(SceneObject* so)
+	{
+		auto iter = obj_node_indices_.find(so);
+		if (iter != obj_node_indices_.end())
+		{
+			int const index = iter->second;
+			auto& obj_ptrs = octree_[index].obj_ptrs;
+			auto obj_iter = std::find(obj_ptrs.begin(), obj_ptrs.end(), so);
+			BOOST_ASSERT(obj_iter != obj_ptrs.end());
+			*obj_iter = obj_ptrs.back();
+			obj_ptrs.pop_back();
+
+			for (int i = index; i != -1; i = octree_[i].parent_index)
 			{
-				if (node.first_child_index != -1)
+				-- octree_[i].num_subtree_objs;
+			}
+
+			obj_node_indices_.erase(iter);
+		}
+	}
+
+	void OCTree::RelocateMoveableObjects()
+	{
+		// An object stays in its node as long as the loose bound holds it. Most moves don't touch the tree.
+		for (auto const & obj : scene_objs_)
+		{
+			SceneObject* so = obj.get();
+			if (so->Visible() && (so->Attrib() & SceneObject::SOA_Moveable) && this->InTree(*so))
+			{
+				auto iter = obj_node_indices_.find(so);
+				if ((iter == obj_node_indices_.end()) || !AABBContains(octree_[iter->second].loose_bb, so->PosBoundWS()))
 				{
-					for (int i = 0; i < 8; ++ i)
-					{
-						this->NodeVisible(node.first_child_index + i);
-					}
+					this->RemoveObject(so);
+					this->InsertObject(so);
 				}
 			}
 		}
-		else
+
+		if (rebuild_tree_)
 		{
-			node.visible = BO_No;
+			this->RebuildTree();
 		}
+	}
 
-#ifdef KLAYGE_DRAW_NODES
-		if ((vis != BO_No) && (-1 == node.first_child_index))
-		{
-			checked_pointer_cast<NodeRenderable>(node_renderable_)->AddInstance(MathLib::scaling(node.bb.HalfSize()) * MathLib::translation(node.bb.Center()));
+	void OCTree::CreateChildren(size_t index)
+	{
+		size_t const this_size = octree_.size();
+		octree_.resize(this_size + 8);
+
+		octree_node_t& node = octree_[index];
+		node.first_child_index = static_cast<int>(this_size);
+		for (int j = 0; j < 8; ++ j)
+		{
+			octree_node_t& new_node = octree_[this_size + j];
+			new_node.bb = ChildBound(node.bb, j);
+			new_node.loose_bb = LooseBound(new_node.bb);
+			new_node.first_child_index = -1;
+			new_node.parent_index = static_cast<int>(index);
+			new_node.depth = node.depth + 1;
+			new_node.num_subtree_objs = 0;
+			new_node.visible = BO_No;
 		}
-#endif
 	}
 
-	void OCTree::MarkNodeObjs(size_t index, bool force)
+	void OCTree::MarkNodeObjs(size_t index, bool force, float3 const & view_dir, float3 const & eye_pos,
+		float4x4 const & view_proj)
 	{
 		BOOST_ASSERT(index < octree_.size());
 
-		App3DFramework& app = Context::Instance().AppInstance();
-		Camera& camera = app.ActiveCamera();
+		octree_node_t& node = octree_[index];
+		if (force)
+		{
+			node.visible = BO_Yes;
+		}
+		else if ((small_obj_threshold_ <= 0)
+			|| ((MathLib::ortho_area(view_dir, node.loose_bb) > small_obj_threshold_)
+				&& (MathLib::perspective_area(eye_pos, view_proj, node.loose_bb) > small_obj_threshold_)))
+		{
+			node.visible = frustum_->Intersect(node.loose_bb);
+		}
+		else
+		{
+			node.visible = BO_No;
+		}
 
-		float4x4 view_proj = camera.ViewProjMatrix();
-		auto drl = Context::Instance().DeferredRenderingLayerInstance();
-		if (drl)
+		// Children of an empty subtree are left untested. BoundVisible doesn't go into them.
+		if ((BO_No == node.visible) || (0 == node.num_subtree_objs))
 		{
-			int32_t cas_index = drl->CurrCascadeIndex();
-			if (cas_index >= 0)
-			{
-				view_proj *= drl->GetCascadedShadowLayer()->CascadeCropMatrix(cas_index);
-			}
+			return;
 		}
 
-		octree_node_t const & node = octree_[index];
-		if ((node.visible != BO_No) || force)
+#ifdef KLAYGE_DRAW_NODES
+		if (-1 == node.first_child_index)
 		{
-			for (auto so : node.obj_ptrs)
+			checked_pointer_cast<NodeRenderable>(node_renderable_)->AddInstance(MathLib::scaling(node.bb.HalfSize()) * MathLib::translation(node.bb.Center()));
+		}
+#endif
+
+		for (auto so : node.obj_ptrs)
+		{
+			if (so->Visible())
 			{
-				if ((BO_No == so->VisibleMark()) && so->Visible())
+				AABBox const & aabb_ws = so->PosBoundWS();
+				BoundOverlap visible;
+				if ((small_obj_threshold_ > 0)
+					&& ((MathLib::ortho_area(view_dir, aabb_ws) <= small_obj_threshold_)
+						|| (MathLib::perspective_area(eye_pos, view_proj, aabb_ws) <= small_obj_threshold_)))
 				{
-					BoundOverlap visible = this->VisibleTestFromParent(so, camera.ForwardVec(), camera.EyePos(), view_proj);
-					if (BO_Partial == visible)
-					{
-						AABBox const & aabb_ws = so->PosBoundWS();
-						if (so->Parent() || (small_obj_threshold_ <= 0)
-							|| ((MathLib::ortho_area(camera.ForwardVec(), node.bb) > small_obj_threshold_)
-								&& (MathLib::perspective_area(camera.EyePos(), view_proj, aabb_ws) > small_obj_threshold_)))
-						{
-							visible = frustum_->Intersect(aabb_ws);
-						}
-						else
-						{
-							visible = BO_No;
-						}
-					}
-					so->VisibleMark(visible);
+					visible = BO_No;
+				}
+				else
+				{
+					// Objects are inside the loose bound, nothing to test if it's fully visible
+					visible = (BO_Yes == node.visible) ? BO_Yes : frustum_->Intersect(aabb_ws);
 				}
+				so->VisibleMark(visible);
 			}
+		}
 
-			if (node.first_child_index != -1)
+		if (node.first_child_index != -1)
+		{
+			for (int i = 0; i < 8; ++ i)
 			{
-				for (int i = 0; i < 8; ++ i)
-				{
-					this->MarkNodeObjs(node.first_child_index + i, (BO_Yes == node.visible) || force);
-				}
+				this->MarkNodeObjs(node.first_child_index + i, BO_Yes == node.visible, view_dir, eye_pos, view_proj);
 			}
 		}
 	}
@@ -558,7 +647,7 @@ namespace KlayGE
 			{
 				BOOST_ASSERT(BO_Partial == node.visible);
 
-				if (node.first_child_index != -1)
+				if ((node.first_child_index != -1) && (node.num_subtree_objs > 0))
 				{
 					float3 const center = node.bb.Center();
 					int mark[6];
@@ -611,7 +700,7 @@ namespace KlayGE
 			{
 				BOOST_ASSERT(BO_Partial == node.visible);
 
-				if (node.first_child_index != -1)
+				if ((node.first_child_index != -1) && (node.num_subtree_objs > 0))
 				{
 					for (int i = 0; i < 8; ++ i)
 					{
@@ -651,7 +740,7 @@ namespace KlayGE
 			{
 				BOOST_ASSERT(BO_Partial == node.visible);
 
-				if (node.first_child_index != -1)
+				if ((node.first_child_index != -1) && (node.num_subtree_objs > 0))
 				{
 					for (int i = 0; i < 8; ++ i)
 					{
@@ -691,7 +780,7 @@ namespace KlayGE
 			{
 				BOOST_ASSERT(BO_Partial == node.visible);
 
-				if (node.first_child_index != -1)
+				if ((node.first_child_index != -1) && (node.num_subtree_objs > 0))
 				{
 					for (int i = 0; i < 8; ++ i)
 					{
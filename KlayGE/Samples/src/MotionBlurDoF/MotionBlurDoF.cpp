@@ -223,7 +223,7 @@ namespace
 
 		void Instance(float4x4 const & mat, Color const & clr)
 		{
-			model_ = mat;
+			this->ModelMatrix(mat);
 			inst_.clr = clr.ABGR();
 		}
 
@@ -249,7 +249,7 @@ namespace
 			inst_.last_mat[2] = mat_t.Row(2);
 
 			float e = elapsed_time * 0.3f * -model_(3, 1);
-			model_ *= MathLib::rotation_y(e);
+			this->ModelMatrix(model_ * MathLib::rotation_y(e));
 
 			mat_t = MathLib::transpose(model_);
 			inst_.mat[0] = mat_t.Row(0);
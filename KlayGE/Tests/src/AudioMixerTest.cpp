@@ -0,0 +1,335 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Math.hpp>
+#include <KFL/Timer.hpp>
+#include <KlayGE/AudioDataSource.hpp>
+#include <KlayGE/AudioMixer.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	// 16-bit PCM generated on the fly. A sine, or a constant when hz is 0.
+	class GeneratedSource : public AudioDataSource
+	{
+	public:
+		GeneratedSource(AudioFormat format, uint32_t freq, uint32_t num_frames, float hz, float amplitude)
+			: num_frames_(num_frames), hz_(hz), amplitude_(amplitude), frame_(0), bytes_read_(0)
+		{
+			format_ = format;
+			freq_ = freq;
+		}
+
+		void Open(ResIdentifierPtr const & file) override
+		{
+			KFL_UNUSED(file);
+		}
+
+		void Close() override
+		{
+		}
+
+		size_t Size() override
+		{
+			return num_frames_ * this->Channels() * sizeof(int16_t);
+		}
+
+		size_t Read(void* data, size_t size) override
+		{
+			uint32_t const channels = this->Channels();
+			int16_t* dst = static_cast<int16_t*>(data);
+			size_t const num_frames = std::min<size_t>(size / (channels * sizeof(int16_t)), num_frames_ - frame_);
+			for (size_t i = 0; i < num_frames; ++ i)
+			{
+				int16_t const s = this->Sample(frame_);
+				for (uint32_t c = 0; c < channels; ++ c)
+				{
+					*dst = s;
+					++ dst;
+				}
+				++ frame_;
+			}
+
+			size_t const read = num_frames * channels * sizeof(int16_t);
+			bytes_read_ += read;
+			return read;
+		}
+
+		void Reset() override
+		{
+			frame_ = 0;
+		}
+
+		int16_t Sample(uint32_t frame) const
+		{
+			float const v = (0 == hz_) ? amplitude_ : amplitude_ * std::sin(2 * PI * hz_ * frame / freq_);
+			return static_cast<int16_t>(v * 32767);
+		}
+
+		uint32_t Channels() const
+		{
+			return (AF_Stereo16 == format_) ? 2 : 1;
+		}
+
+		size_t BytesRead() const
+		{
+			return bytes_read_;
+		}
+
+	private:
+		uint32_t num_frames_;
+		float hz_;
+		float amplitude_;
+		uint32_t frame_;
+		size_t bytes_read_;
+	};
+
+	class CaptureSink : public AudioSink
+	{
+	public:
+		explicit CaptureSink(uint32_t sample_rate)
+			: AudioSink(sample_rate)
+		{
+		}
+
+		void Write(float const * samples, uint32_t num_frames) override
+		{
+			this->samples.insert(this->samples.end(), samples, samples + num_frames * 2);
+		}
+
+		std::vector<float> samples;
+	};
+
+	std::shared_ptr<GeneratedSource> MakeConstant(uint32_t freq, uint32_t num_frames, float value)
+	{
+		return MakeSharedPtr<GeneratedSource>(AF_Mono16, freq, num_frames, 0.0f, value);
+	}
+
+	void MixUntilStopped(AudioMixer& mixer, uint32_t voice)
+	{
+		for (int i = 0; (i < 10000) && mixer.IsPlaying(voice); ++ i)
+		{
+			mixer.Mix();
+		}
+		ASSERT_FALSE(mixer.IsPlaying(voice));
+	}
+}
+
+TEST(AudioMixerTest, PanAndAttenuation)
+{
+	auto sink = MakeSharedPtr<CaptureSink>(48000);
+	AudioMixer mixer(sink);
+	mixer.ListenerPos(float3(0, 0, 0));
+	mixer.ListenerOri(float3(0, 0, 1), float3(0, 1, 0));
+
+	float const value = 16383 / 32768.0f;
+	uint32_t const voice = mixer.CreateVoice(MakeConstant(48000, 48000, 0.5f), false);
+	struct Case
+	{
+		float3 pos;
+		float left;
+		float right;
+	};
+	float const center = value * MathLib::cos(PI / 4);
+	Case const cases[] =
+	{
+		{ float3(0, 0, 0.5f), center, center },
+		{ float3(0, 0, 2), center / 2, center / 2 },
+		{ float3(0, 0, -8), center / 8, center / 8 },
+		{ float3(4, 0, 0), 0, value / 4 },
+		{ float3(-4, 0, 0), value / 4, 0 }
+	};
+	for (auto const & c : cases)
+	{
+		sink->samples.clear();
+		mixer.Position(voice, c.pos);
+		mixer.Play(voice, false);
+		mixer.Mix();
+
+		// A constant source mixes to a constant
+		for (uint32_t i = 0; i < AudioMixer::BLOCK_FRAMES; ++ i)
+		{
+			EXPECT_NEAR(sink->samples[i * 2 + 0], c.left, 1e-4f) << c.pos.x() << ", " << c.pos.z();
+			EXPECT_NEAR(sink->samples[i * 2 + 1], c.right, 1e-4f) << c.pos.x() << ", " << c.pos.z();
+		}
+	}
+}
+
+TEST(AudioMixerTest, Resample)
+{
+	uint32_t const rates[][2] = { { 22050, 44100 }, { 44100, 48000 }, { 48000, 22050 } };
+	for (auto const & rate : rates)
+	{
+		auto sink = MakeSharedPtr<CaptureSink>(rate[1]);
+		AudioMixer mixer(sink);
+
+		// One second
+		uint32_t const voice = mixer.CreateVoice(MakeConstant(rate[0], rate[0], 0.5f), false);
+		mixer.Play(voice, false);
+		MixUntilStopped(mixer, voice);
+
+		uint32_t num_frames = 0;
+		for (size_t i = 0; i < sink->samples.size(); i += 2)
+		{
+			if (sink->samples[i] != 0)
+			{
+				++ num_frames;
+			}
+		}
+		EXPECT_NEAR(num_frames, rate[1], 2) << rate[0] << " to " << rate[1];
+	}
+}
+
+TEST(AudioMixerTest, StreamIsContinuous)
+{
+	uint32_t const FREQ = 48000;
+	uint32_t const NUM_FRAMES = FREQ * 3 + 123;
+
+	auto sink = MakeSharedPtr<CaptureSink>(FREQ);
+	AudioMixer mixer(sink);
+
+	// A 1-second buffer, refilled many times. At the same rate every frame comes out unchanged.
+	auto source = MakeSharedPtr<GeneratedSource>(AF_Stereo16, FREQ, NUM_FRAMES, 441.0f, 0.8f);
+	uint32_t const voice = mixer.CreateVoice(source, true, 1);
+	mixer.Play(voice, true);
+	uint32_t const num_out = NUM_FRAMES * 5 / 2;
+	while (sink->samples.size() < num_out * 2)
+	{
+		mixer.Mix();
+	}
+	EXPECT_TRUE(mixer.IsPlaying(voice));
+
+	uint32_t num_mismatches = 0;
+	for (uint32_t i = 0; i < num_out; ++ i)
+	{
+		float const expected = source->Sample(i % NUM_FRAMES) / 32768.0f;
+		if ((sink->samples[i * 2 + 0] != expected) || (sink->samples[i * 2 + 1] != expected))
+		{
+			++ num_mismatches;
+		}
+	}
+	EXPECT_EQ(num_mismatches, 0U);
+
+	mixer.Stop(voice);
+	EXPECT_FALSE(mixer.IsPlaying(voice));
+	EXPECT_EQ(mixer.NumPlayingVoices(), 0U);
+}
+
+TEST(AudioMixerTest, ClonesShareDecodedData)
+{
+	uint32_t const FREQ = 44100;
+
+	auto sink = MakeSharedPtr<CaptureSink>(FREQ);
+	AudioMixer mixer(sink);
+
+	auto source = MakeSharedPtr<GeneratedSource>(AF_Stereo16, FREQ, FREQ / 2, 1000.0f, 0.2f);
+	std::vector<uint32_t> voices;
+	voices.push_back(mixer.CreateVoice(source, false));
+	for (int i = 0; i < 3; ++ i)
+	{
+		voices.push_back(mixer.CloneVoice(voices[0]));
+	}
+	for (auto voice : voices)
+	{
+		mixer.Play(voice, false);
+	}
+	EXPECT_EQ(mixer.NumPlayingVoices(), 4U);
+	for (auto voice : voices)
+	{
+		MixUntilStopped(mixer, voice);
+	}
+
+	// Decoded once, played 4 times
+	EXPECT_EQ(source->BytesRead(), source->Size());
+	for (uint32_t i = 0; i < FREQ / 2; ++ i)
+	{
+		EXPECT_NEAR(sink->samples[i * 2], 4 * source->Sample(i) / 32768.0f, 1e-5f);
+	}
+
+	for (auto voice : voices)
+	{
+		mixer.DestroyVoice(voice);
+	}
+	mixer.Mix();
+	EXPECT_EQ(mixer.CreateVoice(source, false), voices.back());
+}
+
+TEST(AudioMixerTest, WavFile)
+{
+	std::string const path = "AudioMixerTest.wav";
+	{
+		auto sink = MakeSharedPtr<WavFileAudioSink>(path, 22050);
+		AudioMixer mixer(sink);
+		uint32_t const voice = mixer.CreateVoice(MakeConstant(22050, 1000, 0.5f), false);
+		mixer.Play(voice, false);
+		for (int i = 0; i < 10; ++ i)
+		{
+			mixer.Mix();
+		}
+	}
+
+	std::ifstream file(path.c_str(), std::ios_base::binary);
+	std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	file.close();
+	std::remove(path.c_str());
+
+	ASSERT_EQ(data.size(), 44U + 10 * AudioMixer::BLOCK_FRAMES * 4);
+	EXPECT_EQ(std::memcmp(&data[0], "RIFF", 4), 0);
+	uint32_t data_size;
+	std::memcpy(&data_size, &data[40], sizeof(data_size));
+	EXPECT_EQ(LE2Native(data_size), 10 * AudioMixer::BLOCK_FRAMES * 4);
+}
+
+TEST(AudioMixerTest, DISABLED_Benchmark)
+{
+	uint32_t const NUM_VOICES = 512;
+	uint32_t const NUM_BLOCKS = 400;
+
+	auto sink = MakeSharedPtr<NullAudioSink>(48000);
+	AudioMixer mixer(sink);
+	mixer.ListenerPos(float3(0, 0, 0));
+
+	std::ranlux24_base gen(1);
+	std::uniform_real_distribution<float> dist(-20, 20);
+	std::vector<std::shared_ptr<GeneratedSource>> sources;
+	for (uint32_t i = 0; i < 8; ++ i)
+	{
+		sources.push_back(MakeSharedPtr<GeneratedSource>(AF_Mono16, 44100, 44100, 200.0f + i * 50, 0.5f));
+	}
+	std::vector<uint32_t> voices;
+	for (uint32_t i = 0; i < NUM_VOICES; ++ i)
+	{
+		uint32_t const voice = (i < sources.size()) ? mixer.CreateVoice(sources[i], false) : mixer.CloneVoice(voices[i % sources.size()]);
+		mixer.Position(voice, float3(dist(gen), dist(gen), dist(gen)));
+		mixer.Play(voice, true);
+		voices.push_back(voice);
+	}
+
+	// Decodes the clips first
+	for (int i = 0; i < 100; ++ i)
+	{
+		mixer.Mix();
+	}
+
+	Timer timer;
+	for (uint32_t i = 0; i < NUM_BLOCKS; ++ i)
+	{
+		mixer.Mix();
+	}
+	double const time = timer.elapsed();
+
+	EXPECT_EQ(mixer.NumPlayingVoices(), NUM_VOICES);
+	double const audio_time = static_cast<double>(NUM_BLOCKS) * AudioMixer::BLOCK_FRAMES / sink->SampleRate();
+	cout << NUM_VOICES << " voices: " << static_cast<uint64_t>(NUM_VOICES * NUM_BLOCKS * AudioMixer::BLOCK_FRAMES / time / 1000)
+		<< " voice frames/ms, " << audio_time / time << "x real time" << endl;
+}
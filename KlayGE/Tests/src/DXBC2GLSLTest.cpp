@@ -0,0 +1,208 @@
+#include <KFL/KFL.hpp>
+#include <DXBC2GLSL/DXBC2GLSL.hpp>
+#include <DXBC2GLSL/Utils.hpp>
+
+#include <gtest/gtest.h>
+
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+	void AppendSignature(std::vector<uint32_t>& dxbc, uint32_t fourcc, char const * semantic, uint32_t system_value)
+	{
+		size_t const name_len = std::strlen(semantic);
+		size_t const name_dwords = (name_len + 4) / 4;
+
+		dxbc.push_back(fourcc);
+		dxbc.push_back(static_cast<uint32_t>((2 + 6 + name_dwords) * sizeof(uint32_t)));
+		dxbc.push_back(1);			// count
+		dxbc.push_back(8);			// offset of the elements
+		dxbc.push_back(8 + 6 * 4);	// offset of the name
+		dxbc.push_back(0);			// semantic index
+		dxbc.push_back(system_value);
+		dxbc.push_back(SRCT_FLOAT32);
+		dxbc.push_back(0);			// register
+		dxbc.push_back(0x0F0F);		// mask, read_write_mask
+		size_t const name_pos = dxbc.size();
+		dxbc.resize(name_pos + name_dwords, 0);
+		std::memcpy(&dxbc[name_pos], semantic, name_len);
+	}
+
+	// A vs_4_0 passing its position through. The variant goes into the checksum, so that each one is another shader
+	//  for the translation cache.
+	std::vector<uint32_t> MakeVertexShader(uint32_t variant)
+	{
+		std::vector<uint32_t> dxbc;
+		dxbc.push_back(FOURCC_DXBC);
+		dxbc.push_back(variant);
+		dxbc.push_back(0);
+		dxbc.push_back(0);
+		dxbc.push_back(0);
+		dxbc.push_back(1);
+		dxbc.push_back(0);			// total size
+		dxbc.push_back(3);			// chunk count
+		size_t const offsets_pos = dxbc.size();
+		dxbc.resize(offsets_pos + 3);
+
+		dxbc[offsets_pos + 0] = static_cast<uint32_t>(dxbc.size() * sizeof(uint32_t));
+		AppendSignature(dxbc, FOURCC_ISGN, "POSITION", 0);
+		dxbc[offsets_pos + 1] = static_cast<uint32_t>(dxbc.size() * sizeof(uint32_t));
+		AppendSignature(dxbc, FOURCC_OSGN, "SV_Position", SN_POSITION);
+
+		static uint32_t const shader_tokens[] =
+		{
+			0x00010040, 15,									// vs_4_0
+			0x0300005F, 0x001010F2, 0,						// dcl_input v0.xyzw
+			0x04000067, 0x001020F2, 0, 1,					// dcl_output_siv o0.xyzw, position
+			0x05000036, 0x001020F2, 0, 0x00101E46, 0,		// mov o0.xyzw, v0.xyzw
+			0x0100003E										// ret
+		};
+		dxbc[offsets_pos + 2] = static_cast<uint32_t>(dxbc.size() * sizeof(uint32_t));
+		dxbc.push_back(FOURCC_SHDR);
+		dxbc.push_back(sizeof(shader_tokens));
+		dxbc.insert(dxbc.end(), std::begin(shader_tokens), std::end(shader_tokens));
+
+		dxbc[6] = static_cast<uint32_t>(dxbc.size() * sizeof(uint32_t));
+		return dxbc;
+	}
+
+	std::shared_ptr<DXBC2GLSL::DXBC2GLSL const> Translate(std::vector<uint32_t> const & dxbc)
+	{
+		return DXBC2GLSL::TranslationCache::Instance().Translate(dxbc.data(), false, true, STP_Undefined, STOP_Undefined,
+			GSV_330, DXBC2GLSL::DXBC2GLSL::DefaultRules(GSV_330));
+	}
+}
+
+TEST(DXBC2GLSLTest, StringBuilderMatchesOStream)
+{
+	std::mt19937 gen(3);
+	for (int i = 0; i < 100000; ++ i)
+	{
+		uint32_t bits = gen();
+		float f;
+		std::memcpy(&f, &bits, sizeof(f));
+		if (!std::isfinite(f) || (i % 3 == 0))
+		{
+			f = static_cast<float>(static_cast<int>(gen() % 2000) - 1000) / static_cast<float>(1 << (gen() % 8));
+		}
+		int32_t const iv = static_cast<int32_t>(gen());
+		uint32_t const uv = gen();
+
+		std::ostringstream ss;
+		std::string str;
+		StringBuilder sb(str);
+		if (i & 1)
+		{
+			ss.setf(std::ios::showpoint);
+			sb.ShowPoint(true);
+		}
+		ss << f << ' ' << iv << ' ' << uv << "x" << static_cast<uint8_t>('a' + i % 26) << (i % 5 == 0);
+		sb << f << ' ' << iv << ' ' << uv << "x" << static_cast<uint8_t>('a' + i % 26) << (i % 5 == 0);
+		ASSERT_EQ(ss.str(), str);
+	}
+
+	std::ostringstream ss;
+	std::string str;
+	StringBuilder sb(str);
+	ss << INT_MIN << ' ' << LLONG_MIN << ' ' << 0 << ' ' << 0.0f << ' ' << -0.0f << ' ' << 1e30f << ' ' << 1e-30f;
+	sb << INT_MIN << ' ' << LLONG_MIN << ' ' << 0 << ' ' << 0.0f << ' ' << -0.0f << ' ' << 1e30f << ' ' << 1e-30f;
+	EXPECT_EQ(ss.str(), str);
+}
+
+TEST(DXBC2GLSLTest, StreamRoundTrip)
+{
+	std::vector<uint32_t> const dxbc = MakeVertexShader(0);
+	DXBC2GLSL::DXBC2GLSL translation;
+	translation.FeedDXBC(dxbc.data(), false, true, STP_Undefined, STOP_Undefined, GSV_330);
+	ASSERT_FALSE(translation.GLSLString().empty());
+	ASSERT_EQ(1U, translation.NumInputParams());
+	ASSERT_EQ(1U, translation.NumOutputParams());
+
+	std::stringstream ss;
+	translation.StreamOut(ss);
+
+	DXBC2GLSL::DXBC2GLSL loaded;
+	ASSERT_TRUE(loaded.StreamIn(ss));
+	EXPECT_EQ(translation.GLSLString(), loaded.GLSLString());
+	ASSERT_EQ(translation.NumInputParams(), loaded.NumInputParams());
+	EXPECT_STREQ("POSITION", loaded.InputParam(0).semantic_name);
+	ASSERT_EQ(translation.NumOutputParams(), loaded.NumOutputParams());
+	EXPECT_STREQ("SV_Position", loaded.OutputParam(0).semantic_name);
+	EXPECT_EQ(SN_POSITION, loaded.OutputParam(0).system_value_type);
+	EXPECT_EQ(translation.NumCBuffers(), loaded.NumCBuffers());
+	EXPECT_EQ(translation.NumResources(), loaded.NumResources());
+	EXPECT_EQ(translation.DSPartitioning(), loaded.DSPartitioning());
+	EXPECT_EQ(translation.DSOutputPrimitive(), loaded.DSOutputPrimitive());
+}
+
+TEST(DXBC2GLSLTest, StreamInRejectsBrokenData)
+{
+	std::vector<uint32_t> const dxbc = MakeVertexShader(0);
+	DXBC2GLSL::DXBC2GLSL translation;
+	translation.FeedDXBC(dxbc.data(), false, true, STP_Undefined, STOP_Undefined, GSV_330);
+
+	std::stringstream ss;
+	translation.StreamOut(ss);
+	std::string const data = ss.str();
+
+	{
+		std::stringstream truncated(data.substr(0, data.size() / 2));
+		DXBC2GLSL::DXBC2GLSL loaded;
+		EXPECT_FALSE(loaded.StreamIn(truncated));
+	}
+	{
+		// The length of the GLSL comes first
+		std::string broken = data;
+		broken[0] = '\xFF';
+		broken[1] = '\xFF';
+		broken[2] = '\xFF';
+		broken[3] = '\x7F';
+		std::stringstream is(broken);
+		DXBC2GLSL::DXBC2GLSL loaded;
+		EXPECT_FALSE(loaded.StreamIn(is));
+	}
+}
+
+TEST(DXBC2GLSLTest, TranslationCacheEvictsLeastRecentlyUsed)
+{
+	auto& cache = DXBC2GLSL::TranslationCache::Instance();
+	size_t const max_entries = cache.MaxEntries();
+	cache.Folder("");
+	cache.Clear();
+	cache.MaxEntries(2);
+
+	std::vector<uint32_t> const shaders[] = { MakeVertexShader(1), MakeVertexShader(2), MakeVertexShader(3) };
+
+	auto const first = Translate(shaders[0]);
+	Translate(shaders[1]);
+	EXPECT_EQ(0U, cache.NumHits());
+	EXPECT_EQ(2U, cache.NumMisses());
+
+	// Uses the first one, so the second one is the least recently used
+	EXPECT_EQ(first, Translate(shaders[0]));
+	EXPECT_EQ(1U, cache.NumHits());
+
+	Translate(shaders[2]);
+	EXPECT_EQ(2U, cache.NumEntries());
+	EXPECT_EQ(3U, cache.NumMisses());
+
+	EXPECT_EQ(first, Translate(shaders[0]));
+	EXPECT_EQ(2U, cache.NumHits());
+	Translate(shaders[1]);
+	EXPECT_EQ(4U, cache.NumMisses());
+	EXPECT_EQ(2U, cache.NumEntries());
+
+	// The evicted translations stay valid for their users
+	EXPECT_FALSE(first->GLSLString().empty());
+
+	cache.MaxEntries(max_entries);
+	cache.Clear();
+}
@@ -0,0 +1,125 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Thread.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "DeployJobGraph.hpp"
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	// Every job takes a ticket when it starts and another one when it finishes
+	struct JobTickets
+	{
+		std::atomic<uint32_t> start;
+		std::atomic<uint32_t> finish;
+	};
+
+	uint32_t AddTicketJob(DeployJobGraph& graph, std::vector<JobTickets>& tickets, std::atomic<uint32_t>& next_ticket,
+		bool succeed = true)
+	{
+		uint32_t const index = graph.NumJobs();
+		tickets[index].start = 0;
+		tickets[index].finish = 0;
+		return graph.AddJob([&tickets, &next_ticket, index, succeed]
+			{
+				tickets[index].start = ++ next_ticket;
+				std::this_thread::sleep_for(std::chrono::milliseconds(1 + index % 3));
+				tickets[index].finish = ++ next_ticket;
+				return succeed;
+			});
+	}
+}
+
+TEST(DeployJobGraphTest, DependenciesFinishFirst)
+{
+	thread_pool pool(1, 4);
+
+	// 0 -> 1 -> 3 -> 5, 0 -> 2 -> 3, 4 -> 5, and 6, 7 on their own
+	std::vector<std::pair<uint32_t, uint32_t>> const edges =
+	{
+		{ 1, 0 }, { 2, 0 }, { 3, 1 }, { 3, 2 }, { 5, 3 }, { 5, 4 }
+	};
+
+	for (int run = 0; run < 20; ++ run)
+	{
+		DeployJobGraph graph;
+		std::vector<JobTickets> tickets(8);
+		std::atomic<uint32_t> next_ticket(0);
+		for (uint32_t i = 0; i < tickets.size(); ++ i)
+		{
+			AddTicketJob(graph, tickets, next_ticket);
+		}
+		for (auto const & edge : edges)
+		{
+			graph.AddDependency(edge.first, edge.second);
+		}
+
+		EXPECT_TRUE(graph.Run(pool, 4));
+		for (uint32_t i = 0; i < tickets.size(); ++ i)
+		{
+			EXPECT_EQ(DeployJobGraph::JS_Succeeded, graph.State(i));
+			EXPECT_LT(0U, tickets[i].start.load());
+		}
+		for (auto const & edge : edges)
+		{
+			EXPECT_GT(tickets[edge.first].start.load(), tickets[edge.second].finish.load());
+		}
+	}
+}
+
+TEST(DeployJobGraphTest, FailedDependencySkipsDependents)
+{
+	thread_pool pool(1, 4);
+
+	DeployJobGraph graph;
+	std::vector<JobTickets> tickets(4);
+	std::atomic<uint32_t> next_ticket(0);
+	uint32_t const failing = AddTicketJob(graph, tickets, next_ticket, false);
+	uint32_t const dependent = AddTicketJob(graph, tickets, next_ticket);
+	uint32_t const indirect_dependent = AddTicketJob(graph, tickets, next_ticket);
+	uint32_t const independent = AddTicketJob(graph, tickets, next_ticket);
+	graph.AddDependency(dependent, failing);
+	graph.AddDependency(indirect_dependent, dependent);
+
+	EXPECT_FALSE(graph.Run(pool, 4));
+	EXPECT_EQ(DeployJobGraph::JS_Failed, graph.State(failing));
+	EXPECT_EQ(DeployJobGraph::JS_Skipped, graph.State(dependent));
+	EXPECT_EQ(DeployJobGraph::JS_Skipped, graph.State(indirect_dependent));
+	EXPECT_EQ(DeployJobGraph::JS_Succeeded, graph.State(independent));
+	EXPECT_EQ(0U, tickets[dependent].start.load());
+	EXPECT_EQ(0U, tickets[indirect_dependent].start.load());
+}
+
+TEST(DeployJobGraphTest, CycleIsSkipped)
+{
+	thread_pool pool(1, 4);
+
+	DeployJobGraph graph;
+	std::vector<JobTickets> tickets(4);
+	std::atomic<uint32_t> next_ticket(0);
+	uint32_t const a = AddTicketJob(graph, tickets, next_ticket);
+	uint32_t const b = AddTicketJob(graph, tickets, next_ticket);
+	uint32_t const dependent = AddTicketJob(graph, tickets, next_ticket);
+	uint32_t const independent = AddTicketJob(graph, tickets, next_ticket);
+	graph.AddDependency(a, b);
+	graph.AddDependency(b, a);
+	graph.AddDependency(dependent, a);
+
+	// Doesn't wait forever
+	EXPECT_FALSE(graph.Run(pool, 2));
+	EXPECT_EQ(DeployJobGraph::JS_Skipped, graph.State(a));
+	EXPECT_EQ(DeployJobGraph::JS_Skipped, graph.State(b));
+	EXPECT_EQ(DeployJobGraph::JS_Skipped, graph.State(dependent));
+	EXPECT_EQ(DeployJobGraph::JS_Succeeded, graph.State(independent));
+	EXPECT_EQ(0U, tickets[a].start.load());
+	EXPECT_EQ(0U, tickets[dependent].start.load());
+}
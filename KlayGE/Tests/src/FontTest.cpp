@@ -0,0 +1,82 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KlayGE/Font.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	uint32_t AddGlyph(GlyphAtlas& atlas, wchar_t ch, bool expect_evicted, wchar_t expected_evicted_ch = 0)
+	{
+		bool evicted;
+		wchar_t evicted_ch;
+		uint32_t const cell = atlas.Add(ch, evicted, evicted_ch);
+		EXPECT_EQ(expect_evicted, evicted);
+		if (expect_evicted && evicted)
+		{
+			EXPECT_EQ(expected_evicted_ch, evicted_ch);
+		}
+		EXPECT_EQ(ch, atlas.Glyph(cell));
+		return cell;
+	}
+}
+
+TEST(FontTest, GlyphAtlasFillsFreeCellsFirst)
+{
+	GlyphAtlas atlas(4);
+	EXPECT_EQ(4U, atlas.NumCells());
+	EXPECT_EQ(0U, atlas.NumGlyphs());
+
+	wchar_t const chars[] = { L'a', L'b', L'c', L'd' };
+	for (uint32_t i = 0; i < 4; ++ i)
+	{
+		EXPECT_EQ(i, AddGlyph(atlas, chars[i], false));
+		EXPECT_EQ(i + 1, atlas.NumGlyphs());
+	}
+}
+
+TEST(FontTest, GlyphAtlasEvictsLeastRecentlyUsed)
+{
+	GlyphAtlas atlas(4);
+	uint32_t const cell_a = AddGlyph(atlas, L'a', false);
+	uint32_t const cell_b = AddGlyph(atlas, L'b', false);
+	uint32_t const cell_c = AddGlyph(atlas, L'c', false);
+	uint32_t const cell_d = AddGlyph(atlas, L'd', false);
+
+	// a is used again, so b is the least recently used glyph
+	atlas.Touch(cell_a);
+	EXPECT_EQ(cell_b, AddGlyph(atlas, L'e', true, L'b'));
+	EXPECT_EQ(4U, atlas.NumGlyphs());
+
+	// b comes back, and has to be rasterized again in the cell of the least recently used glyph
+	EXPECT_EQ(cell_c, AddGlyph(atlas, L'b', true, L'c'));
+	EXPECT_EQ(cell_d, AddGlyph(atlas, L'f', true, L'd'));
+
+	// Now the LRU order is a, e, b, f
+	EXPECT_EQ(cell_a, AddGlyph(atlas, L'g', true, L'a'));
+	EXPECT_EQ(L'e', atlas.Glyph(cell_b));
+	EXPECT_EQ(L'b', atlas.Glyph(cell_c));
+	EXPECT_EQ(L'f', atlas.Glyph(cell_d));
+	EXPECT_EQ(L'g', atlas.Glyph(cell_a));
+}
+
+TEST(FontTest, GlyphAtlasTouchKeepsGlyphs)
+{
+	GlyphAtlas atlas(3);
+	uint32_t const cell_a = AddGlyph(atlas, L'a', false);
+	uint32_t const cell_b = AddGlyph(atlas, L'b', false);
+	AddGlyph(atlas, L'c', false);
+
+	// a and b stay, because they're used as often as new glyphs come in
+	wchar_t ch = L'd';
+	for (uint32_t i = 0; i < 100; ++ i, ++ ch)
+	{
+		atlas.Touch(cell_a);
+		atlas.Touch(cell_b);
+		AddGlyph(atlas, ch, true, static_cast<wchar_t>((0 == i) ? L'c' : ch - 1));
+		EXPECT_EQ(L'a', atlas.Glyph(cell_a));
+		EXPECT_EQ(L'b', atlas.Glyph(cell_b));
+	}
+}
@@ -0,0 +1,155 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KlayGE/JudaTexture.hpp>
+#include <KlayGE/ResLoader.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "KlayGETests.hpp"
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	uint32_t const NUM_TILES = 4;
+	uint32_t const TILE_SIZE = 16;
+
+	// Removes the file when the test ends, even when it fails
+	class ScopedFile
+	{
+	public:
+		explicit ScopedFile(std::string const & path)
+			: path_(path)
+		{
+		}
+		~ScopedFile()
+		{
+			std::remove(path_.c_str());
+		}
+
+		std::string const & Path() const
+		{
+			return path_;
+		}
+
+	private:
+		std::string path_;
+	};
+
+	JudaTexturePtr MakeJudaTexture(std::string const & file_name)
+	{
+		JudaTexturePtr juda_tex = MakeSharedPtr<JudaTexture>(NUM_TILES, TILE_SIZE, EF_ABGR8);
+		juda_tex->AddImageEntry("test", 0, 0, NUM_TILES, NUM_TILES, TAM_Wrap, TAM_Wrap, Color(0, 0, 0, 0));
+
+		uint32_t const level = juda_tex->TreeLevels() - 1;
+		std::vector<std::vector<uint8_t>> tiles;
+		std::vector<uint32_t> tile_ids;
+		std::vector<uint32_t> tile_attrs;
+		for (uint32_t y = 0; y < NUM_TILES; ++ y)
+		{
+			for (uint32_t x = 0; x < NUM_TILES; ++ x)
+			{
+				tiles.emplace_back(TILE_SIZE * TILE_SIZE * 4, static_cast<uint8_t>((y * NUM_TILES + x) * 16));
+				tile_ids.push_back(juda_tex->EncodeTileID(level, x, y));
+				tile_attrs.push_back(0);
+			}
+		}
+		juda_tex->CommitTiles(tiles, tile_ids, tile_attrs);
+		SaveJudaTexture(juda_tex, file_name);
+
+		// Streaming only happens on a loaded texture
+		juda_tex = LoadJudaTexture(file_name);
+		juda_tex->CacheProperty(32, EF_ABGR8, 2);
+		return juda_tex;
+	}
+
+	// Runs frames until nothing is in flight, and returns the number of frames it takes
+	uint32_t StreamAll(JudaTexture& juda_tex, std::vector<uint32_t> const & tile_ids)
+	{
+		uint32_t frame = 0;
+		for (; (frame < 10000) && (juda_tex.NumInFlightTiles() > 0); ++ frame)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+			uint32_t const num_resident = juda_tex.NumResidentTiles();
+			juda_tex.UpdateCache(tile_ids);
+			EXPECT_LE(juda_tex.NumResidentTiles(), num_resident + juda_tex.UploadBudget());
+		}
+		EXPECT_EQ(0U, juda_tex.NumInFlightTiles());
+		return frame;
+	}
+}
+
+TEST_F(KlayGETest, JudaTextureStreamsAsync)
+{
+	ScopedFile const jdt_file(ResLoader::Instance().AbsPath("") + "JudaTextureStreamsAsync.jdt");
+	JudaTexturePtr juda_tex = MakeJudaTexture(jdt_file.Path());
+
+	uint32_t const level = juda_tex->TreeLevels() - 1;
+	uint32_t const tile_id = juda_tex->EncodeTileID(level, 1, 1);
+	uint32_t const parent_id = juda_tex->EncodeTileID(level - 1, 0, 0);
+	uint32_t const sibling_id = juda_tex->EncodeTileID(level, 0, 1);
+
+	// Nothing is decoded in UpdateCache. The tile and its parent are requested, and show up in later frames.
+	std::vector<uint32_t> tile_ids(1, tile_id);
+	juda_tex->UpdateCache(tile_ids);
+	EXPECT_EQ(2U, juda_tex->NumInFlightTiles());
+	EXPECT_EQ(0U, juda_tex->NumResidentTiles());
+	uint32_t levels_up;
+	EXPECT_EQ(0xFFFFFFFF, juda_tex->FindResidentTile(levels_up, tile_id));
+
+	StreamAll(*juda_tex, tile_ids);
+	EXPECT_EQ(2U, juda_tex->NumResidentTiles());
+	EXPECT_EQ(tile_id, juda_tex->FindResidentTile(levels_up, tile_id));
+	EXPECT_EQ(0U, levels_up);
+	EXPECT_EQ(parent_id, juda_tex->FindResidentTile(levels_up, parent_id));
+	EXPECT_EQ(0U, levels_up);
+
+	// The sibling shares the parent, which stands in until the sibling itself arrives
+	tile_ids.assign(1, sibling_id);
+	juda_tex->UpdateCache(tile_ids);
+	EXPECT_EQ(1U, juda_tex->NumInFlightTiles());
+	EXPECT_EQ(parent_id, juda_tex->FindResidentTile(levels_up, sibling_id));
+	EXPECT_EQ(1U, levels_up);
+
+	StreamAll(*juda_tex, tile_ids);
+	EXPECT_EQ(3U, juda_tex->NumResidentTiles());
+	EXPECT_EQ(sibling_id, juda_tex->FindResidentTile(levels_up, sibling_id));
+	EXPECT_EQ(0U, levels_up);
+}
+
+TEST_F(KlayGETest, JudaTextureUploadBudget)
+{
+	ScopedFile const jdt_file(ResLoader::Instance().AbsPath("") + "JudaTextureUploadBudget.jdt");
+	JudaTexturePtr juda_tex = MakeJudaTexture(jdt_file.Path());
+	juda_tex->UploadBudget(1);
+
+	uint32_t const level = juda_tex->TreeLevels() - 1;
+	std::vector<uint32_t> tile_ids;
+	for (uint32_t y = 0; y < NUM_TILES; ++ y)
+	{
+		for (uint32_t x = 0; x < NUM_TILES; ++ x)
+		{
+			tile_ids.push_back(juda_tex->EncodeTileID(level, x, y));
+		}
+	}
+
+	// All the tiles, and their 4 parents
+	uint32_t const num_requested = NUM_TILES * NUM_TILES + 4;
+	juda_tex->UpdateCache(tile_ids);
+	EXPECT_EQ(num_requested, juda_tex->NumInFlightTiles());
+
+	// One upload a frame
+	EXPECT_LE(num_requested, StreamAll(*juda_tex, tile_ids));
+	EXPECT_EQ(num_requested, juda_tex->NumResidentTiles());
+	for (auto const tile_id : tile_ids)
+	{
+		uint32_t levels_up;
+		EXPECT_EQ(tile_id, juda_tex->FindResidentTile(levels_up, tile_id));
+		EXPECT_EQ(0U, levels_up);
+	}
+}
@@ -0,0 +1,239 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Timer.hpp>
+#include <KlayGE/Lobby.hpp>
+#include <KlayGE/NetMsg.hpp>
+#include <KlayGE/Player.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#if !defined KLAYGE_PLATFORM_WINDOWS
+#include <sys/resource.h>
+#endif
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	class CountingProcessor : public Processor
+	{
+	public:
+		CountingProcessor()
+			: num_joins(0), num_quits(0)
+		{
+		}
+
+		void OnJoin(uint32_t /*ID*/) const override
+		{
+			++ num_joins;
+		}
+		void OnQuit(uint32_t /*ID*/) const override
+		{
+			++ num_quits;
+		}
+
+		mutable std::atomic<uint32_t> num_joins;
+		mutable std::atomic<uint32_t> num_quits;
+	};
+
+	class EchoProcessor : public Processor
+	{
+	public:
+		void OnDefault(void* revBuf, int size, void* sendBuf, int& numSend, sockaddr_in& /*from*/) const override
+		{
+			std::memcpy(static_cast<char*>(sendBuf) + 1, static_cast<char*>(revBuf) + 1, size - 1);
+			numSend = size - 1;
+		}
+	};
+
+	sockaddr_in LoopbackAddr(Lobby const & lobby)
+	{
+		return TransAddr("127.0.0.1", ntohs(lobby.SockAddr().sin_port));
+	}
+
+	template <typename Pred>
+	bool WaitFor(Pred pred)
+	{
+		for (int i = 0; i < 200; ++ i)
+		{
+			if (pred())
+			{
+				return true;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		return pred();
+	}
+}
+
+TEST(LobbyTest, JoinInfoQuit)
+{
+	CountingProcessor pro;
+	Lobby lobby;
+	lobby.Create("TestLobby", 4, 0);
+	std::thread server([&lobby, &pro] { lobby.Run(pro); });
+
+	sockaddr_in const addr = LoopbackAddr(lobby);
+	Player players[5];
+	for (uint32_t i = 0; i < 4; ++ i)
+	{
+		players[i].Name("Player");
+		EXPECT_TRUE(players[i].Join(addr));
+		EXPECT_NE(players[i].ID(), 0U);
+	}
+	EXPECT_FALSE(players[4].Join(addr));
+
+	LobbyDes const des = players[0].LobbyInfo();
+	EXPECT_EQ(des.numPlayer, 4U);
+	EXPECT_EQ(des.maxPlayers, 4U);
+	EXPECT_EQ(des.name, "TestLobby");
+
+	uint32_t const quit_id = players[1].ID();
+	players[1].Quit();
+	EXPECT_TRUE(WaitFor([&lobby] { return lobby.NumPlayer() == 3; }));
+	EXPECT_TRUE(players[4].Join(addr));
+	EXPECT_EQ(lobby.NumPlayer(), 4U);
+	// Takes the slot of the one that quit, but not its id
+	EXPECT_NE(players[4].ID(), quit_id);
+
+	// Messages from other threads reach the player, and the ones to the player that quit are dropped
+	char const stale_msg[] = { MSG_USER, 'n', 'o' };
+	lobby.SendToPlayer(quit_id, stale_msg, sizeof(stale_msg));
+	char const msg[] = { MSG_USER, 'h', 'i' };
+	lobby.SendToPlayer(players[4].ID(), msg, sizeof(msg));
+	char buf[16];
+	sockaddr_in from;
+	EXPECT_TRUE(WaitFor([&] { return players[4].Receive(buf, sizeof(buf), from) == sizeof(msg); }));
+	EXPECT_EQ(0, std::memcmp(buf, msg, sizeof(msg)));
+
+	lobby.Close();
+	server.join();
+
+	EXPECT_EQ(pro.num_joins, 5U);
+	EXPECT_EQ(pro.num_quits, 1U);
+}
+
+TEST(LobbyTest, TimeOut)
+{
+	CountingProcessor pro;
+	Lobby lobby;
+	lobby.PlayerTimeOut(300);
+	lobby.Create("TestLobby", 8, 0);
+	std::thread server([&lobby, &pro] { lobby.Run(pro); });
+
+	sockaddr_in const addr = LoopbackAddr(lobby);
+	Player quiet;
+	Player chatty;
+	EXPECT_TRUE(quiet.Join(addr));
+	EXPECT_TRUE(chatty.Join(addr));
+
+	// The one that keeps talking stays
+	char const nop = MSG_NOP;
+	EXPECT_TRUE(WaitFor([&] { chatty.Send(&nop, sizeof(nop)); return lobby.NumPlayer() == 1; }));
+	EXPECT_EQ(pro.num_quits, 1U);
+
+	lobby.Close();
+	server.join();
+}
+
+TEST(LobbyTest, DISABLED_Benchmark)
+{
+	uint32_t const NUM_PLAYERS = 2000;
+	uint32_t const NUM_ROUNDS = 50;
+	// Players sending at once. More would overflow the default receive buffer of the lobby.
+	uint32_t const WINDOW = 128;
+
+#if !defined KLAYGE_PLATFORM_WINDOWS
+	rlimit limit;
+	getrlimit(RLIMIT_NOFILE, &limit);
+	if (limit.rlim_cur < NUM_PLAYERS + 64)
+	{
+		limit.rlim_cur = std::min<rlim_t>(limit.rlim_max, NUM_PLAYERS + 64);
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+#endif
+
+	EchoProcessor pro;
+	Lobby lobby;
+	lobby.Create("Benchmark", NUM_PLAYERS, 0);
+	std::thread server([&lobby, &pro] { lobby.Run(pro); });
+
+	sockaddr_in const addr = LoopbackAddr(lobby);
+	std::vector<std::unique_ptr<Player>> players(NUM_PLAYERS);
+	for (auto& player : players)
+	{
+		player = MakeUniquePtr<Player>();
+		ASSERT_TRUE(player->Join(addr));
+	}
+	EXPECT_EQ(lobby.NumPlayer(), NUM_PLAYERS);
+
+	typedef std::chrono::steady_clock clock;
+	std::vector<double> latencies;
+	latencies.reserve(NUM_PLAYERS * NUM_ROUNDS);
+	uint32_t num_lost = 0;
+
+	Timer timer;
+	for (uint32_t round = 0; round < NUM_ROUNDS; ++ round)
+	{
+		for (uint32_t base = 0; base < NUM_PLAYERS; base += WINDOW)
+		{
+			uint32_t const end = std::min(base + WINDOW, NUM_PLAYERS);
+			for (uint32_t i = base; i < end; ++ i)
+			{
+				char msg[1 + sizeof(int64_t)];
+				msg[0] = MSG_USER;
+				int64_t const now = clock::now().time_since_epoch().count();
+				std::memcpy(&msg[1], &now, sizeof(now));
+				players[i]->Send(msg, sizeof(msg));
+			}
+
+			for (uint32_t i = base; i < end; ++ i)
+			{
+				auto const deadline = clock::now() + std::chrono::seconds(1);
+				char buf[64];
+				sockaddr_in from;
+				int size;
+				while (((size = players[i]->Receive(buf, sizeof(buf), from)) <= 0) && (clock::now() < deadline))
+				{
+				}
+
+				if (size == 1 + sizeof(int64_t))
+				{
+					int64_t sent;
+					std::memcpy(&sent, &buf[1], sizeof(sent));
+					latencies.push_back(std::chrono::duration<double, std::micro>(
+						clock::duration(clock::now().time_since_epoch().count() - sent)).count());
+				}
+				else
+				{
+					++ num_lost;
+				}
+			}
+		}
+	}
+	double const time = timer.elapsed();
+
+	lobby.Close();
+	server.join();
+
+	ASSERT_FALSE(latencies.empty());
+	std::sort(latencies.begin(), latencies.end());
+	auto percentile = [&latencies](double p)
+	{
+		return latencies[std::min(static_cast<size_t>(latencies.size() * p), latencies.size() - 1)];
+	};
+
+	cout << NUM_PLAYERS << " players: " << static_cast<uint64_t>(latencies.size() / time) << " round trips/s, "
+		<< "latency p50 " << percentile(0.5) << " us, p99 " << percentile(0.99) << " us, p99.9 " << percentile(0.999)
+		<< " us, " << num_lost << " lost" << endl;
+	EXPECT_LT(num_lost, NUM_PLAYERS * NUM_ROUNDS / 100);
+}
@@ -0,0 +1,263 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Log.hpp>
+#include <KFL/Timer.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	class CaptureLogSink : public LogSink
+	{
+	public:
+		void Write(LogSeverity severity, std::string_view line, size_t msg_offset) override
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			severities_.push_back(severity);
+			lines_.emplace_back(line);
+			msgs_.emplace_back(line.substr(msg_offset));
+		}
+
+		std::vector<std::string> Msgs()
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			return msgs_;
+		}
+		std::vector<std::string> Lines()
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			return lines_;
+		}
+		std::vector<LogSeverity> Severities()
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			return severities_;
+		}
+
+	private:
+		std::mutex mutex_;
+		std::vector<LogSeverity> severities_;
+		std::vector<std::string> lines_;
+		std::vector<std::string> msgs_;
+	};
+
+	class NullLogSink : public LogSink
+	{
+	public:
+		void Write(LogSeverity severity, std::string_view line, size_t msg_offset) override
+		{
+			KFL_UNUSED(severity);
+			KFL_UNUSED(msg_offset);
+
+			count_ += line.size();
+		}
+
+		size_t count_ = 0;
+	};
+
+	// Replaces the default sinks during a test
+	class ScopedSink
+	{
+	public:
+		explicit ScopedSink(LogSinkPtr const & sink)
+		{
+			Logger::Instance().Flush();
+			Logger::Instance().ClearSinks();
+			Logger::Instance().AddSink(sink);
+		}
+
+		~ScopedSink()
+		{
+			Logger::Instance().Flush();
+			Logger::Instance().ClearSinks();
+			Logger::Instance().AddSink(MakeSharedPtr<ConsoleLogSink>());
+			Logger::Instance().MinSeverity(LS_Info);
+		}
+	};
+
+	uint64_t FileSize(std::string const & path)
+	{
+		std::ifstream file(path.c_str(), std::ios_base::binary | std::ios_base::ate);
+		return file ? static_cast<uint64_t>(file.tellg()) : 0;
+	}
+}
+
+TEST(LogTest, Format)
+{
+	auto sink = MakeSharedPtr<CaptureLogSink>();
+	ScopedSink scoped(sink);
+
+	LogInfo("Info %d", 1);
+	LogWarn("Warn %s", "two");
+	LogError("Error %.1f", 3.0f);
+
+	// Errors are written before LogError returns
+	auto const msgs = sink->Msgs();
+	ASSERT_EQ(msgs.size(), 3U);
+	EXPECT_EQ(msgs[0], "Info 1");
+	EXPECT_EQ(msgs[1], "Warn two");
+	EXPECT_EQ(msgs[2], "Error 3.0");
+
+	auto const severities = sink->Severities();
+	EXPECT_EQ(severities[0], LS_Info);
+	EXPECT_EQ(severities[1], LS_Warn);
+	EXPECT_EQ(severities[2], LS_Error);
+
+	// [YYYY-mm-dd HH:MM:SS.mmm] [T<id>] (WARN) KlayGE: Warn two
+	auto const lines = sink->Lines();
+	EXPECT_EQ(lines[1][0], '[');
+	EXPECT_EQ(lines[1][24], ']');
+	EXPECT_NE(lines[1].find("] [T"), std::string::npos);
+	EXPECT_NE(lines[1].find("(WARN) KlayGE: Warn two"), std::string::npos);
+}
+
+TEST(LogTest, MinSeverity)
+{
+	auto sink = MakeSharedPtr<CaptureLogSink>();
+	ScopedSink scoped(sink);
+
+	Logger::Instance().MinSeverity(LS_Warn);
+	LogInfo("Dropped");
+	LogWarn("Kept");
+	Logger::Instance().Flush();
+
+	auto const msgs = sink->Msgs();
+	ASSERT_EQ(msgs.size(), 1U);
+	EXPECT_EQ(msgs[0], "Kept");
+}
+
+TEST(LogTest, LongMessages)
+{
+	auto sink = MakeSharedPtr<CaptureLogSink>();
+	ScopedSink scoped(sink);
+
+	// Used to overflow a 1024-byte buffer. The second one doesn't fit in the queue.
+	std::string const mid(3000, 'a');
+	std::string const big(100000, 'b');
+	LogInfo("%s", mid.c_str());
+	LogInfo("%s", big.c_str());
+	LogInfo("short");
+	Logger::Instance().Flush();
+
+	auto const msgs = sink->Msgs();
+	ASSERT_EQ(msgs.size(), 3U);
+	EXPECT_EQ(msgs[0], mid);
+	EXPECT_EQ(msgs[1], big);
+	EXPECT_EQ(msgs[2], "short");
+}
+
+TEST(LogTest, MultiThreads)
+{
+	int const NUM_THREADS = 4;
+	int const NUM_MSGS = 20000;
+
+	auto sink = MakeSharedPtr<CaptureLogSink>();
+	ScopedSink scoped(sink);
+
+	// Much more than a queue holds, so the threads have to wait for the logging thread sometimes
+	std::vector<std::thread> threads;
+	for (int t = 0; t < NUM_THREADS; ++ t)
+	{
+		threads.emplace_back([t]
+			{
+				for (int i = 0; i < NUM_MSGS; ++ i)
+				{
+					LogInfo("%d %d", t, i);
+				}
+			});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	Logger::Instance().Flush();
+
+	// Nothing is lost, and the messages of each thread are in order
+	auto const msgs = sink->Msgs();
+	ASSERT_EQ(msgs.size(), static_cast<size_t>(NUM_THREADS * NUM_MSGS));
+	std::vector<int> next(NUM_THREADS, 0);
+	for (auto const & msg : msgs)
+	{
+		int t, i;
+		ASSERT_EQ(std::sscanf(msg.c_str(), "%d %d", &t, &i), 2);
+		ASSERT_TRUE((t >= 0) && (t < NUM_THREADS));
+		EXPECT_EQ(i, next[t]);
+		next[t] = i + 1;
+	}
+}
+
+TEST(LogTest, RotatingFile)
+{
+	std::string const path = "LogTest.log";
+	auto sink = MakeSharedPtr<RotatingFileLogSink>(path, 1000, 2);
+	{
+		ScopedSink scoped(sink);
+		for (int i = 0; i < 100; ++ i)
+		{
+			LogInfo("Line %d", i);
+		}
+		Logger::Instance().Flush();
+	}
+	sink.reset();
+
+	EXPECT_GT(FileSize(path), 0U);
+	EXPECT_LE(FileSize(path), 1000U);
+	EXPECT_GT(FileSize(path + ".1"), 0U);
+	EXPECT_LE(FileSize(path + ".1"), 1000U);
+	EXPECT_GT(FileSize(path + ".2"), 0U);
+	EXPECT_EQ(FileSize(path + ".3"), 0U);
+
+	// The newest lines are in the current file
+	{
+		std::ifstream file(path.c_str());
+		std::string line;
+		std::string last;
+		while (std::getline(file, line))
+		{
+			last = line;
+		}
+		EXPECT_NE(last.find("Line 99"), std::string::npos);
+	}
+
+	std::remove(path.c_str());
+	std::remove((path + ".1").c_str());
+	std::remove((path + ".2").c_str());
+}
+
+TEST(LogTest, DISABLED_Benchmark)
+{
+	int const NUM_MSGS = 200000;
+
+	auto sink = MakeSharedPtr<NullLogSink>();
+	ScopedSink scoped(sink);
+
+	Timer timer;
+	for (int i = 0; i < NUM_MSGS; ++ i)
+	{
+		LogInfo("Frame %d, %d objects, %f ms", i, i * 3, i * 0.5f);
+	}
+	double const time = timer.elapsed();
+	Logger::Instance().Flush();
+	EXPECT_GT(sink->count_, 0U);
+
+	Logger::Instance().MinSeverity(LS_Warn);
+	timer.restart();
+	for (int i = 0; i < NUM_MSGS; ++ i)
+	{
+		LogInfo("Frame %d, %d objects, %f ms", i, i * 3, i * 0.5f);
+	}
+	double const filtered_time = timer.elapsed();
+
+	cout << "LogInfo: " << time / NUM_MSGS * 1e9 << " ns per call, filtered out: "
+		<< filtered_time / NUM_MSGS * 1e9 << " ns per call" << endl;
+}
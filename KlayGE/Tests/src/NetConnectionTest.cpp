@@ -0,0 +1,341 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Timer.hpp>
+#include <KlayGE/NetConnection.hpp>
+#include <KlayGE/Socket.hpp>
+
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	// One direction of a link, with loss, latency and jitter. Jitter reorders the packets.
+	class SimulatedLink
+	{
+	public:
+		SimulatedLink(float loss, double latency, double jitter, uint32_t seed)
+			: loss_(loss), latency_(latency), jitter_(jitter), gen_(seed), time_(0)
+		{
+		}
+
+		NetConnection::PacketSender Sender()
+		{
+			return [this](void const * packet, uint32_t size)
+			{
+				std::uniform_real_distribution<float> dist(0, 1);
+				if (dist(gen_) >= loss_)
+				{
+					InFlight in_flight;
+					in_flight.arrival = time_ + latency_ + jitter_ * dist(gen_);
+					in_flight.data.assign(static_cast<uint8_t const *>(packet), static_cast<uint8_t const *>(packet) + size);
+					packets_.push_back(in_flight);
+				}
+			};
+		}
+
+		void Deliver(double time, NetConnection& to)
+		{
+			time_ = time;
+			for (auto iter = packets_.begin(); iter != packets_.end();)
+			{
+				if (iter->arrival <= time)
+				{
+					to.OnPacket(iter->data.data(), static_cast<uint32_t>(iter->data.size()), time);
+					iter = packets_.erase(iter);
+				}
+				else
+				{
+					++ iter;
+				}
+			}
+		}
+
+	private:
+		struct InFlight
+		{
+			double arrival;
+			std::vector<uint8_t> data;
+		};
+
+		float loss_;
+		double latency_;
+		double jitter_;
+		std::ranlux24_base gen_;
+		double time_;
+		std::deque<InFlight> packets_;
+	};
+
+	std::vector<uint8_t> MakeMessage(uint32_t index)
+	{
+		// Some are large enough to be fragmented
+		uint32_t const size = 1 + (index * 7919) % ((index % 10 == 0) ? 20000 : 300);
+		std::vector<uint8_t> msg(size);
+		for (uint32_t i = 0; i < size; ++ i)
+		{
+			msg[i] = static_cast<uint8_t>(index * 31 + i);
+		}
+		std::memcpy(&msg[0], &index, std::min<size_t>(sizeof(index), size));
+		return msg;
+	}
+}
+
+TEST(NetConnectionTest, ReliableOrderedUnderLoss)
+{
+	uint32_t const NUM_MSGS = 300;
+
+	SimulatedLink a_to_b(0.2f, 0.05, 0.03, 1);
+	SimulatedLink b_to_a(0.2f, 0.05, 0.03, 2);
+	NetConnection a(a_to_b.Sender());
+	NetConnection b(b_to_a.Sender());
+	EXPECT_EQ(a.AddChannel(NetConnection::CT_ReliableOrdered), 0U);
+	EXPECT_EQ(b.AddChannel(NetConnection::CT_ReliableOrdered), 0U);
+
+	uint32_t num_received = 0;
+	double time = 0;
+	for (uint32_t step = 0; (step < 3000) && (num_received < NUM_MSGS); ++ step, time += 0.01)
+	{
+		if (step < NUM_MSGS)
+		{
+			std::vector<uint8_t> const msg = MakeMessage(step);
+			a.Send(0, msg.data(), static_cast<uint32_t>(msg.size()));
+		}
+
+		a.Update(time);
+		b.Update(time);
+		a_to_b.Deliver(time, b);
+		b_to_a.Deliver(time, a);
+
+		uint32_t channel;
+		std::vector<uint8_t> msg;
+		while (b.Receive(channel, msg))
+		{
+			EXPECT_EQ(channel, 0U);
+			EXPECT_TRUE(msg == MakeMessage(num_received)) << "message " << num_received;
+			++ num_received;
+		}
+	}
+
+	EXPECT_EQ(num_received, NUM_MSGS);
+}
+
+TEST(NetConnectionTest, UnreliableSequenced)
+{
+	SimulatedLink a_to_b(0.1f, 0.02, 0.05, 3);
+	SimulatedLink b_to_a(0, 0.02, 0, 4);
+	NetConnection a(a_to_b.Sender());
+	NetConnection b(b_to_a.Sender());
+	a.AddChannel(NetConnection::CT_ReliableOrdered);
+	a.AddChannel(NetConnection::CT_UnreliableSequenced);
+	b.AddChannel(NetConnection::CT_ReliableOrdered);
+	b.AddChannel(NetConnection::CT_UnreliableSequenced);
+
+	int32_t last = -1;
+	uint32_t num_received = 0;
+	double time = 0;
+	for (uint32_t step = 0; step < 400; ++ step, time += 0.01)
+	{
+		if (step < 300)
+		{
+			std::vector<uint8_t> const msg = MakeMessage(step);
+			a.Send(1, msg.data(), static_cast<uint32_t>(msg.size()));
+		}
+
+		a.Update(time);
+		b.Update(time);
+		a_to_b.Deliver(time, b);
+		b_to_a.Deliver(time, a);
+
+		uint32_t channel;
+		std::vector<uint8_t> msg;
+		while (b.Receive(channel, msg))
+		{
+			EXPECT_EQ(channel, 1U);
+			int32_t index = 0;
+			std::memcpy(&index, &msg[0], std::min<size_t>(sizeof(index), msg.size()));
+			EXPECT_GT(index, last);
+			EXPECT_TRUE(msg == MakeMessage(index));
+			last = index;
+			++ num_received;
+		}
+	}
+
+	// Lost, or overtaken by a newer one
+	EXPECT_GT(num_received, 150U);
+	EXPECT_LT(num_received, 300U);
+}
+
+TEST(NetConnectionTest, SnapshotDeltaCompression)
+{
+	uint32_t const NUM_ENTITIES = 256;
+	uint32_t const ENTITY_SIZE = 16;
+	uint32_t const NUM_TICKS = 300;
+	uint32_t const STATE_SIZE = NUM_ENTITIES * ENTITY_SIZE;
+
+	SimulatedLink a_to_b(0.05f, 0.05, 0.01, 5);
+	SimulatedLink b_to_a(0.05f, 0.05, 0.01, 6);
+	NetConnection a(a_to_b.Sender());
+	NetConnection b(b_to_a.Sender());
+
+	std::ranlux24_base gen(7);
+	std::vector<std::vector<uint8_t>> states;
+	std::vector<uint8_t> state(STATE_SIZE);
+	for (auto& s : state)
+	{
+		s = static_cast<uint8_t>(gen());
+	}
+
+	uint32_t num_received = 0;
+	double time = 0;
+	for (uint32_t tick = 0; tick < NUM_TICKS; ++ tick, time += 1.0 / 30)
+	{
+		// A few entities move every tick. The first 4 bytes are the tick.
+		for (uint32_t i = 0; i < 8; ++ i)
+		{
+			uint32_t const entity = 1 + gen() % (NUM_ENTITIES - 1);
+			for (uint32_t j = 0; j < 6; ++ j)
+			{
+				state[entity * ENTITY_SIZE + j] = static_cast<uint8_t>(gen());
+			}
+		}
+		std::memcpy(&state[0], &tick, sizeof(tick));
+		states.push_back(state);
+		a.SendSnapshot(state.data(), STATE_SIZE);
+
+		a.Update(time);
+		b.Update(time);
+		a_to_b.Deliver(time, b);
+		b_to_a.Deliver(time, a);
+
+		std::vector<uint8_t> received;
+		if (b.ReceiveSnapshot(received))
+		{
+			uint32_t received_tick;
+			std::memcpy(&received_tick, &received[0], sizeof(received_tick));
+			ASSERT_LE(received_tick, tick);
+			EXPECT_TRUE(received == states[received_tick]) << "tick " << received_tick;
+			++ num_received;
+		}
+	}
+
+	EXPECT_GT(num_received, NUM_TICKS * 8 / 10);
+
+	uint64_t const full_bytes = static_cast<uint64_t>(NUM_TICKS) * STATE_SIZE;
+	cout << "Snapshots: " << a.BytesSent() << " bytes sent, " << full_bytes << " bytes without delta compression" << endl;
+	EXPECT_LT(a.BytesSent() * 10, full_bytes);
+}
+
+TEST(NetConnectionTest, MalformedFragments)
+{
+	std::vector<std::vector<uint8_t>> packets;
+	NetConnection a([&packets](void const * packet, uint32_t size)
+		{
+			packets.emplace_back(static_cast<uint8_t const *>(packet), static_cast<uint8_t const *>(packet) + size);
+		});
+	NetConnection b([](void const * packet, uint32_t size)
+		{
+			KFL_UNUSED(packet);
+			KFL_UNUSED(size);
+		});
+	a.AddChannel(NetConnection::CT_ReliableOrdered);
+	b.AddChannel(NetConnection::CT_ReliableOrdered);
+
+	std::vector<uint8_t> const msg = MakeMessage(10);
+	ASSERT_GT(msg.size(), a.MTU());
+	a.Send(0, msg.data(), static_cast<uint32_t>(msg.size()));
+	a.Update(0);
+	ASSERT_FALSE(packets.empty());
+
+	// Packet header, then channel, message id, fragment index, fragment count and the total size
+	uint32_t const TOTAL_SIZE_OFFSET = 8 + 1 + 2 + 1 + 1;
+	uint32_t total_size;
+	std::memcpy(&total_size, &packets[0][TOTAL_SIZE_OFFSET], sizeof(total_size));
+	ASSERT_EQ(total_size, msg.size());
+
+	uint32_t const bad_sizes[] = { 0xFFFFFFF0U, 0x10000000U, static_cast<uint32_t>(msg.size()) * 2, 1 };
+	for (uint32_t bad_size : bad_sizes)
+	{
+		std::vector<uint8_t> packet = packets[0];
+		std::memcpy(&packet[TOTAL_SIZE_OFFSET], &bad_size, sizeof(bad_size));
+		b.OnPacket(packet.data(), static_cast<uint32_t>(packet.size()), 0);
+	}
+
+	// The real message still goes through
+	for (auto const & packet : packets)
+	{
+		b.OnPacket(packet.data(), static_cast<uint32_t>(packet.size()), 0);
+	}
+	uint32_t channel;
+	std::vector<uint8_t> received;
+	ASSERT_TRUE(b.Receive(channel, received));
+	EXPECT_TRUE(received == msg);
+}
+
+TEST(NetConnectionTest, OverLoopbackSockets)
+{
+	uint32_t const NUM_MSGS = 100;
+
+	Socket socket_a;
+	Socket socket_b;
+	socket_a.Create(SOCK_DGRAM);
+	socket_b.Create(SOCK_DGRAM);
+	socket_a.Bind(TransAddr("127.0.0.1", 0));
+	socket_b.Bind(TransAddr("127.0.0.1", 0));
+	socket_a.NonBlock(true);
+	socket_b.NonBlock(true);
+
+	sockaddr_in addr_a;
+	sockaddr_in addr_b;
+	socklen_t len = sizeof(addr_a);
+	socket_a.SockName(addr_a, len);
+	len = sizeof(addr_b);
+	socket_b.SockName(addr_b, len);
+
+	NetConnection a(socket_a, addr_b);
+	NetConnection b(socket_b, addr_a);
+	a.AddChannel(NetConnection::CT_ReliableOrdered);
+	b.AddChannel(NetConnection::CT_ReliableOrdered);
+
+	for (uint32_t i = 0; i < NUM_MSGS; ++ i)
+	{
+		std::vector<uint8_t> const msg = MakeMessage(i);
+		a.Send(0, msg.data(), static_cast<uint32_t>(msg.size()));
+	}
+
+	Timer timer;
+	uint32_t num_received = 0;
+	std::vector<uint8_t> buf(65536);
+	while ((num_received < NUM_MSGS) && (timer.elapsed() < 5))
+	{
+		double const time = timer.elapsed();
+		a.Update(time);
+		b.Update(time);
+
+		sockaddr_in from;
+		int size;
+		while ((size = socket_b.ReceiveFrom(&buf[0], static_cast<int>(buf.size()), from)) > 0)
+		{
+			b.OnPacket(&buf[0], size, time);
+		}
+		while ((size = socket_a.ReceiveFrom(&buf[0], static_cast<int>(buf.size()), from)) > 0)
+		{
+			a.OnPacket(&buf[0], size, time);
+		}
+
+		uint32_t channel;
+		std::vector<uint8_t> msg;
+		while (b.Receive(channel, msg))
+		{
+			EXPECT_TRUE(msg == MakeMessage(num_received));
+			++ num_received;
+		}
+	}
+
+	EXPECT_EQ(num_received, NUM_MSGS);
+}
@@ -0,0 +1,129 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Util.hpp>
+#include <KFL/ResIdentifier.hpp>
+#include <KFL/CXX17/filesystem.hpp>
+#include <KlayGE/Package.hpp>
+#include <KlayGE/ResLoader.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	ResIdentifierPtr MakeMember(std::string const & content)
+	{
+		return MakeSharedPtr<ResIdentifier>("", 0, MakeSharedPtr<std::stringstream>(content));
+	}
+
+	std::string ReadAll(ResIdentifierPtr const & res)
+	{
+		std::stringstream ss;
+		ss << res->input_stream().rdbuf();
+		return ss.str();
+	}
+
+	// Removes the file when the test ends, even when it fails
+	class ScopedFile
+	{
+	public:
+		explicit ScopedFile(std::string const & path)
+			: path_(path)
+		{
+		}
+		~ScopedFile()
+		{
+			std::remove(path_.c_str());
+		}
+
+		std::string const & Path() const
+		{
+			return path_;
+		}
+
+	private:
+		std::string path_;
+	};
+}
+
+TEST(PackageTest, OpenMembers)
+{
+	ScopedFile const pkg_file(ResLoader::Instance().AbsPath("") + "PackageTest.kpkg");
+	std::string const & pkg_name = pkg_file.Path();
+	{
+		std::vector<std::pair<std::string, ResIdentifierPtr>> members;
+		members.emplace_back("Dir\\A.txt", MakeMember("Hello"));
+		members.emplace_back("B.bin", MakeMember(std::string("\0\1\2\3\4\5\6", 7)));
+		members.emplace_back("Empty", MakeMember(""));
+
+		std::ofstream ofs(pkg_name.c_str(), std::ios_base::binary);
+		Package::Write(ofs, members);
+	}
+
+	{
+		auto package = MakeSharedPtr<Package>(pkg_name);
+		ASSERT_TRUE(package->Valid());
+		EXPECT_EQ(3U, package->NumMembers());
+
+		EXPECT_TRUE(package->HasMember("dir/a.txt"));
+		EXPECT_TRUE(package->HasMember("DIR/A.TXT"));
+		EXPECT_FALSE(package->HasMember("C.txt"));
+		EXPECT_FALSE(package->OpenMember("C.txt", "C.txt"));
+
+		ResIdentifierPtr b = package->OpenMember("B.bin", "B.bin");
+		ASSERT_TRUE(b);
+		package.reset();
+
+		// The member keeps the mapping alive
+		EXPECT_EQ(std::string("\0\1\2\3\4\5\6", 7), ReadAll(b));
+	}
+
+	ResIdentifierPtr a = ResLoader::Instance().Open("PackageTest.kpkg//Dir/A.txt");
+	ASSERT_TRUE(a);
+	EXPECT_EQ("Hello", ReadAll(a));
+
+	ResIdentifierPtr empty = ResLoader::Instance().Open("PackageTest.kpkg//Empty");
+	ASSERT_TRUE(empty);
+	EXPECT_EQ("", ReadAll(empty));
+
+	EXPECT_FALSE(ResLoader::Instance().Open("PackageTest.kpkg//C.txt"));
+	EXPECT_TRUE(ResLoader::Instance().Locate("PackageTest.kpkg//C.txt").empty());
+}
+
+TEST(PackageTest, NotAPackage)
+{
+	ScopedFile const file(ResLoader::Instance().AbsPath("") + "PackageTest.txt");
+	{
+		std::ofstream ofs(file.Path().c_str(), std::ios_base::binary);
+		ofs << "Not a package";
+	}
+
+	auto package = MakeSharedPtr<Package>(file.Path());
+	EXPECT_FALSE(package->Valid());
+}
+
+TEST(PackageTest, TooManyMembers)
+{
+	ScopedFile const file(ResLoader::Instance().AbsPath("") + "PackageTestBroken.kpkg");
+	{
+		std::stringstream ss;
+		Package::Write(ss, { { "A.txt", MakeMember("Hello") } });
+		std::string data = ss.str();
+
+		// The number of members, after the fourcc and the version
+		data[8] = data[9] = data[10] = '\xFF';
+		data[11] = '\x7F';
+
+		std::ofstream ofs(file.Path().c_str(), std::ios_base::binary);
+		ofs.write(data.data(), data.size());
+	}
+
+	auto package = MakeSharedPtr<Package>(file.Path());
+	EXPECT_FALSE(package->Valid());
+}
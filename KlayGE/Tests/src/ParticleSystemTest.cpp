@@ -0,0 +1,129 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KlayGE/App3D.hpp>
+#include <KlayGE/Camera.hpp>
+#include <KlayGE/ParticleSystem.hpp>
+
+#include <random>
+#include <vector>
+
+#include "KlayGETests.hpp"
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	ParticleUpdaterPtr MakePolylineUpdater(ParticleSystemPtr const & ps)
+	{
+		ParticleUpdaterPtr updater = ps->MakeUpdater("polyline");
+		auto polyline = checked_pointer_cast<PolylineParticleUpdater>(updater);
+		polyline->SizeOverLife({ float2(0, 0.1f), float2(0.5f, 0.4f), float2(1, 0.2f) });
+		polyline->MassOverLife({ float2(0, 1), float2(1, 2) });
+		polyline->OpacityOverLife({ float2(0, 1), float2(0.3f, 0.5f), float2(1, 0) });
+		return updater;
+	}
+
+	ParticleEmitterPtr MakePointEmitter(ParticleSystemPtr const & ps, float3 const & center, float freq)
+	{
+		ParticleEmitterPtr emitter = ps->MakeEmitter("point");
+		emitter->Frequency(freq);
+		emitter->EmitAngle(PI / 3);
+		emitter->MinPosition(center - float3(0.1f, 0.1f, 0.1f));
+		emitter->MaxPosition(center + float3(0.1f, 0.1f, 0.1f));
+		emitter->MinVelocity(0.5f);
+		emitter->MaxVelocity(1);
+		emitter->MinLife(2);
+		emitter->MaxLife(3);
+		return emitter;
+	}
+
+	void RandomParticles(ParticleSoA& particles, uint32_t seed)
+	{
+		std::ranlux24_base gen(seed);
+		std::uniform_real_distribution<float> dist(0.1f, 2);
+
+		particles.num = particles.Capacity();
+		for (uint32_t i = 0; i < particles.num; ++ i)
+		{
+			Particle par;
+			par.pos = float3(dist(gen), dist(gen), dist(gen));
+			par.vel = float3(dist(gen), dist(gen), dist(gen));
+			par.init_life = 2;
+			par.life = dist(gen);
+			par.spin = dist(gen);
+			par.size = 0;
+			par.alpha = 0;
+			particles.Set(i, par);
+		}
+	}
+}
+
+TEST_F(KlayGETest, ParticleUpdateBatchMatchesUpdate)
+{
+	ParticleSystemPtr ps = MakeSharedPtr<ParticleSystem>(1003);
+	ps->Force(float3(0.1f, 0.2f, -0.3f));
+	ps->MediaDensity(0.7f);
+	ParticleUpdaterPtr updater = MakePolylineUpdater(ps);
+
+	ParticleSoA batch(1003);
+	ParticleSoA one_by_one(1003);
+	RandomParticles(batch, 1);
+	RandomParticles(one_by_one, 1);
+
+	// A range that doesn't start or end on a group of 4
+	for (int step = 0; step < 3; ++ step)
+	{
+		updater->UpdateBatch(batch, 5, 1002, 0.016f);
+		updater->ParticleUpdater::UpdateBatch(one_by_one, 5, 1002, 0.016f);
+	}
+
+	for (uint32_t i = 0; i < batch.num; ++ i)
+	{
+		Particle const lhs = batch.Get(i);
+		Particle const rhs = one_by_one.Get(i);
+		for (size_t c = 0; c < 3; ++ c)
+		{
+			EXPECT_NEAR(lhs.pos[c], rhs.pos[c], 1e-5f) << "particle " << i;
+			EXPECT_NEAR(lhs.vel[c], rhs.vel[c], 1e-5f) << "particle " << i;
+		}
+		EXPECT_EQ(lhs.life, rhs.life) << "particle " << i;
+		EXPECT_EQ(lhs.spin, rhs.spin) << "particle " << i;
+		EXPECT_EQ(lhs.size, rhs.size) << "particle " << i;
+		EXPECT_EQ(lhs.alpha, rhs.alpha) << "particle " << i;
+	}
+}
+
+TEST_F(KlayGETest, ParticleSystemMultipleEmitters)
+{
+	app->ActiveCamera().ViewParams(float3(0, 0, -10), float3(0, 0, 0));
+
+	ParticleSystemPtr ps = MakeSharedPtr<ParticleSystem>(4096);
+	ps->AddEmitter(MakePointEmitter(ps, float3(-3, 0, 0), 100));
+	ps->AddEmitter(MakePointEmitter(ps, float3(+3, 0, 5), 300));
+	ps->AddUpdater(MakePolylineUpdater(ps));
+
+	ps->SubThreadUpdate(0, 0.1f);
+	EXPECT_EQ(ps->NumParticles(), 10U + 30U);
+	ps->SubThreadUpdate(0.1f, 0.1f);
+	EXPECT_EQ(ps->NumParticles(), 2 * (10U + 30U));
+
+	uint32_t num_from_first = 0;
+	for (uint32_t i = 0; i < ps->NumParticles(); ++ i)
+	{
+		if (ps->GetParticle(i).pos.x() < 0)
+		{
+			++ num_from_first;
+		}
+	}
+	EXPECT_EQ(num_from_first, 2 * 10U);
+
+	// Back to front
+	float4x4 const & view = app->ActiveCamera().ViewMatrix();
+	ASSERT_EQ(ps->NumActiveParticles(), ps->NumParticles());
+	for (uint32_t i = 1; i < ps->NumActiveParticles(); ++ i)
+	{
+		float const prev_depth = MathLib::transform_coord(ps->GetActiveParticle(i - 1).pos, view).z();
+		float const depth = MathLib::transform_coord(ps->GetActiveParticle(i).pos, view).z();
+		EXPECT_GE(prev_depth, depth);
+	}
+}
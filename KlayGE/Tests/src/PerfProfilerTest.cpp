@@ -0,0 +1,189 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KlayGE/PerfProfiler.hpp>
+
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	std::string ReadFile(std::string const & file_name)
+	{
+		std::ifstream ifs(file_name.c_str());
+		std::stringstream ss;
+		ss << ifs.rdbuf();
+		return ss.str();
+	}
+
+	size_t Count(std::string const & str, std::string const & pattern)
+	{
+		size_t ret = 0;
+		for (size_t pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + 1))
+		{
+			++ ret;
+		}
+		return ret;
+	}
+}
+
+TEST(PerfProfilerTest, ChromeTraceAcrossThreads)
+{
+	PerfProfiler& profiler = PerfProfiler::Instance();
+	bool const tracing = profiler.Tracing();
+	profiler.Tracing(true);
+
+	uint64_t flow_id;
+	{
+		PerfEventScope frame("Frame");
+		flow_id = profiler.FlowBegin("Job");
+		profiler.Counter("Jobs \"queued\"", 1);
+	}
+
+	std::thread worker([&profiler, flow_id]
+		{
+			profiler.ThreadName("Worker");
+			PerfEventScope job("Job");
+			profiler.FlowStep("Job", flow_id);
+			{
+				PerfEventScope nested("Nested");
+			}
+		});
+	worker.join();
+
+	{
+		PerfEventScope frame("Frame");
+		profiler.FlowEnd("Job", flow_id);
+	}
+
+	profiler.ExportToChromeTrace("perf_profiler_test.json");
+	profiler.Tracing(tracing);
+
+	std::string const trace = ReadFile("perf_profiler_test.json");
+	EXPECT_EQ(0U, trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+	EXPECT_NE(std::string::npos, trace.find("\"args\":{\"name\":\"Worker\"}"));
+	EXPECT_NE(std::string::npos, trace.find("\"name\":\"Jobs \\\"queued\\\"\""));
+	EXPECT_EQ(Count(trace, "\"ph\":\"B\""), Count(trace, "\"ph\":\"E\""));
+	EXPECT_LE(4U, Count(trace, "\"ph\":\"B\""));
+
+	std::string const id = "\"id\":" + std::to_string(flow_id) + ",";
+	EXPECT_EQ(3U, Count(trace, id));
+	EXPECT_EQ(1U, Count(trace, "\"ph\":\"s\""));
+	EXPECT_EQ(1U, Count(trace, "\"ph\":\"t\""));
+	EXPECT_EQ(1U, Count(trace, "\"ph\":\"f\""));
+}
+
+TEST(PerfProfilerTest, RingBufferIsBounded)
+{
+	PerfProfiler& profiler = PerfProfiler::Instance();
+	bool const tracing = profiler.Tracing();
+	profiler.Tracing(true);
+
+	uint32_t const max_events = PerfProfiler::MAX_EVENTS_PER_THREAD;
+
+	// On a thread of its own, so only its events are in the ring
+	std::thread worker([&profiler, max_events]
+		{
+			profiler.ThreadName("Bounded");
+			for (uint32_t i = 0; i < max_events; ++ i)
+			{
+				PerfEventScope outer("Outer");
+				PerfEventScope inner("Inner");
+			}
+		});
+	worker.join();
+
+	profiler.ExportToChromeTrace("perf_profiler_test.json");
+	profiler.Tracing(tracing);
+
+	std::string const trace = ReadFile("perf_profiler_test.json");
+	size_t const begin_pos = trace.find("\"args\":{\"name\":\"Bounded\"}");
+	ASSERT_NE(std::string::npos, begin_pos);
+	std::string const bounded = trace.substr(begin_pos);
+	size_t const end_pos = bounded.find("thread_name", 1);
+	std::string const events = bounded.substr(0, end_pos);
+
+	size_t const num_begins = Count(events, "\"ph\":\"B\"");
+	size_t const num_ends = Count(events, "\"ph\":\"E\"");
+	EXPECT_EQ(max_events, num_begins + num_ends);
+	// Ends of the begins that have been overwritten are dropped
+	EXPECT_EQ(num_begins, num_ends);
+}
+
+TEST(PerfProfilerTest, ExportWhileRecording)
+{
+	PerfProfiler& profiler = PerfProfiler::Instance();
+	bool const tracing = profiler.Tracing();
+	profiler.Tracing(true);
+
+	// Keeps wrapping its ring around while the trace is exported
+	std::atomic<bool> quit(false);
+	std::atomic<uint32_t> num_loops(0);
+	std::thread worker([&profiler, &quit, &num_loops]
+		{
+			profiler.ThreadName("Busy");
+			while (!quit)
+			{
+				PerfEventScope busy("Busy");
+				profiler.Counter("Busy counter", 1);
+				++ num_loops;
+			}
+		});
+	while (num_loops < PerfProfiler::MAX_EVENTS_PER_THREAD)
+	{
+		std::this_thread::yield();
+	}
+
+	for (int i = 0; i < 5; ++ i)
+	{
+		profiler.ExportToChromeTrace("perf_profiler_test.json");
+
+		std::string const trace = ReadFile("perf_profiler_test.json");
+		EXPECT_EQ(0U, trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+		EXPECT_GE(Count(trace, "\"ph\":\"B\""), Count(trace, "\"ph\":\"E\""));
+	}
+
+	quit = true;
+	worker.join();
+	profiler.Tracing(tracing);
+}
+
+TEST(PerfProfilerTest, ThreadTracesAreReused)
+{
+	PerfProfiler& profiler = PerfProfiler::Instance();
+	bool const tracing = profiler.Tracing();
+	profiler.Tracing(true);
+
+	// One thread at a time, each takes the ring the one before left
+	auto run_thread = [&profiler](std::string const & name)
+	{
+		std::thread worker([&profiler, &name]
+			{
+				profiler.ThreadName(name);
+				PerfEventScope scope("Short lived");
+			});
+		worker.join();
+	};
+	run_thread("Short lived 0");
+	uint32_t const num_traces = profiler.NumThreadTraces();
+	for (int i = 1; i < 16; ++ i)
+	{
+		run_thread("Short lived " + std::to_string(i));
+	}
+	EXPECT_EQ(num_traces, profiler.NumThreadTraces());
+
+	profiler.ExportToChromeTrace("perf_profiler_test.json");
+	profiler.Tracing(tracing);
+
+	// The last thread's events are still there, the ones of the threads before are dropped with the reuse
+	std::string const trace = ReadFile("perf_profiler_test.json");
+	EXPECT_NE(std::string::npos, trace.find("\"args\":{\"name\":\"Short lived 15\"}"));
+	EXPECT_EQ(std::string::npos, trace.find("\"args\":{\"name\":\"Short lived 14\"}"));
+	EXPECT_EQ(1U, Count(trace, "\"name\":\"Short lived\""));
+}
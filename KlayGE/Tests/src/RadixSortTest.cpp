@@ -0,0 +1,103 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/CXX17/iterator.hpp>
+#include <KFL/RadixSort.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	struct Item
+	{
+		uint64_t key;
+		uint32_t id;
+	};
+
+	uint64_t ItemKey(Item const & item)
+	{
+		return item.key;
+	}
+}
+
+TEST(RadixSortTest, MatchesStableSort)
+{
+	std::mt19937 gen(1);
+	std::vector<Item> items(5000);
+	for (size_t i = 0; i < items.size(); ++ i)
+	{
+		// Few different keys, so stability matters. The high and low bytes vary, the middle ones are shared.
+		uint64_t const v = gen() % 64;
+		items[i].key = ((v & 0x7) << 56) | 0x0000123456780000ULL | (v >> 3);
+		items[i].id = static_cast<uint32_t>(i);
+	}
+
+	std::vector<Item> expected = items;
+	std::stable_sort(expected.begin(), expected.end(),
+		[](Item const & lhs, Item const & rhs)
+		{
+			return lhs.key < rhs.key;
+		});
+
+	std::vector<Item> scratch;
+	RadixSort(items, scratch, ItemKey);
+	ASSERT_EQ(expected.size(), items.size());
+	for (size_t i = 0; i < items.size(); ++ i)
+	{
+		EXPECT_EQ(expected[i].key, items[i].key);
+		EXPECT_EQ(expected[i].id, items[i].id);
+	}
+
+	// Sorting again keeps it as it is
+	RadixSort(items, scratch, ItemKey);
+	for (size_t i = 0; i < items.size(); ++ i)
+	{
+		EXPECT_EQ(expected[i].id, items[i].id);
+	}
+}
+
+TEST(RadixSortTest, FirstBit)
+{
+	// Only the high 32 bits are keys, the low ones keep the original order
+	std::vector<uint64_t> items = { (3ULL << 32) | 0, (1ULL << 32) | 1, (3ULL << 32) | 2, (2ULL << 32) | 3, (1ULL << 32) | 4 };
+	std::vector<uint64_t> scratch;
+	RadixSort(items, scratch, [](uint64_t item) { return item & 0xFFFFFFFF00000000ULL; }, 32);
+
+	std::vector<uint64_t> const expected = { (1ULL << 32) | 1, (1ULL << 32) | 4, (2ULL << 32) | 3, (3ULL << 32) | 0, (3ULL << 32) | 2 };
+	EXPECT_EQ(expected, items);
+}
+
+TEST(RadixSortTest, SortableFloat)
+{
+	float const values[] = { -std::numeric_limits<float>::infinity(), -1e10f, -2.5f, -1.0f, -1e-20f, 0.0f, 1e-20f, 0.5f,
+		1.0f, 3.0f, 1e10f, std::numeric_limits<float>::infinity() };
+	for (size_t i = 1; i < std::size(values); ++ i)
+	{
+		EXPECT_LT(SortableFloat(values[i - 1]), SortableFloat(values[i]));
+	}
+
+	std::mt19937 gen(2);
+	std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+	std::vector<uint64_t> items(1000);
+	std::vector<float> expected(items.size());
+	for (size_t i = 0; i < items.size(); ++ i)
+	{
+		expected[i] = dist(gen);
+		items[i] = (static_cast<uint64_t>(SortableFloat(expected[i])) << 32) | i;
+	}
+	std::stable_sort(expected.begin(), expected.end());
+
+	std::vector<uint64_t> scratch;
+	RadixSort(items, scratch, [](uint64_t item) { return item; }, 32);
+	for (size_t i = 0; i < items.size(); ++ i)
+	{
+		float const v = expected[i];
+		EXPECT_EQ(SortableFloat(v), items[i] >> 32);
+	}
+}
@@ -0,0 +1,404 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Util.hpp>
+#include <KFL/Hash.hpp>
+#include <KlayGE/ResLoader.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	class IntLoadingDesc : public ResLoadingDesc
+	{
+	public:
+		IntLoadingDesc(std::string const & res_name, bool state_less)
+			: res_name_(res_name), state_less_(state_less)
+		{
+		}
+
+		uint64_t Type() const override
+		{
+			static uint64_t const type = CT_HASH("IntLoadingDesc");
+			return type;
+		}
+
+		bool StateLess() const override
+		{
+			return state_less_;
+		}
+
+		void SubThreadStage() override
+		{
+		}
+
+		void MainThreadStage() override
+		{
+			value_ = MakeSharedPtr<int>(static_cast<int>(res_name_.size()));
+			weak_value_ = value_;
+		}
+
+		bool HasSubThreadStage() const override
+		{
+			return false;
+		}
+
+		bool Match(ResLoadingDesc const & rhs) const override
+		{
+			if (this->Type() == rhs.Type())
+			{
+				IntLoadingDesc const & ild = static_cast<IntLoadingDesc const &>(rhs);
+				return (res_name_ == ild.res_name_);
+			}
+			return false;
+		}
+
+		size_t Hash() const override
+		{
+			size_t seed = static_cast<size_t>(this->Type());
+			HashRange(seed, res_name_.begin(), res_name_.end());
+			return seed;
+		}
+
+		void CopyDataFrom(ResLoadingDesc const & rhs) override
+		{
+			BOOST_ASSERT(this->Type() == rhs.Type());
+
+			IntLoadingDesc const & ild = static_cast<IntLoadingDesc const &>(rhs);
+			res_name_ = ild.res_name_;
+		}
+
+		std::shared_ptr<void> CloneResourceFrom(std::shared_ptr<void> const & resource) override
+		{
+			value_ = MakeSharedPtr<int>(*std::static_pointer_cast<int>(resource));
+			weak_value_ = value_;
+			return value_;
+		}
+
+		// Hands the value over, so that the desc kept by the cache doesn't keep it alive
+		std::shared_ptr<void> Resource() const override
+		{
+			std::shared_ptr<int> value = weak_value_.lock();
+			value_.reset();
+			return value;
+		}
+
+	private:
+		std::string res_name_;
+		bool state_less_;
+		mutable std::shared_ptr<int> value_;
+		std::weak_ptr<int> weak_value_;
+	};
+
+	// Records the order of sub thread stages. The ones named "block..." wait until released.
+	class OrderLoadingDesc : public ResLoadingDesc
+	{
+	public:
+		OrderLoadingDesc(std::string const & res_name, std::vector<std::string>& order, std::mutex& order_mutex,
+				std::atomic<bool>& release, bool concurrent = false)
+			: res_name_(res_name), order_(order), order_mutex_(order_mutex), release_(release), concurrent_(concurrent)
+		{
+		}
+
+		uint64_t Type() const override
+		{
+			static uint64_t const type = CT_HASH("OrderLoadingDesc");
+			return type;
+		}
+
+		bool StateLess() const override
+		{
+			return true;
+		}
+
+		std::shared_ptr<void> CreateResource() override
+		{
+			value_ = MakeSharedPtr<int>(0);
+			return value_;
+		}
+
+		void SubThreadStage() override
+		{
+			if (0 == res_name_.compare(0, 5, "block"))
+			{
+				while (!release_)
+				{
+					std::this_thread::yield();
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(order_mutex_);
+			order_.push_back(res_name_);
+		}
+
+		void MainThreadStage() override
+		{
+			*value_ = 1;
+		}
+
+		bool HasSubThreadStage() const override
+		{
+			return true;
+		}
+
+		bool ConcurrentSubThreadStage() const override
+		{
+			return concurrent_;
+		}
+
+		bool Match(ResLoadingDesc const & rhs) const override
+		{
+			if (this->Type() == rhs.Type())
+			{
+				OrderLoadingDesc const & old = static_cast<OrderLoadingDesc const &>(rhs);
+				return (res_name_ == old.res_name_);
+			}
+			return false;
+		}
+
+		size_t Hash() const override
+		{
+			size_t seed = static_cast<size_t>(this->Type());
+			HashRange(seed, res_name_.begin(), res_name_.end());
+			return seed;
+		}
+
+		void CopyDataFrom(ResLoadingDesc const & rhs) override
+		{
+			BOOST_ASSERT(this->Type() == rhs.Type());
+
+			OrderLoadingDesc const & old = static_cast<OrderLoadingDesc const &>(rhs);
+			res_name_ = old.res_name_;
+			value_ = old.value_;
+		}
+
+		std::shared_ptr<void> CloneResourceFrom(std::shared_ptr<void> const & resource) override
+		{
+			return resource;
+		}
+
+		std::shared_ptr<void> Resource() const override
+		{
+			return value_;
+		}
+
+	private:
+		std::string res_name_;
+		std::vector<std::string>& order_;
+		std::mutex& order_mutex_;
+		std::atomic<bool>& release_;
+		bool concurrent_;
+		std::shared_ptr<int> value_;
+	};
+}
+
+TEST(ResLoaderTest, Cache)
+{
+	ResLoader& rl = ResLoader::Instance();
+	uint64_t const hits = rl.NumCacheHits();
+	uint64_t const misses = rl.NumCacheMisses();
+	uint64_t const clones = rl.NumCacheClones();
+
+	auto a = rl.SyncQueryT<int>(MakeSharedPtr<IntLoadingDesc>("ResLoaderTest_A", true));
+	auto a2 = rl.SyncQueryT<int>(MakeSharedPtr<IntLoadingDesc>("ResLoaderTest_A", true));
+	EXPECT_EQ(a, a2);
+	EXPECT_EQ(15, *a);
+
+	auto b = rl.SyncQueryT<int>(MakeSharedPtr<IntLoadingDesc>("ResLoaderTest_BB", false));
+	auto b2 = rl.SyncQueryT<int>(MakeSharedPtr<IntLoadingDesc>("ResLoaderTest_BB", false));
+	EXPECT_NE(b, b2);
+	EXPECT_EQ(*b, *b2);
+
+	EXPECT_EQ(hits + 2, rl.NumCacheHits());
+	EXPECT_EQ(misses + 2, rl.NumCacheMisses());
+	EXPECT_EQ(clones + 1, rl.NumCacheClones());
+
+	// Expired resources are not found any more
+	a.reset();
+	a2.reset();
+	auto a3 = rl.SyncQueryT<int>(MakeSharedPtr<IntLoadingDesc>("ResLoaderTest_A", true));
+	EXPECT_EQ(misses + 3, rl.NumCacheMisses());
+
+	// Unloaded ones too
+	rl.Unload(a3);
+	auto a4 = rl.SyncQueryT<int>(MakeSharedPtr<IntLoadingDesc>("ResLoaderTest_A", true));
+	EXPECT_NE(a3, a4);
+	EXPECT_EQ(misses + 4, rl.NumCacheMisses());
+}
+
+TEST(ResLoaderTest, ManyResources)
+{
+	ResLoader& rl = ResLoader::Instance();
+	uint64_t const hits = rl.NumCacheHits();
+
+	uint32_t const NUM_RESOURCES = 10000;
+	std::vector<std::shared_ptr<int>> resources(NUM_RESOURCES);
+	for (uint32_t i = 0; i < NUM_RESOURCES; ++ i)
+	{
+		resources[i] = rl.SyncQueryT<int>(MakeSharedPtr<IntLoadingDesc>("ResLoaderTest_" + std::to_string(i), true));
+	}
+	for (uint32_t i = 0; i < NUM_RESOURCES; ++ i)
+	{
+		EXPECT_EQ(resources[i], rl.SyncQueryT<int>(MakeSharedPtr<IntLoadingDesc>("ResLoaderTest_" + std::to_string(i), true)));
+	}
+	EXPECT_EQ(hits + NUM_RESOURCES, rl.NumCacheHits());
+}
+
+TEST(ResLoaderTest, PriorityAndCancel)
+{
+	ResLoader& rl = ResLoader::Instance();
+	uint32_t const num_threads = rl.NumLoadingThreads();
+	rl.NumLoadingThreads(1);
+
+	std::vector<ResLoadingTiming> timings;
+	rl.CollectLoadingTimings(timings);
+
+	std::vector<std::string> order;
+	std::mutex order_mutex;
+	std::atomic<bool> release(false);
+
+	// Keeps the only loading thread busy, so the rest are queued. It has the highest priority, so it runs first
+	//  even if the thread doesn't pick it up right away.
+	auto block = rl.ASyncQueryT<int>(MakeSharedPtr<OrderLoadingDesc>("block", order, order_mutex, release), 100);
+
+	auto low = rl.ASyncQueryT<int>(MakeSharedPtr<OrderLoadingDesc>("low", order, order_mutex, release), 1);
+	auto cancelled = rl.ASyncQueryT<int>(MakeSharedPtr<OrderLoadingDesc>("cancelled", order, order_mutex, release), 5);
+	auto high = rl.ASyncQueryT<int>(MakeSharedPtr<OrderLoadingDesc>("high", order, order_mutex, release), 10);
+	auto bumped = rl.ASyncQueryT<int>(MakeSharedPtr<OrderLoadingDesc>("bumped", order, order_mutex, release), 0);
+	rl.ASyncQueryT<int>(MakeSharedPtr<OrderLoadingDesc>("bumped", order, order_mutex, release), 20);
+	rl.Unload(cancelled);
+
+	release = true;
+	for (;;)
+	{
+		rl.Update();
+		{
+			std::lock_guard<std::mutex> lock(order_mutex);
+			if (order.size() >= 4)
+			{
+				break;
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	while (!*low)
+	{
+		rl.Update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	ASSERT_EQ(4U, order.size());
+	EXPECT_EQ("block", order[0]);
+	EXPECT_EQ("bumped", order[1]);
+	EXPECT_EQ("high", order[2]);
+	EXPECT_EQ("low", order[3]);
+	EXPECT_EQ(1, *block);
+	EXPECT_EQ(1, *high);
+	EXPECT_EQ(0, *cancelled);
+
+	rl.CollectLoadingTimings(timings);
+	uint32_t num_cancelled = 0;
+	for (auto const & timing : timings)
+	{
+		EXPECT_GE(timing.wait_time, 0);
+		EXPECT_GE(timing.sub_thread_time, 0);
+		if (timing.cancelled)
+		{
+			++ num_cancelled;
+		}
+	}
+	EXPECT_EQ(5U, timings.size());
+	EXPECT_EQ(1U, num_cancelled);
+
+	rl.NumLoadingThreads(num_threads);
+}
+
+TEST(ResLoaderTest, SyncWhileLoading)
+{
+	ResLoader& rl = ResLoader::Instance();
+
+	std::vector<std::string> order;
+	std::mutex order_mutex;
+	std::atomic<bool> release(false);
+
+	// Gives the loading thread time to start it, so the sync query finds it running and has to wait for it. If it's
+	//  still queued, the sync query takes it over. Either way the sub thread stage runs once.
+	auto async_res = rl.ASyncQueryT<int>(MakeSharedPtr<OrderLoadingDesc>("block_sync", order, order_mutex, release), 100);
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+	std::thread releaser([&release]
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			release = true;
+		});
+	auto sync_res = rl.SyncQueryT<int>(MakeSharedPtr<OrderLoadingDesc>("block_sync", order, order_mutex, release));
+	releaser.join();
+
+	EXPECT_EQ(1, *sync_res);
+	{
+		std::lock_guard<std::mutex> lock(order_mutex);
+		EXPECT_EQ(1U, order.size());
+	}
+
+	while (!*async_res)
+	{
+		rl.Update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	rl.Update();
+}
+
+TEST(ResLoaderTest, ConcurrentStages)
+{
+	ResLoader& rl = ResLoader::Instance();
+	uint32_t const num_threads = rl.NumLoadingThreads();
+	rl.NumLoadingThreads(2);
+
+	std::vector<std::string> order;
+	std::mutex order_mutex;
+	std::atomic<bool> release(false);
+
+	// While one thread is blocked in "block", "serial" has to wait for it because they are of the same type. The
+	//  other thread skips it and runs "concurrent".
+	auto block = rl.ASyncQueryT<int>(MakeSharedPtr<OrderLoadingDesc>("block_serial", order, order_mutex, release), 100);
+	auto serial = rl.ASyncQueryT<int>(MakeSharedPtr<OrderLoadingDesc>("serial", order, order_mutex, release), 50);
+	auto concurrent = rl.ASyncQueryT<int>(MakeSharedPtr<OrderLoadingDesc>("concurrent", order, order_mutex, release,
+		true), 10);
+
+	for (int i = 0; i < 5000; ++ i)
+	{
+		{
+			std::lock_guard<std::mutex> lock(order_mutex);
+			if (!order.empty())
+			{
+				break;
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	{
+		std::lock_guard<std::mutex> lock(order_mutex);
+		EXPECT_EQ(1U, order.size());
+		EXPECT_EQ("concurrent", order.empty() ? "" : order[0]);
+	}
+
+	release = true;
+	while (!*block || !*serial || !*concurrent)
+	{
+		rl.Update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	ASSERT_EQ(3U, order.size());
+	EXPECT_EQ("block_serial", order[1]);
+	EXPECT_EQ("serial", order[2]);
+
+	rl.NumLoadingThreads(num_threads);
+}
@@ -1,16 +1,63 @@
 #include <KlayGE/KlayGE.hpp>
 #include <KFL/Math.hpp>
 #include <KFL/SIMDMath.hpp>
+#include <KFL/AlignedAllocator.hpp>
 
 #include <gtest/gtest.h>
 
 #include <vector>
 #include <string>
 #include <iostream>
+#include <random>
 
 using namespace std;
 using namespace KlayGE;
 
+namespace
+{
+	char const * BATCH_TARGET_NAMES[] = { "Scalar", "SSE", "AVX2" };
+
+	// Runs func once for every batch target the CPU supports
+	template <typename F>
+	void ForEachBatchTarget(F const & func)
+	{
+		SIMDMathLib::BatchTarget const old_target = SIMDMathLib::ActiveBatchTarget();
+		for (int t = SIMDMathLib::BT_Scalar; t <= SIMDMathLib::BT_AVX2; ++ t)
+		{
+			SIMDMathLib::BatchTarget const target = static_cast<SIMDMathLib::BatchTarget>(t);
+			if (SIMDMathLib::IsBatchTargetSupported(target))
+			{
+				SCOPED_TRACE(BATCH_TARGET_NAMES[t]);
+				SIMDMathLib::ActiveBatchTarget(target);
+				func(target);
+			}
+		}
+		SIMDMathLib::ActiveBatchTarget(old_target);
+	}
+
+	float4x4 RandomTransform(std::ranlux24_base& gen)
+	{
+		std::uniform_real_distribution<float> dist(-1, 1);
+		float3 const scale(1 + dist(gen) * 0.5f, 1 + dist(gen) * 0.5f, 1 + dist(gen) * 0.5f);
+		Quaternion const rot = MathLib::normalize(Quaternion(dist(gen), dist(gen), dist(gen), dist(gen) + 2));
+		float3 const trans(dist(gen) * 10, dist(gen) * 10, dist(gen) * 10);
+		return MathLib::scaling(scale) * MathLib::to_matrix(rot) * MathLib::translation(trans);
+	}
+
+	Quaternion RandomQuat(std::ranlux24_base& gen)
+	{
+		std::uniform_real_distribution<float> dist(-1, 1);
+		return MathLib::normalize(Quaternion(dist(gen), dist(gen), dist(gen), dist(gen)));
+	}
+
+	AABBox RandomAABB(std::ranlux24_base& gen)
+	{
+		std::uniform_real_distribution<float> dist(-10, 10);
+		float3 const min_pt(dist(gen), dist(gen), dist(gen));
+		return AABBox(min_pt, min_pt + float3(MathLib::abs(dist(gen)), MathLib::abs(dist(gen)), MathLib::abs(dist(gen))));
+	}
+}
+
 TEST(SIMDMathTest, NormalizeVector2)
 {
 	SIMDVectorF4 v = SIMDMathLib::SetVector(1, 2, 0, 0);
@@ -31,3 +78,238 @@ TEST(SIMDMathTest, NormalizeVector4)
 	v = SIMDMathLib::NormalizeVector4(v);
 	EXPECT_LT(MathLib::abs(SIMDMathLib::GetX(SIMDMathLib::LengthVector4(v)) - 1.0f), 1e-3f);
 }
+
+TEST(SIMDMathTest, IntersectAABBFrustum)
+{
+	float4x4 const view_proj = MathLib::look_at_lh(float3(0, 0, 0), float3(0, 0, 1))
+		* MathLib::perspective_fov_lh(PI / 4, 1.0f, 0.1f, 100.0f);
+	Frustum frustum;
+	frustum.ClipMatrix(view_proj, MathLib::inverse(view_proj));
+
+	// Not a multiple of 4, to cover the tail
+	uint32_t const NUM_BOXES = 1023;
+	std::vector<float, aligned_allocator<float, 16>> soa[6];
+	for (auto& arr : soa)
+	{
+		arr.resize((NUM_BOXES + 3) & ~3U, 0.0f);
+	}
+	std::vector<AABBox> boxes;
+	for (uint32_t i = 0; i < NUM_BOXES; ++ i)
+	{
+		float3 const min_pt(MathLib::sin(i * 0.37f) * 60, MathLib::cos(i * 0.23f) * 60, MathLib::sin(i * 0.11f) * 60 + 50);
+		float3 const max_pt = min_pt + float3(static_cast<float>(i % 7), static_cast<float>(i % 5), static_cast<float>(i % 3));
+		boxes.emplace_back(min_pt, max_pt);
+
+		soa[0][i] = min_pt.x();
+		soa[1][i] = min_pt.y();
+		soa[2][i] = min_pt.z();
+		soa[3][i] = max_pt.x();
+		soa[4][i] = max_pt.y();
+		soa[5][i] = max_pt.z();
+	}
+
+	std::vector<BoundOverlap> results(NUM_BOXES);
+	SIMDMathLib::IntersectAABBFrustum(&results[0], &soa[0][0], &soa[1][0], &soa[2][0], &soa[3][0], &soa[4][0], &soa[5][0],
+		NUM_BOXES, frustum);
+
+	for (uint32_t i = 0; i < NUM_BOXES; ++ i)
+	{
+		EXPECT_EQ(frustum.Intersect(boxes[i]), results[i]);
+	}
+}
+
+// Not multiples of 8, to cover the tails
+TEST(SIMDMathTest, TransformCoords)
+{
+	std::ranlux24_base gen(1);
+	std::uniform_real_distribution<float> dist(-100, 100);
+
+	uint32_t const NUM = 1027;
+	std::vector<float3> points(NUM);
+	for (auto& pt : points)
+	{
+		pt = float3(dist(gen), dist(gen), dist(gen));
+	}
+	float4x4 const affine = RandomTransform(gen);
+	float4x4 const proj = MathLib::perspective_fov_lh(PI / 4, 1.0f, 0.1f, 100.0f);
+	// w is 0 for the first point
+	points[0] = float3(1, 2, 0);
+
+	ForEachBatchTarget([&](SIMDMathLib::BatchTarget target)
+		{
+			KFL_UNUSED(target);
+
+			for (auto const & mat : { affine, proj })
+			{
+				std::vector<float3> results(NUM);
+				SIMDMathLib::TransformCoords(&results[0], &points[0], NUM, mat);
+				for (uint32_t i = 0; i < NUM; ++ i)
+				{
+					float3 const expected = MathLib::transform_coord(points[i], mat);
+					for (int c = 0; c < 3; ++ c)
+					{
+						EXPECT_NEAR(results[i][c], expected[c], 1e-4f * std::max(1.0f, MathLib::abs(expected[c]))) << i;
+					}
+				}
+			}
+
+			// In place
+			std::vector<float3> in_place = points;
+			SIMDMathLib::TransformCoords(&in_place[0], &in_place[0], NUM, affine);
+			for (uint32_t i = 0; i < NUM; ++ i)
+			{
+				EXPECT_NEAR(in_place[i].x(), MathLib::transform_coord(points[i], affine).x(), 1e-2f) << i;
+			}
+		});
+}
+
+TEST(SIMDMathTest, TransformAABBs)
+{
+	std::ranlux24_base gen(2);
+
+	uint32_t const NUM = 1029;
+	std::vector<AABBox> boxes(NUM);
+	for (auto& box : boxes)
+	{
+		box = RandomAABB(gen);
+	}
+	// Non-uniform scaling then rotation, which MathLib::transform_aabb can't represent
+	float4x4 const mat = RandomTransform(gen) * RandomTransform(gen);
+
+	ForEachBatchTarget([&](SIMDMathLib::BatchTarget target)
+		{
+			KFL_UNUSED(target);
+
+			std::vector<AABBox> results(NUM);
+			SIMDMathLib::TransformAABBs(&results[0], &boxes[0], NUM, mat);
+			for (uint32_t i = 0; i < NUM; ++ i)
+			{
+				float3 min_pt = MathLib::transform_coord(boxes[i].Corner(0), mat);
+				float3 max_pt = min_pt;
+				for (size_t j = 1; j < 8; ++ j)
+				{
+					float3 const v = MathLib::transform_coord(boxes[i].Corner(j), mat);
+					min_pt = MathLib::minimize(min_pt, v);
+					max_pt = MathLib::maximize(max_pt, v);
+				}
+				for (int c = 0; c < 3; ++ c)
+				{
+					EXPECT_NEAR(results[i].Min()[c], min_pt[c], 1e-3f) << i;
+					EXPECT_NEAR(results[i].Max()[c], max_pt[c], 1e-3f) << i;
+				}
+			}
+		});
+}
+
+TEST(SIMDMathTest, MultiplyQuats)
+{
+	std::ranlux24_base gen(3);
+
+	uint32_t const NUM = 1030;
+	std::vector<Quaternion> lhs(NUM);
+	std::vector<Quaternion> rhs(NUM);
+	for (uint32_t i = 0; i < NUM; ++ i)
+	{
+		lhs[i] = RandomQuat(gen);
+		rhs[i] = RandomQuat(gen);
+	}
+
+	ForEachBatchTarget([&](SIMDMathLib::BatchTarget target)
+		{
+			KFL_UNUSED(target);
+
+			std::vector<Quaternion> results(NUM);
+			SIMDMathLib::MultiplyQuats(&results[0], &lhs[0], &rhs[0], NUM);
+			for (uint32_t i = 0; i < NUM; ++ i)
+			{
+				Quaternion const expected = MathLib::mul(lhs[i], rhs[i]);
+				for (int c = 0; c < 4; ++ c)
+				{
+					EXPECT_NEAR(results[i][c], expected[c], 1e-6f) << i;
+				}
+			}
+		});
+}
+
+TEST(SIMDMathTest, SlerpQuats)
+{
+	std::ranlux24_base gen(4);
+	std::uniform_real_distribution<float> dist(0, 1);
+
+	uint32_t const NUM = 1031;
+	std::vector<Quaternion> lhs(NUM);
+	std::vector<Quaternion> rhs(NUM);
+	std::vector<float> s(NUM);
+	for (uint32_t i = 0; i < NUM; ++ i)
+	{
+		lhs[i] = RandomQuat(gen);
+		rhs[i] = RandomQuat(gen);
+		s[i] = dist(gen);
+	}
+	// Equal, nearly equal, and opposite
+	rhs[1] = lhs[1];
+	rhs[2] = MathLib::normalize(lhs[2] + Quaternion(1e-4f, 0, 0, 0));
+	rhs[3] = -lhs[3];
+	s[4] = 0;
+	s[5] = 1;
+
+	ForEachBatchTarget([&](SIMDMathLib::BatchTarget target)
+		{
+			KFL_UNUSED(target);
+
+			std::vector<Quaternion> results(NUM);
+			SIMDMathLib::SlerpQuats(&results[0], &lhs[0], &rhs[0], &s[0], NUM);
+			for (uint32_t i = 0; i < NUM; ++ i)
+			{
+				Quaternion const expected = MathLib::slerp(lhs[i], rhs[i], s[i]);
+				for (int c = 0; c < 4; ++ c)
+				{
+					EXPECT_NEAR(results[i][c], expected[c], 1e-5f) << i;
+				}
+			}
+		});
+}
+
+TEST(SIMDMathTest, IntersectAABBFrustumTargets)
+{
+	std::ranlux24_base gen(5);
+	std::uniform_real_distribution<float> dist(-60, 60);
+
+	float4x4 const view_proj = MathLib::look_at_lh(float3(0, 0, 0), float3(1, 0, 1))
+		* MathLib::perspective_fov_lh(PI / 3, 1.5f, 0.1f, 50.0f);
+	Frustum frustum;
+	frustum.ClipMatrix(view_proj, MathLib::inverse(view_proj));
+
+	uint32_t const NUM_BOXES = 1021;
+	std::vector<float, aligned_allocator<float, 16>> soa[6];
+	for (auto& arr : soa)
+	{
+		arr.resize((NUM_BOXES + 3) & ~3U, 0.0f);
+	}
+	std::vector<AABBox> boxes;
+	for (uint32_t i = 0; i < NUM_BOXES; ++ i)
+	{
+		float3 const min_pt(dist(gen), dist(gen) * 0.2f, dist(gen));
+		float3 const max_pt = min_pt + float3(MathLib::abs(dist(gen)) * 0.1f, MathLib::abs(dist(gen)) * 0.1f,
+			MathLib::abs(dist(gen)) * 0.1f);
+		boxes.emplace_back(min_pt, max_pt);
+		for (int c = 0; c < 3; ++ c)
+		{
+			soa[c][i] = min_pt[c];
+			soa[3 + c][i] = max_pt[c];
+		}
+	}
+
+	ForEachBatchTarget([&](SIMDMathLib::BatchTarget target)
+		{
+			KFL_UNUSED(target);
+
+			std::vector<BoundOverlap> results(NUM_BOXES);
+			SIMDMathLib::IntersectAABBFrustum(&results[0], &soa[0][0], &soa[1][0], &soa[2][0], &soa[3][0], &soa[4][0], &soa[5][0],
+				NUM_BOXES, frustum);
+			for (uint32_t i = 0; i < NUM_BOXES; ++ i)
+			{
+				EXPECT_EQ(frustum.Intersect(boxes[i]), results[i]) << i;
+			}
+		});
+}
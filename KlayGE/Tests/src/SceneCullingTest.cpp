@@ -0,0 +1,201 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Math.hpp>
+#include <KFL/Timer.hpp>
+#include <KlayGE/App3D.hpp>
+#include <KlayGE/Camera.hpp>
+#include <KlayGE/Context.hpp>
+#include <KlayGE/RenderableHelper.hpp>
+#include <KlayGE/SceneManager.hpp>
+#include <KlayGE/SceneObjectHelper.hpp>
+
+#include <gtest/gtest.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	class SceneCullingTestApp : public App3DFramework
+	{
+	public:
+		SceneCullingTestApp()
+			: App3DFramework("SceneCullingTest")
+		{
+		}
+
+		virtual void DoUpdateOverlay() override
+		{
+		}
+
+		virtual uint32_t DoUpdate(uint32_t pass) override
+		{
+			KFL_UNUSED(pass);
+			return URV_NeedFlush | URV_Finished;
+		}
+	};
+
+	std::shared_ptr<App3DFramework> CreateCullingTestApp()
+	{
+		Context::Instance().LoadCfg("KlayGE.cfg");
+		ContextCfg context_cfg = Context::Instance().Config();
+		if (!Context::Instance().RenderFactoryValid())
+		{
+			context_cfg.render_factory_name = "NullRender";
+		}
+		if (!Context::Instance().SceneManagerValid())
+		{
+			context_cfg.scene_manager_name = "OCTree";
+		}
+		context_cfg.deferred_rendering = false;
+		context_cfg.graphics_cfg.hide_win = true;
+		context_cfg.graphics_cfg.hdr = false;
+		context_cfg.graphics_cfg.color_grading = false;
+		context_cfg.graphics_cfg.gamma = false;
+		Context::Instance().Config(context_cfg);
+
+		auto app = MakeSharedPtr<SceneCullingTestApp>();
+		app->Create();
+
+		app->ActiveCamera().ViewParams(float3(0, 0, -20), float3(0, 0, 0));
+		app->ActiveCamera().ProjParams(PI / 4, 1, 1, 200);
+
+		return app;
+	}
+
+	// A grid_size^3 grid of boxes around the origin, half static, half moveable
+	void AddBoxGrid(uint32_t grid_size)
+	{
+		RenderablePtr box = MakeSharedPtr<RenderableTriBox>(
+			MathLib::convert_to_obbox(AABBox(float3(-0.5f, -0.5f, -0.5f), float3(+0.5f, +0.5f, +0.5f))), Color(1, 1, 1, 1));
+
+		for (uint32_t z = 0; z < grid_size; ++ z)
+		{
+			for (uint32_t y = 0; y < grid_size; ++ y)
+			{
+				for (uint32_t x = 0; x < grid_size; ++ x)
+				{
+					uint32_t const attrib = SceneObject::SOA_Cullable | (((x + y + z) & 1) ? SceneObject::SOA_Moveable : 0);
+					auto so = MakeSharedPtr<SceneObjectHelper>(box, attrib);
+					so->ModelMatrix(MathLib::translation(float3(x * 2.0f, y * 2.0f, z * 2.0f) - float3(grid_size * 1.0f)));
+					so->AddToSceneManager();
+				}
+			}
+		}
+	}
+
+	// Moveable objects drift around, some of them out of their nodes and some out of the tree
+	void MoveObjects(SceneManager& sm, uint32_t iteration)
+	{
+		float const offset = (iteration + 1) * 0.75f;
+		for (uint32_t j = 0; j < sm.NumSceneObjects(); ++ j)
+		{
+			auto const & so = sm.GetSceneObject(j);
+			if (so->Attrib() & SceneObject::SOA_Moveable)
+			{
+				so->ModelMatrix(so->ModelMatrix() * MathLib::translation(offset * ((j & 1) ? 1 : -1), offset * 0.5f, 0.0f));
+			}
+
+			// As Flush does, the tree doesn't touch objects in culled nodes
+			so->VisibleMark(BO_No);
+		}
+	}
+
+	void CheckVisibility(SceneManager& sm, Frustum const & frustum)
+	{
+		for (uint32_t i = 0; i < sm.NumSceneObjects(); ++ i)
+		{
+			auto const & so = sm.GetSceneObject(i);
+			EXPECT_EQ(MathLib::intersect_aabb_frustum(so->PosBoundWS(), frustum) != BO_No, so->VisibleMark() != BO_No)
+				<< "object " << i;
+		}
+	}
+}
+
+// If it runs first, NullRender is picked when the config has no render factory
+TEST(SceneCullingTest, Culling)
+{
+	auto app = CreateCullingTestApp();
+
+	// Some boxes on the far side are out of the frustum, some close ones are culled by the sides
+	uint32_t const GRID_SIZE = 12;
+	AddBoxGrid(GRID_SIZE);
+
+	SceneManager& sm = Context::Instance().SceneManagerInstance();
+	uint32_t const num_objs = sm.NumSceneObjects();
+	EXPECT_EQ(GRID_SIZE * GRID_SIZE * GRID_SIZE, num_objs);
+
+	// The first frame builds the tree and sets up the frustum
+	sm.Update();
+	sm.ClipScene();
+
+	uint32_t num_visible = 0;
+	for (uint32_t i = 0; i < num_objs; ++ i)
+	{
+		if (sm.GetSceneObject(i)->VisibleMark() != BO_No)
+		{
+			++ num_visible;
+		}
+	}
+	EXPECT_GT(num_visible, 0U);
+	EXPECT_LT(num_visible, num_objs);
+
+	Frustum const & frustum = app->ActiveCamera().ViewFrustum();
+	CheckVisibility(sm, frustum);
+
+	for (uint32_t i = 0; i < 8; ++ i)
+	{
+		MoveObjects(sm, i);
+		sm.ClipScene();
+	}
+	CheckVisibility(sm, frustum);
+
+	sm.ClearObject();
+}
+
+// Run it alone (--gtest_filter=SceneCullingTest.*), so NullRender can be picked before any other test loads a render factory.
+TEST(SceneCullingTest, DISABLED_Benchmark)
+{
+	auto app = CreateCullingTestApp();
+
+	uint32_t const GRID_SIZE = 40;
+	AddBoxGrid(GRID_SIZE);
+
+	SceneManager& sm = Context::Instance().SceneManagerInstance();
+	uint32_t const num_objs = sm.NumSceneObjects();
+
+	sm.Update();
+
+	uint32_t const NUM_ITERATIONS = 20;
+	Timer timer;
+	for (uint32_t i = 0; i < NUM_ITERATIONS; ++ i)
+	{
+		sm.ClipScene();
+	}
+	double const ms = timer.elapsed() * 1000;
+
+	uint32_t num_visible = 0;
+	for (uint32_t i = 0; i < num_objs; ++ i)
+	{
+		if (sm.GetSceneObject(i)->VisibleMark() != BO_No)
+		{
+			++ num_visible;
+		}
+	}
+
+	cout << num_objs << " objects, " << num_visible << " visible, "
+		<< num_objs * NUM_ITERATIONS / ms << " objects culled per ms" << endl;
+
+	timer.restart();
+	for (uint32_t i = 0; i < NUM_ITERATIONS; ++ i)
+	{
+		MoveObjects(sm, i);
+		sm.ClipScene();
+	}
+	double const moving_ms = timer.elapsed() * 1000;
+
+	cout << num_objs * NUM_ITERATIONS / moving_ms << " objects culled per ms with moveable objects moving" << endl;
+
+	sm.ClearObject();
+}
@@ -0,0 +1,150 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/CXX17/filesystem.hpp>
+#include <KlayGE/ShaderCache.hpp>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace KlayGE;
+
+#if KLAYGE_IS_DEV_PLATFORM
+
+namespace
+{
+	std::string const CACHE_FOLDER = "ShaderCacheTest/";
+
+	ShaderCompileRequest MakeRequest(uint32_t num_macros)
+	{
+		ShaderCompileRequest request;
+		request.type = ShaderObject::ST_PixelShader;
+		request.func_name = "MainPS";
+		request.profile = "ps_5_0";
+		request.flags = 0x800;
+		for (uint32_t i = 0; i < num_macros; ++ i)
+		{
+			request.macros.emplace_back("MACRO_" + std::to_string(i), std::to_string(i * 3));
+		}
+		return request;
+	}
+
+	std::vector<uint8_t> MakeCode(uint8_t seed)
+	{
+		std::vector<uint8_t> code(1000);
+		for (size_t i = 0; i < code.size(); ++ i)
+		{
+			code[i] = static_cast<uint8_t>(seed + i * 7);
+		}
+		return code;
+	}
+
+	class ShaderCacheTest : public testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			std::filesystem::remove_all(CACHE_FOLDER);
+		}
+
+		void TearDown() override
+		{
+			std::filesystem::remove_all(CACHE_FOLDER);
+		}
+	};
+}
+
+TEST_F(ShaderCacheTest, WriteReadMiss)
+{
+	uint64_t const HLSL_HASH = 0x0123456789ABCDEFULL;
+	ShaderCompileRequest const request = MakeRequest(8);
+	std::vector<uint8_t> const code = MakeCode(1);
+
+	{
+		ShaderCache cache(CACHE_FOLDER, "compiler 1");
+		std::vector<uint8_t> found;
+		EXPECT_FALSE(cache.Find(HLSL_HASH, request, found));
+
+		cache.Add(HLSL_HASH, request, code);
+		EXPECT_TRUE(cache.Contains(HLSL_HASH, request));
+		ASSERT_TRUE(cache.Find(HLSL_HASH, request, found));
+		EXPECT_TRUE(found == code);
+	}
+
+	// From the files
+	ShaderCache cache(CACHE_FOLDER, "compiler 1");
+	std::vector<uint8_t> found;
+	ASSERT_TRUE(cache.Find(HLSL_HASH, request, found));
+	EXPECT_TRUE(found == code);
+
+	// Any change to the inputs misses
+	EXPECT_FALSE(cache.Find(HLSL_HASH + 1, request, found));
+	ShaderCompileRequest other = request;
+	other.macros.back().second += "1";
+	EXPECT_FALSE(cache.Find(HLSL_HASH, other, found));
+	other = request;
+	other.flags ^= 1;
+	EXPECT_FALSE(cache.Contains(HLSL_HASH, other));
+
+	ShaderCache new_compiler(CACHE_FOLDER, "compiler 2");
+	EXPECT_FALSE(new_compiler.Find(HLSL_HASH, request, found));
+}
+
+TEST_F(ShaderCacheTest, ManyMacros)
+{
+	uint64_t const HLSL_HASH = 42;
+	ShaderCompileRequest const request = MakeRequest(300);
+	uint64_t const MANIFEST_KEY = 7;
+
+	{
+		ShaderCache cache(CACHE_FOLDER, "compiler");
+		cache.Add(HLSL_HASH, request, MakeCode(2));
+		cache.Record(MANIFEST_KEY, HLSL_HASH, request);
+		cache.Record(MANIFEST_KEY, HLSL_HASH, request);
+		cache.SaveManifest(MANIFEST_KEY);
+	}
+
+	ShaderCache cache(CACHE_FOLDER, "compiler");
+	EXPECT_TRUE(cache.Contains(HLSL_HASH, request));
+	std::vector<ShaderCompileRequest> const requests = cache.LoadManifest(MANIFEST_KEY);
+	ASSERT_EQ(requests.size(), 1U);
+	EXPECT_TRUE(requests[0] == request);
+}
+
+TEST_F(ShaderCacheTest, Compaction)
+{
+	ShaderCompileRequest const request = MakeRequest(4);
+
+	{
+		ShaderCache cache(CACHE_FOLDER, "compiler");
+		for (uint8_t i = 0; i < 10; ++ i)
+		{
+			cache.Add(1, request, MakeCode(i));
+		}
+		cache.Add(2, request, MakeCode(100));
+		EXPECT_EQ(cache.NumEntries(), 2U);
+	}
+	uintmax_t const appended_size = std::filesystem::file_size(CACHE_FOLDER + "index.bin");
+
+	// The index has one record per entry again, and the blobs of the replaced entries are gone
+	ShaderCache cache(CACHE_FOLDER, "compiler");
+	EXPECT_EQ(cache.NumEntries(), 2U);
+	EXPECT_LT(std::filesystem::file_size(CACHE_FOLDER + "index.bin") * 4, appended_size);
+
+	uint32_t num_blobs = 0;
+	for (std::filesystem::directory_iterator iter(CACHE_FOLDER), end; iter != end; ++ iter)
+	{
+		if (iter->path().extension() == ".dxbc")
+		{
+			++ num_blobs;
+		}
+	}
+	EXPECT_EQ(num_blobs, 2U);
+
+	std::vector<uint8_t> found;
+	ASSERT_TRUE(cache.Find(1, request, found));
+	EXPECT_TRUE(found == MakeCode(9));
+}
+
+#endif
@@ -0,0 +1,187 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KlayGE/Mesh.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	uint32_t const NUM_FRAMES = 48;
+
+	// A random skeleton. Adjacent keys are a few degrees apart, like in a sampled animation.
+	void MakeSkeleton(uint32_t num_joints, uint32_t seed, std::vector<Joint>& joints, KeyFramesType& kfs)
+	{
+		std::ranlux24_base gen(seed);
+		std::uniform_real_distribution<float> dist(-1, 1);
+
+		joints.resize(num_joints);
+		kfs.resize(num_joints);
+		for (uint32_t i = 0; i < num_joints; ++ i)
+		{
+			Joint& joint = joints[i];
+			joint.name = "joint" + std::to_string(i);
+			joint.parent = (0 == i) ? -1 : static_cast<int16_t>(gen() % i);
+
+			Quaternion const origin_rot = MathLib::rotation_axis(float3(dist(gen), dist(gen), 2 + dist(gen)), dist(gen) * 3);
+			joint.inverse_origin_real = origin_rot;
+			joint.inverse_origin_dual = MathLib::quat_trans_to_udq(origin_rot, float3(dist(gen), dist(gen), dist(gen)));
+			joint.inverse_origin_scale = 1;
+			joint.bind_real = Quaternion::Identity();
+			joint.bind_dual = Quaternion(0, 0, 0, 0);
+			joint.bind_scale = 1;
+
+			KeyFrames& kf = kfs[i];
+			uint32_t const num_keys = (0 == i % 7) ? 1 : 2 + gen() % 10;
+			float3 const axis(dist(gen), 2 + dist(gen), dist(gen));
+			float const angle = dist(gen) * 3;
+			float3 const trans(dist(gen), dist(gen), dist(gen));
+			for (uint32_t k = 0; k < num_keys; ++ k)
+			{
+				Quaternion const rot = MathLib::rotation_axis(axis, angle + k * 0.1f);
+				kf.frame_id.push_back(k * NUM_FRAMES / num_keys);
+				kf.bind_real.push_back(rot);
+				kf.bind_dual.push_back(MathLib::quat_trans_to_udq(rot, trans + float3(0.05f, 0, -0.05f) * static_cast<float>(k)));
+				kf.bind_scale.push_back(1 + 0.1f * dist(gen));
+			}
+		}
+	}
+
+	SkinnedModelPtr MakeModel(std::vector<Joint> const & joints, std::shared_ptr<KeyFramesType> const & kfs)
+	{
+		SkinnedModelPtr model = MakeSharedPtr<SkinnedModel>(L"SkinnedAnimationTest");
+		model->AssignJoints(joints.begin(), joints.end());
+		model->AttachKeyFrames(kfs);
+		model->NumFrames(NUM_FRAMES);
+		model->FrameRate(30);
+		return model;
+	}
+
+	// The straightforward per-joint evaluation with sclerp, for models without mirroring
+	void ReferenceBinds(std::vector<Joint> joints, KeyFramesType const & kfs, float frame,
+		std::vector<float4>& bind_reals, std::vector<float4>& bind_duals)
+	{
+		for (size_t i = 0; i < joints.size(); ++ i)
+		{
+			Joint& joint = joints[i];
+			std::pair<std::pair<Quaternion, Quaternion>, float> key_dq = kfs[i].Frame(frame);
+
+			if (joint.parent != -1)
+			{
+				Joint const & parent = joints[joint.parent];
+				if (MathLib::dot(key_dq.first.first, parent.bind_real) < 0)
+				{
+					key_dq.first.first = -key_dq.first.first;
+					key_dq.first.second = -key_dq.first.second;
+				}
+
+				joint.bind_real = MathLib::mul_real(key_dq.first.first, parent.bind_real);
+				joint.bind_dual = MathLib::mul_dual(key_dq.first.first, key_dq.first.second * parent.bind_scale,
+					parent.bind_real, parent.bind_dual);
+				joint.bind_scale = key_dq.second * parent.bind_scale;
+			}
+			else
+			{
+				joint.bind_real = key_dq.first.first;
+				joint.bind_dual = key_dq.first.second;
+				joint.bind_scale = key_dq.second;
+			}
+		}
+
+		bind_reals.resize(joints.size());
+		bind_duals.resize(joints.size());
+		for (size_t i = 0; i < joints.size(); ++ i)
+		{
+			Joint const & joint = joints[i];
+
+			Quaternion bind_real = MathLib::mul_real(joint.inverse_origin_real, joint.bind_real);
+			Quaternion bind_dual = MathLib::mul_dual(joint.inverse_origin_real, joint.inverse_origin_dual,
+				joint.bind_real, joint.bind_dual);
+			float const bind_scale = joint.inverse_origin_scale * joint.bind_scale;
+			if (bind_real.w() < 0)
+			{
+				bind_real = -bind_real;
+				bind_dual = -bind_dual;
+			}
+
+			bind_reals[i] = float4(bind_real.x(), bind_real.y(), bind_real.z(), bind_real.w()) * bind_scale;
+			bind_duals[i] = float4(bind_dual.x(), bind_dual.y(), bind_dual.z(), bind_dual.w());
+		}
+	}
+
+	float MaxDiff(std::vector<float4> const & lhs, std::vector<float4> const & rhs)
+	{
+		float ret = 0;
+		for (size_t i = 0; i < lhs.size(); ++ i)
+		{
+			for (size_t c = 0; c < 4; ++ c)
+			{
+				ret = std::max(ret, MathLib::abs(lhs[i][c] - rhs[i][c]));
+			}
+		}
+		return ret;
+	}
+}
+
+TEST(SkinnedAnimationTest, MatchesSclerp)
+{
+	std::vector<Joint> joints;
+	auto kfs = MakeSharedPtr<KeyFramesType>();
+	MakeSkeleton(37, 1, joints, *kfs);
+	SkinnedModelPtr model = MakeModel(joints, kfs);
+
+	// Forward steps, a wrap around, and jumps back and forth
+	float const frames[] = { 0, 0.5f, 1.25f, 7.9f, 8, 30.5f, 3.3f, NUM_FRAMES - 0.5f, NUM_FRAMES + 2.7f, 100, 47, 12.6f };
+	for (float frame : frames)
+	{
+		model->SetFrame(frame);
+
+		std::vector<float4> ref_reals, ref_duals;
+		ReferenceBinds(joints, *kfs, frame, ref_reals, ref_duals);
+
+		EXPECT_LT(MaxDiff(model->GetBindRealParts(), ref_reals), 1e-2f) << "frame " << frame;
+		EXPECT_LT(MaxDiff(model->GetBindDualParts(), ref_duals), 1e-2f) << "frame " << frame;
+	}
+}
+
+TEST(SkinnedAnimationTest, SetFramesMatchesSetFrame)
+{
+	uint32_t const NUM_MODELS = 19;
+
+	std::vector<SkinnedModelPtr> serial_models;
+	std::vector<SkinnedModelPtr> parallel_models;
+	std::vector<SkinnedModel*> models;
+	std::vector<float> frames;
+	for (uint32_t i = 0; i < NUM_MODELS; ++ i)
+	{
+		std::vector<Joint> joints;
+		auto kfs = MakeSharedPtr<KeyFramesType>();
+		MakeSkeleton(5 + i * 3, i + 2, joints, *kfs);
+
+		serial_models.push_back(MakeModel(joints, kfs));
+		parallel_models.push_back(MakeModel(joints, kfs));
+		models.push_back(parallel_models.back().get());
+		frames.push_back(i * 2.3f);
+	}
+
+	for (int step = 0; step < 3; ++ step)
+	{
+		for (uint32_t i = 0; i < NUM_MODELS; ++ i)
+		{
+			frames[i] += 0.75f;
+			serial_models[i]->SetFrame(frames[i]);
+		}
+		SkinnedModel::SetFrames(models, frames);
+
+		for (uint32_t i = 0; i < NUM_MODELS; ++ i)
+		{
+			EXPECT_TRUE(serial_models[i]->GetBindRealParts() == parallel_models[i]->GetBindRealParts());
+			EXPECT_TRUE(serial_models[i]->GetBindDualParts() == parallel_models[i]->GetBindDualParts());
+		}
+	}
+}
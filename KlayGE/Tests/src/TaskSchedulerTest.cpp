@@ -0,0 +1,104 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Thread.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+using namespace KlayGE;
+
+TEST(TaskSchedulerTest, ParallelFor)
+{
+	task_scheduler scheduler(4);
+
+	std::vector<uint32_t> values(100000, 0);
+	scheduler.parallel_for(0, static_cast<uint32_t>(values.size()), 0,
+		[&values](uint32_t first, uint32_t last)
+		{
+			for (uint32_t i = first; i < last; ++ i)
+			{
+				values[i] = i * 2;
+			}
+		});
+
+	for (uint32_t i = 0; i < values.size(); ++ i)
+	{
+		EXPECT_EQ(i * 2, values[i]);
+	}
+}
+
+TEST(TaskSchedulerTest, NestedGroups)
+{
+	task_scheduler scheduler(4);
+
+	std::atomic<uint32_t> counter(0);
+	std::atomic<uint32_t> seen_by_continuation(0);
+	std::atomic<bool> continuation_done(false);
+	{
+		task_group group(scheduler);
+		for (uint32_t i = 0; i < 64; ++ i)
+		{
+			group.run([&scheduler, &counter]
+				{
+					scheduler.parallel_for(0, 100, 1,
+						[&counter](uint32_t first, uint32_t last)
+						{
+							counter += last - first;
+						});
+				});
+		}
+		group.then([&counter, &seen_by_continuation, &continuation_done]
+			{
+				seen_by_continuation = counter.load();
+				continuation_done = true;
+			});
+		group.wait();
+	}
+
+	EXPECT_EQ(6400U, counter.load());
+	while (!continuation_done)
+	{
+		std::this_thread::yield();
+	}
+	EXPECT_EQ(6400U, seen_by_continuation.load());
+}
+
+// The group is gone as soon as wait returns, while the continuations may still be spawned from a worker
+TEST(TaskSchedulerTest, ShortLivedGroups)
+{
+	task_scheduler scheduler(4);
+
+	std::atomic<uint32_t> num_continuations(0);
+	for (uint32_t i = 0; i < 2000; ++ i)
+	{
+		auto group = MakeUniquePtr<task_group>(scheduler);
+		group->run([]
+			{
+			});
+		group->then([&num_continuations]
+			{
+				++ num_continuations;
+			});
+		group->wait();
+	}
+
+	while (num_continuations != 2000)
+	{
+		std::this_thread::yield();
+	}
+}
+
+TEST(TaskSchedulerTest, Exception)
+{
+	task_scheduler scheduler(2);
+
+	task_group group(scheduler);
+	group.run([]
+		{
+			throw std::runtime_error("task");
+		});
+	EXPECT_THROW(group.wait(), std::runtime_error);
+}
@@ -0,0 +1,208 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Timer.hpp>
+#include <KlayGE/TexCompressionBC.hpp>
+#include <KlayGE/TexCompressionETC.hpp>
+
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	struct CodecEntry
+	{
+		char const * name;
+		TexCompressionPtr codec;
+	};
+
+	std::vector<CodecEntry> MakeCodecs()
+	{
+		return std::vector<CodecEntry>
+		{
+			{ "BC1", MakeSharedPtr<TexCompressionBC1>() },
+			{ "BC2", MakeSharedPtr<TexCompressionBC2>() },
+			{ "BC3", MakeSharedPtr<TexCompressionBC3>() },
+			{ "BC4", MakeSharedPtr<TexCompressionBC4>() },
+			{ "BC5", MakeSharedPtr<TexCompressionBC5>() },
+			{ "BC7", MakeSharedPtr<TexCompressionBC7>() },
+			{ "ETC1", MakeSharedPtr<TexCompressionETC1>() },
+			{ "ETC2_RGB8", MakeSharedPtr<TexCompressionETC2RGB8>() },
+			{ "ETC2_RGB8A1", MakeSharedPtr<TexCompressionETC2RGB8A1>() }
+		};
+	}
+
+	// Gradients with some noise and a few hard edges, like a real texture
+	std::vector<uint8_t> MakeImage(uint32_t width, uint32_t height, uint32_t elem_size, uint32_t row_pitch)
+	{
+		std::ranlux24_base gen(width * 131 + height);
+		std::uniform_int_distribution<int> noise(-8, 8);
+
+		std::vector<uint8_t> image(row_pitch * height, 0xCD);
+		for (uint32_t y = 0; y < height; ++ y)
+		{
+			for (uint32_t x = 0; x < width; ++ x)
+			{
+				bool const edge = ((x / 7 + y / 5) & 3) == 0;
+				for (uint32_t c = 0; c < elem_size; ++ c)
+				{
+					int v = static_cast<int>((x * (c + 1) * 3 + y * (4 - c) * 2) & 0xFF) + noise(gen);
+					if (edge)
+					{
+						v = 255 - v;
+					}
+					if ((4 == elem_size) && (3 == c))
+					{
+						v = edge ? 0 : 255;
+					}
+					image[y * row_pitch + x * elem_size + c] = static_cast<uint8_t>(MathLib::clamp(v, 0, 255));
+				}
+			}
+		}
+
+		return image;
+	}
+
+	// The single-threaded, block by block reference
+	void EncodeBlockByBlock(TexCompression& codec, uint32_t width, uint32_t height,
+		uint8_t* output, uint32_t out_row_pitch, uint8_t const * input, uint32_t in_row_pitch, TexCompressionMethod method)
+	{
+		uint32_t const elem_size = NumFormatBytes(codec.DecodedFormat());
+		uint32_t const block_width = codec.BlockWidth();
+		uint32_t const block_height = codec.BlockHeight();
+
+		std::vector<uint8_t> uncompressed(block_width * block_height * elem_size);
+		for (uint32_t y_base = 0; y_base < height; y_base += block_height)
+		{
+			uint8_t* dst = output + (y_base / block_height) * out_row_pitch;
+			for (uint32_t x_base = 0; x_base < width; x_base += block_width)
+			{
+				for (uint32_t y = 0; y < block_height; ++ y)
+				{
+					for (uint32_t x = 0; x < block_width; ++ x)
+					{
+						uint8_t* texel = &uncompressed[(y * block_width + x) * elem_size];
+						if ((x_base + x < width) && (y_base + y < height))
+						{
+							memcpy(texel, &input[(y_base + y) * in_row_pitch + (x_base + x) * elem_size], elem_size);
+						}
+						else
+						{
+							memset(texel, 0, elem_size);
+						}
+					}
+				}
+
+				codec.EncodeBlock(dst, &uncompressed[0], method);
+				dst += codec.BlockBytes();
+			}
+		}
+	}
+
+	uint64_t Fnv1a(std::vector<uint8_t> const & data)
+	{
+		uint64_t hash = 0xCBF29CE484222325ULL;
+		for (auto b : data)
+		{
+			hash ^= b;
+			hash *= 0x100000001B3ULL;
+		}
+		return hash;
+	}
+}
+
+TEST(TexCompressionTest, EncodeMemMatchesBlockByBlock)
+{
+	uint32_t const sizes[][2] = { { 1, 1 }, { 6, 3 }, { 64, 64 }, { 130, 37 } };
+
+	for (auto const & entry : MakeCodecs())
+	{
+		TexCompression& codec = *entry.codec;
+		uint32_t const elem_size = NumFormatBytes(codec.DecodedFormat());
+
+		for (auto const & size : sizes)
+		{
+			uint32_t const width = size[0];
+			uint32_t const height = size[1];
+			uint32_t const in_row_pitch = width * elem_size + 12;
+			std::vector<uint8_t> const image = MakeImage(width, height, elem_size, in_row_pitch);
+
+			uint32_t const out_row_pitch = (width + codec.BlockWidth() - 1) / codec.BlockWidth() * codec.BlockBytes();
+			uint32_t const num_block_rows = (height + codec.BlockHeight() - 1) / codec.BlockHeight();
+
+			for (int method = TCM_Speed; method <= TCM_Quality; ++ method)
+			{
+				// The slow encoders at their slow settings only run on the small images
+				if ((method != TCM_Speed) && (width * height > 64 * 64) && ((entry.name[0] == 'E') || (entry.name[2] == '7')))
+				{
+					continue;
+				}
+
+				std::vector<uint8_t> parallel(out_row_pitch * num_block_rows);
+				codec.EncodeMem(width, height, &parallel[0], out_row_pitch, 0, &image[0], in_row_pitch, 0,
+					static_cast<TexCompressionMethod>(method));
+
+				std::vector<uint8_t> reference(parallel.size());
+				TexCompressionPtr ref_codec = codec.Clone();
+				EncodeBlockByBlock(*ref_codec, width, height, &reference[0], out_row_pitch, &image[0], in_row_pitch,
+					static_cast<TexCompressionMethod>(method));
+
+				EXPECT_TRUE(parallel == reference) << entry.name << " " << width << "x" << height << " method " << method;
+			}
+		}
+	}
+}
+
+// The annealing of BC7 restarts its own random generator for every block, so the output is the same on every
+//  platform and for every split of blocks between threads. These hashes are what it gives.
+TEST(TexCompressionTest, BC7Deterministic)
+{
+	uint32_t const WIDTH = 32;
+	uint32_t const HEIGHT = 32;
+	uint64_t const expected_hashes[] = { 0x0FCE65BA53CB916CULL, 0x75CB675CD4939E35ULL };
+
+	TexCompressionBC7 codec;
+	std::vector<uint8_t> const image = MakeImage(WIDTH, HEIGHT, 4, WIDTH * 4);
+	uint32_t const out_row_pitch = WIDTH / 4 * codec.BlockBytes();
+	for (int method = TCM_Balanced; method <= TCM_Quality; ++ method)
+	{
+		std::vector<uint8_t> output(out_row_pitch * HEIGHT / 4);
+		codec.EncodeMem(WIDTH, HEIGHT, &output[0], out_row_pitch, 0, &image[0], WIDTH * 4, 0,
+			static_cast<TexCompressionMethod>(method));
+		EXPECT_EQ(Fnv1a(output), expected_hashes[method - TCM_Balanced]) << "method " << method;
+	}
+}
+
+TEST(TexCompressionTest, DISABLED_Benchmark)
+{
+	uint32_t const WIDTH = 256;
+	uint32_t const HEIGHT = 256;
+
+	for (auto const & entry : MakeCodecs())
+	{
+		TexCompression& codec = *entry.codec;
+		uint32_t const elem_size = NumFormatBytes(codec.DecodedFormat());
+		std::vector<uint8_t> const image = MakeImage(WIDTH, HEIGHT, elem_size, WIDTH * elem_size);
+
+		uint32_t const num_blocks = (WIDTH / codec.BlockWidth()) * (HEIGHT / codec.BlockHeight());
+		uint32_t const out_row_pitch = WIDTH / codec.BlockWidth() * codec.BlockBytes();
+		std::vector<uint8_t> output(out_row_pitch * HEIGHT / codec.BlockHeight());
+
+		Timer timer;
+		EncodeBlockByBlock(codec, WIDTH, HEIGHT, &output[0], out_row_pitch, &image[0], WIDTH * elem_size, TCM_Balanced);
+		double const serial_time = timer.elapsed();
+
+		timer.restart();
+		codec.EncodeMem(WIDTH, HEIGHT, &output[0], out_row_pitch, 0, &image[0], WIDTH * elem_size, 0, TCM_Balanced);
+		double const parallel_time = timer.elapsed();
+
+		cout << entry.name << ": " << static_cast<uint64_t>(num_blocks / serial_time) << " blocks/s block by block, "
+			<< static_cast<uint64_t>(num_blocks / parallel_time) << " blocks/s with EncodeMem" << endl;
+	}
+}
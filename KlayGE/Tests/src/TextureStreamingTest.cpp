@@ -0,0 +1,110 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KlayGE/Texture.hpp>
+#include <KlayGE/TextureStreaming.hpp>
+
+#include <vector>
+
+#include "KlayGETests.hpp"
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	uint32_t const SIZE = 256;
+	uint32_t const NUM_MIPS = 9;
+
+	StreamedTexturePtr MakeStreamedTexture()
+	{
+		auto tex = MakeSharedPtr<StreamedTexture>(Texture::TT_2D, SIZE, SIZE, 1, NUM_MIPS, 1, EF_ABGR8, EAH_GPU_Read | EAH_Immutable);
+
+		std::vector<ElementInitData> init_data(NUM_MIPS);
+		std::vector<uint32_t> base(NUM_MIPS);
+		uint32_t data_size = 0;
+		for (uint32_t level = 0; level < NUM_MIPS; ++ level)
+		{
+			uint32_t const size = SIZE >> level;
+			init_data[level].row_pitch = size * 4;
+			init_data[level].slice_pitch = size * size * 4;
+			base[level] = data_size;
+			data_size += init_data[level].slice_pitch;
+		}
+		std::vector<uint8_t> data_block(data_size, 0x80);
+		for (uint32_t level = 0; level < NUM_MIPS; ++ level)
+		{
+			init_data[level].data = &data_block[base[level]];
+		}
+
+		tex->SourceData(std::move(init_data), std::move(data_block));
+		tex->CreateHWResource();
+		TextureStreamingManager::Instance().Add(tex);
+		return tex;
+	}
+}
+
+TEST_F(KlayGETest, TextureStreamingLowMipsFirst)
+{
+	TextureStreamingManager& tsm = TextureStreamingManager::Instance();
+	tsm.Budget(0);
+
+	StreamedTexturePtr tex = MakeStreamedTexture();
+
+	// 64x64 and below
+	EXPECT_EQ(2U, tex->ResidentMip());
+	EXPECT_EQ(64U, tex->ResidentTexture()->Width(0));
+	EXPECT_EQ(NUM_MIPS - 2, tex->ResidentTexture()->NumMipMaps());
+	EXPECT_EQ(tex->MipChainBytes(2), tex->ResidentBytes());
+
+	// Only the mips finer than the base stay in system memory
+	EXPECT_EQ(tex->MipChainBytes(0) - tex->MipChainBytes(2), tex->SourceBytes());
+
+	tex->RequestScreenSize(SIZE / 2.0f);
+	tsm.Update();
+	EXPECT_EQ(1U, tex->ResidentMip());
+	EXPECT_EQ(128U, tex->ResidentTexture()->Width(0));
+
+	tex->RequestMip(0);
+	tsm.Update();
+	EXPECT_EQ(0U, tex->ResidentMip());
+	EXPECT_EQ(SIZE, tex->ResidentTexture()->Width(0));
+	EXPECT_EQ(tex->MipChainBytes(0), tex->ResidentBytes());
+	EXPECT_EQ(tex->ResidentBytes(), tsm.ResidentBytes());
+}
+
+TEST_F(KlayGETest, TextureStreamingBudget)
+{
+	TextureStreamingManager& tsm = TextureStreamingManager::Instance();
+	tsm.Budget(0);
+
+	StreamedTexturePtr old_tex = MakeStreamedTexture();
+	StreamedTexturePtr new_tex = MakeStreamedTexture();
+
+	old_tex->RequestMip(0);
+	tsm.Update();
+	ASSERT_EQ(0U, old_tex->ResidentMip());
+
+	// Only one of them fits at full size. The one not used any more gives way.
+	tsm.Budget(old_tex->MipChainBytes(0) + new_tex->MipChainBytes(1));
+	new_tex->RequestMip(0);
+	tsm.Update();
+	EXPECT_EQ(0U, new_tex->ResidentMip());
+	EXPECT_LT(0U, old_tex->ResidentMip());
+	EXPECT_LE(tsm.ResidentBytes(), tsm.Budget());
+	EXPECT_EQ(old_tex->ResidentBytes() + new_tex->ResidentBytes(), tsm.ResidentBytes());
+
+	// Both in use, so nothing can be evicted, and the other one only grows as far as the budget allows
+	old_tex->RequestMip(0);
+	new_tex->RequestMip(0);
+	tsm.Update();
+	EXPECT_EQ(0U, new_tex->ResidentMip());
+	EXPECT_LT(0U, old_tex->ResidentMip());
+	EXPECT_LE(tsm.ResidentBytes(), tsm.Budget());
+
+	// The evicted mips come back from system memory
+	tsm.Budget(0);
+	old_tex->RequestMip(0);
+	tsm.Update();
+	EXPECT_EQ(0U, old_tex->ResidentMip());
+	EXPECT_EQ(old_tex->MipChainBytes(0), old_tex->ResidentBytes());
+	EXPECT_EQ(SIZE, old_tex->ResidentTexture()->Width(0));
+}
@@ -0,0 +1,300 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/Math.hpp>
+#include <KFL/Thread.hpp>
+#include <KlayGE/TransformHierarchy.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	float4x4 RandomTransform(std::ranlux24_base& gen)
+	{
+		std::uniform_real_distribution<float> dist(-1, 1);
+		float3 const scale(1 + dist(gen) * 0.5f, 1 + dist(gen) * 0.5f, 1 + dist(gen) * 0.5f);
+		Quaternion const rot = MathLib::normalize(Quaternion(dist(gen), dist(gen), dist(gen), dist(gen) + 2));
+		float3 const trans(dist(gen) * 10, dist(gen) * 10, dist(gen) * 10);
+		return MathLib::scaling(scale) * MathLib::to_matrix(rot) * MathLib::translation(trans);
+	}
+
+	// Nodes and a reference computed the slow way
+	struct Forest
+	{
+		std::vector<uint32_t> nodes;
+		std::vector<int> parents;
+		std::vector<float4x4> locals;
+		AABBox bound;
+
+		void Add(TransformHierarchy& th, int parent, float4x4 const & local)
+		{
+			uint32_t parent_node = TransformHierarchy::INVALID_NODE;
+			if (parent >= 0)
+			{
+				parent_node = nodes[parent];
+			}
+			uint32_t const node = th.AddNode(parent_node, local);
+			th.LocalBound(node, bound);
+			nodes.push_back(node);
+			parents.push_back(parent);
+			locals.push_back(local);
+		}
+
+		float4x4 World(int i) const
+		{
+			float4x4 world = locals[i];
+			for (int p = parents[i]; p >= 0; p = parents[p])
+			{
+				world = world * locals[p];
+			}
+			return world;
+		}
+	};
+
+	// Through the corners. MathLib::transform_aabb decomposes the matrix, which loses the shear that non-uniform
+	//  scaling in a parent and rotation in a child make.
+	AABBox ReferenceBound(AABBox const & aabb, float4x4 const & mat)
+	{
+		float3 min_bb = MathLib::transform_coord(aabb.Corner(0), mat);
+		float3 max_bb = min_bb;
+		for (size_t i = 1; i < 8; ++ i)
+		{
+			float3 const v = MathLib::transform_coord(aabb.Corner(i), mat);
+			min_bb = MathLib::minimize(min_bb, v);
+			max_bb = MathLib::maximize(max_bb, v);
+		}
+		return AABBox(min_bb, max_bb);
+	}
+
+	void ExpectMatrixNear(float4x4 const & lhs, float4x4 const & rhs, float tolerance)
+	{
+		for (int r = 0; r < 4; ++ r)
+		{
+			for (int c = 0; c < 4; ++ c)
+			{
+				float const scale = std::max(1.0f, MathLib::abs(rhs(r, c)));
+				EXPECT_NEAR(lhs(r, c), rhs(r, c), tolerance * scale) << r << ", " << c;
+			}
+		}
+	}
+
+	void ExpectBoundNear(AABBox const & lhs, AABBox const & rhs, float tolerance)
+	{
+		for (int i = 0; i < 3; ++ i)
+		{
+			float const scale = std::max(1.0f, MathLib::abs(rhs.Max()[i]) + MathLib::abs(rhs.Min()[i]));
+			EXPECT_NEAR(lhs.Min()[i], rhs.Min()[i], tolerance * scale);
+			EXPECT_NEAR(lhs.Max()[i], rhs.Max()[i], tolerance * scale);
+		}
+	}
+
+	void ExpectMatchesReference(TransformHierarchy const & th, Forest const & forest)
+	{
+		for (size_t i = 0; i < forest.nodes.size(); ++ i)
+		{
+			float4x4 const world = forest.World(static_cast<int>(i));
+			ExpectMatrixNear(th.WorldMatrix(forest.nodes[i]), world, 1e-4f);
+			ExpectBoundNear(th.WorldBound(forest.nodes[i]), ReferenceBound(forest.bound, world), 1e-4f);
+		}
+	}
+
+	// Random trees, added in an order that mixes the levels
+	void BuildForest(TransformHierarchy& th, Forest& forest, uint32_t num_nodes, std::ranlux24_base& gen)
+	{
+		forest.bound = AABBox(float3(-1, -2, -0.5f), float3(3, 1, 0.5f));
+		for (uint32_t i = 0; i < num_nodes; ++ i)
+		{
+			int parent = -1;
+			if ((i > 0) && (gen() % 8 != 0))
+			{
+				parent = static_cast<int>(gen() % i);
+			}
+			forest.Add(th, parent, RandomTransform(gen));
+		}
+	}
+}
+
+TEST(TransformHierarchyTest, DeepChain)
+{
+	std::ranlux24_base gen(1);
+
+	TransformHierarchy th;
+	Forest forest;
+	forest.bound = AABBox(float3(-1, -1, -1), float3(1, 1, 1));
+	for (int i = 0; i < 6; ++ i)
+	{
+		forest.Add(th, i - 1, RandomTransform(gen));
+	}
+	th.Update(nullptr);
+	EXPECT_EQ(th.UpdatedNodes().size(), 6U);
+	EXPECT_EQ(th.Depth(forest.nodes[5]), 5U);
+	ExpectMatchesReference(th, forest);
+
+	// A grandchild follows its grandparent, not only its parent
+	forest.locals[0] = MathLib::translation(100.0f, 0.0f, 0.0f);
+	th.LocalMatrix(forest.nodes[0], forest.locals[0]);
+	th.Update(nullptr);
+	ExpectMatchesReference(th, forest);
+}
+
+TEST(TransformHierarchyTest, OnlyDirtySubtrees)
+{
+	std::ranlux24_base gen(2);
+
+	TransformHierarchy th;
+	Forest forest;
+	BuildForest(th, forest, 1000, gen);
+	th.Update(nullptr);
+	EXPECT_EQ(th.UpdatedNodes().size(), 1000U);
+
+	th.Update(nullptr);
+	EXPECT_TRUE(th.UpdatedNodes().empty());
+
+	// Setting the same matrix changes nothing
+	th.LocalMatrix(forest.nodes[10], forest.locals[10]);
+	th.Update(nullptr);
+	EXPECT_TRUE(th.UpdatedNodes().empty());
+
+	int const changed[] = { 3, 500, 998 };
+	for (int c : changed)
+	{
+		forest.locals[c] = RandomTransform(gen);
+		th.LocalMatrix(forest.nodes[c], forest.locals[c]);
+		EXPECT_TRUE(th.Dirty(forest.nodes[c]));
+	}
+	th.Update(nullptr);
+
+	std::vector<uint32_t> expected;
+	for (size_t i = 0; i < forest.nodes.size(); ++ i)
+	{
+		for (int p = static_cast<int>(i); p >= 0; p = forest.parents[p])
+		{
+			if (std::find(std::begin(changed), std::end(changed), p) != std::end(changed))
+			{
+				expected.push_back(forest.nodes[i]);
+				break;
+			}
+		}
+	}
+	std::vector<uint32_t> updated = th.UpdatedNodes();
+	std::sort(expected.begin(), expected.end());
+	std::sort(updated.begin(), updated.end());
+	EXPECT_EQ(updated, expected);
+	ExpectMatchesReference(th, forest);
+
+	// A new bound only touches the node itself
+	forest.bound = AABBox(float3(0, 0, 0), float3(1, 1, 1));
+	th.LocalBound(forest.nodes[7], forest.bound);
+	th.Update(nullptr);
+	ASSERT_EQ(th.UpdatedNodes().size(), 1U);
+	ExpectBoundNear(th.WorldBound(forest.nodes[7]), ReferenceBound(forest.bound, forest.World(7)), 1e-4f);
+}
+
+TEST(TransformHierarchyTest, AddAndDelete)
+{
+	TransformHierarchy th;
+	uint32_t const root = th.AddNode(TransformHierarchy::INVALID_NODE, MathLib::translation(1.0f, 0.0f, 0.0f));
+	uint32_t const child = th.AddNode(root, MathLib::translation(0.0f, 2.0f, 0.0f));
+	uint32_t const leaf = th.AddNode(child, MathLib::translation(0.0f, 0.0f, 3.0f));
+	th.Update(nullptr);
+	EXPECT_EQ(th.NumNodes(), 3U);
+	ExpectMatrixNear(th.WorldMatrix(leaf), MathLib::translation(1.0f, 2.0f, 3.0f), 1e-6f);
+
+	th.DelNode(leaf);
+	th.DelNode(child);
+	EXPECT_EQ(th.NumNodes(), 1U);
+
+	// Handles are reused, and the new nodes are sorted in before the next update
+	uint32_t const child2 = th.AddNode(root, MathLib::translation(0.0f, 5.0f, 0.0f));
+	uint32_t const root2 = th.AddNode(TransformHierarchy::INVALID_NODE, MathLib::translation(7.0f, 0.0f, 0.0f));
+	EXPECT_TRUE((child2 == child) || (child2 == leaf));
+	EXPECT_EQ(th.NumNodes(), 3U);
+	th.Update(nullptr);
+	EXPECT_EQ(th.UpdatedNodes().size(), 2U);
+	ExpectMatrixNear(th.WorldMatrix(child2), MathLib::translation(1.0f, 5.0f, 0.0f), 1e-6f);
+	ExpectMatrixNear(th.WorldMatrix(root2), MathLib::translation(7.0f, 0.0f, 0.0f), 1e-6f);
+	ExpectMatrixNear(th.WorldMatrix(root), MathLib::translation(1.0f, 0.0f, 0.0f), 1e-6f);
+
+	th.Clear();
+	EXPECT_EQ(th.NumNodes(), 0U);
+	th.Update(nullptr);
+	EXPECT_TRUE(th.UpdatedNodes().empty());
+}
+
+TEST(TransformHierarchyTest, Reparent)
+{
+	std::ranlux24_base gen(4);
+
+	TransformHierarchy th;
+	Forest forest;
+	BuildForest(th, forest, 1000, gen);
+	th.Update(nullptr);
+
+	int num_moved = 0;
+	while (num_moved < 50)
+	{
+		int const c = static_cast<int>(gen() % forest.nodes.size());
+		int parent = static_cast<int>(gen() % (forest.nodes.size() + 1)) - 1;
+		for (int p = parent; p >= 0; p = forest.parents[p])
+		{
+			if (p == c)
+			{
+				parent = -2;
+				break;
+			}
+		}
+		if (parent < -1)
+		{
+			continue;
+		}
+
+		forest.parents[c] = parent;
+		th.Parent(forest.nodes[c], (parent < 0) ? TransformHierarchy::INVALID_NODE : forest.nodes[parent]);
+		++ num_moved;
+	}
+	th.Update(nullptr);
+	ExpectMatchesReference(th, forest);
+
+	for (size_t i = 0; i < forest.nodes.size(); ++ i)
+	{
+		uint32_t depth = 0;
+		for (int p = forest.parents[i]; p >= 0; p = forest.parents[p])
+		{
+			++ depth;
+		}
+		uint32_t parent_node = TransformHierarchy::INVALID_NODE;
+		if (forest.parents[i] >= 0)
+		{
+			parent_node = forest.nodes[forest.parents[i]];
+		}
+		EXPECT_EQ(th.Depth(forest.nodes[i]), depth) << i;
+		EXPECT_EQ(th.Parent(forest.nodes[i]), parent_node) << i;
+	}
+}
+
+TEST(TransformHierarchyTest, Parallel)
+{
+	std::ranlux24_base gen(3);
+
+	task_scheduler scheduler(4);
+	TransformHierarchy th;
+	Forest forest;
+	BuildForest(th, forest, 20000, gen);
+	th.Update(&scheduler);
+	EXPECT_EQ(th.UpdatedNodes().size(), 20000U);
+	ExpectMatchesReference(th, forest);
+
+	for (int i = 0; i < 100; ++ i)
+	{
+		int const c = static_cast<int>(gen() % forest.nodes.size());
+		forest.locals[c] = RandomTransform(gen);
+		th.LocalMatrix(forest.nodes[c], forest.locals[c]);
+	}
+	th.Update(&scheduler);
+	ExpectMatchesReference(th, forest);
+}
@@ -0,0 +1,41 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KlayGE/GraphicsBuffer.hpp>
+#include <KlayGE/TransientBuffer.hpp>
+
+#include <vector>
+
+#include "KlayGETests.hpp"
+
+using namespace std;
+using namespace KlayGE;
+
+TEST_F(KlayGETest, TransientBufferAlignedAlloc)
+{
+	TransientBuffer tb(1024, TransientBuffer::BF_Vertex);
+
+	std::vector<uint8_t> data(512, 0xCD);
+	std::vector<SubAlloc> allocs;
+
+	// Alignments of instance sizes, mixed with unaligned allocs. Enough of them to grow the buffer a few times.
+	uint32_t const alignments[] = { 1, 48, 7, 64, 12, 1, 100, 3 };
+	for (int round = 0; round < 8; ++ round)
+	{
+		for (uint32_t alignment : alignments)
+		{
+			uint32_t const size = alignment * 2 + 5;
+			SubAlloc const alloc = tb.Alloc(size, &data[0], alignment);
+
+			EXPECT_EQ(0U, alloc.offset_ % alignment) << "alignment " << alignment;
+			EXPECT_EQ(size, alloc.length_);
+			EXPECT_LE(alloc.offset_ + alloc.length_, tb.GetBuffer()->Size());
+			for (auto const & prev : allocs)
+			{
+				EXPECT_TRUE((alloc.offset_ >= prev.offset_ + prev.length_) || (prev.offset_ >= alloc.offset_ + alloc.length_))
+					<< "[" << alloc.offset_ << ", " << alloc.offset_ + alloc.length_ << ") overlaps ["
+					<< prev.offset_ << ", " << prev.offset_ + prev.length_ << ")";
+			}
+
+			allocs.push_back(alloc);
+		}
+	}
+}
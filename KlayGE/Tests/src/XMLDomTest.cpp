@@ -0,0 +1,372 @@
+#include <KlayGE/KlayGE.hpp>
+#include <KFL/CXX17/filesystem.hpp>
+#include <KFL/ResIdentifier.hpp>
+#include <KFL/Timer.hpp>
+#include <KFL/Util.hpp>
+#include <KFL/XMLDom.hpp>
+#include <KlayGE/ResLoader.hpp>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/lexical_cast.hpp>
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace KlayGE;
+
+namespace
+{
+	XMLNodePtr ParseString(XMLDocument& doc, std::string const & xml)
+	{
+		return doc.Parse(MakeSharedPtr<ResIdentifier>("", 0, MakeSharedPtr<std::stringstream>(xml)));
+	}
+
+	struct WalkStats
+	{
+		uint32_t num_nodes = 0;
+		uint32_t num_attribs = 0;
+		uint32_t num_numbers = 0;
+		double sum = 0;
+	};
+
+	// Visits every element and attribute like the loaders do, and reads every value that converts to a float
+	void WalkLegacy(XMLNodePtr const & node, WalkStats& stats)
+	{
+		++ stats.num_nodes;
+		for (XMLAttributePtr attr = node->FirstAttrib(); attr; attr = attr->NextAttrib())
+		{
+			++ stats.num_attribs;
+			float val;
+			if (attr->TryConvert(val))
+			{
+				++ stats.num_numbers;
+				stats.sum += val;
+			}
+		}
+		for (XMLNodePtr child = node->FirstNode(); child; child = child->NextSibling())
+		{
+			if (child->Type() == XNT_Element)
+			{
+				WalkLegacy(child, stats);
+			}
+		}
+	}
+
+	void WalkView(XMLNodeView node, WalkStats& stats)
+	{
+		++ stats.num_nodes;
+		for (XMLAttributeView attr = node.FirstAttrib(); attr; attr = attr.NextAttrib())
+		{
+			++ stats.num_attribs;
+			float val;
+			if (attr.TryConvert(val))
+			{
+				++ stats.num_numbers;
+				stats.sum += val;
+			}
+		}
+		for (XMLNodeView child = node.FirstNode(); child; child = child.NextSibling())
+		{
+			if (child.Type() == XNT_Element)
+			{
+				WalkView(child, stats);
+			}
+		}
+	}
+
+	void ExpectSameFloat(std::string const & str)
+	{
+		float const expected = std::strtof(str.c_str(), nullptr);
+		float val = -1;
+		char const * last = str.c_str() + str.size();
+		EXPECT_EQ(FromChars(str.c_str(), last, val), last) << str;
+		EXPECT_EQ(std::memcmp(&val, &expected, sizeof(val)), 0) << str << ": " << val << " vs " << expected;
+	}
+}
+
+TEST(XMLDomTest, Views)
+{
+	XMLDocument doc;
+	XMLNodePtr root = ParseString(doc,
+		"<root version=\"7\">"
+		"<item name=\"a\" x=\"1.5\" y=\"-2\"/>"
+		"<other/>"
+		"<item name=\"b\" x=\"3e2\" y=\"4\">text</item>"
+		"</root>");
+	XMLNodeView const root_view = doc.RootView();
+	ASSERT_TRUE(root_view);
+	EXPECT_EQ(root_view, root->View());
+	EXPECT_EQ(root_view.Name(), root->Name());
+	EXPECT_EQ(root_view.Type(), XNT_Element);
+	EXPECT_EQ(root_view.AttribUInt("version", 0), 7U);
+	EXPECT_EQ(root_view.AttribUInt("missing", 9), 9U);
+	EXPECT_EQ(root_view.AttribString("missing", "default"), "default");
+
+	XMLNodeView const first = root_view.FirstNode("item");
+	XMLNodePtr const first_legacy = root->FirstNode("item");
+	ASSERT_TRUE(first);
+	EXPECT_EQ(first, first_legacy->View());
+	EXPECT_EQ(first.Parent(), root_view);
+	EXPECT_EQ(first.AttribString("name", ""), first_legacy->AttribString("name", ""));
+	EXPECT_EQ(first.AttribFloat("x", 0), 1.5f);
+	EXPECT_EQ(first.AttribInt("y", 0), -2);
+	EXPECT_EQ(first.FirstAttrib().Name(), "name");
+	EXPECT_EQ(first.LastAttrib().Name(), "y");
+	EXPECT_EQ(first.FirstAttrib().NextAttrib("y"), first.LastAttrib());
+	EXPECT_EQ(first.FirstAttrib("x").ValueString(), first_legacy->Attrib("x")->ValueString());
+
+	XMLNodeView const second = first.NextSibling("item");
+	ASSERT_TRUE(second);
+	EXPECT_EQ(second, root_view.LastNode("item"));
+	EXPECT_EQ(second.PrevSibling("item"), first);
+	EXPECT_EQ(second.PrevSibling().Name(), "other");
+	EXPECT_EQ(second.AttribFloat("x", 0), 300.0f);
+	EXPECT_EQ(second.ValueString(), "text");
+	EXPECT_FALSE(second.NextSibling());
+	EXPECT_FALSE(second.FirstNode("item"));
+	EXPECT_FALSE(second.Attrib("z"));
+
+	float val;
+	EXPECT_TRUE(second.TryConvertAttrib("z", val, 5.0f));
+	EXPECT_EQ(val, 5.0f);
+	EXPECT_FALSE(second.TryConvertAttrib("name", val, 5.0f));
+
+	XMLNodeView const none;
+	EXPECT_FALSE(none);
+	EXPECT_NE(none, first);
+}
+
+TEST(XMLDomTest, AllocatedNodes)
+{
+	XMLDocument doc;
+	XMLNodePtr root;
+	{
+		std::string name = "root";
+		root = doc.AllocNode(XNT_Element, name);
+		doc.RootNode(root);
+
+		std::string attr_name = "scale";
+		root->AppendAttrib(doc.AllocAttribFloat(attr_name, 0.25f));
+		root->AppendAttrib(doc.AllocAttribString("name", std::string("temporary")));
+		name = "overwritten";
+		attr_name = "overwritten";
+	}
+
+	// The names and values live in the document, not in the strings they came from
+	XMLNodeView const view = doc.RootView();
+	EXPECT_EQ(view.Name(), "root");
+	EXPECT_EQ(view.AttribFloat("scale", 0), 0.25f);
+	EXPECT_EQ(view.AttribString("name", ""), "temporary");
+	EXPECT_EQ(root->AttribString("name", ""), "temporary");
+}
+
+TEST(XMLDomTest, FromChars)
+{
+	int32_t i = -7;
+	std::string const int_strs[] = { "0", "+12", "-2147483648", "2147483647" };
+	int32_t const int_vals[] = { 0, 12, INT32_MIN, INT32_MAX };
+	for (size_t j = 0; j < std::size(int_strs); ++ j)
+	{
+		char const * last = int_strs[j].c_str() + int_strs[j].size();
+		EXPECT_EQ(FromChars(int_strs[j].c_str(), last, i), last);
+		EXPECT_EQ(i, int_vals[j]);
+	}
+
+	i = -7;
+	char const * fails[] = { "", "-", "+", "2147483648", "-2147483649", "x1", " 1" };
+	for (auto str : fails)
+	{
+		EXPECT_EQ(FromChars(str, str + std::strlen(str), i), str) << str;
+	}
+	EXPECT_EQ(i, -7);
+
+	uint32_t u = 7;
+	char const * u_str = "4294967295 ";
+	EXPECT_EQ(FromChars(u_str, u_str + 11, u), u_str + 10);
+	EXPECT_EQ(u, 0xFFFFFFFFU);
+	u_str = "-1";
+	EXPECT_EQ(FromChars(u_str, u_str + 2, u), u_str);
+	u_str = "4294967296";
+	EXPECT_EQ(FromChars(u_str, u_str + 10, u), u_str);
+
+	char const * partial = "2.5e3x";
+	float f = 0;
+	EXPECT_EQ(FromChars(partial, partial + 6, f), partial + 5);
+	EXPECT_EQ(f, 2500.0f);
+	partial = "1e+";
+	EXPECT_EQ(FromChars(partial, partial + 3, f), partial + 1);
+	EXPECT_EQ(f, 1.0f);
+	partial = "1e39";
+	EXPECT_EQ(FromChars(partial, partial + 4, f), partial);
+
+	char const * floats[] = { "0", "-0", ".5", "1.", "0.1", "3.4028235e38", "1.17549435e-38", "1.4e-45", "1e-50",
+		"16777217", "123456789012345678901234567890", "0.000000000000000000000000000000000000011754943508222875" };
+	for (auto str : floats)
+	{
+		ExpectSameFloat(str);
+	}
+
+	// The bits of random floats, at several precisions, and the points halfway between neighbours
+	std::mt19937 gen(1);
+	char buf[64];
+	for (int j = 0; j < 100000; ++ j)
+	{
+		uint32_t bits = gen();
+		float rand_val;
+		std::memcpy(&rand_val, &bits, sizeof(rand_val));
+		if (!std::isfinite(rand_val))
+		{
+			continue;
+		}
+
+		std::snprintf(buf, sizeof(buf), "%.*g", j % 17 + 1, rand_val);
+		ExpectSameFloat(buf);
+
+		float const next = std::nextafter(rand_val, std::numeric_limits<float>::infinity());
+		if (std::isfinite(next))
+		{
+			std::snprintf(buf, sizeof(buf), "%.25g", (static_cast<double>(rand_val) + next) / 2);
+			ExpectSameFloat(buf);
+		}
+	}
+}
+
+TEST(XMLDomTest, Conversions)
+{
+	XMLDocument doc;
+	XMLNodeView const root = ParseString(doc,
+		"<root a=\"inf\" b=\"-1\" c=\"1.5 \" d=\"abc\" e=\" 2\"/>")->View();
+
+	// What FromChars doesn't take still behaves like boost::lexical_cast
+	EXPECT_EQ(root.AttribFloat("a", 0), std::numeric_limits<float>::infinity());
+	EXPECT_EQ(root.AttribUInt("b", 0), boost::lexical_cast<uint32_t>("-1"));
+	EXPECT_THROW(root.AttribFloat("c", 0), boost::bad_lexical_cast);
+	EXPECT_THROW(root.AttribInt("d", 0), boost::bad_lexical_cast);
+	EXPECT_THROW(root.AttribInt("e", 0), boost::bad_lexical_cast);
+
+	int32_t val;
+	EXPECT_FALSE(root.TryConvertAttrib("d", val, 3));
+	EXPECT_TRUE(root.TryConvertAttrib("b", val, 3));
+	EXPECT_EQ(val, -1);
+}
+
+TEST(XMLDomTest, DISABLED_Benchmark)
+{
+	std::vector<std::string> files;
+	for (auto const & sample : { "Blur.fxml", "Copy.ppml" })
+	{
+		std::string const path = ResLoader::Instance().Locate(sample);
+		if (path.empty())
+		{
+			continue;
+		}
+
+		std::string const ext = filesystem::path(sample).extension().string();
+		filesystem::directory_iterator end_itr;
+		for (filesystem::directory_iterator i(filesystem::path(path).parent_path()); i != end_itr; ++ i)
+		{
+			if (i->path().extension().string() == ext)
+			{
+				files.push_back(i->path().string());
+			}
+		}
+	}
+	if (files.empty())
+	{
+		cout << "No media found, skipping" << endl;
+		return;
+	}
+
+	std::vector<std::string> contents;
+	size_t total_size = 0;
+	for (auto const & file : files)
+	{
+		std::ifstream ifs(file, std::ios_base::binary);
+		std::stringstream ss;
+		ss << ifs.rdbuf();
+		contents.push_back(ss.str());
+		total_size += contents.back().size();
+	}
+
+	uint32_t const NUM_PASSES = 20;
+
+	double parse_time = 0;
+	double legacy_time = 0;
+	double view_time = 0;
+	WalkStats legacy_stats;
+	WalkStats view_stats;
+	Timer timer;
+	for (uint32_t pass = 0; pass < NUM_PASSES; ++ pass)
+	{
+		for (auto const & content : contents)
+		{
+			timer.restart();
+			XMLDocument doc;
+			XMLNodePtr root = ParseString(doc, content);
+			parse_time += timer.elapsed();
+
+			timer.restart();
+			WalkLegacy(root, legacy_stats);
+			legacy_time += timer.elapsed();
+
+			timer.restart();
+			WalkView(doc.RootView(), view_stats);
+			view_time += timer.elapsed();
+		}
+	}
+	EXPECT_EQ(legacy_stats.num_nodes, view_stats.num_nodes);
+	EXPECT_EQ(legacy_stats.num_attribs, view_stats.num_attribs);
+	EXPECT_EQ(legacy_stats.num_numbers, view_stats.num_numbers);
+	EXPECT_EQ(legacy_stats.sum, view_stats.sum);
+
+	cout << files.size() << " files, " << total_size / 1024 << " KB, "
+		<< legacy_stats.num_nodes / NUM_PASSES << " elements, " << legacy_stats.num_attribs / NUM_PASSES << " attributes" << endl;
+	cout << "Parse: " << parse_time / NUM_PASSES * 1000 << " ms" << endl;
+	cout << "Walk, XMLNodePtr: " << legacy_time / NUM_PASSES * 1000 << " ms" << endl;
+	cout << "Walk, XMLNodeView: " << view_time / NUM_PASSES * 1000 << " ms" << endl;
+
+	// Numbers alone
+	std::vector<std::string> numbers;
+	std::mt19937 gen(2);
+	std::uniform_real_distribution<float> dist(-1000, 1000);
+	char buf[64];
+	for (int i = 0; i < 100000; ++ i)
+	{
+		std::snprintf(buf, sizeof(buf), "%.*f", i % 7, dist(gen));
+		numbers.push_back(buf);
+	}
+
+	float lexical_sum = 0;
+	timer.restart();
+	for (auto const & number : numbers)
+	{
+		lexical_sum += boost::lexical_cast<float>(number);
+	}
+	double const lexical_time = timer.elapsed();
+
+	float from_chars_sum = 0;
+	timer.restart();
+	for (auto const & number : numbers)
+	{
+		float val = 0;
+		FromChars(number.c_str(), number.c_str() + number.size(), val);
+		from_chars_sum += val;
+	}
+	double const from_chars_time = timer.elapsed();
+	EXPECT_NEAR(lexical_sum, from_chars_sum, std::abs(lexical_sum) * 1e-5f);
+
+	cout << "Floats, lexical_cast: " << lexical_time * 1e9 / numbers.size() << " ns each" << endl;
+	cout << "Floats, FromChars: " << from_chars_time * 1e9 / numbers.size() << " ns each" << endl;
+}
@@ -16,16 +16,6 @@
 #include <vector>
 #include <cstring>
 
-#if defined(KLAYGE_COMPILER_GCC)
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations" // Ignore auto_ptr declaration
-#endif
-#include <boost/algorithm/string/split.hpp>
-#if defined(KLAYGE_COMPILER_GCC)
-#pragma GCC diagnostic pop
-#endif
-#include <boost/algorithm/string/trim.hpp>
-
 #if defined(KLAYGE_COMPILER_GCC)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations" // Ignore auto_ptr declaration
@@ -76,41 +66,68 @@ namespace
 
 	std::string const JIT_EXT_NAME = ".model_bin";
 
-	template <int N>
-	void ExtractFVector(std::string const & value_str, float* v)
+	// Cuts a value at single spaces, the same tokens as boost::algorithm::split with is_any_of(" "), but without
+	//  allocating. A token is read like atof/atoi, so an empty or malformed one gives 0.
+	class ValueTokenizer
 	{
-		std::vector<std::string> strs;
-		boost::algorithm::split(strs, value_str, boost::is_any_of(" "));
-		for (size_t i = 0; i < N; ++ i)
+	public:
+		explicit ValueTokenizer(std::string_view str)
+			: str_(str), done_(false)
 		{
-			if (i < strs.size())
+		}
+
+		bool Done() const
+		{
+			return done_;
+		}
+
+		template <typename T>
+		T Next()
+		{
+			BOOST_ASSERT(!done_);
+
+			size_t const end = str_.find(' ');
+			std::string_view const token = str_.substr(0, end);
+			if (end == std::string_view::npos)
 			{
-				boost::algorithm::trim(strs[i]);
-				v[i] = static_cast<float>(atof(strs[i].c_str()));
+				done_ = true;
 			}
 			else
 			{
-				v[i] = 0;
+				str_.remove_prefix(end + 1);
+			}
+
+			T val = 0;
+			size_t const first = token.find_first_not_of(" \t\r\n");
+			if (first != std::string_view::npos)
+			{
+				FromChars(token.data() + first, token.data() + token.size(), val);
 			}
+			return val;
+		}
+
+	private:
+		std::string_view str_;
+		bool done_;
+	};
+
+	template <int N>
+	void ExtractFVector(std::string_view value_str, float* v)
+	{
+		ValueTokenizer tokens(value_str);
+		for (size_t i = 0; i < N; ++ i)
+		{
+			v[i] = tokens.Done() ? 0 : tokens.Next<float>();
 		}
 	}
 
 	template <int N>
-	void ExtractUIVector(std::string const & value_str, uint32_t* v)
+	void ExtractUIVector(std::string_view value_str, uint32_t* v)
 	{
-		std::vector<std::string> strs;
-		boost::algorithm::split(strs, value_str, boost::is_any_of(" "));
+		ValueTokenizer tokens(value_str);
 		for (size_t i = 0; i < N; ++ i)
 		{
-			if (i < strs.size())
-			{
-				boost::algorithm::trim(strs[i]);
-				v[i] = static_cast<uint32_t>(atoi(strs[i].c_str()));
-			}
-			else
-			{
-				v[i] = 0;
-			}
+			v[i] = tokens.Done() ? 0 : tokens.Next<uint32_t>();
 		}
 	}
 
@@ -464,7 +481,7 @@ namespace
 		}
 	}
 
-	void CompileMeshesVerticesChunk(XMLNodePtr const & vertices_chunk,
+	void CompileMeshesVerticesChunk(XMLNodeView vertices_chunk,
 		AABBox& pos_bb, AABBox& tc_bb, std::vector<VertexElement>& vertex_elements,
 		std::vector<int16_t>& positions, std::vector<uint32_t>& normals,
 		std::vector<uint32_t>& tangent_quats, 
@@ -484,36 +501,36 @@ namespace
 		std::vector<uint32_t> mesh_bone_weights;
 
 		bool recompute_pos_bb;
-		XMLNodePtr pos_bb_node = vertices_chunk->FirstNode("pos_bb");
+		XMLNodeView pos_bb_node = vertices_chunk.FirstNode("pos_bb");
 		if (pos_bb_node)
 		{
 			float3 pos_min_bb, pos_max_bb;
 			{
-				XMLAttributePtr attr = pos_bb_node->Attrib("min");
+				XMLAttributeView attr = pos_bb_node.Attrib("min");
 				if (attr)
 				{
-					ExtractFVector<3>(attr->ValueString(), &pos_min_bb[0]);
+					ExtractFVector<3>(attr.ValueString(), &pos_min_bb[0]);
 				}
 				else
 				{
-					XMLNodePtr pos_min_node = pos_bb_node->FirstNode("min");
-					pos_min_bb.x() = pos_min_node->Attrib("x")->ValueFloat();
-					pos_min_bb.y() = pos_min_node->Attrib("y")->ValueFloat();
-					pos_min_bb.z() = pos_min_node->Attrib("z")->ValueFloat();
+					XMLNodeView pos_min_node = pos_bb_node.FirstNode("min");
+					pos_min_bb.x() = pos_min_node.Attrib("x").ValueFloat();
+					pos_min_bb.y() = pos_min_node.Attrib("y").ValueFloat();
+					pos_min_bb.z() = pos_min_node.Attrib("z").ValueFloat();
 				}
 			}
 			{
-				XMLAttributePtr attr = pos_bb_node->Attrib("max");
+				XMLAttributeView attr = pos_bb_node.Attrib("max");
 				if (attr)
 				{
-					ExtractFVector<3>(attr->ValueString(), &pos_max_bb[0]);
+					ExtractFVector<3>(attr.ValueString(), &pos_max_bb[0]);
 				}
 				else
 				{
-					XMLNodePtr pos_max_node = pos_bb_node->FirstNode("max");
-					pos_max_bb.x() = pos_max_node->Attrib("x")->ValueFloat();
-					pos_max_bb.y() = pos_max_node->Attrib("y")->ValueFloat();
-					pos_max_bb.z() = pos_max_node->Attrib("z")->ValueFloat();
+					XMLNodeView pos_max_node = pos_bb_node.FirstNode("max");
+					pos_max_bb.x() = pos_max_node.Attrib("x").ValueFloat();
+					pos_max_bb.y() = pos_max_node.Attrib("y").ValueFloat();
+					pos_max_bb.z() = pos_max_node.Attrib("z").ValueFloat();
 				}
 			}
 			pos_bb = AABBox(pos_min_bb, pos_max_bb);
@@ -526,34 +543,34 @@ namespace
 		}
 
 		bool recompute_tc_bb;
-		XMLNodePtr tc_bb_node = vertices_chunk->FirstNode("tc_bb");
+		XMLNodeView tc_bb_node = vertices_chunk.FirstNode("tc_bb");
 		if (tc_bb_node)
 		{
 			float3 tc_min_bb, tc_max_bb;
 			{
-				XMLAttributePtr attr = tc_bb_node->Attrib("min");
+				XMLAttributeView attr = tc_bb_node.Attrib("min");
 				if (attr)
 				{
-					ExtractFVector<2>(attr->ValueString(), &tc_min_bb[0]);
+					ExtractFVector<2>(attr.ValueString(), &tc_min_bb[0]);
 				}
 				else
 				{
-					XMLNodePtr tc_min_node = tc_bb_node->FirstNode("min");
-					tc_min_bb.x() = tc_min_node->Attrib("x")->ValueFloat();
-					tc_min_bb.y() = tc_min_node->Attrib("y")->ValueFloat();
+					XMLNodeView tc_min_node = tc_bb_node.FirstNode("min");
+					tc_min_bb.x() = tc_min_node.Attrib("x").ValueFloat();
+					tc_min_bb.y() = tc_min_node.Attrib("y").ValueFloat();
 				}
 			}
 			{
-				XMLAttributePtr attr = tc_bb_node->Attrib("max");
+				XMLAttributeView attr = tc_bb_node.Attrib("max");
 				if (attr)
 				{
-					ExtractFVector<2>(attr->ValueString(), &tc_max_bb[0]);
+					ExtractFVector<2>(attr.ValueString(), &tc_max_bb[0]);
 				}
 				else
 				{
-					XMLNodePtr tc_max_node = tc_bb_node->FirstNode("max");							
-					tc_max_bb.x() = tc_max_node->Attrib("x")->ValueFloat();
-					tc_max_bb.y() = tc_max_node->Attrib("y")->ValueFloat();
+					XMLNodeView tc_max_node = tc_bb_node.FirstNode("max");							
+					tc_max_bb.x() = tc_max_node.Attrib("x").ValueFloat();
+					tc_max_bb.y() = tc_max_node.Attrib("y").ValueFloat();
 				}
 			}
 
@@ -577,97 +594,97 @@ namespace
 		bool has_binormal = false;
 		bool has_tangent_quat = false;
 
-		for (XMLNodePtr vertex_node = vertices_chunk->FirstNode("vertex"); vertex_node; vertex_node = vertex_node->NextSibling("vertex"))
+		for (XMLNodeView vertex_node = vertices_chunk.FirstNode("vertex"); vertex_node; vertex_node = vertex_node.NextSibling("vertex"))
 		{
 			{
 				float3 pos;
-				XMLAttributePtr attr = vertex_node->Attrib("x");
+				XMLAttributeView attr = vertex_node.Attrib("x");
 				if (attr)
 				{
-					pos.x() = vertex_node->Attrib("x")->ValueFloat();
-					pos.y() = vertex_node->Attrib("y")->ValueFloat();
-					pos.z() = vertex_node->Attrib("z")->ValueFloat();
+					pos.x() = vertex_node.Attrib("x").ValueFloat();
+					pos.y() = vertex_node.Attrib("y").ValueFloat();
+					pos.z() = vertex_node.Attrib("z").ValueFloat();
 
-					attr = vertex_node->Attrib("u");
+					attr = vertex_node.Attrib("u");
 					if (attr)
 					{
 						float2 tex_coord;
-						tex_coord.x() = vertex_node->Attrib("u")->ValueFloat();
-						tex_coord.y() = vertex_node->Attrib("v")->ValueFloat();
+						tex_coord.x() = vertex_node.Attrib("u").ValueFloat();
+						tex_coord.y() = vertex_node.Attrib("v").ValueFloat();
 						mesh_tex_coords.push_back(tex_coord);
 					}
 				}
 				else
 				{
-					ExtractFVector<3>(vertex_node->Attrib("v")->ValueString(), &pos[0]);
+					ExtractFVector<3>(vertex_node.Attrib("v").ValueString(), &pos[0]);
 				}
 				mesh_positions.push_back(pos);
 			}
 
-			XMLNodePtr diffuse_node = vertex_node->FirstNode("diffuse");
+			XMLNodeView diffuse_node = vertex_node.FirstNode("diffuse");
 			if (diffuse_node)
 			{
 				has_diffuse = true;
 
 				float4 diffuse;
-				XMLAttributePtr attr = diffuse_node->Attrib("v");
+				XMLAttributeView attr = diffuse_node.Attrib("v");
 				if (attr)
 				{
-					ExtractFVector<4>(attr->ValueString(), &diffuse[0]);
+					ExtractFVector<4>(attr.ValueString(), &diffuse[0]);
 				}
 				else
 				{
-					diffuse.x() = diffuse_node->Attrib("r")->ValueFloat();
-					diffuse.y() = diffuse_node->Attrib("g")->ValueFloat();
-					diffuse.z() = diffuse_node->Attrib("b")->ValueFloat();
-					diffuse.w() = diffuse_node->Attrib("a")->ValueFloat();										
+					diffuse.x() = diffuse_node.Attrib("r").ValueFloat();
+					diffuse.y() = diffuse_node.Attrib("g").ValueFloat();
+					diffuse.z() = diffuse_node.Attrib("b").ValueFloat();
+					diffuse.w() = diffuse_node.Attrib("a").ValueFloat();										
 				}
 				mesh_diffuses.push_back(diffuse);
 			}
 
-			XMLNodePtr specular_node = vertex_node->FirstNode("specular");
+			XMLNodeView specular_node = vertex_node.FirstNode("specular");
 			if (specular_node)
 			{
 				has_specular = true;
 
 				float3 specular;
-				XMLAttributePtr attr = specular_node->Attrib("v");
+				XMLAttributeView attr = specular_node.Attrib("v");
 				if (attr)
 				{
-					ExtractFVector<3>(attr->ValueString(), &specular[0]);
+					ExtractFVector<3>(attr.ValueString(), &specular[0]);
 				}
 				else
 				{
-					specular.x() = specular_node->Attrib("r")->ValueFloat();
-					specular.y() = specular_node->Attrib("g")->ValueFloat();
-					specular.z() = specular_node->Attrib("b")->ValueFloat();
+					specular.x() = specular_node.Attrib("r").ValueFloat();
+					specular.y() = specular_node.Attrib("g").ValueFloat();
+					specular.z() = specular_node.Attrib("b").ValueFloat();
 				}
 				mesh_speculars.push_back(specular);
 			}
 
-			if (!vertex_node->Attrib("u"))
+			if (!vertex_node.Attrib("u"))
 			{
-				XMLNodePtr tex_coord_node = vertex_node->FirstNode("tex_coord");
+				XMLNodeView tex_coord_node = vertex_node.FirstNode("tex_coord");
 				if (tex_coord_node)
 				{
 					has_tex_coord = true;
 
 					float2 tex_coord;
-					XMLAttributePtr attr = tex_coord_node->Attrib("u");
+					XMLAttributeView attr = tex_coord_node.Attrib("u");
 					if (attr)
 					{
-						tex_coord.x() = tex_coord_node->Attrib("u")->ValueFloat();
-						tex_coord.y() = tex_coord_node->Attrib("v")->ValueFloat();
+						tex_coord.x() = tex_coord_node.Attrib("u").ValueFloat();
+						tex_coord.y() = tex_coord_node.Attrib("v").ValueFloat();
 					}
 					else
 					{
-						ExtractFVector<2>(tex_coord_node->Attrib("v")->ValueString(), &tex_coord[0]);
+						ExtractFVector<2>(tex_coord_node.Attrib("v").ValueString(), &tex_coord[0]);
 					}
 					mesh_tex_coords.push_back(tex_coord);
 				}
 			}
 
-			XMLNodePtr weight_node = vertex_node->FirstNode("weight");
+			XMLNodeView weight_node = vertex_node.FirstNode("weight");
 			if (weight_node)
 			{
 				has_weight = true;
@@ -676,41 +693,31 @@ namespace
 				float bone_weight32[4] = { 0, 0, 0, 0 };
 
 				uint32_t num_blend = 0;
-				XMLAttributePtr attr = weight_node->Attrib("joint");
+				XMLAttributeView attr = weight_node.Attrib("joint");
 				if (!attr)
 				{
-					attr = weight_node->Attrib("bone_index");
+					attr = weight_node.Attrib("bone_index");
 				}
 				if (attr)
 				{
-					XMLAttributePtr weight_attr = weight_node->Attrib("weight");
+					XMLAttributeView weight_attr = weight_node.Attrib("weight");
 
-					std::vector<std::string> index_strs;
-					std::vector<std::string> weight_strs;
-					boost::algorithm::split(index_strs, attr->ValueString(), boost::is_any_of(" "));
-					boost::algorithm::split(weight_strs, weight_attr->ValueString(), boost::is_any_of(" "));
-					
-					for (num_blend = 0; num_blend < 4; ++ num_blend)
+					ValueTokenizer index_tokens(attr.ValueString());
+					ValueTokenizer weight_tokens(weight_attr.ValueString());
+					for (num_blend = 0; (num_blend < 4) && !index_tokens.Done() && !weight_tokens.Done(); ++ num_blend)
 					{
-						if ((num_blend < index_strs.size()) && (num_blend < weight_strs.size()))
-						{
-							bone_index32[num_blend] = static_cast<uint32_t>(atoi(index_strs[num_blend].c_str()));
-							bone_weight32[num_blend] = static_cast<float>(atof(weight_strs[num_blend].c_str()));
-						}
-						else
-						{
-							break;
-						}
+						bone_index32[num_blend] = index_tokens.Next<uint32_t>();
+						bone_weight32[num_blend] = weight_tokens.Next<float>();
 					}
 				}
 				else
 				{
 					while (weight_node && (num_blend < 4))
 					{
-						bone_index32[num_blend] = weight_node->Attrib("bone_index")->ValueUInt();
-						bone_weight32[num_blend] = weight_node->Attrib("weight")->ValueFloat();
+						bone_index32[num_blend] = weight_node.Attrib("bone_index").ValueUInt();
+						bone_weight32[num_blend] = weight_node.Attrib("weight").ValueFloat();
 
-						weight_node = weight_node->NextSibling("weight");
+						weight_node = weight_node.NextSibling("weight");
 						++ num_blend;
 					}
 				}
@@ -729,46 +736,46 @@ namespace
 				mesh_bone_weights.push_back(weight32);
 			}
 						
-			XMLNodePtr normal_node = vertex_node->FirstNode("normal");
+			XMLNodeView normal_node = vertex_node.FirstNode("normal");
 			if (normal_node)
 			{
 				has_normal = true;
 
 				float3 normal;
-				XMLAttributePtr attr = normal_node->Attrib("v");
+				XMLAttributeView attr = normal_node.Attrib("v");
 				if (attr)
 				{
-					ExtractFVector<3>(attr->ValueString(), &normal[0]);
+					ExtractFVector<3>(attr.ValueString(), &normal[0]);
 				}
 				else
 				{
-					normal.x() = normal_node->Attrib("x")->ValueFloat();
-					normal.y() = normal_node->Attrib("y")->ValueFloat();
-					normal.z() = normal_node->Attrib("z")->ValueFloat();
+					normal.x() = normal_node.Attrib("x").ValueFloat();
+					normal.y() = normal_node.Attrib("y").ValueFloat();
+					normal.z() = normal_node.Attrib("z").ValueFloat();
 				}
 				mesh_normals.push_back(normal);
 			}
 
-			XMLNodePtr tangent_node = vertex_node->FirstNode("tangent");
+			XMLNodeView tangent_node = vertex_node.FirstNode("tangent");
 			if (tangent_node)
 			{
 				has_tangent = true;
 
 				float4 tangent;
-				XMLAttributePtr attr = tangent_node->Attrib("v");
+				XMLAttributeView attr = tangent_node.Attrib("v");
 				if (attr)
 				{
-					ExtractFVector<4>(attr->ValueString(), &tangent[0]);
+					ExtractFVector<4>(attr.ValueString(), &tangent[0]);
 				}
 				else
 				{
-					tangent.x() = tangent_node->Attrib("x")->ValueFloat();
-					tangent.y() = tangent_node->Attrib("y")->ValueFloat();
-					tangent.z() = tangent_node->Attrib("z")->ValueFloat();
-					attr = tangent_node->Attrib("w");
+					tangent.x() = tangent_node.Attrib("x").ValueFloat();
+					tangent.y() = tangent_node.Attrib("y").ValueFloat();
+					tangent.z() = tangent_node.Attrib("z").ValueFloat();
+					attr = tangent_node.Attrib("w");
 					if (attr)
 					{
-						tangent.w() = attr->ValueFloat();
+						tangent.w() = attr.ValueFloat();
 					}
 					else
 					{
@@ -778,43 +785,43 @@ namespace
 				mesh_tangents.push_back(tangent);
 			}
 
-			XMLNodePtr binormal_node = vertex_node->FirstNode("binormal");
+			XMLNodeView binormal_node = vertex_node.FirstNode("binormal");
 			if (binormal_node)
 			{
 				has_binormal = true;
 
 				float3 binormal;
-				XMLAttributePtr attr = binormal_node->Attrib("v");
+				XMLAttributeView attr = binormal_node.Attrib("v");
 				if (attr)
 				{
-					ExtractFVector<3>(attr->ValueString(), &binormal[0]);
+					ExtractFVector<3>(attr.ValueString(), &binormal[0]);
 				}
 				else
 				{
-					binormal.x() = binormal_node->Attrib("x")->ValueFloat();
-					binormal.y() = binormal_node->Attrib("y")->ValueFloat();
-					binormal.z() = binormal_node->Attrib("z")->ValueFloat();
+					binormal.x() = binormal_node.Attrib("x").ValueFloat();
+					binormal.y() = binormal_node.Attrib("y").ValueFloat();
+					binormal.z() = binormal_node.Attrib("z").ValueFloat();
 				}
 				mesh_binormals.push_back(binormal);
 			}
 
-			XMLNodePtr tangent_quat_node = vertex_node->FirstNode("tangent_quat");
+			XMLNodeView tangent_quat_node = vertex_node.FirstNode("tangent_quat");
 			if (tangent_quat_node)
 			{
 				has_tangent_quat = true;
 
 				Quaternion tangent_quat;
-				XMLAttributePtr const & attr = tangent_quat_node->Attrib("v");
+				XMLAttributeView attr = tangent_quat_node.Attrib("v");
 				if (attr)
 				{
-					ExtractFVector<4>(attr->ValueString(), &tangent_quat[0]);
+					ExtractFVector<4>(attr.ValueString(), &tangent_quat[0]);
 				}
 				else
 				{
-					tangent_quat.x() = tangent_quat_node->Attrib("x")->ValueFloat();
-					tangent_quat.y() = tangent_quat_node->Attrib("y")->ValueFloat();
-					tangent_quat.z() = tangent_quat_node->Attrib("z")->ValueFloat();
-					tangent_quat.w() = tangent_quat_node->Attrib("w")->ValueFloat();
+					tangent_quat.x() = tangent_quat_node.Attrib("x").ValueFloat();
+					tangent_quat.y() = tangent_quat_node.Attrib("y").ValueFloat();
+					tangent_quat.z() = tangent_quat_node.Attrib("z").ValueFloat();
+					tangent_quat.w() = tangent_quat_node.Attrib("w").ValueFloat();
 				}
 				mesh_tangent_quats.push_back(tangent_quat);
 			}
@@ -1059,25 +1066,25 @@ namespace
 		bone_weights = mesh_bone_weights;
 	}
 
-	void CompileMeshesTrianglesChunk(XMLNodePtr const & triangles_chunk,
+	void CompileMeshesTrianglesChunk(XMLNodeView triangles_chunk,
 		std::vector<uint8_t>& triangle_indices, char& is_index_16)
 	{
 		std::vector<uint32_t> mesh_triangle_indices;
 
 		is_index_16 = true;
-		for (XMLNodePtr tri_node = triangles_chunk->FirstNode("triangle"); tri_node; tri_node = tri_node->NextSibling("triangle"))
+		for (XMLNodeView tri_node = triangles_chunk.FirstNode("triangle"); tri_node; tri_node = tri_node.NextSibling("triangle"))
 		{
 			uint32_t ind[3];
-			XMLAttributePtr attr = tri_node->Attrib("index");
+			XMLAttributeView attr = tri_node.Attrib("index");
 			if (attr)
 			{
-				ExtractUIVector<3>(attr->ValueString(), &ind[0]);
+				ExtractUIVector<3>(attr.ValueString(), &ind[0]);
 			}
 			else
 			{
-				ind[0] = tri_node->Attrib("a")->ValueUInt();
-				ind[1] = tri_node->Attrib("b")->ValueUInt();
-				ind[2] = tri_node->Attrib("c")->ValueUInt();
+				ind[0] = tri_node.Attrib("a").ValueUInt();
+				ind[1] = tri_node.Attrib("b").ValueUInt();
+				ind[2] = tri_node.Attrib("c").ValueUInt();
 			}
 			mesh_triangle_indices.push_back(ind[0]);
 			mesh_triangle_indices.push_back(ind[1]);
@@ -1365,7 +1372,7 @@ namespace
 			XMLNodePtr vertices_chunk = mesh_node->FirstNode("vertices_chunk");
 			if (vertices_chunk)
 			{
-				CompileMeshesVerticesChunk(vertices_chunk,
+				CompileMeshesVerticesChunk(vertices_chunk->View(),
 					pos_bbs[mesh_index], tc_bbs[mesh_index], ves,
 					positions, normals,	tangent_quats,
 					diffuses, speculars, tex_coords,
@@ -1384,7 +1391,7 @@ namespace
 			if (triangles_chunk)
 			{
 				char is_index_16s = true;
-				CompileMeshesTrianglesChunk(triangles_chunk,
+				CompileMeshesTrianglesChunk(triangles_chunk->View(),
 					triangle_indices, is_index_16s);
 				AppendMeshIndices(triangle_indices, is_index_16s,
 					mesh_num_indices, mesh_start_indices, merged_indices,
@@ -0,0 +1,139 @@
+#include <KlayGE/KlayGE.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include "DeployJobGraph.hpp"
+
+using namespace std;
+using namespace KlayGE;
+
+uint32_t DeployJobGraph::AddJob(std::function<bool()> const & run)
+{
+	Job job;
+	job.run = run;
+	job.num_dependencies = 0;
+	job.state = JS_Pending;
+	jobs_.push_back(std::move(job));
+	return static_cast<uint32_t>(jobs_.size() - 1);
+}
+
+void DeployJobGraph::AddDependency(uint32_t job, uint32_t dependency)
+{
+	BOOST_ASSERT(job < jobs_.size());
+	BOOST_ASSERT(dependency < jobs_.size());
+
+	auto& dependents = jobs_[dependency].dependents;
+	if (std::find(dependents.begin(), dependents.end(), job) == dependents.end())
+	{
+		dependents.push_back(job);
+		++ jobs_[job].num_dependencies;
+	}
+}
+
+uint32_t DeployJobGraph::NumJobs() const
+{
+	return static_cast<uint32_t>(jobs_.size());
+}
+
+DeployJobGraph::JobState DeployJobGraph::State(uint32_t job) const
+{
+	return jobs_[job].state;
+}
+
+bool DeployJobGraph::Run(thread_pool& pool, uint32_t num_threads)
+{
+	std::mutex mutex;
+	std::condition_variable cond;
+	std::deque<uint32_t> ready;
+	std::vector<uint32_t> num_waiting(jobs_.size());
+	uint32_t num_done = 0;
+	uint32_t num_running = 0;
+	for (uint32_t i = 0; i < jobs_.size(); ++ i)
+	{
+		jobs_[i].state = JS_Pending;
+		num_waiting[i] = jobs_[i].num_dependencies;
+		if (0 == num_waiting[i])
+		{
+			ready.push_back(i);
+		}
+	}
+
+	// Called with the lock held
+	std::function<void(uint32_t, JobState)> finish = [&](uint32_t index, JobState state)
+	{
+		jobs_[index].state = state;
+		++ num_done;
+		for (auto const dependent : jobs_[index].dependents)
+		{
+			if (JS_Pending == jobs_[dependent].state)
+			{
+				if (state != JS_Succeeded)
+				{
+					finish(dependent, JS_Skipped);
+				}
+				else if (0 == -- num_waiting[dependent])
+				{
+					ready.push_back(dependent);
+				}
+			}
+		}
+	};
+
+	auto worker = [&]
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;)
+		{
+			cond.wait(lock, [&] { return !ready.empty() || (0 == num_running); });
+			if (ready.empty())
+			{
+				// Nothing is running, so the jobs still pending wait on each other
+				for (uint32_t i = 0; i < jobs_.size(); ++ i)
+				{
+					if (JS_Pending == jobs_[i].state)
+					{
+						finish(i, JS_Skipped);
+					}
+				}
+				cond.notify_all();
+				break;
+			}
+
+			uint32_t const index = ready.front();
+			ready.pop_front();
+			++ num_running;
+
+			lock.unlock();
+			bool const succeeded = jobs_[index].run();
+			lock.lock();
+
+			-- num_running;
+			finish(index, succeeded ? JS_Succeeded : JS_Failed);
+			cond.notify_all();
+		}
+	};
+
+	num_threads = std::max(std::min(num_threads, static_cast<uint32_t>(jobs_.size())), 1U);
+	std::vector<joiner<void>> joiners;
+	for (uint32_t i = 1; i < num_threads; ++ i)
+	{
+		joiners.push_back(pool(worker));
+	}
+	worker();
+	for (auto& joiner : joiners)
+	{
+		joiner();
+	}
+
+	BOOST_ASSERT(jobs_.size() == num_done);
+	KFL_UNUSED(num_done);
+
+	return std::all_of(jobs_.begin(), jobs_.end(),
+		[](Job const & job)
+		{
+			return JS_Succeeded == job.state;
+		});
+}
@@ -0,0 +1,46 @@
+#ifndef _DEPLOYJOBGRAPH_HPP
+#define _DEPLOYJOBGRAPH_HPP
+
+#pragma once
+
+#include <KFL/Thread.hpp>
+
+#include <functional>
+#include <vector>
+
+// A job starts once all its dependencies succeed. The ones depending on a failed job, or waiting on each other in
+//  a cycle, are skipped.
+class DeployJobGraph
+{
+public:
+	enum JobState
+	{
+		JS_Pending,
+		JS_Succeeded,
+		JS_Failed,
+		JS_Skipped
+	};
+
+public:
+	// Returns the index of the job
+	KlayGE::uint32_t AddJob(std::function<bool()> const & run);
+	void AddDependency(KlayGE::uint32_t job, KlayGE::uint32_t dependency);
+
+	KlayGE::uint32_t NumJobs() const;
+	JobState State(KlayGE::uint32_t job) const;
+
+	// Runs the jobs on num_threads threads, and returns true if all of them succeed
+	bool Run(KlayGE::thread_pool& pool, KlayGE::uint32_t num_threads);
+
+private:
+	struct Job
+	{
+		std::function<bool()> run;
+		std::vector<KlayGE::uint32_t> dependents;
+		KlayGE::uint32_t num_dependencies;
+		JobState state;
+	};
+	std::vector<Job> jobs_;
+};
+
+#endif		// _DEPLOYJOBGRAPH_HPP
@@ -1,12 +1,20 @@
 #include <KlayGE/KlayGE.hpp>
 #include <KFL/Util.hpp>
+#include <KFL/Thread.hpp>
+#include <KFL/Timer.hpp>
+#include <KlayGE/Context.hpp>
 #include <KlayGE/JudaTexture.hpp>
 #include <KlayGE/ResLoader.hpp>
 #include <KFL/XMLDom.hpp>
 #include <KFL/CXX17/filesystem.hpp>
 
+#include <functional>
 #include <iostream>
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
 #include <vector>
 #include <regex>
 
@@ -30,6 +38,8 @@
 #endif
 #include <boost/algorithm/string/trim.hpp>
 
+#include "DeployJobGraph.hpp"
+
 using namespace std;
 using namespace KlayGE;
 
@@ -38,6 +48,8 @@ struct OfflineRenderDeviceCaps
 	std::string platform;
 	uint8_t major_version;
 	uint8_t minor_version;
+	// Of the whole .plat file. The JIT tools read more of it than what's here.
+	uint64_t config_hash;
 
 	bool bc1_support : 1;
 	bool bc3_support : 1;
@@ -134,15 +146,40 @@ std::string RetrieveNodeValue(XMLNodePtr root, std::string const & node_name, st
 	return default_value;
 }
 
+// 64-bit FNV-1a. Stays the same between runs and compilers, unlike std::hash.
+uint64_t const HASH_SEED = 0xCBF29CE484222325ULL;
+
+uint64_t HashBytes(void const * data, size_t size, uint64_t hash)
+{
+	uint8_t const * bytes = static_cast<uint8_t const *>(data);
+	for (size_t i = 0; i < size; ++ i)
+	{
+		hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+uint64_t HashString(std::string const & str, uint64_t hash)
+{
+	uint64_t const size = str.size();
+	hash = HashBytes(&size, sizeof(size), hash);
+	return HashBytes(str.data(), str.size(), hash);
+}
+
 OfflineRenderDeviceCaps LoadPlatformConfig(std::string const & platform)
 {
 	ResIdentifierPtr plat = ResLoader::Instance().Open("PlatConf/" + platform + ".plat");
 
+	OfflineRenderDeviceCaps caps;
+
+	std::string const content((std::istreambuf_iterator<char>(plat->input_stream())), std::istreambuf_iterator<char>());
+	caps.config_hash = HashString(content, HASH_SEED);
+	plat->clear();
+	plat->seekg(0, std::ios_base::beg);
+
 	KlayGE::XMLDocument doc;
 	XMLNodePtr root = doc.Parse(plat);
 
-	OfflineRenderDeviceCaps caps;
-
 	caps.platform = RetrieveAttrValue(root, "name", "");
 	caps.major_version = static_cast<uint8_t>(RetrieveAttrValue(root, "major_version", 0));
 	caps.minor_version = static_cast<uint8_t>(RetrieveAttrValue(root, "minor_version", 0));
@@ -160,223 +197,637 @@ OfflineRenderDeviceCaps LoadPlatformConfig(std::string const & platform)
 	return caps;
 }
 
-void Deploy(std::vector<std::string> const & res_names, std::string const & res_type, OfflineRenderDeviceCaps const & caps)
+// A step of a deploy job. The description is hashed with the inputs, so changing a command reruns the job.
+struct DeployStep
 {
-	std::ofstream ofs("convert.bat");
+	std::string description;
+	std::function<bool()> run;
+};
 
-	if (("albedo" == res_type)
-		|| ("emissive" == res_type))
+struct DeployJob
+{
+	std::string name;
+	std::string type;
+	// Scanned for dependencies when the job runs, see JobInputs
+	std::vector<std::string> inputs;
+	std::vector<std::string> outputs;
+	std::vector<DeployStep> steps;
+	// Removed after the steps, whether they succeed or not
+	std::vector<std::string> temp_files;
+};
+
+struct ManifestEntry
+{
+	uint64_t inputs_hash;
+	uint64_t outputs_hash;
+};
+
+std::string const MANIFEST_NAME = "PlatformDeployer.manifest";
+
+uint64_t HashFile(std::string const & name, uint64_t hash)
+{
+	hash = HashString(name, hash);
+
+	std::ifstream ifs(name.c_str(), std::ios_base::binary);
+	uint8_t const exists = ifs ? 1 : 0;
+	if (exists)
 	{
-		for (size_t i = 0; i < res_names.size(); ++ i)
+		std::vector<char> buf(64 * 1024);
+		while (ifs)
 		{
-			ofs << "@echo Processing: " << res_names[i] << std::endl;
+			ifs.read(buf.data(), buf.size());
+			hash = HashBytes(buf.data(), static_cast<size_t>(ifs.gcount()), hash);
+		}
+	}
+	return HashBytes(&exists, sizeof(exists), hash);
+}
+
+std::string Quote(std::string const & name)
+{
+	return '"' + name + '"';
+}
 
-			ofs << "@echo off" << std::endl << std::endl;
+std::string TempTextureName(std::string const & res_name)
+{
+	filesystem::path const path(res_name);
+	return (path.parent_path() / (path.stem().string() + ".deploying.dds")).string();
+}
+
+DeployStep CommandStep(std::string const & cmd)
+{
+	return DeployStep{ cmd,
+		[cmd]
+		{
+			return 0 == system(cmd.c_str());
+		} };
+}
+
+DeployStep CopyStep(std::string const & from, std::string const & to)
+{
+	return DeployStep{ "copy " + Quote(from) + ' ' + Quote(to),
+		[from, to]
+		{
+			try
+			{
+				if (filesystem::exists(to))
+				{
+					filesystem::remove(to);
+				}
+				filesystem::copy_file(from, to);
+				return true;
+			}
+			catch (std::exception const & e)
+			{
+				cout << e.what() << endl;
+				return false;
+			}
+		} };
+}
+
+// Dependencies are next to the file referring to them, in the current directory, or somewhere ResLoader looks.
+//  One that can't be found is still an input, so it rebuilds the job when it appears.
+std::string LocateDependency(std::string const & name, filesystem::path const & base_dir)
+{
+	filesystem::path const local = base_dir / name;
+	if (filesystem::exists(local))
+	{
+		return local.string();
+	}
+	if (filesystem::exists(name))
+	{
+		return name;
+	}
+	std::string const located = ResLoader::Instance().Locate(name);
+	return located.empty() ? local.string() : located;
+}
+
+void AddDependency(std::string const & name, std::vector<std::string>& deps)
+{
+	if (std::find(deps.begin(), deps.end(), name) == deps.end())
+	{
+		deps.push_back(name);
+	}
+}
+
+void FxmlIncludes(std::string const & fxml_name, std::vector<std::string>& includes)
+{
+	ResIdentifierPtr file = ResLoader::Instance().Open(fxml_name);
+	if (!file)
+	{
+		return;
+	}
+
+	KlayGE::XMLDocument doc;
+	XMLNodePtr root = doc.Parse(file);
+	filesystem::path const dir = filesystem::path(fxml_name).parent_path();
+	for (XMLNodePtr node = root->FirstNode("include"); node; node = node->NextSibling("include"))
+	{
+		XMLAttributePtr attr = node->Attrib("name");
+		if (attr)
+		{
+			std::string const include_name = LocateDependency(attr->ValueString(), dir);
+			if (std::find(includes.begin(), includes.end(), include_name) == includes.end())
+			{
+				includes.push_back(include_name);
+				FxmlIncludes(include_name, includes);
+			}
+		}
+	}
+}
+
+void MeshMLTextures(std::string const & meshml_name, std::vector<std::string>& textures)
+{
+	ResIdentifierPtr file = ResLoader::Instance().Open(meshml_name);
+	if (!file)
+	{
+		return;
+	}
+
+	KlayGE::XMLDocument doc;
+	XMLNodePtr root = doc.Parse(file);
+	XMLNodePtr materials_chunk = root->FirstNode("materials_chunk");
+	if (!materials_chunk)
+	{
+		return;
+	}
+
+	filesystem::path const dir = filesystem::path(meshml_name).parent_path();
+	for (XMLNodePtr mtl_node = materials_chunk->FirstNode("material"); mtl_node; mtl_node = mtl_node->NextSibling("material"))
+	{
+		char const * slot_names[] = { "albedo", "metalness", "glossiness", "emissive", "bump", "normal", "height" };
+		for (auto slot_name : slot_names)
+		{
+			XMLNodePtr slot_node = mtl_node->FirstNode(slot_name);
+			if (slot_node)
+			{
+				XMLAttributePtr attr = slot_node->Attrib("texture");
+				if (attr)
+				{
+					AddDependency(LocateDependency(attr->ValueString(), dir), textures);
+				}
+			}
+		}
+
+		XMLNodePtr tex_node = mtl_node->FirstNode("texture");
+		if (!tex_node)
+		{
+			XMLNodePtr textures_chunk = mtl_node->FirstNode("textures_chunk");
+			if (textures_chunk)
+			{
+				tex_node = textures_chunk->FirstNode("texture");
+			}
+		}
+		for (; tex_node; tex_node = tex_node->NextSibling("texture"))
+		{
+			XMLAttributePtr attr = tex_node->Attrib("name");
+			if (attr)
+			{
+				AddDependency(LocateDependency(attr->ValueString(), dir), textures);
+			}
+		}
+	}
+}
+
+std::vector<std::string> JobInputs(DeployJob const & job)
+{
+	std::vector<std::string> inputs = job.inputs;
+	if ("effect" == job.type)
+	{
+		FxmlIncludes(job.name, inputs);
+	}
+	else if ("model" == job.type)
+	{
+		MeshMLTextures(job.name, inputs);
+	}
+	return inputs;
+}
+
+uint64_t InputsHash(DeployJob const & job, uint64_t config_hash)
+{
+	uint64_t hash = HashBytes(&config_hash, sizeof(config_hash), HASH_SEED);
+	hash = HashString(job.type, hash);
+	for (auto const & step : job.steps)
+	{
+		hash = HashString(step.description, hash);
+	}
+	for (auto const & input : JobInputs(job))
+	{
+		hash = HashFile(input, hash);
+	}
+	return hash;
+}
+
+uint64_t OutputsHash(DeployJob const & job)
+{
+	uint64_t hash = HASH_SEED;
+	for (auto const & output : job.outputs)
+	{
+		hash = HashFile(output, hash);
+	}
+	return hash;
+}
+
+bool OutputsExist(DeployJob const & job)
+{
+	for (auto const & output : job.outputs)
+	{
+		if (!filesystem::exists(output))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// One line per job, "<inputs hash> <outputs hash> <type> <name>". Jobs append to it as they finish, so an
+//  interrupted deploy keeps what it has built. Later lines override earlier ones.
+std::map<std::string, ManifestEntry> LoadManifest()
+{
+	std::map<std::string, ManifestEntry> manifest;
+
+	std::ifstream ifs(MANIFEST_NAME.c_str());
+	std::string line;
+	while (std::getline(ifs, line))
+	{
+		std::istringstream iss(line);
+		ManifestEntry entry;
+		if (iss >> std::hex >> entry.inputs_hash >> entry.outputs_hash)
+		{
+			std::string key;
+			iss.get();
+			std::getline(iss, key);
+			boost::algorithm::trim_right(key);
+			if (!key.empty())
+			{
+				manifest[key] = entry;
+			}
+		}
+	}
+
+	return manifest;
+}
+
+void WriteManifestEntry(std::ostream& os, std::string const & key, ManifestEntry const & entry)
+{
+	os << std::hex << entry.inputs_hash << ' ' << entry.outputs_hash << std::dec << ' ' << key << '\n';
+}
+
+void SaveManifest(std::map<std::string, ManifestEntry> const & manifest)
+{
+	std::string const tmp_name = MANIFEST_NAME + ".tmp";
+	{
+		std::ofstream ofs(tmp_name.c_str());
+		for (auto const & entry : manifest)
+		{
+			WriteManifestEntry(ofs, entry.first, entry.second);
+		}
+	}
+
+	if (filesystem::exists(MANIFEST_NAME))
+	{
+		filesystem::remove(MANIFEST_NAME);
+	}
+	filesystem::rename(tmp_name, MANIFEST_NAME);
+}
+
+std::vector<DeployJob> MakeJobs(std::vector<std::string> const & res_names, std::vector<std::string> const & res_types,
+	OfflineRenderDeviceCaps const & caps)
+{
+	BOOST_ASSERT(res_names.size() == res_types.size());
+
+	std::vector<DeployJob> jobs;
+	for (size_t i = 0; i < res_names.size(); ++ i)
+	{
+		std::string const & res_name = res_names[i];
+		std::string const & res_type = res_types[i];
+
+		DeployJob job;
+		job.name = res_name;
+		job.type = res_type;
+		job.inputs.push_back(res_name);
+
+		std::string const tmp_name = TempTextureName(res_name);
+		std::string const quoted_name = Quote(res_name);
+		std::string const quoted_tmp = Quote(tmp_name);
+
+		if (("albedo" == res_type)
+			|| ("emissive" == res_type))
+		{
 			if (caps.srgb_support)
 			{
-				ofs << "ForceTexSRGB \"" << res_names[i] << "\" temp.dds" << std::endl;
+				job.steps.push_back(CommandStep("ForceTexSRGB " + quoted_name + ' ' + quoted_tmp));
 			}
 			else
 			{
-				ofs << "copy \"" << res_names[i] << "\" temp.dds" << std::endl;
+				job.steps.push_back(CopyStep(res_name, tmp_name));
 			}
-			ofs << "Mipmapper temp.dds" << std::endl;
+			job.steps.push_back(CommandStep("Mipmapper " + quoted_tmp));
 			if (caps.bc7_support)
 			{
-				ofs << "TexCompressor BC7 temp.dds \"" << res_names[i] << "\"" << std::endl;
+				job.steps.push_back(CommandStep("TexCompressor BC7 " + quoted_tmp + ' ' + quoted_name));
 			}
 			else if (caps.bc1_support)
 			{
-				ofs << "TexCompressor BC1 temp.dds \"" << res_names[i] << "\"" << std::endl;
+				job.steps.push_back(CommandStep("TexCompressor BC1 " + quoted_tmp + ' ' + quoted_name));
 			}
 			else if (caps.etc1_support)
 			{
-				ofs << "TexCompressor ETC1 temp.dds \"" << res_names[i] << "\"" << std::endl;
+				job.steps.push_back(CommandStep("TexCompressor ETC1 " + quoted_tmp + ' ' + quoted_name));
 			}
 			else
 			{
-				ofs << "copy temp.dds \"" << res_names[i] << "\"" << std::endl;
+				job.steps.push_back(CopyStep(tmp_name, res_name));
 			}
-			ofs << "del temp.dds" << std::endl;
-			ofs << "@echo on" << std::endl << std::endl;
+			job.outputs.push_back(res_name);
+			job.temp_files.push_back(tmp_name);
 		}
-	}
-	else if (("glossiness" == res_type)
-		|| ("metalness" == res_type))
-	{
-		for (size_t i = 0; i < res_names.size(); ++ i)
+		else if (("glossiness" == res_type)
+			|| ("metalness" == res_type))
 		{
-			ofs << "@echo Processing: " << res_names[i] << std::endl;
-
-			ofs << "@echo off" << std::endl << std::endl;
-			ofs << "copy \"" << res_names[i] << "\" temp.dds" << std::endl;
-			ofs << "Mipmapper temp.dds" << std::endl;
+			job.steps.push_back(CopyStep(res_name, tmp_name));
+			job.steps.push_back(CommandStep("Mipmapper " + quoted_tmp));
 			if (caps.bc7_support)
 			{
-				ofs << "TexCompressor BC7 temp.dds \"" << res_names[i] << "\"" << std::endl;
+				job.steps.push_back(CommandStep("TexCompressor BC7 " + quoted_tmp + ' ' + quoted_name));
 			}
 			else if (caps.bc4_support)
 			{
-				ofs << "TexCompressor BC4 temp.dds \"" << res_names[i] << "\"" << std::endl;
+				job.steps.push_back(CommandStep("TexCompressor BC4 " + quoted_tmp + ' ' + quoted_name));
 			}
 			else if (caps.bc1_support)
 			{
-				ofs << "TexCompressor BC1 temp.dds \"" << res_names[i] << "\"" << std::endl;
+				job.steps.push_back(CommandStep("TexCompressor BC1 " + quoted_tmp + ' ' + quoted_name));
 			}
 			else if (caps.etc1_support)
 			{
-				ofs << "TexCompressor ETC1 temp.dds \"" << res_names[i] << "\"" << std::endl;
+				job.steps.push_back(CommandStep("TexCompressor ETC1 " + quoted_tmp + ' ' + quoted_name));
 			}
 			else
 			{
-				ofs << "copy temp.dds \"" << res_names[i] << "\"" << std::endl;
+				job.steps.push_back(CopyStep(tmp_name, res_name));
 			}
-			ofs << "del temp.dds" << std::endl;
-			ofs << "@echo on" << std::endl << std::endl;
+			job.outputs.push_back(res_name);
+			job.temp_files.push_back(tmp_name);
 		}
-	}
-	else if ("normal" == res_type)
-	{
-		for (size_t i = 0; i < res_names.size(); ++ i)
+		else if (("normal" == res_type)
+			|| ("bump" == res_type))
 		{
-			ofs << "@echo Processing: " << res_names[i] << std::endl;
-
-			ofs << "@echo off" << std::endl << std::endl;
-			ofs << "Mipmapper \"" << res_names[i] << "\" temp.dds" << std::endl;
-			if (caps.bc5_support)
+			if ("bump" == res_type)
 			{
-				ofs << "NormalMapCompressor temp.dds \"" << res_names[i] << "\" BC5" << std::endl;
-			}
-			else if (caps.bc3_support)
-			{
-				ofs << "NormalMapCompressor temp.dds \"" << res_names[i] << "\" BC3" << std::endl;
+				job.steps.push_back(CommandStep("Bump2Normal " + quoted_name + ' ' + quoted_tmp + " 0.4"));
+				job.steps.push_back(CommandStep("Mipmapper " + quoted_tmp));
 			}
 			else
 			{
-				ofs << "copy temp.dds \"" << res_names[i] << "\"" << std::endl;
+				job.steps.push_back(CommandStep("Mipmapper " + quoted_name + ' ' + quoted_tmp));
 			}
-			ofs << "del temp.dds" << std::endl;
-			ofs << "@echo on" << std::endl << std::endl;
-		}
-	}
-	else if ("bump" == res_type)
-	{
-		for (size_t i = 0; i < res_names.size(); ++ i)
-		{
-			ofs << "@echo Processing: " << res_names[i] << std::endl;
-
-			ofs << "@echo off" << std::endl << std::endl;
-			ofs << "Bump2Normal \"" << res_names[i] << "\" temp.dds 0.4" << std::endl;
-			ofs << "Mipmapper temp.dds" << std::endl; 
 			if (caps.bc5_support)
 			{
-				ofs << "NormalMapCompressor temp.dds \"" << res_names[i] << "\" BC5" << std::endl;
+				job.steps.push_back(CommandStep("NormalMapCompressor " + quoted_tmp + ' ' + quoted_name + " BC5"));
 			}
 			else if (caps.bc3_support)
 			{
-				ofs << "NormalMapCompressor temp.dds \"" << res_names[i] << "\" BC3" << std::endl;
+				job.steps.push_back(CommandStep("NormalMapCompressor " + quoted_tmp + ' ' + quoted_name + " BC3"));
 			}
 			else
 			{
-				ofs << "copy temp.dds \"" << res_names[i] << "\"" << std::endl;
+				job.steps.push_back(CopyStep(tmp_name, res_name));
 			}
-			ofs << "del temp.dds" << std::endl;
-			ofs << "@echo on" << std::endl << std::endl;
+			job.outputs.push_back(res_name);
+			job.temp_files.push_back(tmp_name);
 		}
-	}
-	else if ("height" == res_type)
-	{
-		for (size_t i = 0; i < res_names.size(); ++ i)
+		else if ("height" == res_type)
 		{
-			ofs << "@echo Processing: " << res_names[i] << std::endl;
-
-			ofs << "@echo off" << std::endl << std::endl;
-			ofs << "Mipmapper \"" << res_names[i] << "\" temp.dds" << std::endl;
+			job.steps.push_back(CommandStep("Mipmapper " + quoted_name + ' ' + quoted_tmp));
 			if (caps.bc4_support)
 			{
-				ofs << "TexCompressor BC4 temp.dds \"" << res_names[i] << "\"" << std::endl;
+				job.steps.push_back(CommandStep("TexCompressor BC4 " + quoted_tmp + ' ' + quoted_name));
 			}
 			else if (caps.bc1_support)
 			{
-				ofs << "TexCompressor BC1 temp.dds \"" << res_names[i] << "\"" << std::endl;
+				job.steps.push_back(CommandStep("TexCompressor BC1 " + quoted_tmp + ' ' + quoted_name));
 			}
 			else if (caps.etc1_support)
 			{
-				ofs << "TexCompressor ETC1 temp.dds \"" << res_names[i] << "\"" << std::endl;
+				job.steps.push_back(CommandStep("TexCompressor ETC1 " + quoted_tmp + ' ' + quoted_name));
 			}
 			else
 			{
-				ofs << "copy temp.dds \"" << res_names[i] << "\"" << std::endl;
+				job.steps.push_back(CopyStep(tmp_name, res_name));
 			}
-			ofs << "del temp.dds" << std::endl;
-			ofs << "@echo on" << std::endl << std::endl;
+			job.outputs.push_back(res_name);
+			job.temp_files.push_back(tmp_name);
 		}
-	}
-	else if ("cubemap" == res_type)
-	{
-		std::string y_fmt;
-		std::string c_fmt;
-		if (caps.r16_support)
+		else if ("cubemap" == res_type)
 		{
-			y_fmt = "R16";
+			std::string y_fmt;
+			std::string c_fmt;
+			if (caps.r16_support)
+			{
+				y_fmt = "R16";
+			}
+			else if (caps.r16f_support)
+			{
+				y_fmt = "R16F";
+			}
+			if (caps.bc5_support)
+			{
+				c_fmt = "BC5";
+			}
+			else if (caps.bc3_support)
+			{
+				c_fmt = "BC3";
+			}
+
+			job.steps.push_back(CommandStep("HDRCompressor " + quoted_name + ' ' + y_fmt + ' ' + c_fmt));
+
+			// HDRCompressor writes to the current directory
+			filesystem::path const path(res_name);
+			job.outputs.push_back(path.stem().string() + "_y" + path.extension().string());
+			job.outputs.push_back(path.stem().string() + "_c" + path.extension().string());
 		}
-		else if (caps.r16f_support)
+		else if ("model" == res_type)
 		{
-			y_fmt = "R16F";
+			job.steps.push_back(CommandStep("MeshMLJIT -I " + quoted_name + " -P " + caps.platform));
+			job.outputs.push_back(res_name + ".model_bin");
 		}
-		if (caps.bc5_support)
+		else if ("effect" == res_type)
 		{
-			c_fmt = "BC5";
+			job.steps.push_back(CommandStep("FXMLJIT " + caps.platform + ' ' + quoted_name));
+			filesystem::path const path(res_name);
+			job.outputs.push_back((path.parent_path() / (path.stem().string() + ".kfx")).string());
 		}
-		else if (caps.bc3_support)
+		else
 		{
-			c_fmt = "BC3";
+			cout << "Error: Unknown resource type." << endl;
+			return std::vector<DeployJob>();
 		}
 
-		for (size_t i = 0; i < res_names.size(); ++ i)
-		{
-			ofs << "@echo Processing: " << res_names[i] << std::endl;
-
-			ofs << "@echo off" << std::endl << std::endl;
-			ofs << "HDRCompressor \"" << res_names[i] << "\" " << y_fmt << ' ' << c_fmt << std::endl;
-			ofs << "@echo on" << std::endl << std::endl;
-		}
+		jobs.push_back(std::move(job));
 	}
-	else if ("model" == res_type)
+
+	return jobs;
+}
+
+// Models are hashed with their textures, and textures are processed in place. So a model waits for the textures
+//  deployed in the same run.
+void AddJobDependencies(std::vector<DeployJob> const & jobs, DeployJobGraph& graph)
+{
+	std::map<std::string, uint32_t> texture_jobs;
+	for (uint32_t i = 0; i < jobs.size(); ++ i)
 	{
-		for (size_t i = 0; i < res_names.size(); ++ i)
+		if (jobs[i].outputs == jobs[i].inputs)
 		{
-			ofs << "@echo Processing: " << res_names[i] << std::endl;
-
-			ofs << "@echo off" << std::endl << std::endl;
-			ofs << "MeshMLJIT -I \"" << res_names[i] << "\" -P " << caps.platform << std::endl;
-			ofs << "@echo on" << std::endl << std::endl;
+			texture_jobs.emplace(filesystem::path(jobs[i].name).generic_string(), i);
 		}
 	}
-	else if ("effect" == res_type)
+	if (texture_jobs.empty())
 	{
-		for (size_t i = 0; i < res_names.size(); ++ i)
-		{
-			ofs << "@echo Processing: " << res_names[i] << std::endl;
+		return;
+	}
 
-			ofs << "@echo off" << std::endl << std::endl;
-			ofs << "FXMLJIT " << caps.platform << " \"" << res_names[i] << "\"" << std::endl;
-			ofs << "@echo on" << std::endl << std::endl;
+	for (uint32_t i = 0; i < jobs.size(); ++ i)
+	{
+		if ("model" == jobs[i].type)
+		{
+			std::vector<std::string> textures;
+			MeshMLTextures(jobs[i].name, textures);
+			for (auto const & texture : textures)
+			{
+				auto iter = texture_jobs.find(filesystem::path(texture).generic_string());
+				if (iter != texture_jobs.end())
+				{
+					graph.AddDependency(i, iter->second);
+				}
+			}
 		}
 	}
-	else
+}
+
+// Runs the jobs whose inputs changed since the last deploy, on num_threads threads
+bool RunJobs(std::vector<DeployJob> const & jobs, uint64_t config_hash, uint32_t num_threads, bool force)
+{
+	std::map<std::string, ManifestEntry> manifest = LoadManifest();
+	std::ofstream manifest_log(MANIFEST_NAME.c_str(), std::ios_base::app);
+
+	std::mutex mutex;
+	uint32_t num_finished = 0;
+	uint32_t num_built = 0;
+	uint32_t num_up_to_date = 0;
+	uint32_t num_failed = 0;
+	double build_time = 0;
+
+	DeployJobGraph graph;
+	for (uint32_t i = 0; i < jobs.size(); ++ i)
 	{
-		printf("Error: Unknown resource type.");
-		return;
+		graph.AddJob([&, i]
+		{
+			DeployJob const & job = jobs[i];
+			std::string const key = job.type + ' ' + job.name;
+
+			Timer timer;
+
+			uint64_t const inputs_hash = InputsHash(job, config_hash);
+			bool up_to_date = false;
+			if (!force)
+			{
+				ManifestEntry entry = { 0, 0 };
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					auto iter = manifest.find(key);
+					if (iter != manifest.end())
+					{
+						entry = iter->second;
+					}
+				}
+				up_to_date = (entry.inputs_hash == inputs_hash) && OutputsExist(job) && (OutputsHash(job) == entry.outputs_hash);
+			}
+
+			std::string failed_step;
+			ManifestEntry new_entry = { 0, 0 };
+			if (!up_to_date)
+			{
+				for (auto const & step : job.steps)
+				{
+					if (!step.run())
+					{
+						failed_step = step.description;
+						break;
+					}
+				}
+				for (auto const & temp_file : job.temp_files)
+				{
+					if (filesystem::exists(temp_file))
+					{
+						filesystem::remove(temp_file);
+					}
+				}
+
+				if (failed_step.empty())
+				{
+					// Textures are processed in place, so their inputs are hashed again after the build
+					new_entry.inputs_hash = job.outputs == job.inputs ? InputsHash(job, config_hash) : inputs_hash;
+					new_entry.outputs_hash = OutputsHash(job);
+				}
+			}
+
+			double const elapsed = timer.elapsed();
+
+			std::lock_guard<std::mutex> lock(mutex);
+			++ num_finished;
+			cout << '[' << num_finished << '/' << jobs.size() << "] ";
+			if (up_to_date)
+			{
+				++ num_up_to_date;
+				cout << "Up to date: " << job.name << endl;
+			}
+			else
+			{
+				build_time += elapsed;
+
+				// A failed job is recorded with hashes that never match, so it's built next time
+				manifest[key] = new_entry;
+				WriteManifestEntry(manifest_log, key, new_entry);
+				manifest_log.flush();
+
+				if (failed_step.empty())
+				{
+					++ num_built;
+					cout << "Built: " << job.name << " in " << elapsed << " s" << endl;
+				}
+				else
+				{
+					++ num_failed;
+					cout << "Failed: " << job.name << " in " << elapsed << " s, at: " << failed_step << endl;
+				}
+			}
+
+			return up_to_date || failed_step.empty();
+		});
 	}
+	AddJobDependencies(jobs, graph);
 
-	ofs.close();
+	Timer timer;
 
-	if ((res_type != "cubemap") && (res_type != "model") && (res_type != "effect"))
+	num_threads = std::max(std::min(num_threads, static_cast<uint32_t>(jobs.size())), 1U);
+	graph.Run(Context::Instance().ThreadPool(), num_threads);
+
+	for (uint32_t i = 0; i < jobs.size(); ++ i)
 	{
-		system("convert.bat");
-		system("del convert.bat");
+		if (DeployJobGraph::JS_Skipped == graph.State(i))
+		{
+			++ num_failed;
+			cout << "Skipped: " << jobs[i].name << ", a texture it uses failed" << endl;
+		}
 	}
+
+	manifest_log.close();
+	SaveManifest(manifest);
+
+	cout << num_built << " built, " << num_up_to_date << " up to date, " << num_failed << " failed. "
+		<< timer.elapsed() << " s on " << num_threads << " threads, " << build_time << " s of building." << endl;
+
+	return 0 == num_failed;
 }
 
 int main(int argc, char* argv[])
@@ -384,7 +835,7 @@ int main(int argc, char* argv[])
 	ResLoader::Instance().AddPath("../../Tools/media/PlatformDeployer");
 
 	std::vector<std::string> res_names;
-	std::string res_type;
+	std::vector<std::string> res_types;
 	std::string platform;
 
 	boost::program_options::options_description desc("Allowed options");
@@ -393,6 +844,8 @@ int main(int argc, char* argv[])
 		("input-name,I", boost::program_options::value<std::string>(), "Input resource name.")
 		("type,T", boost::program_options::value<std::string>(), "Resource type.")
 		("platform,P", boost::program_options::value<std::string>(), "Platform name.")
+		("jobs,J", boost::program_options::value<uint32_t>(), "Number of jobs to run in parallel. Default to the number of cores.")
+		("force,F", "Rebuild resources even if they are up to date.")
 		("version,v", "Version.");
 
 	boost::program_options::variables_map vm;
@@ -407,7 +860,7 @@ int main(int argc, char* argv[])
 	}
 	if (vm.count("version") > 0)
 	{
-		cout << "KlayGE PlatformDeployer, Version 1.0.0" << endl;
+		cout << "KlayGE PlatformDeployer, Version 1.1.0" << endl;
 		Context::Destroy();
 		return 1;
 	}
@@ -452,24 +905,31 @@ int main(int argc, char* argv[])
 	}
 	if (vm.count("type") > 0)
 	{
-		res_type = vm["type"].as<std::string>();
+		std::string res_type = vm["type"].as<std::string>();
+		boost::algorithm::to_lower(res_type);
+		res_types.assign(res_names.size(), res_type);
 	}
 	else
 	{
-		std::string ext_name = filesystem::path(res_names[0]).extension().string();
-		if (".dds" == ext_name)
+		// Textures and models can be deployed together, the models wait for their textures
+		for (auto const & res_name : res_names)
 		{
-			res_type = "albedo";
-		}
-		else if (".meshml" == ext_name)
-		{
-			res_type = "model";
-		}
-		else
-		{
-			cout << "Need resource type name." << endl;
-			Context::Destroy();
-			return 1;
+			std::string ext_name = filesystem::path(res_name).extension().string();
+			boost::algorithm::to_lower(ext_name);
+			if (".dds" == ext_name)
+			{
+				res_types.push_back("albedo");
+			}
+			else if (".meshml" == ext_name)
+			{
+				res_types.push_back("model");
+			}
+			else
+			{
+				cout << "Need resource type name." << endl;
+				Context::Destroy();
+				return 1;
+			}
 		}
 	}
 	if (vm.count("platform") > 0)
@@ -481,7 +941,6 @@ int main(int argc, char* argv[])
 		platform = "d3d_11_0";
 	}
 
-	boost::algorithm::to_lower(res_type);
 	boost::algorithm::to_lower(platform);
 
 	if (("pc_dx11" == platform) || ("pc_dx10" == platform) || ("pc_dx9" == platform) || ("win_tegra3" == platform)
@@ -526,10 +985,18 @@ int main(int argc, char* argv[])
 		}
 	}
 
+	uint32_t num_threads = std::thread::hardware_concurrency();
+	if (vm.count("jobs") > 0)
+	{
+		num_threads = vm["jobs"].as<uint32_t>();
+	}
+	bool const force = vm.count("force") > 0;
+
 	OfflineRenderDeviceCaps caps = LoadPlatformConfig(platform);
-	Deploy(res_names, res_type, caps);
+	std::vector<DeployJob> const jobs = MakeJobs(res_names, res_types, caps);
+	bool const success = !jobs.empty() && RunJobs(jobs, caps.config_hash, num_threads, force);
 
 	Context::Destroy();
 
-	return 0;
+	return success ? 0 : 1;
 }